@@ -4,3 +4,4 @@
 #include "ofxTCPManager.h"
 #include "ofxTCPServer.h"
 #include "ofxUDPManager.h"
+#include "ofxUDPReceiver.h"
@@ -0,0 +1,830 @@
+#include "ofxTCPReactor.h"
+#include "ofxNetworkUtils.h"
+#include "ofLog.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+	#define OFX_TCP_REACTOR_EPOLL
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+#elif !defined(TARGET_WIN32)
+	#include <poll.h>
+#endif
+
+#ifndef TARGET_WIN32
+	#include <sys/uio.h>
+	#include <netinet/tcp.h>
+#endif
+
+// maximum number of queued chunks sent in one call
+#define MAX_SEND_CHUNKS 64
+
+// maximum number of reads from a connection every time it's ready, so one
+// fast client can't starve the rest
+#define MAX_READS 4
+
+namespace{
+	bool wouldBlock(int error){
+		return error == OFXNETWORK_ERROR(WOULDBLOCK) || error == EAGAIN || error == OFXNETWORK_ERROR(INTR);
+	}
+
+	int lastError(){
+	#ifdef TARGET_WIN32
+		return WSAGetLastError();
+	#else
+		return errno;
+	#endif
+	}
+
+	void closeSocket(ofxTCPReactor::Socket socket){
+	#ifdef TARGET_WIN32
+		closesocket(socket);
+	#else
+		::close(socket);
+	#endif
+	}
+
+	void shutdownSocket(ofxTCPReactor::Socket socket){
+	#ifdef TARGET_WIN32
+		shutdown(socket, SD_BOTH);
+	#else
+		shutdown(socket, SHUT_RDWR);
+	#endif
+	}
+
+	bool setNonBlocking(ofxTCPReactor::Socket socket){
+	#ifdef TARGET_WIN32
+		unsigned long arg = 1;
+		return ioctlsocket(socket, FIONBIO, &arg) == 0;
+	#else
+		int flags = fcntl(socket, F_GETFL, 0);
+		return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) >= 0;
+	#endif
+	}
+
+	// byte ring buffer that grows up to a maximum capacity
+	class RingBuffer{
+	public:
+		std::size_t size() const{
+			return count;
+		}
+
+		bool empty() const{
+			return count == 0;
+		}
+
+		// contiguous free space after the data, growing the buffer when
+		// it's full and still under maxCapacity
+		char * writable(std::size_t maxCapacity, std::size_t & length){
+			if(count == data.size()){
+				if(data.size() >= maxCapacity){
+					length = 0;
+					return nullptr;
+				}
+				grow(std::min(std::max(data.size() * 2, std::size_t(4096)), maxCapacity));
+			}
+			auto tail = (head + count) % data.size();
+			length = tail >= head ? data.size() - tail : head - tail;
+			return data.data() + tail;
+		}
+
+		void commit(std::size_t length){
+			count += length;
+		}
+
+		std::size_t read(char * out, std::size_t length, bool peek){
+			length = std::min(length, count);
+			if(length == 0) return 0;
+			auto first = std::min(length, data.size() - head);
+			memcpy(out, data.data() + head, first);
+			memcpy(out + first, data.data(), length - first);
+			if(!peek) consume(length);
+			return length;
+		}
+
+		void consume(std::size_t length){
+			head = (head + length) % data.size();
+			count -= length;
+			if(count == 0) head = 0;
+		}
+
+		// position of delimiter in the data or npos
+		std::size_t find(const std::string & delimiter) const{
+			if(delimiter.empty() || count < delimiter.size()) return std::string::npos;
+			for(std::size_t i = 0; i + delimiter.size() <= count; i++){
+				std::size_t j = 0;
+				while(j < delimiter.size() && at(i + j) == delimiter[j]) j++;
+				if(j == delimiter.size()) return i;
+			}
+			return std::string::npos;
+		}
+
+		void clear(){
+			std::vector<char>().swap(data);
+			head = count = 0;
+		}
+
+	private:
+		char at(std::size_t i) const{
+			return data[(head + i) % data.size()];
+		}
+
+		void grow(std::size_t capacity){
+			std::vector<char> grown(capacity);
+			read(grown.data(), count, true);
+			data.swap(grown);
+			head = 0;
+		}
+
+		std::vector<char> data;
+		std::size_t head = 0;
+		std::size_t count = 0;
+	};
+
+	// part of a buffer queued to send, shared by every connection it's sent to
+	struct Chunk{
+		std::shared_ptr<const std::string> data;
+		std::size_t offset;
+	};
+
+	enum Interest: uint32_t{
+		Read = 1,
+		Write = 2,
+	};
+}
+
+//--------------------------------------------------------------
+struct ofxTCPReactor::Connection{
+	int id;
+	Socket socket;
+	std::string ip;
+	int port;
+	std::mutex mutex;
+
+	// guarded by mutex
+	RingBuffer received;
+	std::deque<Chunk> sendQueue;
+	std::size_t queuedBytes = 0;
+	bool open = true;
+	bool closeRequested = false;
+	bool notified = false;
+
+	// only used from the thread calling poll()
+	uint32_t interest = 0;
+	std::atomic<bool> pending{false};
+};
+
+//--------------------------------------------------------------
+// waits for events on the sockets with epoll, or poll where it's not
+// available, which can't be woken up so it waits at most a few ms
+struct ofxTCPReactor::Poller{
+#ifdef OFX_TCP_REACTOR_EPOLL
+	int epoll = -1;
+	int wakeFd = -1;
+	std::vector<epoll_event> ready = std::vector<epoll_event>(256);
+
+	bool setup(){
+		epoll = epoll_create1(EPOLL_CLOEXEC);
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if(epoll < 0 || wakeFd < 0) return false;
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = wakeFd;
+		return epoll_ctl(epoll, EPOLL_CTL_ADD, wakeFd, &event) == 0;
+	}
+
+	~Poller(){
+		if(epoll >= 0) ::close(epoll);
+		if(wakeFd >= 0) ::close(wakeFd);
+	}
+
+	static uint32_t toEvents(uint32_t interest){
+		return (interest & Read ? EPOLLIN : 0) | (interest & Write ? EPOLLOUT : 0);
+	}
+
+	void add(Socket socket, uint32_t interest){
+		epoll_event event{};
+		event.events = toEvents(interest);
+		event.data.fd = socket;
+		epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &event);
+	}
+
+	void modify(Socket socket, uint32_t interest){
+		epoll_event event{};
+		event.events = toEvents(interest);
+		event.data.fd = socket;
+		epoll_ctl(epoll, EPOLL_CTL_MOD, socket, &event);
+	}
+
+	void remove(Socket socket){
+		epoll_event event{};
+		epoll_ctl(epoll, EPOLL_CTL_DEL, socket, &event);
+	}
+
+	void wake(){
+		uint64_t one = 1;
+		auto ret = ::write(wakeFd, &one, sizeof(one));
+		(void)ret;
+	}
+
+	template<typename Handler>
+	void wait(int timeoutMs, Handler handler){
+		int n = epoll_wait(epoll, ready.data(), ready.size(), timeoutMs);
+		for(int i = 0; i < n; i++){
+			auto & event = ready[i];
+			if(event.data.fd == wakeFd){
+				uint64_t count;
+				auto ret = ::read(wakeFd, &count, sizeof(count));
+				(void)ret;
+				continue;
+			}
+			handler(event.data.fd, event.events & EPOLLIN, event.events & EPOLLOUT, event.events & (EPOLLERR | EPOLLHUP));
+		}
+		if(n == int(ready.size())){
+			ready.resize(ready.size() * 2);
+		}
+	}
+#else
+	std::unordered_map<Socket, uint32_t> sockets;
+	std::vector<pollfd> fds;
+
+	bool setup(){
+		return true;
+	}
+
+	void add(Socket socket, uint32_t interest){
+		sockets[socket] = interest;
+	}
+
+	void modify(Socket socket, uint32_t interest){
+		sockets[socket] = interest;
+	}
+
+	void remove(Socket socket){
+		sockets.erase(socket);
+	}
+
+	void wake(){}
+
+	template<typename Handler>
+	void wait(int timeoutMs, Handler handler){
+		fds.clear();
+		for(auto & socket: sockets){
+			pollfd fd{};
+			fd.fd = socket.first;
+			fd.events = (socket.second & Read ? POLLIN : 0) | (socket.second & Write ? POLLOUT : 0);
+			fds.push_back(fd);
+		}
+	#ifdef TARGET_WIN32
+		int n = WSAPoll(fds.data(), ULONG(fds.size()), std::min(timeoutMs, 5));
+	#else
+		int n = ::poll(fds.data(), fds.size(), std::min(timeoutMs, 5));
+	#endif
+		for(std::size_t i = 0; i < fds.size() && n > 0; i++){
+			auto & fd = fds[i];
+			if(fd.revents == 0) continue;
+			n--;
+			handler(fd.fd, fd.revents & POLLIN, fd.revents & POLLOUT, fd.revents & (POLLERR | POLLHUP | POLLNVAL));
+		}
+	}
+#endif
+};
+
+//--------------------------------------------------------------
+ofxTCPReactor::ofxTCPReactor()
+:listener(INVALID_SOCKET){
+}
+
+//--------------------------------------------------------------
+ofxTCPReactor::~ofxTCPReactor(){
+	close();
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::setup(int port, std::size_t maxReceiveBuffer, std::size_t maxSendBuffer){
+	close();
+	this->maxReceiveBuffer = std::max(maxReceiveBuffer, std::size_t(1));
+	this->maxSendBuffer = maxSendBuffer;
+
+	poller.reset(new Poller);
+	if(!poller->setup()){
+		ofLogError("ofxTCPReactor") << "setup(): couldn't create poller";
+		ofxNetworkCheckError();
+		poller.reset();
+		return false;
+	}
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+	if(listener == INVALID_SOCKET){
+		ofxNetworkCheckError();
+		poller.reset();
+		return false;
+	}
+
+	sockaddr_in local;
+	memset(&local, 0, sizeof(sockaddr_in));
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = INADDR_ANY;
+	local.sin_port = htons(port);
+	if(::bind(listener, (sockaddr*)&local, sizeof(local)) != 0 || listen(listener, SOMAXCONN) != 0 || !setNonBlocking(listener)){
+		ofxNetworkCheckError();
+		closeSocket(listener);
+		listener = INVALID_SOCKET;
+		poller.reset();
+		return false;
+	}
+	poller->add(listener, Read);
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::close(){
+	for(auto & socket: sockets){
+		closeSocket(socket.first);
+	}
+	sockets.clear();
+	if(listener != INVALID_SOCKET){
+		closeSocket(listener);
+		listener = INVALID_SOCKET;
+	}
+	poller.reset();
+
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		for(auto & connection: connections){
+			std::unique_lock<std::mutex> connectionLock(connection.second->mutex);
+			connection.second->open = false;
+		}
+		connections.clear();
+		freeIds = decltype(freeIds)();
+		nextId = 0;
+	}
+	{
+		std::unique_lock<std::mutex> lock(pendingMutex);
+		pending.clear();
+	}
+	std::unique_lock<std::mutex> lock(eventsMutex);
+	events.clear();
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::poll(int timeoutMs){
+	if(!poller) return;
+
+	// requests from the app, data is sent as soon as it's queued and the
+	// socket is only watched for writing when it can't take all of it
+	{
+		std::unique_lock<std::mutex> lock(pendingMutex);
+		std::swap(pending, processing);
+	}
+	for(auto & connection: processing){
+		connection->pending = false;
+		bool closeRequested;
+		{
+			std::unique_lock<std::mutex> lock(connection->mutex);
+			closeRequested = connection->closeRequested;
+		}
+		if(closeRequested){
+			closeConnection(connection);
+		}else if(isWatched(connection)){
+			write(connection);
+			updateInterest(connection);
+		}
+	}
+	processing.clear();
+
+	poller->wait(timeoutMs, [&](Socket socket, bool readable, bool writable, bool error){
+		if(socket == listener){
+			accept();
+			return;
+		}
+		auto it = sockets.find(socket);
+		if(it == sockets.end()) return;
+		auto connection = it->second;
+		// errors and hang ups are reported with the data still unread, once
+		// it's read recv fails or returns 0 and the connection is closed
+		bool progress = (readable || error) && read(connection);
+		if(error && !progress) closeConnection(connection);
+		if(writable && isWatched(connection)) write(connection);
+		if(isWatched(connection)) updateInterest(connection);
+	});
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::wake(){
+	if(poller) poller->wake();
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::accept(){
+	while(true){
+		sockaddr_in address;
+	#ifdef TARGET_WIN32
+		int size = sizeof(address);
+	#else
+		socklen_t size = sizeof(address);
+	#endif
+		auto socket = ::accept(listener, (sockaddr*)&address, &size);
+		if(socket == INVALID_SOCKET){
+			auto error = lastError();
+			if(!wouldBlock(error) && error != OFXNETWORK_ERROR(CONNABORTED)){
+				ofxNetworkCheckError();
+			}
+			return;
+		}
+		if(!setNonBlocking(socket)){
+			ofxNetworkCheckError();
+			closeSocket(socket);
+			continue;
+		}
+		int noDelay = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (char*)&noDelay, sizeof(noDelay));
+
+		auto connection = std::make_shared<Connection>();
+		connection->socket = socket;
+		connection->ip = inet_ntoa(address.sin_addr);
+		connection->port = ntohs(address.sin_port);
+		connection->interest = Read;
+		{
+			std::unique_lock<std::mutex> lock(connectionsMutex);
+			if(freeIds.empty()){
+				connection->id = nextId++;
+			}else{
+				connection->id = freeIds.top();
+				freeIds.pop();
+			}
+			connections[connection->id] = connection;
+		}
+		sockets[socket] = connection;
+		poller->add(socket, Read);
+		ofLogVerbose("ofxTCPReactor") << "client " << connection->id << " connected from " << connection->ip << ":" << connection->port;
+		pushEvent(Event::Connected, connection);
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		connected.notify_all();
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::read(const ConnectionPtr & connection){
+	bool received = false;
+	bool closed = false;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		for(int i = 0; i < MAX_READS; i++){
+			std::size_t length;
+			auto buffer = connection->received.writable(maxReceiveBuffer, length);
+			if(!buffer) break;
+			auto ret = recv(connection->socket, buffer, int(length), 0);
+			if(ret > 0){
+				connection->received.commit(ret);
+				received = true;
+				if(std::size_t(ret) < length) break;
+			}else if(ret == 0 || !wouldBlock(lastError())){
+				closed = true;
+				break;
+			}else{
+				break;
+			}
+		}
+		if(received && !connection->notified){
+			connection->notified = true;
+			pushEvent(Event::Received, connection);
+		}
+	}
+	if(closed) closeConnection(connection);
+	return received || closed;
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::write(const ConnectionPtr & connection){
+	bool closed = false;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		auto & queue = connection->sendQueue;
+		while(!queue.empty()){
+			std::size_t total = 0;
+		#ifdef TARGET_WIN32
+			auto & chunk = queue.front();
+			total = chunk.data->size() - chunk.offset;
+			int ret = ::send(connection->socket, chunk.data->data() + chunk.offset, int(total), 0);
+		#else
+			iovec iov[MAX_SEND_CHUNKS];
+			int n = 0;
+			for(auto it = queue.begin(); it != queue.end() && n < MAX_SEND_CHUNKS; ++it, ++n){
+				iov[n].iov_base = (void*)(it->data->data() + it->offset);
+				iov[n].iov_len = it->data->size() - it->offset;
+				total += iov[n].iov_len;
+			}
+			auto ret = ::writev(connection->socket, iov, n);
+		#endif
+			if(ret < 0){
+				closed = !wouldBlock(lastError());
+				break;
+			}
+			std::size_t sent = ret;
+			connection->queuedBytes -= sent;
+			while(sent > 0){
+				auto & chunk = queue.front();
+				auto left = chunk.data->size() - chunk.offset;
+				if(sent >= left){
+					sent -= left;
+					queue.pop_front();
+				}else{
+					chunk.offset += sent;
+					sent = 0;
+				}
+			}
+			if(std::size_t(ret) < total) break;
+		}
+	}
+	if(closed) closeConnection(connection);
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::updateInterest(const ConnectionPtr & connection){
+	uint32_t interest;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		interest = (connection->received.size() < maxReceiveBuffer ? Read : 0) | (connection->sendQueue.empty() ? 0 : Write);
+	}
+	if(interest != connection->interest){
+		connection->interest = interest;
+		poller->modify(connection->socket, interest);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::closeConnection(const ConnectionPtr & connection){
+	if(!isWatched(connection)) return;
+	sockets.erase(connection->socket);
+	poller->remove(connection->socket);
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		closeSocket(connection->socket);
+		connection->open = false;
+		connection->sendQueue.clear();
+		connection->queuedBytes = 0;
+	}
+	ofLogVerbose("ofxTCPReactor") << "client " << connection->id << " disconnected";
+	pushEvent(Event::Disconnected, connection);
+	releaseIfDone(connection);
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::isWatched(const ConnectionPtr & connection) const{
+	auto it = sockets.find(connection->socket);
+	return it != sockets.end() && it->second == connection;
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::releaseIfDone(const ConnectionPtr & connection){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	auto it = connections.find(connection->id);
+	if(it == connections.end() || it->second != connection) return;
+	std::unique_lock<std::mutex> connectionLock(connection->mutex);
+	if(!connection->open && (connection->received.empty() || connection->closeRequested)){
+		connection->received.clear();
+		connections.erase(it);
+		freeIds.push(connection->id);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::release(const Event & event){
+	if(!event.connection) return;
+	{
+		std::unique_lock<std::mutex> lock(event.connection->mutex);
+		if(event.connection->open) return;
+		event.connection->closeRequested = true;
+	}
+	releaseIfDone(event.connection);
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::markPending(const ConnectionPtr & connection){
+	if(!connection->pending.exchange(true)){
+		std::unique_lock<std::mutex> lock(pendingMutex);
+		pending.push_back(connection);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::pushEvent(Event::Type type, const ConnectionPtr & connection){
+	std::unique_lock<std::mutex> lock(eventsMutex);
+	events.push_back({type, connection->id, connection});
+}
+
+//--------------------------------------------------------------
+ofxTCPReactor::ConnectionPtr ofxTCPReactor::find(int clientID){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	auto it = connections.find(clientID);
+	if(it == connections.end()) return nullptr;
+	return it->second;
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::send(int clientID, std::shared_ptr<const std::string> data){
+	if(!data || data->empty()) return false;
+	auto connection = find(clientID);
+	if(!connection) return false;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		if(!connection->open || connection->closeRequested) return false;
+		if(connection->queuedBytes + data->size() > maxSendBuffer){
+			ofLogWarning("ofxTCPReactor") << "send(): send buffer of client " << clientID << " full, dropping " << data->size() << " bytes";
+			return false;
+		}
+		connection->sendQueue.push_back({data, 0});
+		connection->queuedBytes += data->size();
+	}
+	markPending(connection);
+	wake();
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::sendToAll(std::shared_ptr<const std::string> data){
+	if(!data || data->empty()) return false;
+	std::size_t dropped = 0;
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		if(connections.empty()) return false;
+		for(auto & it: connections){
+			auto & connection = it.second;
+			{
+				std::unique_lock<std::mutex> connectionLock(connection->mutex);
+				if(!connection->open || connection->closeRequested) continue;
+				if(connection->queuedBytes + data->size() > maxSendBuffer){
+					dropped++;
+					continue;
+				}
+				connection->sendQueue.push_back({data, 0});
+				connection->queuedBytes += data->size();
+			}
+			markPending(connection);
+		}
+	}
+	if(dropped){
+		ofLogWarning("ofxTCPReactor") << "sendToAll(): send buffer full for " << dropped << " clients, dropping " << data->size() << " bytes";
+	}
+	wake();
+	return true;
+}
+
+//--------------------------------------------------------------
+int ofxTCPReactor::receive(int clientID, char * buffer, int size, bool peek){
+	auto connection = find(clientID);
+	if(!connection) return -1;
+	std::size_t read;
+	bool resume, done;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		resume = connection->received.size() >= maxReceiveBuffer;
+		read = connection->received.read(buffer, std::max(size, 0), peek);
+		done = !connection->open && connection->received.empty();
+	}
+	if(resume && read > 0 && !peek){
+		markPending(connection);
+		wake();
+	}
+	if(done) releaseIfDone(connection);
+	return int(read);
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::receiveMessage(int clientID, const std::string & delimiter, std::string & message, bool skipNull){
+	auto connection = find(clientID);
+	if(!connection) return false;
+	bool found, resume, done;
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		auto & received = connection->received;
+		auto position = received.find(delimiter);
+		found = position != std::string::npos;
+		resume = received.size() >= maxReceiveBuffer;
+		if(found){
+			message.resize(position);
+			received.read(&message[0], position, false);
+			received.consume(delimiter.size());
+			char next;
+			if(skipNull && received.read(&next, 1, true) && next == 0){
+				received.consume(1);
+			}
+		}else if(resume){
+			ofLogWarning("ofxTCPReactor") << "receiveMessage(): receive buffer of client " << clientID << " full without a delimiter, discarding it";
+			received.consume(received.size());
+		}
+		done = !connection->open && received.empty();
+	}
+	if(resume && (found || done)){
+		markPending(connection);
+		wake();
+	}
+	if(done) releaseIfDone(connection);
+	return found;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxTCPReactor::getNumReceivedBytes(int clientID){
+	auto connection = find(clientID);
+	if(!connection) return 0;
+	std::unique_lock<std::mutex> lock(connection->mutex);
+	return connection->received.size();
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::disconnect(int clientID){
+	auto connection = find(clientID);
+	if(!connection) return false;
+	{
+		// the socket is only closed from the thread calling poll() but
+		// shutting it down here lets the client know right away
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		connection->closeRequested = true;
+		connection->received.clear();
+		if(connection->open) shutdownSocket(connection->socket);
+	}
+	releaseIfDone(connection);
+	markPending(connection);
+	wake();
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::disconnectAll(){
+	std::vector<int> ids;
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		for(auto & connection: connections){
+			ids.push_back(connection.first);
+		}
+	}
+	for(auto id: ids){
+		disconnect(id);
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::isClientSetup(int clientID){
+	return find(clientID) != nullptr;
+}
+
+//--------------------------------------------------------------
+bool ofxTCPReactor::isConnected(int clientID){
+	auto connection = find(clientID);
+	if(!connection) return false;
+	std::unique_lock<std::mutex> lock(connection->mutex);
+	return connection->open && !connection->closeRequested;
+}
+
+//--------------------------------------------------------------
+std::string ofxTCPReactor::getIP(int clientID){
+	auto connection = find(clientID);
+	return connection ? connection->ip : "000.000.000.000";
+}
+
+//--------------------------------------------------------------
+int ofxTCPReactor::getPort(int clientID){
+	auto connection = find(clientID);
+	return connection ? connection->port : 0;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxTCPReactor::getNumClients(){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	return connections.size();
+}
+
+//--------------------------------------------------------------
+int ofxTCPReactor::getLastID(){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	return connections.empty() ? 0 : connections.rbegin()->first + 1;
+}
+
+//--------------------------------------------------------------
+void ofxTCPReactor::waitConnected(int timeoutMs){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	auto hasClients = [this]{ return !connections.empty(); };
+	if(timeoutMs < 0){
+		connected.wait(lock, hasClients);
+	}else{
+		connected.wait_for(lock, std::chrono::milliseconds(timeoutMs), hasClients);
+	}
+}
+
+//--------------------------------------------------------------
+std::vector<ofxTCPReactor::Event> ofxTCPReactor::takeEvents(){
+	std::vector<Event> taken;
+	{
+		std::unique_lock<std::mutex> lock(eventsMutex);
+		std::swap(taken, events);
+	}
+	for(auto & event: taken){
+		if(event.type == Event::Received){
+			std::unique_lock<std::mutex> lock(event.connection->mutex);
+			event.connection->notified = false;
+		}
+	}
+	return taken;
+}
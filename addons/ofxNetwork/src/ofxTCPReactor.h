@@ -0,0 +1,152 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofxTCPManager.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+
+/// \brief Event driven server used by ofxTCPServer in reactor mode.
+///
+/// All the connections are handled from one thread, that calls poll() in a
+/// loop, using epoll on linux and poll on other platforms. Sockets are non
+/// blocking, data received is buffered in a ring buffer per connection until
+/// the app reads it and data sent is queued per connection, so sending never
+/// blocks. Data sent to all the clients is queued once and referenced from
+/// every connection.
+///
+/// Connections, data received and disconnections are reported through a
+/// queue of events that the app takes with takeEvents().
+class ofxTCPReactor{
+public:
+#ifdef TARGET_WIN32
+	typedef SOCKET Socket;
+#else
+	typedef int Socket;
+#endif
+
+	struct Connection;
+
+	struct Event{
+		enum Type{
+			Connected,
+			Received,
+			Disconnected,
+		};
+		Type type;
+		int clientID;
+		std::shared_ptr<Connection> connection;
+	};
+
+	ofxTCPReactor();
+	~ofxTCPReactor();
+
+	ofxTCPReactor(const ofxTCPReactor &) = delete;
+	ofxTCPReactor & operator=(const ofxTCPReactor &) = delete;
+
+	/// \brief Starts listening on port.
+	/// \param maxReceiveBuffer bytes buffered per connection, once full the
+	/// connection isn't read until the app reads from it.
+	/// \param maxSendBuffer bytes queued per connection, sends over it fail.
+	bool setup(int port, std::size_t maxReceiveBuffer, std::size_t maxSendBuffer);
+
+	/// \brief Closes all the connections and the listening socket, the thread
+	/// calling poll() has to be stopped before.
+	void close();
+
+	/// \brief Waits up to timeoutMs for events and handles them, called in a
+	/// loop from the thread of the server.
+	void poll(int timeoutMs);
+
+	/// \brief Wakes up the thread waiting in poll().
+	void wake();
+
+	/// \brief Queues data to send to a client, without blocking.
+	bool send(int clientID, std::shared_ptr<const std::string> data);
+
+	/// \brief Queues data to send to all the clients, without copying it.
+	bool sendToAll(std::shared_ptr<const std::string> data);
+
+	/// \brief Reads up to size bytes received from a client.
+	/// \returns the number of bytes read, 0 if there's nothing to read or -1
+	/// if the client doesn't exist.
+	int receive(int clientID, char * buffer, int size, bool peek = false);
+
+	/// \brief Takes the next message ending in delimiter received from a
+	/// client, without the delimiter.
+	/// \param skipNull also take a null byte after the delimiter, that
+	/// ofxTCPClient::send() adds to every message.
+	bool receiveMessage(int clientID, const std::string & delimiter, std::string & message, bool skipNull = false);
+
+	std::size_t getNumReceivedBytes(int clientID);
+
+	/// \brief Closes the connection with a client, discarding the data not
+	/// sent yet.
+	bool disconnect(int clientID);
+	void disconnectAll();
+
+	bool isClientSetup(int clientID);
+	bool isConnected(int clientID);
+	std::string getIP(int clientID);
+	int getPort(int clientID);
+	std::size_t getNumClients();
+	int getLastID();
+
+	/// \brief Waits up to timeoutMs, or forever if negative, until there's at
+	/// least one client.
+	void waitConnected(int timeoutMs);
+
+	/// \brief Takes the events queued by the thread calling poll().
+	///
+	/// A Received event is queued only once until it's taken. A
+	/// Disconnected event releases the id of the client, so it can be
+	/// reused, unless it still has unread data.
+	std::vector<Event> takeEvents();
+
+	/// \brief Releases the id of a closed connection, discarding any unread
+	/// data.
+	void release(const Event & event);
+
+private:
+	struct Poller;
+	typedef std::shared_ptr<Connection> ConnectionPtr;
+
+	void accept();
+	bool read(const ConnectionPtr & connection);
+	void write(const ConnectionPtr & connection);
+	void closeConnection(const ConnectionPtr & connection);
+	void updateInterest(const ConnectionPtr & connection);
+	void markPending(const ConnectionPtr & connection);
+	void releaseIfDone(const ConnectionPtr & connection);
+	bool isWatched(const ConnectionPtr & connection) const;
+	void pushEvent(Event::Type type, const ConnectionPtr & connection);
+	ConnectionPtr find(int clientID);
+
+	Socket listener;
+	std::unique_ptr<Poller> poller;
+	std::size_t maxReceiveBuffer = 0;
+	std::size_t maxSendBuffer = 0;
+
+	// clients by id, locked before the mutex of any connection
+	std::map<int, ConnectionPtr> connections;
+	std::priority_queue<int, std::vector<int>, std::greater<int>> freeIds;
+	int nextId = 0;
+	std::mutex connectionsMutex;
+	std::condition_variable connected;
+
+	// only used from the thread calling poll(), a closed socket can be
+	// reused by a new client so entries are matched by connection too
+	std::unordered_map<Socket, ConnectionPtr> sockets;
+
+	// connections with data to send or requests from the app
+	std::vector<ConnectionPtr> pending;
+	std::vector<ConnectionPtr> processing;
+	std::mutex pendingMutex;
+
+	std::vector<Event> events;
+	std::mutex eventsMutex;
+};
@@ -35,6 +35,21 @@ bool ofxTCPServer::setup(int _port, bool blocking){
 
 //--------------------------
 bool ofxTCPServer::setup(const ofxTCPSettings &settings){
+	if(settings.reactor){
+		reactor.reset(new ofxTCPReactor);
+		if( !reactor->setup(settings.port, settings.maxReceiveBuffer, settings.maxSendBuffer) ){
+			ofLogError("ofxTCPServer") << "setup(): couldn't listen on port " << settings.port;
+			reactor.reset();
+			return false;
+		}
+		connected		= true;
+		port			= settings.port;
+		setMessageDelimiter(settings.messageDelimiter);
+		ofAddListener(ofEvents().update, this, &ofxTCPServer::update);
+		startThread();
+		return true;
+	}
+
 	if( !TCPServer.Create() ){
 		ofLogError("ofxTCPServer") << "setup(): couldn't create server";
 		return false;
@@ -66,6 +81,16 @@ void ofxTCPServer::setMessageDelimiter(std::string delim){
 
 //--------------------------
 bool ofxTCPServer::close(){
+	if(reactor){
+		ofRemoveListener(ofEvents().update, this, &ofxTCPServer::update);
+		stopThread();
+		reactor->wake();
+		waitForThread(false);
+		reactor->close();
+		reactor.reset();
+		connected = false;
+		return true;
+	}
     stopThread();
 	if( !TCPServer.Close() ){
 		ofLogWarning("ofxTCPServer") << "close(): couldn't close connections";
@@ -84,6 +109,13 @@ ofxTCPClient & ofxTCPServer::getClient(int clientID){
 
 //--------------------------
 bool ofxTCPServer::disconnectClient(int clientID){
+	if(reactor){
+		if( !reactor->disconnect(clientID) ){
+			ofLogWarning("ofxTCPServer") << "disconnectClient(): client " << clientID << " doesn't exist";
+			return false;
+		}
+		return true;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "disconnectClient(): client " << clientID << " doesn't exist";
@@ -97,6 +129,10 @@ bool ofxTCPServer::disconnectClient(int clientID){
 
 //--------------------------
 bool ofxTCPServer::disconnectAllClients(){
+	if(reactor){
+		reactor->disconnectAll();
+		return true;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
     TCPConnections.clear();
     return true;
@@ -104,6 +140,17 @@ bool ofxTCPServer::disconnectAllClients(){
 
 //--------------------------
 bool ofxTCPServer::send(int clientID, std::string message){
+	if(reactor){
+		// same format as ofxTCPClient::send
+		auto data = std::make_shared<std::string>(std::move(message));
+		*data += messageDelimiter;
+		*data += (char)0;
+		if( !reactor->isClientSetup(clientID) ){
+			ofLogWarning("ofxTCPServer") << "send(): client " << clientID << " doesn't exist";
+			return false;
+		}
+		return reactor->send(clientID, data);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "send(): client " << clientID << " doesn't exist";
@@ -117,6 +164,12 @@ bool ofxTCPServer::send(int clientID, std::string message){
 
 //--------------------------
 bool ofxTCPServer::sendToAll(std::string message){
+	if(reactor){
+		auto data = std::make_shared<std::string>(std::move(message));
+		*data += messageDelimiter;
+		*data += (char)0;
+		return reactor->sendToAll(data);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if(TCPConnections.size() == 0) return false;
 
@@ -133,6 +186,17 @@ bool ofxTCPServer::sendToAll(std::string message){
 
 //--------------------------
 std::string ofxTCPServer::receive(int clientID){
+	if(reactor){
+		if( !reactor->isClientSetup(clientID) ){
+			ofLogWarning("ofxTCPServer") << "receive(): client " << clientID << " doesn't exist";
+			return "client " + ofToString(clientID) + "doesn't exist";
+		}
+		std::string message;
+		reactor->receiveMessage(clientID, messageDelimiter, message, true);
+		// messages sent with ofxTCPClient::send end in a null byte
+		message.erase(std::remove(message.begin(), message.end(), (char)0), message.end());
+		return message;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "receive(): client " << clientID << " doesn't exist";
@@ -149,6 +213,14 @@ std::string ofxTCPServer::receive(int clientID){
 
 //--------------------------
 bool ofxTCPServer::sendRawBytes(int clientID, const char * rawBytes, const int numBytes){
+	if(reactor){
+		if( !reactor->isClientSetup(clientID) ){
+			ofLogWarning("ofxTCPServer") << "sendRawBytes(): client " << clientID << " doesn't exist";
+			return false;
+		}
+		if(numBytes <= 0) return false;
+		return reactor->send(clientID, std::make_shared<std::string>(rawBytes, numBytes));
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "sendRawBytes(): client " << clientID << " doesn't exist";
@@ -162,6 +234,10 @@ bool ofxTCPServer::sendRawBytes(int clientID, const char * rawBytes, const int n
 
 //--------------------------
 bool ofxTCPServer::sendRawBytesToAll(const char * rawBytes, const int numBytes){
+	if(reactor){
+		if(numBytes <= 0) return false;
+		return reactor->sendToAll(std::make_shared<std::string>(rawBytes, numBytes));
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if(TCPConnections.size() == 0 || numBytes <= 0) return false;
 
@@ -176,6 +252,16 @@ bool ofxTCPServer::sendRawBytesToAll(const char * rawBytes, const int numBytes){
 
 //--------------------------
 bool ofxTCPServer::sendRawMsg(int clientID, const char * rawBytes, const int numBytes){
+	if(reactor){
+		if( !reactor->isClientSetup(clientID) ){
+			ofLogWarning("ofxTCPServer") << "sendRawMsg(): client " << clientID << " doesn't exist";
+			return false;
+		}
+		if(numBytes <= 0) return false;
+		auto data = std::make_shared<std::string>(rawBytes, numBytes);
+		*data += messageDelimiter;
+		return reactor->send(clientID, data);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "sendRawMsg(): client " << clientID << " doesn't exist";
@@ -188,6 +274,12 @@ bool ofxTCPServer::sendRawMsg(int clientID, const char * rawBytes, const int num
 
 //--------------------------
 bool ofxTCPServer::sendRawMsgToAll(const char * rawBytes, const int numBytes){
+	if(reactor){
+		if(numBytes <= 0) return false;
+		auto data = std::make_shared<std::string>(rawBytes, numBytes);
+		*data += messageDelimiter;
+		return reactor->sendToAll(data);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if(TCPConnections.empty() || numBytes <= 0) return false;
 
@@ -201,6 +293,10 @@ bool ofxTCPServer::sendRawMsgToAll(const char * rawBytes, const int numBytes){
 
 //--------------------------
 int ofxTCPServer::getNumReceivedBytes(int clientID){
+	if(reactor){
+		// bytes waiting in the buffer of the client
+		return reactor->getNumReceivedBytes(clientID);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "getNumReceivedBytes(): client " << clientID << " doesn't exist";
@@ -212,6 +308,14 @@ int ofxTCPServer::getNumReceivedBytes(int clientID){
 
 //--------------------------
 int ofxTCPServer::receiveRawBytes(int clientID, char * receiveBytes,  int numBytes){
+	if(reactor){
+		auto ret = reactor->receive(clientID, receiveBytes, numBytes);
+		if(ret < 0){
+			ofLogWarning("ofxTCPServer") << "receiveRawBytes(): client " << clientID << " doesn't exist";
+			return 0;
+		}
+		return ret;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "receiveRawBytes(): client " << clientID << " doesn't exist";
@@ -224,6 +328,9 @@ int ofxTCPServer::receiveRawBytes(int clientID, char * receiveBytes,  int numByt
 
 //--------------------------
 int ofxTCPServer::peekReceiveRawBytes(int clientID, char * receiveBytes,  int numBytes){
+	if(reactor){
+		return std::max(reactor->receive(clientID, receiveBytes, numBytes, true), 0);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLog(OF_LOG_WARNING, "ofxTCPServer: client " + ofToString(clientID) + " doesn't exist");
@@ -235,6 +342,18 @@ int ofxTCPServer::peekReceiveRawBytes(int clientID, char * receiveBytes,  int nu
 
 //--------------------------
 int ofxTCPServer::receiveRawMsg(int clientID, char * receiveBytes,  int numBytes){
+	if(reactor){
+		std::string message;
+		if( !reactor->receiveMessage(clientID, messageDelimiter, message) ){
+			return 0;
+		}
+		if((int)message.size() > numBytes){
+			ofLogWarning("ofxTCPServer") << "receiveRawMsg(): message of " << message.size() << " bytes doesn't fit in the buffer, truncating it";
+		}
+		int size = std::min((int)message.size(), numBytes);
+		memcpy(receiveBytes, message.data(), size);
+		return size;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "receiveRawMsg(): client " << clientID << " doesn't exist";
@@ -246,6 +365,9 @@ int ofxTCPServer::receiveRawMsg(int clientID, char * receiveBytes,  int numBytes
 
 //--------------------------
 int ofxTCPServer::getClientPort(int clientID){
+	if(reactor){
+		return reactor->getPort(clientID);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "getClientPort(): client " << clientID << " doesn't exist";
@@ -256,6 +378,9 @@ int ofxTCPServer::getClientPort(int clientID){
 
 //--------------------------
 std::string ofxTCPServer::getClientIP(int clientID){
+	if(reactor){
+		return reactor->getIP(clientID);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if( !isClientSetup(clientID) ){
 		ofLogWarning("ofxTCPServer") << "getClientIP(): client " << clientID << " doesn't exist";
@@ -266,11 +391,17 @@ std::string ofxTCPServer::getClientIP(int clientID){
 
 //--------------------------
 int ofxTCPServer::getNumClients(){
+	if(reactor){
+		return reactor->getNumClients();
+	}
 	return TCPConnections.size();
 }
 
 //--------------------------
 int ofxTCPServer::getLastID(){
+	if(reactor){
+		return reactor->getLastID();
+	}
 	return idCount;
 }
 
@@ -291,12 +422,19 @@ bool ofxTCPServer::isClientSetup(int clientID){
 
 //--------------------------
 bool ofxTCPServer::isClientConnected(int clientID){
+	if(reactor){
+		return reactor->isConnected(clientID);
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	return isClientSetup(clientID) && getClient(clientID).isConnected();
 }
 
 
 void ofxTCPServer::waitConnectedClient(){
+	if(reactor){
+		reactor->waitConnected(-1);
+		return;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if(TCPConnections.empty()){
 		serverReady.wait(lck);
@@ -304,16 +442,70 @@ void ofxTCPServer::waitConnectedClient(){
 }
 
 void ofxTCPServer::waitConnectedClient(int ms){
+	if(reactor){
+		reactor->waitConnected(ms);
+		return;
+	}
 	std::unique_lock<std::mutex> lck( mConnectionsLock );
 	if(TCPConnections.empty()){
 		serverReady.wait_for(lck, std::chrono::milliseconds(ms));
 	}
 }
 
+//--------------------------
+bool ofxTCPServer::isReactor(){
+	return reactor != nullptr;
+}
+
+//--------------------------
+void ofxTCPServer::update(ofEventArgs &){
+	dispatchEvents();
+}
+
+//--------------------------
+void ofxTCPServer::dispatchEvents(){
+	if(!reactor) return;
+	for(auto & event: reactor->takeEvents()){
+		int clientID = event.clientID;
+		switch(event.type){
+		case ofxTCPReactor::Event::Connected:
+			ofNotifyEvent(clientConnected, clientID, this);
+			break;
+		case ofxTCPReactor::Event::Received:
+			if(messageReceived.size()){
+				ofxTCPMessageEventArgs args;
+				args.clientID = clientID;
+				while(reactor->receiveMessage(clientID, messageDelimiter, args.message, true)){
+					args.message.erase(std::remove(args.message.begin(), args.message.end(), (char)0), args.message.end());
+					ofNotifyEvent(messageReceived, args, this);
+				}
+			}
+			break;
+		case ofxTCPReactor::Event::Disconnected:
+			ofNotifyEvent(clientDisconnected, clientID, this);
+			// the messages were already notified, anything left is an
+			// incomplete message that won't be received anymore
+			if(messageReceived.size()){
+				reactor->release(event);
+			}
+			break;
+		}
+	}
+}
+
 //don't call this
 //--------------------------
 void ofxTCPServer::threadedFunction(){
 
+	if(reactor){
+		ofLogVerbose("ofxTCPServer") << "reactor thread started";
+		while( isThreadRunning() ){
+			reactor->poll(100);
+		}
+		ofLogVerbose("ofxTCPServer") << "reactor thread stopped";
+		return;
+	}
+
 	ofLogVerbose("ofxTCPServer") << "listening thread started";
 	while( isThreadRunning() ){
 		
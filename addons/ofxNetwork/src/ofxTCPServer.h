@@ -4,6 +4,8 @@
 #include "ofThread.h"
 #include "ofxTCPManager.h"
 #include "ofxTCPSettings.h"
+#include "ofxTCPReactor.h"
+#include "ofEvents.h"
 #include <map>
 #include <condition_variable>
 
@@ -12,6 +14,20 @@
 //forward decleration
 class ofxTCPClient;
 
+class ofxTCPMessageEventArgs: public ofEventArgs{
+public:
+	int clientID;
+	std::string message;
+};
+
+// by default the server accepts up to TCP_MAX_CLIENTS clients from a thread
+// and sending and receiving from them happens directly on their sockets.
+//
+// in reactor mode, setting reactor in ofxTCPSettings, one thread handles
+// thousands of clients without blocking: sends are queued and return
+// immediately, sendToAll queues the same data for every client without
+// copying it and receiving reads from a buffer per client. The events
+// below are notified in update, or when calling dispatchEvents()
 class ofxTCPServer : public ofThread{
 
 	public:
@@ -90,11 +106,24 @@ class ofxTCPServer : public ofThread{
 		void waitConnectedClient();
 		void waitConnectedClient(int ms);
 
+		bool isReactor();
+
+		//reactor mode only: notifies the events queued by the
+		//network thread, called automatically on every update
+		void dispatchEvents();
+
+		//every message received, if there's any listener the
+		//messages are not available anymore through receive()
+		ofEvent<ofxTCPMessageEventArgs> messageReceived;
+		ofEvent<int> clientConnected;
+		ofEvent<int> clientDisconnected;
+
 	private:
 		ofxTCPClient & getClient(int clientID);
 		bool isClientSetup(int clientID);
 
 		void threadedFunction();
+		void update(ofEventArgs & args);
 
 		ofxTCPManager			TCPServer;
 		std::map<int,std::shared_ptr<ofxTCPClient> >	TCPConnections;
@@ -107,4 +136,6 @@ class ofxTCPServer : public ofThread{
 		bool			bClientBlocking;
 		std::string			messageDelimiter;
 
+		std::unique_ptr<ofxTCPReactor> reactor;
+
 };
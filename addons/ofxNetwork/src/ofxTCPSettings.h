@@ -16,4 +16,11 @@ public:
 
 	std::string messageDelimiter = "[/TCP]";
 
+	// servers only: handle all the clients from one thread using epoll, or
+	// poll where it's not available, see ofxTCPReactor. Sends never block and
+	// data received is buffered per client up to maxReceiveBuffer bytes
+	bool reactor = false;
+	size_t maxReceiveBuffer = 1024 * 1024;
+	size_t maxSendBuffer = 8 * 1024 * 1024;
+
 };
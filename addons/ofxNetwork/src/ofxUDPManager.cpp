@@ -5,12 +5,127 @@
 #include "ofxNetwork.h"
 #include "ofLog.h"
 #include "ofUtils.h"
+#include <algorithm>
 
 using namespace std;
 
+// packets passed to each recvmmsg or sendmmsg call, the headers are on the
+// stack
+static const int MAX_BATCH_HEADERS = 64;
+
 //--------------------------------------------------------------------------------
 bool ofxUDPManager::m_bWinsockInit= false;
 
+//--------------------------------------------------------------------------------
+string ofxUDPPacket::getAddress() const{
+	return inet_ntoa(address.sin_addr);
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPPacket::getPort() const{
+	return ntohs(address.sin_port);
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBatch::ofxUDPPacketBatch(std::size_t numPackets, int maxPacketSize){
+	allocate(numPackets, maxPacketSize);
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPPacketBatch::allocate(std::size_t numPackets, int maxPacketSize){
+	this->maxPacketSize = max(maxPacketSize, 0);
+	arena.assign(numPackets * this->maxPacketSize, 0);
+	packets.assign(numPackets, ofxUDPPacket());
+	for(std::size_t i = 0; i < numPackets; i++){
+		packets[i].data = arena.data() + i * this->maxPacketSize;
+		packets[i].capacity = this->maxPacketSize;
+	}
+	clear();
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPPacketBatch::add(const char * data, int size){
+	if(count == packets.size() || size < 0 || size > maxPacketSize){
+		return false;
+	}
+	auto & packet = packets[count++];
+	memcpy(packet.data, data, size);
+	packet.size = size;
+	memset(&packet.address, 0, sizeof(packet.address));
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPPacketBatch::add(const char * data, int size, const string & address, unsigned short port){
+	if(!add(data, size)){
+		return false;
+	}
+	auto & packet = packets[count - 1];
+	packet.address.sin_family = AF_INET;
+	packet.address.sin_addr.s_addr = inet_addr(address.c_str());
+	packet.address.sin_port = htons(port);
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPPacketBatch::clear(){
+	count = 0;
+	for(auto & packet: packets){
+		packet.size = 0;
+		memset(&packet.address, 0, sizeof(packet.address));
+	}
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxUDPPacketBatch::size() const{
+	return count;
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxUDPPacketBatch::capacity() const{
+	return packets.size();
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPPacketBatch::empty() const{
+	return count == 0;
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPPacketBatch::getMaxPacketSize() const{
+	return maxPacketSize;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacket & ofxUDPPacketBatch::operator[](std::size_t i){
+	return packets[i];
+}
+
+//--------------------------------------------------------------------------------
+const ofxUDPPacket & ofxUDPPacketBatch::operator[](std::size_t i) const{
+	return packets[i];
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacket * ofxUDPPacketBatch::begin(){
+	return packets.data();
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacket * ofxUDPPacketBatch::end(){
+	return packets.data() + count;
+}
+
+//--------------------------------------------------------------------------------
+const ofxUDPPacket * ofxUDPPacketBatch::begin() const{
+	return packets.data();
+}
+
+//--------------------------------------------------------------------------------
+const ofxUDPPacket * ofxUDPPacketBatch::end() const{
+	return packets.data() + count;
+}
+
 //--------------------------------------------------------------------------------
 ofxUDPManager::ofxUDPManager()
 {
@@ -340,6 +455,71 @@ int	ofxUDPManager::SendAll(const char*	pBuff, const int iSize)
 	return total;
 }
 
+//--------------------------------------------------------------------------------
+int ofxUDPManager::SendBatch(const ofxUDPPacket * packets, int numPackets)
+{
+	if (m_hSocket == INVALID_SOCKET) return(SOCKET_ERROR);
+	if (numPackets <= 0) return 0;
+
+	if (m_dwTimeoutSend	!= NO_TIMEOUT){
+		auto ret = WaitSend(m_dwTimeoutSend,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	int sent = 0;
+	int ret = 0;
+	while(sent < numPackets){
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+		mmsghdr headers[MAX_BATCH_HEADERS];
+		iovec iovecs[MAX_BATCH_HEADERS];
+		int n = min(numPackets - sent, MAX_BATCH_HEADERS);
+		memset(headers, 0, sizeof(mmsghdr) * n);
+		for(int i = 0; i < n; i++){
+			auto & packet = packets[sent + i];
+			iovecs[i].iov_base = packet.data;
+			iovecs[i].iov_len = packet.size;
+			headers[i].msg_hdr.msg_name = (void*)(packet.address.sin_port ? &packet.address : &saClient);
+			headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			headers[i].msg_hdr.msg_iov = &iovecs[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+		ret = sendmmsg(m_hSocket, headers, n, 0);
+		if(ret <= 0){
+			break;
+		}
+		sent += ret;
+		if(ret < n){
+			// the socket buffer is full
+			return sent;
+		}
+#else
+		auto & packet = packets[sent];
+		auto to = packet.address.sin_port ? &packet.address : &saClient;
+		ret = sendto(m_hSocket, packet.data, packet.size, 0, (sockaddr *)to, sizeof(sockaddr));
+		if(ret < 0){
+			break;
+		}
+		sent += 1;
+#endif
+	}
+
+	if(ret < 0){
+		int SocketError = ofxNetworkCheckError();
+		if(sent == 0 && SocketError != OFXNETWORK_ERROR(WOULDBLOCK)){
+			return SOCKET_ERROR;
+		}
+	}
+	return sent;
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPManager::SendBatch(const ofxUDPPacketBatch & batch)
+{
+	return SendBatch(batch.packets.data(), batch.size());
+}
+
 
 //--------------------------------------------------------------------------------
 //	returns number of bytes wiating or SOCKET_ERROR if error
@@ -429,6 +609,114 @@ int	ofxUDPManager::Receive(char* pBuff, const int iSize)
 	//	return(recvfrom(m_hSocket, pBuff, iSize, 0));
 }
 
+//--------------------------------------------------------------------------------
+int ofxUDPManager::ReceiveBatch(ofxUDPPacket * packets, int numPackets)
+{
+	if (m_hSocket == INVALID_SOCKET){
+		ofLogError("ofxUDPManager") << "INVALID_SOCKET";
+		return(SOCKET_ERROR);
+	}
+	if (numPackets <= 0) return 0;
+
+	if (m_dwTimeoutReceive	!= NO_TIMEOUT){
+		auto ret = WaitReceive(m_dwTimeoutReceive,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	int received = 0;
+	int ret = 0;
+	while(received < numPackets){
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+		mmsghdr headers[MAX_BATCH_HEADERS];
+		iovec iovecs[MAX_BATCH_HEADERS];
+		int n = min(numPackets - received, MAX_BATCH_HEADERS);
+		memset(headers, 0, sizeof(mmsghdr) * n);
+		for(int i = 0; i < n; i++){
+			auto & packet = packets[received + i];
+			iovecs[i].iov_base = packet.data;
+			iovecs[i].iov_len = packet.capacity;
+			headers[i].msg_hdr.msg_name = &packet.address;
+			headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			headers[i].msg_hdr.msg_iov = &iovecs[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+		// only waits for the first packet, the rest are taken if they are
+		// already queued
+		ret = recvmmsg(m_hSocket, headers, n, received == 0 ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+		if(ret <= 0){
+			break;
+		}
+		for(int i = 0; i < ret; i++){
+			packets[received + i].size = headers[i].msg_len;
+		}
+		received += ret;
+		if(ret < n){
+			break;
+		}
+#else
+		if(received > 0){
+			// the first packet waits like Receive(), stop once the queue is
+			// empty instead of blocking again
+			#ifdef TARGET_WIN32
+				unsigned long size = 0;
+				int retVal = ioctlsocket(m_hSocket,FIONREAD,&size);
+			#else
+				int size  = 0;
+				int retVal = ioctl(m_hSocket,FIONREAD,&size);
+			#endif
+			if(retVal != 0 || size == 0){
+				break;
+			}
+		}
+		#ifndef TARGET_WIN32
+			socklen_t nLen= sizeof(sockaddr);
+		#else
+			int	nLen= sizeof(sockaddr);
+		#endif
+		auto & packet = packets[received];
+		ret = recvfrom(m_hSocket, packet.data, packet.capacity, 0, (sockaddr *)&packet.address, &nLen);
+		#ifdef TARGET_WIN32
+			// windows fails on packets bigger than the buffer instead of
+			// truncating them, but the buffer is still filled
+			if(ret == SOCKET_ERROR && WSAGetLastError() == WSAEMSGSIZE){
+				ret = packet.capacity;
+			}
+		#endif
+		if(ret < 0){
+			break;
+		}
+		packet.size = min(ret, packet.capacity);
+		received += 1;
+#endif
+	}
+
+	if(received > 0){
+		saClient = packets[received - 1].address;
+		canGetRemoteAddress = true;
+	}else{
+		canGetRemoteAddress = false;
+	}
+
+	if(ret < 0){
+		//	no data in a non blocking socket isn't an error, as in Receive()
+		int SocketError = ofxNetworkCheckError();
+		if(received == 0 && SocketError != OFXNETWORK_ERROR(WOULDBLOCK)){
+			return SOCKET_ERROR;
+		}
+	}
+	return received;
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPManager::ReceiveBatch(ofxUDPPacketBatch & batch)
+{
+	int ret = ReceiveBatch(batch.packets.data(), batch.capacity());
+	batch.count = max(ret, 0);
+	return ret;
+}
+
 void ofxUDPManager::SetTimeoutSend(int	timeoutInSeconds)
 {
 	m_dwTimeoutSend= timeoutInSeconds;
@@ -61,12 +61,23 @@ UDP Multicast (receiving):
 ...
 x) Close()
 
+Batches (sending or receiving):
+--------------
+
+1) ofxUDPPacketBatch batch(numPackets, maxPacketSize)
+2) batch.add() and SendBatch(batch), or ReceiveBatch(batch)
+3) read batch[i]
+...
+
+ofxUDPReceiver receives batches from a thread.
+
 --------------------------------------------------------------------------------*/
 #include "ofConstants.h"
 #include "ofxUDPSettings.h"
 #include <string.h>
 #include <wchar.h>
 #include <stdio.h>
+#include <vector>
 
 #ifndef TARGET_WIN32
 
@@ -104,6 +115,71 @@ x) Close()
 /// Socket constants.
 #define SOCKET_TIMEOUT			SOCKET_ERROR - 1
 
+/// \brief A datagram sent or received with ofxUDPManager::SendBatch() and
+/// ReceiveBatch(), pointing to memory owned by an ofxUDPPacketBatch.
+struct ofxUDPPacket{
+	char * data = nullptr;
+
+	/// \brief Bytes received or to send.
+	int size = 0;
+
+	/// \brief Bytes available in data, larger datagrams are truncated when
+	/// received.
+	int capacity = 0;
+
+	/// \brief Source of a packet received or destination of a packet to
+	/// send. Packets to send with port 0 go to the address passed to
+	/// Connect().
+	struct sockaddr_in address;
+
+	std::string getAddress() const;
+	int getPort() const;
+};
+
+/// \brief A batch of packets allocated in one buffer, so receiving or
+/// sending them doesn't allocate.
+class ofxUDPPacketBatch{
+public:
+	ofxUDPPacketBatch(){}
+	ofxUDPPacketBatch(std::size_t numPackets, int maxPacketSize = 1472);
+
+	/// \brief Allocates numPackets packets of maxPacketSize bytes each. The
+	/// default is the largest datagram that fits in an ethernet frame.
+	void allocate(std::size_t numPackets, int maxPacketSize = 1472);
+
+	/// \brief Copies data to the next free packet, to send it to the
+	/// connected address.
+	/// \returns false if the batch is full or the data too large.
+	bool add(const char * data, int size);
+
+	/// \brief Copies data to the next free packet, to send it to address and
+	/// port.
+	bool add(const char * data, int size, const std::string & address, unsigned short port);
+
+	/// \brief Removes all the packets, keeping the memory allocated.
+	void clear();
+
+	/// \brief Number of packets added or received.
+	std::size_t size() const;
+	std::size_t capacity() const;
+	bool empty() const;
+	int getMaxPacketSize() const;
+
+	ofxUDPPacket & operator[](std::size_t i);
+	const ofxUDPPacket & operator[](std::size_t i) const;
+	ofxUDPPacket * begin();
+	ofxUDPPacket * end();
+	const ofxUDPPacket * begin() const;
+	const ofxUDPPacket * end() const;
+
+private:
+	friend class ofxUDPManager;
+	std::vector<char> arena;
+	std::vector<ofxUDPPacket> packets;
+	std::size_t count = 0;
+	int maxPacketSize = 0;
+};
+
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
 
@@ -134,6 +210,23 @@ public:
 	int  SendAll(const char* pBuff, const int iSize);
 	int  PeekReceive();			//	return number of bytes waiting
 	int  Receive(char* pBuff, const int iSize);
+	/// \brief Receives up to numPackets datagrams with as few system calls as
+	/// possible, recvmmsg on linux.
+	///
+	/// Waits like Receive() for the first packet and then takes only the
+	/// ones already queued.
+	/// \returns the number of packets received, 0 if there's none in a non
+	/// blocking socket, SOCKET_TIMEOUT or SOCKET_ERROR.
+	int  ReceiveBatch(ofxUDPPacket * packets, int numPackets);
+	/// \brief Fills the batch up to its capacity, its size is the number of
+	/// packets received.
+	int  ReceiveBatch(ofxUDPPacketBatch & batch);
+	/// \brief Sends numPackets datagrams with as few system calls as
+	/// possible, sendmmsg on linux.
+	/// \returns the number of packets sent, less than numPackets if a non
+	/// blocking socket's buffer fills, SOCKET_TIMEOUT or SOCKET_ERROR.
+	int  SendBatch(const ofxUDPPacket * packets, int numPackets);
+	int  SendBatch(const ofxUDPPacketBatch & batch);
 	void SetTimeoutSend(int timeoutInSeconds);
 	void SetTimeoutReceive(int timeoutInSeconds);
 	int  GetTimeoutSend();
@@ -153,6 +246,8 @@ public:
 	bool SetTTL(int nTTL);
 
 protected:
+	friend class ofxUDPReceiver;
+
 	#ifdef TARGET_WIN32
 		SOCKET m_hSocket;
 	#else
@@ -0,0 +1,175 @@
+#include "ofxUDPReceiver.h"
+#include "ofLog.h"
+#include <limits>
+
+using namespace std;
+
+//--------------------------------------------------------------------------------
+void ofxUDPReceiver::Queue::allocate(std::size_t capacity){
+	// one slot is always empty to tell a full ring from an empty one
+	items.assign(capacity + 1, nullptr);
+	head = 0;
+	tail = 0;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPReceiver::Queue::push(ofxUDPPacketBatch * batch){
+	auto t = tail.load(memory_order_relaxed);
+	auto next = (t + 1) % items.size();
+	if(next == head.load(memory_order_acquire)){
+		return false;
+	}
+	items[t] = batch;
+	tail.store(next, memory_order_release);
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBatch * ofxUDPReceiver::Queue::pop(){
+	auto h = head.load(memory_order_relaxed);
+	if(h == tail.load(memory_order_acquire)){
+		return nullptr;
+	}
+	auto batch = items[h];
+	head.store((h + 1) % items.size(), memory_order_release);
+	return batch;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPReceiver::~ofxUDPReceiver(){
+	close();
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPReceiver::setup(const ofxUDPSettings & settings, std::size_t numBatches, std::size_t packetsPerBatch, int maxPacketSize){
+	close();
+
+	auto receiverSettings = settings;
+	receiverSettings.blocking = false;
+	receiverSettings.receiveTimeout = NO_TIMEOUT;
+	if(!manager.Setup(receiverSettings)){
+		manager.Close();
+		return false;
+	}
+
+	if(settings.receiveBufferSize == 0){
+		auto wanted = numBatches * packetsPerBatch * maxPacketSize;
+		wanted = min<std::size_t>(wanted, std::numeric_limits<int>::max());
+		if(manager.GetReceiveBufferSize() < int(wanted)){
+			manager.SetReceiveBufferSize(wanted);
+		}
+		// the OS silently limits it, net.core.rmem_max on linux
+		auto size = manager.GetReceiveBufferSize();
+		if(size < int(wanted)){
+			ofLogNotice("ofxUDPReceiver") << "setup(): receive buffer limited by the OS to " << size << " bytes, "
+				<< wanted << " requested";
+		}
+	}
+
+	numBatches = max<std::size_t>(numBatches, 1);
+	batches.resize(numBatches);
+	received.allocate(numBatches);
+	released.allocate(numBatches);
+	for(auto & batch: batches){
+		batch.allocate(packetsPerBatch, maxPacketSize);
+		released.push(&batch);
+	}
+	numPackets = 0;
+	numStalls = 0;
+
+	startThread();
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPReceiver::close(){
+	if(isThreadRunning()){
+		waitForThread(true);
+	}
+	if(manager.HasSocket()){
+		manager.Close();
+	}
+	batches.clear();
+	received.allocate(0);
+	released.allocate(0);
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBatch * ofxUDPReceiver::receive(){
+	if(batches.empty()){
+		return nullptr;
+	}
+	return received.pop();
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPReceiver::release(ofxUDPPacketBatch * batch){
+	if(batch && !batches.empty()){
+		released.push(batch);
+	}
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxUDPReceiver::receive(std::function<void(const ofxUDPPacket &)> function){
+	std::size_t count = 0;
+	while(auto batch = receive()){
+		for(auto & packet: *batch){
+			function(packet);
+		}
+		count += batch->size();
+		release(batch);
+	}
+	return count;
+}
+
+//--------------------------------------------------------------------------------
+uint64_t ofxUDPReceiver::getNumPacketsReceived() const{
+	return numPackets;
+}
+
+//--------------------------------------------------------------------------------
+uint64_t ofxUDPReceiver::getNumStalls() const{
+	return numStalls;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPManager & ofxUDPReceiver::getManager(){
+	return manager;
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPReceiver::threadedFunction(){
+	ofxUDPPacketBatch * batch = nullptr;
+	while(isThreadRunning()){
+		if(!batch){
+			batch = released.pop();
+			if(!batch){
+				numStalls++;
+				while(isThreadRunning() && !(batch = released.pop())){
+					sleep(1);
+				}
+				continue;
+			}
+		}
+
+		// wait with a timeout so the thread can be stopped
+		auto wait = manager.WaitReceive(0, 100000);
+		if(wait == SOCKET_ERROR){
+			sleep(1);
+			continue;
+		}else if(wait != 0){
+			continue;
+		}
+		auto ret = manager.ReceiveBatch(*batch);
+		if(ret > 0){
+			numPackets += ret;
+			received.push(batch);
+			batch = nullptr;
+		}else if(ret == SOCKET_ERROR){
+			// errors like an icmp port unreachable only affect one packet,
+			// keep receiving but don't spin if the error persists
+			ofLogError("ofxUDPReceiver") << "threadedFunction(): error receiving";
+			sleep(1);
+		}
+	}
+}
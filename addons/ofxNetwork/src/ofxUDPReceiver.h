@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofThread.h"
+#include "ofxUDPManager.h"
+#include <atomic>
+#include <functional>
+
+/// \brief Receives UDP packets from a thread, in batches.
+///
+/// The thread receives into a pool of batches allocated in setup() and hands
+/// the full ones to the app through a lock-free queue. The app gives them
+/// back with release() once read, through another queue, so nothing is
+/// allocated or locked while receiving:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// ofxUDPSettings settings;
+/// settings.receiveOn(11999);
+/// receiver.setup(settings);
+///
+/// // update
+/// receiver.receive([&](const ofxUDPPacket & packet){
+///     parse(packet.data, packet.size);
+/// });
+/// ~~~~
+///
+/// If the app doesn't read the batches fast enough the thread waits for a
+/// free one and packets wait in the socket's receive buffer, that setup()
+/// tries to make large enough to hold all the batches.
+///
+/// receive() and release() can only be called from one thread at a time.
+class ofxUDPReceiver: public ofThread{
+public:
+	~ofxUDPReceiver();
+
+	/// \brief Creates the socket and starts the thread.
+	///
+	/// The socket is always non blocking, the thread waits for packets
+	/// itself. If settings.receiveBufferSize is 0 it's set to the size of
+	/// all the batches, as much as the OS allows.
+	/// \param numBatches batches in the pool.
+	/// \param packetsPerBatch maximum packets received at once.
+	/// \param maxPacketSize larger packets are truncated.
+	bool setup(const ofxUDPSettings & settings, std::size_t numBatches = 16, std::size_t packetsPerBatch = 64, int maxPacketSize = 1472);
+
+	/// \brief Stops the thread and closes the socket, the batches taken with
+	/// receive() aren't valid anymore.
+	void close();
+
+	/// \brief Takes the next batch received.
+	/// \returns nullptr if there's none, otherwise a batch to give back with
+	/// release().
+	ofxUDPPacketBatch * receive();
+	void release(ofxUDPPacketBatch * batch);
+
+	/// \brief Calls function with every packet received since the last call
+	/// and releases their batches.
+	/// \returns the number of packets.
+	std::size_t receive(std::function<void(const ofxUDPPacket &)> function);
+
+	/// \brief Packets received by the thread, including the ones not taken
+	/// yet.
+	uint64_t getNumPacketsReceived() const;
+
+	/// \brief Number of times the thread had to wait for the app to release
+	/// a batch.
+	uint64_t getNumStalls() const;
+
+	/// \brief The socket, to read its settings or send replies from it.
+	ofxUDPManager & getManager();
+
+private:
+	// lock-free ring of batches with one producer and one consumer
+	struct Queue{
+		void allocate(std::size_t capacity);
+		bool push(ofxUDPPacketBatch * batch);
+		ofxUDPPacketBatch * pop();
+
+		std::vector<ofxUDPPacketBatch *> items;
+		std::atomic<std::size_t> head{0};
+		std::atomic<std::size_t> tail{0};
+	};
+
+	void threadedFunction() override;
+
+	ofxUDPManager manager;
+	std::vector<ofxUDPPacketBatch> batches;
+	Queue received;
+	Queue released;
+	std::atomic<uint64_t> numPackets{0};
+	std::atomic<uint64_t> numStalls{0};
+};
@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include "ofxCvConstants.h"
+#include "ofMain.h"
 
 
 class ofxCvBlob {
@@ -23,6 +23,7 @@ class ofxCvBlob {
         ofRectangle         boundingRect;
         ofDefaultVec3       centroid;
         bool                hole;
+        int                 id;     // set by ofxCvBlobTracker, -1 if not tracked
 
         std::vector<ofDefaultVec3> pts;    // the contour of the blob
         int                        nPts;   // number of pts;
@@ -32,6 +33,7 @@ class ofxCvBlob {
             area 		= 0.0f;
             length 		= 0.0f;
             hole 		= false;
+            id          = -1;
             nPts        = 0;
         }
 
@@ -0,0 +1,91 @@
+
+#include "ofxCvBlobTracker.h"
+#include <algorithm>
+
+
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setMaxDistance( float distance ) {
+    maxDistance = distance;
+}
+
+//--------------------------------------------------------------------------------
+float ofxCvBlobTracker::getMaxDistance() const {
+    return maxDistance;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setPersistence( int frames ) {
+    persistence = frames;
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobTracker::getPersistence() const {
+    return persistence;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::track( std::vector<ofxCvBlob>& blobs ) {
+
+    // every pair close enough, closest first
+    matches.clear();
+    float maxDistance2 = maxDistance * maxDistance;
+    for( int t = 0; t < (int)tracks.size(); t++ ) {
+        for( int b = 0; b < (int)blobs.size(); b++ ) {
+            if( tracks[t].hole != blobs[b].hole ) {
+                continue;
+            }
+            float dx = blobs[b].centroid.x - tracks[t].centroid.x;
+            float dy = blobs[b].centroid.y - tracks[t].centroid.y;
+            float distance2 = dx * dx + dy * dy;
+            if( distance2 <= maxDistance2 ) {
+                matches.push_back( Match{ distance2, t, b } );
+            }
+        }
+    }
+    std::sort( matches.begin(), matches.end(), []( const Match& a, const Match& b ) {
+        return a.distance < b.distance;
+    });
+
+    for( auto& blob : blobs ) {
+        blob.id = -1;
+    }
+    matched.assign( tracks.size(), false );
+    for( auto& match : matches ) {
+        ofxCvBlob& blob = blobs[match.blob];
+        Track& track = tracks[match.track];
+        if( matched[match.track] || blob.id != -1 ) {
+            continue;
+        }
+        matched[match.track] = true;
+        blob.id = track.id;
+        track.centroid = blob.centroid;
+        track.lost = 0;
+    }
+
+    // forget the tracks lost for too long
+    std::size_t kept = 0;
+    for( std::size_t t = 0; t < tracks.size(); t++ ) {
+        if( !matched[t] ) {
+            tracks[t].lost++;
+        }
+        if( tracks[t].lost <= persistence ) {
+            tracks[kept++] = tracks[t];
+        }
+    }
+    tracks.resize( kept );
+
+    // new blobs
+    for( auto& blob : blobs ) {
+        if( blob.id == -1 ) {
+            blob.id = nextId++;
+            tracks.push_back( Track{ blob.id, blob.centroid, blob.hole, 0 } );
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::reset() {
+    tracks.clear();
+    nextId = 0;
+}
@@ -0,0 +1,60 @@
+/*
+* ofxCvBlobTracker.h
+*
+* Gives the blobs found in consecutive frames stable ids: each blob
+* takes the id of the closest blob of the previous frames, closest
+* pairs first, or a new id if none is close enough.
+*
+* A blob that disappears keeps its id for a few frames in case it
+* comes back, e.g. when it's split or too small for a frame.
+*
+*/
+
+#pragma once
+
+#include "ofxCvBlob.h"
+
+class ofxCvBlobTracker {
+
+  public:
+
+    // a blob keeps its id if its centroid moved less than distance, in
+    // pixels, since the last frame it was seen
+    void  setMaxDistance( float distance );
+    float  getMaxDistance() const;
+
+    // frames a lost blob keeps its id
+    void  setPersistence( int frames );
+    int  getPersistence() const;
+
+    // sets the id of each blob
+    void  track( std::vector<ofxCvBlob>& blobs );
+
+    // forgets all the blobs, ids start again from 0
+    void  reset();
+
+
+  protected:
+
+    struct Track {
+        int  id;
+        ofDefaultVec3  centroid;
+        bool  hole;
+        int  lost;         // frames since it was last seen
+    };
+
+    struct Match {
+        float  distance;
+        int  track;
+        int  blob;
+    };
+
+    float  maxDistance = 50;
+    int  persistence = 10;
+    int  nextId = 0;
+
+    std::vector<Track>  tracks;
+    std::vector<Match>  matches;
+    std::vector<char>  matched;
+
+};
@@ -0,0 +1,389 @@
+
+#include "ofxCvConnectedComponents.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+    // tests 8 pixels at once, the result is exact for the whole word
+    // (a byte can be flagged wrongly but only after one that is flagged
+    // rightly), for thresholds below 128
+    const std::uint64_t ONES  = 0x0101010101010101ull;
+    const std::uint64_t HIGHS = 0x8080808080808080ull;
+
+    // true if a byte of v is greater than threshold
+    inline bool hasGreater( std::uint64_t v, unsigned char threshold ) {
+        return ((v + ONES * (127 - threshold)) | v) & HIGHS;
+    }
+
+    // true if a byte of v is lower or equal to threshold
+    inline bool hasLowerOrEqual( std::uint64_t v, unsigned char threshold ) {
+        return (v - ONES * (threshold + 1)) & ~v & HIGHS;
+    }
+
+    // 8 neighbours clockwise from the right
+    const int DX8[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+    const int DY8[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+    // 4 neighbours clockwise from the right
+    const int DX4[4] = { 1, 0, -1,  0 };
+    const int DY4[4] = { 0, 1,  0, -1 };
+
+    const int NONE = -1;
+    const int BORDER = -2;
+}
+
+
+
+//--------------------------------------------------------------------------------
+std::size_t ofxCvConnectedComponents::find( const ofPixels& pixels, unsigned char _threshold,
+                                            bool bFindHoles ) {
+    runs.clear();
+    rowStart.clear();
+    holeRuns.clear();
+    holeRowStart.clear();
+    components.clear();
+
+    if( pixels.getNumChannels() != 1 ) {
+        ofLogError("ofxCvConnectedComponents") << "find(): pixels have "
+            << pixels.getNumChannels() << " channels, only grayscale is supported";
+        width = 0;
+        height = 0;
+        data = nullptr;
+        return 0;
+    }
+
+    width = pixels.getWidth();
+    height = pixels.getHeight();
+    data = pixels.getData();
+    threshold = _threshold;
+
+    for( int y = 0; y < height; y++ ) {
+        rowStart.push_back( runs.size() );
+        scanRow( data + std::size_t(y) * width );
+    }
+    rowStart.push_back( runs.size() );
+
+    // dark runs are the gaps between the bright ones
+    if( bFindHoles ) {
+        for( int y = 0; y < height; y++ ) {
+            holeRowStart.push_back( holeRuns.size() );
+            int x = 0;
+            for( int i = rowStart[y]; i < rowStart[y+1]; i++ ) {
+                if( runs[i].start > x ) {
+                    holeRuns.push_back( Run{ x, runs[i].start, NONE } );
+                }
+                x = runs[i].end;
+            }
+            if( x < width ) {
+                holeRuns.push_back( Run{ x, width, NONE } );
+            }
+        }
+        holeRowStart.push_back( holeRuns.size() );
+    }
+
+    label( runs, rowStart, false );
+    if( bFindHoles ) {
+        label( holeRuns, holeRowStart, true );
+    }
+
+    return components.size();
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxCvConnectedComponents::size() const {
+    return components.size();
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvConnectedComponents::getArea( std::size_t i ) const {
+    return components[i].area;
+}
+
+//--------------------------------------------------------------------------------
+ofRectangle ofxCvConnectedComponents::getBoundingBox( std::size_t i ) const {
+    const Component& c = components[i];
+    return ofRectangle( c.minX, c.minY, c.maxX - c.minX + 1, c.maxY - c.minY + 1 );
+}
+
+//--------------------------------------------------------------------------------
+ofDefaultVec3 ofxCvConnectedComponents::getCentroid( std::size_t i ) const {
+    const Component& c = components[i];
+    return ofDefaultVec3( c.sumX / c.area, c.sumY / c.area, 0 );
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvConnectedComponents::isHole( std::size_t i ) const {
+    return components[i].hole;
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvConnectedComponents::getLabel( int x, int y ) const {
+    if( x < 0 || y < 0 || x >= width || y >= height ) {
+        return NONE;
+    }
+
+    const std::vector<Run>* rowRuns[2] = { &runs, &holeRuns };
+    const std::vector<int>* rowStarts[2] = { &rowStart, &holeRowStart };
+    for( int k = 0; k < 2; k++ ) {
+        if( rowStarts[k]->empty() ) {
+            continue;
+        }
+        auto begin = rowRuns[k]->begin() + (*rowStarts[k])[y];
+        auto end = rowRuns[k]->begin() + (*rowStarts[k])[y+1];
+        auto it = std::upper_bound( begin, end, x, []( int x, const Run& run ) {
+            return x < run.start;
+        });
+        if( it != begin && x < (it-1)->end ) {
+            return (it-1)->component;
+        }
+    }
+    return NONE;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvConnectedComponents::getContour( std::size_t i, std::vector<ofDefaultVec3>& pts,
+                                           bool bUseApproximation ) const {
+    pts.clear();
+    if( i >= components.size() || data == nullptr ) {
+        return;
+    }
+
+    const Component& c = components[i];
+    int x = c.startX;
+    int y = c.startY;
+    int first = NONE;
+    int last = NONE;
+
+    if( !c.hole ) {
+        // moore neighbour tracing, the pixel on the left of the start is
+        // outside and the search goes clockwise from the last pixel
+        // outside. stops when leaving the start the same way a second time
+        int back = 4;
+        while( true ) {
+            int dir = NONE;
+            for( int k = 1; k <= 8; k++ ) {
+                int n = (back + k) & 7;
+                if( isForeground( x + DX8[n], y + DY8[n] ) ) {
+                    dir = n;
+                    break;
+                }
+            }
+            if( dir == NONE ) {   // single pixel
+                pts.push_back( ofDefaultVec3( x, y, 0 ) );
+                break;
+            }
+            if( first == NONE ) {
+                first = dir;
+            } else if( x == c.startX && y == c.startY && dir == first ) {
+                break;
+            }
+            if( !bUseApproximation || dir != last ) {
+                pts.push_back( ofDefaultVec3( x, y, 0 ) );
+            }
+            last = dir;
+            x += DX8[dir];
+            y += DY8[dir];
+            back = (dir & 1) ? (dir + 5) & 7 : (dir + 6) & 7;
+        }
+    } else {
+        // holes are 4-connected, follow their border keeping the outside
+        // on the left. holes never touch the image border
+        int heading = 0;
+        while( true ) {
+            int dir = NONE;
+            for( int k = 0; k < 4; k++ ) {
+                int n = (heading + 3 + k) & 3;
+                if( !isForeground( x + DX4[n], y + DY4[n] ) ) {
+                    dir = n;
+                    break;
+                }
+            }
+            if( dir == NONE ) {   // single pixel
+                pts.push_back( ofDefaultVec3( x, y, 0 ) );
+                break;
+            }
+            if( first == NONE ) {
+                first = dir;
+            } else if( x == c.startX && y == c.startY && dir == first ) {
+                break;
+            }
+            if( !bUseApproximation || dir != last ) {
+                pts.push_back( ofDefaultVec3( x, y, 0 ) );
+            }
+            last = dir;
+            x += DX4[dir];
+            y += DY4[dir];
+            heading = dir;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxCvConnectedComponents::getBlobs( std::vector<ofxCvBlob>& blobs, int minArea,
+                                                int maxArea, int nConsidered,
+                                                bool bUseApproximation ) const {
+    order.clear();
+    for( std::size_t i = 0; i < components.size(); i++ ) {
+        if( components[i].area > minArea && components[i].area < maxArea ) {
+            order.push_back( i );
+        }
+    }
+    std::sort( order.begin(), order.end(), [this]( std::size_t a, std::size_t b ) {
+        return components[a].area > components[b].area ||
+              (components[a].area == components[b].area && a < b);
+    });
+
+    // resizing keeps the contours of the blobs already there allocated
+    blobs.resize( std::min<std::size_t>( order.size(), std::max( nConsidered, 0 ) ) );
+    for( std::size_t i = 0; i < blobs.size(); i++ ) {
+        ofxCvBlob& blob = blobs[i];
+        std::size_t c = order[i];
+        blob.area = components[c].area;
+        blob.boundingRect = getBoundingBox( c );
+        blob.centroid = getCentroid( c );
+        blob.hole = components[c].hole;
+        blob.id = -1;
+
+        getContour( c, blob.pts, bUseApproximation );
+        blob.nPts = blob.pts.size();
+        blob.length = 0;
+        for( std::size_t j = 0; j < blob.pts.size(); j++ ) {
+            const ofDefaultVec3& a = blob.pts[j];
+            const ofDefaultVec3& b = blob.pts[(j + 1) % blob.pts.size()];
+            blob.length += sqrtf( (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y) );
+        }
+    }
+    return blobs.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvConnectedComponents::scanRow( const unsigned char* row ) {
+    bool bWords = threshold < 128;
+    int x = 0;
+    while( x < width ) {
+        // skip the background
+        if( bWords ) {
+            while( x + 8 <= width ) {
+                std::uint64_t v;
+                memcpy( &v, row + x, 8 );
+                if( hasGreater( v, threshold ) ) break;
+                x += 8;
+            }
+        }
+        while( x < width && row[x] <= threshold ) x++;
+        if( x == width ) {
+            break;
+        }
+
+        int start = x;
+        if( bWords ) {
+            while( x + 8 <= width ) {
+                std::uint64_t v;
+                memcpy( &v, row + x, 8 );
+                if( hasLowerOrEqual( v, threshold ) ) break;
+                x += 8;
+            }
+        }
+        while( x < width && row[x] > threshold ) x++;
+        runs.push_back( Run{ start, x, NONE } );
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvConnectedComponents::join( std::vector<Run>& _runs, const std::vector<int>& _rowStart,
+                                     int y, bool b8Connected ) {
+    // runs of the previous row touching each run of this row, diagonally
+    // too if 8-connected
+    int reach = b8Connected ? 1 : 0;
+    int above = _rowStart[y-1];
+    int aboveEnd = _rowStart[y];
+    for( int i = _rowStart[y]; i < _rowStart[y+1]; i++ ) {
+        const Run& run = _runs[i];
+        while( above < aboveEnd && _runs[above].end + reach <= run.start ) {
+            above++;
+        }
+        for( int k = above; k < aboveEnd && _runs[k].start < run.end + reach; k++ ) {
+            int a = find( i );
+            int b = find( k );
+            if( a != b ) {
+                // the root is always the first run, so the topmost one
+                parent[std::max( a, b )] = std::min( a, b );
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvConnectedComponents::label( std::vector<Run>& _runs, const std::vector<int>& _rowStart,
+                                      bool bHoles ) {
+    parent.resize( _runs.size() );
+    std::iota( parent.begin(), parent.end(), 0 );
+    for( int y = 1; y < height; y++ ) {
+        join( _runs, _rowStart, y, !bHoles );
+    }
+
+    // component index of each root, regions of dark pixels touching the
+    // border are the background, not holes
+    for( auto& run : _runs ) {
+        run.component = NONE;
+    }
+    if( bHoles ) {
+        for( int y = 0; y < height; y++ ) {
+            for( int i = _rowStart[y]; i < _rowStart[y+1]; i++ ) {
+                if( y == 0 || y == height - 1 || _runs[i].start == 0 || _runs[i].end == width ) {
+                    _runs[find( i )].component = BORDER;
+                }
+            }
+        }
+    }
+
+    for( int y = 0; y < height; y++ ) {
+        for( int i = _rowStart[y]; i < _rowStart[y+1]; i++ ) {
+            Run& run = _runs[i];
+            int root = find( i );
+            if( root == i && run.component == NONE ) {
+                run.component = components.size();
+                components.push_back( Component{ 0, run.start, y, run.end - 1, y, 0, 0,
+                                                 bHoles, run.start, y } );
+            } else if( root != i ) {
+                run.component = _runs[root].component;
+            }
+            if( run.component == BORDER ) {
+                continue;
+            }
+
+            Component& c = components[run.component];
+            int length = run.end - run.start;
+            c.area += length;
+            c.minX = std::min( c.minX, run.start );
+            c.maxX = std::max( c.maxX, run.end - 1 );
+            c.maxY = y;
+            c.sumX += (run.start + run.end - 1) * 0.5 * length;
+            c.sumY += double(y) * length;
+        }
+    }
+
+    // runs outside any hole are background
+    for( auto& run : _runs ) {
+        if( run.component == BORDER ) {
+            run.component = NONE;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvConnectedComponents::find( int run ) {
+    while( parent[run] != run ) {
+        parent[run] = parent[parent[run]];
+        run = parent[run];
+    }
+    return run;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvConnectedComponents::isForeground( int x, int y ) const {
+    return x >= 0 && y >= 0 && x < width && y < height &&
+           data[std::size_t(y) * width + x] > threshold;
+}
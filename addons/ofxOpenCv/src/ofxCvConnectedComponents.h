@@ -0,0 +1,95 @@
+/*
+* ofxCvConnectedComponents.h
+*
+* Labels the 8-connected regions of bright pixels in a grayscale
+* ofPixels and measures their area, bounding box and centroid, without
+* OpenCV. Optionally the 4-connected regions of dark pixels enclosed
+* by them are labelled too, as holes.
+*
+* Each row is split in runs of pixels, scanning 8 pixels at a time
+* through the background, and runs touching each other are joined, so
+* the work after the scan is proportional to the number of runs and
+* not to the number of pixels. Contours are only traced for the regions
+* asked for.
+*
+* All buffers are kept between calls to find(), so labelling images of
+* the same size every frame doesn't allocate.
+*
+*/
+
+#pragma once
+
+#include "ofxCvBlob.h"
+
+class ofxCvConnectedComponents {
+
+  public:
+
+    // labels the regions of pixels brighter than threshold, pixels has
+    // to be 1 channel and stay valid while contours are traced.
+    // returns the number of regions, holes included
+    std::size_t find( const ofPixels& pixels, unsigned char threshold = 0,
+                      bool bFindHoles = false );
+
+    std::size_t size() const;
+
+    int  getArea( std::size_t i ) const;           // in pixels
+    ofRectangle  getBoundingBox( std::size_t i ) const;
+    ofDefaultVec3  getCentroid( std::size_t i ) const;
+    bool  isHole( std::size_t i ) const;
+
+    // index of the region a pixel belongs to, -1 for the background
+    int  getLabel( int x, int y ) const;
+
+    // traces the border of a region, through its outermost pixels.
+    // with bUseApproximation only the ends of horizontal, vertical and
+    // diagonal segments are kept, as CV_CHAIN_APPROX_SIMPLE.
+    void  getContour( std::size_t i, std::vector<ofDefaultVec3>& pts,
+                      bool bUseApproximation = true ) const;
+
+    // fills blobs with the regions whose area is between minArea and
+    // maxArea, exclusive, largest first, at most nConsidered of them.
+    // the blobs already in the vector are reused.
+    // returns the number of blobs
+    std::size_t getBlobs( std::vector<ofxCvBlob>& blobs, int minArea, int maxArea,
+                          int nConsidered, bool bUseApproximation = true ) const;
+
+
+  protected:
+
+    struct Run {
+        int  start;        // first pixel
+        int  end;          // one past the last pixel
+        int  component;    // index in components, -1 if none
+    };
+
+    struct Component {
+        int  area;
+        int  minX, minY, maxX, maxY;
+        double  sumX, sumY;
+        bool  hole;
+        int  startX, startY;   // topmost then leftmost pixel
+    };
+
+    void  scanRow( const unsigned char* row );
+    void  join( std::vector<Run>& runs, const std::vector<int>& rowStart,
+                int y, bool b8Connected );
+    void  label( std::vector<Run>& runs, const std::vector<int>& rowStart, bool bHoles );
+    int  find( int run );
+
+    bool  isForeground( int x, int y ) const;
+
+    int  width = 0;
+    int  height = 0;
+    const unsigned char*  data = nullptr;
+    unsigned char  threshold = 0;
+
+    std::vector<Run>  runs;            // bright runs, row by row
+    std::vector<int>  rowStart;        // first run of each row, and the end
+    std::vector<Run>  holeRuns;        // dark runs, row by row
+    std::vector<int>  holeRowStart;
+    std::vector<int>  parent;          // union-find forest of the runs
+    std::vector<Component>  components;
+    mutable std::vector<std::size_t>  order;   // sorted by area in getBlobs()
+
+};
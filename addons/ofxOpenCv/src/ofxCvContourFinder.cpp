@@ -154,6 +154,26 @@ int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
 
 }
 
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContours( const ofPixels& input,
+									  int minArea,
+									  int maxArea,
+									  int nConsidered,
+									  bool bFindHoles,
+                                      bool bUseApproximation) {
+
+    _width = input.getWidth();
+    _height = input.getHeight();
+
+    // unlike reset(), keeps the blobs to reuse their contours
+    cvSeqBlobs.clear();
+    components.find( input, 0, bFindHoles );
+    components.getBlobs( blobs, minArea, maxArea, nConsidered, bUseApproximation );
+    nBlobs = blobs.size();
+
+    return nBlobs;
+}
+
 //--------------------------------------------------------------------------------
 void ofxCvContourFinder::draw( float x, float y, float w, float h ) const {
 
@@ -13,6 +13,7 @@
 #include "ofxCvConstants.h"
 #include "ofxCvBlob.h"
 #include "ofxCvGrayscaleImage.h"
+#include "ofxCvConnectedComponents.h"
 #include <algorithm>
 
 class ofxCvContourFinder : public ofBaseDraws {
@@ -37,6 +38,15 @@ class ofxCvContourFinder : public ofBaseDraws {
                                // of the contour, if the contour runs
                                // along a straight line, for example...
 
+    // same without OpenCV, on a grayscale ofPixels where any pixel
+    // above 0 is part of a blob. areas are in pixels and the contour of
+    // a hole goes through the pixels of the hole. nothing is allocated
+    // once the blobs and their contours have grown to their largest size
+    virtual int  findContours( const ofPixels& input,
+                               int minArea, int maxArea,
+                               int nConsidered, bool bFindHoles,
+                               bool bUseApproximation = true);
+
     virtual void  draw() const { draw(0,0, _width, _height); };
     virtual void  draw( float x, float y ) const { draw(x,y, _width, _height); };
     virtual void  draw( float x, float y, float w, float h ) const;
@@ -58,6 +68,7 @@ class ofxCvContourFinder : public ofBaseDraws {
     CvMemStorage*           storage;
     CvMoments*              myMoments;
     std::vector<CvSeq*>     cvSeqBlobs;  //these will become blobs
+    ofxCvConnectedComponents  components;  // for findContours( ofPixels )
     
     ofPoint  anchor;
     bool  bAnchorIsPct;      
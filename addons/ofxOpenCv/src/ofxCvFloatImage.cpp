@@ -505,6 +505,14 @@ IplImage*  ofxCvFloatImage::getCv8BitsRoiImage() {
 	return cvGrayscaleImage;
 }
 
+//--------------------------------------------------------------------------------
+ofxCvPipeline::Plane  ofxCvFloatImage::getRoiPlane() const {
+    ofxCvPipeline::Plane plane = ofxCvImage::getRoiPlane();
+    plane.scaleMin = scaleMin;
+    plane.scaleMax = scaleMax;
+    return plane;
+}
+
 
 //--------------------------------------------------------------------------------
 float*  ofxCvFloatImage::getPixelsAsFloats(){
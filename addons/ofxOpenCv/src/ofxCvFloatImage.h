@@ -37,8 +37,8 @@ class ofxCvFloatImage : public ofxCvImage {
     // virtual ofTexture&  getTextureReference();                             //in base class
     virtual void flagImageChanged();
     virtual void  setNativeScale( float _scaleMin, float _scaleMax ); 
-    virtual float  getNativeScaleMin() {return scaleMin;}; 
-    virtual float  getNativeScaleMax() {return scaleMax;}; 
+    virtual float  getNativeScaleMin() const {return scaleMin;}; 
+    virtual float  getNativeScaleMax() const {return scaleMax;}; 
 
 
     // ROI - region of interest
@@ -137,6 +137,7 @@ class ofxCvFloatImage : public ofxCvImage {
     // Other Image Operations
     //
     // virtual int  countNonZeroInRegion( int x, int y, int w, int h );        //in base class
+    // virtual void  apply( ofxCvPipeline& pipeline );                         //in base class
     
 
   protected:
@@ -147,6 +148,7 @@ class ofxCvFloatImage : public ofxCvImage {
     virtual void convertGrayToFloat( IplImage* grayImg, IplImage* floatImg );
     virtual IplImage* getCv8BitsImage();
     virtual IplImage* getCv8BitsRoiImage();
+    virtual ofxCvPipeline::Plane  getRoiPlane() const;
     
     ofFloatPixels floatPixels;             // not width stepped for getPixelsAsFloats()
 
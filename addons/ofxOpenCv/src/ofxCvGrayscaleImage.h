@@ -126,6 +126,7 @@ class ofxCvGrayscaleImage : public ofxCvImage {
     // Other Image Operations
     //
     // virtual int  countNonZeroInRegion( int x, int y, int w, int h );        //in base class
+    // virtual void  apply( ofxCvPipeline& pipeline );                         //in base class
     
     
     
@@ -782,11 +782,48 @@ int ofxCvImage::countNonZeroInRegion( int x, int y, int w, int h ) {
 	return count;
 }
 
+//--------------------------------------------------------------------------------
+void ofxCvImage::apply( ofxCvPipeline& pipeline ) {
+	if( !bAllocated ){
+		ofLogError("ofxCvImage") << "apply(): image not allocated";
+		return;
+	}
+	if( iplchannels != 1 || (ipldepth != IPL_DEPTH_8U && ipldepth != IPL_DEPTH_32F) ){
+		ofLogError("ofxCvImage") << "apply(): only grayscale and float images are supported";
+		return;
+	}
+	for( auto& op : pipeline.ops ) {
+		if( op.image ) {
+			if( !op.image->bAllocated ){
+				ofLogError("ofxCvImage") << "apply(): source image not allocated";
+				return;
+			}
+			op.source = op.image->getRoiPlane();
+		}
+	}
+	if( pipeline.run( getRoiPlane() ) ) {
+		flagImageChanged();
+	}
+}
+
 
 
 
 // private methods
 
+//--------------------------------------------------------------------------------
+ofxCvPipeline::Plane ofxCvImage::getRoiPlane() const {
+    CvRect roi = cvGetImageROI( cvImage );
+    ofxCvPipeline::Plane plane;
+    plane.width = roi.width;
+    plane.height = roi.height;
+    plane.stride = cvImage->widthStep;
+    plane.bFloat = cvImage->depth == IPL_DEPTH_32F;
+    plane.data = (unsigned char*)cvImage->imageData + roi.y * cvImage->widthStep
+                 + roi.x * (plane.bFloat ? sizeof(float) : 1) * cvImage->nChannels;
+    return plane;
+}
+
 //--------------------------------------------------------------------------------
 void ofxCvImage::swapTemp() {
 	if (getROI().x != 0 ||
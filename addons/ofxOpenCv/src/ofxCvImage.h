@@ -13,6 +13,7 @@
 
 
 #include "ofxCvConstants.h"
+#include "ofxCvPipeline.h"
 
 class ofxCvGrayscaleImage;
 class ofxCvColorImage;
@@ -149,6 +150,10 @@ class ofxCvImage : public ofBaseImage {
     //
     virtual int  countNonZeroInRegion( int x, int y, int w, int h );
 
+    // runs the ops of the pipeline in one pass over the ROI, in place,
+    // for grayscale and float images
+    virtual void  apply( ofxCvPipeline& pipeline );
+
 
 
 
@@ -167,6 +172,7 @@ class ofxCvImage : public ofBaseImage {
                               // to cvImage after an image operation
     virtual IplImage*  getCv8BitsImage() { return cvImage; }
     virtual IplImage*  getCv8BitsRoiImage() { return cvImage; }
+    virtual ofxCvPipeline::Plane  getRoiPlane() const;   // for ofxCvPipeline
                           
     IplImage*  cvImage;
     IplImage*  cvImageTemp;   // this is typically swapped back into cvImage
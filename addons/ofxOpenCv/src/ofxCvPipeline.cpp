@@ -0,0 +1,664 @@
+
+#include "ofxCvPipeline.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+    // below this a band isn't worth a thread
+    const int MIN_BAND_PIXELS = 64 * 1024;
+
+    inline unsigned char saturate( float v ) {
+        return v <= 0 ? 0 : (v >= 255 ? 255 : (unsigned char)(v + 0.5f));
+    }
+
+    // of a blur, always in range
+    inline unsigned char average( int sum, float scale, unsigned char* ) {
+        return (unsigned char)(sum * scale + 0.5f);
+    }
+
+    inline float average( float sum, float scale, float* ) {
+        return sum * scale;
+    }
+
+    inline void absDiff( unsigned char* row, const unsigned char* mom, int w ) {
+        for( int x = 0; x < w; x++ ) {
+            row[x] = std::abs( int(row[x]) - int(mom[x]) );
+        }
+    }
+
+    inline void absDiff( float* row, const float* mom, int w ) {
+        for( int x = 0; x < w; x++ ) {
+            row[x] = std::abs( row[x] - mom[x] );
+        }
+    }
+
+    inline void subtract( unsigned char* row, const unsigned char* mom, int w ) {
+        for( int x = 0; x < w; x++ ) {
+            row[x] = std::max( int(row[x]) - int(mom[x]), 0 );
+        }
+    }
+
+    inline void subtract( float* row, const float* mom, int w ) {
+        for( int x = 0; x < w; x++ ) {
+            row[x] -= mom[x];
+        }
+    }
+
+    // by value, so the compilers don't branch on random pixels
+    template<typename T>
+    inline T min3( T a, T b, T c ) {
+        T m = a < b ? a : b;
+        return m < c ? m : c;
+    }
+
+    template<typename T>
+    inline T max3( T a, T b, T c ) {
+        T m = a > b ? a : b;
+        return m > c ? m : c;
+    }
+
+    template<typename T, typename Op>
+    inline const T* sourceRow( const Op& op, int y ) {
+        return reinterpret_cast<const T*>( op.source.data + (std::size_t)y * op.source.stride );
+    }
+}
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::absDiff( const ofxCvImage& mom ) {
+    Op op;
+    op.type = ABS_DIFF;
+    op.image = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::absDiff( const ofPixels& mom ) {
+    Op op;
+    op.type = ABS_DIFF;
+    op.pixels = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::absDiff( const ofFloatPixels& mom ) {
+    Op op;
+    op.type = ABS_DIFF;
+    op.floatPixels = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::subtract( const ofxCvImage& mom ) {
+    Op op;
+    op.type = SUBTRACT;
+    op.image = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::subtract( const ofPixels& mom ) {
+    Op op;
+    op.type = SUBTRACT;
+    op.pixels = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::subtract( const ofFloatPixels& mom ) {
+    Op op;
+    op.type = SUBTRACT;
+    op.floatPixels = &mom;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::subtract( float value ) {
+    Op op;
+    op.type = SUBTRACT_VALUE;
+    op.value = value;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::threshold( float value, bool invert ) {
+    Op op;
+    op.type = THRESHOLD;
+    op.value = value;
+    op.invert = invert;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::convertToRange( float min, float max ) {
+    Op op;
+    op.type = CONVERT_TO_RANGE;
+    op.value = min;
+    op.max = max;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::blur( int value ) {
+    if( value % 2 == 0 ) {
+        ofLogNotice("ofxCvPipeline") << "blur(): value " << value << " not odd, adding 1";
+        value++;
+    }
+    if( value <= 1 ) {
+        return *this;
+    }
+    Op op;
+    op.type = BLUR;
+    op.radius = value / 2;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::erode() {
+    Op op;
+    op.type = ERODE;
+    op.radius = 1;
+    return add( op );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::dilate() {
+    Op op;
+    op.type = DILATE;
+    op.radius = 1;
+    return add( op );
+}
+//--------------------------------------------------------------------------------
+ofxCvPipeline::ofxCvPipeline() {
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline::ofxCvPipeline( const ofxCvPipeline& mom ) {
+    *this = mom;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::operator = ( const ofxCvPipeline& mom ) {
+    ops = mom.ops;
+    stages = mom.stages;
+    numThreads = mom.numThreads;
+    return *this;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline::~ofxCvPipeline() {
+    // stops and joins them before the bands they use are freed
+    workers.clear();
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline::Worker::Worker( ofxCvPipeline& _pipeline )
+:pipeline( _pipeline ) {
+    setThreadName( "ofxCvPipeline" );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline::Worker::~Worker() {
+    bands.close();
+    waitForThread( true );
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::Worker::threadedFunction() {
+    std::size_t b;
+    while( bands.receive( b ) ) {
+        pipeline.runBand( b );
+        pipeline.bandsDone.send( b );
+    }
+}
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvPipeline& ofxCvPipeline::add( const Op& op ) {
+    if( op.radius > 0 ) {
+        stages.push_back( ops.size() );
+    }
+    ops.push_back( op );
+    return *this;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::clear() {
+    ops.clear();
+    stages.clear();
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxCvPipeline::size() const {
+    return ops.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::setNumThreads( std::size_t _numThreads ) {
+    numThreads = _numThreads;
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ofxCvPipeline::getNumThreads() const {
+    return numThreads;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvPipeline::run( ofPixels& pixels ) {
+    if( pixels.getNumChannels() != 1 ) {
+        ofLogError("ofxCvPipeline") << "run(): pixels have "
+            << pixels.getNumChannels() << " channels, only grayscale is supported";
+        return false;
+    }
+    for( auto& op : ops ) {
+        if( op.image ) {
+            ofLogError("ofxCvPipeline") << "run(): ofxCvImage sources need ofxCvImage::apply()";
+            return false;
+        }
+    }
+    Plane image;
+    image.data = pixels.getData();
+    image.width = pixels.getWidth();
+    image.height = pixels.getHeight();
+    image.stride = image.width;
+    return run( image );
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvPipeline::run( ofFloatPixels& pixels ) {
+    if( pixels.getNumChannels() != 1 ) {
+        ofLogError("ofxCvPipeline") << "run(): pixels have "
+            << pixels.getNumChannels() << " channels, only grayscale is supported";
+        return false;
+    }
+    for( auto& op : ops ) {
+        if( op.image ) {
+            ofLogError("ofxCvPipeline") << "run(): ofxCvImage sources need ofxCvImage::apply()";
+            return false;
+        }
+    }
+    Plane image;
+    image.data = reinterpret_cast<unsigned char*>( pixels.getData() );
+    image.width = pixels.getWidth();
+    image.height = pixels.getHeight();
+    image.stride = image.width * sizeof(float);
+    image.bFloat = true;
+    image.scaleMax = 1;
+    return run( image );
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvPipeline::run( const Plane& image ) {
+    if( !resolve( image ) ) {
+        return false;
+    }
+    if( ops.empty() || image.width == 0 || image.height == 0 ) {
+        return true;
+    }
+    current = image;
+    if( image.bFloat ) {
+        run( image, bands32 );
+    } else {
+        run( image, bands8 );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvPipeline::resolve( const Plane& image ) {
+    Op* lutOp = nullptr;
+    for( auto& op : ops ) {
+
+        // sources, ofxCvImage::apply() resolves the images
+        if( op.pixels ) {
+            if( op.pixels->getNumChannels() != 1 ) {
+                ofLogError("ofxCvPipeline") << "run(): source pixels have "
+                    << op.pixels->getNumChannels() << " channels, only grayscale is supported";
+                return false;
+            }
+            op.source = Plane();
+            op.source.data = const_cast<unsigned char*>( op.pixels->getData() );
+            op.source.width = op.pixels->getWidth();
+            op.source.height = op.pixels->getHeight();
+            op.source.stride = op.source.width;
+        } else if( op.floatPixels ) {
+            if( op.floatPixels->getNumChannels() != 1 ) {
+                ofLogError("ofxCvPipeline") << "run(): source pixels have "
+                    << op.floatPixels->getNumChannels() << " channels, only grayscale is supported";
+                return false;
+            }
+            op.source = Plane();
+            op.source.data = reinterpret_cast<unsigned char*>( const_cast<float*>( op.floatPixels->getData() ) );
+            op.source.width = op.floatPixels->getWidth();
+            op.source.height = op.floatPixels->getHeight();
+            op.source.stride = op.source.width * sizeof(float);
+            op.source.bFloat = true;
+        }
+        if( op.type == ABS_DIFF || op.type == SUBTRACT ) {
+            if( op.source.bFloat != image.bFloat ) {
+                ofLogError("ofxCvPipeline") << "run(): source image type mismatch";
+                return false;
+            }
+            if( op.source.width != image.width || op.source.height != image.height ) {
+                ofLogError("ofxCvPipeline") << "run(): source image size mismatch: "
+                    << op.source.width << "x" << op.source.height << " instead of "
+                    << image.width << "x" << image.height;
+                return false;
+            }
+        }
+
+        // per pixel ops as v * scale + offset
+        switch( op.type ) {
+            case SUBTRACT_VALUE:
+                op.scale = 1;
+                op.offset = -op.value;
+                break;
+            case THRESHOLD:
+                op.scale = op.invert ? image.scaleMin : image.scaleMax;
+                op.offset = op.invert ? image.scaleMax : image.scaleMin;
+                break;
+            case CONVERT_TO_RANGE:
+                op.scale = (op.max - op.value) / (image.scaleMax - image.scaleMin);
+                op.offset = op.value - image.scaleMin * op.scale;
+                break;
+            default:
+                lutOp = nullptr;
+                continue;
+        }
+
+        // on 8 bits they become a table, consecutive tables are merged
+        op.bMerged = false;
+        op.bComposed = false;
+        if( image.bFloat ) {
+            continue;
+        }
+        op.lut.resize( 256 );
+        for( int i = 0; i < 256; i++ ) {
+            if( op.type == THRESHOLD ) {
+                op.lut[i] = saturate( i > op.value ? op.scale : op.offset );
+            } else {
+                op.lut[i] = saturate( i * op.scale + op.offset );
+            }
+        }
+        if( lutOp ) {
+            for( auto& v : lutOp->lut ) {
+                v = op.lut[v];
+            }
+            op.bMerged = true;
+            lutOp->bComposed = true;
+        } else {
+            lutOp = &op;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+template<typename T, typename Acc>
+void ofxCvPipeline::run( const Plane& image, std::vector<Band<T,Acc>>& bands ) {
+    int w = image.width;
+    int h = image.height;
+
+    std::size_t numBands = numThreads == 0 ? std::thread::hardware_concurrency() : numThreads;
+    numBands = std::max( std::size_t(1), std::min( { numBands,
+                                                     std::size_t( w * h / MIN_BAND_PIXELS ),
+                                                     std::size_t( h ) } ) );
+    bands.resize( numBands );
+
+    int halo = 0;
+    for( auto stage : stages ) {
+        halo += ops[stage].radius;
+    }
+
+    for( std::size_t b = 0; b < numBands; b++ ) {
+        auto& band = bands[b];
+        band.y0 = h * b / numBands;
+        band.y1 = h * (b + 1) / numBands;
+        band.s0 = std::max( 0, band.y0 - halo );
+        band.s1 = std::min( h, band.y1 + halo );
+        if( stages.empty() ) {
+            continue;
+        }
+
+        band.row.resize( w );
+        band.rings.resize( stages.size() );
+        band.sumRings.resize( stages.size() );
+        band.sums.resize( stages.size() );
+        band.outs.resize( stages.size() );
+        band.ranges.resize( stages.size() );
+        int maxRadius = 0;
+        for( std::size_t k = 0; k < stages.size(); k++ ) {
+            int r = ops[stages[k]].radius;
+            maxRadius = std::max( maxRadius, r );
+            bool bBlur = ops[stages[k]].type == BLUR;
+            band.rings[k].resize( bBlur ? 0 : (2 * r + 2) * w );
+            band.sumRings[k].resize( bBlur ? (2 * r + 2) * w : 0 );
+            band.sums[k].resize( bBlur ? w : 0 );
+            band.outs[k].resize( w );
+        }
+        band.padded.resize( w + 2 * maxRadius );
+
+        // rows of the other bands are copied before any band writes them
+        band.halo.resize( ((band.y0 - band.s0) + (band.s1 - band.y1)) * w );
+        T* dst = band.halo.data();
+        for( int y = band.s0; y < band.s1; y++ ) {
+            if( y < band.y0 || y >= band.y1 ) {
+                memcpy( dst, image.data + (std::size_t)y * image.stride, w * sizeof(T) );
+                dst += w;
+            }
+        }
+    }
+
+    while( workers.size() < numBands - 1 ) {
+        workers.emplace_back( new Worker( *this ) );
+        workers.back()->startThread();
+    }
+    for( std::size_t b = 1; b < numBands; b++ ) {
+        workers[b - 1]->bands.send( b );
+    }
+    runBand( image, bands[0] );
+    std::size_t b;
+    for( std::size_t done = 1; done < numBands; done++ ) {
+        bandsDone.receive( b );
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::runBand( std::size_t b ) {
+    if( current.bFloat ) {
+        runBand( current, bands32[b] );
+    } else {
+        runBand( current, bands8[b] );
+    }
+}
+
+//--------------------------------------------------------------------------------
+template<typename T, typename Acc>
+void ofxCvPipeline::runBand( const Plane& image, Band<T,Acc>& band ) {
+    int w = image.width;
+    int h = image.height;
+
+    // only per pixel ops, straight on the image
+    if( stages.empty() ) {
+        for( int y = band.y0; y < band.y1; y++ ) {
+            applyOps( 0, ops.size(), reinterpret_cast<T*>( image.data + (std::size_t)y * image.stride ), y, w );
+        }
+        return;
+    }
+
+    // rows each stage needs, from the last one
+    int out0 = band.y0;
+    int out1 = band.y1;
+    for( std::size_t k = stages.size(); k-- > 0; ) {
+        int r = ops[stages[k]].radius;
+        Range& range = band.ranges[k];
+        range.out0 = out0;
+        range.out1 = out1;
+        range.next = out0;
+        range.in0 = std::max( 0, out0 - r );
+        range.in1 = std::min( h, out1 + r );
+        out0 = range.in0;
+        out1 = range.in1;
+    }
+
+    const T* halo = band.halo.data();
+    for( int y = out0; y < out1; y++ ) {
+        const T* src;
+        if( y >= band.y0 && y < band.y1 ) {
+            src = reinterpret_cast<const T*>( image.data + (std::size_t)y * image.stride );
+        } else {
+            src = halo;
+            halo += w;
+        }
+        memcpy( band.row.data(), src, w * sizeof(T) );
+        applyOps( 0, stages[0], band.row.data(), y, w );
+        push( image, band, 0, y, band.row.data() );
+    }
+}
+
+//--------------------------------------------------------------------------------
+template<typename T, typename Acc>
+void ofxCvPipeline::push( const Plane& image, Band<T,Acc>& band, std::size_t k,
+                          int j, const T* row ) {
+    int w = image.width;
+    int h = image.height;
+    const Op& op = ops[stages[k]];
+    int r = op.radius;
+    int slots = 2 * r + 2;
+
+    // horizontal pass, replicating the borders
+    T* padded = band.padded.data();
+    std::fill( padded, padded + r, row[0] );
+    memcpy( padded + r, row, w * sizeof(T) );
+    std::fill( padded + r + w, padded + 2 * r + w, row[w - 1] );
+    std::size_t slot = (std::size_t)(j % slots) * w;
+    if( op.type == BLUR ) {
+        // a running sum would be serial, this vectorizes
+        Acc* filtered = band.sumRings[k].data() + slot;
+        std::fill( filtered, filtered + w, Acc(0) );
+        for( int i = 0; i <= 2 * r; i++ ) {
+            for( int x = 0; x < w; x++ ) {
+                filtered[x] += padded[x + i];
+            }
+        }
+    } else if( op.type == ERODE ) {
+        T* filtered = band.rings[k].data() + slot;
+        for( int x = 0; x < w; x++ ) {
+            filtered[x] = min3( padded[x], padded[x + 1], padded[x + 2] );
+        }
+    } else {
+        T* filtered = band.rings[k].data() + slot;
+        for( int x = 0; x < w; x++ ) {
+            filtered[x] = max3( padded[x], padded[x + 1], padded[x + 2] );
+        }
+    }
+
+    // vertical pass for every row that can be written now
+    auto slotOf = [&]( int y ) {
+        return (std::size_t)(std::min( std::max( y, 0 ), h - 1 ) % slots) * w;
+    };
+    Range& range = band.ranges[k];
+    T* out = band.outs[k].data();
+    while( range.next < range.out1 && std::min( h - 1, range.next + r ) <= j ) {
+        int y = range.next++;
+        if( op.type == BLUR ) {
+            Acc* sum = band.sums[k].data();
+            if( y == range.out0 ) {
+                std::fill( sum, sum + w, Acc(0) );
+                for( int d = -r; d <= r; d++ ) {
+                    const Acc* add = band.sumRings[k].data() + slotOf( y + d );
+                    for( int x = 0; x < w; x++ ) {
+                        sum[x] += add[x];
+                    }
+                }
+            } else {
+                const Acc* add = band.sumRings[k].data() + slotOf( y + r );
+                const Acc* sub = band.sumRings[k].data() + slotOf( y - r - 1 );
+                for( int x = 0; x < w; x++ ) {
+                    sum[x] += add[x] - sub[x];
+                }
+            }
+            float scale = 1.0f / ((2 * r + 1) * (2 * r + 1));
+            for( int x = 0; x < w; x++ ) {
+                out[x] = average( sum[x], scale, out );
+            }
+        } else {
+            const T* a = band.rings[k].data() + slotOf( y - 1 );
+            const T* b = band.rings[k].data() + slotOf( y );
+            const T* c = band.rings[k].data() + slotOf( y + 1 );
+            if( op.type == ERODE ) {
+                for( int x = 0; x < w; x++ ) {
+                    out[x] = min3( a[x], b[x], c[x] );
+                }
+            } else {
+                for( int x = 0; x < w; x++ ) {
+                    out[x] = max3( a[x], b[x], c[x] );
+                }
+            }
+        }
+
+        if( k + 1 < stages.size() ) {
+            applyOps( stages[k] + 1, stages[k + 1], out, y, w );
+            push( image, band, k + 1, y, out );
+        } else {
+            applyOps( stages[k] + 1, ops.size(), out, y, w );
+            memcpy( image.data + (std::size_t)y * image.stride, out, w * sizeof(T) );
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+template<typename T>
+void ofxCvPipeline::applyOps( std::size_t first, std::size_t last, T* row, int y, int w ) const {
+    for( std::size_t i = first; i < last; i++ ) {
+        const Op& op = ops[i];
+        switch( op.type ) {
+            case ABS_DIFF:
+                ::absDiff( row, sourceRow<T>( op, y ), w );
+                break;
+            case SUBTRACT:
+                ::subtract( row, sourceRow<T>( op, y ), w );
+                break;
+            default:
+                if( !op.bMerged ) {
+                    map( op, row, w );
+                }
+                break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::map( const Op& op, unsigned char* row, int w ) {
+    // a threshold alone is a comparison, which vectorizes
+    if( op.type == THRESHOLD && !op.bComposed && op.value >= 0 && op.value < 255 ) {
+        unsigned char value = (unsigned char)op.value;
+        unsigned char above = op.lut[255];
+        unsigned char below = op.lut[0];
+        for( int x = 0; x < w; x++ ) {
+            row[x] = row[x] > value ? above : below;
+        }
+        return;
+    }
+    const unsigned char* lut = op.lut.data();
+    for( int x = 0; x < w; x++ ) {
+        row[x] = lut[row[x]];
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvPipeline::map( const Op& op, float* row, int w ) {
+    if( op.type == THRESHOLD ) {
+        for( int x = 0; x < w; x++ ) {
+            row[x] = row[x] > op.value ? op.scale : op.offset;
+        }
+    } else {
+        for( int x = 0; x < w; x++ ) {
+            row[x] = row[x] * op.scale + op.offset;
+        }
+    }
+}
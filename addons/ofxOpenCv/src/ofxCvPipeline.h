@@ -0,0 +1,182 @@
+/*
+* ofxCvPipeline.h
+*
+* A chain of per frame operations on a grayscale or float image that
+* runs as a single pass over the image or its ROI, e.g. background
+* subtraction, threshold and morphology:
+*
+*     pipeline.absDiff( background ).threshold( 30 ).erode().dilate();
+*     grayImage.apply( pipeline );
+*
+* Rows flow through the whole chain one at a time: per pixel operations
+* are applied to a row while it's in cache, and blur, erode and dilate
+* keep only the few rows they need, so no intermediate image is written.
+* The result is written back in place and the image is flagged as
+* changed once, at the end.
+*
+* Large images are split in horizontal bands processed by different
+* threads, which the pipeline starts on its first run and keeps until
+* it's destroyed. Borders are replicated at the edges of the image or
+* ROI, as the OpenCV filters do.
+*
+*/
+
+#pragma once
+
+#include "ofMain.h"
+
+class ofxCvImage;
+
+class ofxCvPipeline {
+
+  public:
+
+    ofxCvPipeline();
+    ofxCvPipeline( const ofxCvPipeline& mom );      // copies the chain, not the threads
+    ofxCvPipeline&  operator = ( const ofxCvPipeline& mom );
+    ~ofxCvPipeline();
+
+    // sources have to be the size of the image, or its ROI, the
+    // pipeline runs on, with the same type. they are read when the
+    // pipeline runs, so they can change between runs
+    ofxCvPipeline&  absDiff( const ofxCvImage& mom );
+    ofxCvPipeline&  absDiff( const ofPixels& mom );
+    ofxCvPipeline&  absDiff( const ofFloatPixels& mom );
+    ofxCvPipeline&  subtract( const ofxCvImage& mom );    // as operator -=
+    ofxCvPipeline&  subtract( const ofPixels& mom );
+    ofxCvPipeline&  subtract( const ofFloatPixels& mom );
+    ofxCvPipeline&  subtract( float value );
+
+    // pixels above value become the top of the range of the image, 255
+    // or the native scale max of float images, the rest the bottom
+    ofxCvPipeline&  threshold( float value, bool invert=false );
+
+    // maps the range of the image, 0-255 or the native scale of float
+    // images, to min-max
+    ofxCvPipeline&  convertToRange( float min, float max );
+
+    ofxCvPipeline&  blur( int value=3 );    // value = x*2+1, where x is an integer
+    ofxCvPipeline&  erode();                // based on 3x3 shape
+    ofxCvPipeline&  dilate();               // based on 3x3 shape
+
+    void  clear();
+    std::size_t  size() const;
+
+    // threads the image is split between, 0 uses as many as cores
+    void  setNumThreads( std::size_t numThreads );
+    std::size_t  getNumThreads() const;
+
+    // runs the chain in place, ofxCvImage::apply() does the same for
+    // the ROI of an image. returns false if a source doesn't match
+    bool  run( ofPixels& pixels );
+    bool  run( ofFloatPixels& pixels );
+
+
+  protected:
+
+    friend class ofxCvImage;
+
+    // rows of an image or ROI
+    struct Plane {
+        unsigned char*  data = nullptr;
+        int  width = 0;
+        int  height = 0;
+        int  stride = 0;           // in bytes
+        bool  bFloat = false;
+        float  scaleMin = 0;
+        float  scaleMax = 255;
+    };
+
+    enum Type {
+        ABS_DIFF,
+        SUBTRACT,
+        SUBTRACT_VALUE,
+        THRESHOLD,
+        CONVERT_TO_RANGE,
+        BLUR,
+        ERODE,
+        DILATE
+    };
+
+    struct Op {
+        Type  type = ABS_DIFF;
+        float  value = 0;
+        float  max = 0;
+        bool  invert = false;
+        int  radius = 0;           // of blur, erode and dilate
+
+        // one of them for ops with a source, resolved into source
+        const ofxCvImage*  image = nullptr;
+        const ofPixels*  pixels = nullptr;
+        const ofFloatPixels*  floatPixels = nullptr;
+        Plane  source;
+
+        // set before each run for the type of the image
+        float  scale = 1;
+        float  offset = 0;
+        std::vector<unsigned char>  lut;    // per pixel ops on 8 bits
+        bool  bMerged = false;              // lut merged in the previous op
+        bool  bComposed = false;            // luts of the next ops merged in this one
+    };
+
+    struct Range {
+        int  in0, in1;             // rows a stage reads
+        int  out0, out1;           // rows it writes
+        int  next;                 // next row to write
+    };
+
+    // buffers of each band, kept between runs
+    template<typename T, typename Acc>
+    struct Band {
+        int  y0, y1;               // rows written
+        int  s0, s1;               // rows read
+        std::vector<T>  halo;      // rows read from other bands
+        std::vector<T>  row;
+        std::vector<T>  padded;
+        std::vector<std::vector<T>>  rings;     // filtered rows of erode and dilate
+        std::vector<std::vector<Acc>>  sumRings;    // and of blur, as sums
+        std::vector<std::vector<Acc>>  sums;    // running column sums of blurs
+        std::vector<std::vector<T>>  outs;      // output row of each stage
+        std::vector<Range>  ranges;             // of each stage
+    };
+
+    // thread that processes the bands it's sent, kept between runs
+    class Worker : public ofThread {
+      public:
+        Worker( ofxCvPipeline& pipeline );
+        ~Worker();
+        ofThreadChannel<std::size_t>  bands;
+
+      protected:
+        void  threadedFunction();
+        ofxCvPipeline&  pipeline;
+    };
+
+    ofxCvPipeline&  add( const Op& op );
+    bool  run( const Plane& image );
+    bool  resolve( const Plane& image );
+    template<typename T, typename Acc>
+    void  run( const Plane& image, std::vector<Band<T,Acc>>& bands );
+    void  runBand( std::size_t b );    // of the image being run
+    template<typename T, typename Acc>
+    void  runBand( const Plane& image, Band<T,Acc>& band );
+    template<typename T, typename Acc>
+    void  push( const Plane& image, Band<T,Acc>& band, std::size_t stage,
+                int y, const T* row );
+    template<typename T>
+    void  applyOps( std::size_t first, std::size_t last, T* row, int y, int w ) const;
+    static void  map( const Op& op, unsigned char* row, int w );
+    static void  map( const Op& op, float* row, int w );
+
+    std::vector<Op>  ops;
+    std::vector<std::size_t>  stages;    // indices of blur, erode and dilate
+    std::size_t  numThreads = 0;
+
+    std::vector<Band<unsigned char,int>>  bands8;
+    std::vector<Band<float,float>>  bands32;
+
+    Plane  current;                      // image being run
+    ofThreadChannel<std::size_t>  bandsDone;    // by the workers
+    std::vector<std::unique_ptr<Worker>>  workers;    // run bands 1 to n
+
+};
@@ -11,9 +11,12 @@
 #include "ofxCvColorImage.h"
 #include "ofxCvFloatImage.h"
 #include "ofxCvShortImage.h"
+#include "ofxCvPipeline.h"
 
 //--------------------------
 // contours and blobs
 #include "ofxCvContourFinder.h"
+#include "ofxCvConnectedComponents.h"
+#include "ofxCvBlobTracker.h"
 
 #include "ofxCvHaarFinder.h"
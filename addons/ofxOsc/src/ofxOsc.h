@@ -4,5 +4,7 @@
 
 #include "ofxOscArg.h"
 #include "ofxOscMessage.h"
+#include "ofxOscFlatMessage.h"
+#include "ofxOscRouter.h"
 #include "ofxOscSender.h"
 #include "ofxOscReceiver.h"
@@ -0,0 +1,856 @@
+// copyright (c) openFrameworks team 2010-2017
+#include "ofxOscFlatMessage.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+namespace{
+	// OSC data is big endian and aligned to 4 bytes
+
+	std::size_t pad4(std::size_t size){
+		return (size + 3) & ~std::size_t(3);
+	}
+
+	std::uint32_t read32(const char *data){
+		auto bytes = reinterpret_cast<const unsigned char*>(data);
+		return (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16) |
+		       (std::uint32_t(bytes[2]) << 8) | std::uint32_t(bytes[3]);
+	}
+
+	std::uint64_t read64(const char *data){
+		return (std::uint64_t(read32(data)) << 32) | read32(data + 4);
+	}
+
+	char *write32(char *data, std::uint32_t value){
+		data[0] = char(value >> 24);
+		data[1] = char(value >> 16);
+		data[2] = char(value >> 8);
+		data[3] = char(value);
+		return data + 4;
+	}
+
+	char *write64(char *data, std::uint64_t value){
+		write32(data, std::uint32_t(value >> 32));
+		return write32(data + 4, std::uint32_t(value));
+	}
+
+	// writes data followed by zeros up to a multiple of 4, at least one
+	// zero if nullTerminate
+	char *writePadded(char *dst, const char *data, std::size_t size, bool nullTerminate){
+		auto padded = pad4(size + (nullTerminate ? 1 : 0));
+		memcpy(dst, data, size);
+		memset(dst + size, 0, padded - size);
+		return dst + padded;
+	}
+
+	// length of a null terminated string inside size bytes, or size if it
+	// isn't terminated
+	std::size_t stringLength(const char *data, std::size_t size){
+		auto end = static_cast<const char*>(memchr(data, 0, size));
+		return end ? end - data : size;
+	}
+
+	std::size_t argSize(const ofxOscFlatArg &arg){
+		switch(arg.type){
+			case OFXOSC_TYPE_INT32: case OFXOSC_TYPE_FLOAT: case OFXOSC_TYPE_CHAR:
+			case OFXOSC_TYPE_MIDI_MESSAGE: case OFXOSC_TYPE_RGBA_COLOR:
+				return 4;
+			case OFXOSC_TYPE_INT64: case OFXOSC_TYPE_DOUBLE: case OFXOSC_TYPE_TIMETAG:
+				return 8;
+			case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
+				return pad4(arg.bytes.size + 1);
+			case OFXOSC_TYPE_BLOB:
+				return 4 + pad4(arg.bytes.size);
+			default:
+				return 0;
+		}
+	}
+
+	const char bundleTag[] = "#bundle";
+}
+
+//--------------------------------------------------------------
+ofxOscFlatMessage::ofxOscFlatMessage(const char *address){
+	setAddress(address);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::clear(){
+	args.clear();
+	storage.clear();
+	view = nullptr;
+	viewSize = 0;
+	addressOffset = 0;
+	addressSize = 0;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::reserve(std::size_t numArgs, std::size_t numBytes){
+	args.reserve(numArgs);
+	storage.reserve(numBytes);
+}
+
+//--------------------------------------------------------------
+bool ofxOscFlatMessage::parse(const char *data, std::size_t size){
+	clear();
+	if(size < 4 || size % 4 != 0 || data[0] != '/'){
+		return false;
+	}
+
+	// address
+	addressSize = stringLength(data, size);
+	if(addressSize == size){
+		return false;
+	}
+	std::size_t position = pad4(addressSize + 1);
+
+	// type tags, optional in old implementations
+	const char *tags = "";
+	std::size_t numTags = 0;
+	if(position < size){
+		if(data[position] != ','){
+			return false;
+		}
+		tags = data + position + 1;
+		numTags = stringLength(tags, size - position - 1);
+		if(position + 1 + numTags == size){
+			return false;
+		}
+		position += pad4(numTags + 2);
+	}
+
+	// arguments
+	for(std::size_t i = 0; i < numTags; i++){
+		ofxOscFlatArg arg;
+		arg.type = static_cast<ofxOscArgType>(tags[i]);
+		arg.int64Value = 0;
+		std::size_t left = size - position;
+		switch(tags[i]){
+			case OFXOSC_TYPE_INT32: case OFXOSC_TYPE_FLOAT: case OFXOSC_TYPE_CHAR:
+			case OFXOSC_TYPE_MIDI_MESSAGE: case OFXOSC_TYPE_RGBA_COLOR:
+				if(left < 4) return false;
+				arg.uint32Value = read32(data + position);
+				if(arg.type == OFXOSC_TYPE_CHAR){
+					arg.int32Value = char(arg.uint32Value);
+				}
+				break;
+			case OFXOSC_TYPE_INT64: case OFXOSC_TYPE_DOUBLE: case OFXOSC_TYPE_TIMETAG:
+				if(left < 8) return false;
+				arg.timetagValue = read64(data + position);
+				break;
+			case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
+				arg.bytes.offset = position;
+				arg.bytes.size = stringLength(data + position, left);
+				if(arg.bytes.size == left) return false;
+				break;
+			case OFXOSC_TYPE_BLOB:
+				if(left < 4) return false;
+				arg.bytes.offset = position + 4;
+				arg.bytes.size = read32(data + position);
+				if(arg.bytes.size > left - 4) return false;
+				break;
+			case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE:
+			case OFXOSC_TYPE_NONE: case OFXOSC_TYPE_TRIGGER:
+				break;
+			default:
+				// the size of unknown types can't be known
+				args.clear();
+				return false;
+		}
+		position += argSize(arg);
+		args.push_back(arg);
+	}
+	if(position > size){
+		args.clear();
+		return false;
+	}
+
+	view = data;
+	viewSize = size;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::setAddress(const char *address){
+	auto size = strlen(address);
+	addressOffset = appendBytes(address, size, true);
+	addressSize = size;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::setAddress(const std::string &address){
+	addressOffset = appendBytes(address.c_str(), address.size(), true);
+	addressSize = address.size();
+}
+
+//--------------------------------------------------------------
+const char *ofxOscFlatMessage::getAddress() const{
+	if(addressSize == 0){
+		return "";
+	}
+	return getData() + addressOffset;
+}
+
+//--------------------------------------------------------------
+bool ofxOscFlatMessage::isAddress(const char *address) const{
+	return strcmp(getAddress(), address) == 0;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatMessage::getNumArgs() const{
+	return args.size();
+}
+
+//--------------------------------------------------------------
+ofxOscArgType ofxOscFlatMessage::getArgType(std::size_t index) const{
+	if(index >= args.size()){
+		ofLogError("ofxOscFlatMessage") << "getArgType(): index "
+		                                << index << " out of bounds";
+		return OFXOSC_TYPE_INDEXOUTOFBOUNDS;
+	}
+	return args[index].type;
+}
+
+//--------------------------------------------------------------
+std::string ofxOscFlatMessage::getTypeString() const{
+	std::string types;
+	types.reserve(args.size());
+	for(auto &arg: args){
+		types += char(arg.type);
+	}
+	return types;
+}
+
+//--------------------------------------------------------------
+const ofxOscFlatArg &ofxOscFlatMessage::getArg(std::size_t index) const{
+	return args.at(index);
+}
+
+//--------------------------------------------------------------
+std::int32_t ofxOscFlatMessage::getArgAsInt(std::size_t index) const{
+	return getArgAsInt32(index);
+}
+
+//--------------------------------------------------------------
+std::int32_t ofxOscFlatMessage::getArgAsInt32(std::size_t index) const{
+	auto arg = getNumeric(index, "getArgAsInt32");
+	if(!arg) return 0;
+	switch(arg->type){
+		case OFXOSC_TYPE_INT32: return arg->int32Value;
+		case OFXOSC_TYPE_INT64: return std::int32_t(arg->int64Value);
+		case OFXOSC_TYPE_FLOAT: return std::int32_t(arg->floatValue);
+		case OFXOSC_TYPE_DOUBLE: return std::int32_t(arg->doubleValue);
+		default: return arg->type == OFXOSC_TYPE_TRUE;
+	}
+}
+
+//--------------------------------------------------------------
+std::int64_t ofxOscFlatMessage::getArgAsInt64(std::size_t index) const{
+	auto arg = getNumeric(index, "getArgAsInt64");
+	if(!arg) return 0;
+	switch(arg->type){
+		case OFXOSC_TYPE_INT32: return arg->int32Value;
+		case OFXOSC_TYPE_INT64: return arg->int64Value;
+		case OFXOSC_TYPE_FLOAT: return std::int64_t(arg->floatValue);
+		case OFXOSC_TYPE_DOUBLE: return std::int64_t(arg->doubleValue);
+		default: return arg->type == OFXOSC_TYPE_TRUE;
+	}
+}
+
+//--------------------------------------------------------------
+float ofxOscFlatMessage::getArgAsFloat(std::size_t index) const{
+	auto arg = getNumeric(index, "getArgAsFloat");
+	if(!arg) return 0;
+	switch(arg->type){
+		case OFXOSC_TYPE_INT32: return float(arg->int32Value);
+		case OFXOSC_TYPE_INT64: return float(arg->int64Value);
+		case OFXOSC_TYPE_FLOAT: return arg->floatValue;
+		case OFXOSC_TYPE_DOUBLE: return float(arg->doubleValue);
+		default: return arg->type == OFXOSC_TYPE_TRUE;
+	}
+}
+
+//--------------------------------------------------------------
+double ofxOscFlatMessage::getArgAsDouble(std::size_t index) const{
+	auto arg = getNumeric(index, "getArgAsDouble");
+	if(!arg) return 0;
+	switch(arg->type){
+		case OFXOSC_TYPE_INT32: return double(arg->int32Value);
+		case OFXOSC_TYPE_INT64: return double(arg->int64Value);
+		case OFXOSC_TYPE_FLOAT: return arg->floatValue;
+		case OFXOSC_TYPE_DOUBLE: return arg->doubleValue;
+		default: return arg->type == OFXOSC_TYPE_TRUE;
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxOscFlatMessage::getArgAsBool(std::size_t index) const{
+	auto arg = getNumeric(index, "getArgAsBool");
+	if(!arg) return false;
+	switch(arg->type){
+		case OFXOSC_TYPE_INT32: return arg->int32Value != 0;
+		case OFXOSC_TYPE_INT64: return arg->int64Value != 0;
+		case OFXOSC_TYPE_FLOAT: return arg->floatValue != 0;
+		case OFXOSC_TYPE_DOUBLE: return arg->doubleValue != 0;
+		default: return arg->type == OFXOSC_TYPE_TRUE;
+	}
+}
+
+//--------------------------------------------------------------
+char ofxOscFlatMessage::getArgAsChar(std::size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_CHAR){
+		ofLogError("ofxOscFlatMessage") << "getArgAsChar(): argument " << index << " is not a char";
+		return 0;
+	}
+	return char(args[index].int32Value);
+}
+
+//--------------------------------------------------------------
+std::uint32_t ofxOscFlatMessage::getArgAsMidiMessage(std::size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_MIDI_MESSAGE){
+		ofLogError("ofxOscFlatMessage") << "getArgAsMidiMessage(): argument " << index << " is not a midi message";
+		return 0;
+	}
+	return args[index].uint32Value;
+}
+
+//--------------------------------------------------------------
+std::uint64_t ofxOscFlatMessage::getArgAsTimetag(std::size_t index) const{
+	if(getArgType(index) != OFXOSC_TYPE_TIMETAG){
+		ofLogError("ofxOscFlatMessage") << "getArgAsTimetag(): argument " << index << " is not a timetag";
+		return 0;
+	}
+	return args[index].timetagValue;
+}
+
+//--------------------------------------------------------------
+std::uint32_t ofxOscFlatMessage::getArgAsRgbaColor(std::size_t index) const{
+	auto type = getArgType(index);
+	if(type == OFXOSC_TYPE_INT32){
+		return args[index].uint32Value;
+	}
+	if(type != OFXOSC_TYPE_RGBA_COLOR){
+		ofLogError("ofxOscFlatMessage") << "getArgAsRgbaColor(): argument " << index << " is not a color";
+		return 0;
+	}
+	return args[index].uint32Value;
+}
+
+//--------------------------------------------------------------
+const char *ofxOscFlatMessage::getArgAsCString(std::size_t index) const{
+	auto data = getBytes(index, OFXOSC_TYPE_STRING, OFXOSC_TYPE_SYMBOL, "getArgAsCString");
+	return data ? data : "";
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatMessage::getArgAsStringSize(std::size_t index) const{
+	auto data = getBytes(index, OFXOSC_TYPE_STRING, OFXOSC_TYPE_SYMBOL, "getArgAsStringSize");
+	return data ? args[index].bytes.size : 0;
+}
+
+//--------------------------------------------------------------
+std::string ofxOscFlatMessage::getArgAsString(std::size_t index) const{
+	auto data = getBytes(index, OFXOSC_TYPE_STRING, OFXOSC_TYPE_SYMBOL, "getArgAsString");
+	return data ? std::string(data, args[index].bytes.size) : std::string();
+}
+
+//--------------------------------------------------------------
+const char *ofxOscFlatMessage::getArgAsBlobData(std::size_t index) const{
+	return getBytes(index, OFXOSC_TYPE_BLOB, OFXOSC_TYPE_BLOB, "getArgAsBlobData");
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatMessage::getArgAsBlobSize(std::size_t index) const{
+	auto data = getBytes(index, OFXOSC_TYPE_BLOB, OFXOSC_TYPE_BLOB, "getArgAsBlobSize");
+	return data ? args[index].bytes.size : 0;
+}
+
+// set methods
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addIntArg(std::int32_t argument){
+	addInt32Arg(argument);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addInt32Arg(std::int32_t argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_INT32;
+	arg.int32Value = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addInt64Arg(std::int64_t argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_INT64;
+	arg.int64Value = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addFloatArg(float argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_FLOAT;
+	arg.floatValue = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addDoubleArg(double argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_DOUBLE;
+	arg.doubleValue = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addStringArg(const char *argument){
+	addBytesArg(OFXOSC_TYPE_STRING, argument, strlen(argument));
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addStringArg(const std::string &argument){
+	addBytesArg(OFXOSC_TYPE_STRING, argument.c_str(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addSymbolArg(const char *argument){
+	addBytesArg(OFXOSC_TYPE_SYMBOL, argument, strlen(argument));
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addSymbolArg(const std::string &argument){
+	addBytesArg(OFXOSC_TYPE_SYMBOL, argument.c_str(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addCharArg(char argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_CHAR;
+	arg.int32Value = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addMidiMessageArg(std::uint32_t argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_MIDI_MESSAGE;
+	arg.uint32Value = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addBoolArg(bool argument){
+	ofxOscFlatArg arg;
+	arg.type = argument ? OFXOSC_TYPE_TRUE : OFXOSC_TYPE_FALSE;
+	arg.int64Value = 0;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addNoneArg(){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_NONE;
+	arg.int64Value = 0;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addTriggerArg(){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_TRIGGER;
+	arg.int64Value = 0;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addTimetagArg(std::uint64_t argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_TIMETAG;
+	arg.timetagValue = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addBlobArg(const char *data, std::size_t size){
+	addBytesArg(OFXOSC_TYPE_BLOB, data, size);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addBlobArg(const ofBuffer &argument){
+	addBytesArg(OFXOSC_TYPE_BLOB, argument.getData(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addRgbaColorArg(std::uint32_t argument){
+	ofxOscFlatArg arg;
+	arg.type = OFXOSC_TYPE_RGBA_COLOR;
+	arg.uint32Value = argument;
+	args.push_back(arg);
+}
+
+// serialization
+//--------------------------------------------------------------
+std::size_t ofxOscFlatMessage::getSerializedSize() const{
+	std::size_t size = pad4(addressSize + 1) + pad4(args.size() + 2);
+	for(auto &arg: args){
+		size += argSize(arg);
+	}
+	return size;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatMessage::serialize(char *buffer, std::size_t size) const{
+	auto serializedSize = getSerializedSize();
+	if(serializedSize > size){
+		return 0;
+	}
+
+	auto data = getData();
+	char *dst = writePadded(buffer, getAddress(), addressSize, true);
+
+	// type tags
+	auto tagsSize = pad4(args.size() + 2);
+	memset(dst, 0, tagsSize);
+	dst[0] = ',';
+	for(std::size_t i = 0; i < args.size(); i++){
+		dst[i + 1] = char(args[i].type);
+	}
+	dst += tagsSize;
+
+	for(auto &arg: args){
+		switch(arg.type){
+			case OFXOSC_TYPE_INT32: case OFXOSC_TYPE_FLOAT: case OFXOSC_TYPE_CHAR:
+			case OFXOSC_TYPE_MIDI_MESSAGE: case OFXOSC_TYPE_RGBA_COLOR:
+				dst = write32(dst, arg.uint32Value);
+				break;
+			case OFXOSC_TYPE_INT64: case OFXOSC_TYPE_DOUBLE: case OFXOSC_TYPE_TIMETAG:
+				dst = write64(dst, arg.timetagValue);
+				break;
+			case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
+				dst = writePadded(dst, data + arg.bytes.offset, arg.bytes.size, true);
+				break;
+			case OFXOSC_TYPE_BLOB:
+				dst = write32(dst, arg.bytes.size);
+				dst = writePadded(dst, data + arg.bytes.offset, arg.bytes.size, false);
+				break;
+			default:
+				break;
+		}
+	}
+	return serializedSize;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::toMessage(ofxOscMessage &message) const{
+	message.clear();
+	message.setAddress(getAddress());
+	for(std::size_t i = 0; i < args.size(); i++){
+		auto &arg = args[i];
+		switch(arg.type){
+			case OFXOSC_TYPE_INT32: message.addInt32Arg(arg.int32Value); break;
+			case OFXOSC_TYPE_INT64: message.addInt64Arg(arg.int64Value); break;
+			case OFXOSC_TYPE_FLOAT: message.addFloatArg(arg.floatValue); break;
+			case OFXOSC_TYPE_DOUBLE: message.addDoubleArg(arg.doubleValue); break;
+			case OFXOSC_TYPE_STRING: message.addStringArg(getArgAsString(i)); break;
+			case OFXOSC_TYPE_SYMBOL: message.addSymbolArg(getArgAsString(i)); break;
+			case OFXOSC_TYPE_CHAR: message.addCharArg(char(arg.int32Value)); break;
+			case OFXOSC_TYPE_MIDI_MESSAGE: message.addMidiMessageArg(arg.uint32Value); break;
+			case OFXOSC_TYPE_TRUE: message.addBoolArg(true); break;
+			case OFXOSC_TYPE_FALSE: message.addBoolArg(false); break;
+			case OFXOSC_TYPE_NONE: message.addNoneArg(); break;
+			case OFXOSC_TYPE_TRIGGER: message.addTriggerArg(); break;
+			case OFXOSC_TYPE_TIMETAG: message.addTimetagArg(arg.timetagValue); break;
+			case OFXOSC_TYPE_RGBA_COLOR: message.addRgbaColorArg(arg.uint32Value); break;
+			case OFXOSC_TYPE_BLOB:
+				message.addBlobArg(ofBuffer(getData() + arg.bytes.offset, arg.bytes.size));
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::fromMessage(const ofxOscMessage &message){
+	clear();
+	setAddress(message.getAddress());
+	for(std::size_t i = 0; i < message.getNumArgs(); i++){
+		switch(message.getArgType(i)){
+			case OFXOSC_TYPE_INT32: addInt32Arg(message.getArgAsInt32(i)); break;
+			case OFXOSC_TYPE_INT64: addInt64Arg(message.getArgAsInt64(i)); break;
+			case OFXOSC_TYPE_FLOAT: addFloatArg(message.getArgAsFloat(i)); break;
+			case OFXOSC_TYPE_DOUBLE: addDoubleArg(message.getArgAsDouble(i)); break;
+			case OFXOSC_TYPE_STRING: addStringArg(message.getArgAsString(i)); break;
+			case OFXOSC_TYPE_SYMBOL: addSymbolArg(message.getArgAsSymbol(i)); break;
+			case OFXOSC_TYPE_CHAR: addCharArg(message.getArgAsChar(i)); break;
+			case OFXOSC_TYPE_MIDI_MESSAGE: addMidiMessageArg(message.getArgAsMidiMessage(i)); break;
+			case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE: addBoolArg(message.getArgAsBool(i)); break;
+			case OFXOSC_TYPE_NONE: addNoneArg(); break;
+			case OFXOSC_TYPE_TRIGGER: addTriggerArg(); break;
+			case OFXOSC_TYPE_TIMETAG: addTimetagArg(message.getArgAsTimetag(i)); break;
+			case OFXOSC_TYPE_RGBA_COLOR: addRgbaColorArg(message.getArgAsRgbaColor(i)); break;
+			case OFXOSC_TYPE_BLOB: addBlobArg(message.getArgAsBlob(i)); break;
+			default:
+				break;
+		}
+	}
+}
+
+// private
+//--------------------------------------------------------------
+const char *ofxOscFlatMessage::getData() const{
+	return view ? view : storage.data();
+}
+
+//--------------------------------------------------------------
+const char *ofxOscFlatMessage::getBytes(std::size_t index, ofxOscArgType type1, ofxOscArgType type2, const char *method) const{
+	auto type = getArgType(index);
+	if(type != type1 && type != type2){
+		if(type != OFXOSC_TYPE_INDEXOUTOFBOUNDS){
+			ofLogError("ofxOscFlatMessage") << method << "(): argument " << index
+				<< " of type '" << char(type) << "' can't be converted";
+		}
+		return nullptr;
+	}
+	return getData() + args[index].bytes.offset;
+}
+
+//--------------------------------------------------------------
+const ofxOscFlatArg *ofxOscFlatMessage::getNumeric(std::size_t index, const char *method) const{
+	switch(getArgType(index)){
+		case OFXOSC_TYPE_INT32: case OFXOSC_TYPE_INT64:
+		case OFXOSC_TYPE_FLOAT: case OFXOSC_TYPE_DOUBLE:
+		case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE:
+			return &args[index];
+		case OFXOSC_TYPE_INDEXOUTOFBOUNDS:
+			return nullptr;
+		default:
+			ofLogError("ofxOscFlatMessage") << method << "(): argument " << index
+				<< " of type '" << char(args[index].type) << "' is not numeric";
+			return nullptr;
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::own(){
+	// the offsets of a parsed message are relative to the start of the data
+	// so they stay valid in the copy
+	if(view){
+		storage.assign(view, view + viewSize);
+		view = nullptr;
+		viewSize = 0;
+	}
+}
+
+//--------------------------------------------------------------
+std::uint32_t ofxOscFlatMessage::appendBytes(const char *data, std::size_t size, bool nullTerminate){
+	own();
+	auto offset = storage.size();
+	storage.insert(storage.end(), data, data + size);
+	if(nullTerminate){
+		storage.push_back(0);
+	}
+	return std::uint32_t(offset);
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatMessage::addBytesArg(ofxOscArgType type, const char *data, std::size_t size){
+	ofxOscFlatArg arg;
+	arg.type = type;
+	arg.bytes.offset = appendBytes(data, size, type != OFXOSC_TYPE_BLOB);
+	arg.bytes.size = std::uint32_t(size);
+	args.push_back(arg);
+}
+
+// friend functions
+//--------------------------------------------------------------
+std::ostream& operator<<(std::ostream &os, const ofxOscFlatMessage &message){
+	os << message.getAddress();
+	for(std::size_t i = 0; i < message.getNumArgs(); ++i){
+		auto &arg = message.args[i];
+		os << " ";
+		switch(arg.type){
+			case OFXOSC_TYPE_INT32: os << arg.int32Value; break;
+			case OFXOSC_TYPE_INT64: os << arg.int64Value; break;
+			case OFXOSC_TYPE_FLOAT: os << arg.floatValue; break;
+			case OFXOSC_TYPE_DOUBLE: os << arg.doubleValue; break;
+			case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
+				os << message.getArgAsCString(i);
+				break;
+			case OFXOSC_TYPE_CHAR: os << char(arg.int32Value); break;
+			case OFXOSC_TYPE_MIDI_MESSAGE: case OFXOSC_TYPE_RGBA_COLOR:
+				os << ofToHex(arg.uint32Value);
+				break;
+			case OFXOSC_TYPE_TRUE: os << "T"; break;
+			case OFXOSC_TYPE_FALSE: os << "F"; break;
+			case OFXOSC_TYPE_NONE: os << "NONE"; break;
+			case OFXOSC_TYPE_TRIGGER: os << "TRIGGER"; break;
+			case OFXOSC_TYPE_TIMETAG: os << "TIMETAG"; break;
+			case OFXOSC_TYPE_BLOB: os << "BLOB"; break;
+			default: break;
+		}
+	}
+	return os;
+}
+
+//--------------------------------------------------------------
+ofxOscFlatBundle::ofxOscFlatBundle(const ofxOscFlatBundle &other){
+	*this = other;
+}
+
+//--------------------------------------------------------------
+ofxOscFlatBundle& ofxOscFlatBundle::operator=(const ofxOscFlatBundle &other){
+	if(this == &other) return *this;
+	if(other.copied){
+		// the messages point into the packet, parse the copy again
+		parse(other.packet.data(), other.packet.size(), true);
+	}else{
+		messages.assign(other.messages.begin(), other.messages.begin() + other.count);
+		count = other.count;
+		copied = false;
+		timetag = other.timetag;
+	}
+	remoteHost = other.remoteHost;
+	remotePort = other.remotePort;
+	return *this;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatBundle::clear(){
+	for(std::size_t i = 0; i < count; i++){
+		messages[i].clear();
+	}
+	count = 0;
+	copied = false;
+	timetag = 1;
+	remoteHost.clear();
+	remotePort = 0;
+}
+
+//--------------------------------------------------------------
+bool ofxOscFlatBundle::parse(const char *data, std::size_t size, bool copy){
+	clear();
+	if(copy){
+		packet.assign(data, data + size);
+		data = packet.data();
+		copied = true;
+	}
+	if(size >= 16 && memcmp(data, bundleTag, sizeof(bundleTag)) == 0){
+		timetag = read64(data + 8);
+	}
+	if(!parseElement(data, size, 0)){
+		clear();
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+ofxOscFlatMessage &ofxOscFlatBundle::addMessage(){
+	if(count == messages.size()){
+		messages.emplace_back();
+	}
+	return messages[count++];
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatBundle::addMessage(const ofxOscFlatMessage &message){
+	addMessage() = message;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatBundle::getMessageCount() const{
+	return count;
+}
+
+//--------------------------------------------------------------
+const ofxOscFlatMessage &ofxOscFlatBundle::getMessageAt(std::size_t i) const{
+	return messages[i];
+}
+
+//--------------------------------------------------------------
+ofxOscFlatMessage &ofxOscFlatBundle::getMessageAt(std::size_t i){
+	return messages[i];
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatBundle::setTimetag(std::uint64_t timetag){
+	this->timetag = timetag;
+}
+
+//--------------------------------------------------------------
+std::uint64_t ofxOscFlatBundle::getTimetag() const{
+	return timetag;
+}
+
+//--------------------------------------------------------------
+void ofxOscFlatBundle::setRemoteEndpoint(const std::string &host, int port){
+	remoteHost = host;
+	remotePort = port;
+}
+
+//--------------------------------------------------------------
+const std::string &ofxOscFlatBundle::getRemoteHost() const{
+	return remoteHost;
+}
+
+//--------------------------------------------------------------
+int ofxOscFlatBundle::getRemotePort() const{
+	return remotePort;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatBundle::getSerializedSize() const{
+	// #bundle, time tag and the size of each element
+	std::size_t size = 16;
+	for(std::size_t i = 0; i < count; i++){
+		size += 4 + messages[i].getSerializedSize();
+	}
+	return size;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscFlatBundle::serialize(char *buffer, std::size_t size) const{
+	auto serializedSize = getSerializedSize();
+	if(serializedSize > size){
+		return 0;
+	}
+	memcpy(buffer, bundleTag, sizeof(bundleTag));
+	char *dst = write64(buffer + 8, timetag);
+	for(std::size_t i = 0; i < count; i++){
+		auto messageSize = messages[i].serialize(dst + 4, buffer + size - dst - 4);
+		write32(dst, std::uint32_t(messageSize));
+		dst += 4 + messageSize;
+	}
+	return serializedSize;
+}
+
+// private
+//--------------------------------------------------------------
+bool ofxOscFlatBundle::parseElement(const char *data, std::size_t size, int depth){
+	if(size < 16 || memcmp(data, bundleTag, sizeof(bundleTag)) != 0){
+		if(!addMessage().parse(data, size)){
+			count--;
+			return false;
+		}
+		return true;
+	}
+
+	// limit nesting so a malicious packet can't overflow the stack
+	if(depth > 16){
+		return false;
+	}
+	std::size_t position = 16;
+	while(position < size){
+		if(size - position < 4){
+			return false;
+		}
+		std::size_t elementSize = read32(data + position);
+		position += 4;
+		if(elementSize > size - position || !parseElement(data + position, elementSize, depth + 1)){
+			return false;
+		}
+		position += elementSize;
+	}
+	return true;
+}
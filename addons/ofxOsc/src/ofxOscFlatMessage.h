@@ -0,0 +1,246 @@
+// copyright (c) openFrameworks team 2010-2017
+#pragma once
+
+#include "ofxOscMessage.h"
+
+/// \struct ofxOscFlatArg
+/// \brief an argument of an ofxOscFlatMessage, its type and value
+///
+/// strings, symbols and blobs are stored as the position and size of their
+/// bytes in the memory of the message
+struct ofxOscFlatArg{
+	ofxOscArgType type;
+	union{
+		std::int32_t int32Value;   ///< int32 & char
+		std::int64_t int64Value;
+		float floatValue;
+		double doubleValue;
+		std::uint32_t uint32Value; ///< midi message & rgba color
+		std::uint64_t timetagValue;
+		struct{
+			std::uint32_t offset;
+			std::uint32_t size;
+		} bytes;                   ///< string, symbol & blob
+	};
+};
+
+/// \class ofxOscFlatMessage
+/// \brief an OSC message stored without allocating each argument
+///
+/// arguments are kept in an array of tagged values and the address, strings
+/// and blobs in one buffer. clear() keeps the memory allocated, so reusing a
+/// message to send or receive doesn't allocate once it has grown to the
+/// largest message.
+///
+/// parse() doesn't copy the data: the address, strings and blobs point into
+/// the received packet, which has to stay valid while the message is read.
+/// modifying a parsed message copies it first.
+///
+/// messages are sent with ofxOscSender::sendMessage() and received in an
+/// ofxOscFlatBundle with ofxOscReceiver::getNextBundle()
+class ofxOscFlatMessage{
+public:
+
+	ofxOscFlatMessage(){}
+
+	/// create a message with the given address
+	ofxOscFlatMessage(const char *address);
+
+	/// clear the address & arguments, keeping the memory allocated
+	void clear();
+
+	/// reserve memory for a number of arguments & bytes of address, strings
+	/// and blobs
+	void reserve(std::size_t numArgs, std::size_t numBytes);
+
+	/// parse a message in OSC format without copying it
+	///
+	/// data has to stay valid while the message is used, until it's
+	/// modified or cleared
+	///
+	/// \return false if data isn't a valid OSC message
+	bool parse(const char *data, std::size_t size);
+
+	/// set the message address, must start with a /
+	void setAddress(const char *address);
+	void setAddress(const std::string &address);
+
+	/// \return the OSC address
+	const char *getAddress() const;
+
+	/// \return true if the address is equal to address
+	bool isAddress(const char *address) const;
+
+	/// \return number of arguments
+	std::size_t getNumArgs() const;
+
+	/// \return argument type code for a given index
+	ofxOscArgType getArgType(std::size_t index) const;
+
+	/// \return type tags for all arguments as a string, 1 char for each argument
+	std::string getTypeString() const;
+
+	/// \return the argument at index, its value has to be read according
+	/// to its type
+	const ofxOscFlatArg &getArg(std::size_t index) const;
+
+	/// \section Argument Getters
+	///
+	/// numeric types, bools included, are converted automatically, other
+	/// types return 0 or an empty value with an error
+
+	std::int32_t getArgAsInt(std::size_t index) const;
+	std::int32_t getArgAsInt32(std::size_t index) const;
+	std::int64_t getArgAsInt64(std::size_t index) const;
+	float getArgAsFloat(std::size_t index) const;
+	double getArgAsDouble(std::size_t index) const;
+	bool getArgAsBool(std::size_t index) const;
+	char getArgAsChar(std::size_t index) const;
+	std::uint32_t getArgAsMidiMessage(std::size_t index) const;
+	std::uint64_t getArgAsTimetag(std::size_t index) const;
+	std::uint32_t getArgAsRgbaColor(std::size_t index) const;
+
+	/// \return a string or symbol argument, null terminated, without copying it
+	const char *getArgAsCString(std::size_t index) const;
+
+	/// \return the length of a string or symbol argument
+	std::size_t getArgAsStringSize(std::size_t index) const;
+
+	/// \return a copy of a string or symbol argument
+	std::string getArgAsString(std::size_t index) const;
+
+	/// \return the data of a blob argument, without copying it
+	const char *getArgAsBlobData(std::size_t index) const;
+
+	/// \return the size of a blob argument
+	std::size_t getArgAsBlobSize(std::size_t index) const;
+
+	/// \section Argument Setters
+
+	void addIntArg(std::int32_t argument);
+	void addInt32Arg(std::int32_t argument);
+	void addInt64Arg(std::int64_t argument);
+	void addFloatArg(float argument);
+	void addDoubleArg(double argument);
+	void addStringArg(const char *argument);
+	void addStringArg(const std::string &argument);
+	void addSymbolArg(const char *argument);
+	void addSymbolArg(const std::string &argument);
+	void addCharArg(char argument);
+	void addMidiMessageArg(std::uint32_t argument);
+	void addBoolArg(bool argument);
+	void addNoneArg();
+	void addTriggerArg();
+	void addTimetagArg(std::uint64_t argument);
+	void addBlobArg(const char *data, std::size_t size);
+	void addBlobArg(const ofBuffer &argument);
+	void addRgbaColorArg(std::uint32_t argument);
+
+	/// \section Serialization
+
+	/// \return the size of the message in OSC format
+	std::size_t getSerializedSize() const;
+
+	/// write the message in OSC format to buffer, without allocating
+	/// \return the number of bytes written or 0 if size is too small
+	std::size_t serialize(char *buffer, std::size_t size) const;
+
+	/// copy the address & arguments to an ofxOscMessage
+	void toMessage(ofxOscMessage &message) const;
+
+	/// copy the address & arguments of an ofxOscMessage
+	void fromMessage(const ofxOscMessage &message);
+
+	/// output stream operator for string conversion and printing, as
+	/// ofxOscMessage
+	friend std::ostream& operator<<(std::ostream &os, const ofxOscFlatMessage &message);
+
+private:
+
+	const char *getData() const;
+	const char *getBytes(std::size_t index, ofxOscArgType type1, ofxOscArgType type2, const char *method) const;
+	const ofxOscFlatArg *getNumeric(std::size_t index, const char *method) const;
+	void own();
+	std::uint32_t appendBytes(const char *data, std::size_t size, bool nullTerminate);
+	void addBytesArg(ofxOscArgType type, const char *data, std::size_t size);
+
+	std::vector<ofxOscFlatArg> args; ///< current arguments
+	std::vector<char> storage; ///< address, strings & blobs added or copied
+	const char *view = nullptr; ///< parsed data, while not copied to storage
+	std::size_t viewSize = 0;
+	std::uint32_t addressOffset = 0;
+	std::uint32_t addressSize = 0;
+};
+
+/// \class ofxOscFlatBundle
+/// \brief an OSC packet as a list of ofxOscFlatMessages
+///
+/// parsing a packet flattens nested bundles into one list of messages.
+/// the messages are reused after clear(), so receiving into the same bundle
+/// every frame doesn't allocate once it has grown to the largest packet
+class ofxOscFlatBundle{
+public:
+
+	ofxOscFlatBundle(){}
+	ofxOscFlatBundle(const ofxOscFlatBundle &other);
+	ofxOscFlatBundle& operator=(const ofxOscFlatBundle &other);
+
+	/// clear the messages, keeping the memory allocated
+	void clear();
+
+	/// parse an OSC packet, a message or a bundle
+	///
+	/// \param copy copy the packet to the bundle, otherwise data has to
+	/// stay valid while the bundle is used
+	/// \return false if data isn't a valid OSC packet
+	bool parse(const char *data, std::size_t size, bool copy = false);
+
+	/// \return a new empty message at the end of the bundle, to fill in place
+	ofxOscFlatMessage &addMessage();
+
+	/// add a copy of a message to the bundle
+	void addMessage(const ofxOscFlatMessage &message);
+
+	/// \return the current message count
+	std::size_t getMessageCount() const;
+
+	/// \return the message at the given index
+	const ofxOscFlatMessage &getMessageAt(std::size_t i) const;
+	ofxOscFlatMessage &getMessageAt(std::size_t i);
+
+	/// set the time tag of the bundle, in NTP format, 1 is immediately
+	void setTimetag(std::uint64_t timetag);
+
+	/// \return the time tag of the bundle, 1 (immediately) for a single
+	/// message or the time of the outermost bundle
+	std::uint64_t getTimetag() const;
+
+	/// set host and port of the remote endpoint,
+	/// this is mainly used by ofxOscReceiver
+	void setRemoteEndpoint(const std::string &host, int port);
+
+	/// \return the remote host name/ip or "" if not set
+	const std::string &getRemoteHost() const;
+
+	/// \return the remote port or 0 if not set
+	int getRemotePort() const;
+
+	/// \return the size of the bundle in OSC format
+	std::size_t getSerializedSize() const;
+
+	/// write the bundle in OSC format to buffer, without allocating
+	/// \return the number of bytes written or 0 if size is too small
+	std::size_t serialize(char *buffer, std::size_t size) const;
+
+private:
+
+	bool parseElement(const char *data, std::size_t size, int depth);
+
+	std::vector<ofxOscFlatMessage> messages; ///< messages, reused after clear()
+	std::size_t count = 0; ///< messages in use
+	std::vector<char> packet; ///< copy of the packet parsed
+	bool copied = false;
+	std::uint64_t timetag = 1;
+	std::string remoteHost;
+	int remotePort = 0;
+};
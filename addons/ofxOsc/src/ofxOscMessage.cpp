@@ -62,6 +62,9 @@ ofxOscMessage& ofxOscMessage::copy(const ofxOscMessage &other){
 			case OFXOSC_TYPE_MIDI_MESSAGE:
 				args.push_back(new ofxOscArgMidiMessage(other.getArgAsMidiMessage(i)));
 				break;
+			case OFXOSC_TYPE_NONE:
+				args.push_back(new ofxOscArgNone());
+				break;
 			case OFXOSC_TYPE_TRIGGER:
 				args.push_back(new ofxOscArgTrigger());
 				break;
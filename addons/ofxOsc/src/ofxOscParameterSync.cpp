@@ -13,17 +13,20 @@ ofxOscParameterSync::~ofxOscParameterSync(){
 
 //--------------------------------------------------------------
 void ofxOscParameterSync::setup(ofParameterGroup &group, int localPort, const std::string &host, int remotePort){
+	ofRemoveListener(syncGroup.parameterChangedE(), this, &ofxOscParameterSync::parameterChanged);
 	syncGroup = group;
 	ofAddListener(syncGroup.parameterChangedE(), this, &ofxOscParameterSync::parameterChanged);
 	sender.setup(host, remotePort);
+	receiver.clearRoutes();
+	addRoutes(syncGroup);
 	receiver.setup(localPort);
 }
 
 //--------------------------------------------------------------
 void ofxOscParameterSync::update(){
-	if(receiver.hasWaitingMessages()){
+	if(receiver.hasWaitingMessages() || receiver.hasWaitingBundles()){
 		updatingParameter = true;
-		receiver.getParameter(syncGroup);
+		receiver.dispatchMessages();
 		updatingParameter = false;
 	}
 }
@@ -33,3 +36,24 @@ void ofxOscParameterSync::parameterChanged(ofAbstractParameter &parameter){
 	if(updatingParameter) return;
 	sender.sendParameter(parameter);
 }
+
+//--------------------------------------------------------------
+void ofxOscParameterSync::addRoutes(ofAbstractParameter &parameter){
+	if(!parameter.isSerializable()) return;
+	if(parameter.type() == typeid(ofParameterGroup).name()){
+		ofParameterGroup &group = static_cast<ofParameterGroup &>(parameter);
+		for(std::size_t i = 0; i < group.size(); i++){
+			addRoutes(group[i]);
+		}
+	}
+	else{
+		// same address as ofxOscSender::sendParameter()
+		std::string address;
+		for(auto &name: parameter.getGroupHierarchyNames()){
+			address += "/" + name;
+		}
+		receiver.addRoute(address, [&parameter](const ofxOscMessage &message){
+			ofxOscReceiver::updateParameter(parameter, message);
+		});
+	}
+}
@@ -16,6 +16,10 @@ public:
 
 	/// set the parameter group & connection info
 	/// the remote and local ports must be different to avoid collisions
+	///
+	/// incoming messages are routed to the parameters of the group by
+	/// address, parameters added to the group later are not synced until
+	/// setup is called again
 	void setup(ofParameterGroup &group, int localPort, const std::string &remoteHost, int remotePort);
 	
 	/// process any incoming messages
@@ -25,6 +29,9 @@ private:
 
 	/// parameter change callaback
 	void parameterChanged(ofAbstractParameter &parameter);
+
+	/// add a receiver route for each parameter in a group
+	void addRoutes(ofAbstractParameter &parameter);
 	
 	ofxOscSender sender; ///< sync sender
 	ofxOscReceiver receiver; ///< sync receiver
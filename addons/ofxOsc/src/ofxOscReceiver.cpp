@@ -61,6 +61,11 @@ bool ofxOscReceiver::start() {
 	   osc::UdpSocket::SetUdpBufferSize(65535);
 	}
 	
+	// the listener thread is joined in stop() so the queue can be replaced
+	if(settings.flat && (!packets || packets->buffer.size() < settings.flatQueueSize)){
+		packets.reset(new PacketQueue(settings.flatQueueSize));
+	}
+
 	// create socket
 	osc::UdpListeningReceiveSocket *socket = nullptr;
 	try{
@@ -89,27 +94,36 @@ bool ofxOscReceiver::start() {
 		return false;
 	}
 
-	listenThread = std::thread([this]{
-		while(listenSocket){
+	stopListening = false;
+	listenerRunning = true;
+	listenThread = std::thread([this, socket]{
+		while(!stopListening){
 			try{
-				listenSocket->Run();
+				socket->Run();
 			}
 			catch(std::exception &e){
 				ofLogWarning("ofxOscReceiver") << e.what();
 			}
 		}
+		listenerRunning = false;
 	});
-
-	// detach thread so we don't have to wait on it before creating a new socket
-	// or on destruction, the custom deleter for the socket unique_ptr already
-	// does the right thing
-	listenThread.detach();
 	
 	return true;
 }
 
 //--------------------------------------------------------------
 void ofxOscReceiver::stop() {
+	if(!listenSocket){
+		return;
+	}
+	// Run() clears the break flag when it starts, so keep breaking until
+	// the listener is out of it
+	stopListening = true;
+	while(listenerRunning){
+		listenSocket->AsynchronousBreak();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	listenThread.join();
 	listenSocket.reset();
 }
 
@@ -123,6 +137,11 @@ bool ofxOscReceiver::hasWaitingMessages() const{
 	return !messagesChannel.empty();
 }
 
+//--------------------------------------------------------------
+bool ofxOscReceiver::hasWaitingBundles() const{
+	return packets && !packets->empty();
+}
+
 //--------------------------------------------------------------
 bool ofxOscReceiver::getNextMessage(ofxOscMessage *message){
 	return getNextMessage(*message);
@@ -133,6 +152,60 @@ bool ofxOscReceiver::getNextMessage(ofxOscMessage &message){
 	return messagesChannel.tryReceive(message);
 }
 
+//--------------------------------------------------------------
+bool ofxOscReceiver::getNextBundle(ofxOscFlatBundle &bundle){
+	return packets && packets->pop(bundle);
+}
+
+//--------------------------------------------------------------
+std::uint64_t ofxOscReceiver::getNumDroppedPackets() const{
+	return packets ? packets->dropped.load() : 0;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscReceiver::addRoute(const std::string &pattern, std::function<void(const ofxOscMessage &)> handler, bool threaded){
+	return (threaded ? threadedRoutes : routes).add(pattern, std::move(handler));
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscReceiver::addRoute(const std::string &pattern, std::function<void(const ofxOscFlatMessage &)> handler, bool threaded){
+	return (threaded ? threadedRoutes : routes).add(pattern, std::move(handler));
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::removeRoute(std::size_t id){
+	if(!routes.remove(id)){
+		threadedRoutes.remove(id);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::clearRoutes(){
+	routes.clear();
+	threadedRoutes.clear();
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscReceiver::dispatchMessages(){
+	std::size_t count = 0;
+	ofxOscMessage msg;
+	while(messagesChannel.tryReceive(msg)){
+		if(routes.dispatch(msg)){
+			count++;
+		}
+	}
+	if(packets){
+		while(packets->pop(dispatchedBundle)){
+			for(std::size_t i = 0; i < dispatchedBundle.getMessageCount(); i++){
+				if(routes.dispatch(dispatchedBundle.getMessageAt(i))){
+					count++;
+				}
+			}
+		}
+	}
+	return count;
+}
+
 //--------------------------------------------------------------
 bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
 	ofxOscMessage msg;
@@ -153,31 +226,8 @@ bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
 							}
 						}
 					}
-					else if(p->type() == typeid(ofParameter<int>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_INT32){
-						p->cast<int>() = msg.getArgAsInt32(0);
-					}
-					else if(p->type() == typeid(ofParameter<float>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_FLOAT){
-						p->cast<float>() = msg.getArgAsFloat(0);
-					}
-					else if(p->type() == typeid(ofParameter<double>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_DOUBLE){
-						p->cast<double>() = msg.getArgAsDouble(0);
-					}
-					else if(p->type() == typeid(ofParameter<bool>).name() &&
-						(msg.getArgType(0) == OFXOSC_TYPE_TRUE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_FALSE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_INT32 ||
-						 msg.getArgType(0) == OFXOSC_TYPE_INT64 ||
-						 msg.getArgType(0) == OFXOSC_TYPE_FLOAT ||
-						 msg.getArgType(0) == OFXOSC_TYPE_DOUBLE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_STRING ||
-						 msg.getArgType(0) == OFXOSC_TYPE_SYMBOL)){
-						p->cast<bool>() = msg.getArgAsBool(0);
-					}
-					else if(msg.getArgType(0) == OFXOSC_TYPE_STRING){
-						p->fromString(msg.getArgAsString(0));
+					else{
+						updateParameter(*p, msg);
 					}
 				}
 			}
@@ -186,6 +236,43 @@ bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
 	return true;
 }
 
+//--------------------------------------------------------------
+bool ofxOscReceiver::updateParameter(ofAbstractParameter &parameter, const ofxOscMessage &message){
+	if(message.getNumArgs() == 0){
+		return false;
+	}
+	if(parameter.type() == typeid(ofParameter<int>).name() &&
+		message.getArgType(0) == OFXOSC_TYPE_INT32){
+		parameter.cast<int>() = message.getArgAsInt32(0);
+	}
+	else if(parameter.type() == typeid(ofParameter<float>).name() &&
+		message.getArgType(0) == OFXOSC_TYPE_FLOAT){
+		parameter.cast<float>() = message.getArgAsFloat(0);
+	}
+	else if(parameter.type() == typeid(ofParameter<double>).name() &&
+		message.getArgType(0) == OFXOSC_TYPE_DOUBLE){
+		parameter.cast<double>() = message.getArgAsDouble(0);
+	}
+	else if(parameter.type() == typeid(ofParameter<bool>).name() &&
+		(message.getArgType(0) == OFXOSC_TYPE_TRUE ||
+		 message.getArgType(0) == OFXOSC_TYPE_FALSE ||
+		 message.getArgType(0) == OFXOSC_TYPE_INT32 ||
+		 message.getArgType(0) == OFXOSC_TYPE_INT64 ||
+		 message.getArgType(0) == OFXOSC_TYPE_FLOAT ||
+		 message.getArgType(0) == OFXOSC_TYPE_DOUBLE ||
+		 message.getArgType(0) == OFXOSC_TYPE_STRING ||
+		 message.getArgType(0) == OFXOSC_TYPE_SYMBOL)){
+		parameter.cast<bool>() = message.getArgAsBool(0);
+	}
+	else if(message.getArgType(0) == OFXOSC_TYPE_STRING){
+		parameter.fromString(message.getArgAsString(0));
+	}
+	else{
+		return false;
+	}
+	return true;
+}
+
 //--------------------------------------------------------------
 int ofxOscReceiver::getPort() const{
 	return settings.port;
@@ -266,10 +353,111 @@ void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::Ip
 		}
 	}
 
+	// handled on this thread
+	if(threadedRoutes.dispatch(msg)){
+		return;
+	}
+
 	// send msg to main thread
 	messagesChannel.send(std::move(msg));
 }
 
+//--------------------------------------------------------------
+void ofxOscReceiver::ProcessPacket(const char *data, int size, const osc::IpEndpointName &remoteEndpoint){
+	if(settings.flat && packets){
+		// the packet is only parsed here if it can be handled on this thread
+		if(!threadedRoutes.empty() && routedBundle.parse(data, size)){
+			bool handled = true;
+			for(std::size_t i = 0; i < routedBundle.getMessageCount(); i++){
+				handled &= threadedRoutes.dispatch(routedBundle.getMessageAt(i));
+			}
+			if(handled){
+				return;
+			}
+		}
+		packets->push(data, size, remoteEndpoint);
+	}
+	else{
+		osc::OscPacketListener::ProcessPacket(data, size, remoteEndpoint);
+	}
+}
+
+// PRIVATE
+//--------------------------------------------------------------
+ofxOscReceiver::PacketQueue::PacketQueue(std::size_t size)
+:buffer((size + 3) & ~std::size_t(3)){}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::PacketQueue::push(const char *data, std::size_t size, const osc::IpEndpointName &remoteEndpoint){
+	std::size_t capacity = buffer.size();
+	std::size_t needed = HEADER_SIZE + ((size + 3) & ~std::size_t(3));
+	auto write = writePosition.load(std::memory_order_relaxed);
+	auto read = readPosition.load(std::memory_order_acquire);
+
+	// packets are never split, if it doesn't fit before the end of the
+	// buffer it goes at the beginning
+	std::size_t offset = write % capacity;
+	std::size_t skip = capacity - offset < needed ? capacity - offset : 0;
+	if(needed > capacity || capacity - (write - read) < skip + needed){
+		dropped++;
+		return false;
+	}
+	if(skip){
+		std::uint32_t wrap = WRAP;
+		memcpy(&buffer[offset], &wrap, 4);
+		write += skip;
+		offset = 0;
+	}
+
+	std::uint32_t header[3] = {
+		std::uint32_t(size),
+		std::uint32_t(remoteEndpoint.address),
+		std::uint32_t(remoteEndpoint.port)
+	};
+	memcpy(&buffer[offset], header, HEADER_SIZE);
+	memcpy(&buffer[offset + HEADER_SIZE], data, size);
+	writePosition.store(write + needed, std::memory_order_release);
+	return true;
+}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::PacketQueue::pop(ofxOscFlatBundle &bundle){
+	std::size_t capacity = buffer.size();
+	while(true){
+		auto read = readPosition.load(std::memory_order_relaxed);
+		auto write = writePosition.load(std::memory_order_acquire);
+		if(read == write){
+			return false;
+		}
+
+		std::size_t offset = read % capacity;
+		std::uint32_t header[3];
+		memcpy(header, &buffer[offset], 4);
+		if(header[0] == WRAP){
+			read += capacity - offset;
+			offset = 0;
+		}
+		memcpy(header, &buffer[offset], HEADER_SIZE);
+
+		bool parsed = bundle.parse(&buffer[offset + HEADER_SIZE], header[0], true);
+		if(parsed){
+			char host[osc::IpEndpointName::ADDRESS_STRING_LENGTH];
+			osc::IpEndpointName((unsigned long)header[1], (int)header[2]).AddressAsString(host);
+			bundle.setRemoteEndpoint(host, header[2]);
+		}
+		readPosition.store(read + HEADER_SIZE + ((header[0] + 3) & ~std::uint32_t(3)), std::memory_order_release);
+		if(parsed){
+			return true;
+		}
+		ofLogError("ofxOscReceiver") << "getNextBundle(): discarding malformed packet of " << header[0] << " bytes";
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::PacketQueue::empty() const{
+	return readPosition.load() == writePosition.load();
+}
+
 // friend functions
 //--------------------------------------------------------------
 std::ostream& operator<<(std::ostream &os, const ofxOscReceiver &receiver) {
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "ofxOscMessage.h"
+#include "ofxOscFlatMessage.h"
+#include "ofxOscRouter.h"
 #include "ofParameter.h"
 #include "ofThreadChannel.h"
+#include <atomic>
 
 #include "OscTypes.h"
 #include "OscPacketListener.h"
@@ -16,6 +19,8 @@ struct ofxOscReceiverSettings {
 	int port = 0;            ///< port to listen on
 	bool reuse = true;       ///< should the port be reused by other receivers?
 	bool start = true;       ///< start listening after setup?
+	bool flat = false;       ///< queue packets for getNextBundle() instead of ofxOscMessages?
+	std::size_t flatQueueSize = 1024 * 1024; ///< bytes of packets queued in flat mode
 };
 
 /// \class ofxOscReceiver
@@ -63,7 +68,8 @@ public:
 	/// \return true if the receiver is listening
 	bool isListening() const;
 
-	/// \return true if there are any messages waiting for collection
+	/// \return true if there are any messages waiting for getNextMessage(),
+	/// packets received in flat mode are waiting for getNextBundle() instead
 	bool hasWaitingMessages() const;
 
 	/// remove a message from the queue and copy it's data into msg
@@ -71,10 +77,59 @@ public:
 	bool getNextMessage(ofxOscMessage& msg);
 	OF_DEPRECATED_MSG("Pass a reference instead of a pointer", bool getNextMessage(ofxOscMessage *msg));
 	
+	/// remove the next packet received in flat mode from the queue and
+	/// parse it into bundle
+	///
+	/// packets are copied as they are received to a preallocated queue,
+	/// without allocating or locking, and parsed here without allocating
+	/// once the bundle has grown to the largest packet
+	///
+	/// \return false if there are no waiting packets
+	bool getNextBundle(ofxOscFlatBundle &bundle);
+
+	/// \return true if there are any packets waiting for getNextBundle()
+	bool hasWaitingBundles() const;
+
+	/// \return number of packets dropped in flat mode because the queue
+	/// was full
+	std::uint64_t getNumDroppedPackets() const;
+
+	/// call handler for the messages whose address matches an OSC address
+	/// pattern, see ofxOscRouter
+	///
+	/// threaded routes are called from the receive thread as soon as a
+	/// message arrives and the messages they handle aren't queued, in flat
+	/// mode a packet is queued unless all its messages were handled.
+	/// other routes are called from dispatchMessages()
+	///
+	/// routes aren't copied with the receiver
+	///
+	/// \return an id to remove the route, 0 if pattern isn't valid
+	std::size_t addRoute(const std::string &pattern, std::function<void(const ofxOscMessage &)> handler, bool threaded = false);
+	std::size_t addRoute(const std::string &pattern, std::function<void(const ofxOscFlatMessage &)> handler, bool threaded = false);
+
+	/// remove the route with the given id
+	void removeRoute(std::size_t id);
+
+	/// remove all routes
+	void clearRoutes();
+
+	/// remove all the waiting messages from the queue and call the
+	/// handlers of the routes that are not threaded matching them, messages
+	/// that don't match any route are discarded
+	///
+	/// \return number of messages handled
+	std::size_t dispatchMessages();
+
 	/// try to get waiting message an ofParameter
 	/// \return true if message was handled by the given parameter
 	bool getParameter(ofAbstractParameter &parameter);
 
+	/// set the value of a parameter from the first argument of a message,
+	/// the address isn't checked
+	/// \return true if the argument could be converted to the parameter type
+	static bool updateParameter(ofAbstractParameter &parameter, const ofxOscMessage &message);
+
 	/// \return listening port
 	int getPort() const;
 	
@@ -90,14 +145,46 @@ protected:
 	/// process an incoming osc message and add it to the queue
 	virtual void ProcessMessage(const osc::ReceivedMessage &m, const osc::IpEndpointName &remoteEndpoint);
 
+	/// queue an incoming packet in flat mode, otherwise parse its messages
+	virtual void ProcessPacket(const char *data, int size, const osc::IpEndpointName &remoteEndpoint);
+
 private:
 
+	/// lock-free queue of packets, written by the listener thread and read
+	/// from getNextBundle()
+	///
+	/// each packet is stored after a header with its size and endpoint, a
+	/// header with size WRAP means the next packet starts at the beginning
+	/// of the buffer
+	struct PacketQueue{
+		static const std::uint32_t WRAP = 0xFFFFFFFF;
+		static const std::size_t HEADER_SIZE = 12;
+
+		PacketQueue(std::size_t size);
+		bool push(const char *data, std::size_t size, const osc::IpEndpointName &remoteEndpoint);
+		bool pop(ofxOscFlatBundle &bundle);
+		bool empty() const;
+
+		std::vector<char> buffer;
+		std::atomic<std::uint64_t> writePosition{0};
+		std::atomic<std::uint64_t> readPosition{0};
+		std::atomic<std::uint64_t> dropped{0};
+	};
+
 	/// socket to listen on, unique for each port
 	/// shared between objects if allowReuse is true
 	std::unique_ptr<osc::UdpListeningReceiveSocket, std::function<void(osc::UdpListeningReceiveSocket*)>> listenSocket;
 
-	std::thread listenThread; ///< listener thread
+	std::thread listenThread; ///< listener thread, joined in stop()
+	std::atomic<bool> stopListening{false}; ///< tells the listener thread to exit
+	std::atomic<bool> listenerRunning{false}; ///< false once the listener thread exits
 	ofThreadChannel<ofxOscMessage> messagesChannel; ///< message passing thread channel
+	std::unique_ptr<PacketQueue> packets; ///< packets received in flat mode
+
+	ofxOscRouter routes; ///< routes called from dispatchMessages()
+	ofxOscRouter threadedRoutes; ///< routes called from the receive thread
+	ofxOscFlatBundle routedBundle; ///< packet dispatched to threaded routes in flat mode
+	ofxOscFlatBundle dispatchedBundle; ///< packet dispatched from dispatchMessages() in flat mode
 
 	ofxOscReceiverSettings settings; ///< current settings
 };
@@ -0,0 +1,271 @@
+// copyright (c) openFrameworks team 2010-2017
+#include "ofxOscRouter.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <algorithm>
+
+namespace{
+	// ids are unique across routers so a receiver can tell which of its
+	// routers a route belongs to
+	std::atomic<std::size_t> nextId{1};
+
+	bool hasWildcards(const std::string &part){
+		return part.find_first_of("?*[{") != std::string::npos;
+	}
+
+	// order of the literal parts, compared with a part of an address
+	// without copying it
+	struct PartLess{
+		template<class Child>
+		bool operator()(const Child &child, const std::pair<const char*, std::size_t> &part) const{
+			return child.first.compare(0, std::string::npos, part.first, part.second) < 0;
+		}
+	};
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscRouter::add(const std::string &pattern, std::function<void(const ofxOscMessage &)> handler){
+	Route route;
+	route.handler = std::move(handler);
+	return addRoute(pattern, std::move(route));
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscRouter::add(const std::string &pattern, std::function<void(const ofxOscFlatMessage &)> handler){
+	Route route;
+	route.flatHandler = std::move(handler);
+	return addRoute(pattern, std::move(route));
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::remove(std::size_t id){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto it = nodes.find(id);
+	if(it == nodes.end()){
+		return false;
+	}
+
+	// the node is kept, empty, in case another route is added there
+	auto &routes = it->second->routes;
+	routes.erase(std::remove_if(routes.begin(), routes.end(), [id](const Route &route){
+		return route.id == id;
+	}), routes.end());
+	nodes.erase(it);
+	numRoutes--;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofxOscRouter::clear(){
+	std::unique_lock<std::mutex> lock(mutex);
+	root.literals.clear();
+	root.wildcards.clear();
+	root.routes.clear();
+	nodes.clear();
+	numRoutes = 0;
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscRouter::size() const{
+	return numRoutes;
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::empty() const{
+	return numRoutes == 0;
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::dispatch(const ofxOscMessage &message) const{
+	const std::string &address = message.getAddress();
+	if(empty() || address.empty() || address[0] != '/'){
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	return dispatch(root, address.c_str(), message);
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::dispatch(const ofxOscFlatMessage &message) const{
+	const char *address = message.getAddress();
+	if(empty() || address[0] != '/'){
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	return dispatch(root, address, message);
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::matchPart(const char *pattern, std::size_t patternSize, const char *part, std::size_t partSize){
+	const char *p = pattern, *patternEnd = pattern + patternSize;
+	const char *s = part, *partEnd = part + partSize;
+	while(p < patternEnd){
+		switch(*p){
+			case '?':
+				if(s == partEnd) return false;
+				p++;
+				s++;
+				break;
+
+			case '*':{
+				while(p < patternEnd && *p == '*') p++;
+				if(p == patternEnd) return true;
+				for(; s <= partEnd; s++){
+					if(matchPart(p, patternEnd - p, s, partEnd - s)) return true;
+				}
+				return false;
+			}
+
+			case '[':{
+				auto close = std::find(p + 1, patternEnd, ']');
+				if(s == partEnd || close == patternEnd) return false;
+				bool negate = p[1] == '!';
+				bool found = false;
+				for(auto c = p + 1 + (negate ? 1 : 0); c < close; c++){
+					if(c + 2 < close && c[1] == '-'){
+						found |= *s >= c[0] && *s <= c[2];
+						c += 2;
+					}
+					else{
+						found |= *s == *c;
+					}
+				}
+				if(found == negate) return false;
+				p = close + 1;
+				s++;
+				break;
+			}
+
+			case '{':{
+				auto close = std::find(p + 1, patternEnd, '}');
+				if(close == patternEnd) return false;
+				for(auto option = p + 1; option <= close;){
+					auto optionEnd = std::find(option, close, ',');
+					std::size_t size = optionEnd - option;
+					if(std::size_t(partEnd - s) >= size && memcmp(s, option, size) == 0 &&
+					   matchPart(close + 1, patternEnd - close - 1, s + size, partEnd - s - size)){
+						return true;
+					}
+					option = optionEnd + 1;
+				}
+				return false;
+			}
+
+			default:
+				if(s == partEnd || *s != *p) return false;
+				p++;
+				s++;
+				break;
+		}
+	}
+	return s == partEnd;
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::match(const std::string &pattern, const std::string &address){
+	auto patternParts = ofSplitString(pattern, "/");
+	auto addressParts = ofSplitString(address, "/");
+	if(patternParts.size() != addressParts.size() || pattern.empty() || address.empty() ||
+	   pattern[0] != '/' || address[0] != '/'){
+		return false;
+	}
+	for(std::size_t i = 0; i < patternParts.size(); i++){
+		if(!matchPart(patternParts[i].c_str(), patternParts[i].size(), addressParts[i].c_str(), addressParts[i].size())){
+			return false;
+		}
+	}
+	return true;
+}
+
+// PRIVATE
+//--------------------------------------------------------------
+std::size_t ofxOscRouter::addRoute(const std::string &pattern, Route route){
+	if(pattern.empty() || pattern[0] != '/'){
+		ofLogError("ofxOscRouter") << "add(): pattern \"" << pattern << "\" doesn't start with /";
+		return 0;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	Node *node = &root;
+	std::size_t start = 1;
+	while(true){
+		auto end = std::min(pattern.find('/', start), pattern.size());
+		auto part = pattern.substr(start, end - start);
+		if(hasWildcards(part)){
+			auto &children = node->wildcards;
+			auto it = std::find_if(children.begin(), children.end(), [&part](const std::pair<std::string, std::unique_ptr<Node>> &child){
+				return child.first == part;
+			});
+			if(it == children.end()){
+				children.emplace_back(part, std::unique_ptr<Node>(new Node));
+				it = children.end() - 1;
+			}
+			node = it->second.get();
+		}
+		else{
+			auto &children = node->literals;
+			auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(part.c_str(), part.size()), PartLess());
+			if(it == children.end() || it->first != part){
+				it = children.emplace(it, part, std::unique_ptr<Node>(new Node));
+			}
+			node = it->second.get();
+		}
+		if(end == pattern.size()){
+			break;
+		}
+		start = end + 1;
+	}
+
+	route.id = nextId++;
+	node->routes.push_back(std::move(route));
+	nodes[node->routes.back().id] = node;
+	numRoutes++;
+	return node->routes.back().id;
+}
+
+//--------------------------------------------------------------
+template<class Message>
+bool ofxOscRouter::dispatch(const Node &node, const char *address, const Message &message) const{
+	bool called = false;
+	if(*address == 0){
+		for(auto &route: node.routes){
+			called |= call(route, message);
+		}
+		return called;
+	}
+
+	// address points to the / before the next part
+	const char *part = address + 1;
+	const char *end = part;
+	while(*end != 0 && *end != '/') end++;
+	std::size_t size = end - part;
+
+	auto it = std::lower_bound(node.literals.begin(), node.literals.end(), std::make_pair(part, size), PartLess());
+	if(it != node.literals.end() && it->first.size() == size && memcmp(it->first.c_str(), part, size) == 0){
+		called |= dispatch(*it->second, end, message);
+	}
+	for(auto &child: node.wildcards){
+		if(matchPart(child.first.c_str(), child.first.size(), part, size)){
+			called |= dispatch(*child.second, end, message);
+		}
+	}
+	return called;
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::call(const Route &route, const ofxOscMessage &message){
+	if(route.handler){
+		route.handler(message);
+		return true;
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+bool ofxOscRouter::call(const Route &route, const ofxOscFlatMessage &message){
+	if(route.flatHandler){
+		route.flatHandler(message);
+		return true;
+	}
+	return false;
+}
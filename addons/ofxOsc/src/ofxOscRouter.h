@@ -0,0 +1,98 @@
+// copyright (c) openFrameworks team 2010-2017
+#pragma once
+
+#include "ofxOscMessage.h"
+#include "ofxOscFlatMessage.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/// \class ofxOscRouter
+/// \brief calls handlers for the messages matching OSC address patterns
+///
+/// patterns are split at each / into a tree, so dispatching a message only
+/// walks the parts of its address instead of comparing it with every
+/// pattern:
+///
+/// ~~~~{.cpp}
+/// router.add("/synth/*/volume", [](const ofxOscMessage &m){ ... });
+/// router.add("/synth/{lead,bass}/note", [](const ofxOscMessage &m){ ... });
+///
+/// while(receiver.getNextMessage(m)){
+///     router.dispatch(m);
+/// }
+/// ~~~~
+///
+/// each part of a pattern can use the OSC wildcards ? (any character),
+/// * (any sequence of characters), [abc], [a-z] & [!abc] (any character
+/// in or not in the list) and {foo,bar} (any of the strings). the address
+/// of the messages is compared as is, without wildcards.
+///
+/// all the handlers of the patterns matching a message are called. handlers
+/// are added for ofxOscMessage or ofxOscFlatMessage and only called for
+/// messages of their type.
+///
+/// routes can be added and removed from any thread but not from a handler
+class ofxOscRouter{
+public:
+
+	/// add a handler for the messages matching pattern
+	/// \return an id to remove the route, 0 if pattern doesn't start with /
+	std::size_t add(const std::string &pattern, std::function<void(const ofxOscMessage &)> handler);
+	std::size_t add(const std::string &pattern, std::function<void(const ofxOscFlatMessage &)> handler);
+
+	/// remove the route with the given id
+	/// \return false if there's no route with that id
+	bool remove(std::size_t id);
+
+	/// remove all routes
+	void clear();
+
+	/// \return the number of routes
+	std::size_t size() const;
+
+	/// \return true if there are no routes
+	bool empty() const;
+
+	/// call the handlers of the patterns matching the message address
+	/// \return true if at least one handler was called
+	bool dispatch(const ofxOscMessage &message) const;
+	bool dispatch(const ofxOscFlatMessage &message) const;
+
+	/// \return true if a part of an address matches a part of a pattern,
+	/// without /
+	static bool matchPart(const char *pattern, std::size_t patternSize, const char *part, std::size_t partSize);
+
+	/// \return true if an address matches a pattern
+	static bool match(const std::string &pattern, const std::string &address);
+
+private:
+
+	struct Route{
+		std::size_t id;
+		std::function<void(const ofxOscMessage &)> handler;
+		std::function<void(const ofxOscFlatMessage &)> flatHandler;
+	};
+
+	/// a part of the patterns, literal parts are sorted to be found by
+	/// binary search, parts with wildcards are compared one by one
+	struct Node{
+		std::vector<std::pair<std::string, std::unique_ptr<Node>>> literals;
+		std::vector<std::pair<std::string, std::unique_ptr<Node>>> wildcards;
+		std::vector<Route> routes; ///< routes of the patterns ending here
+	};
+
+	std::size_t addRoute(const std::string &pattern, Route route);
+
+	template<class Message>
+	bool dispatch(const Node &node, const char *address, const Message &message) const;
+	static bool call(const Route &route, const ofxOscMessage &message);
+	static bool call(const Route &route, const ofxOscFlatMessage &message);
+
+	Node root;
+	std::unordered_map<std::size_t, Node*> nodes; ///< node of each route id
+	std::atomic<std::size_t> numRoutes{0};
+	mutable std::mutex mutex;
+};
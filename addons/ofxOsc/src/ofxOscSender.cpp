@@ -128,6 +128,47 @@ void ofxOscSender::sendMessage(const ofxOscMessage &message, bool wrapInBundle){
 	sendSocket->Send(p.Data(), p.Size());
 }
 
+//--------------------------------------------------------------
+void ofxOscSender::sendMessage(const ofxOscFlatMessage &message, bool wrapInBundle){
+	if(!sendSocket){
+		ofLogError("ofxOscSender") << "trying to send with empty socket";
+		return;
+	}
+
+	auto size = message.getSerializedSize();
+	if(!wrapInBundle){
+		flatBuffer.resize(std::max(flatBuffer.size(), size));
+		message.serialize(flatBuffer.data(), size);
+		sendSocket->Send(flatBuffer.data(), size);
+		return;
+	}
+
+	// bundle with an immediate time tag and the message as its only element
+	static const char header[] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0, 0, 0, 1};
+	flatBuffer.resize(std::max(flatBuffer.size(), sizeof(header) + 4 + size));
+	char *data = flatBuffer.data();
+	memcpy(data, header, sizeof(header));
+	data[16] = char(size >> 24);
+	data[17] = char(size >> 16);
+	data[18] = char(size >> 8);
+	data[19] = char(size);
+	message.serialize(data + 20, size);
+	sendSocket->Send(data, 20 + size);
+}
+
+//--------------------------------------------------------------
+void ofxOscSender::sendBundle(const ofxOscFlatBundle &bundle){
+	if(!sendSocket){
+		ofLogError("ofxOscSender") << "trying to send with empty socket";
+		return;
+	}
+
+	auto size = bundle.getSerializedSize();
+	flatBuffer.resize(std::max(flatBuffer.size(), size));
+	bundle.serialize(flatBuffer.data(), size);
+	sendSocket->Send(flatBuffer.data(), size);
+}
+
 //--------------------------------------------------------------
 void ofxOscSender::sendParameter(const ofAbstractParameter &parameter){
 	if(!parameter.isSerializable()) return;
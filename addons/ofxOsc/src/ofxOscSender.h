@@ -7,6 +7,7 @@
 #include "UdpSocket.h"
 
 #include "ofxOscBundle.h"
+#include "ofxOscFlatMessage.h"
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
 
@@ -49,6 +50,15 @@ public:
 	/// send the given bundle
 	void sendBundle(const ofxOscBundle &bundle);
 
+	/// send the given flat message, serialized without allocating once the
+	/// sender has sent a message as large
+	/// if wrapInBundle is true (default), message sent in a timetagged bundle
+	void sendMessage(const ofxOscFlatMessage &message, bool wrapInBundle=true);
+
+	/// send the given flat bundle, serialized without allocating once the
+	/// sender has sent a bundle as large
+	void sendBundle(const ofxOscFlatBundle &bundle);
+
 	/// create & send a message with data from an ofParameter
 	void sendParameter(const ofAbstractParameter &parameter);
 
@@ -75,4 +85,5 @@ private:
 
 	ofxOscSenderSettings settings; ///< current settings
 	std::unique_ptr<osc::UdpTransmitSocket> sendSocket; ///< sender socket
+	std::vector<char> flatBuffer; ///< reused to serialize flat messages & bundles
 };
@@ -965,6 +965,7 @@ void ofDeserialize(const ofxXmlPoco & xml, ofAbstractParameter & parameter){
 	if(parameter.type() == typeid(ofParameterGroup).name()){
 		ofParameterGroup & group = static_cast <ofParameterGroup &>(parameter);
 		if(const_cast<ofxXmlPoco&>(xml).setTo(name)){
+			ofParameterGroup::ChangeSet changes(group);
 			for(auto & p: group){
 				ofDeserialize(xml, *p);
 			}
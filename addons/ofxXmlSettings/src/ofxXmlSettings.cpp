@@ -715,6 +715,7 @@ void ofDeserialize(const ofxXmlSettings & xml, ofAbstractParameter & parameter){
 		ofParameterGroup & group = static_cast<ofParameterGroup&>(parameter);
 		if(xml.tagExists(name)){
 			const_cast<ofxXmlSettings&>(xml).pushTag(name);
+			ofParameterGroup::ChangeSet changes(group);
 			for(size_t i = 0;i < group.size(); i++){
 				ofDeserialize(xml, group.get(i));
 			}
@@ -9,6 +9,18 @@
 template<class V, class N, class C, class T>
 class ofMeshFace_;
 
+/// \brief Post-transform vertex cache statistics for an indexed
+/// triangle mesh, as returned by ofMesh_::getCacheStats().
+struct ofMeshCacheStats{
+	/// \brief Average cache miss ratio: transformed vertices per triangle.
+	/// 3.0 is the worst case, ~0.5 is close to optimal for big meshes.
+	float acmr = 0.f;
+
+	/// \brief Average transform to vertex ratio: transformed vertices per
+	/// referenced vertex. 1.0 means every vertex is transformed only once.
+	float atvr = 0.f;
+};
+
 /// \brief Represents a set of vertices in 3D spaces with normals, colors,
 /// and texture coordinates at those points.
 ///
@@ -557,6 +569,53 @@ public:
 	ofMesh_<V,N,C,T> getMeshForIndices( ofIndexType startIndex, ofIndexType endIndex ) const;
 	ofMesh_<V,N,C,T> getMeshForIndices( ofIndexType startIndex, ofIndexType endIndex, ofIndexType startVertIndex, ofIndexType endVertIndex ) const;
 
+	/// \}
+	/// \name Index optimization
+	/// \{
+
+	/// \brief Simulates a FIFO post-transform cache of cacheSize entries
+	/// over the current indices.
+	///
+	/// Only meaningful for indexed OF_PRIMITIVE_TRIANGLES meshes, other
+	/// meshes return zeroed stats.
+	/// \returns the ACMR and ATVR of the mesh for that cache size.
+	ofMeshCacheStats getCacheStats(std::size_t cacheSize = 16) const;
+
+	/// \brief Reorders the triangles to improve post-transform vertex cache
+	/// hits using Forsyth's linear-speed algorithm.
+	///
+	/// The result is independent of the exact cache size of the GPU.
+	/// Only works on indexed meshes in OF_PRIMITIVE_TRIANGLES mode.
+	void optimizeVertexCache();
+
+	/// \brief Reorders clusters of triangles so the ones facing outwards
+	/// are drawn first, which reduces overdraw from most view points.
+	///
+	/// Should be called after optimizeVertexCache(), clusters are split
+	/// where that order already misses the cache completely so the vertex
+	/// cache efficiency is mostly preserved. If the new order makes the ACMR
+	/// worse than threshold times the original one the order is left as is.
+	void optimizeOverdraw(float threshold = 1.05f);
+
+	/// \brief Reorders the vertices, and their colors, normals and texture
+	/// coordinates, in the order they are first referenced by the indices
+	/// so the GPU fetches vertex memory linearly.
+	///
+	/// Vertices not referenced by any index are kept at the end.
+	void optimizeVertexFetch();
+
+	/// \brief Runs optimizeVertexCache(), optimizeOverdraw() and
+	/// optimizeVertexFetch() in that order and logs the ACMR / ATVR before
+	/// and after at verbose level.
+	///
+	/// ~~~~{.cpp}
+	/// ofMesh mesh = ofMesh::icosphere(100, 5);
+	/// auto before = mesh.getCacheStats();
+	/// mesh.optimizeIndices();
+	/// auto after = mesh.getCacheStats();
+	/// ~~~~
+	void optimizeIndices(float overdrawThreshold = 1.05f);
+
 
 	/// \}
 	/// \name Drawing
@@ -8,6 +8,8 @@
 #include "ofMath.h"
 #include "ofLog.h"
 #include <map>
+#include <algorithm>
+#include <limits>
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
@@ -1553,6 +1555,396 @@ void ofMesh_<V,N,C,T>::mergeDuplicateVertices() {
 }
 
 
+//--------------------------------------------------------------
+namespace of{
+	namespace priv{
+		// moves attributes[i] to attributes[remap[i]], attribute arrays
+		// that don't have one element per vertex are left untouched
+		template<class A>
+		bool remapAttributes(std::vector<A> & attributes, const std::vector<ofIndexType> & remap){
+			if(attributes.size() != remap.size()){
+				return false;
+			}
+			std::vector<A> old = attributes;
+			for(std::size_t i = 0; i < remap.size(); i++){
+				attributes[remap[i]] = old[i];
+			}
+			return true;
+		}
+	}
+}
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+ofMeshCacheStats ofMesh_<V,N,C,T>::getCacheStats(std::size_t cacheSize) const{
+	ofMeshCacheStats stats;
+	if(getMode() != OF_PRIMITIVE_TRIANGLES || indices.size() < 3 || cacheSize == 0){
+		return stats;
+	}
+
+	// FIFO cache, an entry is in cache if it was pushed less than
+	// cacheSize misses ago
+	std::vector<std::size_t> timestamps(vertices.size(), 0);
+	std::vector<bool> referenced(vertices.size(), false);
+	std::size_t time = cacheSize + 1;
+	std::size_t misses = 0;
+	std::size_t unique = 0;
+	for(auto index: indices){
+		if(index >= vertices.size()) continue;
+		if(!referenced[index]){
+			referenced[index] = true;
+			unique++;
+		}
+		if(time - timestamps[index] > cacheSize){
+			timestamps[index] = time++;
+			misses++;
+		}
+	}
+
+	stats.acmr = float(misses) / float(indices.size() / 3);
+	stats.atvr = unique == 0 ? 0.f : float(misses) / float(unique);
+	return stats;
+}
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeVertexCache(){
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogWarning("ofMesh") << "optimizeVertexCache(): only OF_PRIMITIVE_TRIANGLES meshes can be optimized";
+		return;
+	}
+	const std::size_t numTris = indices.size() / 3;
+	const std::size_t numVerts = vertices.size();
+	if(numTris == 0){
+		return;
+	}
+	for(auto index: indices){
+		if(index >= numVerts){
+			ofLogWarning("ofMesh") << "optimizeVertexCache(): index " << index << " out of range, skipping";
+			return;
+		}
+	}
+
+	// Forsyth, "Linear-Speed Vertex Cache Optimisation"
+	const int maxCacheSize = 32;
+	const float cacheDecayPower = 1.5f;
+	const float lastTriScore = 0.75f;
+	const float valenceBoostScale = 2.0f;
+	const float valenceBoostPower = 0.5f;
+
+	auto vertexScore = [&](int cachePosition, std::size_t activeTris){
+		if(activeTris == 0){
+			return -1.f;
+		}
+		float score = 0.f;
+		if(cachePosition >= 0){
+			if(cachePosition < 3){
+				score = lastTriScore;
+			}else{
+				const float scaler = 1.f / (maxCacheSize - 3);
+				score = std::pow(1.f - (cachePosition - 3) * scaler, cacheDecayPower);
+			}
+		}
+		score += valenceBoostScale * std::pow(float(activeTris), -valenceBoostPower);
+		return score;
+	};
+
+	// vertex -> triangles adjacency in one flat array
+	std::vector<std::size_t> activeTris(numVerts, 0);
+	for(auto index: indices){
+		activeTris[index]++;
+	}
+	std::vector<std::size_t> adjacencyOffset(numVerts + 1, 0);
+	for(std::size_t v = 0; v < numVerts; v++){
+		adjacencyOffset[v + 1] = adjacencyOffset[v] + activeTris[v];
+	}
+	std::vector<std::size_t> adjacency(adjacencyOffset.back());
+	{
+		std::vector<std::size_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+		for(std::size_t t = 0; t < numTris; t++){
+			for(std::size_t k = 0; k < 3; k++){
+				auto v = indices[t * 3 + k];
+				adjacency[fill[v]++] = t;
+			}
+		}
+	}
+
+	std::vector<int> cachePosition(numVerts, -1);
+	std::vector<float> vertScore(numVerts);
+	for(std::size_t v = 0; v < numVerts; v++){
+		vertScore[v] = vertexScore(-1, activeTris[v]);
+	}
+	std::vector<float> triScore(numTris);
+	std::vector<bool> triAdded(numTris, false);
+	for(std::size_t t = 0; t < numTris; t++){
+		triScore[t] = vertScore[indices[t*3]] + vertScore[indices[t*3+1]] + vertScore[indices[t*3+2]];
+	}
+
+	// adjacency lists are compacted as triangles get added so only the
+	// first activeTris entries of each vertex are still pending
+	auto removeFromAdjacency = [&](ofIndexType v, std::size_t t){
+		auto begin = adjacency.begin() + adjacencyOffset[v];
+		auto end = begin + activeTris[v];
+		auto it = std::find(begin, end, t);
+		if(it != end){
+			std::iter_swap(it, end - 1);
+			activeTris[v]--;
+		}
+	};
+
+	std::vector<ofIndexType> cache;
+	std::vector<ofIndexType> newCache;
+	cache.reserve(maxCacheSize + 3);
+	newCache.reserve(maxCacheSize + 3);
+	std::vector<ofIndexType> newIndices;
+	newIndices.reserve(indices.size());
+
+	std::size_t nextCandidate = 0;
+	std::ptrdiff_t bestTri = -1;
+	for(std::size_t added = 0; added < numTris; added++){
+		if(bestTri < 0){
+			// nothing useful in the cache, pick the best scored of the
+			// remaining triangles, in practice this is rare so a linear
+			// scan from the last position is good enough
+			float bestScore = -1.f;
+			for(std::size_t t = nextCandidate; t < numTris; t++){
+				if(!triAdded[t] && triScore[t] > bestScore){
+					bestScore = triScore[t];
+					bestTri = t;
+				}
+			}
+			while(nextCandidate < numTris && triAdded[nextCandidate]){
+				nextCandidate++;
+			}
+		}
+
+		triAdded[bestTri] = true;
+		newCache.clear();
+		for(std::size_t k = 0; k < 3; k++){
+			auto v = indices[bestTri * 3 + k];
+			newIndices.push_back(v);
+			removeFromAdjacency(v, bestTri);
+			// degenerate triangles repeat a vertex, it only takes one
+			// cache entry
+			if(std::find(newCache.begin(), newCache.end(), v) == newCache.end()){
+				newCache.push_back(v);
+			}
+		}
+		const std::size_t triVerts = newCache.size();
+		for(auto v: cache){
+			if(std::find(newCache.begin(), newCache.begin() + triVerts, v) == newCache.begin() + triVerts){
+				newCache.push_back(v);
+			}
+		}
+		for(std::size_t i = maxCacheSize; i < newCache.size(); i++){
+			auto v = newCache[i];
+			cachePosition[v] = -1;
+			vertScore[v] = vertexScore(-1, activeTris[v]);
+		}
+		std::swap(cache, newCache);
+
+		// update scores of the vertices in cache, then of the triangles of
+		// the vertices pushed out of it, which are only picked again by the
+		// scan above, and choose the next triangle among the ones in cache
+		for(std::size_t i = 0; i < cache.size() && i < std::size_t(maxCacheSize); i++){
+			auto v = cache[i];
+			cachePosition[v] = i;
+			vertScore[v] = vertexScore(i, activeTris[v]);
+		}
+		for(std::size_t i = maxCacheSize; i < cache.size(); i++){
+			auto v = cache[i];
+			for(std::size_t a = 0; a < activeTris[v]; a++){
+				auto t = adjacency[adjacencyOffset[v] + a];
+				triScore[t] = vertScore[indices[t*3]] + vertScore[indices[t*3+1]] + vertScore[indices[t*3+2]];
+			}
+		}
+		if(cache.size() > std::size_t(maxCacheSize)){
+			cache.resize(maxCacheSize);
+		}
+		bestTri = -1;
+		float bestScore = -1.f;
+		for(auto v: cache){
+			for(std::size_t a = 0; a < activeTris[v]; a++){
+				auto t = adjacency[adjacencyOffset[v] + a];
+				float score = vertScore[indices[t*3]] + vertScore[indices[t*3+1]] + vertScore[indices[t*3+2]];
+				triScore[t] = score;
+				if(score > bestScore){
+					bestScore = score;
+					bestTri = t;
+				}
+			}
+		}
+	}
+
+	// keep any trailing indices that don't form a full triangle
+	newIndices.insert(newIndices.end(), indices.begin() + numTris * 3, indices.end());
+	indices = std::move(newIndices);
+	bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeOverdraw(float threshold){
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogWarning("ofMesh") << "optimizeOverdraw(): only OF_PRIMITIVE_TRIANGLES meshes can be optimized";
+		return;
+	}
+	const std::size_t numTris = indices.size() / 3;
+	if(numTris < 2){
+		return;
+	}
+	for(auto index: indices){
+		if(index >= vertices.size()){
+			ofLogWarning("ofMesh") << "optimizeOverdraw(): index " << index << " out of range, skipping";
+			return;
+		}
+	}
+
+	// Sander, Nehab, Barczak "Fast Triangle Reordering for Vertex Locality
+	// and Reduced Overdraw": split the current order in clusters where all
+	// the vertices of a triangle miss the cache and sort the clusters so the
+	// ones pointing outwards from the center of the mesh go first
+	const std::size_t cacheSize = 16;
+	std::vector<std::size_t> clusters;
+	{
+		std::vector<std::size_t> timestamps(vertices.size(), 0);
+		std::size_t time = cacheSize + 1;
+		for(std::size_t t = 0; t < numTris; t++){
+			std::size_t misses = 0;
+			for(std::size_t k = 0; k < 3; k++){
+				auto v = indices[t * 3 + k];
+				if(time - timestamps[v] > cacheSize){
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			if(t == 0 || misses == 3){
+				clusters.push_back(t);
+			}
+		}
+	}
+	if(clusters.size() < 2){
+		return;
+	}
+	clusters.push_back(numTris);
+
+	glm::vec3 meshCenter;
+	{
+		glm::vec3 sum(0.f);
+		for(auto index: indices){
+			sum += toGlm(vertices[index]);
+		}
+		meshCenter = sum / float(indices.size());
+	}
+
+	std::vector<std::pair<float, std::size_t>> sortKeys(clusters.size() - 1);
+	for(std::size_t c = 0; c < clusters.size() - 1; c++){
+		glm::vec3 center(0.f);
+		glm::vec3 normal(0.f);
+		float area = 0.f;
+		for(std::size_t t = clusters[c]; t < clusters[c+1]; t++){
+			const auto & v0 = toGlm(vertices[indices[t*3]]);
+			const auto & v1 = toGlm(vertices[indices[t*3+1]]);
+			const auto & v2 = toGlm(vertices[indices[t*3+2]]);
+			// length of the cross product is twice the triangle area so
+			// summing it weights the normal and the center by area
+			auto n = glm::cross(v1 - v0, v2 - v0);
+			float a = glm::length(n);
+			center += (v0 + v1 + v2) * (a / 3.f);
+			normal += n;
+			area += a;
+		}
+		float key = 0.f;
+		if(area > 0.f){
+			center /= area;
+			key = glm::dot(center - meshCenter, normal);
+		}
+		sortKeys[c] = std::make_pair(-key, c);
+	}
+	std::stable_sort(sortKeys.begin(), sortKeys.end(), [](const std::pair<float, std::size_t> & a, const std::pair<float, std::size_t> & b){
+		return a.first < b.first;
+	});
+
+	auto before = getCacheStats(cacheSize);
+	std::vector<ofIndexType> oldIndices = indices;
+	std::size_t i = 0;
+	for(auto & key: sortKeys){
+		auto c = key.second;
+		for(std::size_t t = clusters[c]; t < clusters[c+1]; t++){
+			indices[i++] = oldIndices[t * 3];
+			indices[i++] = oldIndices[t * 3 + 1];
+			indices[i++] = oldIndices[t * 3 + 2];
+		}
+	}
+
+	if(getCacheStats(cacheSize).acmr > before.acmr * threshold){
+		indices = std::move(oldIndices);
+		return;
+	}
+	bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeVertexFetch(){
+	if(!hasIndices() || !hasVertices()){
+		return;
+	}
+	const std::size_t numVerts = vertices.size();
+	for(auto index: indices){
+		if(index >= numVerts){
+			ofLogWarning("ofMesh") << "optimizeVertexFetch(): index " << index << " out of range, skipping";
+			return;
+		}
+	}
+
+	const ofIndexType unassigned = std::numeric_limits<ofIndexType>::max();
+	std::vector<ofIndexType> remap(numVerts, unassigned);
+	ofIndexType next = 0;
+	for(auto & index: indices){
+		if(remap[index] == unassigned){
+			remap[index] = next++;
+		}
+		index = remap[index];
+	}
+	for(auto & r: remap){
+		if(r == unassigned){
+			r = next++;
+		}
+	}
+
+	bVertsChanged |= of::priv::remapAttributes(vertices, remap);
+	bColorsChanged |= of::priv::remapAttributes(colors, remap);
+	bNormalsChanged |= of::priv::remapAttributes(normals, remap);
+	bTexCoordsChanged |= of::priv::remapAttributes(texCoords, remap);
+	bIndicesChanged = true;
+	bFacesDirty = true;
+}
+
+
+//--------------------------------------------------------------
+template<class V, class N, class C, class T>
+void ofMesh_<V,N,C,T>::optimizeIndices(float overdrawThreshold){
+	if(getMode() != OF_PRIMITIVE_TRIANGLES){
+		ofLogWarning("ofMesh") << "optimizeIndices(): only OF_PRIMITIVE_TRIANGLES meshes can be optimized";
+		return;
+	}
+	auto before = getCacheStats();
+	optimizeVertexCache();
+	optimizeOverdraw(overdrawThreshold);
+	optimizeVertexFetch();
+	auto after = getCacheStats();
+	ofLogVerbose("ofMesh") << "optimizeIndices(): ACMR " << before.acmr << " -> " << after.acmr
+		<< ", ATVR " << before.atvr << " -> " << after.atvr;
+}
+
+
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 ofMeshFace_<V,N,C,T> ofMesh_<V,N,C,T>::getFace(ofIndexType faceId) const{
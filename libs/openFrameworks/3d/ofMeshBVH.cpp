@@ -0,0 +1,637 @@
+#include "ofMeshBVH.h"
+#include "ofCamera.h"
+#include "ofLog.h"
+#include "ofVectorMath.h"
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+namespace{
+	const size_t maxDepth = 48;
+	const size_t maxStackSize = maxDepth + 2;
+	const size_t maxBins = 64;
+
+	struct Bounds{
+		glm::vec3 min{numeric_limits<float>::max()};
+		glm::vec3 max{-numeric_limits<float>::max()};
+
+		void grow(const glm::vec3 & p){
+			min = glm::min(min, p);
+			max = glm::max(max, p);
+		}
+
+		void grow(const Bounds & b){
+			min = glm::min(min, b.min);
+			max = glm::max(max, b.max);
+		}
+
+		float area() const{
+			auto d = max - min;
+			if(d.x < 0.f || d.y < 0.f || d.z < 0.f){
+				return 0.f;
+			}
+			return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+	};
+
+	// Moller, Trumbore "Fast, Minimum Storage Ray/Triangle Intersection"
+	bool intersectTriangle(const glm::vec3 & origin, const glm::vec3 & direction,
+						   const glm::vec3 & v0, const glm::vec3 & v1, const glm::vec3 & v2,
+						   float & t, float & u, float & v){
+		auto e1 = v1 - v0;
+		auto e2 = v2 - v0;
+		auto p = glm::cross(direction, e2);
+		float det = glm::dot(e1, p);
+		// det scales with the area of the triangle, an absolute epsilon
+		// would miss every hit on small meshes, only parallel rays are
+		// discarded and the barycentric tests reject the rest
+		if(det == 0.f){
+			return false;
+		}
+		float invDet = 1.f / det;
+		auto s = origin - v0;
+		u = glm::dot(s, p) * invDet;
+		if(u < 0.f || u > 1.f){
+			return false;
+		}
+		auto q = glm::cross(s, e1);
+		v = glm::dot(direction, q) * invDet;
+		if(v < 0.f || u + v > 1.f){
+			return false;
+		}
+		t = glm::dot(e2, q) * invDet;
+		return t >= 0.f;
+	}
+
+	// slab test, returns the distance to the entry point or a negative
+	// value if the box is missed
+	float intersectBox(const glm::vec3 & origin, const glm::vec3 & invDirection, const glm::vec3 & min, const glm::vec3 & max, float maxDistance){
+		float tmin = 0.f;
+		float tmax = maxDistance;
+		for(int i = 0; i < 3; i++){
+			float t0 = (min[i] - origin[i]) * invDirection[i];
+			float t1 = (max[i] - origin[i]) * invDirection[i];
+			if(t0 > t1){
+				swap(t0, t1);
+			}
+			// written so NaNs from 0 * inf don't discard the box
+			tmin = t0 > tmin ? t0 : tmin;
+			tmax = t1 < tmax ? t1 : tmax;
+			if(tmin > tmax){
+				return -1.f;
+			}
+		}
+		return tmin;
+	}
+
+	float distanceSquaredToBox(const glm::vec3 & p, const glm::vec3 & min, const glm::vec3 & max){
+		float d = 0.f;
+		for(int i = 0; i < 3; i++){
+			float v = p[i] < min[i] ? min[i] - p[i] : (p[i] > max[i] ? p[i] - max[i] : 0.f);
+			d += v * v;
+		}
+		return d;
+	}
+
+	// Ericson, "Real-Time Collision Detection" 5.1.5
+	glm::vec3 closestPointOnTriangle(const glm::vec3 & p, const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c, glm::vec3 & barycentric){
+		auto ab = b - a;
+		auto ac = c - a;
+		auto ap = p - a;
+		float d1 = glm::dot(ab, ap);
+		float d2 = glm::dot(ac, ap);
+		if(d1 <= 0.f && d2 <= 0.f){
+			barycentric = {1.f, 0.f, 0.f};
+			return a;
+		}
+
+		auto bp = p - b;
+		float d3 = glm::dot(ab, bp);
+		float d4 = glm::dot(ac, bp);
+		if(d3 >= 0.f && d4 <= d3){
+			barycentric = {0.f, 1.f, 0.f};
+			return b;
+		}
+
+		float vc = d1 * d4 - d3 * d2;
+		if(vc <= 0.f && d1 >= 0.f && d3 <= 0.f){
+			float v = d1 / (d1 - d3);
+			barycentric = {1.f - v, v, 0.f};
+			return a + ab * v;
+		}
+
+		auto cp = p - c;
+		float d5 = glm::dot(ab, cp);
+		float d6 = glm::dot(ac, cp);
+		if(d6 >= 0.f && d5 <= d6){
+			barycentric = {0.f, 0.f, 1.f};
+			return c;
+		}
+
+		float vb = d5 * d2 - d1 * d6;
+		if(vb <= 0.f && d2 >= 0.f && d6 <= 0.f){
+			float w = d2 / (d2 - d6);
+			barycentric = {1.f - w, 0.f, w};
+			return a + ac * w;
+		}
+
+		float va = d3 * d6 - d5 * d4;
+		if(va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f){
+			float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			barycentric = {0.f, 1.f - w, w};
+			return b + (c - b) * w;
+		}
+
+		float denom = 1.f / (va + vb + vc);
+		float v = vb * denom;
+		float w = vc * denom;
+		barycentric = {1.f - v - w, v, w};
+		return a + ab * v + ac * w;
+	}
+}
+
+struct ofMeshBVH::BuildContext{
+	vector<Bounds> faceBounds;
+	vector<glm::vec3> centroids;
+	atomic<size_t> nextNode;
+	size_t parallelDepth;
+};
+
+//----------------------------------------
+ofMeshBVH::ofMeshBVH(){
+}
+
+//----------------------------------------
+ofMeshBVH::ofMeshBVH(const ofMesh & mesh){
+	build(mesh);
+}
+
+//----------------------------------------
+ofMeshBVH::ofMeshBVH(const ofMesh & mesh, const Settings & settings){
+	build(mesh, settings);
+}
+
+//----------------------------------------
+bool ofMeshBVH::build(const ofMesh & mesh, const Settings & settings){
+	this->settings = settings;
+	return build(mesh);
+}
+
+//----------------------------------------
+bool ofMeshBVH::build(const ofMesh & mesh){
+	clear();
+
+	auto numVertices = mesh.getNumVertices();
+	auto numElements = mesh.hasIndices() ? mesh.getNumIndices() : numVertices;
+	auto element = [&](size_t i) -> ofIndexType{
+		return mesh.hasIndices() ? mesh.getIndex(i) : ofIndexType(i);
+	};
+	switch(mesh.getMode()){
+		case OF_PRIMITIVE_TRIANGLES:
+			for(size_t i = 0; i + 2 < numElements; i += 3){
+				faceVertices.push_back(element(i));
+				faceVertices.push_back(element(i + 1));
+				faceVertices.push_back(element(i + 2));
+			}
+			break;
+		case OF_PRIMITIVE_TRIANGLE_STRIP:
+			for(size_t i = 0; i + 2 < numElements; i++){
+				// keep the winding consistent for odd triangles
+				if(i % 2 == 0){
+					faceVertices.push_back(element(i));
+					faceVertices.push_back(element(i + 1));
+				}else{
+					faceVertices.push_back(element(i + 1));
+					faceVertices.push_back(element(i));
+				}
+				faceVertices.push_back(element(i + 2));
+			}
+			break;
+		case OF_PRIMITIVE_TRIANGLE_FAN:
+			for(size_t i = 1; i + 1 < numElements; i++){
+				faceVertices.push_back(element(0));
+				faceVertices.push_back(element(i));
+				faceVertices.push_back(element(i + 1));
+			}
+			break;
+		default:
+			ofLogError("ofMeshBVH") << "build(): unsupported primitive mode " << mesh.getMode() << ", only triangles, triangle strips and fans can be used";
+			return false;
+	}
+
+	for(auto index: faceVertices){
+		if(index >= numVertices){
+			ofLogError("ofMeshBVH") << "build(): index " << index << " out of range";
+			clear();
+			return false;
+		}
+	}
+
+	size_t numFaces = faceVertices.size() / 3;
+	if(numFaces == 0){
+		return false;
+	}
+
+	positions.resize(numVertices);
+	for(size_t i = 0; i < numVertices; i++){
+		positions[i] = toGlm(mesh.getVertices()[i]);
+	}
+
+	BuildContext context;
+	context.faceBounds.resize(numFaces);
+	context.centroids.resize(numFaces);
+	faceOrder.resize(numFaces);
+	for(size_t f = 0; f < numFaces; f++){
+		Bounds b;
+		b.grow(getVertex(f, 0));
+		b.grow(getVertex(f, 1));
+		b.grow(getVertex(f, 2));
+		context.faceBounds[f] = b;
+		context.centroids[f] = (b.min + b.max) * 0.5f;
+		faceOrder[f] = f;
+	}
+
+	auto numThreads = settings.numThreads == 0 ? thread::hardware_concurrency() : settings.numThreads;
+	context.parallelDepth = 0;
+	while((size_t(1) << context.parallelDepth) < numThreads){
+		context.parallelDepth++;
+	}
+
+	// a binary tree with n leaves has at most 2n - 1 nodes, allocating
+	// them upfront allows the threads to reserve nodes with just an atomic
+	nodes.resize(numFaces * 2);
+	context.nextNode = 1;
+	buildNode(context, 0, 0, numFaces, 0);
+	nodes.resize(context.nextNode);
+	nodes.shrink_to_fit();
+	return true;
+}
+
+//----------------------------------------
+void ofMeshBVH::buildNode(BuildContext & context, size_t nodeIndex, size_t first, size_t count, size_t depth){
+	Bounds bounds, centroidBounds;
+	for(size_t i = first; i < first + count; i++){
+		auto f = faceOrder[i];
+		bounds.grow(context.faceBounds[f]);
+		centroidBounds.grow(context.centroids[f]);
+	}
+	nodes[nodeIndex].min = bounds.min;
+	nodes[nodeIndex].max = bounds.max;
+	nodes[nodeIndex].first = first;
+	nodes[nodeIndex].count = count;
+
+	// the depth limit keeps the traversal stacks bounded
+	if(count <= 1 || depth >= maxDepth){
+		return;
+	}
+
+	// choose the axis and bin boundary with the lowest surface area
+	// heuristic cost evaluating numBins - 1 planes per axis
+	auto numBins = min(max(settings.numBins, size_t(2)), maxBins);
+	auto extent = centroidBounds.max - centroidBounds.min;
+	float bestCost = numeric_limits<float>::max();
+	int bestAxis = -1;
+	size_t bestSplit = 0;
+	Bounds bins[maxBins];
+	size_t binCounts[maxBins];
+	float rightCost[maxBins];
+	for(int axis = 0; axis < 3; axis++){
+		if(extent[axis] <= 0.f){
+			continue;
+		}
+		fill(bins, bins + numBins, Bounds());
+		fill(binCounts, binCounts + numBins, 0);
+		float scale = numBins / extent[axis];
+		for(size_t i = first; i < first + count; i++){
+			auto f = faceOrder[i];
+			auto bin = min(size_t((context.centroids[f][axis] - centroidBounds.min[axis]) * scale), numBins - 1);
+			bins[bin].grow(context.faceBounds[f]);
+			binCounts[bin]++;
+		}
+
+		Bounds right;
+		size_t rightCount = 0;
+		for(size_t b = numBins - 1; b > 0; b--){
+			right.grow(bins[b]);
+			rightCount += binCounts[b];
+			rightCost[b] = right.area() * rightCount;
+		}
+		Bounds left;
+		size_t leftCount = 0;
+		for(size_t b = 1; b < numBins; b++){
+			left.grow(bins[b - 1]);
+			leftCount += binCounts[b - 1];
+			float cost = left.area() * leftCount + rightCost[b];
+			if(leftCount > 0 && leftCount < count && cost < bestCost){
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = b;
+			}
+		}
+	}
+
+	// cost of a leaf against traversing one more node, both relative to the
+	// cost of intersecting one triangle
+	float leafCost = float(count);
+	float area = bounds.area();
+	float splitCost = area > 0.f ? 1.f + bestCost / area : numeric_limits<float>::max();
+	if(count <= settings.maxLeafTriangles && (bestAxis < 0 || splitCost >= leafCost)){
+		return;
+	}
+
+	size_t mid;
+	if(bestAxis >= 0){
+		float scale = numBins / extent[bestAxis];
+		auto it = partition(faceOrder.begin() + first, faceOrder.begin() + first + count, [&](size_t f){
+			auto bin = min(size_t((context.centroids[f][bestAxis] - centroidBounds.min[bestAxis]) * scale), numBins - 1);
+			return bin < bestSplit;
+		});
+		mid = it - faceOrder.begin();
+	}else{
+		// all the centroids are in the same place, split in half so
+		// leaves don't end up with too many triangles
+		mid = first + count / 2;
+	}
+
+	size_t left = context.nextNode.fetch_add(2);
+	nodes[nodeIndex].first = left;
+	nodes[nodeIndex].count = 0;
+
+	size_t leftCount = mid - first;
+	size_t rightCount = count - leftCount;
+	if(depth < context.parallelDepth && count > 4096){
+		thread leftThread([&]{
+			buildNode(context, left, first, leftCount, depth + 1);
+		});
+		buildNode(context, left + 1, mid, rightCount, depth + 1);
+		leftThread.join();
+	}else{
+		buildNode(context, left, first, leftCount, depth + 1);
+		buildNode(context, left + 1, mid, rightCount, depth + 1);
+	}
+}
+
+//----------------------------------------
+bool ofMeshBVH::refit(const ofMesh & mesh){
+	if(!isBuilt()){
+		ofLogError("ofMeshBVH") << "refit(): the hierarchy hasn't been built yet";
+		return false;
+	}
+	if(mesh.getNumVertices() != positions.size()){
+		ofLogError("ofMeshBVH") << "refit(): the mesh has " << mesh.getNumVertices()
+			<< " vertices but the hierarchy was built with " << positions.size() << ", call build() instead";
+		return false;
+	}
+	for(size_t i = 0; i < positions.size(); i++){
+		positions[i] = toGlm(mesh.getVertices()[i]);
+	}
+
+	// children are always allocated after their parent so going backwards
+	// updates every child before its parent
+	for(size_t i = nodes.size(); i > 0; i--){
+		computeBounds(nodes[i - 1]);
+	}
+	return true;
+}
+
+//----------------------------------------
+void ofMeshBVH::computeBounds(Node & node) const{
+	Bounds bounds;
+	if(node.count > 0){
+		for(size_t i = node.first; i < node.first + node.count; i++){
+			auto f = faceOrder[i];
+			bounds.grow(getVertex(f, 0));
+			bounds.grow(getVertex(f, 1));
+			bounds.grow(getVertex(f, 2));
+		}
+	}else{
+		const auto & left = nodes[node.first];
+		const auto & right = nodes[node.first + 1];
+		bounds.min = glm::min(left.min, right.min);
+		bounds.max = glm::max(left.max, right.max);
+	}
+	node.min = bounds.min;
+	node.max = bounds.max;
+}
+
+//----------------------------------------
+void ofMeshBVH::clear(){
+	nodes.clear();
+	positions.clear();
+	faceVertices.clear();
+	faceOrder.clear();
+}
+
+//----------------------------------------
+bool ofMeshBVH::isBuilt() const{
+	return !nodes.empty();
+}
+
+//----------------------------------------
+glm::vec3 ofMeshBVH::getVertex(size_t face, size_t corner) const{
+	return positions[faceVertices[face * 3 + corner]];
+}
+
+//----------------------------------------
+ofMeshBVH::Hit ofMeshBVH::intersect(const glm::vec3 & origin, const glm::vec3 & direction, float maxDistance) const{
+	Hit result;
+	if(!isBuilt()){
+		return result;
+	}
+
+	glm::vec3 invDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+	result.distance = maxDistance;
+
+	size_t stack[maxStackSize];
+	size_t stackSize = 0;
+	if(intersectBox(origin, invDirection, nodes[0].min, nodes[0].max, result.distance) >= 0.f){
+		stack[stackSize++] = 0;
+	}
+	while(stackSize > 0){
+		const auto & node = nodes[stack[--stackSize]];
+		if(node.count > 0){
+			for(size_t i = node.first; i < node.first + node.count; i++){
+				auto f = faceOrder[i];
+				float t, u, v;
+				if(intersectTriangle(origin, direction, getVertex(f, 0), getVertex(f, 1), getVertex(f, 2), t, u, v) && t < result.distance){
+					result.hit = true;
+					result.distance = t;
+					result.faceIndex = f;
+					result.barycentric = {1.f - u - v, u, v};
+				}
+			}
+		}else{
+			// visit the closest child first so the furthest one can be
+			// discarded against a closer hit
+			float tl = intersectBox(origin, invDirection, nodes[node.first].min, nodes[node.first].max, result.distance);
+			float tr = intersectBox(origin, invDirection, nodes[node.first + 1].min, nodes[node.first + 1].max, result.distance);
+			if(tl >= 0.f && tr >= 0.f){
+				if(tl < tr){
+					stack[stackSize++] = node.first + 1;
+					stack[stackSize++] = node.first;
+				}else{
+					stack[stackSize++] = node.first;
+					stack[stackSize++] = node.first + 1;
+				}
+			}else if(tl >= 0.f){
+				stack[stackSize++] = node.first;
+			}else if(tr >= 0.f){
+				stack[stackSize++] = node.first + 1;
+			}
+		}
+	}
+
+	if(result.hit){
+		result.position = origin + direction * result.distance;
+	}
+	return result;
+}
+
+//----------------------------------------
+ofMeshBVH::Hit ofMeshBVH::pick(const ofCamera & camera, const glm::vec2 & screenPosition, const glm::mat4 & modelMatrix) const{
+	auto nearPoint = camera.screenToWorld(glm::vec3(screenPosition, -1.f));
+	auto farPoint = camera.screenToWorld(glm::vec3(screenPosition, 1.f));
+	auto invModel = glm::inverse(modelMatrix);
+	auto origin = glm::vec3(invModel * glm::vec4(nearPoint, 1.f));
+	auto end = glm::vec3(invModel * glm::vec4(farPoint, 1.f));
+	auto direction = end - origin;
+	auto length = glm::length(direction);
+	if(length <= 0.f){
+		return Hit();
+	}
+	auto hit = intersect(origin, direction / length, length);
+	return hit;
+}
+
+//----------------------------------------
+ofMeshBVH::Hit ofMeshBVH::getClosestPoint(const glm::vec3 & p, float maxDistance) const{
+	Hit result;
+	if(!isBuilt()){
+		return result;
+	}
+
+	float bestDistance2 = maxDistance < sqrt(numeric_limits<float>::max()) ? maxDistance * maxDistance : numeric_limits<float>::max();
+	size_t stack[maxStackSize];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0){
+		const auto & node = nodes[stack[--stackSize]];
+		if(distanceSquaredToBox(p, node.min, node.max) > bestDistance2){
+			continue;
+		}
+		if(node.count > 0){
+			for(size_t i = node.first; i < node.first + node.count; i++){
+				auto f = faceOrder[i];
+				glm::vec3 barycentric;
+				auto closest = closestPointOnTriangle(p, getVertex(f, 0), getVertex(f, 1), getVertex(f, 2), barycentric);
+				auto d = closest - p;
+				float d2 = glm::dot(d, d);
+				if(d2 <= bestDistance2){
+					bestDistance2 = d2;
+					result.hit = true;
+					result.faceIndex = f;
+					result.position = closest;
+					result.barycentric = barycentric;
+				}
+			}
+		}else{
+			float dl = distanceSquaredToBox(p, nodes[node.first].min, nodes[node.first].max);
+			float dr = distanceSquaredToBox(p, nodes[node.first + 1].min, nodes[node.first + 1].max);
+			if(dl < dr){
+				stack[stackSize++] = node.first + 1;
+				stack[stackSize++] = node.first;
+			}else{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+			}
+		}
+	}
+
+	if(result.hit){
+		result.distance = sqrt(bestDistance2);
+	}
+	return result;
+}
+
+//----------------------------------------
+void ofMeshBVH::getFacesInFrustum(const glm::mat4 & mvp, vector<size_t> & faces) const{
+	if(!isBuilt()){
+		return;
+	}
+
+	// Gribb, Hartmann "Fast Extraction of Viewing Frustum Planes from the
+	// World-View-Projection Matrix", glm matrices are column major
+	glm::vec4 planes[6];
+	for(int i = 0; i < 3; i++){
+		glm::vec4 row(mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i]);
+		glm::vec4 w(mvp[0][3], mvp[1][3], mvp[2][3], mvp[3][3]);
+		planes[i * 2] = w + row;
+		planes[i * 2 + 1] = w - row;
+	}
+
+	struct Entry{
+		size_t node;
+		bool inside;
+	};
+	Entry stack[maxStackSize];
+	size_t stackSize = 0;
+	stack[stackSize++] = {0, false};
+	while(stackSize > 0){
+		auto entry = stack[--stackSize];
+		const auto & node = nodes[entry.node];
+		bool inside = entry.inside;
+		if(!inside){
+			bool outside = false;
+			inside = true;
+			for(const auto & plane: planes){
+				glm::vec3 normal(plane);
+				// corners of the box furthest along and against the plane normal
+				glm::vec3 positive(normal.x >= 0 ? node.max.x : node.min.x,
+								   normal.y >= 0 ? node.max.y : node.min.y,
+								   normal.z >= 0 ? node.max.z : node.min.z);
+				glm::vec3 negative(normal.x >= 0 ? node.min.x : node.max.x,
+								   normal.y >= 0 ? node.min.y : node.max.y,
+								   normal.z >= 0 ? node.min.z : node.max.z);
+				if(glm::dot(normal, positive) + plane.w < 0.f){
+					outside = true;
+					break;
+				}
+				if(glm::dot(normal, negative) + plane.w < 0.f){
+					inside = false;
+				}
+			}
+			if(outside){
+				continue;
+			}
+		}
+
+		if(node.count > 0){
+			for(size_t i = node.first; i < node.first + node.count; i++){
+				faces.push_back(faceOrder[i]);
+			}
+		}else{
+			stack[stackSize++] = {node.first + 1, inside};
+			stack[stackSize++] = {node.first, inside};
+		}
+	}
+}
+
+//----------------------------------------
+size_t ofMeshBVH::getNumFaces() const{
+	return faceOrder.size();
+}
+
+//----------------------------------------
+size_t ofMeshBVH::getNumNodes() const{
+	return nodes.size();
+}
+
+//----------------------------------------
+pair<glm::vec3, glm::vec3> ofMeshBVH::getBounds() const{
+	if(!isBuilt()){
+		return make_pair(glm::vec3(0.f), glm::vec3(0.f));
+	}
+	return make_pair(nodes[0].min, nodes[0].max);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofMesh.h"
+
+class ofCamera;
+
+/// \brief A bounding volume hierarchy over the triangles of an ofMesh.
+///
+/// Allows to cast rays against a mesh, find the closest point on its
+/// surface or find which faces are inside a view frustum without having to
+/// test every triangle. The hierarchy is built using the surface area
+/// heuristic with binning and big meshes are built in parallel.
+///
+/// Face indices returned by the queries are the index of the triangle in the
+/// mesh, the same index as in ofMesh::getUniqueFaces() for
+/// OF_PRIMITIVE_TRIANGLES meshes. Triangle strips and fans are converted to
+/// triangles in the order they are drawn.
+///
+/// ~~~~{.cpp}
+/// // setup
+/// mesh = ofMesh::icosphere(200, 4);
+/// bvh.build(mesh);
+///
+/// // mouseMoved
+/// auto hit = bvh.pick(cam, glm::vec2(x, y));
+/// if(hit){
+/// 	selectedFace = hit.faceIndex;
+/// }
+/// ~~~~
+///
+/// If only the positions of the vertices change, refit() updates the bounds
+/// of the hierarchy without rebuilding it, which is much faster but makes the
+/// queries slower if the mesh deforms a lot.
+class ofMeshBVH{
+public:
+	struct Settings{
+		/// \brief Nodes with this number of triangles or less become leaves
+		/// when splitting them isn't cheaper.
+		std::size_t maxLeafTriangles = 4;
+
+		/// \brief Number of bins per axis used to evaluate the SAH, up to 64.
+		std::size_t numBins = 16;
+
+		/// \brief Threads used to build the tree, 0 uses as many as cores.
+		std::size_t numThreads = 0;
+	};
+
+	/// \brief Result of a ray or closest point query.
+	struct Hit{
+		/// \brief Index of the face hit or closest to the query point.
+		std::size_t faceIndex = 0;
+
+		/// \brief Distance from the ray origin or the query point.
+		float distance = std::numeric_limits<float>::max();
+
+		/// \brief Position of the hit in mesh coordinates.
+		glm::vec3 position{0.f, 0.f, 0.f};
+
+		/// \brief Barycentric coordinates of the hit relative to the 3
+		/// vertices of the face, they can be used to interpolate normals,
+		/// colors or texture coordinates.
+		glm::vec3 barycentric{0.f, 0.f, 0.f};
+
+		bool hit = false;
+
+		explicit operator bool() const{
+			return hit;
+		}
+	};
+
+	ofMeshBVH();
+	ofMeshBVH(const ofMesh & mesh);
+	ofMeshBVH(const ofMesh & mesh, const Settings & settings);
+
+	/// \brief Builds the hierarchy for the triangles in mesh.
+	///
+	/// Only OF_PRIMITIVE_TRIANGLES, OF_PRIMITIVE_TRIANGLE_STRIP and
+	/// OF_PRIMITIVE_TRIANGLE_FAN meshes are supported.
+	bool build(const ofMesh & mesh);
+	bool build(const ofMesh & mesh, const Settings & settings);
+
+	/// \brief Updates the bounds of the hierarchy with the current vertex
+	/// positions of mesh, which has to be the mesh used to build it or one
+	/// with the same indices and number of vertices.
+	bool refit(const ofMesh & mesh);
+
+	void clear();
+	bool isBuilt() const;
+
+	/// \brief Finds the closest triangle hit by a ray.
+	/// \param origin the origin of the ray
+	/// \param direction direction of the ray, doesn't need to be normalized
+	/// but the distance of the hit is in units of its length
+	/// \param maxDistance hits further than this are ignored
+	Hit intersect(const glm::vec3 & origin, const glm::vec3 & direction, float maxDistance = std::numeric_limits<float>::max()) const;
+
+	/// \brief Casts a ray from the camera through screenPosition, usually
+	/// the mouse position, against the mesh transformed by modelMatrix.
+	///
+	/// The position of the hit is returned in mesh coordinates.
+	Hit pick(const ofCamera & camera, const glm::vec2 & screenPosition, const glm::mat4 & modelMatrix = glm::mat4(1.f)) const;
+
+	/// \brief Finds the closest point on the surface of the mesh to p.
+	/// \param maxDistance points further than this are ignored, a small
+	/// value makes the search faster.
+	Hit getClosestPoint(const glm::vec3 & p, float maxDistance = std::numeric_limits<float>::max()) const;
+
+	/// \brief Collects the faces whose bounds are at least partially inside
+	/// the frustum defined by modelViewProjection.
+	///
+	/// Whole subtrees are accepted or rejected at once so some faces close to
+	/// the border of the frustum might be returned even if they aren't
+	/// visible. Faces are appended to faces in hierarchy order which keeps
+	/// faces close in space next to each other.
+	void getFacesInFrustum(const glm::mat4 & modelViewProjection, std::vector<std::size_t> & faces) const;
+
+	/// \returns the number of triangles in the hierarchy.
+	std::size_t getNumFaces() const;
+
+	/// \returns the number of nodes in the hierarchy.
+	std::size_t getNumNodes() const;
+
+	/// \returns the bounds of the whole mesh as min, max corners.
+	std::pair<glm::vec3, glm::vec3> getBounds() const;
+
+private:
+	struct Node{
+		glm::vec3 min;
+		glm::vec3 max;
+		// for leaves the range of triangles in faceOrder, for interior
+		// nodes count is 0 and first is the index of the left child, the
+		// right child is always allocated right after it
+		std::size_t first;
+		std::size_t count;
+	};
+
+	struct BuildContext;
+	void buildNode(BuildContext & context, std::size_t nodeIndex, std::size_t first, std::size_t count, std::size_t depth);
+	void computeBounds(Node & node) const;
+
+	glm::vec3 getVertex(std::size_t face, std::size_t corner) const;
+
+	Settings settings;
+	std::vector<Node> nodes;
+	std::vector<glm::vec3> positions;
+	// 3 vertex indices per face
+	std::vector<ofIndexType> faceVertices;
+	// faces sorted so each leaf references a contiguous range
+	std::vector<std::size_t> faceOrder;
+};
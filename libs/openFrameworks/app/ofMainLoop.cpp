@@ -10,6 +10,8 @@
 #include "ofConstants.h"
 #include "ofAppBaseWindow.h"
 #include "ofBaseApp.h"
+#include "ofProfiler.h"
+#include "ofParameter.h"
 
 //========================================================================
 // default windowing
@@ -35,12 +37,14 @@ ofMainLoop::ofMainLoop()
 :bShouldClose(false)
 ,status(0)
 ,allowMultiWindow(true)
-,escapeQuits(true){
-
+,escapeQuits(true)
+,eventQueue("main"){
+	ofParameterGroup::setAsyncEventQueue(&eventQueue);
 }
 
 ofMainLoop::~ofMainLoop() {
 	exit();
+	ofParameterGroup::setAsyncEventQueue(nullptr);
 }
 
 shared_ptr<ofAppBaseWindow> ofMainLoop::createWindow(const ofWindowSettings & settings){
@@ -68,6 +72,7 @@ shared_ptr<ofAppBaseWindow> ofMainLoop::createWindow(const ofWindowSettings & se
 
 void ofMainLoop::run(shared_ptr<ofAppBaseWindow> window, shared_ptr<ofBaseApp> && app){
 	windowsApps[window] = app;
+	ofAddListener(window->events().update,this,&ofMainLoop::processEventQueue,OF_EVENT_ORDER_BEFORE_APP);
 	if(app){
 		ofAddListener(window->events().setup,app.get(),&ofBaseApp::setup,OF_EVENT_ORDER_APP);
 		ofAddListener(window->events().update,app.get(),&ofBaseApp::update,OF_EVENT_ORDER_APP);
@@ -133,6 +138,10 @@ int ofMainLoop::loop(){
 
 void ofMainLoop::loopOnce(){
 	if(bShouldClose) return;
+	if(ofProfiler::isEnabled()){
+		ofProfiler::newFrame();
+	}
+	OF_PROFILE_SCOPE("loopOnce");
 	for(auto i = windowsApps.begin(); !windowsApps.empty() && i != windowsApps.end();){
 		if(i->first->getWindowShouldClose()){
 			auto window = i->first;
@@ -141,8 +150,14 @@ void ofMainLoop::loopOnce(){
 		}else{
 			currentWindow = i->first;
 			i->first->makeCurrent();
-			i->first->update();
-			i->first->draw();
+			{
+				OF_PROFILE_SCOPE("update");
+				i->first->update();
+			}
+			{
+				OF_PROFILE_SCOPE("draw");
+				i->first->draw();
+			}
 			i++; ///< continue to next window
 		}
 	}
@@ -150,6 +165,7 @@ void ofMainLoop::loopOnce(){
 }
 
 void ofMainLoop::pollEvents(){
+	OF_PROFILE_SCOPE("pollEvents");
 	if(windowPollEvents){
 		windowPollEvents();
 	}
@@ -157,6 +173,7 @@ void ofMainLoop::pollEvents(){
 
 void ofMainLoop::exit(){
 	exitEvent.notify(this);
+	ofProfiler::stopTrace();
 
 	for(auto i: windowsApps){
 		shared_ptr<ofAppBaseWindow> window = i.first;
@@ -165,6 +182,7 @@ void ofMainLoop::exit(){
 		if(window == nullptr) {
 			continue;
 		}
+		ofRemoveListener(window->events().update,this,&ofMainLoop::processEventQueue,OF_EVENT_ORDER_BEFORE_APP);
 		if(app == nullptr) {
 			continue;
 		}
@@ -256,6 +274,14 @@ void ofMainLoop::setEscapeQuitsLoop(bool quits){
 	escapeQuits = quits;
 }
 
+ofEventQueue & ofMainLoop::getEventQueue(){
+	return eventQueue;
+}
+
+void ofMainLoop::processEventQueue(ofEventArgs &){
+	eventQueue.process();
+}
+
 void ofMainLoop::keyPressed(ofKeyEventArgs & key){
 	if (key.key == OF_KEY_ESC && escapeQuits == true){				// "escape"
 		shouldClose(0);
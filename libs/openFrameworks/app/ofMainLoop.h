@@ -2,6 +2,7 @@
 
 #include "ofConstants.h"
 #include "ofEvents.h"
+#include "ofEventQueue.h"
 #include <map>
 
 class ofBaseApp;
@@ -44,10 +45,17 @@ public:
 	std::shared_ptr<ofBaseApp> getCurrentApp();
 	void setEscapeQuitsLoop(bool quits);
 
+	/// \brief Queue processed in the main thread before every update.
+	///
+	/// Listeners added to this queue are called in the main thread no matter
+	/// which thread notifies the event, see ofEventQueue.
+	ofEventQueue & getEventQueue();
+
 	ofEvent<void> exitEvent;
 	ofEvent<void> loopEvent;
 private:
 	void keyPressed(ofKeyEventArgs & key);
+	void processEventQueue(ofEventArgs &);
 	std::map<std::shared_ptr<ofAppBaseWindow>,std::shared_ptr<ofBaseApp> > windowsApps;
 	bool bShouldClose;
 	std::weak_ptr<ofAppBaseWindow> currentWindow;
@@ -56,4 +64,5 @@ private:
 	std::function<void()> windowLoop;
 	std::function<void()> windowPollEvents;
 	bool escapeQuits;
+	ofEventQueue eventQueue;
 };
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <functional>
+#include <algorithm>
 #include <mutex>
 #include <thread>
 #include <memory>
@@ -21,6 +22,7 @@ namespace priv{
 	class NoopMutex{
 	public:
 		void lock(){}
+		bool try_lock(){ return true; }
 		void unlock(){}
 	};
 
@@ -150,7 +152,7 @@ namespace priv{
 
 		BaseEvent(const BaseEvent & mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = mom.self->functions;
+			self->set(mom.self->getFunctions());
 		}
 
 		BaseEvent & operator=(const BaseEvent & mom){
@@ -159,15 +161,16 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->set(mom.self->getFunctions());
 			self->enabled = mom.self->enabled;
 			return *this;
 		}
 
 		BaseEvent(BaseEvent && mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = std::move(mom.self->functions);
+			self->set(mom.self->getFunctions());
 			self->enabled = std::move(mom.self->enabled);
+			mom.self->set({});
 		}
 
 		BaseEvent & operator=(BaseEvent && mom){
@@ -176,7 +179,7 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->set(mom.self->getFunctions());
 			self->enabled = mom.self->enabled;
 			return *this;
 		}
@@ -194,29 +197,116 @@ namespace priv{
 		}
 
 		std::size_t size() const {
-			return self->functions.size();
+			return self->size();
 		}
 
 	protected:
 
-		struct Data{
+		// The listeners are never modified in place: adding or removing one
+		// publishes a modified copy, so notify can iterate them without
+		// locking the event or copying them. A copy that gets replaced while
+		// some notify is still iterating it is kept until no notify is running.
+		class Data{
+		public:
+			typedef std::vector<std::shared_ptr<Function>> Functions;
+
+			Data(){}
+
+			~Data(){
+				delete functions.load();
+			}
+
 			Mutex mtx;
-			std::vector<std::shared_ptr<Function>> functions;
 			bool enabled = true;
 
+			std::size_t size() const{
+				return numFunctions;
+			}
+
+			// the current listeners, only safe with mtx locked or in a NotifyScope
+			const Functions & getFunctions() const{
+				return *functions.load();
+			}
+
+			// replaces the listeners with a modified copy, must be called with mtx locked
+			template<typename Modify>
+			void update(Modify && modify){
+				std::unique_ptr<Functions> next(new Functions(*functions.load()));
+				modify(*next);
+				numFunctions = next->size();
+				retired.emplace_back(functions.exchange(next.release()));
+				hasRetired = true;
+				reclaim();
+			}
+
+			void set(const Functions & next){
+				update([&](Functions & functions){
+					functions = next;
+				});
+			}
+
 			void remove(const BaseFunctionId & id){
 				std::unique_lock<Mutex> lck(mtx);
-				auto it = functions.begin();
-				for(; it!=functions.end(); ++it){
-					auto f = *it;
-					if(*f->id == id){
-						f->disable();
-						functions.erase(it);
-						break;
+				auto & current = getFunctions();
+				auto it = std::find_if(current.begin(), current.end(), [&](const std::shared_ptr<Function> & f){
+					return *f->id == id;
+				});
+				if(it!=current.end()){
+					(*it)->disable();
+					auto index = it - current.begin();
+					update([&](Functions & functions){
+						functions.erase(functions.begin() + index);
+					});
+				}
+			}
+
+			// keeps the listeners a notify is iterating alive, and the event
+			// too in case a listener destroys it
+			class NotifyScope{
+			public:
+				NotifyScope(const std::shared_ptr<Data> & data)
+				:data(data){
+					this->data->notifying++;
+				}
+
+				~NotifyScope(){
+					if(--data->notifying == 0 && data->hasRetired){
+						// if a listener is being added or removed right now
+						// that thread or the next notify will free the copies
+						std::unique_lock<Mutex> lck(data->mtx, std::try_to_lock);
+						if(lck.owns_lock()){
+							data->reclaim();
+						}
 					}
 				}
+
+				const Functions & functions() const{
+					return *data->functions.load();
+				}
+
+			private:
+				std::shared_ptr<Data> data;
+			};
+
+		private:
+			Data(const Data &) = delete;
+			Data & operator=(const Data &) = delete;
+
+			// must be called with mtx locked
+			void reclaim(){
+				if(notifying == 0){
+					retired.clear();
+					hasRetired = false;
+				}
 			}
+
+			std::atomic<const Functions*> functions{new Functions};
+			std::atomic<std::size_t> numFunctions{0};
+			std::atomic<int> notifying{0};
+			std::atomic<bool> hasRetired{false};
+			std::vector<std::unique_ptr<const Functions>> retired;
 		};
+		typedef typename Data::NotifyScope NotifyScope;
 		std::shared_ptr<Data> self{new Data};
 
 		class EventToken: public AbstractEventToken{
@@ -248,21 +338,25 @@ namespace priv{
 		template<typename TFunction>
 		void addNoToken(TFunction && f){
 			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
-				if((*it)->priority>f->priority) break;
-			}
-			self->functions.emplace(it, f);
+			self->update([&](typename Data::Functions & functions){
+				auto it = functions.begin();
+				for(; it!=functions.end(); ++it){
+					if((*it)->priority>f->priority) break;
+				}
+				functions.emplace(it, f);
+			});
 		}
 
 		template<typename TFunction>
 		std::unique_ptr<EventToken> addFunction(TFunction && f){
 			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
-				if((*it)->priority>f->priority) break;
-			}
-			self->functions.emplace(it, f);
+			self->update([&](typename Data::Functions & functions){
+				auto it = functions.begin();
+				for(; it!=functions.end(); ++it){
+					if((*it)->priority>f->priority) break;
+				}
+				functions.emplace(it, f);
+			});
 			return make_token(*f);
 		}
 	};
@@ -556,25 +650,21 @@ public:
 	}
 
 	inline bool notify(const void* sender, T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-                if(f->notify(sender,param)){
+		if(ofEvent<T,Mutex>::self->enabled && ofEvent<T,Mutex>::self->size()){
+			typename ofEvent<T,Mutex>::NotifyScope scope(ofEvent<T,Mutex>::self);
+			for(auto & f: scope.functions()){
+				if(f->notify(sender,param)){
 					return true;
-                }
+				}
 			}
 		}
 		return false;
 	}
 
 	inline bool notify(T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
+		if(ofEvent<T,Mutex>::self->enabled && ofEvent<T,Mutex>::self->size()){
+			typename ofEvent<T,Mutex>::NotifyScope scope(ofEvent<T,Mutex>::self);
+			for(auto & f: scope.functions()){
 				if(f->notify(nullptr,param)){
 					return true;
 				}
@@ -714,11 +804,9 @@ public:
 	}
 
 	bool notify(const void* sender){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
+		if(ofEvent<void,Mutex>::self->enabled && ofEvent<void,Mutex>::self->size()){
+			typename ofEvent<void,Mutex>::NotifyScope scope(ofEvent<void,Mutex>::self);
+			for(auto & f: scope.functions()){
 				if(f->notify(sender)){
 					return true;
 				}
@@ -728,11 +816,9 @@ public:
 	}
 
 	bool notify(){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
+		if(ofEvent<void,Mutex>::self->enabled && ofEvent<void,Mutex>::self->size()){
+			typename ofEvent<void,Mutex>::NotifyScope scope(ofEvent<void,Mutex>::self);
+			for(auto & f: scope.functions()){
 				if(f->notify(nullptr)){
 					return true;
 				}
@@ -750,7 +836,7 @@ class ofFastEvent: public ofEvent<T,of::priv::NoopMutex>{
 public:
 	inline bool notify(const void* sender, T & param){
 		if(this->isEnabled()){
-			for(auto & f: ofFastEvent<T>::self->functions){
+			for(auto & f: ofFastEvent<T>::self->getFunctions()){
 				if(f->notify(sender, param)){
 					return true;
 				}
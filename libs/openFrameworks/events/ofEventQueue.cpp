@@ -0,0 +1,160 @@
+#include "ofEventQueue.h"
+#include "ofLog.h"
+#include <map>
+
+using namespace std;
+
+//--------------------------------------------------------------
+ofEventQueue::ofEventQueue(const string & name)
+:data(make_shared<Data>(name)){}
+
+//--------------------------------------------------------------
+ofEventQueue::~ofEventQueue(){}
+
+//--------------------------------------------------------------
+void ofEventQueue::post(function<void()> function){
+	data->push(std::move(function));
+}
+
+//--------------------------------------------------------------
+size_t ofEventQueue::process(){
+	return data->process();
+}
+
+//--------------------------------------------------------------
+bool ofEventQueue::wait(int64_t timeoutMs){
+	return data->wait(timeoutMs);
+}
+
+//--------------------------------------------------------------
+size_t ofEventQueue::size() const{
+	return data->count;
+}
+
+//--------------------------------------------------------------
+const string & ofEventQueue::getName() const{
+	return data->name;
+}
+
+//--------------------------------------------------------------
+ofEventQueue::Data::Data(const string & name)
+:name(name)
+,head(&stub)
+,tail(&stub){}
+
+//--------------------------------------------------------------
+ofEventQueue::Data::~Data(){
+	while(auto node = pop()){
+		delete node;
+	}
+}
+
+//--------------------------------------------------------------
+void ofEventQueue::Data::push(Node * node){
+	node->next.store(nullptr, memory_order_relaxed);
+	auto prev = head.exchange(node, memory_order_acq_rel);
+	prev->next.store(node, memory_order_release);
+}
+
+//--------------------------------------------------------------
+void ofEventQueue::Data::push(function<void()> && function){
+	auto node = new Node;
+	node->function = std::move(function);
+	// counted before it's in the queue so process() never sees more
+	// nodes than the count
+	count++;
+	push(node);
+	if(waiting > 0){
+		unique_lock<mutex> lck(waitMutex);
+		condition.notify_all();
+	}
+}
+
+//--------------------------------------------------------------
+// Returns null if the queue is empty or a producer is in the middle of
+// pushing the next node, in which case it'll be there in the next call
+ofEventQueue::Data::Node * ofEventQueue::Data::pop(){
+	auto first = tail;
+	auto next = first->next.load(memory_order_acquire);
+	if(first == &stub){
+		if(!next){
+			return nullptr;
+		}
+		tail = next;
+		first = next;
+		next = next->next.load(memory_order_acquire);
+	}
+	if(next){
+		tail = next;
+		return first;
+	}
+	if(first != head.load(memory_order_acquire)){
+		return nullptr;
+	}
+	push(&stub);
+	next = first->next.load(memory_order_acquire);
+	if(next){
+		tail = next;
+		return first;
+	}
+	return nullptr;
+}
+
+//--------------------------------------------------------------
+size_t ofEventQueue::Data::process(){
+	if(processing.exchange(true)){
+		ofLogError("ofEventQueue") << "process(): queue " << name << " is already being processed, "
+			"only one thread can process a queue and it can't be processed from one of its listeners";
+		return 0;
+	}
+	// only deliver what was pending when starting so listeners that
+	// notify queued events can't keep this loop running forever
+	size_t pending = count;
+	size_t processed = 0;
+	while(processed < pending){
+		auto node = pop();
+		if(!node){
+			break;
+		}
+		count--;
+		processed++;
+		try{
+			node->function();
+		}catch(...){
+			delete node;
+			processing = false;
+			throw;
+		}
+		delete node;
+	}
+	processing = false;
+	return processed;
+}
+
+//--------------------------------------------------------------
+bool ofEventQueue::Data::wait(int64_t timeoutMs){
+	if(count > 0){
+		return true;
+	}
+	waiting++;
+	unique_lock<mutex> lck(waitMutex);
+	if(timeoutMs < 0){
+		condition.wait(lck, [this]{ return count > 0; });
+	}else{
+		condition.wait_for(lck, chrono::milliseconds(timeoutMs), [this]{ return count > 0; });
+	}
+	waiting--;
+	return count > 0;
+}
+
+//--------------------------------------------------------------
+ofEventQueue & ofGetEventQueue(const string & name){
+	static mutex mtx;
+	static map<string, unique_ptr<ofEventQueue>> * queues = new map<string, unique_ptr<ofEventQueue>>;
+	unique_lock<mutex> lck(mtx);
+	auto & queue = (*queues)[name];
+	if(!queue){
+		queue = make_unique<ofEventQueue>(name);
+	}
+	return *queue;
+}
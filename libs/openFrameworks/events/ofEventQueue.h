@@ -0,0 +1,327 @@
+#pragma once
+
+#include "ofEvent.h"
+#include <condition_variable>
+#include <string>
+
+/// \brief How notifications are queued for a listener added to an ofEventQueue.
+enum ofEventQueueMode{
+	/// \brief Every notification is delivered, in the order they happened.
+	OF_EVENT_QUEUE_ALL,
+	/// \brief Only the latest value of the notifications that happened since
+	/// the queue was last processed is delivered. Useful for events that
+	/// fire at a high rate, like progress or position updates, where only
+	/// the last value matters.
+	OF_EVENT_QUEUE_LATEST
+};
+
+/// \brief Delivers event notifications on a specific thread.
+///
+/// ofEvent::notify() calls the listeners in the thread that notifies the
+/// event. Listeners added through an ofEventQueue are called instead in the
+/// thread that processes the queue, usually the main thread, when it
+/// calls process(). The notifying thread only copies the arguments and
+/// pushes them into the queue, which doesn't need any lock.
+///
+/// The main loop has a queue that is processed before every update:
+///
+/// ~~~~{.cpp}
+/// // ofApp.h
+/// ofEventListener progressListener;
+///
+/// // ofApp::setup(), loader.progress is notified from the loader thread
+/// progressListener = ofGetMainLoop()->getEventQueue().newListener(loader.progress, [this](float & progress){
+/// 	this->progress = progress;
+/// }, OF_EVENT_QUEUE_LATEST);
+/// ~~~~
+///
+/// A worker thread can process its own queue, or a named one from
+/// ofGetEventQueue(), in its loop:
+///
+/// ~~~~{.cpp}
+/// while(isThreadRunning()){
+/// 	queue.wait(100);
+/// 	queue.process();
+/// }
+/// ~~~~
+///
+/// Once a listener is unsubscribed it won't be called anymore even if it
+/// has notifications pending in the queue.
+class ofEventQueue{
+public:
+	/// \param name used to identify the queue in log messages.
+	ofEventQueue(const std::string & name = "");
+	~ofEventQueue();
+
+	ofEventQueue(const ofEventQueue &) = delete;
+	ofEventQueue & operator=(const ofEventQueue &) = delete;
+
+	/// \brief Calls a function in the thread that processes the queue.
+	void post(std::function<void()> function);
+
+	/// \brief Delivers the pending notifications in the calling thread.
+	///
+	/// Notifications that happen while processing, for example because a
+	/// listener notifies another queued event, are delivered on the next
+	/// call. Only one thread should process a queue.
+	///
+	/// \returns the number of notifications delivered.
+	std::size_t process();
+
+	/// \brief Blocks until there are notifications pending.
+	///
+	/// \param timeoutMs maximum time to wait in milliseconds, or -1 to
+	/// wait indefinitely.
+	/// \returns true if there are notifications pending.
+	bool wait(int64_t timeoutMs = -1);
+
+	/// \returns the number of notifications pending.
+	std::size_t size() const;
+
+	const std::string & getName() const;
+
+	/// \brief Adds a listener to an event that is called from this queue.
+	///
+	/// The arguments of the event are copied when it's notified so the
+	/// type has to be copyable. Since the listener is called later, it can't
+	/// stop the notification of other listeners and doesn't receive the
+	/// sender.
+	///
+	/// \param event event to listen to.
+	/// \param function function to call with the arguments of the event,
+	/// with no arguments for events of type void.
+	/// \param mode whether every notification is delivered or only the latest.
+	/// \param priority order of the listener in the event.
+	template<typename T, typename Mutex, typename TFunction>
+	std::unique_ptr<of::priv::AbstractEventToken> newListener(ofEvent<T,Mutex> & event, TFunction function, ofEventQueueMode mode = OF_EVENT_QUEUE_ALL, int priority = OF_EVENT_ORDER_AFTER_APP);
+
+	/// \brief Adds a method as a listener to an event that is called from
+	/// this queue, see the version taking a function.
+	template<typename T, typename Mutex, class TObj, typename TMethod>
+	std::unique_ptr<of::priv::AbstractEventToken> newListener(ofEvent<T,Mutex> & event, TObj * listener, TMethod method, ofEventQueueMode mode = OF_EVENT_QUEUE_ALL, int priority = OF_EVENT_ORDER_AFTER_APP);
+
+	/*! \cond PRIVATE */
+	// Lock free multiple producer, single consumer queue of functions.
+	// The listeners keep a weak reference to it so notifying an event
+	// after the queue is destroyed doesn't crash.
+	class Data{
+	public:
+		Data(const std::string & name);
+		~Data();
+		void push(std::function<void()> && function);
+		std::size_t process();
+		bool wait(int64_t timeoutMs);
+
+		std::string name;
+		std::atomic<std::size_t> count{0};
+
+	private:
+		struct Node{
+			std::atomic<Node*> next{nullptr};
+			std::function<void()> function;
+		};
+		void push(Node * node);
+		Node * pop();
+
+		std::atomic<Node*> head;
+		Node * tail;
+		Node stub;
+		std::atomic<bool> processing{false};
+		std::atomic<int> waiting{0};
+		std::mutex waitMutex;
+		std::condition_variable condition;
+	};
+	/*! \endcond */
+
+private:
+	std::shared_ptr<Data> data;
+};
+
+/// \brief Get a queue shared by name, it's created the first time it's
+/// requested and lives until the application ends.
+///
+/// Useful for worker threads that other parts of the application need to
+/// send events to without having access to the thread object.
+ofEventQueue & ofGetEventQueue(const std::string & name);
+
+/*! \cond PRIVATE */
+namespace of{
+namespace priv{
+	// Shared between the token and the queued notifications, once the token
+	// is destroyed pending notifications are discarded. The lock makes
+	// unsubscribing wait for a listener that is being called.
+	class QueuedListenerState{
+	public:
+		template<typename F>
+		void call(F && f){
+			std::unique_lock<std::recursive_mutex> lck(mtx);
+			if(active){
+				f();
+			}
+		}
+
+		void disable(){
+			std::unique_lock<std::recursive_mutex> lck(mtx);
+			active = false;
+		}
+
+	private:
+		std::recursive_mutex mtx;
+		bool active = true;
+	};
+
+	class QueuedEventToken: public AbstractEventToken{
+	public:
+		QueuedEventToken(std::unique_ptr<AbstractEventToken> && token, std::shared_ptr<QueuedListenerState> state)
+		:token(std::move(token))
+		,state(state){}
+
+		~QueuedEventToken(){
+			token.reset();
+			state->disable();
+		}
+
+	private:
+		std::unique_ptr<AbstractEventToken> token;
+		std::shared_ptr<QueuedListenerState> state;
+	};
+
+	template<typename T>
+	class QueuedListener: public QueuedListenerState{
+	public:
+		typedef typename std::remove_const<T>::type Value;
+
+		QueuedListener(std::function<void(Value&)> function, ofEventQueueMode mode, std::weak_ptr<ofEventQueue::Data> queue)
+		:function(function)
+		,mode(mode)
+		,queue(queue){}
+
+		template<typename Mutex>
+		static std::unique_ptr<AbstractEventToken> listen(ofEvent<T,Mutex> & event, std::function<void(Value&)> function, ofEventQueueMode mode, int priority, std::weak_ptr<ofEventQueue::Data> queue){
+			auto listener = std::make_shared<QueuedListener<T>>(function, mode, queue);
+			std::weak_ptr<QueuedListener<T>> weakListener = listener;
+			auto token = event.newListener(std::function<void(T&)>([weakListener](T & value){
+				auto listener = weakListener.lock();
+				if(listener){
+					listener->enqueue(listener, value);
+				}
+			}), priority);
+			return std::make_unique<QueuedEventToken>(std::move(token), listener);
+		}
+
+	private:
+		void enqueue(const std::shared_ptr<QueuedListener<T>> & self, const Value & value){
+			auto queue = this->queue.lock();
+			if(!queue){
+				return;
+			}
+			if(mode == OF_EVENT_QUEUE_LATEST){
+				std::unique_lock<std::mutex> lck(latestMutex);
+				if(latest){
+					// there's already a notification in the queue, it'll
+					// deliver this value instead
+					*latest = value;
+					return;
+				}
+				latest = std::make_unique<Value>(value);
+				lck.unlock();
+				queue->push([self]{
+					std::unique_lock<std::mutex> lck(self->latestMutex);
+					auto value = std::move(self->latest);
+					lck.unlock();
+					self->call([&]{
+						self->function(*value);
+					});
+				});
+			}else{
+				queue->push([self, value = Value(value)]() mutable{
+					self->call([&]{
+						self->function(value);
+					});
+				});
+			}
+		}
+
+		std::function<void(Value&)> function;
+		ofEventQueueMode mode;
+		std::weak_ptr<ofEventQueue::Data> queue;
+		std::mutex latestMutex;
+		std::unique_ptr<Value> latest;
+	};
+
+	template<>
+	class QueuedListener<void>: public QueuedListenerState{
+	public:
+		QueuedListener(std::function<void()> function, ofEventQueueMode mode, std::weak_ptr<ofEventQueue::Data> queue)
+		:function(function)
+		,mode(mode)
+		,queue(queue){}
+
+		template<typename Mutex>
+		static std::unique_ptr<AbstractEventToken> listen(ofEvent<void,Mutex> & event, std::function<void()> function, ofEventQueueMode mode, int priority, std::weak_ptr<ofEventQueue::Data> queue){
+			auto listener = std::make_shared<QueuedListener<void>>(function, mode, queue);
+			std::weak_ptr<QueuedListener<void>> weakListener = listener;
+			auto token = event.newListener(std::function<void()>([weakListener]{
+				auto listener = weakListener.lock();
+				if(listener){
+					listener->enqueue(listener);
+				}
+			}), priority);
+			return std::make_unique<QueuedEventToken>(std::move(token), listener);
+		}
+
+	private:
+		void enqueue(const std::shared_ptr<QueuedListener<void>> & self){
+			auto queue = this->queue.lock();
+			if(!queue){
+				return;
+			}
+			if(mode == OF_EVENT_QUEUE_LATEST && pending.exchange(true)){
+				return;
+			}
+			queue->push([self]{
+				self->pending = false;
+				self->call([&]{
+					self->function();
+				});
+			});
+		}
+
+		std::function<void()> function;
+		ofEventQueueMode mode;
+		std::weak_ptr<ofEventQueue::Data> queue;
+		std::atomic<bool> pending{false};
+	};
+
+	template<typename T>
+	struct QueuedMethod{
+		template<class TObj, typename TMethod>
+		static std::function<void(typename QueuedListener<T>::Value&)> bind(TObj * listener, TMethod method){
+			return [listener, method](typename QueuedListener<T>::Value & value){
+				(listener->*method)(value);
+			};
+		}
+	};
+
+	template<>
+	struct QueuedMethod<void>{
+		template<class TObj, typename TMethod>
+		static std::function<void()> bind(TObj * listener, TMethod method){
+			return [listener, method]{
+				(listener->*method)();
+			};
+		}
+	};
+}
+}
+/*! \endcond */
+
+template<typename T, typename Mutex, typename TFunction>
+std::unique_ptr<of::priv::AbstractEventToken> ofEventQueue::newListener(ofEvent<T,Mutex> & event, TFunction function, ofEventQueueMode mode, int priority){
+	return of::priv::QueuedListener<T>::listen(event, function, mode, priority, data);
+}
+
+template<typename T, typename Mutex, class TObj, typename TMethod>
+std::unique_ptr<of::priv::AbstractEventToken> ofEventQueue::newListener(ofEvent<T,Mutex> & event, TObj * listener, TMethod method, ofEventQueueMode mode, int priority){
+	return of::priv::QueuedListener<T>::listen(event, of::priv::QueuedMethod<T>::bind(listener, method), mode, priority, data);
+}
@@ -1,6 +1,7 @@
 #include "ofEvents.h"
 #include "ofAppRunner.h"
 #include "ofAppBaseWindow.h"
+#include "ofProfiler.h"
 #include "ofLog.h"
 
 using namespace std;
@@ -283,14 +284,20 @@ bool ofCoreEvents::notifySetup(){
 #include "ofGraphics.h"
 //------------------------------------------
 bool ofCoreEvents::notifyUpdate(){
+	OF_PROFILE_SCOPE("notify update");
 	return ofNotifyEvent( update, voidEventArgs );
 }
 
 //------------------------------------------
 bool ofCoreEvents::notifyDraw(){
-	auto attended = ofNotifyEvent( draw, voidEventArgs );
+	bool attended;
+	{
+		OF_PROFILE_SCOPE("notify draw");
+		attended = ofNotifyEvent( draw, voidEventArgs );
+	}
 
 	if (bFrameRateSet){
+		OF_PROFILE_SCOPE("wait frame rate");
 		timer.waitNext();
 	}
 	
@@ -323,6 +330,7 @@ bool ofCoreEvents::notifyKeyReleased(int key, int keycode, int scancode, uint32_
 
 //------------------------------------------
 bool ofCoreEvents::notifyKeyEvent(ofKeyEventArgs & e){
+	OF_PROFILE_SCOPE("notify key");
 	bool attended = false;
 	modifiers = e.modifiers;
 	switch(e.type){
@@ -474,6 +482,7 @@ void ofCoreEvents::notifyTouchEvent(ofTouchEventArgs & touchArgs){
 
 //------------------------------------------
 bool  ofCoreEvents::notifyMouseEvent(ofMouseEventArgs & e){
+	OF_PROFILE_SCOPE("notify mouse");
 	modifiers = e.modifiers;
 	switch(e.type){
 		case ofMouseEventArgs::Moved:
@@ -597,6 +606,7 @@ bool ofCoreEvents::notifyExit(){
 
 //------------------------------------------
 bool ofCoreEvents::notifyWindowResized(int width, int height){
+	OF_PROFILE_SCOPE("notify windowResized");
 	ofResizeEventArgs resizeEventArgs(width,height);
 	return ofNotifyEvent( windowResized, resizeEventArgs );
 }
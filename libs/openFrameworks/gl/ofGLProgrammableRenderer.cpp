@@ -12,6 +12,7 @@
 #include "ofMaterial.h"
 #include "ofCamera.h"
 #include "ofTrueTypeFont.h"
+#include "ofTextLayout.h"
 #include "ofNode.h"
 #include "ofVideoBaseTypes.h"
 
@@ -53,6 +54,7 @@ ofGLProgrammableRenderer::ofGLProgrammableRenderer(const ofAppBaseWindow * _wind
 	rectMesh.getVertices().resize(4);
 
 	bitmapStringEnabled = false;
+	distanceFieldStringMode = OF_TTF_RENDER_BITMAP;
     verticesEnabled = true;
     colorsEnabled = false;
     texCoordsEnabled = false;
@@ -1112,6 +1114,12 @@ void ofGLProgrammableRenderer::setAlphaBitmapText(bool bitmapText){
 	}
 }
 
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::setDistanceFieldText(ofTrueTypeFontRenderMode mode){
+	// the shader is selected when the font texture is bound
+	distanceFieldStringMode = mode;
+}
+
 ofStyle ofGLProgrammableRenderer::getStyle() const{
 	return currentStyle;
 }
@@ -1508,6 +1516,12 @@ void ofGLProgrammableRenderer::beginDefaultShader(){
         if(currentMaterial){
             nextShader = &currentMaterial->getShader(currentTextureTarget,colorsEnabled,*this);
 
+		}else if(distanceFieldStringMode == OF_TTF_RENDER_SDF){
+			nextShader = &distanceFieldStringShader;
+
+		}else if(distanceFieldStringMode == OF_TTF_RENDER_MSDF){
+			nextShader = &multiDistanceFieldStringShader;
+
 		}else if(bitmapStringEnabled){
 			nextShader = &bitmapStringShader;
 
@@ -1821,14 +1835,50 @@ void ofGLProgrammableRenderer::drawString(string textString, float x, float y, f
 
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::drawString(const ofTrueTypeFont & font, string text, float x, float y) const{
+	// strings drawn repeatedly are only laid out once
+	auto layout = font.getCachedLayout(text,isVFlipped());
+	if(layout){
+		drawString(*layout,x,y);
+		return;
+	}
+
+	// the meshes are generated before binding any texture since adding
+	// glyphs to a dynamic atlas uploads them to the page textures
+	drawFontMeshes(font,font.getStringMeshes(text,x,y,isVFlipped()));
+}
+
+//----------------------------------------------------------
+void ofGLProgrammableRenderer::drawString(const ofTextLayout & layout, float x, float y) const{
+	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
+	const auto & font = *layout.getFont();
+	const auto & meshes = layout.getMeshes();
+	mutThis->pushMatrix();
+	if(font.getRenderMode() == OF_TTF_RENDER_BITMAP){
+		// bitmap glyphs are snapped to pixels as drawString does
+		mutThis->translate(long(x),long(y));
+	}else{
+		mutThis->translate(x,y);
+	}
+	drawFontMeshes(font,meshes);
+	mutThis->popMatrix();
+}
+
+//----------------------------------------------------------
+template<class Mesh>
+void ofGLProgrammableRenderer::drawFontMeshes(const ofTrueTypeFont & font, const vector<Mesh> & meshes) const{
 	ofGLProgrammableRenderer * mutThis = const_cast<ofGLProgrammableRenderer*>(this);
 	ofBlendMode blendMode = currentStyle.blendingMode;
 
 	mutThis->setBlendMode(OF_BLENDMODE_ALPHA);
 
-	mutThis->bind(font.getFontTexture(),0);
-	draw(font.getStringMesh(text,x,y,isVFlipped()),OF_MESH_FILL);
-	mutThis->unbind(font.getFontTexture(),0);
+	mutThis->setDistanceFieldText(font.getRenderMode());
+	for(size_t page = 0; page < meshes.size(); page++){
+		if(meshes[page].getNumVertices() == 0) continue;
+		mutThis->bind(font.getFontTexture(page),0);
+		draw(meshes[page],OF_MESH_FILL);
+		mutThis->unbind(font.getFontTexture(page),0);
+	}
+	mutThis->setDistanceFieldText(OF_TTF_RENDER_BITMAP);
 
 	mutThis->setBlendMode(blendMode);
 }
@@ -2118,6 +2168,31 @@ static const string bitmapStringFragmentShader = fragment_shader_header + STRING
 	}
 );
 
+// ----------------------------------------------------------------------
+// distance field fonts, the distance is encoded as 0.5 at the outline and
+// the screen space derivatives give an antialiased edge at any scale
+
+static const string distanceFieldStringFragmentShader = STRINGIFY(
+
+	uniform sampler2D src_tex_unit0;
+	uniform vec4 globalColor;
+
+	IN vec2 texCoordVarying;
+
+	float median(float r, float g, float b){
+		return max(min(r, g), min(max(r, g), b));
+	}
+
+	void main()
+	{
+		vec4 tex = TEXTURE(src_tex_unit0, texCoordVarying);
+		float dist = DISTANCE(tex) - 0.5;
+		float alpha = clamp(dist / max(fwidth(dist), 0.0001) + 0.5, 0.0, 1.0);
+		if (alpha <= 0.0) discard;
+		FRAG_COLOR = vec4(globalColor.rgb, globalColor.a * alpha);
+	}
+);
+
 // ----------------------------------------------------------------------
 // changing shaders in raspberry pi is very expensive so we use only one shader there
 // in desktop openGL these are not used but we declare it to avoid more ifdefs
@@ -2304,6 +2379,21 @@ static string shaderSource(const string & src, int major, int minor){
 	return shaderSrc;
 }
 
+static string distanceFieldShaderSource(bool multiChannel, int major, int minor){
+	string src = fragment_shader_header;
+	if(multiChannel){
+		src += "#define DISTANCE(tex) median(tex.r, tex.g, tex.b)\n";
+	}else{
+		src += "#define DISTANCE(tex) tex.a\n";
+	}
+	src += distanceFieldStringFragmentShader;
+#ifdef TARGET_OPENGLES
+	// fwidth is an extension in GLES 2
+	ofStringReplace(src,"%extensions%","#extension GL_OES_standard_derivatives : enable");
+#endif
+	return shaderSource(src, major, minor);
+}
+
 #ifdef TARGET_ANDROID
 static string shaderOESSource(const string & src, int major, int minor){
 	string shaderSrc = src;
@@ -2430,6 +2520,11 @@ void ofGLProgrammableRenderer::setup(int _major, int _minor){
 		bitmapStringShader.setupShaderFromSource(GL_VERTEX_SHADER, shaderSource(bitmapStringVertexShader,major, minor));
 		bitmapStringShader.setupShaderFromSource(GL_FRAGMENT_SHADER, shaderSource(bitmapStringFragmentShader,major, minor));
 
+		distanceFieldStringShader.setupShaderFromSource(GL_VERTEX_SHADER, shaderSource(bitmapStringVertexShader,major, minor));
+		distanceFieldStringShader.setupShaderFromSource(GL_FRAGMENT_SHADER, distanceFieldShaderSource(false,major, minor));
+		multiDistanceFieldStringShader.setupShaderFromSource(GL_VERTEX_SHADER, shaderSource(bitmapStringVertexShader,major, minor));
+		multiDistanceFieldStringShader.setupShaderFromSource(GL_FRAGMENT_SHADER, distanceFieldShaderSource(true,major, minor));
+
 #ifndef TARGET_OPENGLES
 		defaultTexRectColor.bindDefaults();
 		defaultTexRectNoColor.bindDefaults();
@@ -2454,6 +2549,11 @@ void ofGLProgrammableRenderer::setup(int _major, int _minor){
 
 		bitmapStringShader.bindDefaults();
 		bitmapStringShader.linkProgram();
+
+		distanceFieldStringShader.bindDefaults();
+		distanceFieldStringShader.linkProgram();
+		multiDistanceFieldStringShader.bindDefaults();
+		multiDistanceFieldStringShader.linkProgram();
 		
 		
 #ifdef TARGET_ANDROID
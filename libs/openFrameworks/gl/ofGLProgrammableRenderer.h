@@ -13,6 +13,7 @@
 class ofShapeTessellation;
 class ofFbo;
 class ofVbo;
+enum ofTrueTypeFontRenderMode : uint32_t;
 static const int OF_NO_TEXTURE=-1;
 
 class ofGLProgrammableRenderer: public ofBaseGLRenderer{
@@ -165,6 +166,7 @@ public:
 	void drawEllipse(float x, float y, float z, float width, float height) const;
 	void drawString(std::string text, float x, float y, float z) const;
 	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const;
+	void drawString(const ofTextLayout & layout, float x, float y) const;
 
 
 	void enableTextureTarget(const ofTexture & tex, int textureLocation);
@@ -257,6 +259,9 @@ private:
 
 	void setAttributes(bool vertices, bool color, bool tex, bool normals);
 	void setAlphaBitmapText(bool bitmapText);
+	void setDistanceFieldText(ofTrueTypeFontRenderMode mode);
+	template<class Mesh>
+	void drawFontMeshes(const ofTrueTypeFont & font, const std::vector<Mesh> & meshes) const;
 
     
 	ofMatrixStack matrixStack;
@@ -268,6 +273,7 @@ private:
 
 	bool verticesEnabled, colorsEnabled, texCoordsEnabled, normalsEnabled, bitmapStringEnabled;
 	bool usingCustomShader, settingDefaultShader, usingVideoShader;
+	ofTrueTypeFontRenderMode distanceFieldStringMode;
 	int currentTextureTarget;
 
 	bool wrongUseLoggedOnce;
@@ -299,6 +305,8 @@ private:
 	ofShader alphaMask2DShader;
 	
 	ofShader bitmapStringShader;
+	ofShader distanceFieldStringShader;
+	ofShader multiDistanceFieldStringShader;
 	
 	ofShader shaderPlanarYUY2;
 	ofShader shaderNV12;
@@ -11,6 +11,7 @@
 #include "ofMaterial.h"
 #include "ofCamera.h"
 #include "ofTrueTypeFont.h"
+#include "ofTextLayout.h"
 #include "ofNode.h"
 #include "ofVideoBaseTypes.h"
 
@@ -1682,6 +1683,37 @@ void ofGLRenderer::drawString(string textString, float x, float y, float z) cons
 
 //----------------------------------------------------------
 void ofGLRenderer::drawString(const ofTrueTypeFont & font, string text, float x, float y) const{
+	// strings drawn repeatedly are only laid out once
+	auto layout = font.getCachedLayout(text,isVFlipped());
+	if(layout){
+		drawString(*layout,x,y);
+		return;
+	}
+
+	// the meshes are generated before binding any texture since adding
+	// glyphs to a dynamic atlas uploads them to the page textures
+	drawFontMeshes(font,font.getStringMeshes(text,x,y,isVFlipped()));
+}
+
+//----------------------------------------------------------
+void ofGLRenderer::drawString(const ofTextLayout & layout, float x, float y) const{
+	ofGLRenderer * mutThis = const_cast<ofGLRenderer*>(this);
+	const auto & font = *layout.getFont();
+	const auto & meshes = layout.getMeshes();
+	mutThis->pushMatrix();
+	if(font.getRenderMode() == OF_TTF_RENDER_BITMAP){
+		// bitmap glyphs are snapped to pixels as drawString does
+		mutThis->translate(long(x),long(y));
+	}else{
+		mutThis->translate(x,y);
+	}
+	drawFontMeshes(font,meshes);
+	mutThis->popMatrix();
+}
+
+//----------------------------------------------------------
+template<class Mesh>
+void ofGLRenderer::drawFontMeshes(const ofTrueTypeFont & font, const vector<Mesh> & meshes) const{
 	ofGLRenderer * mutThis = const_cast<ofGLRenderer*>(this);
 	bool blendEnabled = glIsEnabled(GL_BLEND);
 	GLint blend_src, blend_dst;
@@ -1691,9 +1723,38 @@ void ofGLRenderer::drawString(const ofTrueTypeFont & font, string text, float x,
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	mutThis->bind(font.getFontTexture(),0);
-	draw(font.getStringMesh(text,x,y,isVFlipped()),OF_MESH_FILL);
-	mutThis->unbind(font.getFontTexture(),0);
+#ifndef TARGET_OPENGLES
+	// without shaders distance fields are drawn by alpha testing the
+	// distance at the outline, the color comes only from the style since
+	// multichannel fields store the distances in the texture rgb
+	bool distanceField = font.getRenderMode() != OF_TTF_RENDER_BITMAP;
+	if(distanceField){
+		glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(GL_GEQUAL, 0.5f * currentStyle.color.a / 255.f);
+	}
+#endif
+	for(size_t page = 0; page < meshes.size(); page++){
+		if(meshes[page].getNumVertices() == 0) continue;
+		mutThis->bind(font.getFontTexture(page),0);
+#ifndef TARGET_OPENGLES
+		if(distanceField){
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SRC0_RGB, GL_PRIMARY_COLOR);
+			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SRC0_ALPHA, GL_TEXTURE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SRC1_ALPHA, GL_PRIMARY_COLOR);
+		}
+#endif
+		draw(meshes[page],OF_MESH_FILL);
+		mutThis->unbind(font.getFontTexture(page),0);
+	}
+#ifndef TARGET_OPENGLES
+	if(distanceField){
+		glPopAttrib();
+	}
+#endif
 
 	if(!blendEnabled){
 		glDisable(GL_BLEND);
@@ -160,6 +160,7 @@ public:
 	void drawEllipse(float x, float y, float z, float width, float height) const;
 	void drawString(std::string text, float x, float y, float z) const;
 	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const;
+	void drawString(const ofTextLayout & layout, float x, float y) const;
 
 
 	// gl specifics
@@ -221,6 +222,8 @@ public:
 private:
 	void startSmoothing();
 	void endSmoothing();
+	template<class Mesh>
+	void drawFontMeshes(const ofTrueTypeFont & font, const std::vector<Mesh> & meshes) const;
 
 
 	bool bBackgroundAuto;
@@ -2,6 +2,7 @@
 #include "glm/vec2.hpp"
 #include "glm/trigonometric.hpp"
 #include "ofRectangle.h"
+#include "ofTextLayout.h"
 
 void ofBaseDraws::draw(const glm::vec2 & point) const {
 	draw(point.x, point.y);
@@ -36,3 +37,12 @@ void ofBaseRenderer::rotateZDeg(float degrees){
 void ofBaseRenderer::rotateDeg(float degrees){
 	rotateRad(glm::radians(degrees));
 }
+
+void ofBaseRenderer::drawString(const ofTextLayout & layout, float x, float y) const{
+	if(!layout.isSetup()){
+		return;
+	}
+	for(auto & line: layout.getLines()){
+		drawString(*layout.getFont(), line.text, x + line.position.x, y + line.position.y);
+	}
+}
@@ -29,6 +29,7 @@ class ofMaterial;
 class ofBaseMaterial;
 class ofCamera;
 class ofTrueTypeFont;
+class ofTextLayout;
 class ofNode;
 class of3dGraphics;
 class ofVbo;
@@ -1029,6 +1030,16 @@ public:
 	/// \param x The x position for the bottom of \p text.
 	/// \param y The y position for the left alignment of \p text.
 	virtual void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const=0;
+	/// \brief Draw text laid out with an ofTextLayout.
+	///
+	/// By default draws each line of the layout with
+	/// drawString(const ofTrueTypeFont&, std::string, float, float),
+	/// renderers that can draw the meshes of the layout directly override it.
+	///
+	/// \param layout The layout to draw.
+	/// \param x The x position of the left of the layout.
+	/// \param y The y position of the baseline of the first line.
+	virtual void drawString(const ofTextLayout & layout, float x, float y) const;
 
 
 	// returns true an ofPath to draw with, this allows to keep
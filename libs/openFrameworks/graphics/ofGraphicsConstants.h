@@ -109,6 +109,40 @@ enum ofPolyWindingMode{
 	OF_POLY_WINDING_ABS_GEQ_TWO
 };
 
+/// \brief represents the boolean operations that can be performed between
+/// two sets of polygons.
+///
+/// \sa ofPolylinesClip()
+/// \sa ofPath::unionWith()
+enum ofPolyClipOperation{
+	/// \brief Area covered by any of the polygons.
+	OF_POLY_CLIP_UNION,
+	/// \brief Area covered by both the subject and the clip polygons.
+	OF_POLY_CLIP_INTERSECTION,
+	/// \brief Area of the subject not covered by the clip polygons.
+	OF_POLY_CLIP_DIFFERENCE,
+	/// \brief Area covered by the subject or the clip polygons but not both.
+	OF_POLY_CLIP_XOR
+};
+
+/// \brief represents the ways the corners of an offset polygon are joined.
+///
+/// Open polylines use the same style for their end caps, bevel gives butt
+/// caps and miter falls back to square caps.
+///
+/// \sa ofPolylinesOffset()
+enum ofPolyJoinType{
+	/// \brief Extends the edges until they meet, up to the miter limit after
+	/// which the corner is squared.
+	OF_POLY_JOIN_MITER,
+	/// \brief Cuts the corner at the offset distance from the original vertex.
+	OF_POLY_JOIN_SQUARE,
+	/// \brief Joins the edges with an arc centered on the original vertex.
+	OF_POLY_JOIN_ROUND,
+	/// \brief Joins the ends of the offset edges with a straight line.
+	OF_POLY_JOIN_BEVEL
+};
+
 /// \brief represents the available matrix coordinate system handednesses.
 ///
 /// \sa ofMatrixStack
@@ -1,4 +1,5 @@
 #include "ofPath.h"
+#include "ofPolygonClipping.h"
 
 using namespace std;
 
@@ -878,6 +879,57 @@ void ofPath::append(const ofPath & path){
 	flagShapeChanged();
 }
 
+//----------------------------------------------------------
+void ofPath::unionWith(const ofPath & path){
+	clip(path, OF_POLY_CLIP_UNION);
+}
+
+//----------------------------------------------------------
+void ofPath::intersect(const ofPath & path){
+	clip(path, OF_POLY_CLIP_INTERSECTION);
+}
+
+//----------------------------------------------------------
+void ofPath::difference(const ofPath & path){
+	clip(path, OF_POLY_CLIP_DIFFERENCE);
+}
+
+//----------------------------------------------------------
+void ofPath::xorWith(const ofPath & path){
+	clip(path, OF_POLY_CLIP_XOR);
+}
+
+//----------------------------------------------------------
+void ofPath::offset(float delta, ofPolyJoinType join, float miterLimit){
+	generatePolylinesFromCommands();
+	// the fill of a path always closes its sub paths
+	vector<ofPolyline> closed = polylines;
+	for(auto & polyline: closed){
+		polyline.setClosed(true);
+	}
+	setContours(ofPolylinesOffset(closed, delta, join, miterLimit, windingMode));
+}
+
+//----------------------------------------------------------
+void ofPath::clip(const ofPath & path, ofPolyClipOperation operation){
+	generatePolylinesFromCommands();
+	const_cast<ofPath&>(path).generatePolylinesFromCommands();
+	setContours(ofPolylinesClip(polylines, path.polylines, operation, windingMode, path.windingMode));
+}
+
+//----------------------------------------------------------
+void ofPath::setContours(const vector<ofPolyline> & contours){
+	clear();
+	for(auto & contour: contours){
+		moveTo(contour[0]);
+		for(size_t i = 1; i < contour.size(); i++){
+			lineTo(contour[i]);
+		}
+		close();
+	}
+	setPolyWindingMode(OF_POLY_WINDING_ODD);
+}
+
 void ofPath::addCommand(const ofPath::Command & command){
 	if((commands.empty() || commands.back().type==Command::close) && command.type!=Command::moveTo){
 		commands.push_back(Command(Command::moveTo,command.to));
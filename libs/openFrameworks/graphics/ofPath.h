@@ -342,6 +342,50 @@ public:
 
 	void append(const ofPath & path);
 
+	/// \}
+	/// \name Boolean operations
+	/// \{
+
+	/// \brief Replaces the path with the area covered by it or by path.
+	///
+	/// The area of each path is decided using its own winding mode. The
+	/// result is made of closed contours without curves that don't cross each
+	/// other, holes go in the opposite direction than the outer contours, and
+	/// the winding mode is set to OF_POLY_WINDING_ODD.
+	///
+	/// ~~~~{.cpp}
+	/// ofPath shape;
+	/// shape.rectangle(0, 0, 200, 200);
+	/// ofPath hole;
+	/// hole.circle(100, 100, 50);
+	/// shape.difference(hole);
+	/// ~~~~
+	///
+	/// \sa ofPolylinesClip()
+	void unionWith(const ofPath & path);
+
+	/// \brief Replaces the path with the area covered by both it and path.
+	/// \sa unionWith()
+	void intersect(const ofPath & path);
+
+	/// \brief Removes the area covered by path from this path.
+	/// \sa unionWith()
+	void difference(const ofPath & path);
+
+	/// \brief Replaces the path with the area covered by it or by path but
+	/// not by both.
+	/// \sa unionWith()
+	void xorWith(const ofPath & path);
+
+	/// \brief Grows the filled area of the path by delta, or shrinks it if
+	/// delta is negative.
+	///
+	/// All the sub paths are considered closed, the result replaces the path
+	/// the same way as with unionWith().
+	///
+	/// \sa ofPolylinesOffset()
+	void offset(float delta, ofPolyJoinType join = OF_POLY_JOIN_MITER, float miterLimit = 2.f);
+
 	/// \}
 	/// \name Path Mode
 	/// \{
@@ -399,6 +443,8 @@ private:
 	ofPolyline & lastPolyline();
 	void addCommand(const Command & command);
 	void generatePolylinesFromCommands();
+	void clip(const ofPath & path, ofPolyClipOperation operation);
+	void setContours(const std::vector<ofPolyline> & contours);
 
 	// only needs to be called when path is modified externally
 	void flagShapeChanged();
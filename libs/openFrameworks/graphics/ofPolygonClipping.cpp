@@ -0,0 +1,972 @@
+#include "ofPolygonClipping.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+
+// The clipper works on polygons snapped to an integer grid:
+//
+// - Intersections are rounded to the grid and every edge is split at the
+// vertices and intersections it passes through or very close to (snap
+// rounding) so no two edges intersect except at their end points.
+// - Overlapping edges are merged adding their winding contributions.
+// - A sweep from bottom to top over the scanbeams, the horizontal bands
+// between consecutive vertices, keeps the edges crossing the current
+// scanbeam sorted from left to right in a balanced tree. Sums of the windings
+// of its subtrees give the winding number of each polygon set on both sides
+// of every edge.
+// - Edges that have the result of the boolean operation inside on one side
+// and outside on the other are the result's contour, oriented so the
+// inside is on the left, and are linked back into closed contours.
+//
+// Coordinates are kept under 2^28 in absolute value so every orientation
+// test, even with doubled coordinates, fits in 64 bits.
+
+namespace{
+
+	struct IntPoint{
+		int64_t x;
+		int64_t y;
+	};
+
+	bool operator==(const IntPoint & p0, const IntPoint & p1){
+		return p0.x == p1.x && p0.y == p1.y;
+	}
+
+	bool operator!=(const IntPoint & p0, const IntPoint & p1){
+		return !(p0 == p1);
+	}
+
+	// bottom to top and then left to right
+	bool operator<(const IntPoint & p0, const IntPoint & p1){
+		return p0.y < p1.y || (p0.y == p1.y && p0.x < p1.x);
+	}
+
+	int64_t cross(int64_t x0, int64_t y0, int64_t x1, int64_t y1){
+		return x0 * y1 - y0 * x1;
+	}
+
+	// > 0 if p is to the left of the line going from p0 to p1
+	int64_t orientation(const IntPoint & p0, const IntPoint & p1, const IntPoint & p){
+		return cross(p1.x - p0.x, p1.y - p0.y, p.x - p0.x, p.y - p0.y);
+	}
+
+	int sign(int64_t v){
+		return (v > 0) - (v < 0);
+	}
+
+	// a is always below b, or to its left for horizontal edges. winding is
+	// the change in the winding number of each polygon set when crossing the
+	// edge from left to right and is 0 for horizontal edges. sideA and sideB
+	// are the winding numbers to the left and right of the edge, or above and
+	// below it if it's horizontal.
+	struct Edge{
+		IntPoint a;
+		IntPoint b;
+		int winding[2];
+		int sideA[2];
+		int sideB[2];
+	};
+
+	bool isHorizontal(const Edge & e){
+		return e.a.y == e.b.y;
+	}
+
+	void addEdge(vector<Edge> & edges, const IntPoint & from, const IntPoint & to, const int * winding){
+		if(from == to) return;
+		Edge e;
+		// going down crosses from left to right into the polygon for counter
+		// clockwise contours
+		int direction = from < to ? -1 : 1;
+		e.a = std::min(from, to);
+		e.b = std::max(from, to);
+		if(isHorizontal(e)) direction = 0;
+		e.winding[0] = winding[0] * direction;
+		e.winding[1] = winding[1] * direction;
+		edges.push_back(e);
+	}
+
+	class Grid{
+	public:
+		Grid(const vector<ofPolyline> & subject, const vector<ofPolyline> & clip){
+			glm::dvec2 min(std::numeric_limits<double>::max());
+			glm::dvec2 max(std::numeric_limits<double>::lowest());
+			for(auto polylines: {&subject, &clip}){
+				for(auto & polyline: *polylines){
+					for(auto & v: polyline){
+						min = glm::min(min, glm::dvec2(v.x, v.y));
+						max = glm::max(max, glm::dvec2(v.x, v.y));
+					}
+				}
+			}
+			if(min.x > max.x){
+				center = {0, 0};
+				scale = 1;
+			}else{
+				const double maxCoordinate = double(1 << 28) - 1;
+				center = (min + max) * 0.5;
+				double extent = std::max(max.x - center.x, max.y - center.y);
+				// power of 2 so converting back and forth is exact
+				int exponent = 0;
+				if(extent > 0){
+					exponent = int(std::floor(std::log2(maxCoordinate / extent)));
+					while(std::ldexp(extent, exponent) > maxCoordinate){
+						exponent--;
+					}
+				}
+				scale = std::ldexp(1.0, exponent);
+			}
+		}
+
+		IntPoint toGrid(const glm::vec3 & p) const{
+			return {int64_t(std::llround((p.x - center.x) * scale)), int64_t(std::llround((p.y - center.y) * scale))};
+		}
+
+		glm::vec3 fromGrid(const IntPoint & p) const{
+			return {float(p.x / scale + center.x), float(p.y / scale + center.y), 0.f};
+		}
+
+	private:
+		glm::dvec2 center;
+		double scale;
+	};
+
+	void addEdges(vector<Edge> & edges, const vector<ofPolyline> & polylines, const Grid & grid, size_t set){
+		int winding[2] = {0, 0};
+		winding[set] = 1;
+		for(auto & polyline: polylines){
+			if(polyline.size() < 2) continue;
+			auto first = grid.toGrid(polyline[0]);
+			auto prev = first;
+			for(size_t i = 1; i < polyline.size(); i++){
+				auto p = grid.toGrid(polyline[i]);
+				addEdge(edges, prev, p, winding);
+				prev = p;
+			}
+			addEdge(edges, prev, first, winding);
+		}
+	}
+
+	// uniform grid over the edges used to only test edges that are close
+	struct CellGrid{
+		IntPoint origin;
+		int64_t cellSize;
+		int64_t columns;
+		int64_t rows;
+
+		size_t getCell(const IntPoint & p) const{
+			return size_t((p.y - origin.y) / cellSize * columns + (p.x - origin.x) / cellSize);
+		}
+
+		size_t getNumCells() const{
+			return size_t(columns * rows);
+		}
+	};
+
+	CellGrid makeCellGrid(const vector<Edge> & edges){
+		IntPoint min = edges[0].a;
+		IntPoint max = edges[0].b;
+		double extentSum = 0;
+		for(auto & e: edges){
+			min.x = std::min(min.x, std::min(e.a.x, e.b.x));
+			max.x = std::max(max.x, std::max(e.a.x, e.b.x));
+			min.y = std::min(min.y, e.a.y);
+			max.y = std::max(max.y, e.b.y);
+			extentSum += std::max(std::abs(e.b.x - e.a.x), e.b.y - e.a.y);
+		}
+		double width = double(max.x - min.x) + 1;
+		double height = double(max.y - min.y) + 1;
+		// cells around the size of an edge but not many more than edges
+		double cellSize = std::max(extentSum / edges.size(), std::sqrt(width * height / (edges.size() * 2.0)));
+		CellGrid grid;
+		grid.origin = min;
+		grid.cellSize = std::max(int64_t(1), int64_t(std::ceil(cellSize)));
+		grid.columns = (max.x - min.x) / grid.cellSize + 1;
+		grid.rows = (max.y - min.y) / grid.cellSize + 1;
+		return grid;
+	}
+
+	// calls f with the index of every cell that e crosses or passes within
+	// one unit of
+	template<typename Function>
+	void forEachCell(const CellGrid & grid, const Edge & e, Function f){
+		auto row0 = (e.a.y - grid.origin.y) / grid.cellSize;
+		auto row1 = (e.b.y - grid.origin.y) / grid.cellSize;
+		auto minColumn = (std::min(e.a.x, e.b.x) - grid.origin.x) / grid.cellSize;
+		auto maxColumn = (std::max(e.a.x, e.b.x) - grid.origin.x) / grid.cellSize;
+		if(row0 == row1 || e.a.x == e.b.x){
+			for(auto row = row0; row <= row1; row++){
+				for(auto column = minColumn; column <= maxColumn; column++){
+					f(size_t(row * grid.columns + column));
+				}
+			}
+			return;
+		}
+		auto column = [&](double x){
+			auto c = int64_t(std::floor((x - grid.origin.x) / grid.cellSize));
+			return std::min(std::max(c, minColumn), maxColumn);
+		};
+		double slope = double(e.b.x - e.a.x) / double(e.b.y - e.a.y);
+		for(auto row = row0; row <= row1; row++){
+			double y0 = std::max(double(e.a.y), double(grid.origin.y + row * grid.cellSize) - 1);
+			double y1 = std::min(double(e.b.y), double(grid.origin.y + (row + 1) * grid.cellSize) + 1);
+			double x0 = e.a.x + (y0 - e.a.y) * slope;
+			double x1 = e.a.x + (y1 - e.a.y) * slope;
+			auto last = column(std::max(x0, x1) + 1);
+			for(auto c = column(std::min(x0, x1) - 1); c <= last; c++){
+				f(size_t(row * grid.columns + c));
+			}
+		}
+	}
+
+	// compressed lists of the items in each cell of a grid
+	struct CellBuckets{
+		vector<size_t> start;
+		vector<size_t> items;
+
+		template<typename ForEachCell>
+		void build(size_t numCells, size_t numItems, ForEachCell forEachCell){
+			start.assign(numCells + 1, 0);
+			for(size_t i = 0; i < numItems; i++){
+				forEachCell(i, [&](size_t cell){
+					start[cell + 1]++;
+				});
+			}
+			std::partial_sum(start.begin(), start.end(), start.begin());
+			items.resize(start.back());
+			auto end = start;
+			for(size_t i = 0; i < numItems; i++){
+				forEachCell(i, [&](size_t cell){
+					items[end[cell]++] = i;
+				});
+			}
+		}
+	};
+
+	// rounded intersection of e0 and e1 if they cross at a point that isn't
+	// an end point of any of them
+	bool findCrossing(const Edge & e0, const Edge & e1, IntPoint & p){
+		if(std::max(e0.a.x, e0.b.x) < std::min(e1.a.x, e1.b.x) ||
+		   std::max(e1.a.x, e1.b.x) < std::min(e0.a.x, e0.b.x) ||
+		   e0.b.y < e1.a.y || e1.b.y < e0.a.y){
+			return false;
+		}
+		if(sign(orientation(e0.a, e0.b, e1.a)) * sign(orientation(e0.a, e0.b, e1.b)) >= 0 ||
+		   sign(orientation(e1.a, e1.b, e0.a)) * sign(orientation(e1.a, e1.b, e0.b)) >= 0){
+			return false;
+		}
+		auto dx0 = e0.b.x - e0.a.x;
+		auto dy0 = e0.b.y - e0.a.y;
+		auto dx1 = e1.b.x - e1.a.x;
+		auto dy1 = e1.b.y - e1.a.y;
+		auto denominator = cross(dx0, dy0, dx1, dy1);
+		auto numerator = cross(e1.a.x - e0.a.x, e1.a.y - e0.a.y, dx1, dy1);
+		auto t = (long double)numerator / (long double)denominator;
+		p.x = e0.a.x + int64_t(std::llround(t * dx0));
+		p.y = e0.a.y + int64_t(std::llround(t * dy0));
+		return true;
+	}
+
+	// checks if e crosses or touches the unit square centered at p
+	bool crossesPixel(const Edge & e, const IntPoint & p){
+		if(p.x < std::min(e.a.x, e.b.x) || p.x > std::max(e.a.x, e.b.x) || p.y < e.a.y || p.y > e.b.y){
+			return false;
+		}
+		// the bounds overlap so it only needs to check that the corners of
+		// the pixel aren't all on the same side of the edge, in doubled
+		// coordinates so the corners are integers
+		IntPoint a{e.a.x * 2, e.a.y * 2};
+		IntPoint b{e.b.x * 2, e.b.y * 2};
+		int sides = 0;
+		for(auto corner: {IntPoint{p.x * 2 - 1, p.y * 2 - 1}, IntPoint{p.x * 2 + 1, p.y * 2 - 1},
+		                  IntPoint{p.x * 2 - 1, p.y * 2 + 1}, IntPoint{p.x * 2 + 1, p.y * 2 + 1}}){
+			auto o = orientation(a, b, corner);
+			if(o == 0) return true;
+			sides |= o > 0 ? 1 : 2;
+		}
+		return sides == 3;
+	}
+
+	void addSubEdge(vector<Edge> & edges, const Edge & parent, const IntPoint & from, const IntPoint & to){
+		if(from == to) return;
+		Edge e = parent;
+		e.a = std::min(from, to);
+		e.b = std::max(from, to);
+		if(isHorizontal(e)){
+			// snapping can make a piece of an almost horizontal edge
+			// horizontal, it doesn't cross any scanbeam anymore
+			e.winding[0] = e.winding[1] = 0;
+		}
+		edges.push_back(e);
+	}
+
+	// snap rounds the edges: the intersections are rounded to the grid and
+	// together with the vertices become hot pixels, every edge is then
+	// split at the center of each hot pixel it goes through. afterwards
+	// edges don't cross and can only touch at their end points or overlap
+	// completely
+	void splitEdges(vector<Edge> & edges){
+		if(edges.size() < 2){
+			return;
+		}
+
+		auto grid = makeCellGrid(edges);
+		CellBuckets edgeCells;
+		edgeCells.build(grid.getNumCells(), edges.size(), [&](size_t i, auto f){
+			forEachCell(grid, edges[i], f);
+		});
+
+		vector<IntPoint> hotPixels;
+		hotPixels.reserve(edges.size() * 2);
+		for(auto & e: edges){
+			hotPixels.push_back(e.a);
+			hotPixels.push_back(e.b);
+		}
+		// the edges of each cell are sorted by their left end so each one
+		// is only tested against the ones its x range overlaps
+		auto edgeMinX = [&](size_t i){
+			return std::min(edges[i].a.x, edges[i].b.x);
+		};
+		vector<size_t> cellEdges;
+		IntPoint p;
+		for(size_t cell = 0; cell < grid.getNumCells(); cell++){
+			cellEdges.assign(edgeCells.items.begin() + edgeCells.start[cell], edgeCells.items.begin() + edgeCells.start[cell + 1]);
+			std::sort(cellEdges.begin(), cellEdges.end(), [&](size_t i0, size_t i1){
+				return edgeMinX(i0) < edgeMinX(i1);
+			});
+			for(size_t i = 0; i < cellEdges.size(); i++){
+				auto & e0 = edges[cellEdges[i]];
+				auto maxX = std::max(e0.a.x, e0.b.x);
+				for(auto j = i + 1; j < cellEdges.size() && edgeMinX(cellEdges[j]) <= maxX; j++){
+					if(findCrossing(e0, edges[cellEdges[j]], p)){
+						hotPixels.push_back(p);
+					}
+				}
+			}
+		}
+		std::sort(hotPixels.begin(), hotPixels.end());
+		hotPixels.erase(std::unique(hotPixels.begin(), hotPixels.end()), hotPixels.end());
+
+		// the pixels of each cell are sorted by x so an edge only goes
+		// through the ones in its x range
+		CellBuckets pixelCells;
+		pixelCells.build(grid.getNumCells(), hotPixels.size(), [&](size_t i, auto f){
+			f(grid.getCell(hotPixels[i]));
+		});
+		auto pixelX = [&](size_t i){
+			return hotPixels[i].x;
+		};
+		for(size_t cell = 0; cell < grid.getNumCells(); cell++){
+			std::sort(pixelCells.items.begin() + pixelCells.start[cell], pixelCells.items.begin() + pixelCells.start[cell + 1], [&](size_t i0, size_t i1){
+				return pixelX(i0) < pixelX(i1);
+			});
+		}
+
+		vector<Edge> splitted;
+		splitted.reserve(edges.size() * 2);
+		vector<IntPoint> splits;
+		for(auto & e: edges){
+			splits.clear();
+			auto minX = std::min(e.a.x, e.b.x);
+			auto maxX = std::max(e.a.x, e.b.x);
+			forEachCell(grid, e, [&](size_t cell){
+				auto begin = pixelCells.items.begin() + pixelCells.start[cell];
+				auto end = pixelCells.items.begin() + pixelCells.start[cell + 1];
+				auto first = std::partition_point(begin, end, [&](size_t i){
+					return pixelX(i) < minX;
+				});
+				for(auto it = first; it != end && pixelX(*it) <= maxX; ++it){
+					auto & pixel = hotPixels[*it];
+					if(pixel != e.a && pixel != e.b && crossesPixel(e, pixel)){
+						splits.push_back(pixel);
+					}
+				}
+			});
+			if(splits.empty()){
+				splitted.push_back(e);
+				continue;
+			}
+			auto dx = e.b.x - e.a.x;
+			auto dy = e.b.y - e.a.y;
+			std::sort(splits.begin(), splits.end(), [&](const IntPoint & p0, const IntPoint & p1){
+				return (p0.x - e.a.x) * dx + (p0.y - e.a.y) * dy < (p1.x - e.a.x) * dx + (p1.y - e.a.y) * dy;
+			});
+			auto prev = e.a;
+			for(auto & split: splits){
+				addSubEdge(splitted, e, prev, split);
+				prev = split;
+			}
+			addSubEdge(splitted, e, prev, e.b);
+		}
+		edges.swap(splitted);
+	}
+
+	// edges with the same end points are merged into one with the sum of
+	// their windings, edges that cancel out are removed
+	void mergeEdges(vector<Edge> & edges){
+		std::sort(edges.begin(), edges.end(), [](const Edge & e0, const Edge & e1){
+			return e0.a < e1.a || (e0.a == e1.a && e0.b < e1.b);
+		});
+		size_t count = 0;
+		for(size_t i = 0; i < edges.size(); i++){
+			if(count > 0 && edges[count - 1].a == edges[i].a && edges[count - 1].b == edges[i].b){
+				edges[count - 1].winding[0] += edges[i].winding[0];
+				edges[count - 1].winding[1] += edges[i].winding[1];
+			}else{
+				edges[count++] = edges[i];
+			}
+		}
+		edges.resize(count);
+		edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge & e){
+			return !isHorizontal(e) && e.winding[0] == 0 && e.winding[1] == 0;
+		}), edges.end());
+	}
+
+	// e0 is to the left of e1 in a scanbeam crossed by both, they can only
+	// touch at their end points
+	bool isLeftOf(const Edge & e0, const Edge & e1){
+		if(e0.a.y <= e1.a.y){
+			auto o = orientation(e0.a, e0.b, e1.a);
+			if(o == 0) o = orientation(e0.a, e0.b, e1.b);
+			return o < 0;
+		}else{
+			auto o = orientation(e1.a, e1.b, e0.a);
+			if(o == 0) o = orientation(e1.a, e1.b, e0.b);
+			return o > 0;
+		}
+	}
+
+	// edges crossing the current scanbeam sorted from left to right. it's a
+	// treap where every node also keeps the sum of the windings of its
+	// subtree, so inserting, removing and finding the winding to the left
+	// of an edge or a point are all O(log n) however many edges are active
+	class ActiveEdges{
+	public:
+		ActiveEdges(const vector<Edge> & edges)
+		:edges(edges)
+		,nodes(edges.size()){}
+
+		// after the edges that are to its left or that it can't be
+		// ordered with
+		void insert(size_t i){
+			auto & node = nodes[i];
+			node.left = none;
+			node.right = none;
+			node.sum[0] = edges[i].winding[0];
+			node.sum[1] = edges[i].winding[1];
+			// xorshift, the priorities only need to look random
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			node.priority = seed;
+
+			size_t parent = none;
+			bool left = false;
+			for(auto n = root; n != none; n = left ? nodes[n].left : nodes[n].right){
+				parent = n;
+				left = isLeftOf(edges[i], edges[n]);
+			}
+			node.parent = parent;
+			if(parent == none){
+				root = i;
+				return;
+			}
+			(left ? nodes[parent].left : nodes[parent].right) = i;
+			addToAncestors(i, 1);
+			while(node.parent != none && nodes[node.parent].priority < node.priority){
+				rotateUp(i);
+			}
+		}
+
+		void remove(size_t i){
+			auto & node = nodes[i];
+			while(node.left != none || node.right != none){
+				if(node.right == none || (node.left != none && nodes[node.left].priority > nodes[node.right].priority)){
+					rotateUp(node.left);
+				}else{
+					rotateUp(node.right);
+				}
+			}
+			addToAncestors(i, -1);
+			replaceChild(node.parent, i, none);
+		}
+
+		// sum of the windings of the edges to the left of active edge i
+		void windingLeftOf(size_t i, int * winding) const{
+			winding[0] = sum(nodes[i].left, 0);
+			winding[1] = sum(nodes[i].left, 1);
+			for(auto n = i; nodes[n].parent != none; n = nodes[n].parent){
+				auto parent = nodes[n].parent;
+				if(nodes[parent].right == n){
+					winding[0] += sum(nodes[parent].left, 0) + edges[parent].winding[0];
+					winding[1] += sum(nodes[parent].left, 1) + edges[parent].winding[1];
+				}
+			}
+		}
+
+		// winding at a point on the lower or upper border of the scanbeam,
+		// in doubled coordinates so the middle of an edge is exact
+		void windingAt(const IntPoint & p2, int * winding) const{
+			winding[0] = 0;
+			winding[1] = 0;
+			auto n = root;
+			while(n != none){
+				auto & e = edges[n];
+				if(orientation({e.a.x * 2, e.a.y * 2}, {e.b.x * 2, e.b.y * 2}, p2) < 0){
+					winding[0] += sum(nodes[n].left, 0) + e.winding[0];
+					winding[1] += sum(nodes[n].left, 1) + e.winding[1];
+					n = nodes[n].right;
+				}else{
+					n = nodes[n].left;
+				}
+			}
+		}
+
+	private:
+		static const size_t none = std::numeric_limits<size_t>::max();
+
+		struct Node{
+			size_t left;
+			size_t right;
+			size_t parent;
+			uint32_t priority;
+			int sum[2];
+		};
+
+		int sum(size_t n, size_t set) const{
+			return n == none ? 0 : nodes[n].sum[set];
+		}
+
+		void updateSum(size_t n){
+			nodes[n].sum[0] = sum(nodes[n].left, 0) + sum(nodes[n].right, 0) + edges[n].winding[0];
+			nodes[n].sum[1] = sum(nodes[n].left, 1) + sum(nodes[n].right, 1) + edges[n].winding[1];
+		}
+
+		void addToAncestors(size_t i, int sign){
+			for(auto n = nodes[i].parent; n != none; n = nodes[n].parent){
+				nodes[n].sum[0] += edges[i].winding[0] * sign;
+				nodes[n].sum[1] += edges[i].winding[1] * sign;
+			}
+		}
+
+		void replaceChild(size_t parent, size_t child, size_t replacement){
+			if(parent == none){
+				root = replacement;
+			}else if(nodes[parent].left == child){
+				nodes[parent].left = replacement;
+			}else{
+				nodes[parent].right = replacement;
+			}
+			if(replacement != none){
+				nodes[replacement].parent = parent;
+			}
+		}
+
+		// swaps n with its parent keeping the order, the ancestors above
+		// keep the same edges so their sums don't change
+		void rotateUp(size_t n){
+			auto parent = nodes[n].parent;
+			replaceChild(nodes[parent].parent, parent, n);
+			if(nodes[parent].left == n){
+				nodes[parent].left = nodes[n].right;
+				if(nodes[n].right != none) nodes[nodes[n].right].parent = parent;
+				nodes[n].right = parent;
+			}else{
+				nodes[parent].right = nodes[n].left;
+				if(nodes[n].left != none) nodes[nodes[n].left].parent = parent;
+				nodes[n].left = parent;
+			}
+			nodes[parent].parent = n;
+			updateSum(parent);
+			updateSum(n);
+		}
+
+		const vector<Edge> & edges;
+		vector<Node> nodes;
+		size_t root = none;
+		uint32_t seed = 2463534242u;
+	};
+
+	void computeWindings(vector<Edge> & edges){
+		vector<size_t> sloped;
+		vector<size_t> horizontal;
+		vector<int64_t> ys;
+		ys.reserve(edges.size() * 2);
+		for(size_t i = 0; i < edges.size(); i++){
+			(isHorizontal(edges[i]) ? horizontal : sloped).push_back(i);
+			ys.push_back(edges[i].a.y);
+			ys.push_back(edges[i].b.y);
+		}
+		auto byBottom = [&](size_t i0, size_t i1){
+			return edges[i0].a.y < edges[i1].a.y;
+		};
+		auto slopedByTop = sloped;
+		std::sort(sloped.begin(), sloped.end(), byBottom);
+		std::sort(horizontal.begin(), horizontal.end(), byBottom);
+		std::sort(slopedByTop.begin(), slopedByTop.end(), [&](size_t i0, size_t i1){
+			return edges[i0].b.y < edges[i1].b.y;
+		});
+		std::sort(ys.begin(), ys.end());
+		ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+		ActiveEdges active(edges);
+		size_t nextSloped = 0;
+		size_t nextEnding = 0;
+		size_t nextHorizontal = 0;
+		for(auto y: ys){
+			// below the horizontal edges at this height is the previous scanbeam
+			auto firstHorizontal = nextHorizontal;
+			for(; nextHorizontal < horizontal.size() && edges[horizontal[nextHorizontal]].a.y == y; nextHorizontal++){
+				auto & e = edges[horizontal[nextHorizontal]];
+				active.windingAt({e.a.x + e.b.x, y * 2}, e.sideB);
+			}
+
+			// edges don't cross inside a scanbeam so the order of the edges
+			// that continue is still valid and new ones can be inserted
+			for(; nextEnding < slopedByTop.size() && edges[slopedByTop[nextEnding]].b.y == y; nextEnding++){
+				active.remove(slopedByTop[nextEnding]);
+			}
+			auto firstSloped = nextSloped;
+			for(; nextSloped < sloped.size() && edges[sloped[nextSloped]].a.y == y; nextSloped++){
+				active.insert(sloped[nextSloped]);
+			}
+			for(auto k = firstSloped; k < nextSloped; k++){
+				auto & e = edges[sloped[k]];
+				active.windingLeftOf(sloped[k], e.sideA);
+				e.sideB[0] = e.sideA[0] + e.winding[0];
+				e.sideB[1] = e.sideA[1] + e.winding[1];
+			}
+
+			for(auto h = firstHorizontal; h < nextHorizontal; h++){
+				auto & e = edges[horizontal[h]];
+				active.windingAt({e.a.x + e.b.x, y * 2}, e.sideA);
+			}
+		}
+	}
+
+	bool isFilled(int winding, ofPolyWindingMode mode){
+		switch(mode){
+		case OF_POLY_WINDING_ODD:
+			return (winding & 1) != 0;
+		case OF_POLY_WINDING_NONZERO:
+			return winding != 0;
+		case OF_POLY_WINDING_POSITIVE:
+			return winding > 0;
+		case OF_POLY_WINDING_NEGATIVE:
+			return winding < 0;
+		case OF_POLY_WINDING_ABS_GEQ_TWO:
+			return winding >= 2 || winding <= -2;
+		}
+		return false;
+	}
+
+	bool isInResult(const int * winding, ofPolyClipOperation operation, ofPolyWindingMode subjectWinding, ofPolyWindingMode clipWinding){
+		bool subject = isFilled(winding[0], subjectWinding);
+		bool clip = isFilled(winding[1], clipWinding);
+		switch(operation){
+		case OF_POLY_CLIP_UNION:
+			return subject || clip;
+		case OF_POLY_CLIP_INTERSECTION:
+			return subject && clip;
+		case OF_POLY_CLIP_DIFFERENCE:
+			return subject && !clip;
+		case OF_POLY_CLIP_XOR:
+			return subject != clip;
+		}
+		return false;
+	}
+
+	struct DirectedEdge{
+		IntPoint from;
+		IntPoint to;
+	};
+
+	// half turns are split so they can be compared with a single cross
+	// product, 0 for clockwise angles from reference in (0, 180] and 1 for
+	// (180, 360]
+	int clockwiseHalf(const IntPoint & reference, const IntPoint & v){
+		auto c = cross(reference.x, reference.y, v.x, v.y);
+		if(c != 0) return c < 0 ? 0 : 1;
+		return reference.x * v.x + reference.y * v.y < 0 ? 0 : 1;
+	}
+
+	bool isLessClockwise(const IntPoint & reference, const IntPoint & v0, const IntPoint & v1){
+		auto h0 = clockwiseHalf(reference, v0);
+		auto h1 = clockwiseHalf(reference, v1);
+		if(h0 != h1) return h0 < h1;
+		return cross(v0.x, v0.y, v1.x, v1.y) < 0;
+	}
+
+	void removeCollinear(vector<IntPoint> & contour){
+		size_t count = 0;
+		for(size_t i = 0; i < contour.size(); i++){
+			while(count >= 2 && orientation(contour[count - 2], contour[count - 1], contour[i]) == 0){
+				count--;
+			}
+			contour[count++] = contour[i];
+		}
+		contour.resize(count);
+		size_t first = 0;
+		while(contour.size() - first >= 3){
+			if(orientation(contour[contour.size() - 2], contour.back(), contour[first]) == 0){
+				contour.pop_back();
+			}else if(orientation(contour.back(), contour[first], contour[first + 1]) == 0){
+				first++;
+			}else{
+				break;
+			}
+		}
+		contour.erase(contour.begin(), contour.begin() + first);
+	}
+
+	// links the edges into closed contours, where contours touch at a
+	// vertex they are kept separated by always taking the sharpest turn to
+	// the right
+	vector<vector<IntPoint>> buildContours(vector<DirectedEdge> & edges){
+		std::sort(edges.begin(), edges.end(), [](const DirectedEdge & e0, const DirectedEdge & e1){
+			return e0.from < e1.from;
+		});
+		vector<bool> used(edges.size(), false);
+		vector<vector<IntPoint>> contours;
+		vector<IntPoint> contour;
+		for(size_t start = 0; start < edges.size(); start++){
+			if(used[start]) continue;
+			used[start] = true;
+			contour.clear();
+			contour.push_back(edges[start].from);
+			auto current = start;
+			while(true){
+				auto & e = edges[current];
+				IntPoint reference{e.from.x - e.to.x, e.from.y - e.to.y};
+				auto first = std::lower_bound(edges.begin(), edges.end(), e.to, [](const DirectedEdge & edge, const IntPoint & p){
+					return edge.from < p;
+				}) - edges.begin();
+				auto next = edges.size();
+				IntPoint nextDirection{0, 0};
+				for(auto i = size_t(first); i < edges.size() && edges[i].from == e.to; i++){
+					if(used[i] && i != start) continue;
+					IntPoint direction{edges[i].to.x - edges[i].from.x, edges[i].to.y - edges[i].from.y};
+					if(next == edges.size() || isLessClockwise(reference, direction, nextDirection)){
+						next = i;
+						nextDirection = direction;
+					}
+				}
+				if(next == start || next == edges.size()){
+					break;
+				}
+				used[next] = true;
+				contour.push_back(edges[next].from);
+				current = next;
+			}
+			removeCollinear(contour);
+			if(contour.size() >= 3){
+				contours.push_back(contour);
+			}
+		}
+		return contours;
+	}
+
+	vector<ofPolyline> clipPolylines(const vector<ofPolyline> & subject, const vector<ofPolyline> & clip, ofPolyClipOperation operation, ofPolyWindingMode subjectWinding, ofPolyWindingMode clipWinding){
+		Grid grid(subject, clip);
+		vector<Edge> edges;
+		addEdges(edges, subject, grid, 0);
+		addEdges(edges, clip, grid, 1);
+
+		splitEdges(edges);
+		mergeEdges(edges);
+		computeWindings(edges);
+
+		vector<DirectedEdge> contourEdges;
+		for(auto & e: edges){
+			bool insideA = isInResult(e.sideA, operation, subjectWinding, clipWinding);
+			bool insideB = isInResult(e.sideB, operation, subjectWinding, clipWinding);
+			if(insideA && !insideB){
+				contourEdges.push_back({e.a, e.b});
+			}else if(insideB && !insideA){
+				contourEdges.push_back({e.b, e.a});
+			}
+		}
+
+		vector<ofPolyline> result;
+		for(auto & contour: buildContours(contourEdges)){
+			result.emplace_back();
+			auto & polyline = result.back();
+			for(auto & p: contour){
+				polyline.addVertex(grid.fromGrid(p));
+			}
+			polyline.setClosed(true);
+		}
+		return result;
+	}
+
+	// appends the offset of the contour at vertex p between the edges with
+	// directions d0 and d1. the normals are to the right of each edge, the
+	// outside for counter clockwise contours
+	void addJoin(vector<glm::vec3> & out, const glm::dvec2 & p, const glm::dvec2 & d0, const glm::dvec2 & d1, double delta, ofPolyJoinType join, double miterLimit){
+		auto toVertex = [](const glm::dvec2 & v){
+			return glm::vec3(float(v.x), float(v.y), 0.f);
+		};
+		glm::dvec2 n0(d0.y, -d0.x);
+		glm::dvec2 n1(d1.y, -d1.x);
+		double sinA = n0.x * n1.y - n0.y * n1.x;
+		double cosA = glm::dot(n0, n1);
+		const double epsilon = 1e-9;
+		if(std::abs(sinA) < epsilon && cosA > 0){
+			out.push_back(toVertex(p + n0 * delta));
+			return;
+		}
+		if(sinA * delta < 0 && !(std::abs(sinA) < epsilon && cosA < 0)){
+			// concave corner, going through the original vertex makes the
+			// overlap a loop that gets removed when resolving the winding.
+			// almost flat corners, like in dense curves, don't need it and
+			// skipping it avoids lots of intersections
+			out.push_back(toVertex(p + n0 * delta));
+			if(cosA < 0.99){
+				out.push_back(toVertex(p));
+			}
+			out.push_back(toVertex(p + n1 * delta));
+			return;
+		}
+
+		// from here everything is in the side of the offset
+		double side = delta < 0 ? -1 : 1;
+		double distance = std::abs(delta);
+		auto e0 = n0 * side;
+		auto e1 = n1 * side;
+		auto bisector = e0 + e1;
+		if(glm::length(bisector) < epsilon){
+			bisector = d0;
+		}else{
+			bisector = glm::normalize(bisector);
+		}
+
+		if(join == OF_POLY_JOIN_MITER){
+			double r = 1 + glm::dot(e0, e1);
+			if(r >= 2 / (miterLimit * miterLimit)){
+				out.push_back(toVertex(p + (e0 + e1) * (distance / r)));
+				return;
+			}
+			join = OF_POLY_JOIN_SQUARE;
+		}
+
+		switch(join){
+		case OF_POLY_JOIN_SQUARE:{
+			double cos0 = glm::dot(d0, bisector);
+			double cos1 = glm::dot(d1, bisector);
+			if(cos0 > epsilon && cos1 < -epsilon){
+				double t0 = distance * (1 - glm::dot(e0, bisector)) / cos0;
+				double t1 = distance * (glm::dot(e1, bisector) - 1) / cos1;
+				out.push_back(toVertex(p + e0 * distance + d0 * t0));
+				out.push_back(toVertex(p + e1 * distance - d1 * t1));
+			}else{
+				out.push_back(toVertex(p + e0 * distance));
+				out.push_back(toVertex(p + e1 * distance));
+			}
+			break;
+		}
+		case OF_POLY_JOIN_ROUND:{
+			const double tolerance = 0.25;
+			double step = 2 * std::acos(glm::clamp(1 - tolerance / distance, -1., 1.));
+			step = std::max(step, 0.01);
+			double angle = std::acos(glm::clamp(glm::dot(e0, e1), -1., 1.));
+			if(e0.x * bisector.y - e0.y * bisector.x < 0){
+				angle = -angle;
+			}
+			double start = std::atan2(e0.y, e0.x);
+			int steps = std::max(1, int(std::ceil(std::abs(angle) / step)));
+			for(int i = 0; i <= steps; i++){
+				double a = start + angle * i / steps;
+				out.push_back(toVertex(p + glm::dvec2(std::cos(a), std::sin(a)) * distance));
+			}
+			break;
+		}
+		default:
+			out.push_back(toVertex(p + e0 * distance));
+			out.push_back(toVertex(p + e1 * distance));
+			break;
+		}
+	}
+
+	// offsets a closed contour, the points can't have consecutive duplicates
+	void offsetContour(const vector<glm::dvec2> & points, double delta, ofPolyJoinType join, double miterLimit, vector<ofPolyline> & out){
+		auto n = points.size();
+		if(n < 2) return;
+		vector<glm::dvec2> directions(n);
+		for(size_t i = 0; i < n; i++){
+			directions[i] = glm::normalize(points[(i + 1) % n] - points[i]);
+		}
+		out.emplace_back();
+		auto & vertices = out.back().getVertices();
+		for(size_t i = 0; i < n; i++){
+			addJoin(vertices, points[i], directions[(i + n - 1) % n], directions[i], delta, join, miterLimit);
+		}
+		out.back().setClosed(true);
+	}
+
+	vector<glm::dvec2> getContourPoints(const ofPolyline & polyline, bool closed){
+		vector<glm::dvec2> points;
+		points.reserve(polyline.size());
+		for(auto & v: polyline){
+			glm::dvec2 p(v.x, v.y);
+			if(points.empty() || points.back() != p){
+				points.push_back(p);
+			}
+		}
+		while(closed && points.size() > 1 && points.back() == points.front()){
+			points.pop_back();
+		}
+		return points;
+	}
+}
+
+//----------------------------------------------------------
+vector<ofPolyline> ofPolylinesClip(const vector<ofPolyline> & subject, const vector<ofPolyline> & clip, ofPolyClipOperation operation, ofPolyWindingMode subjectWinding, ofPolyWindingMode clipWinding){
+	return clipPolylines(subject, clip, operation, subjectWinding, clipWinding);
+}
+
+//----------------------------------------------------------
+vector<ofPolyline> ofPolylinesSimplify(const vector<ofPolyline> & polylines, ofPolyWindingMode windingMode){
+	return clipPolylines(polylines, {}, OF_POLY_CLIP_UNION, windingMode, windingMode);
+}
+
+//----------------------------------------------------------
+vector<ofPolyline> ofPolylinesOffset(const vector<ofPolyline> & polylines, float delta, ofPolyJoinType join, float miterLimit, ofPolyWindingMode windingMode){
+	vector<ofPolyline> closed;
+	vector<const ofPolyline*> open;
+	for(auto & polyline: polylines){
+		if(polyline.isClosed()){
+			closed.push_back(polyline);
+		}else{
+			open.push_back(&polyline);
+		}
+	}
+	miterLimit = std::max(miterLimit, 1.f);
+
+	// resolving the closed polylines first leaves outer contours counter
+	// clockwise and holes clockwise so the outside is always to the right
+	vector<ofPolyline> raw;
+	if(!closed.empty()){
+		for(auto & contour: ofPolylinesSimplify(closed, windingMode)){
+			offsetContour(getContourPoints(contour, true), delta, join, miterLimit, raw);
+		}
+	}
+
+	// open polylines are stroked by offsetting them as a contour that goes
+	// forward and back, the turns at both ends become the caps
+	for(auto polyline: open){
+		auto points = getContourPoints(*polyline, false);
+		if(points.size() < 2) continue;
+		for(size_t i = points.size() - 2; i > 0; i--){
+			points.push_back(points[i]);
+		}
+		offsetContour(points, std::abs(delta), join, miterLimit, raw);
+	}
+
+	return clipPolylines(raw, {}, OF_POLY_CLIP_UNION, OF_POLY_WINDING_POSITIVE, OF_POLY_WINDING_POSITIVE);
+}
+
+//----------------------------------------------------------
+vector<ofPolyline> ofPolylineOffset(const ofPolyline & polyline, float delta, ofPolyJoinType join, float miterLimit){
+	return ofPolylinesOffset({polyline}, delta, join, miterLimit);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofGraphicsConstants.h"
+#include "ofPolyline.h"
+
+/// \file
+/// Boolean operations and offsetting of polygons.
+///
+/// Polygons are described by closed ofPolyline instances in the xy plane,
+/// the z coordinate is ignored. Internally the coordinates are snapped to an
+/// integer grid fitted to the bounds of the input, so intersections are
+/// found and classified exactly and the results don't depend on floating
+/// point tolerances. The grid has around 2^28 steps across the input so
+/// the snapping is well below what's noticeable on screen.
+///
+/// The result is a set of closed, non self-intersecting contours: outer
+/// contours go counter-clockwise, the direction that gives a positive
+/// ofPolyline::getArea() (clockwise on screen where y grows downwards) and
+/// holes go in the opposite direction. They can be drawn with any of the
+/// OF_POLY_WINDING_ODD or OF_POLY_WINDING_NONZERO winding modes.
+///
+/// ~~~~{.cpp}
+/// auto a = ofPolyline::fromRectangle(ofRectangle(0, 0, 200, 200));
+/// auto b = ofPolyline::fromRectangle(ofRectangle(100, 100, 200, 200));
+/// auto shape = ofPolylinesClip({a}, {b}, OF_POLY_CLIP_DIFFERENCE);
+/// auto outline = ofPolylinesOffset(shape, 10, OF_POLY_JOIN_ROUND);
+/// ~~~~
+
+/// \brief Computes a boolean operation between two sets of polygons.
+///
+/// Each set is first resolved using its winding mode, the same way it would
+/// be filled by ofPath or ofTessellator, open polylines are considered closed.
+/// Contours that go counter-clockwise, with a positive area, have a winding
+/// number of +1 in their interior.
+///
+/// \param subject the polygons to clip
+/// \param clip the polygons to clip the subject with
+/// \param operation the boolean operation to perform
+/// \param subjectWinding winding mode used to decide the area of subject
+/// \param clipWinding winding mode used to decide the area of clip
+/// \returns the resulting contours
+std::vector<ofPolyline> ofPolylinesClip(const std::vector<ofPolyline> & subject, const std::vector<ofPolyline> & clip, ofPolyClipOperation operation, ofPolyWindingMode subjectWinding = OF_POLY_WINDING_NONZERO, ofPolyWindingMode clipWinding = OF_POLY_WINDING_NONZERO);
+
+/// \brief Resolves self intersections and overlaps in a set of polygons.
+///
+/// \returns the contours of the area filled by polylines with windingMode.
+std::vector<ofPolyline> ofPolylinesSimplify(const std::vector<ofPolyline> & polylines, ofPolyWindingMode windingMode = OF_POLY_WINDING_NONZERO);
+
+/// \brief Grows or shrinks a set of polygons by delta.
+///
+/// Closed polylines are treated as the area they enclose using windingMode
+/// and are grown for positive deltas and shrunk for negative ones. Open
+/// polylines are stroked with a width of 2 * abs(delta). The result is
+/// the union of all of them.
+///
+/// \param polylines the polygons to offset
+/// \param delta the distance to move the outline
+/// \param join how to join the edges at convex corners
+/// \param miterLimit maximum distance, in multiples of delta, of a miter
+/// join from the original corner before it is squared
+/// \param windingMode winding mode used to decide the area of polylines
+/// \returns the offset contours
+std::vector<ofPolyline> ofPolylinesOffset(const std::vector<ofPolyline> & polylines, float delta, ofPolyJoinType join = OF_POLY_JOIN_MITER, float miterLimit = 2.f, ofPolyWindingMode windingMode = OF_POLY_WINDING_NONZERO);
+
+/// \brief Grows or shrinks a single polygon by delta or strokes it if it's
+/// open, shrinking a polygon can split it into several ones.
+///
+/// \sa ofPolylinesOffset()
+std::vector<ofPolyline> ofPolylineOffset(const ofPolyline & polyline, float delta, ofPolyJoinType join = OF_POLY_JOIN_MITER, float miterLimit = 2.f);
@@ -326,6 +326,12 @@ public:
 	/// box window (1) or something in between (for example, .5).
 	ofPolyline_ getSmoothed(int smoothingSize, float smoothingShape = 0) const;
 
+	/// \brief Same as getSmoothed() but stores the smoothed line in result,
+	/// reusing its memory, which avoids allocations when called every frame.
+	///
+	/// result can't be this same polyline.
+	void getSmoothed(int smoothingSize, float smoothingShape, ofPolyline_ & result) const;
+
 	/// \brief Resamples the line based on the spacing passed in. The larger the
 	/// spacing, the more points will be eliminated.
 	///
@@ -337,12 +343,24 @@ public:
 	/// ![polyline resample](graphics/resample.jpg)
 	ofPolyline_ getResampledBySpacing(float spacing) const;
 
+	/// \brief Same as getResampledBySpacing() but stores the resampled line
+	/// in result, reusing its memory.
+	///
+	/// result can't be this same polyline.
+	void getResampledBySpacing(float spacing, ofPolyline_ & result) const;
+
 	/// \brief Resamples the line based on the count passed in. The lower the
 	/// count passed in, the more points will be eliminated.
 	///
 	/// This doesn't add new points to the line.
 	ofPolyline_ getResampledByCount(int count) const;
 
+	/// \brief Same as getResampledByCount() but stores the resampled line in
+	/// result, reusing its memory.
+	///
+	/// result can't be this same polyline.
+	void getResampledByCount(int count, ofPolyline_ & result) const;
+
 	/// \brief Simplifies the polyline, removing un-necessary vertices.
 	///
 	/// \param tolerance determines how dis-similar points need to be to stay in the line.
@@ -371,6 +389,27 @@ public:
 	/// scaling by 0,0 zeros out all data.
 	void scale(float x, float y);
 
+	/// \brief Transforms all the vertices by the matrix m.
+	///
+	/// Applying one matrix that combines several transformations is much
+	/// faster than calling translate(), rotateDeg() and scale() one after
+	/// another on big lines.
+	///
+	/// ~~~~{.cpp}
+	/// glm::mat4 m = glm::translate(glm::vec3(200, 200, 0));
+	/// m = glm::rotate(m, ofDegToRad(45), glm::vec3(0, 0, 1));
+	/// m = glm::scale(m, glm::vec3(2));
+	/// line.transform(m);
+	/// ~~~~
+	void transform(const glm::mat4 & m);
+
+	/// \brief Stores in result this line transformed by the matrix m,
+	/// reusing the memory of result.
+	///
+	/// Useful to draw an animated copy of a line every frame without
+	/// allocating. result can be this same polyline.
+	void getTransformed(const glm::mat4 & m, ofPolyline_ & result) const;
+
 	/// \}
 	/// \name Polyline State
 	/// \{
@@ -423,6 +462,34 @@ public:
 	/// index of the closest vertex
 	T getClosestPoint(const T& target, unsigned int* nearestIndex = nullptr) const;
 
+	/// \brief Gets the closest point on the line for each of numTargets
+	/// targets and stores them in closest, which has to have space for
+	/// numTargets points. Optionally stores the index of the closest vertex
+	/// to each of them in nearestIndices.
+	void getClosestPoints(const T* targets, std::size_t numTargets, T* closest, unsigned int* nearestIndices = nullptr) const;
+
+	/// \brief Gets the closest point on the line for each of the targets.
+	std::vector<T> getClosestPoints(const std::vector<T>& targets) const;
+
+	/// \brief Tests whether each of the points is within the closed ofPolyline.
+	std::vector<bool> inside(const std::vector<T>& points) const;
+
+	/// \brief Gets the points where the segment from p0 to p1 crosses the
+	/// line, in the xy plane.
+	///
+	/// The z of the intersections is interpolated along the polyline.
+	std::vector<T> getIntersections(const T& p0, const T& p1) const;
+
+	/// \brief Enables a bounding box hierarchy over the segments of the line
+	/// that makes getClosestPoint(), inside() and getIntersections()
+	/// logarithmic instead of linear in the number of vertices.
+	///
+	/// The index is built the first time it's needed after the line changes,
+	/// so it's only worth it for big lines that are queried many times
+	/// between modifications.
+	void setUseSpatialIndex(bool useSpatialIndex);
+	bool isUsingSpatialIndex() const;
+
 
 	/// \}
 	/// \name Other Functions
@@ -548,6 +615,31 @@ private:
 	void getInterpolationParams(float findex, int &i1, int &i2, float &t) const;
 
 	void calcData(int index, T &tangent, float &angle, T &rotation, T &normal) const;
+
+	// spatial index over the segments, segment i goes from points[i] to
+	// points[i+1 % size()], the closing segment is always included since
+	// inside() treats the line as closed
+	struct SegmentNode{
+		T min;
+		T max;
+		// leaves have right == 0 and cover count segments from first,
+		// internal nodes have the left child right after them
+		std::size_t first;
+		std::size_t count;
+		std::size_t right;
+	};
+	// nodes split their segments in half so the tree is never deeper than
+	// the bits of a size_t, a depth first traversal keeps one node per
+	// level plus the root in its stack
+	static const std::size_t segmentStackSize = sizeof(std::size_t) * 8 + 1;
+	mutable std::vector<SegmentNode> segmentIndex;
+	mutable bool bSegmentIndexDirty;
+	bool bUseSpatialIndex;
+
+	void updateSegmentIndex() const;
+	std::size_t buildSegmentNode(std::size_t first, std::size_t count) const;
+	T getClosestPointIndexed(const T& target, unsigned int* nearestIndex) const;
+	bool insideIndexed(float x, float y) const;
 };
 
 #include "ofPolyline.inl"
@@ -14,6 +14,7 @@
 template<class T>
 ofPolyline_<T>::ofPolyline_(){
     setRightVector();
+	bUseSpatialIndex = false;
 	clear();
 }
 
@@ -21,6 +22,7 @@ ofPolyline_<T>::ofPolyline_(){
 template<class T>
 ofPolyline_<T>::ofPolyline_(const std::vector<T>& verts){
     setRightVector();
+	bUseSpatialIndex = false;
 	clear();
 	addVertices(verts);
 }
@@ -154,6 +156,7 @@ template<class T>
 void ofPolyline_<T>::flagHasChanged() {
     bHasChanged = true;
     bCacheIsDirty = true;
+    bSegmentIndexDirty = true;
 }
 
 //----------------------------------------------------------
@@ -455,79 +458,135 @@ ofRectangle ofPolyline_<T>::getBoundingBox() const {
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getSmoothed(int smoothingSize, float smoothingShape) const {
+	ofPolyline_ result;
+	getSmoothed(smoothingSize, smoothingShape, result);
+	return result;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getSmoothed(int smoothingSize, float smoothingShape, ofPolyline_ & result) const {
 	int n = size();
 	smoothingSize = ofClamp(smoothingSize, 0, n);
 	smoothingShape = ofClamp(smoothingShape, 0, 1);
-	
-	// precompute weights and normalization
-	std::vector<float> weights;
-	weights.resize(smoothingSize);
-	// side weights
-	for(int i = 1; i < smoothingSize; i++) {
-		float curWeight = ofMap(i, 0, smoothingSize, 1, smoothingShape);
-		weights[i] = curWeight;
-	}
-	
-	// make a copy of this polyline
-	ofPolyline_ result = *this;
-	
-	for(int i = 0; i < n; i++) {
-		float sum = 1; // center weight
-		for(int j = 1; j < smoothingSize; j++) {
-			T cur;
-			int leftPosition = i - j;
-			int rightPosition = i + j;
-			if(leftPosition < 0 && bClosed) {
-				leftPosition += n;
-			}
-			if(leftPosition >= 0) {
-				cur += points[leftPosition];
-				sum += weights[j];
-			}
-			if(rightPosition >= n && bClosed) {
-				rightPosition -= n;
+
+	result.points.assign(points.begin(), points.end());
+	result.curveVertices.clear();
+	result.rightVector = rightVector;
+	result.setClosed(bClosed);
+
+	// the side weights go linearly from 1 to smoothingShape:
+	// weight(j) = 1 + slope * j, so the sum of the first k weights is
+	// k + slope * k * (k + 1) / 2 and the normalization of every point can
+	// be computed without iterating the window
+	float slope = smoothingSize > 0 ? (smoothingShape - 1.f) / smoothingSize : 0.f;
+	auto weightsSum = [&](int k){
+		return k + slope * k * (k + 1) * 0.5f;
+	};
+
+	// convolve one offset at a time over contiguous ranges of points, the
+	// inner loops have no branches or wrapping so the compiler can
+	// vectorize them
+	T * dst = result.points.data();
+	const T * src = points.data();
+	for(int j = 1; j < smoothingSize; j++) {
+		float weight = 1.f + slope * j;
+		for(int i = j; i < n; i++) {
+			dst[i] += src[i - j] * weight;
+		}
+		for(int i = 0; i < n - j; i++) {
+			dst[i] += src[i + j] * weight;
+		}
+		if(bClosed) {
+			for(int i = 0; i < j; i++) {
+				dst[i] += src[i - j + n] * weight;
 			}
-			if(rightPosition < n) {
-				cur += points[rightPosition];
-				sum += weights[j];
+			for(int i = n - j; i < n; i++) {
+				dst[i] += src[i + j - n] * weight;
 			}
-			result[i] += cur * weights[j];
 		}
-		result[i] /= sum;
 	}
-	
-	return result;
+
+	int window = std::max(smoothingSize - 1, 0);
+	if(bClosed) {
+		float sum = 1.f + 2.f * weightsSum(window);
+		for(int i = 0; i < n; i++) {
+			dst[i] /= sum;
+		}
+	} else {
+		// points close to the ends only have part of the window
+		for(int i = 0; i < n; i++) {
+			int left = std::min(i, window);
+			int right = std::min(n - 1 - i, window);
+			dst[i] /= 1.f + weightsSum(left) + weightsSum(right);
+		}
+	}
 }
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getResampledBySpacing(float spacing) const {
-    if(spacing==0 || size() == 0) return *this;
 	ofPolyline_ poly;
-    float totalLength = getPerimeter();
-    for(float f=0; f<totalLength; f += spacing) {
-        poly.lineTo(getPointAtLength(f));
-    }
-    
-    if(!isClosed()) {
-        if(poly.size() > 0) poly.points.back() = points.back();
-        poly.setClosed(false);
-    } else {
-        poly.setClosed(true);
-    }
-    
-    return poly;
+	getResampledBySpacing(spacing, poly);
+	return poly;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getResampledBySpacing(float spacing, ofPolyline_ & poly) const {
+	poly.curveVertices.clear();
+	poly.rightVector = rightVector;
+	if(spacing <= 0 || size() == 0) {
+		poly.points.assign(points.begin(), points.end());
+		poly.setClosed(isClosed());
+		return;
+	}
+
+	poly.points.clear();
+	float totalLength = getPerimeter();
+	if(totalLength > 0) {
+		poly.points.reserve(size_t(totalLength / spacing) + 1);
+	}
+
+	// walk the segments once instead of searching the length of every
+	// sample, lengths is only valid after getPerimeter() updated the cache
+	int lastSegment = int(lengths.size()) - 2;
+	int segment = 0;
+	for(float f=0; f<totalLength; f += spacing) {
+		while(segment < lastSegment && lengths[segment + 1] <= f) {
+			segment++;
+		}
+		float t = ofMap(f, lengths[segment], lengths[segment + 1], 0, 1);
+		const auto & p1 = toGlm(points[getWrappedIndex(segment)]);
+		const auto & p2 = toGlm(points[getWrappedIndex(segment + 1)]);
+		poly.points.push_back(glm::lerp(p1, p2, t));
+	}
+
+	if(!isClosed()) {
+		if(poly.size() > 0) poly.points.back() = points.back();
+		poly.setClosed(false);
+	} else {
+		poly.setClosed(true);
+	}
 }
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T> ofPolyline_<T>::getResampledByCount(int count) const {
+	ofPolyline_ poly;
+	getResampledByCount(count, poly);
+	return poly;
+}
+
+//----------------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getResampledByCount(int count, ofPolyline_ & result) const {
 	float perimeter = getPerimeter();
 	if(count < 2) {
 		ofLogWarning("ofPolyline_") << "getResampledByCount(): requested " << count <<" points, using minimum count of 2 ";
 		count = 2;
-    }
-	return ofPolyline_<T>::getResampledBySpacing(perimeter / (count-1));
+	}
+	getResampledBySpacing(perimeter / (count-1), result);
 }
 
 //----------------------------------------------------------
@@ -573,6 +632,10 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 		}
 		return target;
 	}
+
+	if(bUseSpatialIndex) {
+		return getClosestPointIndexed(target, nearestIndex);
+	}
 	
 	float distance = 0;
 	T nearestPoint;
@@ -612,6 +675,274 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 	return nearestPoint;
 }
 
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getClosestPoints(const T* targets, std::size_t numTargets, T* closest, unsigned int* nearestIndices) const {
+	if(bUseSpatialIndex){
+		updateSegmentIndex();
+	}
+	for(std::size_t i = 0; i < numTargets; i++){
+		closest[i] = getClosestPoint(targets[i], nearestIndices == nullptr ? nullptr : nearestIndices + i);
+	}
+}
+
+//--------------------------------------------------
+template<class T>
+std::vector<T> ofPolyline_<T>::getClosestPoints(const std::vector<T>& targets) const {
+	std::vector<T> closest(targets.size());
+	if(!targets.empty()){
+		getClosestPoints(targets.data(), targets.size(), closest.data());
+	}
+	return closest;
+}
+
+//--------------------------------------------------
+template<class T>
+std::vector<bool> ofPolyline_<T>::inside(const std::vector<T>& targets) const {
+	std::vector<bool> result(targets.size());
+	if(bUseSpatialIndex){
+		updateSegmentIndex();
+	}
+	for(std::size_t i = 0; i < targets.size(); i++){
+		result[i] = inside(targets[i]);
+	}
+	return result;
+}
+
+//--------------------------------------------------
+template<class T>
+std::vector<T> ofPolyline_<T>::getIntersections(const T& p0, const T& p1) const {
+	std::vector<T> intersections;
+	if(points.size() < 2){
+		return intersections;
+	}
+	std::size_t numSegments = isClosed() ? points.size() : points.size() - 1;
+
+	auto d = toGlm(p1) - toGlm(p0);
+	auto intersectSegment = [&](std::size_t i){
+		const auto & a = toGlm(points[i]);
+		const auto & b = toGlm(points[(i + 1) % points.size()]);
+		auto e = b - a;
+		float denom = d.x * e.y - d.y * e.x;
+		if(denom == 0){
+			return;
+		}
+		auto w = a - toGlm(p0);
+		float t = (w.x * e.y - w.y * e.x) / denom;
+		float u = (w.x * d.y - w.y * d.x) / denom;
+		if(t >= 0 && t <= 1 && u >= 0 && u <= 1){
+			auto p = a + e * u;
+			intersections.push_back(T(p.x, p.y, p.z));
+		}
+	};
+
+	if(!bUseSpatialIndex){
+		for(std::size_t i = 0; i < numSegments; i++){
+			intersectSegment(i);
+		}
+		return intersections;
+	}
+
+	updateSegmentIndex();
+	glm::vec2 qmin(std::min(p0.x, p1.x), std::min(p0.y, p1.y));
+	glm::vec2 qmax(std::max(p0.x, p1.x), std::max(p0.y, p1.y));
+	std::size_t stack[segmentStackSize];
+	std::size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0){
+		std::size_t nodeIndex = stack[--stackSize];
+		const auto & node = segmentIndex[nodeIndex];
+		if(node.max.x < qmin.x || node.min.x > qmax.x || node.max.y < qmin.y || node.min.y > qmax.y){
+			continue;
+		}
+		if(node.right == 0){
+			for(std::size_t i = node.first; i < node.first + node.count; i++){
+				if(i < numSegments){
+					intersectSegment(i);
+				}
+			}
+		}else{
+			stack[stackSize++] = node.right;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+	return intersections;
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::setUseSpatialIndex(bool useSpatialIndex){
+	bUseSpatialIndex = useSpatialIndex;
+	if(!bUseSpatialIndex){
+		segmentIndex.clear();
+		segmentIndex.shrink_to_fit();
+	}
+	bSegmentIndexDirty = true;
+}
+
+//--------------------------------------------------
+template<class T>
+bool ofPolyline_<T>::isUsingSpatialIndex() const{
+	return bUseSpatialIndex;
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::updateSegmentIndex() const{
+	if(!bSegmentIndexDirty){
+		return;
+	}
+	bSegmentIndexDirty = false;
+	segmentIndex.clear();
+	if(points.size() < 2){
+		return;
+	}
+	// consecutive segments of a line are usually close in space so the
+	// hierarchy is built over ranges of segments in order which is linear
+	// and needs no sorting
+	segmentIndex.reserve(2 * (points.size() / 8 + 1));
+	buildSegmentNode(0, points.size());
+}
+
+//--------------------------------------------------
+template<class T>
+std::size_t ofPolyline_<T>::buildSegmentNode(std::size_t first, std::size_t count) const{
+	const std::size_t maxLeafSegments = 8;
+	std::size_t index = segmentIndex.size();
+	segmentIndex.push_back(SegmentNode());
+	SegmentNode node;
+	node.first = first;
+	node.count = count;
+	node.right = 0;
+	if(count <= maxLeafSegments){
+		glm::vec3 min = toGlm(points[first]);
+		glm::vec3 max = min;
+		for(std::size_t i = first; i < first + count; i++){
+			const auto & next = toGlm(points[(i + 1) % points.size()]);
+			min = glm::min(min, next);
+			max = glm::max(max, next);
+		}
+		node.min = T(min.x, min.y, min.z);
+		node.max = T(max.x, max.y, max.z);
+	}else{
+		std::size_t leftCount = count / 2;
+		buildSegmentNode(first, leftCount);
+		node.right = buildSegmentNode(first + leftCount, count - leftCount);
+		const auto & left = segmentIndex[index + 1];
+		const auto & right = segmentIndex[node.right];
+		auto min = glm::min(toGlm(left.min), toGlm(right.min));
+		auto max = glm::max(toGlm(left.max), toGlm(right.max));
+		node.min = T(min.x, min.y, min.z);
+		node.max = T(max.x, max.y, max.z);
+	}
+	segmentIndex[index] = node;
+	return index;
+}
+
+//--------------------------------------------------
+template<class T>
+T ofPolyline_<T>::getClosestPointIndexed(const T& target, unsigned int* nearestIndex) const {
+	updateSegmentIndex();
+	std::size_t numSegments = isClosed() ? points.size() : points.size() - 1;
+	const auto & p = toGlm(target);
+	auto distanceToBox = [&](const SegmentNode & node){
+		auto d = glm::max(glm::max(toGlm(node.min) - p, p - toGlm(node.max)), glm::vec3(0.f));
+		return glm::length(d);
+	};
+
+	float distance = std::numeric_limits<float>::max();
+	T nearestPoint = target;
+	std::size_t nearest = 0;
+	float normalizedPosition = 0;
+	std::size_t stack[segmentStackSize];
+	std::size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0){
+		std::size_t nodeIndex = stack[--stackSize];
+		const auto & node = segmentIndex[nodeIndex];
+		if(distanceToBox(node) > distance){
+			continue;
+		}
+		if(node.right == 0){
+			for(std::size_t i = node.first; i < node.first + node.count && i < numSegments; i++){
+				float curNormalizedPosition = 0;
+				auto curNearestPoint = getClosestPointUtil(points[i], points[(i + 1) % points.size()], target, &curNormalizedPosition);
+				float curDistance = glm::distance(toGlm(curNearestPoint), p);
+				// ties resolved to the lowest segment like the linear search
+				if(curDistance < distance || (curDistance == distance && i < nearest)){
+					distance = curDistance;
+					nearest = i;
+					nearestPoint = curNearestPoint;
+					normalizedPosition = curNormalizedPosition;
+				}
+			}
+		}else{
+			// visit the closest child first so the other one is more
+			// likely to be discarded
+			const auto & left = segmentIndex[nodeIndex + 1];
+			const auto & right = segmentIndex[node.right];
+			if(distanceToBox(left) < distanceToBox(right)){
+				stack[stackSize++] = node.right;
+				stack[stackSize++] = nodeIndex + 1;
+			}else{
+				stack[stackSize++] = nodeIndex + 1;
+				stack[stackSize++] = node.right;
+			}
+		}
+	}
+
+	if(nearestIndex != nullptr) {
+		if(normalizedPosition > .5) {
+			nearest++;
+			if(nearest == points.size()) {
+				nearest = 0;
+			}
+		}
+		*nearestIndex = nearest;
+	}
+	return nearestPoint;
+}
+
+//--------------------------------------------------
+template<class T>
+bool ofPolyline_<T>::insideIndexed(float x, float y) const {
+	updateSegmentIndex();
+	int counter = 0;
+	std::size_t stack[segmentStackSize];
+	std::size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0){
+		std::size_t nodeIndex = stack[--stackSize];
+		const auto & node = segmentIndex[nodeIndex];
+		// same conditions as the linear crossing test, a segment can only
+		// count if the horizontal ray from x,y to the right crosses it
+		if(y <= node.min.y || y > node.max.y || x > node.max.x){
+			continue;
+		}
+		if(node.right == 0){
+			for(std::size_t i = node.first; i < node.first + node.count; i++){
+				const auto & p1 = points[i];
+				const auto & p2 = points[(i + 1) % points.size()];
+				if (y > MIN(p1.y,p2.y)) {
+					if (y <= MAX(p1.y,p2.y)) {
+						if (x <= MAX(p1.x,p2.x)) {
+							if (p1.y != p2.y) {
+								double xinters = (y-p1.y)*(p2.x-p1.x)/(p2.y-p1.y)+p1.x;
+								if (p1.x == p2.x || x <= xinters)
+									counter++;
+							}
+						}
+					}
+				}
+			}
+		}else{
+			stack[stackSize++] = node.right;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+	return counter % 2 != 0;
+}
+
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(const T & p, const ofPolyline_ & polyline){
@@ -621,6 +952,10 @@ bool ofPolyline_<T>::inside(const T & p, const ofPolyline_ & polyline){
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(float x, float y, const ofPolyline_ & polyline){
+	if(polyline.bUseSpatialIndex && polyline.size() >= 2){
+		return polyline.insideIndexed(x, y);
+	}
+
 	int counter = 0;
 	int i;
 	double xinters;
@@ -746,9 +1081,6 @@ void ofPolyline_<T>::simplify(float tol){
 		return;
 	}
 
-	std::vector <T> sV;
-	sV.resize(n);
-    
     int    i, k, m, pv;            // misc counters
     float  tol2 = tol * tol;       // tolerance squared
     std::vector<T> vt;
@@ -771,18 +1103,13 @@ void ofPolyline_<T>::simplify(float tol){
     mk[0] = mk[k-1] = 1;       // mark the first and last vertices
 	of::priv::simplifyDP( tol, &vt[0], 0, k-1, &mk[0] );
     
-    // copy marked vertices to the output simplified polyline
+    // copy marked vertices to the output simplified polyline, we already
+    // have a copy in vt so the original points can be overwritten in place
     for (i=m=0; i<k; i++) {
-        if (mk[i]) sV[m++] = vt[i];
+        if (mk[i]) points[m++] = vt[i];
     }
-    
-	//get rid of the unused points
-	if( m < (int)sV.size() ){
-		points.assign( sV.begin(),sV.begin()+m );
-	}else{
-		points = sV;
-	}
-    
+	points.resize(m);
+	flagHasChanged();
 }
 
 //--------------------------------------------------
@@ -809,10 +1136,8 @@ void ofPolyline_<T>::rotateDeg(float degrees, const glm::vec3& axis){
 //--------------------------------------------------
 template<class T>
 void ofPolyline_<T>::rotateRad(float radians, const glm::vec3& axis){
-    for(auto & point : points){
-        point = glm::rotate(toGlm(point), radians, axis);
-    }
-    flagHasChanged();
+    // build the rotation once instead of once per vertex
+    transform(glm::rotate(glm::mat4(1.f), radians, axis));
 }
 
 //--------------------------------------------------
@@ -849,6 +1174,49 @@ void ofPolyline_<T>::scale(float x, float y){
     flagHasChanged();
 }
 
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::transform(const glm::mat4 & m){
+    getTransformed(m, *this);
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getTransformed(const glm::mat4 & m, ofPolyline_ & result) const{
+    if(&result != this){
+        result.points.resize(points.size());
+        result.curveVertices.clear();
+        result.rightVector = rightVector;
+        result.bClosed = bClosed;
+    }
+
+    const T * src = points.data();
+    T * dst = result.points.data();
+    std::size_t n = points.size();
+
+    // expanded multiply of the columns so the loop doesn't build temporary
+    // vec4s and can be vectorized, the perspective divide is only needed
+    // for projective matrices which are rare
+    const auto c0 = m[0], c1 = m[1], c2 = m[2], c3 = m[3];
+    if(c0.w == 0 && c1.w == 0 && c2.w == 0 && c3.w == 1){
+        for(std::size_t i = 0; i < n; i++){
+            float x = src[i].x, y = src[i].y, z = src[i].z;
+            dst[i].x = c0.x * x + c1.x * y + c2.x * z + c3.x;
+            dst[i].y = c0.y * x + c1.y * y + c2.y * z + c3.y;
+            dst[i].z = c0.z * x + c1.z * y + c2.z * z + c3.z;
+        }
+    }else{
+        for(std::size_t i = 0; i < n; i++){
+            float x = src[i].x, y = src[i].y, z = src[i].z;
+            float w = c0.w * x + c1.w * y + c2.w * z + c3.w;
+            dst[i].x = (c0.x * x + c1.x * y + c2.x * z + c3.x) / w;
+            dst[i].y = (c0.y * x + c1.y * y + c2.y * z + c3.y) / w;
+            dst[i].z = (c0.z * x + c1.z * y + c2.z * z + c3.z) / w;
+        }
+    }
+    result.flagHasChanged();
+}
+
 //--------------------------------------------------
 template<class T>
 void ofPolyline_<T>::draw() const{
@@ -879,28 +1247,14 @@ float ofPolyline_<T>::getIndexAtLength(float length) const {
     
     int lastPointIndex = isClosed() ? points.size() : points.size()-1;
     
-    int i1 = ofClamp(floor(length / totalLength * lastPointIndex), 0, lengths.size()-2);   // start approximation here
-    int leftLimit = 0;
-    int rightLimit = lastPointIndex;
-    
-    float distAt1, distAt2;
-    for(int iterations = 0; iterations < 32; iterations ++) {	// limit iterations
-        i1 = ofClamp(i1, 0, lengths.size()-1);
-        distAt1 = lengths[i1];
-        if(distAt1 <= length) {         // if Length at i1 is less than desired Length (this is good)
-            distAt2 = lengths[i1+1];
-            if(distAt2 >= length) {
-                float t = ofMap(length, distAt1, distAt2, 0, 1);
-                return i1 + t;
-            } else {
-                leftLimit = i1;
-            }
-        } else {
-            rightLimit = i1;
-        }
-        i1 = (leftLimit + rightLimit)/2;
-    }
-    return 0;
+    // lengths is sorted so the segment containing length is the one before
+    // the first cumulative length bigger than it
+    auto it = std::upper_bound(lengths.begin(), lengths.begin() + lastPointIndex + 1, length);
+    int i1 = ofClamp(int(it - lengths.begin()) - 1, 0, lastPointIndex - 1);
+    float distAt1 = lengths[i1];
+    float distAt2 = lengths[i1+1];
+    float t = ofMap(length, distAt1, distAt2, 0, 1);
+    return i1 + t;
 }
 
 
@@ -681,6 +681,12 @@ void ofRendererCollection::drawString(const ofTrueTypeFont & font, std::string t
 	}
 }
 
+void ofRendererCollection::drawString(const ofTextLayout & layout, float x, float y) const{
+   for(auto renderer: renderers){
+	   renderer->drawString(layout, x,y);
+	}
+}
+
 void ofRendererCollection::bind(const ofCamera & camera, const ofRectangle & viewport){
    for(auto renderer: renderers){
 	   renderer->bind(camera, viewport);
@@ -222,6 +222,8 @@ public:
 
 	void drawString(const ofTrueTypeFont & font, std::string text, float x, float y) const;
 
+	void drawString(const ofTextLayout & layout, float x, float y) const;
+
 	virtual void bind(const ofCamera & camera, const ofRectangle & viewport);
 	virtual void unbind(const ofCamera & camera);
 
@@ -0,0 +1,253 @@
+#include "ofTextLayout.h"
+#include "ofTrueTypeFont.h"
+#include "ofGraphicsBaseTypes.h"
+#include "ofAppRunner.h"
+#include "ofUtils.h"
+
+using namespace std;
+
+//-----------------------------------------------------------
+ofTextLayout::ofTextLayout()
+:font(nullptr)
+,width(0)
+,alignment(OF_ALIGN_HORZ_LEFT)
+,vflip(true)
+,useColor(false){}
+
+//-----------------------------------------------------------
+ofTextLayout::ofTextLayout(const ofTrueTypeFont & font, const std::string & text, float width, ofAlignHorz alignment, bool vflip)
+:ofTextLayout(){
+	setup(font, text, width, alignment, vflip);
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::setup(const ofTrueTypeFont & font, const std::string & text, float width, ofAlignHorz alignment, bool vflip){
+	this->font = &font;
+	this->text = text;
+	this->width = width;
+	this->alignment = alignment;
+	this->vflip = vflip;
+	if(!font.isLoaded()){
+		ofLogError("ofTextLayout") << "setup(): font not loaded";
+	}
+	update();
+}
+
+//-----------------------------------------------------------
+bool ofTextLayout::isSetup() const{
+	return font && font->isLoaded();
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::draw() const{
+	draw(position.x, position.y);
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::draw(float x, float y) const{
+	if(!isSetup()){
+		ofLogError("ofTextLayout") << "draw(): layout not set up with a loaded font";
+		return;
+	}
+	auto renderer = ofGetCurrentRenderer();
+	if(useColor){
+		renderer->pushStyle();
+		renderer->setColor(color);
+	}
+	renderer->drawString(*this, x, y);
+	if(useColor){
+		renderer->popStyle();
+	}
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::setPosition(float x, float y){
+	position = {x, y};
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::setPosition(const glm::vec2 & position){
+	this->position = position;
+}
+
+//-----------------------------------------------------------
+const glm::vec2 & ofTextLayout::getPosition() const{
+	return position;
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::setColor(const ofColor & color){
+	this->color = color;
+	useColor = true;
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::clearColor(){
+	useColor = false;
+}
+
+//-----------------------------------------------------------
+bool ofTextLayout::hasColor() const{
+	return useColor;
+}
+
+//-----------------------------------------------------------
+const ofColor & ofTextLayout::getColor() const{
+	return color;
+}
+
+//-----------------------------------------------------------
+const ofTrueTypeFont * ofTextLayout::getFont() const{
+	return font;
+}
+
+//-----------------------------------------------------------
+const std::string & ofTextLayout::getText() const{
+	return text;
+}
+
+//-----------------------------------------------------------
+float ofTextLayout::getWidth() const{
+	return width;
+}
+
+//-----------------------------------------------------------
+ofAlignHorz ofTextLayout::getAlignment() const{
+	return alignment;
+}
+
+//-----------------------------------------------------------
+bool ofTextLayout::isVFlipped() const{
+	return vflip;
+}
+
+//-----------------------------------------------------------
+const ofRectangle & ofTextLayout::getBoundingBox() const{
+	if(isSetup() && !font->isLayoutCurrent(glyphs)){
+		update();
+	}
+	return boundingBox;
+}
+
+//-----------------------------------------------------------
+const vector<ofRectangle> & ofTextLayout::getGlyphBoxes() const{
+	if(isSetup() && !font->isLayoutCurrent(glyphs)){
+		update();
+	}
+	return glyphBoxes;
+}
+
+//-----------------------------------------------------------
+const vector<ofTextLayout::line> & ofTextLayout::getLines() const{
+	if(isSetup() && !font->isLayoutCurrent(glyphs)){
+		update();
+	}
+	return lines;
+}
+
+//-----------------------------------------------------------
+const vector<ofVboMesh> & ofTextLayout::getMeshes() const{
+	// marks the glyphs as used so they aren't evicted while the layout is
+	// being drawn
+	if(isSetup() && !font->useLayout(glyphs)){
+		update();
+	}
+	return meshes;
+}
+
+//-----------------------------------------------------------
+void ofTextLayout::update() const{
+	lines.clear();
+	glyphBoxes.clear();
+	boundingBox = ofRectangle();
+	if(!isSetup()){
+		meshes.clear();
+		return;
+	}
+
+	//--------------------- break lines
+	auto fits = [&](const string & str){
+		return font->stringWidth(str) <= width;
+	};
+	for(auto & paragraph: ofSplitString(text, "\n")){
+		if(width <= 0){
+			lines.push_back({paragraph, {}, {}});
+			continue;
+		}
+
+		string current;
+		bool started = false;
+		for(auto & word: ofSplitString(paragraph, " ")){
+			auto candidate = started ? current + " " + word : word;
+			if(!started || fits(candidate)){
+				current = candidate;
+				started = true;
+			}else{
+				lines.push_back({current, {}, {}});
+				current = word;
+			}
+			if(!fits(current)){
+				// the word alone doesn't fit, break it between characters
+				string part;
+				for(auto c: ofUTF8Iterator(current)){
+					string next = part;
+					ofUTF8Append(next, c);
+					if(!part.empty() && !fits(next)){
+						lines.push_back({part, {}, {}});
+						next.clear();
+						ofUTF8Append(next, c);
+					}
+					part = next;
+				}
+				current = part;
+			}
+		}
+		lines.push_back({current, {}, {}});
+	}
+
+	//--------------------- align
+	float lineHeight = font->getLineHeight() * (vflip ? 1 : -1);
+	float alignWidth = width;
+	for(size_t i = 0; i < lines.size(); i++){
+		lines[i].position = {0.f, i * lineHeight};
+		lines[i].boundingBox = font->getStringBoundingBox(lines[i].text, 0, 0, vflip);
+		if(width <= 0){
+			alignWidth = std::max(alignWidth, lines[i].boundingBox.width);
+		}
+	}
+	for(auto & line: lines){
+		auto & box = line.boundingBox;
+		switch(alignment){
+		case OF_ALIGN_HORZ_LEFT:
+			line.position.x = -box.x;
+			break;
+		case OF_ALIGN_HORZ_CENTER:
+			line.position.x = (alignWidth - box.width) / 2 - box.x;
+			break;
+		case OF_ALIGN_HORZ_RIGHT:
+			line.position.x = alignWidth - box.width - box.x;
+			break;
+		default:
+			break;
+		}
+		box.x += line.position.x;
+		box.y += line.position.y;
+		if(&line == &lines.front()){
+			boundingBox = box;
+		}else{
+			boundingBox.growToInclude(box);
+		}
+	}
+
+	//--------------------- glyph quads
+	font->beginLayout(glyphs);
+	for(auto & line: lines){
+		font->addLayoutLine(line.text, line.position, vflip, glyphs, glyphBoxes);
+	}
+	auto & quads = font->endLayout(glyphs);
+
+	meshes.resize(quads.size());
+	for(size_t page = 0; page < meshes.size(); page++){
+		meshes[page] = quads[page];
+	}
+}
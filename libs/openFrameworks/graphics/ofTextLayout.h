@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofColor.h"
+#include "ofRectangle.h"
+#include "ofVboMesh.h"
+#include "ofTrueTypeFont.h"
+
+/// \brief Text laid out once with an ofTrueTypeFont to be drawn many times.
+///
+/// ofTrueTypeFont::drawString() decodes the string, applies kerning and
+/// builds the glyph quads every time it's called. A layout does that work
+/// once, wrapping the text to a width and aligning its lines, and keeps
+/// the quads in vbos so drawing a static label doesn't need any work on
+/// the CPU. Moving the layout or changing its color doesn't touch the
+/// quads either.
+///
+/// The layout is rebuilt automatically when the font changes in a way
+/// that affects it, like changing the line height or, with a dynamic
+/// atlas, evicting any of its glyphs. The font has to outlive the layout.
+///
+/// ~~~~{.cpp}
+/// // setup
+/// label.setup(font, "Some long text that wraps", 200, OF_ALIGN_HORZ_CENTER);
+/// label.setPosition(20, 40);
+///
+/// // draw
+/// label.draw();
+/// ~~~~
+class ofTextLayout{
+public:
+	/// \brief A line of text after wrapping and its position in the layout.
+	struct line{
+		std::string text;
+		glm::vec2 position;
+		ofRectangle boundingBox;
+	};
+
+	ofTextLayout();
+
+	/// \brief Lays out text, see setup().
+	ofTextLayout(const ofTrueTypeFont & font, const std::string & text, float width = 0, ofAlignHorz alignment = OF_ALIGN_HORZ_LEFT, bool vflip = true);
+
+	/// \brief Lays out text with a font.
+	///
+	/// \param font the font to draw the text with.
+	/// \param text utf8 text, can contain line breaks.
+	/// \param width width in pixels to wrap the text at, lines are broken
+	/// between words and words longer than width between characters.
+	/// 0 only breaks lines at the line breaks in the text.
+	/// \param alignment how lines are aligned between 0 and width or the
+	/// width of the longest line if width is 0. OF_ALIGN_HORZ_IGNORE starts
+	/// every line at the position of the layout, as drawString() does.
+	/// \param vflip true if the text will be drawn with the y axis going
+	/// down, as the default openFrameworks coordinates.
+	void setup(const ofTrueTypeFont & font, const std::string & text, float width = 0, ofAlignHorz alignment = OF_ALIGN_HORZ_LEFT, bool vflip = true);
+
+	/// \returns true if the layout has been set up with a loaded font.
+	bool isSetup() const;
+
+	/// \brief Draws the layout at its position.
+	void draw() const;
+
+	/// \brief Draws the layout at x, y, the baseline of the first line.
+	void draw(float x, float y) const;
+
+	/// \brief Sets the position draw() uses, the left of the baseline of
+	/// the first line.
+	void setPosition(float x, float y);
+	void setPosition(const glm::vec2 & position);
+	const glm::vec2 & getPosition() const;
+
+	/// \brief Sets a color to draw the text with instead of the current
+	/// style color.
+	void setColor(const ofColor & color);
+	/// \brief Draws with the current style color again.
+	void clearColor();
+	bool hasColor() const;
+	const ofColor & getColor() const;
+
+	const ofTrueTypeFont * getFont() const;
+	const std::string & getText() const;
+	float getWidth() const;
+	ofAlignHorz getAlignment() const;
+	bool isVFlipped() const;
+
+	/// \returns the bounding box of the text relative to the position.
+	const ofRectangle & getBoundingBox() const;
+
+	/// \returns the bounding box of each drawn glyph relative to the
+	/// position, in the order they appear in the text.
+	const std::vector<ofRectangle> & getGlyphBoxes() const;
+
+	/// \returns the lines of the layout after wrapping.
+	const std::vector<line> & getLines() const;
+
+	/// \brief Get the glyph quads relative to the position.
+	///
+	/// As with ofTrueTypeFont::getStringMeshes() there's one mesh per atlas
+	/// page that has to be drawn with ofTrueTypeFont::getFontTexture(page).
+	const std::vector<ofVboMesh> & getMeshes() const;
+
+private:
+	void update() const;
+
+	const ofTrueTypeFont * font;
+	std::string text;
+	float width;
+	ofAlignHorz alignment;
+	bool vflip;
+	glm::vec2 position;
+	ofColor color;
+	bool useColor;
+
+	mutable std::vector<line> lines;
+	mutable std::vector<ofVboMesh> meshes;
+	mutable std::vector<ofRectangle> glyphBoxes;
+	mutable ofTrueTypeFont::layoutGlyphs glyphs;
+	mutable ofRectangle boundingBox;
+};
@@ -13,9 +13,15 @@
 #include FT_TRIGONOMETRY_H
 
 #include <algorithm>
+#include <atomic>
+#include <iomanip>
 #include <numeric>
+#include <sstream>
+#include <thread>
 
 #include "ofGraphics.h"
+#include "ofGLUtils.h"
+#include "ofTextLayout.h"
 #include "utf8.h"
 
 using namespace std;
@@ -158,6 +164,7 @@ const ofTrueTypeFont::glyphProps ofTrueTypeFont::invalidProps{
 };
 
 const size_t TAB_WIDTH = 4; /// Number of spaces per tab
+const uint32_t cacheVersion = 1; /// Format of the distance field atlas cache
 
 static bool printVectorInfo = false;
 static int ttfGlobalDpi = 96;
@@ -174,29 +181,43 @@ void ofTrueTypeShutdown(){
 }
 
 //--------------------------------------------------------
-static ofPath makeContoursForCharacter(FT_Face face){
-	ofPath charOutlines;
-	charOutlines.setUseShapeColor(false);
-	charOutlines.setPolyWindingMode(OF_POLY_WINDING_NONZERO);
+// subpixel keeps the fractional part of the outline coordinates, the
+// contours returned to the user have always been rounded to pixels
+static ofPath makeContoursForCharacter(FT_Face face, bool subpixel = false){
+	struct contourWriter{
+		ofPath path;
+		bool subpixel;
+
+		glm::vec2 toPoint(const FT_Vector * v) const{
+			if(subpixel){
+				return {v->x/64.f, -v->y/64.f};
+			}else{
+				return {float(v->x/64), float(-v->y/64)};
+			}
+		}
+	};
+	contourWriter writer{ofPath(), subpixel};
+	writer.path.setUseShapeColor(false);
+	writer.path.setPolyWindingMode(OF_POLY_WINDING_NONZERO);
 	auto moveTo = [](const FT_Vector*to, void * userData){
-		ofPath * charOutlines = static_cast<ofPath*>(userData);
-		charOutlines->moveTo(to->x/64, -to->y/64);
+		contourWriter * writer = static_cast<contourWriter*>(userData);
+		writer->path.moveTo(writer->toPoint(to));
 		return 0;
 	};
 	auto lineTo = [](const FT_Vector*to, void * userData){
-		ofPath * charOutlines = static_cast<ofPath*>(userData);
-		charOutlines->lineTo(to->x/64, -to->y/64);
+		contourWriter * writer = static_cast<contourWriter*>(userData);
+		writer->path.lineTo(writer->toPoint(to));
 		return 0;
 	};
 	auto conicTo = [](const FT_Vector*cp, const FT_Vector*to, void * userData){
-		ofPath * charOutlines = static_cast<ofPath*>(userData);
-		auto lastP = charOutlines->getCommands().back().to;
-		charOutlines->quadBezierTo(lastP, {cp->x/64, -cp->y/64}, {to->x/64, -to->y/64});
+		contourWriter * writer = static_cast<contourWriter*>(userData);
+		auto lastP = writer->path.getCommands().back().to;
+		writer->path.quadBezierTo(lastP, glm::vec3(writer->toPoint(cp), 0.f), glm::vec3(writer->toPoint(to), 0.f));
 		return 0;
 	};
 	auto cubicTo = [](const FT_Vector*cp1, const FT_Vector*cp2, const FT_Vector*to, void * userData){
-		ofPath * charOutlines = static_cast<ofPath*>(userData);
-		charOutlines->bezierTo({cp1->x/64, -cp1->y/64}, {cp2->x/64, -cp2->y/64}, {to->x/64, -to->y/64});
+		contourWriter * writer = static_cast<contourWriter*>(userData);
+		writer->path.bezierTo(writer->toPoint(cp1), writer->toPoint(cp2), writer->toPoint(to));
 		return 0;
 	};
 	FT_Outline_Funcs funcs{
@@ -208,10 +229,385 @@ static ofPath makeContoursForCharacter(FT_Face face){
 		0,
 	};
 
-	FT_Outline_Decompose(&face->glyph->outline, &funcs, &charOutlines);
-	charOutlines.close();
+	FT_Outline_Decompose(&face->glyph->outline, &funcs, &writer);
+	writer.path.close();
 
-	return charOutlines;
+	return writer.path;
+}
+
+namespace{
+	// channels of a multi-channel distance field an edge contributes to
+	enum edgeColor{
+		BLACK = 0,
+		RED = 1,
+		GREEN = 2,
+		YELLOW = 3,
+		BLUE = 4,
+		MAGENTA = 5,
+		CYAN = 6,
+		WHITE = 7
+	};
+
+	// a curve of an outline flattened to a polyline, corners of the
+	// outline are always at the start or end of an edge
+	struct outlineEdge{
+		std::vector<glm::vec2> points;
+		int color = WHITE;
+
+		glm::vec2 startDirection() const{
+			return glm::normalize(points[1] - points[0]);
+		}
+
+		glm::vec2 endDirection() const{
+			return glm::normalize(points[points.size() - 1] - points[points.size() - 2]);
+		}
+	};
+
+	struct distanceSegment{
+		glm::vec2 a, b;
+		float minX, maxX, minY, maxY;
+		int color;
+		bool first, last; // extended at the ends of an edge to get pseudo distances
+	};
+
+	float cross(const glm::vec2 & a, const glm::vec2 & b){
+		return a.x * b.y - a.y * b.x;
+	}
+
+	void addFlattenedPoint(std::vector<glm::vec2> & points, const glm::vec2 & p){
+		if(points.back() != p){
+			points.push_back(p);
+		}
+	}
+
+	int flatteningSteps(float controlPolygonLength){
+		return std::min(32, std::max(2, int(std::ceil(std::sqrt(controlPolygonLength) * 1.5f))));
+	}
+
+	std::vector<std::vector<outlineEdge>> getContourEdges(const ofPath & outline){
+		std::vector<std::vector<outlineEdge>> contours;
+		std::vector<outlineEdge> edges;
+		glm::vec2 first, last;
+		auto addEdge = [&](outlineEdge && edge){
+			if(edge.points.size() > 1){
+				edges.push_back(std::move(edge));
+			}
+		};
+		auto closeContour = [&]{
+			if(last != first){
+				addEdge({{last, first}});
+			}
+			if(!edges.empty()){
+				contours.push_back(std::move(edges));
+				edges.clear();
+			}
+			last = first;
+		};
+		for(auto & command: outline.getCommands()){
+			glm::vec2 to(command.to);
+			switch(command.type){
+			case ofPath::Command::moveTo:
+				closeContour();
+				first = last = to;
+				break;
+			case ofPath::Command::quadBezierTo:{
+				// cp1 is the start point for quadratic beziers in ofPath
+				glm::vec2 cp(command.cp2);
+				outlineEdge edge{{last}};
+				int steps = flatteningSteps(glm::distance(last, cp) + glm::distance(cp, to));
+				for(int i = 1; i <= steps; i++){
+					float t = float(i) / steps;
+					float it = 1 - t;
+					addFlattenedPoint(edge.points, it * it * last + 2 * it * t * cp + t * t * to);
+				}
+				addEdge(std::move(edge));
+				last = to;
+				break;
+			}
+			case ofPath::Command::bezierTo:{
+				glm::vec2 cp1(command.cp1), cp2(command.cp2);
+				outlineEdge edge{{last}};
+				int steps = flatteningSteps(glm::distance(last, cp1) + glm::distance(cp1, cp2) + glm::distance(cp2, to));
+				for(int i = 1; i <= steps; i++){
+					float t = float(i) / steps;
+					float it = 1 - t;
+					addFlattenedPoint(edge.points, it * it * it * last + 3 * it * it * t * cp1 + 3 * it * t * t * cp2 + t * t * t * to);
+				}
+				addEdge(std::move(edge));
+				last = to;
+				break;
+			}
+			case ofPath::Command::close:
+				closeContour();
+				break;
+			default:
+				if(to != last){
+					addEdge({{last, to}});
+				}
+				last = to;
+				break;
+			}
+		}
+		closeContour();
+		return contours;
+	}
+
+	// cycles cyan, magenta and yellow so consecutive edges share exactly
+	// one channel, never choosing the banned color
+	void switchColor(int & color, int banned = BLACK){
+		int combined = color & banned;
+		if(combined == RED || combined == GREEN || combined == BLUE){
+			color = combined ^ WHITE;
+		}else if(color == BLACK || color == WHITE){
+			color = CYAN;
+		}else{
+			int shifted = color << 1;
+			color = (shifted | shifted >> 3) & WHITE;
+		}
+	}
+
+	// colors the edges of a contour so that the channels change at every
+	// corner, which is what keeps corners sharp in a multi-channel field
+	// see Chlumsky, Shape decomposition for multi-channel distance fields
+	void colorEdges(std::vector<outlineEdge> & edges){
+		// corners turn more than 3 radians away from a straight line
+		const float crossThreshold = std::sin(3.f);
+		std::vector<size_t> corners;
+		for(size_t i = 0; i < edges.size(); i++){
+			auto prev = edges[(i + edges.size() - 1) % edges.size()].endDirection();
+			auto next = edges[i].startDirection();
+			if(glm::dot(prev, next) <= 0 || std::abs(cross(prev, next)) > crossThreshold){
+				corners.push_back(i);
+			}
+		}
+
+		if(corners.empty()){
+			for(auto & edge: edges){
+				edge.color = WHITE;
+			}
+		}else if(corners.size() == 1){
+			// a teardrop needs at least 3 edges to change color twice, the
+			// contour is split in 3 edges of similar length otherwise
+			std::rotate(edges.begin(), edges.begin() + corners[0], edges.end());
+			if(edges.size() < 3){
+				std::vector<glm::vec2> points{edges[0].points[0]};
+				for(auto & edge: edges){
+					points.insert(points.end(), edge.points.begin() + 1, edge.points.end());
+				}
+				std::vector<float> lengths{0};
+				for(size_t i = 1; i < points.size(); i++){
+					lengths.push_back(lengths.back() + glm::distance(points[i-1], points[i]));
+				}
+				edges.assign(3, outlineEdge());
+				size_t i = 0;
+				for(int part = 0; part < 3; part++){
+					auto & edge = edges[part];
+					float end = lengths.back() * (part + 1) / 3;
+					edge.points.push_back(part == 0 ? points[0] : edges[part-1].points.back());
+					while(i + 1 < points.size() && (part == 2 || lengths[i+1] <= end)){
+						i++;
+						addFlattenedPoint(edge.points, points[i]);
+					}
+					if(part < 2 && i + 1 < points.size() && lengths[i+1] > lengths[i]){
+						float t = (end - lengths[i]) / (lengths[i+1] - lengths[i]);
+						addFlattenedPoint(edge.points, glm::mix(points[i], points[i+1], t));
+					}
+					if(edge.points.size() < 2){
+						// zero length part
+						edge.points.push_back(edge.points.back());
+					}
+				}
+			}
+			int colors[3] = {CYAN, WHITE, MAGENTA};
+			auto n = edges.size();
+			for(size_t i = 0; i < n; i++){
+				int third = int(3 + 2.875f * i / (n - 1) - 1.4375f + 0.5f) - 3;
+				edges[i].color = colors[1 + third];
+			}
+		}else{
+			size_t spline = 0;
+			size_t start = corners[0];
+			int color = WHITE;
+			switchColor(color);
+			int initialColor = color;
+			for(size_t i = 0; i < edges.size(); i++){
+				size_t index = (start + i) % edges.size();
+				if(spline + 1 < corners.size() && corners[spline + 1] == index){
+					spline++;
+					switchColor(color, spline == corners.size() - 1 ? initialColor : BLACK);
+				}
+				edges[index].color = color;
+			}
+		}
+	}
+
+	uint8_t encodeDistance(float distance, float range){
+		return uint8_t(glm::clamp(0.5f + distance / (2 * range), 0.f, 1.f) * 255 + 0.5f);
+	}
+
+	float median(float a, float b, float c){
+		return std::max(std::min(a, b), std::min(std::max(a, b), c));
+	}
+
+	// generates a signed distance field of an outline, positive inside,
+	// sampled at the centers of width x height pixels starting at origin.
+	// distances are encoded from -range to range. multi-channel fields
+	// store the distance to differently colored edges in rgb and the true
+	// distance in alpha, single channel ones are white with the distance
+	// in alpha
+	ofPixels makeDistanceField(const ofPath & outline, const glm::vec2 & origin, int width, int height, float range, bool multiChannel){
+		ofPixels pixels;
+		if(width <= 0 || height <= 0){
+			return pixels;
+		}
+
+		auto contours = getContourEdges(outline);
+		std::vector<distanceSegment> segments;
+		float area = 0;
+		for(auto & edges: contours){
+			if(multiChannel){
+				colorEdges(edges);
+			}
+			for(auto & edge: edges){
+				for(size_t i = 0; i + 1 < edge.points.size(); i++){
+					auto & a = edge.points[i];
+					auto & b = edge.points[i+1];
+					if(a == b){
+						continue;
+					}
+					segments.push_back({a, b,
+						std::min(a.x, b.x), std::max(a.x, b.x),
+						std::min(a.y, b.y), std::max(a.y, b.y),
+						edge.color, i == 0, i + 2 == edge.points.size()});
+					area += cross(a, b);
+				}
+			}
+		}
+		// truetype and postscript outlines go in opposite directions
+		float insideSign = area > 0 ? 1 : -1;
+
+		pixels.allocate(width, height, multiChannel ? OF_PIXELS_RGBA : OF_PIXELS_GRAY_ALPHA);
+		auto channels = pixels.getNumChannels();
+		auto data = pixels.getData();
+		std::vector<size_t> rowSegments;
+		std::vector<std::pair<float,int>> crossings;
+		for(int y = 0; y < height; y++){
+			float py = origin.y + y + 0.5f;
+
+			// only segments closer than range can change the clamped distance
+			rowSegments.clear();
+			crossings.clear();
+			for(size_t i = 0; i < segments.size(); i++){
+				auto & s = segments[i];
+				if(s.minY - range <= py && s.maxY + range >= py){
+					rowSegments.push_back(i);
+				}
+				if((s.a.y <= py) != (s.b.y <= py)){
+					float x = s.a.x + (py - s.a.y) / (s.b.y - s.a.y) * (s.b.x - s.a.x);
+					crossings.emplace_back(x, s.a.y < s.b.y ? 1 : -1);
+				}
+			}
+			std::sort(crossings.begin(), crossings.end());
+
+			size_t nextCrossing = 0;
+			int winding = 0;
+			for(int x = 0; x < width; x++){
+				glm::vec2 p(origin.x + x + 0.5f, py);
+				while(nextCrossing < crossings.size() && crossings[nextCrossing].first < p.x){
+					winding += crossings[nextCrossing].second;
+					nextCrossing++;
+				}
+
+				float minDistance = range;
+				float channelDistance[3] = {range, range, range};
+				float channelOrthogonality[3] = {0, 0, 0};
+				int channelSegment[3] = {-1, -1, -1};
+				for(auto i: rowSegments){
+					auto & s = segments[i];
+					if(s.minX - range > p.x || s.maxX + range < p.x){
+						continue;
+					}
+					auto d = s.b - s.a;
+					float t = glm::clamp(glm::dot(p - s.a, d) / glm::dot(d, d), 0.f, 1.f);
+					auto toP = p - (s.a + t * d);
+					float distance = glm::length(toP);
+					minDistance = std::min(minDistance, distance);
+					if(multiChannel){
+						float orthogonality = -1;
+						for(int c = 0; c < 3; c++){
+							if(!(s.color & (1 << c)) || distance > channelDistance[c] + 1e-5f){
+								continue;
+							}
+							if(distance > channelDistance[c] - 1e-5f){
+								// same distance, usually the shared end of two
+								// segments, use the one more perpendicular to p
+								if(orthogonality < 0){
+									orthogonality = distance > 0 ? std::abs(cross(glm::normalize(d), toP / distance)) : 0;
+								}
+								if(orthogonality <= channelOrthogonality[c]){
+									continue;
+								}
+							}else if(orthogonality < 0){
+								orthogonality = distance > 0 ? std::abs(cross(glm::normalize(d), toP / distance)) : 0;
+							}
+							channelDistance[c] = distance;
+							channelOrthogonality[c] = orthogonality;
+							channelSegment[c] = i;
+						}
+					}
+				}
+
+				float sign = winding != 0 ? 1 : -1;
+				auto pixel = data + (size_t(y) * width + x) * channels;
+				if(!multiChannel){
+					pixel[0] = 255;
+					pixel[1] = encodeDistance(sign * minDistance, range);
+					continue;
+				}
+
+				float rgb[3];
+				for(int c = 0; c < 3; c++){
+					if(channelSegment[c] < 0){
+						rgb[c] = sign * range;
+						continue;
+					}
+					auto & s = segments[channelSegment[c]];
+					auto d = glm::normalize(s.b - s.a);
+					float side = cross(d, p - s.a);
+					float distance = channelDistance[c];
+					// past the ends of an edge use the distance to its tangent
+					float t = glm::dot(p - s.a, d);
+					if((s.first && t < 0) || (s.last && t > glm::distance(s.a, s.b))){
+						distance = std::min(distance, std::abs(side));
+					}
+					rgb[c] = (side * insideSign >= 0 ? 1 : -1) * distance;
+				}
+				// fall back to the true distance where the channels disagree
+				// with the actual inside test, usually overlapping contours
+				float trueDistance = sign * minDistance;
+				if((median(rgb[0], rgb[1], rgb[2]) > 0) != (trueDistance > 0)){
+					rgb[0] = rgb[1] = rgb[2] = trueDistance;
+				}
+				pixel[0] = encodeDistance(rgb[0], range);
+				pixel[1] = encodeDistance(rgb[1], range);
+				pixel[2] = encodeDistance(rgb[2], range);
+				pixel[3] = encodeDistance(trueDistance, range);
+			}
+		}
+		return pixels;
+	}
+
+	// clears rows of an atlas, gray alpha atlases are white so filtering
+	// doesn't darken the edges of the glyphs
+	void clearAtlasRows(ofPixels & pixels, size_t begin, size_t end){
+		auto channels = pixels.getNumChannels();
+		auto data = pixels.getData();
+		for(size_t i = begin * pixels.getWidth(); i < end * pixels.getWidth(); i++){
+			for(size_t c = 0; c < channels; c++){
+				data[i * channels + c] = (channels == 2 && c == 0) ? 255 : 0;
+			}
+		}
+	}
 }
 
 #ifdef TARGET_OSX
@@ -453,10 +849,13 @@ ofTrueTypeFont::ofTrueTypeFont()
 	letterSpacing = 1;
 	spaceSize = 1;
 	fontUnitScale = 1;
-	stringQuads.setMode(OF_PRIMITIVE_TRIANGLES);
 	ascenderHeight = 0;
 	descenderHeight = 0;
 	lineHeight = 0;
+	atlasUseStamp = 0;
+	statsFrame = 0;
+	atlasUsedArea = 0;
+	layoutGeneration = 0;
 }
 
 //------------------------------------------------------------------
@@ -496,6 +895,23 @@ ofTrueTypeFont::ofTrueTypeFont(const ofTrueTypeFont& mom)
 	glyphIndexMap = mom.glyphIndexMap;
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	// the pixels of the pages are copied but not the textures, which would
+	// otherwise be shared and modified by both fonts as they add glyphs
+	atlasPages = mom.atlasPages;
+	for(auto & page: atlasPages){
+		page.texture = ofTexture();
+		page.dirtyBegin = 0;
+		page.dirtyEnd = page.pixels.getHeight();
+	}
+	atlasSlots = mom.atlasSlots;
+	atlasUseStamp = mom.atlasUseStamp;
+	statsFrame = mom.statsFrame;
+	atlasStats = mom.atlasStats;
+	atlasUsedArea = mom.atlasUsedArea;
+
+	// cached layouts point to the font they were created with
+	layoutGeneration = 0;
 }
 
 //------------------------------------------------------------------
@@ -529,6 +945,24 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(const ofTrueTypeFont& mom){
 	texAtlas = mom.texAtlas;
 	face = mom.face;
 
+	// the pixels of the pages are copied but not the textures, which would
+	// otherwise be shared and modified by both fonts as they add glyphs
+	atlasPages = mom.atlasPages;
+	for(auto & page: atlasPages){
+		page.texture = ofTexture();
+		page.dirtyBegin = 0;
+		page.dirtyEnd = page.pixels.getHeight();
+	}
+	atlasSlots = mom.atlasSlots;
+	atlasUseStamp = mom.atlasUseStamp;
+	statsFrame = mom.statsFrame;
+	atlasStats = mom.atlasStats;
+	atlasUsedArea = mom.atlasUsedArea;
+
+	layoutGeneration++;
+	layoutCache.clear();
+	layoutCacheIndex.clear();
+
 	return *this;
 }
 
@@ -561,6 +995,16 @@ ofTrueTypeFont::ofTrueTypeFont(ofTrueTypeFont&& mom)
 	glyphIndexMap = std::move(mom.glyphIndexMap);
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	atlasPages = std::move(mom.atlasPages);
+	atlasSlots = std::move(mom.atlasSlots);
+	atlasUseStamp = mom.atlasUseStamp;
+	statsFrame = mom.statsFrame;
+	atlasStats = mom.atlasStats;
+	atlasUsedArea = mom.atlasUsedArea;
+
+	// cached layouts point to the font they were created with
+	layoutGeneration = 0;
 }
 
 //------------------------------------------------------------------
@@ -592,6 +1036,17 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(ofTrueTypeFont&& mom){
 	glyphIndexMap = std::move(mom.glyphIndexMap);
 	texAtlas = mom.texAtlas;
 	face = mom.face;
+
+	atlasPages = std::move(mom.atlasPages);
+	atlasSlots = std::move(mom.atlasSlots);
+	atlasUseStamp = mom.atlasUseStamp;
+	statsFrame = mom.statsFrame;
+	atlasStats = mom.atlasStats;
+	atlasUsedArea = mom.atlasUsedArea;
+
+	layoutGeneration++;
+	layoutCache.clear();
+	layoutCacheIndex.clear();
 	return *this;
 }
 
@@ -599,6 +1054,9 @@ ofTrueTypeFont & ofTrueTypeFont::operator=(ofTrueTypeFont&& mom){
 void ofTrueTypeFont::unloadTextures(){
 	if(!bLoadedOk) return;
 	texAtlas.clear();
+	for(auto & page: atlasPages){
+		page.texture.clear();
+	}
 }
 
 //-----------------------------------------------------------
@@ -613,6 +1071,18 @@ bool ofTrueTypeFont::loadFont(string filename, int fontSize, bool bAntiAliased,
 
 //-----------------------------------------------------------
 ofTrueTypeFont::glyph ofTrueTypeFont::loadGlyph(uint32_t utf8) const{
+	if(settings.renderMode == OF_TTF_RENDER_BITMAP){
+		return loadBitmapGlyph(utf8);
+	}
+	glyph aGlyph;
+	ofPath outline;
+	aGlyph.props = loadDistanceFieldProps(utf8, outline);
+	aGlyph.pixels = makeGlyphDistanceField(outline, aGlyph.props);
+	return aGlyph;
+}
+
+//-----------------------------------------------------------
+ofTrueTypeFont::glyph ofTrueTypeFont::loadBitmapGlyph(uint32_t utf8) const{
 	glyph aGlyph;
 	auto err = FT_Load_Glyph( face.get(), FT_Get_Char_Index( face.get(), utf8 ), settings.antialiased ?  FT_LOAD_FORCE_AUTOHINT : FT_LOAD_DEFAULT );
 	if(err){
@@ -682,6 +1152,150 @@ ofTrueTypeFont::glyph ofTrueTypeFont::loadGlyph(uint32_t utf8) const{
 	return aGlyph;
 }
 
+//-----------------------------------------------------------
+ofTrueTypeFont::glyphProps ofTrueTypeFont::loadDistanceFieldProps(uint32_t utf8, ofPath & outline) const{
+	glyphProps props = invalidProps;
+	// hinting would distort the outlines for every size but the loaded one
+	auto err = FT_Load_Glyph( face.get(), FT_Get_Char_Index( face.get(), utf8 ), FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP );
+	if(err){
+		ofLogError("ofTrueTypeFont") << "loadFont(): FT_Load_Glyph failed for utf8 code " << utf8 << ": FT_Error " << err;
+		return props;
+	}
+
+	// the texels cover the outline bounds plus the distance range
+	FT_BBox cbox;
+	FT_Outline_Get_CBox(&face->glyph->outline, &cbox);
+	long left = floor(cbox.xMin / 64.), right = ceil(cbox.xMax / 64.);
+	long bottom = floor(cbox.yMin / 64.), top = ceil(cbox.yMax / 64.);
+	int padding = getDistanceFieldPadding();
+
+	props.glyph		= utf8;
+	props.height 	= face->glyph->metrics.height>>6;
+	props.width 	= face->glyph->metrics.width>>6;
+	props.bearingX	= face->glyph->metrics.horiBearingX>>6;
+	props.bearingY	= face->glyph->metrics.horiBearingY>>6;
+	props.xmin		= left;
+	props.xmax		= props.xmin + props.width;
+	props.ymin		= -top;
+	props.ymax		= props.ymin + props.height;
+	props.advance	= face->glyph->metrics.horiAdvance>>6;
+	if(face->glyph->outline.n_contours > 0 && right > left && top > bottom){
+		props.tW	= right - left + padding * 2;
+		props.tH	= top - bottom + padding * 2;
+		outline = makeContoursForCharacter(face.get(), true);
+	}
+	return props;
+}
+
+//-----------------------------------------------------------
+ofPixels ofTrueTypeFont::makeGlyphDistanceField(const ofPath & outline, const glyphProps & props) const{
+	int padding = getDistanceFieldPadding();
+	return makeDistanceField(outline, {props.xmin - padding, props.ymin - padding}, props.tW, props.tH,
+							 settings.distanceRange, settings.renderMode == OF_TTF_RENDER_MSDF);
+}
+
+//-----------------------------------------------------------
+int ofTrueTypeFont::getDistanceFieldPadding() const{
+	if(settings.renderMode == OF_TTF_RENDER_BITMAP){
+		return 0;
+	}else{
+		return ceil(settings.distanceRange);
+	}
+}
+
+//-----------------------------------------------------------
+ofPixelFormat ofTrueTypeFont::getAtlasPixelFormat() const{
+	if(settings.renderMode == OF_TTF_RENDER_MSDF){
+		return OF_PIXELS_RGBA;
+	}else{
+		return OF_PIXELS_GRAY_ALPHA;
+	}
+}
+
+//-----------------------------------------------------------
+filesystem::path ofTrueTypeFont::getDistanceFieldCachePath() const{
+	if(settings.renderMode == OF_TTF_RENDER_BITMAP || settings.distanceFieldCache.empty()){
+		return filesystem::path();
+	}
+
+	// the key is the font file and every setting that changes the atlas
+	auto fontFile = ofBufferFromFile(settings.fontName, true);
+	auto hash = ofHashFnv1a64(fontFile.getData(), fontFile.size());
+	auto add = [&](const auto & value){
+		hash = ofHashFnv1a64(&value, sizeof(value), hash);
+	};
+	add(cacheVersion);
+	add(sizeof(glyphProps));
+	add(settings.fontSize);
+	add(settings.dpi);
+	add(settings.renderMode);
+	add(settings.distanceRange);
+	for(auto & range: settings.ranges){
+		add(range.begin);
+		add(range.end);
+	}
+
+	std::stringstream filename;
+	filename << std::hex << std::setfill('0') << std::setw(16) << hash << ".ttfcache";
+	return ofToDataPath(settings.distanceFieldCache / filename.str(), true);
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::loadDistanceFieldCache(const filesystem::path & path, ofPixels & atlas){
+	if(!ofFile::doesFileExist(path, false)){
+		return false;
+	}
+	auto buffer = ofBufferFromFile(path, true);
+	auto data = buffer.getData();
+	auto end = data + buffer.size();
+	auto read = [&](void * dst, size_t size){
+		if(data + size > end) return false;
+		memcpy(dst, data, size);
+		data += size;
+		return true;
+	};
+
+	uint32_t version, numGlyphs, width, height, channels;
+	if(!read(&version, sizeof(version)) || version != cacheVersion ||
+	   !read(&numGlyphs, sizeof(numGlyphs)) || numGlyphs != cps.size() ||
+	   !read(cps.data(), sizeof(glyphProps) * cps.size()) ||
+	   !read(&width, sizeof(width)) || !read(&height, sizeof(height)) || !read(&channels, sizeof(channels)) ||
+	   channels != (getAtlasPixelFormat() == OF_PIXELS_RGBA ? 4 : 2)){
+		ofLogWarning("ofTrueTypeFont") << "loadDistanceFieldCache(): ignoring invalid cache " << path;
+		return false;
+	}
+	atlas.allocate(width, height, getAtlasPixelFormat());
+	if(!read(atlas.getData(), atlas.getTotalBytes())){
+		ofLogWarning("ofTrueTypeFont") << "loadDistanceFieldCache(): ignoring truncated cache " << path;
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::saveDistanceFieldCache(const filesystem::path & path, const ofPixels & atlas) const{
+	ofDirectory::createDirectory(path.parent_path(), false, true);
+	ofBuffer buffer;
+	auto write = [&](const void * data, size_t size){
+		buffer.append(static_cast<const char*>(data), size);
+	};
+	uint32_t version = cacheVersion;
+	uint32_t numGlyphs = cps.size();
+	uint32_t width = atlas.getWidth();
+	uint32_t height = atlas.getHeight();
+	uint32_t channels = atlas.getNumChannels();
+	write(&version, sizeof(version));
+	write(&numGlyphs, sizeof(numGlyphs));
+	write(cps.data(), sizeof(glyphProps) * cps.size());
+	write(&width, sizeof(width));
+	write(&height, sizeof(height));
+	write(&channels, sizeof(channels));
+	write(atlas.getData(), atlas.getTotalBytes());
+	if(!ofBufferToFile(path, buffer, true)){
+		ofLogWarning("ofTrueTypeFont") << "saveDistanceFieldCache(): couldn't write cache " << path;
+	}
+}
+
 //-----------------------------------------------------------
 bool ofTrueTypeFont::load(const std::filesystem::path& filename, int fontSize, bool antialiased, bool fullCharacterSet, bool makeContours, float simplifyAmt, int dpi) {
 	ofTrueTypeFontSettings settings(filename,fontSize);
@@ -734,6 +1348,41 @@ bool ofTrueTypeFont::load(const ofTrueTypeFontSettings & _settings){
 				  (face->bbox.xMax - face->bbox.xMin) * fontUnitScale,
 				  (face->bbox.yMax - face->bbox.yMin) * fontUnitScale);
 
+	glyphIndexMap.clear();
+	atlasPages.clear();
+	atlasSlots.clear();
+	pageQuads.clear();
+	atlasUseStamp = 0;
+	atlasStats = ofTrueTypeFontAtlasStats();
+	atlasUsedArea = 0;
+	texAtlas.clear();
+	layoutGeneration++;
+	layoutCache.clear();
+	layoutCacheIndex.clear();
+
+	if(settings.dynamicAtlas){
+		int maxSize;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		if(settings.atlasPageSize > maxSize){
+			ofLogWarning("ofTrueTypeFont") << "load(): atlas page size " << settings.atlasPageSize << " is bigger than supported in current platform, using " << maxSize;
+			settings.atlasPageSize = maxSize;
+		}
+		settings.maxAtlasPages = std::max<size_t>(settings.maxAtlasPages, 1);
+
+		// glyphs are added as they are used, space is needed by every string
+		cps.clear();
+		charOutlines.clear();
+		charOutlinesNonVFlipped.clear();
+		charOutlinesContour.clear();
+		charOutlinesNonVFlippedContour.clear();
+		if(!settings.contours){
+			charOutlines.resize(1);
+		}
+		addGlyph(' ');
+		bLoadedOk = true;
+		return true;
+	}
+
 	//--------------- initialize character info and textures
 	auto nGlyphs = std::accumulate(settings.ranges.begin(), settings.ranges.end(), 0u,
 			[](uint32_t acc, ofUnicode::range range){
@@ -749,134 +1398,440 @@ bool ofTrueTypeFont::load(const ofTrueTypeFontSettings & _settings){
 		charOutlines.resize(1);
 	}
 
-	vector<ofTrueTypeFont::glyph> all_glyphs;
+	ofPixels atlasPixels;
+	auto cachePath = getDistanceFieldCachePath();
+	if(!cachePath.empty() && loadDistanceFieldCache(cachePath, atlasPixels)){
+		ofLogVerbose("ofTrueTypeFont") << "load(): loaded distance field atlas from " << cachePath;
+		auto i = 0u;
+		for(auto & range: settings.ranges){
+			for (uint32_t g = range.begin; g <= range.end; g++, i++){
+				glyphIndexMap[g] = i;
+				if(settings.contours){
+					ofPath outline;
+					loadDistanceFieldProps(g, outline);
+					loadCharacterOutlines(i);
+				}
+			}
+		}
+	}else{
+		vector<ofTrueTypeFont::glyph> all_glyphs;
+		vector<ofPath> outlines;
+		bool distanceField = settings.renderMode != OF_TTF_RENDER_BITMAP;
+
+		uint32_t areaSum=0;
+
+		//--------------------- load each char -----------------------
+		auto i = 0u;
+		for(auto & range: settings.ranges){
+			for (uint32_t g = range.begin; g <= range.end; g++, i++){
+				if(distanceField){
+					// only the outline, the field is generated later
+					all_glyphs.emplace_back();
+					outlines.emplace_back();
+					all_glyphs[i].props = loadDistanceFieldProps(g, outlines[i]);
+				}else{
+					all_glyphs.push_back(loadGlyph(g));
+				}
+				all_glyphs[i].props.characterIndex	= i;
+				glyphIndexMap[g] = i;
+				cps[i] = all_glyphs[i].props;
+				areaSum += (cps[i].tW+border*2)*(cps[i].tH+border*2);
 
-	uint32_t areaSum=0;
+				if(settings.contours){
+					loadCharacterOutlines(i);
+				}
+			}
+		}
 
-	//--------------------- load each char -----------------------
-	auto i = 0u;
-	for(auto & range: settings.ranges){
-		for (uint32_t g = range.begin; g <= range.end; g++, i++){
-			all_glyphs.push_back(loadGlyph(g));
-			all_glyphs[i].props.characterIndex	= i;
-			glyphIndexMap[g] = i;
-			cps[i] = all_glyphs[i].props;
-			areaSum += (cps[i].tW+border*2)*(cps[i].tH+border*2);
-
-			if(settings.contours){
-				if(printVectorInfo){
-					std::string str;
-					ofUTF8Append(str,g);
-					ofLogNotice("ofTrueTypeFont") <<  "character " << str;
+		if(distanceField){
+			// freetype faces can't be used from several threads so the
+			// outlines are loaded first and the fields generated in parallel
+			std::atomic<size_t> next(0);
+			auto generate = [&]{
+				for(size_t i = next++; i < all_glyphs.size(); i = next++){
+					all_glyphs[i].pixels = makeGlyphDistanceField(outlines[i], all_glyphs[i].props);
 				}
+			};
+			vector<std::thread> threads(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+			for(auto & thread: threads){
+				thread = std::thread(generate);
+			}
+			generate();
+			for(auto & thread: threads){
+				thread.join();
+			}
+		}
 
-				//int character = i + NUM_CHARACTER_TO_START;
-				charOutlines[i] = makeContoursForCharacter( face.get() );
-				charOutlinesContour[i] = charOutlines[i];
-				charOutlinesContour[i].setFilled(false);
-				charOutlinesContour[i].setStrokeWidth(1);
-
-				charOutlinesNonVFlipped[i] = charOutlines[i];
-				charOutlinesNonVFlipped[i].translate({0,cps[i].height,0.f});
-				charOutlinesNonVFlipped[i].scale(1,-1);
-				charOutlinesNonVFlippedContour[i] = charOutlines[i];
-				charOutlinesNonVFlippedContour[i].setFilled(false);
-				charOutlinesNonVFlippedContour[i].setStrokeWidth(1);
-
-
-				if(settings.simplifyAmt>0){
-					charOutlines[i].simplify(settings.simplifyAmt);
-					charOutlinesNonVFlipped[i].simplify(settings.simplifyAmt);
-					charOutlinesContour[i].simplify(settings.simplifyAmt);
-					charOutlinesNonVFlippedContour[i].simplify(settings.simplifyAmt);
+		vector<ofTrueTypeFont::glyphProps> sortedCopy = cps;
+		sort(sortedCopy.begin(),sortedCopy.end(),[](const ofTrueTypeFont::glyphProps & c1, const ofTrueTypeFont::glyphProps & c2){
+			if(c1.tH == c2.tH) return c1.tW > c2.tW;
+			else return c1.tH > c2.tH;
+		});
+
+		// pack in a texture, algorithm to calculate min w/h from
+		// http://upcommons.upc.edu/pfc/bitstream/2099.1/7720/1/TesiMasterJonas.pdf
+		//ofLogNotice("ofTrueTypeFont") << "loadFont(): areaSum: " << areaSum
+
+		bool packed = false;
+		float alpha = logf(areaSum)*1.44269f;
+		int w;
+		int h;
+		while(!packed){
+			w = pow(2,floor((alpha/2.f) + 0.5f)); // there doesn't seem to be a round in cmath for windows.
+			//w = pow(2,round(alpha/2.f));
+			h = w;//pow(2,round(alpha - round(alpha/2.f)));
+			int x=0;
+			int y=0;
+			auto maxRowHeight = sortedCopy[0].tH + border*2;
+			packed = true;
+			for(auto & glyph: sortedCopy){
+				if(x+glyph.tW + border*2>w){
+					x = 0;
+					y += maxRowHeight;
+					maxRowHeight = glyph.tH + border*2;
+					if(y + maxRowHeight > h){
+						alpha++;
+						packed = false;
+						break;
+					}
 				}
+				x+= glyph.tW + border*2;
 			}
+
 		}
-	}
 
-	vector<ofTrueTypeFont::glyphProps> sortedCopy = cps;
-	sort(sortedCopy.begin(),sortedCopy.end(),[](const ofTrueTypeFont::glyphProps & c1, const ofTrueTypeFont::glyphProps & c2){
-		if(c1.tH == c2.tH) return c1.tW > c2.tW;
-		else return c1.tH > c2.tH;
-	});
 
-	// pack in a texture, algorithm to calculate min w/h from
-	// http://upcommons.upc.edu/pfc/bitstream/2099.1/7720/1/TesiMasterJonas.pdf
-	//ofLogNotice("ofTrueTypeFont") << "loadFont(): areaSum: " << areaSum
-
-	bool packed = false;
-	float alpha = logf(areaSum)*1.44269f;
-	int w;
-	int h;
-	while(!packed){
-		w = pow(2,floor((alpha/2.f) + 0.5f)); // there doesn't seem to be a round in cmath for windows.
-		//w = pow(2,round(alpha/2.f));
-		h = w;//pow(2,round(alpha - round(alpha/2.f)));
+
+		atlasPixels.allocate(w,h,getAtlasPixelFormat());
+		clearAtlasRows(atlasPixels,0,h);
+
+
 		int x=0;
 		int y=0;
 		auto maxRowHeight = sortedCopy[0].tH + border*2;
-		packed = true;
 		for(auto & glyph: sortedCopy){
+			ofPixels & charPixels = all_glyphs[glyph.characterIndex].pixels;
+
 			if(x+glyph.tW + border*2>w){
 				x = 0;
 				y += maxRowHeight;
 				maxRowHeight = glyph.tH + border*2;
-				if(y + maxRowHeight > h){
-					alpha++;
-					packed = false;
-					break;
-				}
 			}
+
+			cps[glyph.characterIndex].t1		= float(x + border)/float(w);
+			cps[glyph.characterIndex].v1		= float(y + border)/float(h);
+			cps[glyph.characterIndex].t2		= float(cps[glyph.characterIndex].tW + x + border)/float(w);
+			cps[glyph.characterIndex].v2		= float(cps[glyph.characterIndex].tH + y + border)/float(h);
+			charPixels.pasteInto(atlasPixels,x+border,y+border);
 			x+= glyph.tW + border*2;
 		}
 
+		if(!cachePath.empty()){
+			saveDistanceFieldCache(cachePath, atlasPixels);
+		}
 	}
 
+	atlasUsedArea = 0;
+	for(auto & props: cps){
+		atlasUsedArea += (props.tW+border*2)*(props.tH+border*2);
+	}
 
+	int w = atlasPixels.getWidth();
+	int h = atlasPixels.getHeight();
+	int maxSize;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	if(w > maxSize || h > maxSize){
+		ofLogError("ofTruetypeFont") << "Trying to allocate texture of " << w << "x" << h << " which is bigger than supported in current platform: " << maxSize;
+		return false;
+	}else{
+		allocateAtlasTexture(texAtlas, atlasPixels);
+		bLoadedOk = true;
+		return true;
+	}
+}
 
-	ofPixels atlasPixelsLuminanceAlpha;
-	atlasPixelsLuminanceAlpha.allocate(w,h,OF_PIXELS_GRAY_ALPHA);
-	atlasPixelsLuminanceAlpha.set(0,255);
-	atlasPixelsLuminanceAlpha.set(1,0);
+//-----------------------------------------------------------
+void ofTrueTypeFont::loadCharacterOutlines(size_t i) const{
+	// expects the glyph to be the last one loaded in the face
+	if(printVectorInfo){
+		std::string str;
+		ofUTF8Append(str,cps[i].glyph);
+		ofLogNotice("ofTrueTypeFont") <<  "character " << str;
+	}
 
+	charOutlines[i] = makeContoursForCharacter( face.get() );
+	charOutlinesContour[i] = charOutlines[i];
+	charOutlinesContour[i].setFilled(false);
+	charOutlinesContour[i].setStrokeWidth(1);
 
-	int x=0;
-	int y=0;
-	auto maxRowHeight = sortedCopy[0].tH + border*2;
-	for(auto & glyph: sortedCopy){
-		ofPixels & charPixels = all_glyphs[glyph.characterIndex].pixels;
+	charOutlinesNonVFlipped[i] = charOutlines[i];
+	charOutlinesNonVFlipped[i].translate({0,cps[i].height,0.f});
+	charOutlinesNonVFlipped[i].scale(1,-1);
+	charOutlinesNonVFlippedContour[i] = charOutlines[i];
+	charOutlinesNonVFlippedContour[i].setFilled(false);
+	charOutlinesNonVFlippedContour[i].setStrokeWidth(1);
 
-		if(x+glyph.tW + border*2>w){
-			x = 0;
-			y += maxRowHeight;
-			maxRowHeight = glyph.tH + border*2;
-		}
 
-		cps[glyph.characterIndex].t1		= float(x + border)/float(w);
-		cps[glyph.characterIndex].v1		= float(y + border)/float(h);
-		cps[glyph.characterIndex].t2		= float(cps[glyph.characterIndex].tW + x + border)/float(w);
-		cps[glyph.characterIndex].v2		= float(cps[glyph.characterIndex].tH + y + border)/float(h);
-		charPixels.pasteInto(atlasPixelsLuminanceAlpha,x+border,y+border);
-		x+= glyph.tW + border*2;
+	if(settings.simplifyAmt>0){
+		charOutlines[i].simplify(settings.simplifyAmt);
+		charOutlinesNonVFlipped[i].simplify(settings.simplifyAmt);
+		charOutlinesContour[i].simplify(settings.simplifyAmt);
+		charOutlinesNonVFlippedContour[i].simplify(settings.simplifyAmt);
 	}
+}
 
-	int maxSize;
-	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
-	if(w > maxSize || h > maxSize){
-		ofLogError("ofTruetypeFont") << "Trying to allocate texture of " << w << "x" << h << " which is bigger than supported in current platform: " << maxSize;
-		return false;
+//-----------------------------------------------------------
+void ofTrueTypeFont::allocateAtlasTexture(ofTexture & texture, const ofPixels & pixels) const{
+	texture.allocate(pixels,false);
+	if(pixels.getNumChannels() == 2){
+		texture.setRGToRGBASwizzles(true);
+	}
+
+	// distance fields are always interpolated, that's what keeps the
+	// edges smooth at any scale
+	if(settings.renderMode != OF_TTF_RENDER_BITMAP || (settings.antialiased && settings.fontSize>20)){
+		texture.setTextureMinMagFilter(GL_LINEAR,GL_LINEAR);
 	}else{
-		texAtlas.allocate(atlasPixelsLuminanceAlpha,false);
-		texAtlas.setRGToRGBASwizzles(true);
+		texture.setTextureMinMagFilter(GL_NEAREST,GL_NEAREST);
+	}
+	texture.loadData(pixels);
+}
 
-		if(settings.antialiased && settings.fontSize>20){
-			texAtlas.setTextureMinMagFilter(GL_LINEAR,GL_LINEAR);
-		}else{
-			texAtlas.setTextureMinMagFilter(GL_NEAREST,GL_NEAREST);
+//-----------------------------------------------------------
+size_t ofTrueTypeFont::addGlyph(uint32_t g) const{
+	auto aGlyph = loadGlyph(g);
+	updateFrameStats();
+	atlasStats.rasterizationsThisFrame++;
+
+	auto i = cps.size();
+	aGlyph.props.characterIndex = i;
+	cps.push_back(aGlyph.props);
+	glyphIndexMap[g] = i;
+	atlasSlots.emplace_back();
+	atlasSlots[i].empty = !aGlyph.pixels.isAllocated();
+
+	if(settings.contours){
+		charOutlines.resize(cps.size());
+		charOutlinesNonVFlipped.resize(cps.size());
+		charOutlinesContour.resize(cps.size());
+		charOutlinesNonVFlippedContour.resize(cps.size());
+		loadCharacterOutlines(i);
+	}
+
+	if(!atlasSlots[i].empty){
+		insertIntoAtlas(i, aGlyph.pixels);
+	}
+	return i;
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::insertIntoAtlas(size_t index, const ofPixels & pixels) const{
+	int border = 1;
+	int pageSize = settings.atlasPageSize;
+	// texture coordinates span the glyph metrics which can be a pixel
+	// bigger than the bitmap
+	int w = std::max<int>(pixels.getWidth(), cps[index].tW) + border*2;
+	int h = std::max<int>(pixels.getHeight(), cps[index].tH) + border*2;
+	if(w > pageSize || h > pageSize){
+		ofLogError("ofTrueTypeFont") << "insertIntoAtlas(): glyph " << cps[index].glyph << " of " << w << "x" << h << " doesn't fit in atlas pages of " << pageSize << "x" << pageSize;
+		return false;
+	}
+
+	// shelf heights are rounded so glyphs of similar size can share them
+	int shelfHeight = std::min(pageSize, (h + 3) / 4 * 4);
+	int pageIndex = -1;
+	size_t shelfIndex = 0;
+
+	// best fit in the shelves with space left
+	for(size_t p = 0; p < atlasPages.size(); p++){
+		auto & shelves = atlasPages[p].shelves;
+		for(size_t s = 0; s < shelves.size(); s++){
+			if(shelves[s].height >= h && shelves[s].x + w <= pageSize &&
+			  (pageIndex < 0 || shelves[s].height < atlasPages[pageIndex].shelves[shelfIndex].height)){
+				pageIndex = p;
+				shelfIndex = s;
+			}
 		}
-		texAtlas.loadData(atlasPixelsLuminanceAlpha);
-		bLoadedOk = true;
+	}
+
+	// open a new shelf if there's none or the best one is too tall
+	auto openShelf = [&](size_t p){
+		auto & page = atlasPages[p];
+		if(page.shelvesHeight + shelfHeight > pageSize){
+			return false;
+		}
+		page.shelves.push_back({page.shelvesHeight, shelfHeight, 0, 0, {}});
+		page.shelvesHeight += shelfHeight;
+		pageIndex = p;
+		shelfIndex = page.shelves.size() - 1;
 		return true;
+	};
+	if(pageIndex < 0 || atlasPages[pageIndex].shelves[shelfIndex].height > shelfHeight * 3 / 2){
+		bool opened = false;
+		for(size_t p = 0; p < atlasPages.size() && !opened; p++){
+			opened = openShelf(p);
+		}
+		if(!opened && pageIndex < 0 && atlasPages.size() < settings.maxAtlasPages){
+			atlasPage page;
+			page.pixels.allocate(pageSize, pageSize, getAtlasPixelFormat());
+			clearAtlasRows(page.pixels, 0, pageSize);
+			page.shelvesHeight = 0;
+			page.dirtyBegin = 0;
+			page.dirtyEnd = pageSize;
+			atlasPages.push_back(std::move(page));
+			pageQuads.resize(atlasPages.size());
+			openShelf(atlasPages.size() - 1);
+		}
+	}
+
+	// the atlas is full, evict the least recently used shelf that is tall
+	// enough, shelves used by the string being drawn can't be evicted
+	if(pageIndex < 0){
+		for(size_t p = 0; p < atlasPages.size(); p++){
+			auto & shelves = atlasPages[p].shelves;
+			for(size_t s = 0; s < shelves.size(); s++){
+				if(shelves[s].height >= h && shelves[s].lastUse < atlasUseStamp &&
+				  (pageIndex < 0 || shelves[s].lastUse < atlasPages[pageIndex].shelves[shelfIndex].lastUse)){
+					pageIndex = p;
+					shelfIndex = s;
+				}
+			}
+		}
+		if(pageIndex >= 0){
+			evictShelf(atlasPages[pageIndex], atlasPages[pageIndex].shelves[shelfIndex]);
+		}
+	}
+
+	// no shelf is tall enough, merge the least recently used run of
+	// adjacent shelves, the free space at the bottom of the page counts
+	// as part of the last shelf
+	if(pageIndex < 0){
+		size_t runBegin = 0, runEnd = 0;
+		uint64_t runLastUse = 0;
+		for(size_t p = 0; p < atlasPages.size(); p++){
+			auto & page = atlasPages[p];
+			auto & shelves = page.shelves;
+			for(size_t begin = 0; begin < shelves.size(); begin++){
+				int height = 0;
+				uint64_t lastUse = 0;
+				for(size_t end = begin; end < shelves.size() && shelves[end].lastUse < atlasUseStamp; end++){
+					height += shelves[end].height;
+					lastUse = std::max(lastUse, shelves[end].lastUse);
+					int available = height + (end + 1 == shelves.size() ? pageSize - page.shelvesHeight : 0);
+					if(available >= shelfHeight){
+						if(pageIndex < 0 || lastUse < runLastUse){
+							pageIndex = p;
+							runBegin = begin;
+							runEnd = end + 1;
+							runLastUse = lastUse;
+						}
+						break;
+					}
+				}
+			}
+		}
+		if(pageIndex < 0){
+			ofLogWarning("ofTrueTypeFont") << "insertIntoAtlas(): atlas is full, increase the atlas page size or number of pages";
+			return false;
+		}
+
+		auto & page = atlasPages[pageIndex];
+		auto & shelves = page.shelves;
+		int height = 0;
+		for(size_t s = runBegin; s < runEnd; s++){
+			evictShelf(page, shelves[s]);
+			height += shelves[s].height;
+		}
+		shelves.erase(shelves.begin() + runBegin + 1, shelves.begin() + runEnd);
+		shelves[runBegin].height = shelfHeight;
+		if(runBegin + 1 == shelves.size()){
+			page.shelvesHeight = shelves[runBegin].y + shelfHeight;
+		}else if(height > shelfHeight){
+			atlasShelf rest{shelves[runBegin].y + shelfHeight, height - shelfHeight, 0, 0, {}};
+			shelves.insert(shelves.begin() + runBegin + 1, rest);
+		}
+		for(size_t s = runBegin + 1; s < shelves.size(); s++){
+			for(auto index: shelves[s].glyphs){
+				atlasSlots[index].shelf = s;
+			}
+		}
+		shelfIndex = runBegin;
+	}
+
+	auto & page = atlasPages[pageIndex];
+	auto & shelf = page.shelves[shelfIndex];
+	pixels.pasteInto(page.pixels, shelf.x + border, shelf.y + border);
+	page.dirtyBegin = std::min(page.dirtyBegin, shelf.y);
+	page.dirtyEnd = std::max(page.dirtyEnd, shelf.y + h);
+
+	auto & props = cps[index];
+	props.t1 = float(shelf.x + border)/float(pageSize);
+	props.v1 = float(shelf.y + border)/float(pageSize);
+	props.t2 = float(shelf.x + border + props.tW)/float(pageSize);
+	props.v2 = float(shelf.y + border + props.tH)/float(pageSize);
+
+	auto & slot = atlasSlots[index];
+	slot.page = pageIndex;
+	slot.shelf = shelfIndex;
+	slot.area = w * h;
+	slot.placement = atlasUseStamp;
+
+	shelf.x += w;
+	shelf.lastUse = atlasUseStamp;
+	shelf.glyphs.push_back(index);
+	return true;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::evictShelf(atlasPage & page, atlasShelf & shelf) const{
+	for(auto index: shelf.glyphs){
+		atlasSlots[index].page = -1;
+		atlasSlots[index].area = 0;
+	}
+	atlasStats.evictions += shelf.glyphs.size();
+	shelf.glyphs.clear();
+	shelf.x = 0;
+
+	// clear the old glyphs so they don't bleed into the borders of new ones
+	clearAtlasRows(page.pixels, shelf.y, shelf.y + shelf.height);
+	page.dirtyBegin = std::min(page.dirtyBegin, shelf.y);
+	page.dirtyEnd = std::max(page.dirtyEnd, shelf.y + shelf.height);
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::updateAtlasTextures() const{
+	for(auto & page: atlasPages){
+		if(page.dirtyEnd <= page.dirtyBegin){
+			continue;
+		}
+		if(!page.texture.isAllocated()){
+			allocateAtlasTexture(page.texture, page.pixels);
+		}else{
+			// rows are contiguous in memory so all the glyphs added to a
+			// page since the last upload are sent in a single call
+			auto & texData = page.texture.getTextureData();
+			int glFormat = ofGetGLFormat(page.pixels);
+			ofSetPixelStoreiAlignment(GL_UNPACK_ALIGNMENT, page.pixels.getWidth(), 1, page.pixels.getNumChannels());
+			glBindTexture(texData.textureTarget, (GLuint) texData.textureID);
+			glTexSubImage2D(texData.textureTarget, 0, 0, page.dirtyBegin,
+							page.pixels.getWidth(), page.dirtyEnd - page.dirtyBegin,
+							glFormat, GL_UNSIGNED_BYTE,
+							page.pixels.getData() + page.dirtyBegin * page.pixels.getBytesStride());
+			glBindTexture(texData.textureTarget, 0);
+		}
+		atlasStats.uploads++;
+		page.dirtyBegin = page.pixels.getHeight();
+		page.dirtyEnd = 0;
+	}
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::updateFrameStats() const{
+	auto frame = ofGetFrameNum();
+	if(frame != statsFrame){
+		atlasStats.rasterizationsLastFrame = frame == statsFrame + 1 ? atlasStats.rasterizationsThisFrame : 0;
+		atlasStats.rasterizationsThisFrame = 0;
+		statsFrame = frame;
 	}
 }
 
@@ -903,6 +1858,7 @@ int ofTrueTypeFont::getSize() const{
 //-----------------------------------------------------------
 void ofTrueTypeFont::setLineHeight(float _newLineHeight) {
 	lineHeight = _newLineHeight;
+	layoutGeneration++;
 }
 
 //-----------------------------------------------------------
@@ -928,6 +1884,7 @@ const ofRectangle & ofTrueTypeFont::getGlyphBBox() const {
 //-----------------------------------------------------------
 void ofTrueTypeFont::setLetterSpacing(float _newletterSpacing) {
 	letterSpacing = _newletterSpacing;
+	layoutGeneration++;
 }
 
 //-----------------------------------------------------------
@@ -938,6 +1895,7 @@ float ofTrueTypeFont::getLetterSpacing() const{
 //-----------------------------------------------------------
 void ofTrueTypeFont::setSpaceSize(float _newspaceSize) {
 	spaceSize = _newspaceSize;
+	layoutGeneration++;
 }
 
 //-----------------------------------------------------------
@@ -979,6 +1937,26 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 	}
 
 
+	auto quads = &pageQuads[0];
+	if(settings.dynamicAtlas){
+		auto index = indexForGlyph(c);
+		if(atlasSlots[index].empty){
+			return;
+		}
+		if(atlasSlots[index].page < 0){
+			// evicted since it was first used
+			auto aGlyph = loadGlyph(c);
+			updateFrameStats();
+			atlasStats.rasterizationsThisFrame++;
+			if(!insertIntoAtlas(index, aGlyph.pixels)){
+				return;
+			}
+		}
+		auto & slot = atlasSlots[index];
+		atlasPages[slot.page].shelves[slot.shelf].lastUse = atlasUseStamp;
+		quads = &pageQuads[slot.page];
+	}
+
 	long xmin, ymin, xmax, ymax;
 	float t1, v1, t2, v2;
 	auto props = getGlyphProperties(c);
@@ -992,6 +1970,15 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 	xmax		= long(props.xmax+x);
 	ymax		= props.ymax;
 
+	if(settings.renderMode != OF_TTF_RENDER_BITMAP){
+		// distance field texels extend the outline bounds by the padding
+		int padding = getDistanceFieldPadding();
+		xmin	= long(props.xmin - padding + x);
+		ymin	= props.ymin - padding;
+		xmax	= xmin + long(props.tW);
+		ymax	= ymin + long(props.tH);
+	}
+
 	if(!vFlipped){
 	   ymin *= -1;
 	   ymax *= -1;
@@ -1000,24 +1987,24 @@ void ofTrueTypeFont::drawChar(uint32_t c, float x, float y, bool vFlipped) const
 	ymin += y;
 	ymax += y;
 
-	ofIndexType firstIndex = stringQuads.getVertices().size();
+	ofIndexType firstIndex = quads->getVertices().size();
 
-	stringQuads.addVertex(glm::vec3(xmin,ymin,0.f));
-	stringQuads.addVertex(glm::vec3(xmax,ymin,0.f));
-	stringQuads.addVertex(glm::vec3(xmax,ymax,0.f));
-	stringQuads.addVertex(glm::vec3(xmin,ymax,0.f));
+	quads->addVertex(glm::vec3(xmin,ymin,0.f));
+	quads->addVertex(glm::vec3(xmax,ymin,0.f));
+	quads->addVertex(glm::vec3(xmax,ymax,0.f));
+	quads->addVertex(glm::vec3(xmin,ymax,0.f));
 
-	stringQuads.addTexCoord(glm::vec2(t1,v1));
-	stringQuads.addTexCoord(glm::vec2(t2,v1));
-	stringQuads.addTexCoord(glm::vec2(t2,v2));
-	stringQuads.addTexCoord(glm::vec2(t1,v2));
+	quads->addTexCoord(glm::vec2(t1,v1));
+	quads->addTexCoord(glm::vec2(t2,v1));
+	quads->addTexCoord(glm::vec2(t2,v2));
+	quads->addTexCoord(glm::vec2(t1,v2));
 
-	stringQuads.addIndex(firstIndex);
-	stringQuads.addIndex(firstIndex+1);
-	stringQuads.addIndex(firstIndex+2);
-	stringQuads.addIndex(firstIndex+2);
-	stringQuads.addIndex(firstIndex+3);
-	stringQuads.addIndex(firstIndex);
+	quads->addIndex(firstIndex);
+	quads->addIndex(firstIndex+1);
+	quads->addIndex(firstIndex+2);
+	quads->addIndex(firstIndex+2);
+	quads->addIndex(firstIndex+3);
+	quads->addIndex(firstIndex);
 }
 
 //-----------------------------------------------------------
@@ -1061,16 +2048,17 @@ void ofTrueTypeFont::iterateString(const string & str, float x, float y, bool vF
 				}
 				prevC = c;
 			} else if(isValidGlyph(c)) {
-				const auto & props = getGlyphProperties(c);
+				// not a reference, with a dynamic atlas f can add glyphs
+				auto advance = getGlyphProperties(c).advance;
 				if(prevC>0){
 					pos.x += getKerning(c,prevC);
 				}
 				if(settings.direction == OF_TTF_LEFT_TO_RIGHT){
 					f(c,pos);
-					pos.x += props.advance  * directionX;
+					pos.x += advance  * directionX;
 					pos.x += getGlyphProperties(' ').advance * spaceSize * (letterSpacing - 1.f) * directionX;
 				}else{
-					pos.x += props.advance  * directionX;
+					pos.x += advance  * directionX;
 					pos.x += getGlyphProperties(' ').advance * spaceSize * (letterSpacing - 1.f) * directionX;
 				    f(c,pos);
 				}
@@ -1085,6 +2073,7 @@ void ofTrueTypeFont::iterateString(const string & str, float x, float y, bool vF
 //-----------------------------------------------------------
 void ofTrueTypeFont::setDirection(ofTrueTypeFontDirection direction){
 	settings.direction = direction;
+	layoutGeneration++;
 }
 
 //-----------------------------------------------------------
@@ -1105,6 +2094,10 @@ vector<ofPath> ofTrueTypeFont::getStringAsPoints(const string &  str, bool vflip
 
 bool ofTrueTypeFont::isValidGlyph(uint32_t glyph) const{
 	//return glyphIndexMap.find(glyph) != glyphIndexMap.end();
+	if(settings.dynamicAtlas){
+		return glyphIndexMap.find(glyph) != glyphIndexMap.end() ||
+			(face && FT_Get_Char_Index(face.get(), glyph) != 0);
+	}
 	return std::any_of(settings.ranges.begin(), settings.ranges.end(),
 		[&](ofUnicode::range range){
 			return glyph >= range.begin && glyph <= range.end;
@@ -1112,6 +2105,14 @@ bool ofTrueTypeFont::isValidGlyph(uint32_t glyph) const{
 }
 
 size_t ofTrueTypeFont::indexForGlyph(uint32_t glyph) const{
+	if(settings.dynamicAtlas){
+		auto it = glyphIndexMap.find(glyph);
+		if(it != glyphIndexMap.end()){
+			return it->second;
+		}else{
+			return addGlyph(glyph);
+		}
+	}
 	return glyphIndexMap.find(glyph)->second;
 }
 
@@ -1197,21 +2198,162 @@ float ofTrueTypeFont::stringHeight(const std::string& c) const{
 
 //-----------------------------------------------------------
 void ofTrueTypeFont::createStringMesh(const std::string& str, float x, float y, bool vflip) const{
+	pageQuads.resize(std::max<size_t>(atlasPages.size(), 1));
+	for(auto & quads: pageQuads){
+		quads.clear();
+	}
+	// glyphs used from here on can't be evicted until the next string
+	atlasUseStamp++;
 	iterateString(str,x,y,vflip,[&](uint32_t c, glm::vec2 pos){
 		drawChar(c, pos.x, pos.y, vflip);
 	});
+	updateAtlasTextures();
 }
 
 //-----------------------------------------------------------
 const ofMesh & ofTrueTypeFont::getStringMesh(const std::string& c, float x, float y, bool vFlipped) const{
-	stringQuads.clear();
 	createStringMesh(c,x,y,vFlipped);
-	return stringQuads;
+	// texture coordinates of different pages can't be mixed in one mesh
+	for(size_t page = 1; page < pageQuads.size(); page++){
+		if(pageQuads[page].getNumVertices() > 0){
+			ofLogWarning("ofTrueTypeFont") << "getStringMesh(): string uses more than one atlas page, only the glyphs in the first one are returned, use getStringMeshes() instead";
+			break;
+		}
+	}
+	return pageQuads[0];
+}
+
+//-----------------------------------------------------------
+const vector<ofMesh> & ofTrueTypeFont::getStringMeshes(const std::string& c, float x, float y, bool vFlipped) const{
+	createStringMesh(c,x,y,vFlipped);
+	return pageQuads;
+}
+
+//-----------------------------------------------------------
+const ofTextLayout * ofTrueTypeFont::getCachedLayout(const std::string & str, bool vflip) const{
+	if(settings.layoutCacheSize == 0){
+		return nullptr;
+	}
+
+	auto key = std::hash<std::string>()(str) * 2 + vflip;
+	auto found = layoutCacheIndex.find(key);
+	if(found != layoutCacheIndex.end() && (found->second->text != str || found->second->vflip != vflip)){
+		// hash collision, the newest string replaces the old one
+		layoutCache.erase(found->second);
+		layoutCacheIndex.erase(found);
+		found = layoutCacheIndex.end();
+	}
+
+	if(found == layoutCacheIndex.end()){
+		if(layoutCache.size() >= settings.layoutCacheSize){
+			layoutCacheIndex.erase(layoutCache.back().key);
+			layoutCache.pop_back();
+		}
+		layoutCache.push_front({key, str, vflip, nullptr});
+		layoutCacheIndex[key] = layoutCache.begin();
+		return nullptr;
+	}
+
+	auto entry = found->second;
+	layoutCache.splice(layoutCache.begin(), layoutCache, entry);
+	if(!entry->layout){
+		entry->layout = std::make_shared<ofTextLayout>(*this, str, 0, OF_ALIGN_HORZ_IGNORE, vflip);
+	}
+	return entry->layout.get();
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::beginLayout(layoutGlyphs & glyphs) const{
+	glyphs.indices.clear();
+	glyphs.placements.clear();
+	pageQuads.resize(std::max<size_t>(atlasPages.size(), 1));
+	for(auto & quads: pageQuads){
+		quads.clear();
+	}
+	// glyphs used from here on can't be evicted until the layout is done
+	atlasUseStamp++;
+}
+
+//-----------------------------------------------------------
+void ofTrueTypeFont::addLayoutLine(const std::string & line, const glm::vec2 & position, bool vflip, layoutGlyphs & glyphs, std::vector<ofRectangle> & glyphBoxes) const{
+	iterateString(line, position.x, position.y, vflip, [&](uint32_t c, glm::vec2 pos){
+		if(c == '\t'){
+			return;
+		}
+		drawChar(c, pos.x, pos.y, vflip);
+		auto & props = getGlyphProperties(c);
+		glyphs.indices.push_back(props.characterIndex);
+		float y = vflip ? pos.y + props.ymin : pos.y - props.ymax;
+		glyphBoxes.emplace_back(pos.x + props.xmin, y, props.width, props.height);
+	});
+}
+
+//-----------------------------------------------------------
+const vector<ofMesh> & ofTrueTypeFont::endLayout(layoutGlyphs & glyphs) const{
+	updateAtlasTextures();
+	// glyphs of the layout can't be evicted while it's built so where they
+	// are now is where its quads point to
+	if(settings.dynamicAtlas){
+		for(auto index: glyphs.indices){
+			glyphs.placements.push_back(atlasSlots[index].placement);
+		}
+	}
+	glyphs.generation = layoutGeneration;
+	return pageQuads;
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::isLayoutCurrent(const layoutGlyphs & glyphs) const{
+	return glyphs.generation == layoutGeneration;
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::useLayout(const layoutGlyphs & glyphs) const{
+	if(!isLayoutCurrent(glyphs)){
+		return false;
+	}
+	if(!settings.dynamicAtlas){
+		return true;
+	}
+	// only layouts with glyphs that were evicted since they were built
+	// are stale, evicting other glyphs doesn't affect them
+	for(size_t i = 0; i < glyphs.indices.size(); i++){
+		auto & slot = atlasSlots[glyphs.indices[i]];
+		if(!slot.empty && (slot.page < 0 || slot.placement != glyphs.placements[i])){
+			return false;
+		}
+	}
+	auto stamp = ++atlasUseStamp;
+	for(auto index: glyphs.indices){
+		auto & slot = atlasSlots[index];
+		if(slot.page >= 0){
+			atlasPages[slot.page].shelves[slot.shelf].lastUse = stamp;
+		}
+	}
+	return true;
 }
 
 //-----------------------------------------------------------
 const ofTexture & ofTrueTypeFont::getFontTexture() const{
-	return texAtlas;
+	return getFontTexture(0);
+}
+
+//-----------------------------------------------------------
+const ofTexture & ofTrueTypeFont::getFontTexture(size_t page) const{
+	if(settings.dynamicAtlas && page < atlasPages.size()){
+		return atlasPages[page].texture;
+	}else{
+		return texAtlas;
+	}
+}
+
+//-----------------------------------------------------------
+size_t ofTrueTypeFont::getNumAtlasPages() const{
+	if(settings.dynamicAtlas){
+		return atlasPages.size();
+	}else{
+		return texAtlas.isAllocated() ? 1 : 0;
+	}
 }
 
 //-----------------------------------------------------------
@@ -1221,7 +2363,7 @@ glm::vec2 ofTrueTypeFont::getFirstGlyphPosForTexture(const std::string & str, bo
 			auto c = *ofUTF8Iterator(str).begin();
 			if(settings.direction == OF_TTF_LEFT_TO_RIGHT){
 				if (c != '\n') {
-					auto g = loadGlyph(c);
+					auto g = loadBitmapGlyph(c);
 					return {-float(g.props.xmin), getLineHeight() + g.props.ymin + getDescenderHeight()};
 				}
 			}else{
@@ -1230,7 +2372,7 @@ glm::vec2 ofTrueTypeFont::getFirstGlyphPosForTexture(const std::string & str, bo
 				iterateString(str, 0, 0, vflip, [&](uint32_t c, ofVec2f){
 					try{
 						if (c != '\n') {
-							auto g = loadGlyph(c);
+							auto g = loadBitmapGlyph(c);
 							lineWidth += g.props.advance + getGlyphProperties(' ').advance * spaceSize * (letterSpacing - 1.f);
 							width = max(width, lineWidth);
 						}else{
@@ -1240,7 +2382,7 @@ glm::vec2 ofTrueTypeFont::getFirstGlyphPosForTexture(const std::string & str, bo
 					}
 				});
 				if (c != '\n') {
-					auto g = loadGlyph(c);
+					auto g = loadBitmapGlyph(c);
 					return {width - float(g.props.xmin), getLineHeight() + g.props.ymin + getDescenderHeight()};
 				}else{
 					return {float(width), 0.0};
@@ -1262,7 +2404,7 @@ ofTexture ofTrueTypeFont::getStringTexture(const std::string& str, bool vflip) c
 	iterateString(str, 0, 0, vflip, [&](uint32_t c, ofVec2f pos){
 		try{
 			if (c != '\n') {
-				auto g = loadGlyph(c);
+				auto g = loadBitmapGlyph(c);
 				glyphs.push_back(g);
 				int x = pos.x + g.props.xmin;
 				int y = g.props.ymax + pos.y;
@@ -1332,3 +2474,39 @@ void ofTrueTypeFont::drawStringAsShapes(const std::string& str, float x, float y
 std::size_t ofTrueTypeFont::getNumCharacters() const{
 	return cps.size();
 }
+
+//-----------------------------------------------------------
+ofTrueTypeFontRenderMode ofTrueTypeFont::getRenderMode() const{
+	return settings.renderMode;
+}
+
+//-----------------------------------------------------------
+bool ofTrueTypeFont::hasDynamicAtlas() const{
+	return settings.dynamicAtlas;
+}
+
+//-----------------------------------------------------------
+ofTrueTypeFontAtlasStats ofTrueTypeFont::getAtlasStats() const{
+	updateFrameStats();
+	auto stats = atlasStats;
+	stats.numPages = getNumAtlasPages();
+	stats.numGlyphs = cps.size();
+	if(settings.dynamicAtlas){
+		size_t usedArea = 0;
+		for(auto & slot: atlasSlots){
+			if(slot.page >= 0){
+				stats.numResidentGlyphs++;
+				usedArea += slot.area;
+			}
+		}
+		if(stats.numPages > 0){
+			stats.occupancy = float(usedArea) / (float(settings.atlasPageSize) * float(settings.atlasPageSize) * stats.numPages);
+		}
+	}else{
+		stats.numResidentGlyphs = cps.size();
+		if(texAtlas.isAllocated()){
+			stats.occupancy = float(atlasUsedArea) / (texAtlas.getWidth() * texAtlas.getHeight());
+		}
+	}
+	return stats;
+}
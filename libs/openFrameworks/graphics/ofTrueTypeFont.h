@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ofConstants.h"
+#include <list>
 #include <unordered_map>
 #include "ofRectangle.h"
 #include "ofPath.h"
@@ -8,6 +9,8 @@
 #include "ofMesh.h"
 #include "ofPixels.h"
 
+class ofTextLayout;
+
 /// \file
 /// The ofTrueTypeFont class provides an interface to load fonts into
 /// openFrameworks. The fonts are converted to textures, and can be drawn on
@@ -123,6 +126,24 @@ enum ofTrueTypeFontDirection : uint32_t {
     OF_TTF_RIGHT_TO_LEFT
 };
 
+/// \brief How glyphs are stored in the font atlas.
+///
+/// Distance fields store, for each texel, the distance to the outline of
+/// the glyph instead of its coverage, so text stays sharp when it's scaled
+/// and a single font can be drawn at any size with ofScale(). They are
+/// drawn with a shader on the programmable renderer and with alpha testing
+/// on the fixed pipeline one.
+enum ofTrueTypeFontRenderMode : uint32_t {
+    /// \brief Anti-aliased or monochrome bitmaps rasterized by freetype.
+    OF_TTF_RENDER_BITMAP,
+    /// \brief Single channel signed distance field, rounds sharp corners
+    /// when scaled up a lot.
+    OF_TTF_RENDER_SDF,
+    /// \brief Multi-channel signed distance field which keeps corners
+    /// sharp at any scale, uses an RGBA atlas.
+    OF_TTF_RENDER_MSDF
+};
+
 struct ofTrueTypeFontSettings{
 
     std::filesystem::path     fontName;
@@ -134,6 +155,31 @@ struct ofTrueTypeFontSettings{
     ofTrueTypeFontDirection direction = OF_TTF_LEFT_TO_RIGHT;
     std::vector<ofUnicode::range> ranges;
 
+    /// Rasterize glyphs on first use into a paged atlas instead of
+    /// loading every glyph in ranges, which are ignored in this mode.
+    /// Any character present in the font can be drawn.
+    bool                      dynamicAtlas = false;
+    /// Width and height in pixels of each page of the dynamic atlas.
+    int                       atlasPageSize = 1024;
+    /// Pages the dynamic atlas can grow to before the least recently
+    /// used glyphs start to be evicted.
+    std::size_t               maxAtlasPages = 4;
+
+    /// How glyphs are rasterized into the atlas.
+    ofTrueTypeFontRenderMode  renderMode = OF_TTF_RENDER_BITMAP;
+    /// Distance in pixels, at fontSize, encoded on each side of the
+    /// outline of distance field glyphs. Larger ranges allow effects like
+    /// outlines or glows but need more padding between glyphs.
+    float                     distanceRange = 4.f;
+    /// Directory, relative to the data folder, where distance field
+    /// atlases are cached between runs. Empty disables the cache.
+    std::filesystem::path     distanceFieldCache;
+
+    /// Strings drawn more than once with drawString() keep their layout
+    /// in a cache of this size so it isn't recomputed every frame. 0
+    /// disables the cache.
+    std::size_t               layoutCacheSize = 64;
+
     ofTrueTypeFontSettings(const std::filesystem::path & name, int size)
     :fontName(name)
     ,fontSize(size){}
@@ -147,6 +193,28 @@ struct ofTrueTypeFontSettings{
     }
 };
 
+/// \brief Usage statistics of the glyph atlas of an ofTrueTypeFont.
+///
+/// \sa ofTrueTypeFont::getAtlasStats()
+struct ofTrueTypeFontAtlasStats{
+	/// \brief Number of atlas textures.
+	std::size_t numPages = 0;
+	/// \brief Number of glyphs whose metrics are known.
+	std::size_t numGlyphs = 0;
+	/// \brief Number of glyphs currently stored in the atlas.
+	std::size_t numResidentGlyphs = 0;
+	/// \brief Fraction, from 0 to 1, of the atlas area used by glyphs.
+	float occupancy = 0;
+	/// \brief Glyphs rasterized during the current frame.
+	std::size_t rasterizationsThisFrame = 0;
+	/// \brief Glyphs rasterized during the previous frame.
+	std::size_t rasterizationsLastFrame = 0;
+	/// \brief Glyphs evicted from the atlas since the font was loaded.
+	std::size_t evictions = 0;
+	/// \brief Texture uploads since the font was loaded.
+	std::size_t uploads = 0;
+};
+
 class ofTrueTypeFont{
 
 public:
@@ -224,9 +292,30 @@ public:
 	/// If you allocate the font using different parameters, you can load in partial 
 	/// and full character sets, this helps you know how many characters it can represent.
 	///
+	/// With a dynamic atlas this is the number of characters used so far.
+	///
 	/// \returns Number of characters in loaded character set.
 	std::size_t	getNumCharacters() const;
 
+	/// \brief How the glyphs of this font are rasterized.
+	/// \sa ofTrueTypeFontSettings::renderMode
+	ofTrueTypeFontRenderMode getRenderMode() const;
+
+	/// \brief Is the font using a dynamic atlas?
+	/// \returns true if glyphs are rasterized on first use.
+	/// \sa ofTrueTypeFontSettings::dynamicAtlas
+	bool hasDynamicAtlas() const;
+
+	/// \brief Get usage statistics of the glyph atlas.
+	///
+	/// Useful to tune ofTrueTypeFontSettings::atlasPageSize and
+	/// ofTrueTypeFontSettings::maxAtlasPages for a dynamic atlas: glyphs
+	/// being rasterized every frame mean the atlas is too small for the
+	/// text being drawn.
+	///
+	/// \returns the current atlas statistics.
+	ofTrueTypeFontAtlasStats getAtlasStats() const;
+
 	/// \}
 	/// \name Font Size
 	/// \{
@@ -353,8 +442,35 @@ public:
 	/// \todo
 	ofPath getCharacterAsPoints(uint32_t character, bool vflip=true, bool filled=true) const;
 	std::vector<ofPath> getStringAsPoints(const std::string &  str, bool vflip=true, bool filled=true) const;
+
+	/// \brief Get the mesh of a string to draw with getFontTexture().
+	///
+	/// With a dynamic atlas the mesh only contains the glyphs stored in
+	/// the first page, strings that use more than one page need
+	/// getStringMeshes().
+	///
+	/// \returns the mesh of the glyphs in the first atlas page.
 	const ofMesh & getStringMesh(const std::string &  s, float x, float y, bool vflip=true) const;
+
+	/// \brief Get the mesh of a string split by atlas page.
+	///
+	/// A dynamic atlas can store the glyphs of a string in different
+	/// textures, each mesh has to be drawn with the texture of the page
+	/// with the same index as returned by getFontTexture(std::size_t).
+	/// Meshes of pages not used by the string are empty.
+	///
+	/// \returns one mesh per atlas page.
+	const std::vector<ofMesh> & getStringMeshes(const std::string & s, float x, float y, bool vflip=true) const;
+
 	const ofTexture & getFontTexture() const;
+
+	/// \brief Get the texture of an atlas page.
+	/// \sa getStringMeshes()
+	const ofTexture & getFontTexture(std::size_t page) const;
+
+	/// \returns the number of atlas textures.
+	std::size_t getNumAtlasPages() const;
+
 	ofTexture getStringTexture(const std::string &  s, bool vflip=true) const;
 	glm::vec2 getFirstGlyphPosForTexture(const std::string & str, bool vflip) const;
 	bool isValidGlyph(uint32_t) const;
@@ -366,12 +482,53 @@ public:
 protected:
 	/// \cond INTERNAL
 	
+	/// \brief Get the cached layout of a string drawn repeatedly.
+	///
+	/// Used by the GL renderers to draw strings with drawString() without
+	/// laying them out again every frame. Strings are only cached the
+	/// second time they are drawn so text that changes every frame
+	/// doesn't fill the cache.
+	///
+	/// \returns the layout of s at 0,0 or nullptr if it isn't cached yet.
+	const ofTextLayout * getCachedLayout(const std::string & s, bool vflip=true) const;
+
+	/// \brief Glyphs of a layout and where they were stored in the atlas
+	/// when its quads were built.
+	///
+	/// Used by ofTextLayout to know when its quads are stale.
+	struct layoutGlyphs{
+		std::vector<std::size_t> indices;
+		std::vector<uint64_t> placements;
+		uint64_t generation = 0;
+	};
+
+	/// \brief Starts building the quads of a layout.
+	void beginLayout(layoutGlyphs & glyphs) const;
+
+	/// \brief Adds the quads of a line of a layout.
+	/// \param glyphBoxes receives the bounding box of each glyph drawn.
+	void addLayoutLine(const std::string & line, const glm::vec2 & position, bool vflip, layoutGlyphs & glyphs, std::vector<ofRectangle> & glyphBoxes) const;
+
+	/// \brief Finishes building the quads of a layout.
+	/// \returns the quads of the layout, one mesh per atlas page.
+	const std::vector<ofMesh> & endLayout(layoutGlyphs & glyphs) const;
+
+	/// \returns false if the metrics of the font changed since the layout
+	/// was built.
+	bool isLayoutCurrent(const layoutGlyphs & glyphs) const;
+
+	/// \brief Marks the glyphs of a layout as used so they aren't evicted
+	/// while it's drawn.
+	/// \returns false if the layout is stale because the metrics changed or
+	/// any of its glyphs were evicted or moved in the atlas.
+	bool useLayout(const layoutGlyphs & glyphs) const;
+
 	bool bLoadedOk;
 	
-	std::vector <ofPath> charOutlines;
-	std::vector <ofPath> charOutlinesNonVFlipped;
-	std::vector <ofPath> charOutlinesContour;
-	std::vector <ofPath> charOutlinesNonVFlippedContour;
+	mutable std::vector <ofPath> charOutlines;
+	mutable std::vector <ofPath> charOutlinesNonVFlipped;
+	mutable std::vector <ofPath> charOutlinesContour;
+	mutable std::vector <ofPath> charOutlinesNonVFlippedContour;
 
 	float lineHeight;
 	float ascenderHeight;
@@ -398,22 +555,85 @@ protected:
 		ofPixels pixels;
 	};
 
-	std::vector<glyphProps> cps; // properties for each character
+	mutable std::vector<glyphProps> cps; // properties for each character
 
 	ofTrueTypeFontSettings settings;
-	std::unordered_map<uint32_t,size_t> glyphIndexMap;
+	mutable std::unordered_map<uint32_t,size_t> glyphIndexMap;
+
+	// glyphs of similar height are packed in horizontal shelves, shelves
+	// are the unit of eviction so the space they leave is reused as is
+	struct atlasShelf{
+		int y;
+		int height;
+		int x;
+		uint64_t lastUse;
+		std::vector<size_t> glyphs;
+	};
+
+	struct atlasPage{
+		ofPixels pixels;
+		ofTexture texture;
+		std::vector<atlasShelf> shelves;
+		int shelvesHeight;
+		int dirtyBegin, dirtyEnd; // range of rows not uploaded yet
+	};
+
+	struct atlasSlot{
+		int page = -1;
+		size_t shelf = 0;
+		size_t area = 0;
+		uint64_t placement = 0; // use stamp when it was last inserted
+		bool empty = false; // glyphs like space have no pixels
+	};
 
     int getKerning(uint32_t c, uint32_t prevC) const;
 	void drawChar(uint32_t c, float x, float y, bool vFlipped) const;
 	void drawCharAsShape(uint32_t c, float x, float y, bool vFlipped, bool filled) const;
 	void createStringMesh(const std::string & s, float x, float y, bool vFlipped) const;
 	glyph loadGlyph(uint32_t utf8) const;
+	glyph loadBitmapGlyph(uint32_t utf8) const;
+	glyphProps loadDistanceFieldProps(uint32_t utf8, ofPath & outline) const;
+	ofPixels makeGlyphDistanceField(const ofPath & outline, const glyphProps & props) const;
+	int getDistanceFieldPadding() const;
+	ofPixelFormat getAtlasPixelFormat() const;
+	std::filesystem::path getDistanceFieldCachePath() const;
+	bool loadDistanceFieldCache(const std::filesystem::path & path, ofPixels & atlas);
+	void saveDistanceFieldCache(const std::filesystem::path & path, const ofPixels & atlas) const;
 	const glyphProps & getGlyphProperties(uint32_t glyph) const;
 	void iterateString(const std::string & str, float x, float y, bool vFlipped, std::function<void(uint32_t, glm::vec2)> f) const;
 	size_t indexForGlyph(uint32_t glyph) const;
+	void loadCharacterOutlines(size_t index) const;
+	void allocateAtlasTexture(ofTexture & texture, const ofPixels & pixels) const;
+
+	size_t addGlyph(uint32_t glyph) const;
+	bool insertIntoAtlas(size_t index, const ofPixels & pixels) const;
+	void evictShelf(atlasPage & page, atlasShelf & shelf) const;
+	void updateAtlasTextures() const;
+	void updateFrameStats() const;
 
 	ofTexture texAtlas;
-	mutable ofMesh stringQuads;
+	mutable std::vector<ofMesh> pageQuads;
+
+	mutable std::vector<atlasPage> atlasPages;
+	mutable std::vector<atlasSlot> atlasSlots;
+	mutable uint64_t atlasUseStamp;
+	mutable uint64_t statsFrame;
+	mutable ofTrueTypeFontAtlasStats atlasStats;
+	size_t atlasUsedArea;
+
+	struct layoutCacheEntry{
+		size_t key;
+		std::string text;
+		bool vflip;
+		std::shared_ptr<ofTextLayout> layout;
+	};
+
+	// changes whenever the metrics used by laid out strings change, atlas
+	// evictions are tracked per glyph with atlasSlot::placement
+	mutable uint64_t layoutGeneration;
+	// most recently used first
+	mutable std::list<layoutCacheEntry> layoutCache;
+	mutable std::unordered_map<size_t,std::list<layoutCacheEntry>::iterator> layoutCacheIndex;
 
 	/// \endcond
 
@@ -430,4 +650,7 @@ private:
 	static void finishLibraries();
 
 	friend void ofExitCallback();
+	friend class ofTextLayout;
+	friend class ofGLRenderer;
+	friend class ofGLProgrammableRenderer;
 };
@@ -18,6 +18,7 @@
 #endif
 
 #include "ofFpsCounter.h"
+#include "ofProfiler.h"
 #include "ofJson.h"
 #include "ofXml.h"
 
@@ -30,6 +31,7 @@
 #include "ofRectangle.h"
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
+#include "ofParameterSnapshot.h"
 
 //--------------------------
 // math
@@ -68,9 +70,11 @@
 #include "ofImage.h"
 #include "ofPath.h"
 #include "ofPixels.h"
+#include "ofPolygonClipping.h"
 #include "ofPolyline.h"
 #include "ofRendererCollection.h"
 #include "ofTessellator.h"
+#include "ofTextLayout.h"
 #include "ofTrueTypeFont.h"
 
 //--------------------------
@@ -93,6 +97,9 @@
 	#include "ofSoundStream.h"
 	#include "ofSoundPlayer.h"
 	#include "ofSoundBuffer.h"
+	#include "ofSoundResampler.h"
+	#include "ofFFT.h"
+	#include "ofSoundGraph.h"
 #endif
 
 //--------------------------
@@ -102,6 +109,7 @@
 
 //--------------------------
 // events
+#include "ofEventQueue.h"
 #include "ofEvents.h"
 
 //--------------------------
@@ -110,6 +118,7 @@
 #include "ofCamera.h"
 #include "ofEasyCam.h"
 #include "ofMesh.h"
+#include "ofMeshBVH.h"
 #include "ofNode.h"
 
 //--------------------------
@@ -0,0 +1,598 @@
+#include "ofFFT.h"
+#include "ofSoundBuffer.h"
+#include "ofLog.h"
+
+using namespace std;
+
+namespace{
+	typedef std::complex<float> complexf;
+
+	// std::complex multiplication checks for nans and infinities which
+	// prevents it from being inlined and vectorized
+	inline complexf mul(complexf a, complexf b){
+		return complexf(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+
+	inline complexf mulMinusI(complexf a){
+		return complexf(a.imag(), -a.real());
+	}
+
+	inline complexf polar(double turns){
+		return complexf(cos(2 * M_PI * turns), sin(2 * M_PI * turns));
+	}
+}
+
+//--------------------------------------------------------------
+void ofFFT::Plan::setup(size_t size){
+	this->size = size;
+	stages.clear();
+
+	vector<size_t> factors;
+	auto n = size;
+	while(n % 4 == 0){
+		factors.push_back(4);
+		n /= 4;
+	}
+	while(n % 2 == 0){
+		factors.push_back(2);
+		n /= 2;
+	}
+	for(size_t p = 3; p * p <= n; p += 2){
+		while(n % p == 0){
+			factors.push_back(p);
+			n /= p;
+		}
+	}
+	if(n > 1){
+		factors.push_back(n);
+	}
+
+	// stockham autosort, every stage splits the remaining length by its
+	// radix so the output comes out in order without bit reversal
+	size_t length = size;
+	size_t stride = 1;
+	size_t maxRadix = 0;
+	for(auto radix: factors){
+		Stage stage;
+		stage.radix = radix;
+		stage.length = length;
+		stage.stride = stride;
+		auto m = length / radix;
+		stage.twiddles.resize(m * radix);
+		for(size_t j = 0; j < m; j++){
+			for(size_t u = 0; u < radix; u++){
+				stage.twiddles[j * radix + u] = polar(-double(j * u) / length);
+			}
+		}
+		if(radix > 4){
+			stage.roots.resize(radix);
+			for(size_t k = 0; k < radix; k++){
+				stage.roots[k] = polar(-double(k) / radix);
+			}
+		}
+		maxRadix = std::max(maxRadix, radix);
+		stages.push_back(std::move(stage));
+		length = m;
+		stride *= radix;
+	}
+	scratch.resize(maxRadix * 2);
+}
+
+//--------------------------------------------------------------
+void ofFFT::Plan::transform(const complexf * in, complexf * out, complexf * work0, complexf * work1){
+	if(stages.empty()){
+		if(size == 1){
+			out[0] = in[0];
+		}
+		return;
+	}
+	if(stages.size() == 1 && in == out){
+		std::copy(in, in + size, work0);
+		in = work0;
+	}
+
+	const complexf * x = in;
+	for(size_t i = 0; i < stages.size(); i++){
+		auto & stage = stages[i];
+		complexf * y = i + 1 == stages.size() ? out : (x == work0 ? work1 : work0);
+		const size_t s = stage.stride;
+		const size_t m = stage.length / stage.radix;
+		const complexf * tw = stage.twiddles.data();
+
+		switch(stage.radix){
+		case 2:
+			for(size_t j = 0; j < m; j++){
+				auto w1 = tw[j * 2 + 1];
+				const complexf * x0 = x + s * j;
+				const complexf * x1 = x + s * (j + m);
+				complexf * y0 = y + s * (2 * j);
+				complexf * y1 = y + s * (2 * j + 1);
+				for(size_t q = 0; q < s; q++){
+					auto a = x0[q];
+					auto b = x1[q];
+					y0[q] = a + b;
+					y1[q] = mul(a - b, w1);
+				}
+			}
+			break;
+		case 3:{
+			const float sin60 = 0.866025403784438646763723170753f;
+			for(size_t j = 0; j < m; j++){
+				auto w1 = tw[j * 3 + 1];
+				auto w2 = tw[j * 3 + 2];
+				const complexf * x0 = x + s * j;
+				const complexf * x1 = x + s * (j + m);
+				const complexf * x2 = x + s * (j + 2 * m);
+				complexf * y0 = y + s * (3 * j);
+				complexf * y1 = y + s * (3 * j + 1);
+				complexf * y2 = y + s * (3 * j + 2);
+				for(size_t q = 0; q < s; q++){
+					auto a0 = x0[q];
+					auto sum = x1[q] + x2[q];
+					auto diff = mulMinusI(x1[q] - x2[q]) * sin60;
+					auto mid = a0 - sum * 0.5f;
+					y0[q] = a0 + sum;
+					y1[q] = mul(mid + diff, w1);
+					y2[q] = mul(mid - diff, w2);
+				}
+			}
+			break;
+		}
+		case 4:
+			for(size_t j = 0; j < m; j++){
+				auto w1 = tw[j * 4 + 1];
+				auto w2 = tw[j * 4 + 2];
+				auto w3 = tw[j * 4 + 3];
+				const complexf * x0 = x + s * j;
+				const complexf * x1 = x + s * (j + m);
+				const complexf * x2 = x + s * (j + 2 * m);
+				const complexf * x3 = x + s * (j + 3 * m);
+				complexf * y0 = y + s * (4 * j);
+				complexf * y1 = y + s * (4 * j + 1);
+				complexf * y2 = y + s * (4 * j + 2);
+				complexf * y3 = y + s * (4 * j + 3);
+				for(size_t q = 0; q < s; q++){
+					auto t0 = x0[q] + x2[q];
+					auto t1 = x0[q] - x2[q];
+					auto t2 = x1[q] + x3[q];
+					auto t3 = mulMinusI(x1[q] - x3[q]);
+					y0[q] = t0 + t2;
+					y1[q] = mul(t1 + t3, w1);
+					y2[q] = mul(t0 - t2, w2);
+					y3[q] = mul(t1 - t3, w3);
+				}
+			}
+			break;
+		default:{
+			const size_t p = stage.radix;
+			complexf * a = scratch.data();
+			complexf * b = a + p;
+			const complexf * roots = stage.roots.data();
+			for(size_t j = 0; j < m; j++){
+				for(size_t q = 0; q < s; q++){
+					for(size_t r = 0; r < p; r++){
+						a[r] = x[q + s * (j + r * m)];
+					}
+					for(size_t u = 0; u < p; u++){
+						complexf sum = a[0];
+						size_t k = 0;
+						for(size_t r = 1; r < p; r++){
+							k += u;
+							if(k >= p){
+								k -= p;
+							}
+							sum += mul(a[r], roots[k]);
+						}
+						b[u] = sum;
+					}
+					for(size_t u = 0; u < p; u++){
+						y[q + s * (p * j + u)] = mul(b[u], tw[j * p + u]);
+					}
+				}
+			}
+			break;
+		}
+		}
+		x = y;
+	}
+}
+
+//--------------------------------------------------------------
+ofFFT::ofFFT(){}
+
+//--------------------------------------------------------------
+void ofFFT::setup(size_t size){
+	if(size == 0){
+		ofLogError("ofFFT") << "setup(): size can't be 0";
+		return;
+	}
+	this->size = size;
+	plan.setup(size);
+	if(size % 2 == 0){
+		// real transforms of even sizes run as a complex transform of half
+		// the size with the even samples as real and the odd as imaginary
+		auto half = size / 2;
+		halfPlan.setup(half);
+		realTwiddles.resize(half);
+		for(size_t k = 0; k < half; k++){
+			realTwiddles[k] = polar(-double(k) / size);
+		}
+	}else{
+		halfPlan = Plan();
+		realTwiddles.clear();
+	}
+	work0.assign(size, 0);
+	work1.assign(size, 0);
+	work2.assign(size, 0);
+}
+
+//--------------------------------------------------------------
+size_t ofFFT::getSize() const{
+	return size;
+}
+
+//--------------------------------------------------------------
+size_t ofFFT::getNumBins() const{
+	return size / 2 + 1;
+}
+
+//--------------------------------------------------------------
+void ofFFT::forward(const float * in, complexf * out){
+	if(size % 2 == 1){
+		for(size_t i = 0; i < size; i++){
+			work2[i] = in[i];
+		}
+		plan.transform(work2.data(), work2.data(), work0.data(), work1.data());
+		std::copy(work2.begin(), work2.begin() + getNumBins(), out);
+		return;
+	}
+
+	auto half = size / 2;
+	auto z = work2.data();
+	halfPlan.transform(reinterpret_cast<const complexf *>(in), z, work0.data(), work1.data());
+	out[0] = complexf(z[0].real() + z[0].imag(), 0);
+	out[half] = complexf(z[0].real() - z[0].imag(), 0);
+	for(size_t k = 1; k < half; k++){
+		auto zk = z[k];
+		auto zc = conj(z[half - k]);
+		auto even = (zk + zc) * 0.5f;
+		auto odd = mulMinusI(zk - zc) * 0.5f;
+		out[k] = even + mul(odd, realTwiddles[k]);
+	}
+}
+
+//--------------------------------------------------------------
+void ofFFT::inverse(const complexf * in, float * out){
+	if(size % 2 == 1){
+		auto bins = getNumBins();
+		for(size_t k = 0; k < size; k++){
+			work2[k] = conj(k < bins ? in[k] : conj(in[size - k]));
+		}
+		plan.transform(work2.data(), work2.data(), work0.data(), work1.data());
+		float scale = 1.f / size;
+		for(size_t i = 0; i < size; i++){
+			out[i] = work2[i].real() * scale;
+		}
+		return;
+	}
+
+	// undoes the split of forward() and runs the half size transform
+	// inverted by conjugating its input and output
+	auto half = size / 2;
+	auto z = work2.data();
+	for(size_t k = 0; k < half; k++){
+		auto xk = in[k];
+		auto xc = conj(in[half - k]);
+		auto even = (xk + xc) * 0.5f;
+		auto odd = mul((xk - xc) * 0.5f, conj(realTwiddles[k]));
+		z[k] = conj(even + complexf(-odd.imag(), odd.real()));
+	}
+	halfPlan.transform(z, z, work0.data(), work1.data());
+	float scale = 1.f / half;
+	for(size_t n = 0; n < half; n++){
+		out[2 * n] = z[n].real() * scale;
+		out[2 * n + 1] = -z[n].imag() * scale;
+	}
+}
+
+//--------------------------------------------------------------
+void ofFFT::forward(const complexf * in, complexf * out){
+	plan.transform(in, out, work0.data(), work1.data());
+}
+
+//--------------------------------------------------------------
+void ofFFT::inverse(const complexf * in, complexf * out){
+	for(size_t i = 0; i < size; i++){
+		work2[i] = conj(in[i]);
+	}
+	plan.transform(work2.data(), out, work0.data(), work1.data());
+	float scale = 1.f / size;
+	for(size_t i = 0; i < size; i++){
+		out[i] = conj(out[i]) * scale;
+	}
+}
+
+//--------------------------------------------------------------
+void ofFFT::getWindow(Window type, size_t size, vector<float> & window){
+	window.resize(size);
+	// periodic windows, the right choice for spectral analysis and for
+	// overlapping frames
+	for(size_t i = 0; i < size; i++){
+		double t = 2 * M_PI * i / size;
+		switch(type){
+		case Rectangular:
+			window[i] = 1;
+			break;
+		case Hann:
+			window[i] = 0.5 - 0.5 * cos(t);
+			break;
+		case Hamming:
+			window[i] = 0.54 - 0.46 * cos(t);
+			break;
+		case Blackman:
+			window[i] = 0.42 - 0.5 * cos(t) + 0.08 * cos(2 * t);
+			break;
+		case BlackmanHarris:
+			window[i] = 0.35875 - 0.48829 * cos(t) + 0.14128 * cos(2 * t) - 0.01168 * cos(3 * t);
+			break;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::setup(size_t fftSize, size_t hopSize, unsigned int sampleRate, ofFFT::Window windowType){
+	if(fftSize == 0 || sampleRate == 0){
+		ofLogError("ofSpectrumAnalyzer") << "setup(): invalid fft size " << fftSize << " or sample rate " << sampleRate;
+		return;
+	}
+	if(hopSize == 0 || hopSize > fftSize){
+		ofLogWarning("ofSpectrumAnalyzer") << "setup(): hop size " << hopSize << " out of range, using " << fftSize;
+		hopSize = fftSize;
+	}
+	this->hopSize = hopSize;
+	this->sampleRate = sampleRate;
+	fft.setup(fftSize);
+	ofFFT::getWindow(windowType, fftSize, window);
+	float sum = 0;
+	for(auto w: window){
+		sum += w;
+	}
+	magnitudeScale = 2 / sum;
+	input.assign(fftSize, 0);
+	frame.assign(fftSize, 0);
+	spectrum.assign(fft.getNumBins(), 0);
+	magnitudes.assign(fft.getNumBins(), 0);
+	melBands = Bands();
+	logBands = Bands();
+	reset();
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::setupMelBands(size_t numBands, float minHz, float maxHz){
+	if(sampleRate == 0){
+		ofLogError("ofSpectrumAnalyzer") << "setupMelBands(): call setup first";
+		return;
+	}
+	if(maxHz <= 0){
+		maxHz = sampleRate / 2.f;
+	}
+	vector<float> edges(numBands + 2);
+	float minMel = hzToMel(minHz);
+	float maxMel = hzToMel(maxHz);
+	for(size_t i = 0; i < edges.size(); i++){
+		edges[i] = melToHz(minMel + (maxMel - minMel) * i / (numBands + 1));
+	}
+	melBands.setup(edges, true, *this);
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::setupLogBands(size_t bandsPerOctave, float minHz, float maxHz){
+	if(sampleRate == 0){
+		ofLogError("ofSpectrumAnalyzer") << "setupLogBands(): call setup first";
+		return;
+	}
+	if(bandsPerOctave == 0 || minHz <= 0){
+		ofLogError("ofSpectrumAnalyzer") << "setupLogBands(): bands per octave and the minimum frequency have to be positive";
+		return;
+	}
+	if(maxHz <= 0){
+		maxHz = sampleRate / 2.f;
+	}
+	size_t numBands = floor(bandsPerOctave * log2(maxHz / minHz) + 1e-4);
+	vector<float> edges(numBands + 1);
+	for(size_t i = 0; i < edges.size(); i++){
+		edges[i] = minHz * pow(2.f, float(i) / bandsPerOctave);
+	}
+	logBands.setup(edges, false, *this);
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::Bands::setup(const vector<float> & edges, bool triangular, const ofSpectrumAnalyzer & analyzer){
+	size_t numBands = triangular ? edges.size() - 2 : edges.size() - 1;
+	firstBin.assign(numBands, 0);
+	offsets.assign(numBands + 1, 0);
+	frequencies.assign(numBands, 0);
+	values.assign(numBands, 0);
+	weights.clear();
+	auto binWidth = analyzer.getBinFrequency(1);
+	auto lastBin = analyzer.getNumBins() - 1;
+	for(size_t b = 0; b < numBands; b++){
+		float low = edges[b];
+		float high = triangular ? edges[b + 2] : edges[b + 1];
+		float center = triangular ? edges[b + 1] : sqrt(low * high);
+		frequencies[b] = center;
+		offsets[b] = weights.size();
+
+		size_t first = std::min<size_t>(ceil(low / binWidth), lastBin);
+		size_t last = std::min<size_t>(floor(high / binWidth), lastBin);
+		float sum = 0;
+		for(size_t bin = first; bin <= last; bin++){
+			float hz = bin * binWidth;
+			float weight;
+			if(triangular){
+				weight = hz < center ? (hz - low) / (center - low) : (high - hz) / (high - center);
+			}else{
+				weight = hz < high ? 1 : 0;
+			}
+			weights.push_back(std::max(weight, 0.f));
+			sum += weights.back();
+		}
+		if(sum > 0){
+			firstBin[b] = first;
+			for(size_t i = offsets[b]; i < weights.size(); i++){
+				weights[i] /= sum;
+			}
+		}else{
+			// bands narrower than a bin use the closest one
+			weights.resize(offsets[b]);
+			firstBin[b] = std::min<size_t>(round(center / binWidth), lastBin);
+			weights.push_back(1);
+		}
+	}
+	offsets[numBands] = weights.size();
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::Bands::process(const vector<float> & magnitudes){
+	for(size_t b = 0; b < values.size(); b++){
+		const float * mags = &magnitudes[firstBin[b]];
+		const float * w = &weights[offsets[b]];
+		size_t n = offsets[b + 1] - offsets[b];
+		float sum = 0;
+		for(size_t i = 0; i < n; i++){
+			sum += mags[i] * w[i];
+		}
+		values[b] = sum;
+	}
+}
+
+//--------------------------------------------------------------
+size_t ofSpectrumAnalyzer::process(const ofSoundBuffer & buffer){
+	return process(buffer.getBuffer().data(), buffer.getNumFrames(), buffer.getNumChannels());
+}
+
+//--------------------------------------------------------------
+size_t ofSpectrumAnalyzer::process(const float * samples, size_t numFrames, size_t numChannels){
+	if(input.empty() || numChannels == 0){
+		return 0;
+	}
+	size_t analyzed = 0;
+	float gain = 1.f / numChannels;
+	auto fftSize = input.size();
+	while(numFrames > 0){
+		auto frames = std::min(numFrames, fftSize - filled);
+		float * dst = &input[filled];
+		if(numChannels == 1){
+			std::copy(samples, samples + frames, dst);
+		}else{
+			for(size_t i = 0; i < frames; i++){
+				float sum = 0;
+				for(size_t c = 0; c < numChannels; c++){
+					sum += samples[i * numChannels + c];
+				}
+				dst[i] = sum * gain;
+			}
+		}
+		samples += frames * numChannels;
+		numFrames -= frames;
+		filled += frames;
+		if(filled == fftSize){
+			analyze();
+			analyzed++;
+			std::copy(input.begin() + hopSize, input.end(), input.begin());
+			filled -= hopSize;
+		}
+	}
+	return analyzed;
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::analyze(){
+	for(size_t i = 0; i < frame.size(); i++){
+		frame[i] = input[i] * window[i];
+	}
+	fft.forward(frame.data(), spectrum.data());
+	for(size_t k = 0; k < spectrum.size(); k++){
+		auto re = spectrum[k].real();
+		auto im = spectrum[k].imag();
+		magnitudes[k] = sqrt(re * re + im * im) * magnitudeScale;
+	}
+	melBands.process(magnitudes);
+	logBands.process(magnitudes);
+	framesAnalyzed++;
+}
+
+//--------------------------------------------------------------
+void ofSpectrumAnalyzer::reset(){
+	filled = 0;
+	framesAnalyzed = 0;
+	std::fill(spectrum.begin(), spectrum.end(), 0);
+	std::fill(magnitudes.begin(), magnitudes.end(), 0);
+	std::fill(melBands.values.begin(), melBands.values.end(), 0);
+	std::fill(logBands.values.begin(), logBands.values.end(), 0);
+}
+
+//--------------------------------------------------------------
+const vector<complex<float>> & ofSpectrumAnalyzer::getSpectrum() const{
+	return spectrum;
+}
+
+//--------------------------------------------------------------
+const vector<float> & ofSpectrumAnalyzer::getMagnitudes() const{
+	return magnitudes;
+}
+
+//--------------------------------------------------------------
+const vector<float> & ofSpectrumAnalyzer::getMelBands() const{
+	return melBands.values;
+}
+
+//--------------------------------------------------------------
+const vector<float> & ofSpectrumAnalyzer::getLogBands() const{
+	return logBands.values;
+}
+
+//--------------------------------------------------------------
+const vector<float> & ofSpectrumAnalyzer::getMelFrequencies() const{
+	return melBands.frequencies;
+}
+
+//--------------------------------------------------------------
+const vector<float> & ofSpectrumAnalyzer::getLogFrequencies() const{
+	return logBands.frequencies;
+}
+
+//--------------------------------------------------------------
+float ofSpectrumAnalyzer::getBinFrequency(size_t bin) const{
+	return input.empty() ? 0 : float(bin) * sampleRate / input.size();
+}
+
+//--------------------------------------------------------------
+size_t ofSpectrumAnalyzer::getNumBins() const{
+	return spectrum.size();
+}
+
+//--------------------------------------------------------------
+size_t ofSpectrumAnalyzer::getFFTSize() const{
+	return input.size();
+}
+
+//--------------------------------------------------------------
+size_t ofSpectrumAnalyzer::getHopSize() const{
+	return hopSize;
+}
+
+//--------------------------------------------------------------
+uint64_t ofSpectrumAnalyzer::getNumFramesAnalyzed() const{
+	return framesAnalyzed;
+}
+
+//--------------------------------------------------------------
+float ofSpectrumAnalyzer::hzToMel(float hz){
+	return 2595 * log10(1 + hz / 700);
+}
+
+//--------------------------------------------------------------
+float ofSpectrumAnalyzer::melToHz(float mel){
+	return 700 * (pow(10, mel / 2595) - 1);
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <complex>
+
+class ofSoundBuffer;
+
+/// \brief Fast Fourier transform of a fixed size.
+///
+/// setup() plans the transform for a size, precomputing the twiddle factors
+/// and allocating the working memory, so the transforms don't allocate and
+/// can run inside the audio callbacks.
+///
+/// Any size is supported. Sizes that are products of 2, 3 and 4 use
+/// specialized butterflies, power of two sizes being the fastest, other
+/// prime factors use a generic, slower, butterfly.
+class ofFFT{
+public:
+	/// \brief Window functions applied before the transform to reduce the
+	/// spectral leakage of the frequencies that don't fit an exact number of
+	/// periods in it.
+	enum Window{
+		Rectangular,
+		Hann,
+		Hamming,
+		Blackman,
+		BlackmanHarris
+	};
+
+	ofFFT();
+
+	/// \brief Plans transforms of size samples.
+	void setup(std::size_t size);
+
+	std::size_t getSize() const;
+
+	/// \brief Number of bins of the transform of real data, getSize() / 2 + 1.
+	std::size_t getNumBins() const;
+
+	/// \brief Transforms getSize() real samples into getNumBins() bins,
+	/// from 0Hz to the nyquist frequency.
+	void forward(const float * in, std::complex<float> * out);
+
+	/// \brief Transforms getNumBins() bins back into getSize() samples.
+	///
+	/// The output is scaled so inverse(forward(x)) == x.
+	void inverse(const std::complex<float> * in, float * out);
+
+	/// \brief Transforms getSize() complex samples, in and out can be the same.
+	void forward(const std::complex<float> * in, std::complex<float> * out);
+
+	/// \brief Inverse of the complex transform, scaled so
+	/// inverse(forward(x)) == x. in and out can be the same.
+	void inverse(const std::complex<float> * in, std::complex<float> * out);
+
+	/// \brief Fills window with size samples of a window function.
+	static void getWindow(Window type, std::size_t size, std::vector<float> & window);
+
+private:
+	struct Stage{
+		std::size_t radix;
+		std::size_t length;
+		std::size_t stride;
+		std::vector<std::complex<float>> twiddles;
+		std::vector<std::complex<float>> roots;
+	};
+
+	struct Plan{
+		void setup(std::size_t size);
+		void transform(const std::complex<float> * in, std::complex<float> * out, std::complex<float> * work0, std::complex<float> * work1);
+
+		std::size_t size = 0;
+		std::vector<Stage> stages;
+		std::vector<std::complex<float>> scratch;
+	};
+
+	Plan plan;
+	Plan halfPlan;
+	std::size_t size = 0;
+	std::vector<std::complex<float>> realTwiddles;
+	std::vector<std::complex<float>> work0;
+	std::vector<std::complex<float>> work1;
+	std::vector<std::complex<float>> work2;
+};
+
+/// \brief Short time Fourier transform of a stream of audio.
+///
+/// Feeding it the buffers of the audio callbacks analyzes a frame of
+/// fftSize samples every hopSize samples, with the channels mixed to mono.
+/// After setup nothing allocates so it can run in the audio thread:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// analyzer.setup(2048, 512, 44100);
+/// analyzer.setupMelBands(40);
+///
+/// // audioIn
+/// if(analyzer.process(buffer)){
+/// 	std::unique_lock<std::mutex> lock(mutex);
+/// 	mel = analyzer.getMelBands();
+/// }
+/// ~~~~
+///
+/// The results always correspond to the last frame analyzed.
+class ofSpectrumAnalyzer{
+public:
+	/// \param fftSize samples analyzed in every frame.
+	/// \param hopSize samples between the start of consecutive frames,
+	/// smaller than fftSize for the frames to overlap.
+	void setup(std::size_t fftSize, std::size_t hopSize, unsigned int sampleRate, ofFFT::Window window = ofFFT::Hann);
+
+	/// \brief Also aggregates every frame in triangular bands equally
+	/// spaced on the mel scale, which approximates how pitch is perceived.
+	/// \param maxHz upper frequency of the last band, 0 for the nyquist
+	/// frequency.
+	void setupMelBands(std::size_t numBands, float minHz = 0, float maxHz = 0);
+
+	/// \brief Also aggregates every frame in bands of a fraction of an
+	/// octave, like a graphic equalizer.
+	void setupLogBands(std::size_t bandsPerOctave, float minHz = 20, float maxHz = 0);
+
+	/// \brief Adds samples to the stream, mixing all the channels.
+	/// \returns the number of frames analyzed.
+	std::size_t process(const ofSoundBuffer & buffer);
+	std::size_t process(const float * samples, std::size_t numFrames, std::size_t numChannels);
+
+	/// \brief Clears the samples waiting to be analyzed and the results.
+	void reset();
+
+	/// \brief Complex spectrum of the last frame.
+	const std::vector<std::complex<float>> & getSpectrum() const;
+
+	/// \brief Amplitude of every bin of the last frame, scaled so a sine of
+	/// amplitude 1 centered in a bin measures 1.
+	const std::vector<float> & getMagnitudes() const;
+
+	/// \brief Average magnitude in each mel band, weighted by the triangles.
+	const std::vector<float> & getMelBands() const;
+
+	/// \brief Average magnitude in each logarithmic band.
+	const std::vector<float> & getLogBands() const;
+
+	/// \brief Center frequency of every band.
+	const std::vector<float> & getMelFrequencies() const;
+	const std::vector<float> & getLogFrequencies() const;
+
+	/// \brief Frequency in Hz of the center of a bin.
+	float getBinFrequency(std::size_t bin) const;
+
+	std::size_t getNumBins() const;
+	std::size_t getFFTSize() const;
+	std::size_t getHopSize() const;
+
+	/// \brief Number of frames analyzed since setup or reset.
+	uint64_t getNumFramesAnalyzed() const;
+
+	static float hzToMel(float hz);
+	static float melToHz(float mel);
+
+private:
+	struct Bands{
+		void setup(const std::vector<float> & edges, bool triangular, const ofSpectrumAnalyzer & analyzer);
+		void process(const std::vector<float> & magnitudes);
+
+		std::vector<std::size_t> firstBin;
+		std::vector<std::size_t> offsets;
+		std::vector<float> weights;
+		std::vector<float> frequencies;
+		std::vector<float> values;
+	};
+
+	void analyze();
+
+	ofFFT fft;
+	std::vector<float> window;
+	std::vector<float> input;
+	std::vector<float> frame;
+	std::vector<std::complex<float>> spectrum;
+	std::vector<float> magnitudes;
+	Bands melBands;
+	Bands logBands;
+	std::size_t hopSize = 0;
+	std::size_t filled = 0;
+	unsigned int sampleRate = 0;
+	float magnitudeScale = 1;
+	uint64_t framesAnalyzed = 0;
+};
@@ -8,6 +8,7 @@
 #include "ofLog.h"
 #include "ofEvents.h"
 #include <sndfile.h>
+#include <cstring>
 
 #if defined (TARGET_OF_IOS) || defined (TARGET_OSX)
 #include <OpenAL/al.h>
@@ -115,6 +116,72 @@ static string getMpg123EncodingString(int encoding) {
 #endif
 
 #define BUFFER_STREAM_SIZE 4096
+// OpenAL buffers queued for every channel of a stream
+#define NUM_STREAM_BUFFERS 4
+// blocks the decoder can be ahead of the ones queued
+#define NUM_STREAM_BLOCKS 8
+// finished voices kept to be reused by the next ones
+#define MAX_FREE_SOURCES 256
+
+//------------------------------------------------------------
+static vector<ALuint> & freeSources(){
+	static vector<ALuint> * sources = new vector<ALuint>;
+	return *sources;
+}
+
+//------------------------------------------------------------
+// takes sources from the pool of finished voices or creates new ones
+static bool acquireSources(ALuint * sources, int num){
+	auto & pool = freeSources();
+	int fromPool = std::min<int>(num, pool.size());
+	std::copy(pool.end() - fromPool, pool.end(), sources);
+	pool.resize(pool.size() - fromPool);
+	if(fromPool < num){
+		alGetError(); // Clear error.
+		alGenSources(num - fromPool, sources + fromPool);
+		ALenum err = alGetError();
+		if(err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer") << "couldn't generate sources: " << (int) err << " " << getALErrorString(err);
+			pool.insert(pool.end(), sources, sources + fromPool);
+			return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------
+static void releaseSources(const ALuint * sources, int num){
+	if(num == 0) return;
+	alSourceStopv(num, sources);
+	auto & pool = freeSources();
+	for(int i = 0; i < num; i++){
+		// detaches the buffers so they can be deleted
+		alSourcei(sources[i], AL_BUFFER, 0);
+		if(pool.size() < MAX_FREE_SOURCES){
+			pool.push_back(sources[i]);
+		}else{
+			alDeleteSources(1, &sources[i]);
+		}
+	}
+}
+
+//------------------------------------------------------------
+// a sound decoded into OpenAL buffers, one per channel, shared by all the
+// players that load the same file
+struct ofOpenALSoundPlayer::Sample{
+	~Sample(){
+		if(alContext && !buffers.empty()){
+			alDeleteBuffers(buffers.size(), &buffers[0]);
+		}
+	}
+
+	vector<ALuint> buffers;
+	vector<vector<float> > fftBuffers;
+	int channels = 0;
+	int samplerate = 0;
+	float duration = 0;
+	uint64_t frames = 0;
+};
 
 // now, the individual sound player:
 //------------------------------------------------------------
@@ -129,11 +196,21 @@ ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
 	isStreaming		= false;
 	channels		= 0;
 	duration		= 0;
+	samplerate		= 0;
+	numFrames		= 0;
 	fftCfg			= 0;
 	streamf			= 0;
 #ifdef OF_USING_MPG123
 	mp3streamf		= 0;
 #endif
+	streamFrame		= 0;
+	streamGeneration = 0;
+	streamSeekFrame	= 0;
+	streamPosition	= 0;
+	streamLoop		= false;
+	decoding		= false;
+	feederGeneration = 0;
+	streamEnded		= false;
 	players().insert(this);
 }
 
@@ -175,6 +252,11 @@ void ofOpenALSoundPlayer::createWindow(int size){
 //---------------------------------------
 void ofOpenALSoundPlayer::close(){
 	if(alDevice){
+		auto & pool = freeSources();
+		if(!pool.empty()){
+			alDeleteSources(pool.size(), &pool[0]);
+			pool.clear();
+		}
 		alcCloseDevice(alDevice);
 		alDevice = nullptr;
 		alcDestroyContext(alContext);
@@ -278,141 +360,257 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 #endif
 
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfStream(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
-	if(!streamf){
-		SF_INFO sfInfo;
-		streamf = sf_open(path.c_str(),SFM_READ,&sfInfo);
-		if(!streamf){
-			ofLogError("ofOpenALSoundPlayer") << "sfStream(): couldn't read \"" << path << "\"";
-			return false;
-		}
+bool ofOpenALSoundPlayer::openStream(const std::filesystem::path& fileName){
+	streamWav.reset(new ofMappedWav);
+	if(streamWav->open(fileName)){
+		channels = streamWav->channels;
+		samplerate = streamWav->samplerate;
+		numFrames = streamWav->frames;
+	}else{
+		streamWav.reset();
+#ifdef OF_USING_MPG123
+		if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3"){
+			int err = MPG123_OK;
+			mp3streamf = mpg123_new(nullptr,&err);
+			if(mpg123_open(mp3streamf,fileName.c_str())!=MPG123_OK){
+				ofLogError("ofOpenALSoundPlayer") << "openStream(): couldn't read \"" << fileName << "\"";
+				closeStream();
+				return false;
+			}
 
-		stream_subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
-		if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-			sf_command (streamf, SFC_CALC_SIGNAL_MAX, &stream_scale, sizeof (stream_scale)) ;
-			if (stream_scale < 1e-10)
-				stream_scale = 1.0 ;
-			else
-				stream_scale = 32700.0 / stream_scale ;
+			long int rate;
+			int encoding;
+			mpg123_getformat(mp3streamf,&rate,&channels,&encoding);
+			if(encoding!=MPG123_ENC_SIGNED_16){
+				ofLogError("ofOpenALSoundPlayer") << "openStream(): " << getMpg123EncodingString(encoding)
+				<< " encoding for \"" << fileName << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
+				closeStream();
+				return false;
+			}
+			// scanning the file makes the length and seeking sample accurate
+			mpg123_scan(mp3streamf);
+			samplerate = rate;
+			numFrames = std::max<off_t>(mpg123_length(mp3streamf), 0);
+		}else
+#endif
+		{
+			SF_INFO sfInfo;
+			streamf = sf_open(fileName.c_str(),SFM_READ,&sfInfo);
+			if(!streamf){
+				ofLogError("ofOpenALSoundPlayer") << "openStream(): couldn't read \"" << fileName << "\"";
+				return false;
+			}
+			// float files are normalized when read as shorts
+			sf_command(streamf, SFC_SET_SCALE_FLOAT_INT_READ, nullptr, SF_TRUE);
+			channels = sfInfo.channels;
+			samplerate = sfInfo.samplerate;
+			numFrames = sfInfo.frames;
 		}
-		channels = sfInfo.channels;
-		duration = float(sfInfo.frames) / float(sfInfo.samplerate);
-		samplerate = sfInfo.samplerate;
-		stream_samples_read = 0;
 	}
-
-	int curr_buffer_size = BUFFER_STREAM_SIZE*channels;
-	if(speed>1) curr_buffer_size *= (int)round(speed);
-	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
-	if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-		sf_count_t samples_read = sf_read_float (streamf, &fftAuxBuffer[0], fftAuxBuffer.size());
-		stream_samples_read += samples_read;
-		if(samples_read<(int)fftAuxBuffer.size()){
-			fftAuxBuffer.resize(samples_read);
-			buffer.resize(samples_read);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
-			fftAuxBuffer[i] *= stream_scale ;
-			buffer[i] = 32565.0 * fftAuxBuffer[i];
-		}
-	}else{
-		sf_count_t frames_read = sf_readf_short(streamf,&buffer[0],curr_buffer_size/channels);
-		stream_samples_read += frames_read*channels;
-		if(frames_read<curr_buffer_size/channels){
-			fftAuxBuffer.resize(frames_read*channels);
-			buffer.resize(frames_read*channels);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for(int i=0;i<(int)buffer.size();i++){
-			fftAuxBuffer[i]=float(buffer[i])/32565.0f;
-		}
+	if(numFrames == 0 || channels <= 0){
+		ofLogError("ofOpenALSoundPlayer") << "openStream(): \"" << fileName << "\" is empty";
+		closeStream();
+		return false;
 	}
-
+	duration = float(numFrames) / float(samplerate);
+	streamFrame = 0;
 	return true;
 }
 
-#ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123Stream(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
-	if(!mp3streamf){
-		int err = MPG123_OK;
-		mp3streamf = mpg123_new(nullptr,&err);
-		if(mpg123_open(mp3streamf,path.c_str())!=MPG123_OK){
-			mpg123_close(mp3streamf);
-			mpg123_delete(mp3streamf);
-			ofLogError("ofOpenALSoundPlayer") << "mpg123Stream(): couldn't read \"" << path << "\"";
-			return false;
-		}
-
-		long int rate;
-		mpg123_getformat(mp3streamf,&rate,&channels,(int*)&stream_encoding);
-		if(stream_encoding!=MPG123_ENC_SIGNED_16){
-			ofLogError("ofOpenALSoundPlayer") << "mpg123Stream(): " << getMpg123EncodingString(stream_encoding)
-			<< " encoding for \"" << path << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
-			return false;
-		}
-		samplerate = rate;
-		mp3_buffer_size = mpg123_outblock( mp3streamf );
+void ofOpenALSoundPlayer::closeStream(){
+#ifdef OF_USING_MPG123
+	if(mp3streamf){
+		mpg123_close(mp3streamf);
+		mpg123_delete(mp3streamf);
+	}
+	mp3streamf = 0;
+#endif
 
+	if(streamf){
+		sf_close(streamf);
+	}
+	streamf = 0;
+	streamWav.reset();
+}
 
-		mpg123_seek(mp3streamf,0,SEEK_END);
-		off_t samples = mpg123_tell(mp3streamf);
-		duration = float(samples/channels) / float(samplerate);
-		mpg123_seek(mp3streamf,0,SEEK_SET);
+//------------------------------------------------------------
+size_t ofOpenALSoundPlayer::readStream(short * out, size_t frames){
+	size_t read = 0;
+	if(streamWav){
+		read = std::min<uint64_t>(frames, numFrames - std::min(streamFrame, numFrames));
+		memcpy(out, streamWav->samples + streamFrame * channels, read * channels * sizeof(short));
 	}
+#ifdef OF_USING_MPG123
+	else if(mp3streamf){
+		auto bytes = reinterpret_cast<unsigned char *>(out);
+		size_t wanted = frames * channels * sizeof(short);
+		size_t done = 0;
+		while(read < wanted){
+			int ret = mpg123_read(mp3streamf, bytes + read, wanted - read, &done);
+			read += done;
+			if(ret != MPG123_OK || done == 0){
+				break;
+			}
+		}
+		read /= channels * sizeof(short);
+	}
+#endif
+	else if(streamf){
+		read = std::max<sf_count_t>(sf_readf_short(streamf, out, frames), 0);
+	}
+	streamFrame += read;
+	return read;
+}
 
-	int curr_buffer_size = mp3_buffer_size;
-	if(speed>1) curr_buffer_size *= (int)round(speed);
-	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
-	size_t done=0;
-	if(mpg123_read(mp3streamf,(unsigned char*)&buffer[0],curr_buffer_size*2,&done)==MPG123_DONE){
-		setPosition(0);
-		buffer.resize(done/2);
-		fftAuxBuffer.resize(done/2);
-		if(!bLoop) stopThread();
-		stream_end = true;
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::seekStream(uint64_t frame){
+	frame = std::min(frame, numFrames);
+#ifdef OF_USING_MPG123
+	if(mp3streamf){
+		mpg123_seek(mp3streamf, frame, SEEK_SET);
+	}
+#endif
+	if(streamf){
+		sf_seek(streamf, frame, SEEK_SET);
 	}
+	streamFrame = frame;
+}
 
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::decodeStream(){
+	uint32_t generation = streamGeneration.load(std::memory_order_acquire);
+	bool ended = false;
+	while(decoding){
+		auto requested = streamGeneration.load(std::memory_order_acquire);
+		if(requested != generation){
+			generation = requested;
+			seekStream(streamSeekFrame);
+			ended = false;
+		}
 
-	for(int i=0;i<(int)buffer.size();i++){
-		fftAuxBuffer[i] = float(buffer[i])/32565.f;
-	}
+		auto block = ended ? nullptr : streamRing.beginWrite();
+		if(!block){
+			std::unique_lock<std::mutex> lock(decoderMutex);
+			decoderCondition.wait_for(lock, std::chrono::milliseconds(10));
+			continue;
+		}
 
-	return true;
+		block->firstFrame = streamFrame;
+		block->frames = readStream(&block->samples[0], BUFFER_STREAM_SIZE);
+		block->generation = generation;
+		block->last = block->frames < BUFFER_STREAM_SIZE;
+		if(block->last && streamLoop){
+			seekStream(0);
+			block->last = false;
+		}
+		ended = block->last;
+		streamRing.endWrite();
+	}
 }
-#endif
 
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::stream(const std::filesystem::path& fileName, vector<short> & buffer){
-#ifdef OF_USING_MPG123
-	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3" || mp3streamf){
-		if(!mpg123Stream(fileName,buffer,fftAuxBuffer)) return false;
-	}else
-#endif
-		if(!sfStream(fileName,buffer,fftAuxBuffer)) return false;
+// called from the streaming thread with the mutex locked
+void ofOpenALSoundPlayer::feedStream(){
+	ALuint * voice = &sources[0];
+	auto generation = streamGeneration.load(std::memory_order_acquire);
+	if(generation != feederGeneration){
+		// seeked, drop what was queued before
+		alSourceStopv(channels, voice);
+		for(int i=0;i<channels;i++){
+			alSourcei(voice[i], AL_BUFFER, 0);
+		}
+		freeStreamBuffers.clear();
+		for(size_t i=0;i<NUM_STREAM_BUFFERS;i++){
+			freeStreamBuffers.push_back(i);
+		}
+		queuedFrames.clear();
+		feederGeneration = generation;
+		streamEnded = false;
+	}
 
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
+	// the state is read before unqueueing, if the sources stop after it
+	// they keep a processed buffer that playing again would repeat
+	bool playing = false;
+	for(int i=0;i<channels;i++){
+		ALint state;
+		alGetSourcei(voice[i], AL_SOURCE_STATE, &state);
+		playing |= state == AL_PLAYING;
+	}
 
+	// the sources of every channel might not be exactly in sync
+	ALint processed = NUM_STREAM_BUFFERS;
 	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
+		ALint channelProcessed;
+		alGetSourcei(voice[i], AL_BUFFERS_PROCESSED, &channelProcessed);
+		processed = std::min(processed, channelProcessed);
+	}
+	for(; processed > 0; processed--){
+		ALuint albuffer;
+		for(int i=0;i<channels;i++){
+			alSourceUnqueueBuffers(voice[i], 1, &albuffer);
 		}
+		size_t index = std::find(buffers.begin(), buffers.end(), albuffer) - buffers.begin();
+		freeStreamBuffers.push_back(index / channels);
+		queuedFrames.pop_front();
+	}
+
+	// blocks decoded before the last seek are skipped, the ones after a
+	// seek made since the generation was loaded wait for the next feed
+	while(!freeStreamBuffers.empty() && !streamEnded){
+		auto block = streamRing.front(generation);
+		if(!block){
+			break;
+		}
+		if(block->frames > 0){
+			size_t slot = freeStreamBuffers.back();
+			freeStreamBuffers.pop_back();
+			for(int i=0;i<channels;i++){
+				const short * samples = &block->samples[0];
+				if(channels>1){
+					for(size_t j=0;j<block->frames;j++){
+						channelBuffer[j] = block->samples[j*channels+i];
+					}
+					samples = &channelBuffer[0];
+				}
+				fftBuffers[i].resize(block->frames);
+				for(size_t j=0;j<block->frames;j++){
+					fftBuffers[i][j] = float(samples[j])/32565.f;
+				}
+				ALuint albuffer = buffers[slot*channels+i];
+				alBufferData(albuffer,AL_FORMAT_MONO16,samples,block->frames*sizeof(short),samplerate);
+				alSourceQueueBuffers(voice[i], 1, &albuffer);
+			}
+			queuedFrames.push_back(block->firstFrame);
+		}
+		streamEnded = block->last;
+		streamRing.pop();
+	}
+	decoderCondition.notify_one();
+
+	if(!playing){
+		ALint queued;
+		alGetSourcei(voice[0], AL_BUFFERS_QUEUED, &queued);
+		if(queued > 0){
+			// starting, or the decoder didn't keep up
+			alSourcePlayv(channels, voice);
+		}else if(streamEnded){
+			// finished, rewind for the next play
+			setPositionFrames(0);
+			stopThread();
+			return;
+		}
+	}
+
+	if(!queuedFrames.empty()){
+		ALint offset;
+		alGetSourcei(voice[0], AL_SAMPLE_OFFSET, &offset);
+		streamPosition = queuedFrames.front() + offset;
 	}
-	return true;
 }
 
-bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector<short> & buffer){
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector<short> & buffer, vector<float> & fftAuxBuffer){
 #ifdef OF_USING_MPG123
 	if(ofFilePath::getFileExt(fileName)!="mp3" && ofFilePath::getFileExt(fileName)!="MP3"){
 		if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
@@ -422,6 +620,9 @@ bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector
 #else
 	if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
 #endif
+	if(channels<=0){
+		return false;
+	}
 	fftBuffers.resize(channels);
 	int numFrames = buffer.size()/channels;
 
@@ -434,15 +635,78 @@ bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector
 	return true;
 }
 
+//------------------------------------------------------------
+shared_ptr<ofOpenALSoundPlayer::Sample> ofOpenALSoundPlayer::loadSample(const std::filesystem::path& fileName){
+	// players loading the same file share its buffers
+	static auto * cache = new ofSoundCache<Sample>;
+	return cache->get(fileName.string(), [&]{
+		return decodeSample(fileName);
+	});
+}
+
+//------------------------------------------------------------
+shared_ptr<ofOpenALSoundPlayer::Sample> ofOpenALSoundPlayer::decodeSample(const std::filesystem::path& fileName){
+	auto sample = make_shared<Sample>();
+	const short * pcm;
+	vector<short> decoded;
+	ofMappedWav wav;
+	if(wav.open(fileName)){
+		channels = wav.channels;
+		samplerate = wav.samplerate;
+		duration = float(wav.frames) / float(samplerate);
+		pcm = wav.samples;
+		sample->frames = wav.frames;
+		fftBuffers.resize(channels);
+		for(int i=0;i<channels;i++){
+			fftBuffers[i].resize(wav.frames);
+			for(uint64_t j=0;j<wav.frames;j++){
+				fftBuffers[i][j] = float(pcm[j*channels+i])/32565.f;
+			}
+		}
+	}else{
+		vector<float> fftAuxBuffer;
+		if(!readFile(fileName, decoded, fftAuxBuffer)){
+			return nullptr;
+		}
+		pcm = decoded.data();
+		sample->frames = decoded.size()/channels;
+	}
+	sample->channels = channels;
+	sample->samplerate = samplerate;
+	sample->duration = duration;
+	sample->fftBuffers.swap(fftBuffers);
+	fftBuffers.clear();
+
+	sample->buffers.resize(channels);
+	alGenBuffers(channels, &sample->buffers[0]);
+	vector<short> channelData;
+	for(int i=0;i<channels;i++){
+		const short * data = pcm;
+		if(channels>1){
+			channelData.resize(sample->frames);
+			for(uint64_t j=0;j<sample->frames;j++){
+				channelData[j] = pcm[j*channels+i];
+			}
+			data = channelData.data();
+		}
+		alGetError(); // Clear error.
+		alBufferData(sample->buffers[i],AL_FORMAT_MONO16,data,sample->frames*sizeof(short),samplerate);
+		ALenum err = alGetError();
+		if (err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create buffer for \"" << fileName << "\": "
+			<< (int) err << " " << getALErrorString(err);
+			return nullptr;
+		}
+	}
+
+	return sample;
+}
+
 //------------------------------------------------------------
 bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_stream){
 
 	std::filesystem::path fileName = ofToDataPath(_fileName);
 
-	bMultiPlay = false;
-	isStreaming = is_stream;
-	int err = AL_NO_ERROR;
-
 	// [1] init sound systems, if necessary
 	initialize();
 
@@ -451,125 +715,92 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 	// if they call "loadSound" repeatedly, for example
 
 	unload();
-	ALenum format=AL_FORMAT_MONO16;
+	bMultiPlay = false;
+	isStreaming = is_stream;
 	bLoadedOk = false;
 
-	if(!isStreaming){
-		readFile(fileName, buffer);
-	}else{
-		stream(fileName, buffer);
-	}
-
-	int numFrames = buffer.size()/channels;
-
 	if(isStreaming){
-		buffers.resize(channels*2);
-	}else{
-		buffers.resize(channels);
-	}
-	alGenBuffers(buffers.size(), &buffers[0]);
-	if(channels==1){
-		sources.resize(1);
-		alGetError(); // Clear error.
-		alGenSources(1, &sources[0]);
-		err = alGetError();
-		if (err != AL_NO_ERROR){
-			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't generate source for \"" << fileName << "\": "
-			<< (int) err << " " << getALErrorString(err);
-			return false;
-		}
-
-		for(int i=0; i<(int)buffers.size(); i++){
-			alGetError(); // Clear error.
-			alBufferData(buffers[i],format,&buffer[0],buffer.size()*2,samplerate);
-			err = alGetError();
-			if (err != AL_NO_ERROR){
-				ofLogError("ofOpenALSoundPlayer:") << "loadSound(): couldn't create buffer for \"" << fileName << "\": "
-				<< (int) err << " " << getALErrorString(err);
-				return false;
-			}
-			if(isStreaming){
-				stream(fileName,buffer);
-			}
-		}
-		if(isStreaming){
-			alSourceQueueBuffers(sources[0],buffers.size(),&buffers[0]);
-		}else{
-			alSourcei (sources[0], AL_BUFFER,   buffers[0]);
+		if(!openStream(fileName)) return false;
+
+		// the decoder starts filling the ring right away so playing
+		// doesn't have to wait for it
+		streamRing.allocate(NUM_STREAM_BLOCKS, BUFFER_STREAM_SIZE*channels);
+		channelBuffer.resize(BUFFER_STREAM_SIZE);
+		fftBuffers.assign(channels, vector<float>());
+		streamSeekFrame = 0;
+		streamPosition = 0;
+		streamLoop = bLoop;
+		feederGeneration = streamGeneration;
+		streamEnded = false;
+		queuedFrames.clear();
+		freeStreamBuffers.clear();
+		for(size_t i=0;i<NUM_STREAM_BUFFERS;i++){
+			freeStreamBuffers.push_back(i);
 		}
-
-		alSourcef (sources[0], AL_PITCH,    1.0f);
-		alSourcef (sources[0], AL_GAIN,     1.0f);
-	    alSourcef (sources[0], AL_ROLLOFF_FACTOR,  0.0);
-	    alSourcei (sources[0], AL_SOURCE_RELATIVE, AL_TRUE);
+		buffers.resize(channels*NUM_STREAM_BUFFERS);
+		alGenBuffers(buffers.size(), &buffers[0]);
+		decoding = true;
+		decoderThread = std::thread(&ofOpenALSoundPlayer::decodeStream, this);
 	}else{
-		vector<vector<short> > multibuffer;
-		multibuffer.resize(channels);
-		sources.resize(channels);
-		alGenSources(channels, &sources[0]);
-		if(isStreaming){
-			for(int s=0; s<2;s++){
-				for(int i=0;i<channels;i++){
-					multibuffer[i].resize(buffer.size()/channels);
-					for(int j=0;j<numFrames;j++){
-						multibuffer[i][j] = buffer[j*channels+i];
-					}
-					alGetError(); // Clear error.
-					alBufferData(buffers[s*2+i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
-					err = alGetError();
-					if ( err != AL_NO_ERROR){
-						ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
-						return false;
-					}
-					alSourceQueueBuffers(sources[i],1,&buffers[s*2+i]);
-					stream(fileName,buffer);
-				}
-			}
-		}else{
-			for(int i=0;i<channels;i++){
-				multibuffer[i].resize(buffer.size()/channels);
-				for(int j=0;j<numFrames;j++){
-					multibuffer[i][j] = buffer[j*channels+i];
-				}
-				alGetError(); // Clear error.
-				alBufferData(buffers[i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
-				err = alGetError();
-				if (err != AL_NO_ERROR){
-					ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": "
-					<< (int) err << " " << getALErrorString(err);
-					return false;
-				}
-				alSourcei (sources[i], AL_BUFFER,   buffers[i]   );
-			}
-		}
-
+		sample = loadSample(fileName);
+		if(!sample) return false;
+		channels = sample->channels;
+		samplerate = sample->samplerate;
+		duration = sample->duration;
+		numFrames = sample->frames;
+	}
 
+	sources.resize(channels);
+	if(!acquireSources(&sources[0], channels)){
+		ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't generate sources for \"" << fileName << "\"";
+		sources.clear();
+		unload();
+		return false;
+	}
+	initSources(&sources[0]);
+	if(!isStreaming){
 		for(int i=0;i<channels;i++){
-			err = alGetError();
-			if (err != AL_NO_ERROR){
-				ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo sources for \"" << fileName << "\": "
-				<< (int) err << " " << getALErrorString(err);
-				return false;
-			}
-
-			// only stereo panning
-			if(i==0){
-				float pos[3] = {-1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}else{
-				float pos[3] = {1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}
-			alSourcef (sources[i], AL_ROLLOFF_FACTOR,  0.0);
-			alSourcei (sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
+			alSourcei(sources[i], AL_BUFFER, sample->buffers[i]);
 		}
 	}
+	applyVoiceSettings();
 
 	bLoadedOk = true;
 	return bLoadedOk;
 
 }
 
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::initSources(ALuint * voice){
+	for(int i=0;i<channels;i++){
+		// sources from the pool keep the settings of their last voice
+		alSourcef (voice[i], AL_PITCH,    1.0f);
+		alSourcef (voice[i], AL_GAIN,     1.0f);
+		alSourcei (voice[i], AL_LOOPING,  AL_FALSE);
+		alSourcef (voice[i], AL_ROLLOFF_FACTOR,  0.0);
+		alSourcei (voice[i], AL_SOURCE_RELATIVE, AL_TRUE);
+		// only stereo panning
+		float pos[3] = {0,0,0};
+		if(channels>1){
+			pos[0] = i==0 ? -1 : 1;
+		}
+		alSourcefv(voice[i],AL_POSITION,pos);
+	}
+}
+
+//------------------------------------------------------------
+// applies speed, loop, volume and pan to the last voice
+void ofOpenALSoundPlayer::applyVoiceSettings(){
+	for(int i=0;i<channels;i++){
+		alSourcef(sources[sources.size()-channels+i],AL_PITCH,speed);
+		alSourcei(sources[sources.size()-channels+i],AL_LOOPING,bLoop && !bMultiPlay && !isStreaming?AL_TRUE:AL_FALSE);
+	}
+	if(channels==1){
+		setVolume(volume);
+	}
+	setPan(pan);
+}
+
 //------------------------------------------------------------
 bool ofOpenALSoundPlayer::isLoaded() const{
 	return bLoadedOk;
@@ -577,52 +808,10 @@ bool ofOpenALSoundPlayer::isLoaded() const{
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::threadedFunction(){
-	vector<vector<short> > multibuffer;
-	multibuffer.resize(channels);
 	while(isThreadRunning()){
-		std::unique_lock<std::mutex> lock(mutex);
-		for(int i=0; i<int(sources.size())/channels; i++){
-			int processed;
-			alGetSourcei(sources[i*channels], AL_BUFFERS_PROCESSED, &processed);
-
-			while(processed--)
-			{
-				stream("",buffer);
-				int numFrames = buffer.size()/channels;
-				if(channels>1){
-					for(int j=0;j<channels;j++){
-						multibuffer[j].resize(buffer.size()/channels);
-						for(int k=0;k<numFrames;k++){
-							multibuffer[j][k] = buffer[k*channels+j];
-						}
-						ALuint albuffer;
-						alSourceUnqueueBuffers(sources[i*channels+j], 1, &albuffer);
-						alBufferData(albuffer,AL_FORMAT_MONO16,&multibuffer[j][0],buffer.size()*2/channels,samplerate);
-						alSourceQueueBuffers(sources[i*channels+j], 1, &albuffer);
-					}
-				}else{
-					ALuint albuffer;
-					alSourceUnqueueBuffers(sources[i], 1, &albuffer);
-					alBufferData(albuffer,AL_FORMAT_MONO16,&buffer[0],buffer.size()*2/channels,samplerate);
-					alSourceQueueBuffers(sources[i], 1, &albuffer);
-				}
-				if(stream_end){
-					break;
-				}
-			}
-			ALint state;
-			alGetSourcei(sources[i*channels],AL_SOURCE_STATE,&state);
-			bool stream_running=false;
-			#ifdef OF_USING_MPG123
-				stream_running = streamf || mp3streamf;
-			#else
-				stream_running = streamf;
-			#endif
-			if(state != AL_PLAYING && stream_running && !stream_end){
-				alSourcePlayv(channels,&sources[i*channels]);
-			}
-
-			stream_end = false;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			feedStream();
 		}
 		sleep(1);
 	}
@@ -635,10 +824,9 @@ void ofOpenALSoundPlayer::update(ofEventArgs & args){
 		ALint state;
 		alGetSourcei(sources[i*channels],AL_SOURCE_STATE,&state);
 		if(state != AL_PLAYING){
-			alDeleteSources(channels,&sources[i*channels]);
-			for(int j=0;j<channels;j++){
-				sources.erase(sources.begin()+i*channels);
-			}
+			// finished voices go back to the pool for the next ones
+			releaseSources(&sources[i*channels],channels);
+			sources.erase(sources.begin()+i*channels,sources.begin()+(i+1)*channels);
 		}else{
 			i++;
 		}
@@ -650,31 +838,31 @@ void ofOpenALSoundPlayer::unload(){
 	stop();
 	ofRemoveListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
 
+	if(decoderThread.joinable()){
+		decoding = false;
+		decoderCondition.notify_one();
+		decoderThread.join();
+	}
+
 	// Only lock the thread where necessary.
 	{
 		std::unique_lock<std::mutex> lock(mutex);
 
-		// Delete sources before buffers.
-		alDeleteSources(sources.size(),&sources[0]);
-		alDeleteBuffers(buffers.size(),&buffers[0]);
+		// Release sources before deleting the buffers.
+		releaseSources(sources.data(),sources.size());
+		if(!buffers.empty()){
+			alDeleteBuffers(buffers.size(),&buffers[0]);
+		}
 
 		sources.clear();
 		buffers.clear();
 	}
+	sample.reset();
 
 	// Free resources and close file descriptors.
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		mpg123_close(mp3streamf);
-		mpg123_delete(mp3streamf);
-	}
-	mp3streamf = 0;
-#endif
-
-	if(streamf){
-		sf_close(streamf);
-	}
-	streamf = 0;
+	closeStream();
+	streamRing.clear();
+	fftBuffers.clear();
 
 	bLoadedOk = false;
 }
@@ -732,49 +920,60 @@ void ofOpenALSoundPlayer::setVolume(float vol){
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPosition(float pct){
-	setPositionMS(duration*pct*1000.f);
+	setPositionFrames(glm::clamp(pct, 0.f, 1.f) * numFrames);
 }
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPositionMS(int ms){
+	setPositionFrames(uint64_t(std::max(ms, 0)) * samplerate / 1000);
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::setPositionFrames(uint64_t frame){
 	if(sources.empty()) return;
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		mpg123_seek(mp3streamf,float(ms)/1000.f*samplerate,SEEK_SET);
-	}else
-#endif
-	if(streamf){
-        stream_samples_read = sf_seek(streamf,float(ms)/1000.f*samplerate,SEEK_SET) * channels;
+	frame = std::min(frame, numFrames);
+	if(isStreaming){
+		// the decoder seeks and the streaming thread drops what was
+		// queued when they see the new generation
+		streamSeekFrame = frame;
+		streamPosition = frame;
+		streamGeneration.fetch_add(1, std::memory_order_release);
+		decoderCondition.notify_one();
 	}else{
 		for(int i=0;i<(int)channels;i++){
-			alSourcef(sources[sources.size()-channels+i],AL_SEC_OFFSET,float(ms)/1000.f);
+			alSourcei(sources[sources.size()-channels+i],AL_SAMPLE_OFFSET,frame);
 		}
 	}
 }
 
 //------------------------------------------------------------
 float ofOpenALSoundPlayer::getPosition() const{
-	if(duration==0 || sources.empty())
+	if(numFrames==0 || sources.empty())
 		return 0;
 	else
-		return getPositionMS()/(1000.f*duration);
+		return float(getPositionFrames())/float(numFrames);
 }
 
 //------------------------------------------------------------
 int ofOpenALSoundPlayer::getPositionMS() const{
+	if(samplerate==0) return 0;
+	return getPositionFrames() * 1000 / samplerate;
+}
+
+//------------------------------------------------------------
+uint64_t ofOpenALSoundPlayer::getPositionFrames() const{
 	if(sources.empty()) return 0;
-	float pos;
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		pos = float(mpg123_tell(mp3streamf)) / float(samplerate);
-	}else
-#endif
-	if(streamf){
-		pos = float(stream_samples_read) / float(channels) / float(samplerate);
-	}else{
-		alGetSourcef(sources[sources.size()-1],AL_SEC_OFFSET,&pos);
+	if(isStreaming){
+		return streamPosition;
 	}
-	return pos * 1000.f;
+	ALint offset;
+	alGetSourcei(sources[sources.size()-channels],AL_SAMPLE_OFFSET,&offset);
+	return offset;
+}
+
+//------------------------------------------------------------
+uint64_t ofOpenALSoundPlayer::getNumFrames() const{
+	return numFrames;
 }
 
 //------------------------------------------------------------
@@ -808,15 +1007,20 @@ void ofOpenALSoundPlayer::setPan(float p){
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPaused(bool bP){
 	if(sources.empty()) return;
-	std::unique_lock<std::mutex> lock(mutex);
 	if(bP){
-		alSourcePausev(sources.size(),&sources[0]);
+		// the streaming thread would restart the sources
 		if(isStreaming){
-			stopThread();
+			waitForThread(true);
 		}
+		std::unique_lock<std::mutex> lock(mutex);
+		alSourcePausev(sources.size(),&sources[0]);
 	}else{
-		alSourcePlayv(sources.size(),&sources[0]);
-		if(isStreaming){
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			alSourcePlayv(sources.size(),&sources[0]);
+		}
+		if(isStreaming && !isThreadRunning()){
+			waitForThread(false);
 			startThread();
 		}
 	}
@@ -827,10 +1031,11 @@ void ofOpenALSoundPlayer::setPaused(bool bP){
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setSpeed(float spd){
+	speed = spd;
+	if(sources.empty()) return;
 	for(int i=0;i<channels;i++){
 		alSourcef(sources[sources.size()-channels+i],AL_PITCH,spd);
 	}
-	speed = spd;
 }
 
 
@@ -838,7 +1043,10 @@ void ofOpenALSoundPlayer::setSpeed(float spd){
 void ofOpenALSoundPlayer::setLoop(bool bLp){
 	if(bMultiPlay) return; // no looping on multiplay
 	bLoop = bLp;
-	if(isStreaming) return;
+	if(isStreaming){
+		streamLoop = bLp;
+		return;
+	}
 	for(int i=0;i<(int)sources.size();i++){
 		alSourcei(sources[i],AL_LOOPING,bLp?AL_TRUE:AL_FALSE);
 	}
@@ -861,63 +1069,56 @@ void ofOpenALSoundPlayer::setMultiPlay(bool bMp){
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::play(){
+	if(sources.empty()) return;
+
+	if(isStreaming){
+		// the streaming thread starts the sources once it queues the first
+		// blocks, it can't be started with the mutex locked
+		waitForThread(true);
+		if(streamPosition != 0 || streamSeekFrame != 0){
+			setPositionFrames(0);
+		}
+		startThread();
+		return;
+	}
+
 	std::unique_lock<std::mutex> lock(mutex);
-	int err = glGetError();
 
 	// if the sound is set to multiplay, then create new sources,
 	// do not multiplay on loop or we won't be able to stop it
 	if (bMultiPlay && !bLoop){
 		sources.resize(sources.size()+channels);
-		alGetError(); // Clear error.
-		alGenSources(channels, &sources[sources.size()-channels]);
-		err = alGetError();
-		if (err != AL_NO_ERROR){
-			ofLogError("ofOpenALSoundPlayer") << "play(): couldn't create multiplay stereo sources: "
-			<< (int) err << " " << getALErrorString(err);
+		ALuint * voice = &sources[sources.size()-channels];
+		if(!acquireSources(voice, channels)){
+			sources.resize(sources.size()-channels);
 			return;
 		}
+		initSources(voice);
 		for(int i=0;i<channels;i++){
-			alSourcei (sources[sources.size()-channels+i], AL_BUFFER,   buffers[i]   );
-			// only stereo panning
-			if(i==0){
-				float pos[3] = {-1,0,0};
-				alSourcefv(sources[sources.size()-channels+i],AL_POSITION,pos);
-			}else{
-				float pos[3] = {1,0,0};
-				alSourcefv(sources[sources.size()-channels+i],AL_POSITION,pos);
-			}
-		    alSourcef (sources[sources.size()-channels+i], AL_ROLLOFF_FACTOR,  0.0);
-		    alSourcei (sources[sources.size()-channels+i], AL_SOURCE_RELATIVE, AL_TRUE);
-		}
-
-		err = glGetError();
-		if (err != AL_NO_ERROR){
-			ofLogError("ofOpenALSoundPlayer") << "play(): couldn't assign multiplay buffers: "
-			<< (int) err << " " << getALErrorString(err);
-			return;
+			alSourcei(voice[i], AL_BUFFER, sample->buffers[i]);
 		}
+		applyVoiceSettings();
 	}
 	alSourcePlayv(channels,&sources[sources.size()-channels]);
 
 	if(bMultiPlay){
 		ofAddListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
 	}
-	if(isStreaming){
-		setPosition(0);
-		stream_end = false;
-		startThread();
-	}
-
 }
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::stop(){
 	if(sources.empty()) return;
-	std::unique_lock<std::mutex> lock(mutex);
-	alSourceStopv(channels,&sources[sources.size()-channels]);
 	if(isStreaming){
-		setPosition(0);
-		stopThread();
+		// the streaming thread would restart the sources
+		waitForThread(true);
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		alSourceStopv(channels,&sources[sources.size()-channels]);
+	}
+	if(isStreaming){
+		setPositionFrames(0);
 	}
 }
 
@@ -948,6 +1149,12 @@ float * ofOpenALSoundPlayer::getCurrentBufferSum(int size){
 		windowedSignal.resize(size);
 	}
 	windowedSignal.assign(windowedSignal.size(),0);
+	// streams keep the last block queued, updated by the streaming thread
+	std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+	if(isStreaming){
+		lock.lock();
+	}
+	const auto & fftBuffers = sample ? sample->fftBuffers : this->fftBuffers;
 	for(int k=0;k<int(sources.size())/channels;k++){
 		if(!isStreaming){
 			ALint state;
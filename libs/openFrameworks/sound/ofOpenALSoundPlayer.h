@@ -4,7 +4,11 @@
 
 #ifdef OF_SOUND_PLAYER_OPENAL
 #include "ofSoundBaseTypes.h"
+#include "ofSoundDecoding.h"
 #include "ofThread.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 
 
 
@@ -51,6 +55,17 @@ float * ofFmodSoundGetSpectrum(int nBands);		// max 512...
 
 
 // --------------------- player functions:
+/// \brief Sound player using OpenAL, libsndfile and mpg123.
+///
+/// Sounds loaded without streaming are decoded once and shared by all the
+/// players that load the same file, so many players, or a player with
+/// multiplay, don't duplicate the samples. The sources of multiplay voices
+/// are recycled from a pool when they finish.
+///
+/// Streamed sounds are decoded ahead by a decoder thread into a lock free
+/// ring of blocks that the streaming thread queues into OpenAL, so decoding
+/// never blocks the app or the playback. 16 bit PCM wav files are memory
+/// mapped instead of read, both when loading and when streaming.
 class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 
 	public:
@@ -72,9 +87,15 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		void setPosition(float pct); // 0 = start, 1 = end;
 		void setPositionMS(int ms);
 
+		/// \brief Sets the position in frames, exact for files that can seek
+		/// to any sample, like wav or mp3 files.
+		void setPositionFrames(uint64_t frame);
+
 
 		float getPosition() const;
 		int getPositionMS() const;
+		uint64_t getPositionFrames() const;
+		uint64_t getNumFrames() const;
 		bool isPlaying() const;
 		float getSpeed() const;
 		float getPan() const;
@@ -94,23 +115,33 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 
 	private:
 		friend void ofOpenALSoundUpdate();
+		struct Sample;
+
 		void update(ofEventArgs & args);
 		void initFFT(int bands);
 		float * getCurrentBufferSum(int size);
+		void initSources(ALuint * voice);
+		void applyVoiceSettings();
 
 		static void createWindow(int size);
 		static void runWindow(std::vector<float> & signal);
 		static void initSystemFFT(int bands);
 
         bool sfReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool sfStream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
 #ifdef OF_USING_MPG123
         bool mpg123ReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool mpg123Stream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
 #endif
 
-        bool readFile(const std::filesystem::path& fileName,std::vector<short> & buffer);
-        bool stream(const std::filesystem::path& fileName, std::vector<short> & buffer);
+        bool readFile(const std::filesystem::path& fileName,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        std::shared_ptr<Sample> loadSample(const std::filesystem::path& fileName);
+        std::shared_ptr<Sample> decodeSample(const std::filesystem::path& fileName);
+
+        bool openStream(const std::filesystem::path& fileName);
+        void closeStream();
+        std::size_t readStream(short * out, std::size_t frames);
+        void seekStream(uint64_t frame);
+        void decodeStream();
+        void feedStream();
 
 		bool isStreaming;
 		bool bMultiPlay;
@@ -131,6 +162,8 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		int channels;
 		float duration; //in secs
 		int samplerate;
+		uint64_t numFrames;
+		std::shared_ptr<Sample> sample;
 		std::vector<ALuint> buffers;
 		std::vector<ALuint> sources;
 
@@ -147,19 +180,32 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static std::vector<float> systemBins;
 		static std::vector<kiss_fft_cpx> systemCx_out;
 
+		// decoder, only used by the decoder thread once it's started
 		SNDFILE* streamf;
-		size_t stream_samples_read;
 #ifdef OF_USING_MPG123
 		mpg123_handle * mp3streamf;
-		int stream_encoding;
 #endif
-		int mp3_buffer_size;
-		int stream_subformat;
-		double stream_scale;
-		std::vector<short> buffer;
-		std::vector<float> fftAuxBuffer;
-
-		bool stream_end;
+		std::unique_ptr<ofMappedWav> streamWav;
+		uint64_t streamFrame;
+
+		// blocks from the decoder to the streaming thread. Seeking increments
+		// the generation so the blocks decoded before are discarded
+		ofSoundStreamRing streamRing;
+		std::atomic<uint32_t> streamGeneration;
+		std::atomic<uint64_t> streamSeekFrame;
+		std::atomic<uint64_t> streamPosition;
+		std::atomic<bool> streamLoop;
+		std::atomic<bool> decoding;
+		std::thread decoderThread;
+		std::mutex decoderMutex;
+		std::condition_variable decoderCondition;
+
+		// streaming thread state
+		uint32_t feederGeneration;
+		std::vector<std::size_t> freeStreamBuffers;
+		std::deque<uint64_t> queuedFrames;
+		std::vector<short> channelBuffer;
+		bool streamEnded;
 };
 
 #endif
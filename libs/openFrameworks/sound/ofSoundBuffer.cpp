@@ -7,6 +7,7 @@
 
 #include "ofSoundBuffer.h"
 #include "ofSoundUtils.h"
+#include "ofSoundResampler.h"
 #include "ofLog.h"
 #include <limits>
 #include "glm/trigonometric.hpp"
@@ -472,6 +473,101 @@ void ofSoundBuffer::hermiteResampleTo(ofSoundBuffer &outBuffer, std::size_t from
 	}
 }
 
+struct ofSoundBuffer::SincState{
+	const ofSoundBuffer * owner = nullptr;
+	ofSoundResampler resampler;
+	float speed = 0;
+	std::size_t channels = 0;
+	const float * data = nullptr;
+	std::size_t frames = 0;
+	bool loop = false;
+	// input position of the next output frame and next input frame to
+	// give to the resampler, not wrapped when looping
+	double end = 0;
+	std::size_t fed = 0;
+	std::vector<float> block;
+};
+
+void ofSoundBuffer::sincResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
+	std::size_t inChannels = getNumChannels();
+	std::size_t inFrames = getNumFrames();
+	bool bufferReady = prepareBufferForResampling(*this, outBuffer, numFrames);
+	
+	if(!bufferReady) {
+		outBuffer = *this;
+		return;
+	}
+	
+	const std::size_t blockFrames = 1024;
+	// copies of this buffer share the pointer, they get their own state
+	// on first use
+	if(!sincState || sincState->owner != this){
+		sincState = std::make_shared<SincState>();
+		sincState->owner = this;
+	}
+	auto & state = *sincState;
+	auto & resampler = state.resampler;
+	
+	// a call that starts less than a frame from where the last one ended
+	// continues the same stream with its fractional position
+	double distance = fromFrame - state.end;
+	if(loop && inFrames > 0){
+		distance -= round(distance / inFrames) * inFrames;
+	}
+	bool continues = state.data == buffer.data() && state.frames == inFrames && state.loop == loop && fabs(distance) < 1;
+	if(state.speed != speed || state.channels != inChannels){
+		// only rebuilds the filter when the speed changes
+		resampler.setup(speed, inChannels, ofSoundResampler::Normal, blockFrames);
+		state.speed = speed;
+		state.channels = inChannels;
+		continues = false;
+	}
+	
+	// copies frames to the block, wrapped when looping and silence outside
+	// of the buffer otherwise
+	auto fill = [&](int64_t position, std::size_t frames){
+		state.block.resize(frames * inChannels);
+		for(std::size_t i = 0; i < frames; i++, position++){
+			int64_t frame = position;
+			if(loop && inFrames > 0){
+				frame %= int64_t(inFrames);
+				if(frame < 0){
+					frame += inFrames;
+				}
+			}
+			if(frame >= 0 && frame < int64_t(inFrames)){
+				memcpy(&state.block[i * inChannels], &buffer[frame * inChannels], inChannels * sizeof(float));
+			}else{
+				memset(&state.block[i * inChannels], 0, inChannels * sizeof(float));
+			}
+		}
+	};
+	
+	if(!continues){
+		// the filter starts on the frames before fromFrame instead of on
+		// silence
+		resampler.reset();
+		std::size_t history = resampler.getLatency() - 1;
+		fill(int64_t(fromFrame) - int64_t(history), history);
+		resampler.prime(state.block.data(), history);
+		state.data = buffer.data();
+		state.frames = inFrames;
+		state.loop = loop;
+		state.end = fromFrame;
+		state.fed = fromFrame;
+	}
+	
+	float * resBufferPtr = &outBuffer[0];
+	std::size_t done = 0;
+	while(done < numFrames){
+		std::size_t frames = std::min(blockFrames, resampler.getInputFramesNeeded(numFrames - done));
+		fill(state.fed, frames);
+		state.fed += frames;
+		done += resampler.process(state.block.data(), frames, resBufferPtr + done * inChannels, numFrames - done);
+	}
+	state.end += double(numFrames) * speed;
+}
+
 void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop, InterpolationAlgorithm algorithm) const {
 	switch(algorithm){
 		case Linear:
@@ -480,13 +576,31 @@ void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, st
 		case Hermite:
 			hermiteResampleTo(buffer, fromFrame, numFrames, speed, loop);
 			break;
+		case Sinc:
+			sincResampleTo(buffer, fromFrame, numFrames, speed, loop);
+			break;
 	}
 }
 
 void ofSoundBuffer::resample(float speed, InterpolationAlgorithm algorithm){
+	std::size_t inFrames = getNumFrames();
+	std::size_t outFrames = ceilf(inFrames / speed);
+	if(algorithm == Sinc){
+		ofSoundResampler resampler;
+		resampler.setup(speed, channels, ofSoundResampler::Normal, inFrames);
+		// the history is as long as the input so the resampler copies all
+		// of it before writing and the output can overwrite it
+		if(outFrames > inFrames){
+			buffer.resize(outFrames * channels);
+		}
+		std::size_t done = resampler.process(buffer.data(), inFrames, buffer.data(), outFrames);
+		done += resampler.flush(buffer.data() + done * channels, outFrames - done);
+		buffer.resize(done * channels);
+		return;
+	}
 	ofSoundBuffer resampled;
-	resampleTo(resampled, 0, ceilf(getNumFrames() / speed), speed, false, algorithm);
-	*this = resampled;
+	resampleTo(resampled, 0, outFrames, speed, false, algorithm);
+	buffer.swap(resampled.buffer);
 }
 
 void ofSoundBuffer::getChannel(ofSoundBuffer & targetBuffer, std::size_t sourceChannel) const {
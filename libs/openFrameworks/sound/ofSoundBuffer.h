@@ -88,7 +88,9 @@ public:
 
 	enum InterpolationAlgorithm{
 		Linear,
-		Hermite
+		Hermite,
+		/// band-limited windowed sinc, see ofSoundResampler. slower but doesn't alias
+		Sinc
 	};
 	static InterpolationAlgorithm defaultAlgorithm;  //defaults to Linear for mobile, Hermite for desktop
 
@@ -97,7 +99,9 @@ public:
 	/// sample rate of the audio in this buffer
 	unsigned int getSampleRate() const { return samplerate; }
 	void setSampleRate(unsigned int rate);
-	/// resample by changing the playback speed, keeping the same sampleRate
+	/// resample by changing the playback speed, keeping the same sampleRate.
+	/// with Sinc the result is written back to this buffer, the resampler
+	/// copies the input into its own history first
 	void resample(float speed, InterpolationAlgorithm algorithm=defaultAlgorithm);
 	/// the number of channels per frame
 	std::size_t getNumChannels() const { return channels; }
@@ -176,6 +180,8 @@ public:
 
 	/// resample our data to outBuffer at the given target speed, starting at fromFrame and copying numFrames of data. resize outBuffer to fit.
 	/// speed is relative to current speed (ie 1.0f == no change). lower speeds will give a larger outBuffer, higher speeds a smaller outBuffer.
+	/// with Sinc the filter is kept between calls, and a call starting less than a frame away from where the last one ended
+	/// continues from its exact position, so a sound can be resampled block by block. not safe to call from several threads at once.
 	void resampleTo(ofSoundBuffer & outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop = false, InterpolationAlgorithm algorithm = defaultAlgorithm) const;
 	
 	/// copy the requested channel of our data to outBuffer. resize outBuffer to fit.
@@ -188,6 +194,7 @@ public:
 	
 	void linearResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	void hermiteResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
+	void sincResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	
 	/// fills the buffer with random noise between -amplitude and amplitude. useful for debugging.
 	void fillWithNoise(float amplitude = 1.0f);
@@ -227,6 +234,11 @@ protected:
 
 	uint64_t tickCount;
 	int soundStreamDeviceID;
+
+private:
+	// state of sincResampleTo kept between calls
+	struct SincState;
+	mutable std::shared_ptr<SincState> sincState;
 };
 
 namespace std{
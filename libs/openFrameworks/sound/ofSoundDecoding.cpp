@@ -0,0 +1,192 @@
+#include "ofSoundDecoding.h"
+#include <cstring>
+
+#ifndef TARGET_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace{
+	uint16_t readLE16(const unsigned char * p){
+		return p[0] | (p[1] << 8);
+	}
+
+	uint32_t readLE32(const unsigned char * p){
+		return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+	}
+}
+
+//------------------------------------------------------------
+ofMappedWav::~ofMappedWav(){
+	close();
+}
+
+//------------------------------------------------------------
+bool ofMappedWav::map(const std::filesystem::path & path){
+#ifdef TARGET_WIN32
+	HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE){
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0){
+		CloseHandle(file);
+		return false;
+	}
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(!mapping){
+		return false;
+	}
+	data = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if(!data){
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return false;
+	}
+	size = fileSize.QuadPart;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		return false;
+	}
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0 || fileStat.st_size == 0){
+		::close(fd);
+		return false;
+	}
+	void * mapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(mapped == MAP_FAILED){
+		return false;
+	}
+	data = static_cast<const unsigned char *>(mapped);
+	size = fileStat.st_size;
+#endif
+	return true;
+}
+
+//------------------------------------------------------------
+bool ofMappedWav::open(const std::filesystem::path & path){
+	close();
+
+	// the samples can only be used in place in little endian machines
+	const uint16_t one = 1;
+	if(*reinterpret_cast<const unsigned char *>(&one) != 1 || !map(path)){
+		return false;
+	}
+	if(size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0){
+		close();
+		return false;
+	}
+
+	bool pcm16 = false;
+	size_t pos = 12;
+	while(pos + 8 <= size){
+		const unsigned char * id = data + pos;
+		uint64_t chunkSize = readLE32(data + pos + 4);
+		pos += 8;
+		if(memcmp(id, "fmt ", 4) == 0 && chunkSize >= 16 && pos + 16 <= size){
+			uint16_t format = readLE16(data + pos);
+			// WAVE_FORMAT_EXTENSIBLE, the format is the start of the sub format
+			if(format == 0xFFFE && chunkSize >= 40 && pos + 40 <= size){
+				format = readLE16(data + pos + 24);
+			}
+			channels = readLE16(data + pos + 2);
+			samplerate = readLE32(data + pos + 4);
+			pcm16 = format == 1 && readLE16(data + pos + 14) == 16 && channels > 0;
+		}else if(memcmp(id, "data", 4) == 0){
+			if(!pcm16 || pos % sizeof(short) != 0){
+				break;
+			}
+			samples = reinterpret_cast<const short *>(data + pos);
+			frames = std::min<uint64_t>(chunkSize, size - pos) / (sizeof(short) * channels);
+			return true;
+		}
+		pos += chunkSize + (chunkSize & 1);
+	}
+	close();
+	return false;
+}
+
+//------------------------------------------------------------
+void ofMappedWav::close(){
+	if(data){
+#ifdef TARGET_WIN32
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		mapping = nullptr;
+#else
+		munmap(const_cast<unsigned char *>(data), size);
+#endif
+	}
+	data = nullptr;
+	size = 0;
+	samples = nullptr;
+	frames = 0;
+	channels = 0;
+	samplerate = 0;
+}
+
+//------------------------------------------------------------
+void ofSoundStreamRing::allocate(size_t numBlocks, size_t samplesPerBlock){
+	blocks.resize(numBlocks);
+	for(auto & block: blocks){
+		block.samples.resize(samplesPerBlock);
+		block.frames = 0;
+		block.last = false;
+	}
+	head = 0;
+	tail = 0;
+}
+
+//------------------------------------------------------------
+void ofSoundStreamRing::clear(){
+	blocks.clear();
+	head = 0;
+	tail = 0;
+}
+
+//------------------------------------------------------------
+ofSoundStreamBlock * ofSoundStreamRing::beginWrite(){
+	auto h = head.load(std::memory_order_relaxed);
+	if(blocks.empty() || h - tail.load(std::memory_order_acquire) == blocks.size()){
+		return nullptr;
+	}
+	return &blocks[h % blocks.size()];
+}
+
+//------------------------------------------------------------
+void ofSoundStreamRing::endWrite(){
+	head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------
+const ofSoundStreamBlock * ofSoundStreamRing::front(uint32_t generation){
+	auto t = tail.load(std::memory_order_relaxed);
+	for(; t != head.load(std::memory_order_acquire); t++){
+		auto & block = blocks[t % blocks.size()];
+		// compared by their difference so the generations can wrap around
+		auto age = int32_t(generation - block.generation);
+		if(age <= 0){
+			tail.store(t, std::memory_order_release);
+			return age == 0 ? &block : nullptr;
+		}
+	}
+	tail.store(t, std::memory_order_release);
+	return nullptr;
+}
+
+//------------------------------------------------------------
+void ofSoundStreamRing::pop(){
+	tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------
+size_t ofSoundStreamRing::getNumBlocks() const{
+	return blocks.size();
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+
+/// \brief A 16 bit PCM wav file mapped in memory.
+///
+/// The samples are used in place instead of being read, so loading or
+/// streaming a wav file doesn't copy it. Only little endian machines can
+/// use the samples in place, open() fails on others and for any other
+/// format so the file can be decoded some other way.
+class ofMappedWav{
+public:
+	ofMappedWav(){}
+	~ofMappedWav();
+
+	ofMappedWav(const ofMappedWav &) = delete;
+	ofMappedWav & operator=(const ofMappedWav &) = delete;
+
+	/// \returns false if the file can't be mapped or isn't a 16 bit PCM
+	/// wav file.
+	bool open(const std::filesystem::path & path);
+	void close();
+
+	/// \brief Interleaved samples, valid until the file is closed.
+	const short * samples = nullptr;
+	uint64_t frames = 0;
+	int channels = 0;
+	int samplerate = 0;
+
+private:
+	bool map(const std::filesystem::path & path);
+
+	const unsigned char * data = nullptr;
+	std::size_t size = 0;
+#ifdef TARGET_WIN32
+	HANDLE mapping = nullptr;
+#endif
+};
+
+/// \brief A block of a stream decoded by ofSoundStreamRing's producer.
+struct ofSoundStreamBlock{
+	/// \brief Interleaved samples, allocated by the ring.
+	std::vector<short> samples;
+	std::size_t frames = 0;
+	/// \brief Position of the first frame in the stream.
+	uint64_t firstFrame = 0;
+	/// \brief Generation of the stream the block was decoded for, see
+	/// ofSoundStreamRing::front().
+	uint32_t generation = 0;
+	/// \brief Whether it's the end of the stream.
+	bool last = false;
+};
+
+/// \brief Single producer, single consumer ring of decoded blocks.
+///
+/// A decoder thread writes blocks ahead of the thread that plays them,
+/// without locking. Seeking increments a generation the decoder stamps on
+/// the blocks, so the consumer can discard the ones decoded before a seek
+/// it has seen and keep the ones decoded after a seek it hasn't seen yet.
+class ofSoundStreamRing{
+public:
+	/// \brief Allocates the blocks and empties the ring, only while neither
+	/// thread uses it.
+	void allocate(std::size_t numBlocks, std::size_t samplesPerBlock);
+	void clear();
+
+	/// \brief The block to decode into, or nullptr if the ring is full.
+	/// Only called by the producer.
+	ofSoundStreamBlock * beginWrite();
+
+	/// \brief Makes the block returned by beginWrite() available to the
+	/// consumer.
+	void endWrite();
+
+	/// \brief The next block of generation, or nullptr if there's none
+	/// ready. Only called by the consumer.
+	///
+	/// Blocks of older generations are discarded. A block of a newer
+	/// generation is left in the ring and nullptr returned, so the consumer
+	/// can reset for the new generation before reading it.
+	const ofSoundStreamBlock * front(uint32_t generation);
+
+	/// \brief Discards the block returned by front().
+	void pop();
+
+	std::size_t getNumBlocks() const;
+
+private:
+	std::vector<ofSoundStreamBlock> blocks;
+	std::atomic<std::size_t> head{0};
+	std::atomic<std::size_t> tail{0};
+};
+
+/// \brief Shares the objects loaded from the same key while they're in use.
+///
+/// Only weak references are kept so an object is freed when its last user
+/// releases it and is loaded again the next time it's asked for.
+template<typename T, typename Key = std::string>
+class ofSoundCache{
+public:
+	/// \brief The object for key, created with load() if it isn't in use.
+	///
+	/// \param load returns a std::shared_ptr<T>, or nullptr if the object
+	/// can't be loaded, which isn't cached.
+	template<typename Load>
+	std::shared_ptr<T> get(const Key & key, Load && load){
+		std::unique_lock<std::mutex> lck(mtx);
+		auto it = entries.find(key);
+		if(it != entries.end()){
+			auto cached = it->second.lock();
+			if(cached){
+				return cached;
+			}
+		}
+		std::shared_ptr<T> loaded = load();
+		if(loaded){
+			entries[key] = loaded;
+		}
+		for(auto entry = entries.begin(); entry != entries.end();){
+			if(entry->second.expired()){
+				entry = entries.erase(entry);
+			}else{
+				++entry;
+			}
+		}
+		return loaded;
+	}
+
+	/// \brief Number of keys cached, entries of objects no longer in use
+	/// are removed by the next get().
+	std::size_t size() const{
+		std::unique_lock<std::mutex> lck(mtx);
+		return entries.size();
+	}
+
+private:
+	std::map<Key, std::weak_ptr<T>> entries;
+	mutable std::mutex mtx;
+};
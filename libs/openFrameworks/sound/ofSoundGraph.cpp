@@ -0,0 +1,796 @@
+#include "ofSoundGraph.h"
+#include "ofSoundUtils.h"
+#include "ofLog.h"
+#include <map>
+#include <set>
+
+using namespace std;
+
+namespace{
+	const size_t parameterQueueSize = 4096;
+
+	// ofSoundBuffer::resize and set check the channels building a string,
+	// the audio thread works with the vector directly so it doesn't allocate
+	inline void resizeFrames(ofSoundBuffer & buffer, size_t frames){
+		buffer.getBuffer().resize(frames * buffer.getNumChannels());
+	}
+
+	inline void silence(ofSoundBuffer & buffer){
+		std::fill(buffer.getBuffer().begin(), buffer.getBuffer().end(), 0.f);
+	}
+}
+
+struct ofSoundGraph::Schedule{
+	struct Step{
+		ofSoundNode * node;
+		vector<const ofSoundBuffer *> inputs;
+		ofSoundBuffer * output;
+	};
+
+	uint64_t id = 0;
+	vector<unique_ptr<ofSoundBuffer>> buffers;
+	vector<Step> steps;
+	// first step of every level, steps in a level don't depend on each other
+	vector<size_t> levels;
+	ofSoundBuffer * output = nullptr;
+	Schedule * nextGarbage = nullptr;
+};
+
+//--------------------------------------------------------------
+void ofSoundNode::setParameter(int id, float value){
+	if(graph){
+		graph->postParameter(this, id, value);
+	}else{
+		onParameter(id, value);
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundNode::mixInputs(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	auto & out = output.getBuffer();
+	if(inputs.empty()){
+		silence(output);
+		return;
+	}
+	auto & first = inputs[0]->getBuffer();
+	std::copy(first.begin(), first.begin() + out.size(), out.begin());
+	for(size_t i = 1; i < inputs.size(); i++){
+		const float * in = inputs[i]->getBuffer().data();
+		for(size_t j = 0; j < out.size(); j++){
+			out[j] += in[j];
+		}
+	}
+}
+
+//--------------------------------------------------------------
+ofSoundFunctionNode::ofSoundFunctionNode(Function function)
+:function(function){}
+
+//--------------------------------------------------------------
+void ofSoundFunctionNode::process(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	function(inputs, output);
+}
+
+//--------------------------------------------------------------
+ofSoundBufferSourceNode::ofSoundBufferSourceNode(shared_ptr<const ofSoundBuffer> buffer)
+:buffer(buffer){}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::play(){
+	setParameter(Play, 1);
+}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::stop(){
+	setParameter(Stop, 1);
+}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::setLoop(bool loop){
+	setParameter(Loop, loop);
+}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::setGain(float gain){
+	setParameter(Gain, gain);
+}
+
+//--------------------------------------------------------------
+bool ofSoundBufferSourceNode::isPlaying() const{
+	return playing.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::onParameter(int id, float value){
+	switch(id){
+	case Play:
+		position = 0;
+		playing = true;
+		break;
+	case Stop:
+		playing = false;
+		break;
+	case Loop:
+		loop = value != 0;
+		break;
+	case Gain:
+		gain = value;
+		break;
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundBufferSourceNode::process(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	silence(output);
+	auto sourceFrames = buffer ? buffer->getNumFrames() : 0;
+	if(!playing || sourceFrames == 0){
+		playing = false;
+		return;
+	}
+	auto sourceChannels = buffer->getNumChannels();
+	auto channels = output.getNumChannels();
+	auto frames = output.getNumFrames();
+	const float * src = buffer->getBuffer().data();
+	float * dst = output.getBuffer().data();
+	for(size_t i = 0; i < frames; i++){
+		if(position >= sourceFrames){
+			if(!loop){
+				playing = false;
+				return;
+			}
+			position = 0;
+		}
+		for(size_t c = 0; c < channels; c++){
+			dst[i * channels + c] = src[position * sourceChannels + c % sourceChannels] * gain;
+		}
+		position++;
+	}
+}
+
+//--------------------------------------------------------------
+ofSoundGainNode::ofSoundGainNode(float gain)
+:gain(gain)
+,target(gain){}
+
+//--------------------------------------------------------------
+void ofSoundGainNode::setGain(float gain){
+	setParameter(Gain, gain);
+}
+
+//--------------------------------------------------------------
+void ofSoundGainNode::onParameter(int id, float value){
+	if(id == Gain){
+		target = value;
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGainNode::process(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	mixInputs(inputs, output);
+	auto channels = output.getNumChannels();
+	auto frames = output.getNumFrames();
+	float * samples = output.getBuffer().data();
+	float increment = frames > 0 ? (target - gain) / frames : 0;
+	for(size_t i = 0; i < frames; i++){
+		gain += increment;
+		for(size_t c = 0; c < channels; c++){
+			samples[i * channels + c] *= gain;
+		}
+	}
+	gain = target;
+}
+
+//--------------------------------------------------------------
+ofSoundPanNode::ofSoundPanNode(float pan){
+	ofStereoVolumes(1, pan, left, right);
+	targetLeft = left;
+	targetRight = right;
+}
+
+//--------------------------------------------------------------
+void ofSoundPanNode::setPan(float pan){
+	setParameter(Pan, pan);
+}
+
+//--------------------------------------------------------------
+void ofSoundPanNode::onParameter(int id, float value){
+	if(id == Pan){
+		ofStereoVolumes(1, value, targetLeft, targetRight);
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundPanNode::process(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	mixInputs(inputs, output);
+	if(output.getNumChannels() != 2){
+		return;
+	}
+	auto frames = output.getNumFrames();
+	float * samples = output.getBuffer().data();
+	float incrementLeft = frames > 0 ? (targetLeft - left) / frames : 0;
+	float incrementRight = frames > 0 ? (targetRight - right) / frames : 0;
+	for(size_t i = 0; i < frames; i++){
+		left += incrementLeft;
+		right += incrementRight;
+		samples[i * 2] *= left;
+		samples[i * 2 + 1] *= right;
+	}
+	left = targetLeft;
+	right = targetRight;
+}
+
+//--------------------------------------------------------------
+ofSoundMixerNode::ofSoundMixerNode(size_t maxInputs)
+:gains(maxInputs, 1)
+,targets(maxInputs, 1){}
+
+//--------------------------------------------------------------
+void ofSoundMixerNode::setInputGain(size_t input, float gain){
+	if(input >= gains.size()){
+		ofLogError("ofSoundMixerNode") << "setInputGain(): input " << input << " out of range, the mixer was created for " << gains.size() << " inputs";
+		return;
+	}
+	setParameter(input, gain);
+}
+
+//--------------------------------------------------------------
+void ofSoundMixerNode::setGain(float gain){
+	setParameter(-1, gain);
+}
+
+//--------------------------------------------------------------
+void ofSoundMixerNode::onParameter(int id, float value){
+	if(id < 0){
+		target = value;
+	}else if(size_t(id) < targets.size()){
+		targets[id] = value;
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundMixerNode::process(const vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output){
+	silence(output);
+	auto channels = output.getNumChannels();
+	auto frames = output.getNumFrames();
+	float * out = output.getBuffer().data();
+	for(size_t i = 0; i < inputs.size(); i++){
+		const float * in = inputs[i]->getBuffer().data();
+		if(i >= gains.size()){
+			for(size_t j = 0; j < frames * channels; j++){
+				out[j] += in[j];
+			}
+			continue;
+		}
+		float g = gains[i];
+		float increment = frames > 0 ? (targets[i] - g) / frames : 0;
+		for(size_t f = 0; f < frames; f++){
+			g += increment;
+			for(size_t c = 0; c < channels; c++){
+				out[f * channels + c] += in[f * channels + c] * g;
+			}
+		}
+		gains[i] = targets[i];
+	}
+
+	float increment = frames > 0 ? (target - gain) / frames : 0;
+	if(gain != 1 || increment != 0){
+		for(size_t f = 0; f < frames; f++){
+			gain += increment;
+			for(size_t c = 0; c < channels; c++){
+				out[f * channels + c] *= gain;
+			}
+		}
+	}
+	gain = target;
+}
+
+//--------------------------------------------------------------
+ofSoundGraph::ofSoundGraph()
+:output(make_shared<ofSoundMixerNode>()){
+	parameters.resize(parameterQueueSize);
+	add(output);
+}
+
+//--------------------------------------------------------------
+ofSoundGraph::~ofSoundGraph(){
+	stopThreads();
+	for(auto & node: nodes){
+		node->graph = nullptr;
+	}
+	for(auto & r: removed){
+		r.node->graph = nullptr;
+	}
+	collectGarbage();
+	delete pending.exchange(nullptr);
+	delete current;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::setup(size_t numChannels, size_t maxFrames, unsigned int sampleRate){
+	if(numChannels == 0 || maxFrames == 0){
+		ofLogError("ofSoundGraph") << "setup(): invalid format " << numChannels << " channels, " << maxFrames << " frames";
+		return;
+	}
+	channels = numChannels;
+	this->maxFrames = maxFrames;
+	this->sampleRate = sampleRate;
+	for(auto & node: nodes){
+		node->setup(channels, maxFrames, sampleRate);
+	}
+	for(auto & r: removed){
+		r.node->setup(channels, maxFrames, sampleRate);
+	}
+	compile();
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::add(shared_ptr<ofSoundNode> node){
+	if(!node){
+		return;
+	}
+	if(node->graph == this){
+		// a node added back before it was detached might still be
+		// processed by the audio thread so it isn't set up again
+		auto it = std::find_if(removed.begin(), removed.end(), [&](const RemovedNode & r){
+			return r.node == node;
+		});
+		if(it != removed.end()){
+			removed.erase(it);
+			nodes.push_back(node);
+			compile();
+		}
+		return;
+	}
+	if(node->graph){
+		ofLogError("ofSoundGraph") << "add(): node already belongs to another graph";
+		return;
+	}
+	node->graph = this;
+	node->setup(channels, maxFrames, sampleRate);
+	nodes.push_back(node);
+	compile();
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::remove(shared_ptr<ofSoundNode> node){
+	if(!node || node->graph != this){
+		return;
+	}
+	if(node == output){
+		ofLogError("ofSoundGraph") << "remove(): the output can't be removed";
+		return;
+	}
+	auto it = std::find(nodes.begin(), nodes.end(), node);
+	if(it == nodes.end()){
+		return;
+	}
+	auto raw = node.get();
+	connections.erase(std::remove_if(connections.begin(), connections.end(), [raw](const pair<ofSoundNode *, ofSoundNode *> & c){
+		return c.first == raw || c.second == raw;
+	}), connections.end());
+	nodes.erase(it);
+	removeNode(node);
+	compile();
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::removeNode(shared_ptr<ofSoundNode> node){
+	// the schedule is set when the graph is compiled without the node
+	removed.push_back({node, 0, parametersHead.load(std::memory_order_relaxed)});
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::detachRemovedNodes(){
+	if(removed.empty()){
+		return;
+	}
+	auto used = usedSchedule.load(std::memory_order_acquire);
+	auto tail = parametersTail.load(std::memory_order_acquire);
+	removed.erase(std::remove_if(removed.begin(), removed.end(), [&](RemovedNode & r){
+		if(r.schedule != 0 && r.schedule <= used && tail >= r.lastParameter){
+			r.node->graph = nullptr;
+			return true;
+		}
+		return false;
+	}), removed.end());
+}
+
+//--------------------------------------------------------------
+bool ofSoundGraph::connect(shared_ptr<ofSoundNode> from, shared_ptr<ofSoundNode> to){
+	if(!from || !to){
+		return false;
+	}
+	if((from->graph && from->graph != this) || (to->graph && to->graph != this)){
+		ofLogError("ofSoundGraph") << "connect(): node belongs to another graph";
+		return false;
+	}
+	if(from == to || (to->graph == this && reaches(to.get(), from.get()))){
+		ofLogError("ofSoundGraph") << "connect(): connection would create a cycle";
+		return false;
+	}
+	pair<ofSoundNode *, ofSoundNode *> connection(from.get(), to.get());
+	if(std::find(connections.begin(), connections.end(), connection) != connections.end()){
+		return true;
+	}
+	beginChanges();
+	add(from);
+	add(to);
+	connections.push_back(connection);
+	endChanges();
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::disconnect(shared_ptr<ofSoundNode> from, shared_ptr<ofSoundNode> to){
+	pair<ofSoundNode *, ofSoundNode *> connection(from.get(), to.get());
+	auto it = std::find(connections.begin(), connections.end(), connection);
+	if(it != connections.end()){
+		connections.erase(it);
+		compile();
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::clear(){
+	for(auto & node: nodes){
+		if(node != output){
+			removeNode(node);
+		}
+	}
+	nodes.assign(1, output);
+	connections.clear();
+	compile();
+}
+
+//--------------------------------------------------------------
+shared_ptr<ofSoundMixerNode> ofSoundGraph::getOutput() const{
+	return output;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::beginChanges(){
+	changesDepth++;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::endChanges(){
+	if(changesDepth > 0 && --changesDepth == 0){
+		compile();
+	}
+}
+
+//--------------------------------------------------------------
+bool ofSoundGraph::reaches(ofSoundNode * from, ofSoundNode * to) const{
+	vector<ofSoundNode *> stack{from};
+	set<ofSoundNode *> visited;
+	while(!stack.empty()){
+		auto node = stack.back();
+		stack.pop_back();
+		if(node == to){
+			return true;
+		}
+		if(!visited.insert(node).second){
+			continue;
+		}
+		for(auto & c: connections){
+			if(c.first == node){
+				stack.push_back(c.second);
+			}
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::compile(){
+	if(changesDepth > 0){
+		return;
+	}
+
+	map<ofSoundNode *, vector<ofSoundNode *>> inputs;
+	map<ofSoundNode *, vector<ofSoundNode *>> outputs;
+	for(auto & c: connections){
+		inputs[c.second].push_back(c.first);
+		outputs[c.first].push_back(c.second);
+	}
+
+	// level of every node feeding the output, one more than its deepest
+	// input, found depth first from the output. Without cycles an input
+	// is always leveled before the nodes it feeds
+	map<ofSoundNode *, size_t> level;
+	vector<pair<ofSoundNode *, bool>> stack{{output.get(), false}};
+	while(!stack.empty()){
+		auto entry = stack.back();
+		stack.pop_back();
+		auto node = entry.first;
+		if(entry.second){
+			size_t l = 0;
+			for(auto input: inputs[node]){
+				l = std::max(l, level[input] + 1);
+			}
+			level[node] = l;
+			continue;
+		}
+		if(level.count(node)){
+			continue;
+		}
+		level[node] = 0;
+		stack.push_back({node, true});
+		for(auto input: inputs[node]){
+			if(!level.count(input)){
+				stack.push_back({input, false});
+			}
+		}
+	}
+	auto schedule = new Schedule;
+	schedule->id = ++numSchedules;
+	for(auto & r: removed){
+		if(r.schedule == 0){
+			r.schedule = schedule->id;
+		}
+	}
+	vector<ofSoundNode *> order;
+	for(auto & node: nodes){
+		if(level.count(node.get())){
+			order.push_back(node.get());
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [&](ofSoundNode * a, ofSoundNode * b){
+		return level[a] < level[b];
+	});
+
+	// assign buffers from a pool, a buffer is free again after the level
+	// of the last node that reads it
+	auto numLevels = order.empty() ? 0 : level[order.back()] + 1;
+	vector<vector<ofSoundBuffer *>> releasedAfter(numLevels);
+	vector<ofSoundBuffer *> free;
+	map<ofSoundNode *, ofSoundBuffer *> buffers;
+	size_t currentLevel = 0;
+	for(auto node: order){
+		auto l = level[node];
+		while(currentLevel < l){
+			free.insert(free.end(), releasedAfter[currentLevel].begin(), releasedAfter[currentLevel].end());
+			currentLevel++;
+			schedule->levels.push_back(schedule->steps.size());
+		}
+		if(schedule->levels.empty()){
+			schedule->levels.push_back(0);
+		}
+
+		ofSoundBuffer * buffer;
+		if(free.empty()){
+			schedule->buffers.emplace_back(new ofSoundBuffer);
+			buffer = schedule->buffers.back().get();
+			buffer->allocate(maxFrames, channels);
+			buffer->setSampleRate(sampleRate);
+		}else{
+			buffer = free.back();
+			free.pop_back();
+		}
+		buffers[node] = buffer;
+
+		size_t lastUse = l;
+		for(auto reader: outputs[node]){
+			if(level.count(reader)){
+				lastUse = std::max(lastUse, level[reader]);
+			}
+		}
+		if(node != output.get()){
+			releasedAfter[lastUse].push_back(buffer);
+		}
+
+		Schedule::Step step;
+		step.node = node;
+		for(auto input: inputs[node]){
+			step.inputs.push_back(buffers[input]);
+		}
+		step.output = buffer;
+		schedule->steps.push_back(std::move(step));
+	}
+	schedule->levels.push_back(schedule->steps.size());
+	schedule->output = buffers[output.get()];
+	scheduledNodes = schedule->steps.size();
+
+	// removed nodes are kept alive until they are detached so a schedule
+	// the audio thread never used can be deleted right away
+	delete pending.exchange(nullptr, std::memory_order_acq_rel);
+	collectGarbage();
+	detachRemovedNodes();
+	pending.store(schedule, std::memory_order_release);
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::collectGarbage(){
+	auto schedule = garbage.exchange(nullptr, std::memory_order_acquire);
+	while(schedule){
+		auto next = schedule->nextGarbage;
+		delete schedule;
+		schedule = next;
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::postParameter(ofSoundNode * node, int id, float value){
+	std::unique_lock<std::mutex> lock(parametersMutex);
+	detachRemovedNodes();
+	if(node->graph != this){
+		node->onParameter(id, value);
+		return;
+	}
+	auto head = parametersHead.load(std::memory_order_relaxed);
+	auto tail = parametersTail.load(std::memory_order_acquire);
+	if(head - tail >= parameters.size()){
+		droppedParameters++;
+		return;
+	}
+	parameters[head % parameters.size()] = {node, id, value};
+	parametersHead.store(head + 1, std::memory_order_release);
+	for(auto & r: removed){
+		if(r.node.get() == node){
+			r.lastParameter = head + 1;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::audioOut(ofSoundBuffer & buffer){
+	auto next = pending.exchange(nullptr, std::memory_order_acquire);
+
+	auto tail = parametersTail.load(std::memory_order_relaxed);
+	auto head = parametersHead.load(std::memory_order_acquire);
+	for(; tail != head; tail++){
+		auto & change = parameters[tail % parameters.size()];
+		change.node->onParameter(change.id, change.value);
+	}
+	parametersTail.store(tail, std::memory_order_release);
+
+	if(next){
+		if(current){
+			current->nextGarbage = garbage.load(std::memory_order_relaxed);
+			while(!garbage.compare_exchange_weak(current->nextGarbage, current, std::memory_order_release, std::memory_order_relaxed));
+		}
+		current = next;
+		usedSchedule.store(current->id, std::memory_order_release);
+	}
+
+	if(!current || !current->output){
+		silence(buffer);
+		return;
+	}
+
+	auto frames = buffer.getNumFrames();
+	auto & levels = current->levels;
+	bool parallel = numWorkers.load(std::memory_order_relaxed) > 0;
+	for(size_t l = 0; l + 1 < levels.size(); l++){
+		auto begin = levels[l];
+		auto end = levels[l + 1];
+		if(parallel && end - begin >= minParallelNodes){
+			runParallel(*current, begin, end, frames);
+		}else{
+			processSteps(*current, begin, end, frames);
+		}
+	}
+	current->output->copyTo(buffer.getBuffer().data(), frames, buffer.getNumChannels(), 0);
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::processSteps(Schedule & schedule, size_t begin, size_t end, size_t frames){
+	for(size_t i = begin; i < end; i++){
+		auto & step = schedule.steps[i];
+		resizeFrames(*step.output, frames);
+		step.node->process(step.inputs, *step.output);
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::runParallel(Schedule & schedule, size_t begin, size_t end, size_t frames){
+	generation++;
+	// close the claim before changing the range, otherwise a worker still
+	// holding the exhausted claim of the previous range could see a larger
+	// count and claim a step past its end. the count is stored with release
+	// so a worker that sees it also sees the closed claim and its stale
+	// compare exchange fails
+	claim.store((uint64_t(generation) << 32) | 0xffffffff, std::memory_order_relaxed);
+	parallelSchedule.store(&schedule, std::memory_order_relaxed);
+	parallelBegin.store(begin, std::memory_order_relaxed);
+	parallelFrames.store(frames, std::memory_order_relaxed);
+	remaining.store(end - begin, std::memory_order_relaxed);
+	parallelCount.store(end - begin, std::memory_order_release);
+	claim.store(uint64_t(generation) << 32, std::memory_order_release);
+
+	work(generation);
+	while(remaining.load(std::memory_order_acquire) != 0);
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::work(uint32_t gen){
+	while(true){
+		auto value = claim.load(std::memory_order_acquire);
+		if(uint32_t(value >> 32) != gen){
+			return;
+		}
+		auto index = size_t(value & 0xffffffff);
+		if(index >= parallelCount.load(std::memory_order_acquire)){
+			return;
+		}
+		if(!claim.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel)){
+			continue;
+		}
+		// the claim only succeeds while it's tagged with the current range,
+		// which can't change until this step is done
+		auto step = parallelBegin.load(std::memory_order_relaxed) + index;
+		processSteps(*parallelSchedule.load(std::memory_order_relaxed), step, step + 1, parallelFrames.load(std::memory_order_relaxed));
+		remaining.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::workerLoop(){
+	size_t idle = 0;
+	while(running.load(std::memory_order_relaxed)){
+		auto value = claim.load(std::memory_order_acquire);
+		if(size_t(value & 0xffffffff) < parallelCount.load(std::memory_order_relaxed)){
+			work(uint32_t(value >> 32));
+			idle = 0;
+		}else if(++idle < 10000){
+			std::this_thread::yield();
+		}else{
+			// long without work, stop spinning until the next blocks
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::startThreads(size_t numThreads){
+	running = true;
+	for(size_t i = 0; i < numThreads; i++){
+		workers.emplace_back(&ofSoundGraph::workerLoop, this);
+	}
+	numWorkers = numThreads;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::stopThreads(){
+	// the audio thread doesn't wait for the workers, only for the steps
+	// they already claimed, so they can stop at any time
+	numWorkers = 0;
+	running = false;
+	for(auto & worker: workers){
+		worker.join();
+	}
+	workers.clear();
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::setNumThreads(size_t numThreads){
+	stopThreads();
+	if(numThreads > 1){
+		startThreads(numThreads - 1);
+	}
+}
+
+//--------------------------------------------------------------
+size_t ofSoundGraph::getNumThreads() const{
+	return numWorkers + 1;
+}
+
+//--------------------------------------------------------------
+void ofSoundGraph::setMinParallelNodes(size_t numNodes){
+	minParallelNodes = std::max<size_t>(numNodes, 1);
+}
+
+//--------------------------------------------------------------
+size_t ofSoundGraph::getNumNodes() const{
+	return nodes.size();
+}
+
+//--------------------------------------------------------------
+size_t ofSoundGraph::getNumScheduledNodes() const{
+	return scheduledNodes;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundGraph::getDroppedParameterCount() const{
+	return droppedParameters;
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofSoundBaseTypes.h"
+#include "ofSoundBuffer.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class ofSoundGraph;
+
+/// \brief A node of an ofSoundGraph.
+///
+/// Nodes produce a buffer of audio every block from the buffers of the nodes
+/// connected to their input. Sources have no inputs and effects or mixers
+/// combine them. Custom DSP is added by inheriting from this class, or with
+/// ofSoundFunctionNode.
+///
+/// process() runs on the audio thread and shouldn't allocate or lock. The
+/// node's parameters should only be changed through setParameter(), which
+/// delivers the change to onParameter() on the audio thread before the next
+/// block.
+class ofSoundNode{
+public:
+	virtual ~ofSoundNode(){}
+
+	/// \brief Called by the graph, on the calling thread, when the node is
+	/// added or the graph set up, before it's processed.
+	virtual void setup(std::size_t numChannels, std::size_t maxFrames, unsigned int sampleRate){}
+
+	/// \brief Fills output with the next block of audio.
+	///
+	/// output already has the number of frames of the block and the
+	/// channels of the graph.
+	/// \param inputs buffers of the nodes connected to this one, in the
+	/// order they were connected.
+	virtual void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) = 0;
+
+	/// \brief Receives on the audio thread the values sent with
+	/// setParameter().
+	virtual void onParameter(int id, float value){}
+
+	/// \brief Sends a parameter change to the audio thread.
+	///
+	/// Changes are sent through a lock-free queue, in order, and applied
+	/// before the next block. If the node isn't in a graph it's applied
+	/// immediately. A node removed from a graph keeps receiving its changes
+	/// through the queue until the audio thread stops processing it.
+	void setParameter(int id, float value);
+
+	/// \brief Sums all the inputs into output, or silence without inputs.
+	static void mixInputs(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output);
+
+private:
+	friend class ofSoundGraph;
+	ofSoundGraph * graph = nullptr;
+};
+
+/// \brief Runs a function as a node, for sources or effects that don't need
+/// parameters.
+class ofSoundFunctionNode: public ofSoundNode{
+public:
+	typedef std::function<void(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output)> Function;
+
+	ofSoundFunctionNode(Function function);
+	void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override;
+
+private:
+	Function function;
+};
+
+/// \brief Plays a sound buffer.
+///
+/// The buffer can't change while the node is in a graph, a different sound
+/// needs a new node.
+class ofSoundBufferSourceNode: public ofSoundNode{
+public:
+	enum Parameters{
+		Play,
+		Stop,
+		Loop,
+		Gain
+	};
+
+	ofSoundBufferSourceNode(std::shared_ptr<const ofSoundBuffer> buffer);
+
+	/// \brief Starts playing from the beginning.
+	void play();
+	void stop();
+	void setLoop(bool loop);
+	void setGain(float gain);
+
+	/// \brief Whether the sound was playing in the last block, updated from
+	/// the audio thread.
+	bool isPlaying() const;
+
+	void onParameter(int id, float value) override;
+	void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override;
+
+private:
+	std::shared_ptr<const ofSoundBuffer> buffer;
+	std::size_t position = 0;
+	bool loop = false;
+	float gain = 1;
+	std::atomic<bool> playing{false};
+};
+
+/// \brief Multiplies the sum of its inputs by a gain, smoothed over each
+/// block to avoid clicks.
+class ofSoundGainNode: public ofSoundNode{
+public:
+	enum Parameters{
+		Gain
+	};
+
+	ofSoundGainNode(float gain = 1);
+	void setGain(float gain);
+
+	void onParameter(int id, float value) override;
+	void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override;
+
+private:
+	float gain;
+	float target;
+};
+
+/// \brief Pans the sum of its inputs in a stereo graph using a constant
+/// power law, see ofStereoVolumes().
+class ofSoundPanNode: public ofSoundNode{
+public:
+	enum Parameters{
+		Pan
+	};
+
+	/// \param pan from -1, left, to 1, right.
+	ofSoundPanNode(float pan = 0);
+	void setPan(float pan);
+
+	void onParameter(int id, float value) override;
+	void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override;
+
+private:
+	float left, right;
+	float targetLeft, targetRight;
+};
+
+/// \brief Sums its inputs, each with its own gain.
+///
+/// The graph output is a mixer.
+class ofSoundMixerNode: public ofSoundNode{
+public:
+	/// \param maxInputs number of inputs whose gain can be set, inputs
+	/// beyond it are mixed with gain 1.
+	ofSoundMixerNode(std::size_t maxInputs = 64);
+
+	/// \brief Sets the gain of an input, by the order it was connected.
+	///
+	/// Removing an input moves the ones connected after it down one
+	/// position, keeping their gains in place.
+	void setInputGain(std::size_t input, float gain);
+
+	/// \brief Sets the gain of the mix, smoothed over a block.
+	void setGain(float gain);
+
+	void onParameter(int id, float value) override;
+	void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override;
+
+private:
+	std::vector<float> gains;
+	std::vector<float> targets;
+	float gain = 1;
+	float target = 1;
+};
+
+/// \brief A graph of sound nodes, pulled by a sound stream.
+///
+/// The graph is built and modified from the main thread. Every change
+/// compiles a new schedule, with the nodes in the order they have to run and
+/// the buffers they write assigned from a pool, so buffers are reused once
+/// the nodes that read them have run. The schedule is handed to the audio
+/// thread without locking and, when processing, the graph only runs the
+/// nodes connected to the output, without allocating or locking:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// graph.setup(2, 512, 44100);
+/// auto voice = std::make_shared<ofSoundBufferSourceNode>(sample);
+/// auto pan = std::make_shared<ofSoundPanNode>(-0.5);
+/// graph.connect(voice, pan);
+/// graph.connect(pan, graph.getOutput());
+/// voice->play();
+///
+/// ofSoundStreamSettings settings;
+/// settings.setOutListener(&graph);
+/// ...
+/// ~~~~
+///
+/// With setNumThreads(), nodes that don't depend on each other, like the
+/// voices of a synth, are processed in parallel by worker threads.
+///
+/// The methods that change the graph and the nodes' parameters can only be
+/// called from one thread at a time, usually the main thread.
+class ofSoundGraph: public ofBaseSoundOutput{
+public:
+	ofSoundGraph();
+	~ofSoundGraph();
+
+	ofSoundGraph(const ofSoundGraph &) = delete;
+	ofSoundGraph & operator=(const ofSoundGraph &) = delete;
+
+	/// \brief Sets the format of the audio, call it before starting the
+	/// stream.
+	///
+	/// \param maxFrames largest block the stream will ask for, the buffers
+	/// are allocated for it.
+	void setup(std::size_t numChannels, std::size_t maxFrames, unsigned int sampleRate);
+
+	/// \brief Adds a node, not processed until it's connected to the
+	/// output.
+	void add(std::shared_ptr<ofSoundNode> node);
+
+	/// \brief Removes a node and all its connections.
+	///
+	/// The audio thread might still be processing the node, so it stays
+	/// attached to the graph until the audio thread uses a schedule without
+	/// it and the changes sent to it have been applied.
+	void remove(std::shared_ptr<ofSoundNode> node);
+
+	/// \brief Connects the output of from to the input of to, adding them if
+	/// they weren't in the graph.
+	/// \returns false if the connection would create a cycle.
+	bool connect(std::shared_ptr<ofSoundNode> from, std::shared_ptr<ofSoundNode> to);
+	void disconnect(std::shared_ptr<ofSoundNode> from, std::shared_ptr<ofSoundNode> to);
+
+	/// \brief Removes all the nodes except the output.
+	void clear();
+
+	/// \brief The mixer whose output is sent to the sound stream.
+	std::shared_ptr<ofSoundMixerNode> getOutput() const;
+
+	/// \brief Groups changes to the graph so it's compiled only once, in
+	/// endChanges().
+	void beginChanges();
+	void endChanges();
+
+	/// \brief Number of threads used to process the graph, including the
+	/// audio thread. 1, the default, processes everything in the audio
+	/// thread.
+	void setNumThreads(std::size_t numThreads);
+	std::size_t getNumThreads() const;
+
+	/// \brief Minimum number of independent nodes to process them in
+	/// parallel, 8 by default.
+	void setMinParallelNodes(std::size_t numNodes);
+
+	std::size_t getNumNodes() const;
+
+	/// \brief Number of nodes processed every block, the ones connected to
+	/// the output.
+	std::size_t getNumScheduledNodes() const;
+
+	/// \brief Number of parameter changes discarded because the queue to
+	/// the audio thread was full.
+	std::size_t getDroppedParameterCount() const;
+
+	/// \brief Processes one block into buffer.
+	void audioOut(ofSoundBuffer & buffer) override;
+
+private:
+	friend class ofSoundNode;
+	struct Schedule;
+	struct ParameterChange{
+		ofSoundNode * node;
+		int id;
+		float value;
+	};
+
+	// a node removed from the graph, detached once the audio thread uses
+	// the schedule compiled without it and consumes its last change
+	struct RemovedNode{
+		std::shared_ptr<ofSoundNode> node;
+		uint64_t schedule;
+		std::size_t lastParameter;
+	};
+
+	void postParameter(ofSoundNode * node, int id, float value);
+	void compile();
+	void collectGarbage();
+	void removeNode(std::shared_ptr<ofSoundNode> node);
+	void detachRemovedNodes();
+	bool reaches(ofSoundNode * from, ofSoundNode * to) const;
+	void processSteps(Schedule & schedule, std::size_t begin, std::size_t end, std::size_t frames);
+	void runParallel(Schedule & schedule, std::size_t begin, std::size_t end, std::size_t frames);
+	void startThreads(std::size_t numThreads);
+	void stopThreads();
+	void workerLoop();
+	void work(uint32_t generation);
+
+	std::vector<std::shared_ptr<ofSoundNode>> nodes;
+	std::vector<std::pair<ofSoundNode *, ofSoundNode *>> connections;
+	std::vector<RemovedNode> removed;
+	std::shared_ptr<ofSoundMixerNode> output;
+	std::size_t channels = 2;
+	std::size_t maxFrames = 512;
+	unsigned int sampleRate = 44100;
+	int changesDepth = 0;
+	std::size_t minParallelNodes = 8;
+
+	// schedules are published to the audio thread through pending and the
+	// ones it stops using come back through garbage to be deleted here
+	Schedule * current = nullptr;
+	std::atomic<Schedule *> pending{nullptr};
+	std::atomic<Schedule *> garbage{nullptr};
+	uint64_t numSchedules = 0;
+	std::atomic<uint64_t> usedSchedule{0};
+	std::atomic<std::size_t> scheduledNodes{0};
+
+	// single consumer ring, producers serialized by the mutex
+	std::vector<ParameterChange> parameters;
+	std::atomic<std::size_t> parametersHead{0};
+	std::atomic<std::size_t> parametersTail{0};
+	std::mutex parametersMutex;
+	std::atomic<std::size_t> droppedParameters{0};
+
+	// parallel processing of a range of independent steps, claimed by
+	// the audio thread and the workers with a counter tagged with the
+	// generation of the range so late workers can't claim the next one.
+	// the claim is closed while the range changes
+	std::vector<std::thread> workers;
+	std::atomic<std::size_t> numWorkers{0};
+	std::atomic<bool> running{false};
+	std::atomic<uint64_t> claim{0};
+	std::atomic<std::size_t> remaining{0};
+	std::atomic<Schedule *> parallelSchedule{nullptr};
+	std::atomic<std::size_t> parallelBegin{0};
+	std::atomic<std::size_t> parallelCount{0};
+	std::atomic<std::size_t> parallelFrames{0};
+	uint32_t generation = 0;
+};
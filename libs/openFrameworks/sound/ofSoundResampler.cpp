@@ -0,0 +1,368 @@
+#include "ofSoundResampler.h"
+#include "ofSoundBuffer.h"
+#include "ofLog.h"
+
+using namespace std;
+
+namespace{
+	struct QualitySettings{
+		size_t halfTaps;
+		double beta;
+		double rolloff;
+	};
+
+	const QualitySettings qualities[] = {
+		{8, 5.65, 0.85},
+		{16, 7.86, 0.9},
+		{32, 9.96, 0.94},
+	};
+
+	const size_t maxExactPhases = 1024;
+	const size_t interpolatedPhases = 512;
+
+	// modified bessel function of the first kind, order 0
+	double besselI0(double x){
+		double sum = 1;
+		double term = 1;
+		for(int k = 1; k < 50; k++){
+			term *= (x / (2 * k)) * (x / (2 * k));
+			sum += term;
+			if(term < sum * 1e-12){
+				break;
+			}
+		}
+		return sum;
+	}
+
+	double sinc(double x){
+		if(fabs(x) < 1e-9){
+			return 1;
+		}
+		return sin(M_PI * x) / (M_PI * x);
+	}
+
+	// independent accumulators so the compiler can keep them in simd
+	// registers without reordering the additions
+	inline float dot(const float * samples, const float * coefficients, size_t n){
+		float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		size_t i = 0;
+		for(; i + 8 <= n; i += 8){
+			for(size_t k = 0; k < 8; k++){
+				acc[k] += samples[i + k] * coefficients[i + k];
+			}
+		}
+		for(; i < n; i++){
+			acc[0] += samples[i] * coefficients[i];
+		}
+		return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+	}
+}
+
+//--------------------------------------------------------------
+ofSoundResampler::ofSoundResampler(){}
+
+//--------------------------------------------------------------
+void ofSoundResampler::setup(unsigned int inSampleRate, unsigned int outSampleRate, size_t numChannels, Quality quality, size_t maxBlockFrames){
+	if(inSampleRate == 0 || outSampleRate == 0){
+		ofLogError("ofSoundResampler") << "setup(): invalid sample rates " << inSampleRate << " -> " << outSampleRate;
+		return;
+	}
+	uint64_t a = inSampleRate, b = outSampleRate;
+	while(b != 0){
+		auto r = a % b;
+		a = b;
+		b = r;
+	}
+	uint64_t num = inSampleRate / a;
+	uint64_t den = outSampleRate / a;
+	setup(double(outSampleRate) / inSampleRate, num, den <= maxExactPhases ? den : 0, numChannels, quality, maxBlockFrames);
+	this->outSampleRate = outSampleRate;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::setup(double speed, size_t numChannels, Quality quality, size_t maxBlockFrames){
+	if(!(speed > 0)){
+		ofLogError("ofSoundResampler") << "setup(): invalid speed " << speed;
+		return;
+	}
+	// speeds like 0.5 or 1.5 can still use the exact filter bank
+	uint64_t num = 0, den = 0;
+	for(uint64_t d = 1; d <= maxExactPhases; d++){
+		double n = round(speed * d);
+		if(n >= 1 && fabs(speed * d - n) < 1e-9 * d){
+			num = n;
+			den = d;
+			break;
+		}
+	}
+	setup(1. / speed, num, den, numChannels, quality, maxBlockFrames);
+	outSampleRate = 0;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::setup(double ratio, uint64_t num, uint64_t den, size_t numChannels, Quality quality, size_t maxBlockFrames){
+	if(numChannels == 0){
+		ofLogError("ofSoundResampler") << "setup(): can't resample 0 channels";
+		return;
+	}
+	auto & settings = qualities[quality];
+	channels = numChannels;
+	exact = den != 0;
+	this->num = num;
+	this->den = den;
+	step = 1. / ratio;
+
+	// when downsampling the cutoff is lowered to the new nyquist frequency
+	// and the filter widened to keep the same transition band
+	double scale = std::min(1., ratio);
+	halfTaps = ceil(settings.halfTaps / scale);
+	halfTaps = (halfTaps + 3) / 4 * 4;
+	numTaps = halfTaps * 2;
+	double cutoff = 0.5 * scale * settings.rolloff;
+	double windowNorm = besselI0(settings.beta);
+
+	// one extra phase, the first one shifted by a frame, so interpolating
+	// between phases never wraps
+	numPhases = exact ? den : interpolatedPhases;
+	bank.resize((numPhases + 1) * numTaps);
+	for(size_t p = 0; p <= numPhases; p++){
+		double offset = double(p) / numPhases;
+		float * taps = &bank[p * numTaps];
+		double sum = 0;
+		for(size_t j = 0; j < numTaps; j++){
+			double x = double(j) - (halfTaps - 1) - offset;
+			double t = x / halfTaps;
+			double window = fabs(t) < 1 ? besselI0(settings.beta * sqrt(1 - t * t)) / windowNorm : 0;
+			double tap = sinc(2 * cutoff * x) * window;
+			taps[j] = tap;
+			sum += tap;
+		}
+		for(size_t j = 0; j < numTaps; j++){
+			taps[j] /= sum;
+		}
+	}
+	coefficients.assign(exact ? 0 : numTaps, 0);
+
+	capacity = numTaps + maxBlockFrames;
+	history.assign(channels * capacity, 0);
+	reset();
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::reset(){
+	// the first output frame is centered on the first input frame
+	length = halfTaps > 0 ? halfTaps - 1 : 0;
+	for(size_t c = 0; c < channels; c++){
+		std::fill(history.begin() + c * capacity, history.begin() + c * capacity + length, 0.f);
+	}
+	position = 0;
+	phase = 0;
+	fraction = 0;
+	framesIn = 0;
+	framesOut = 0;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::prime(const float * in, size_t frames){
+	if(channels == 0){
+		ofLogError("ofSoundResampler") << "prime(): resampler not set up";
+		return;
+	}
+	if(framesIn > 0){
+		ofLogError("ofSoundResampler") << "prime(): the stream already started, call reset() first";
+		return;
+	}
+	// the history only holds the silence before the first frame, replace
+	// its end with the last frames given
+	auto n = std::min(frames, length);
+	in += (frames - n) * channels;
+	for(size_t c = 0; c < channels; c++){
+		float * dst = &history[c * capacity + length - n];
+		for(size_t i = 0; i < n; i++){
+			dst[i] = in[i * channels + c];
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::reserve(size_t frames){
+	if(length + frames <= capacity){
+		return;
+	}
+	auto newCapacity = length + frames;
+	vector<float> newHistory(channels * newCapacity);
+	for(size_t c = 0; c < channels; c++){
+		std::copy(history.begin() + c * capacity, history.begin() + c * capacity + length, newHistory.begin() + c * newCapacity);
+	}
+	history.swap(newHistory);
+	capacity = newCapacity;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::write(const float * in, size_t inFrames){
+	reserve(inFrames);
+	for(size_t c = 0; c < channels; c++){
+		float * dst = &history[c * capacity + length];
+		const float * src = in + c;
+		for(size_t i = 0; i < inFrames; i++){
+			dst[i] = src[i * channels];
+		}
+	}
+	length += inFrames;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::writeSilence(size_t frames){
+	reserve(frames);
+	for(size_t c = 0; c < channels; c++){
+		std::fill(history.begin() + c * capacity + length, history.begin() + c * capacity + length + frames, 0.f);
+	}
+	length += frames;
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::advance(size_t & position, uint64_t & phase, double & fraction) const{
+	if(exact){
+		phase += num;
+		position += phase / den;
+		phase %= den;
+	}else{
+		fraction += step;
+		auto frames = floor(fraction);
+		position += size_t(frames);
+		fraction -= frames;
+	}
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::read(float * out, size_t maxOutFrames){
+	size_t frames = 0;
+	while(frames < maxOutFrames && position + numTaps <= length){
+		const float * taps;
+		if(exact){
+			taps = &bank[phase * numTaps];
+		}else{
+			double index = fraction * numPhases;
+			size_t p = index;
+			float t = index - p;
+			const float * a = &bank[p * numTaps];
+			const float * b = a + numTaps;
+			for(size_t j = 0; j < numTaps; j++){
+				coefficients[j] = a[j] + (b[j] - a[j]) * t;
+			}
+			taps = coefficients.data();
+		}
+		for(size_t c = 0; c < channels; c++){
+			out[frames * channels + c] = dot(&history[c * capacity + position], taps, numTaps);
+		}
+		advance(position, phase, fraction);
+		frames++;
+	}
+	framesOut += frames;
+
+	// discard the frames no output needs anymore
+	auto consumed = std::min(position, length);
+	if(consumed > 0){
+		for(size_t c = 0; c < channels; c++){
+			auto begin = history.begin() + c * capacity;
+			std::copy(begin + consumed, begin + length, begin);
+		}
+		length -= consumed;
+		position -= consumed;
+	}
+	return frames;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::process(const float * in, size_t inFrames, float * out, size_t maxOutFrames){
+	if(channels == 0){
+		ofLogError("ofSoundResampler") << "process(): resampler not set up";
+		return 0;
+	}
+	write(in, inFrames);
+	framesIn += inFrames;
+	return read(out, maxOutFrames);
+}
+
+//--------------------------------------------------------------
+void ofSoundResampler::process(const ofSoundBuffer & in, ofSoundBuffer & out){
+	if(channels == 0){
+		ofLogError("ofSoundResampler") << "process(): resampler not set up";
+		return;
+	}
+	if(in.getNumChannels() != channels){
+		ofLogError("ofSoundResampler") << "process(): buffer has " << in.getNumChannels() << " channels, resampler was set up for " << channels;
+		return;
+	}
+	auto sampleRate = outSampleRate != 0 ? outSampleRate : in.getSampleRate();
+	auto inFrames = in.getNumFrames();
+	write(in.getBuffer().data(), inFrames);
+	framesIn += inFrames;
+
+	auto maxFrames = getMaxOutputFrames(0);
+	out.setNumChannels(channels);
+	out.setSampleRate(sampleRate);
+	out.resize(maxFrames * channels);
+	auto frames = read(out.getBuffer().data(), maxFrames);
+	out.resize(frames * channels);
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::flush(float * out, size_t maxOutFrames){
+	uint64_t total = exact ? (framesIn * den + num - 1) / num : uint64_t(ceil(framesIn / step));
+	if(framesOut >= total){
+		return 0;
+	}
+	auto frames = size_t(std::min<uint64_t>(total - framesOut, maxOutFrames));
+	writeSilence(getInputFramesNeeded(frames));
+	return read(out, frames);
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::getInputFramesNeeded(size_t outFrames) const{
+	if(outFrames == 0){
+		return 0;
+	}
+	auto last = position;
+	if(exact){
+		last += (phase + num * (outFrames - 1)) / den;
+	}else{
+		auto lastPhase = phase;
+		auto lastFraction = fraction;
+		for(size_t i = 1; i < outFrames; i++){
+			advance(last, lastPhase, lastFraction);
+		}
+	}
+	auto needed = last + numTaps;
+	return needed > length ? needed - length : 0;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::getMaxOutputFrames(size_t inFrames) const{
+	auto available = length + inFrames;
+	if(available < position + numTaps){
+		return 0;
+	}
+	// positions advance by step rounded down, so at most one more frame
+	return size_t((available - position - numTaps + 1) / step) + 1;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::getLatency() const{
+	return halfTaps;
+}
+
+//--------------------------------------------------------------
+double ofSoundResampler::getRatio() const{
+	return 1. / step;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::getNumChannels() const{
+	return channels;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundResampler::getNumTaps() const{
+	return numTaps;
+}
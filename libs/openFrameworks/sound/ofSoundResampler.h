@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ofConstants.h"
+
+class ofSoundBuffer;
+
+/// \brief Band-limited sample rate converter for streams of interleaved audio.
+///
+/// Converts between arbitrary sample rates, like 44100Hz to 48000Hz, or
+/// changes the playback speed of a sound using a Kaiser windowed sinc filter
+/// which, unlike the linear and hermite interpolation in ofSoundBuffer,
+/// removes the frequencies above the new Nyquist frequency instead of
+/// aliasing them.
+///
+/// The filter is precomputed by setup() as a bank of phases. When the ratio
+/// between the sample rates is a fraction with a small denominator, as for
+/// all the common audio rates, there's a phase for every output position
+/// and the conversion is exact, otherwise the output interpolates between
+/// the two closest of 512 phases.
+///
+/// The resampler keeps the last input frames between calls so a stream can
+/// be converted block by block, for example inside audioOut, and once set up
+/// it doesn't allocate unless a block is larger than the maxBlockFrames
+/// passed to setup():
+///
+/// ~~~~{.cpp}
+/// // setup
+/// resampler.setup(44100, 48000, 2);
+///
+/// // audioOut
+/// auto needed = resampler.getInputFramesNeeded(output.getNumFrames());
+/// input.resize(needed * 2);
+/// decoder.read(input.data(), needed);
+/// resampler.process(input.data(), needed, output.getBuffer().data(), output.getNumFrames());
+/// ~~~~
+///
+/// The output is delayed by getLatency() input frames while the filter fills
+/// with the first frames of the stream, flush() returns the output still
+/// held back when the stream ends.
+class ofSoundResampler{
+public:
+	enum Quality{
+		/// \brief 16 taps, around 60dB of attenuation of the aliasing.
+		Fast,
+		/// \brief 32 taps, around 80dB.
+		Normal,
+		/// \brief 64 taps, around 100dB.
+		Best
+	};
+
+	ofSoundResampler();
+
+	/// \brief Sets up conversion from inSampleRate to outSampleRate.
+	///
+	/// \param maxBlockFrames largest number of input frames expected in
+	/// a call to process(), used to allocate the internal buffers.
+	void setup(unsigned int inSampleRate, unsigned int outSampleRate, std::size_t numChannels, Quality quality = Normal, std::size_t maxBlockFrames = 4096);
+
+	/// \brief Sets up resampling by a change of playback speed, with speed 2
+	/// one frame is output for every 2 input frames.
+	void setup(double speed, std::size_t numChannels, Quality quality = Normal, std::size_t maxBlockFrames = 4096);
+
+	/// \brief Resamples interleaved frames.
+	///
+	/// All the input is consumed and as many frames as are ready, up to
+	/// maxOutFrames, are written to out. The rest are kept for the next call.
+	///
+	/// The input is copied before writing any output so in and out can be
+	/// the same memory as long as it has space for the output.
+	///
+	/// \returns the number of frames written to out.
+	std::size_t process(const float * in, std::size_t inFrames, float * out, std::size_t maxOutFrames);
+
+	/// \brief Resamples a buffer, resizing out to the frames written.
+	///
+	/// in and out can be the same buffer.
+	void process(const ofSoundBuffer & in, ofSoundBuffer & out);
+
+	/// \brief Writes the frames held back at the end of a stream.
+	///
+	/// After the last call, the total output is ceil(input frames * getRatio()).
+	/// Call reset() before starting a new stream.
+	/// \returns the number of frames written to out.
+	std::size_t flush(float * out, std::size_t maxOutFrames);
+
+	/// \brief Clears the stream state keeping the filter.
+	void reset();
+
+	/// \brief Gives the frames that come before the stream, instead of the
+	/// silence the filter starts with.
+	///
+	/// Call after setup() or reset(), before the first process(). Only the
+	/// last getLatency() - 1 frames are used.
+	void prime(const float * in, std::size_t frames);
+
+	/// \brief Number of input frames needed to output exactly outFrames in
+	/// the next call to process().
+	std::size_t getInputFramesNeeded(std::size_t outFrames) const;
+
+	/// \brief Maximum number of frames process() can output for inFrames.
+	std::size_t getMaxOutputFrames(std::size_t inFrames) const;
+
+	/// \brief Input frames needed to output the first frame of a stream.
+	std::size_t getLatency() const;
+
+	/// \brief Output frames per input frame.
+	double getRatio() const;
+
+	std::size_t getNumChannels() const;
+
+	/// \brief Number of taps of the filter, each output frame multiplies
+	/// this many input frames.
+	std::size_t getNumTaps() const;
+
+private:
+	void setup(double ratio, uint64_t num, uint64_t den, std::size_t numChannels, Quality quality, std::size_t maxBlockFrames);
+	void write(const float * in, std::size_t inFrames);
+	void writeSilence(std::size_t frames);
+	void reserve(std::size_t frames);
+	std::size_t read(float * out, std::size_t maxOutFrames);
+	void advance(std::size_t & position, uint64_t & phase, double & fraction) const;
+
+	std::vector<float> bank;
+	std::vector<float> coefficients;
+	std::vector<float> history;
+	std::size_t channels = 0;
+	unsigned int outSampleRate = 0;
+	std::size_t halfTaps = 0;
+	std::size_t numTaps = 0;
+	std::size_t numPhases = 0;
+	std::size_t capacity = 0;
+	std::size_t length = 0;
+	std::size_t position = 0;
+	bool exact = true;
+	uint64_t num = 1;
+	uint64_t den = 1;
+	uint64_t phase = 0;
+	double step = 1;
+	double fraction = 0;
+	uint64_t framesIn = 0;
+	uint64_t framesOut = 0;
+};
@@ -48,6 +48,15 @@ bool ofAbstractParameter::isReferenceTo(const ofAbstractParameter &other) const{
 	return getInternalObject() == other.getInternalObject();
 }
 
+void ofAbstractParameter::toBinary(std::string & data) const{
+	data += toString();
+}
+
+bool ofAbstractParameter::fromBinary(const char * data, std::size_t size){
+	fromString(std::string(data, size));
+	return true;
+}
+
 ostream& operator<<(ostream& os, const ofAbstractParameter& p){
 	os << p.toString();
 	return os;
@@ -6,6 +6,9 @@
 #include "ofColor.h"
 #include "ofLog.h"
 #include <map>
+#include <unordered_set>
+#include <cstring>
+#include <atomic>
 
 template<typename ParameterType>
 class ofParameter;
@@ -14,6 +17,7 @@ template<typename ParameterType, typename Friend>
 class ofReadOnlyParameter;
 
 class ofParameterGroup;
+class ofEventQueue;
 
 
 
@@ -71,6 +75,29 @@ protected:
 	virtual void setSerializable(bool serializable)=0;
 	virtual std::string escape(const std::string& str) const;
 	virtual const void* getInternalObject() const = 0;
+
+	/// Binary representation of the value used by ofParameterSnapshot,
+	/// by default the same as toString()
+	virtual void toBinary(std::string & data) const;
+	/// Sets the value from toBinary() data, returns false if it's not valid
+	virtual bool fromBinary(const char * data, std::size_t size);
+
+	friend class ofParameterGroup;
+	friend class ofParameterSnapshot;
+};
+
+
+
+//----------------------------------------------------------------------
+/// Arguments of ofParameterGroup::parametersChangedE(), the parameters that
+/// changed in a group, each one only once and in the order they first changed
+class ofParameterGroupChangedEventArgs{
+public:
+	/// References to the parameters that changed
+	std::vector<std::shared_ptr<ofAbstractParameter>> parameters;
+
+	/// \returns true if parameter or a reference to it is in the changes
+	bool contains(const ofAbstractParameter & parameter) const;
 };
 
 
@@ -241,6 +268,76 @@ public:
 
 	ofEvent<ofAbstractParameter> & parameterChangedE();
 
+	/// \brief Event notified once with all the parameters that changed.
+	///
+	/// Outside of a change set it's notified every time a parameter changes,
+	/// like parameterChangedE(). Inside a change set it's notified once
+	/// when it ends.
+	ofEvent<const ofParameterGroupChangedEventArgs> & parametersChangedE();
+
+	/// \brief Starts a change set.
+	///
+	/// Until the matching endChanges(), changes to the parameters in this
+	/// group and its subgroups don't notify the group listeners. When the
+	/// change set ends, parameterChangedE() is notified once for every
+	/// parameter that changed, no matter how many times it did, and
+	/// parametersChangedE() once with all of them. The parent groups are
+	/// notified the same way. The listeners of each parameter are still
+	/// notified immediately.
+	///
+	/// Change sets can be nested, only the outermost one notifies.
+	///
+	/// ~~~~{.cpp}
+	/// group.beginChanges();
+	/// ofDeserialize(preset, group);
+	/// group.endChanges(); // listeners of group are notified here
+	/// ~~~~
+	///
+	/// ChangeSet does the same for a scope.
+	void beginChanges();
+
+	/// \brief Ends a change set started with beginChanges() and notifies
+	/// the changes if it's the outermost one.
+	void endChanges();
+
+	/// \returns true while a change set is open.
+	bool isChanging() const;
+
+	/// \brief Change set that ends when it goes out of scope, also when an
+	/// exception leaves it.
+	///
+	/// ~~~~{.cpp}
+	/// {
+	///     ofParameterGroup::ChangeSet changes(group);
+	///     ofDeserialize(preset, group);
+	/// } // listeners of group are notified here
+	/// ~~~~
+	class ChangeSet{
+	public:
+		ChangeSet(ofParameterGroup & group);
+		~ChangeSet();
+		ChangeSet(const ChangeSet &) = delete;
+		ChangeSet & operator=(const ChangeSet &) = delete;
+
+	private:
+		ofParameterGroup & group;
+	};
+
+	/// \brief Delays the group notifications until the next frame.
+	///
+	/// When enabled every change behaves as if it were part of a change
+	/// set that ends right before the next update. The group listeners are
+	/// then called once per frame in the main thread, which is useful for
+	/// expensive listeners or when parameters are set from other threads.
+	void setAsyncChanges(bool async);
+	bool isAsyncChanges() const;
+
+	/// \brief Sets the queue async groups post their notifications to.
+	///
+	/// ofMainLoop sets its own event queue, which is processed before every
+	/// update. Without a queue async groups notify right away.
+	static void setAsyncEventQueue(ofEventQueue * queue);
+
 	std::vector<std::shared_ptr<ofAbstractParameter> >::iterator begin();
 	std::vector<std::shared_ptr<ofAbstractParameter> >::iterator end();
 	std::vector<std::shared_ptr<ofAbstractParameter> >::const_iterator begin() const;
@@ -254,12 +351,15 @@ protected:
 	const void* getInternalObject() const;
 
 private:
-	class Value{
+	class Value: public std::enable_shared_from_this<Value>{
 	public:
 		Value()
 		:serializable(true){}
 
 		void notifyParameterChanged(ofAbstractParameter & param);
+		void notifyParametersChanged(const std::vector<std::shared_ptr<ofAbstractParameter>> & params);
+		void addChanges(const std::vector<std::shared_ptr<ofAbstractParameter>> & params);
+		void flushChanges();
 
 		std::map<std::string,std::size_t> parametersIndex;
 		std::vector<std::shared_ptr<ofAbstractParameter> > parameters;
@@ -267,6 +367,16 @@ private:
 		bool serializable;
 		std::vector<std::weak_ptr<Value>> parents;
 		ofEvent<ofAbstractParameter> parameterChangedE;
+		ofEvent<const ofParameterGroupChangedEventArgs> parametersChangedE;
+
+		// pending changes of a change set or waiting for the next frame
+		// can be changed from any thread, the rest is guarded by the mutex
+		std::atomic<int> changesDepth{0};
+		std::atomic<bool> asyncChanges{false};
+		bool flushScheduled = false;
+		std::vector<std::shared_ptr<ofAbstractParameter>> changes;
+		std::unordered_set<const void*> changedObjects;
+		std::mutex changesMutex;
 	};
 	std::shared_ptr<Value> obj;
 	ofParameterGroup(std::shared_ptr<Value> obj)
@@ -460,6 +570,49 @@ namespace priv{
 		throw std::exception();
 
 	}
+
+	// Binary representation of the values of a parameter, used by
+	// ofParameterSnapshot. Trivially copyable types like numbers, vectors
+	// or colors are stored as their bytes, strings as their characters and
+	// anything else as its string representation
+	template<typename ParameterType, bool = std::is_trivially_copyable<ParameterType>::value>
+	struct BinaryImpl{
+		static void append(const ParameterType & value, std::string & data){
+			data += toStringImpl(value);
+		}
+
+		static bool read(const char * data, std::size_t size, ParameterType & value){
+			value = fromStringImpl<ParameterType>(std::string(data, size));
+			return true;
+		}
+	};
+
+	template<typename ParameterType>
+	struct BinaryImpl<ParameterType, true>{
+		static void append(const ParameterType & value, std::string & data){
+			data.append(reinterpret_cast<const char*>(&value), sizeof(ParameterType));
+		}
+
+		static bool read(const char * data, std::size_t size, ParameterType & value){
+			if(size != sizeof(ParameterType)){
+				return false;
+			}
+			memcpy(&value, data, size);
+			return true;
+		}
+	};
+
+	template<>
+	struct BinaryImpl<std::string, false>{
+		static void append(const std::string & value, std::string & data){
+			data += value;
+		}
+
+		static bool read(const char * data, std::size_t size, std::string & value){
+			value.assign(data, size);
+			return true;
+		}
+	};
 }
 }
 /*! \endcond */
@@ -583,6 +736,8 @@ public:
 	const void* getInternalObject() const;
 
 protected:
+	void toBinary(std::string & data) const;
+	bool fromBinary(const char * data, std::size_t size);
 
 private:
 	class Value{
@@ -979,6 +1134,32 @@ const void* ofParameter<ParameterType>::getInternalObject() const{
 	return obj.get();
 }
 
+template<typename ParameterType>
+void ofParameter<ParameterType>::toBinary(std::string & data) const{
+	of::priv::BinaryImpl<ParameterType>::append(obj->value, data);
+}
+
+template<typename ParameterType>
+bool ofParameter<ParameterType>::fromBinary(const char * data, std::size_t size){
+	// avoid notifying a change if the value is the same
+	std::string current;
+	toBinary(current);
+	if(current.size() == size && std::equal(current.begin(), current.end(), data)){
+		return true;
+	}
+	try{
+		ParameterType value = obj->value;
+		if(!of::priv::BinaryImpl<ParameterType>::read(data, size, value)){
+			return false;
+		}
+		set(value);
+		return true;
+	}catch(...){
+		ofLogError("ofParameter") << "fromBinary(): couldn't read value of " << getName();
+		return false;
+	}
+}
+
 template<>
 class ofParameter<void>: public ofAbstractParameter{
 public:
@@ -1168,6 +1349,14 @@ protected:
 		return parameter.getInternalObject();
 	}
 
+	void toBinary(std::string & data) const{
+		parameter.toBinary(data);
+	}
+
+	bool fromBinary(const char * data, std::size_t size){
+		return parameter.fromBinary(data, size);
+	}
+
 	ofParameter<ParameterType> parameter;
 
 	template<typename T>
@@ -1,8 +1,13 @@
 #include "ofUtils.h"
 #include "ofParameter.h"
+#include "ofEventQueue.h"
 
 using namespace std;
 
+namespace{
+	std::atomic<ofEventQueue*> asyncEventQueue{nullptr};
+}
+
 ofParameterGroup::ofParameterGroup()
 :obj(new Value)
 {
@@ -411,7 +416,15 @@ bool ofParameterGroup::contains(const string& name) const{
 }
 
 void ofParameterGroup::Value::notifyParameterChanged(ofAbstractParameter & param){
+	if(changesDepth > 0 || asyncChanges){
+		addChanges({param.newReference()});
+		return;
+	}
 	ofNotifyEvent(parameterChangedE,param);
+	if(parametersChangedE.size()){
+		ofParameterGroupChangedEventArgs args{{param.newReference()}};
+		ofNotifyEvent(parametersChangedE,args);
+	}
 	parents.erase(std::remove_if(parents.begin(),parents.end(),[&param](const weak_ptr<Value> & p){
 		auto parent = p.lock();
 		if(parent) parent->notifyParameterChanged(param);
@@ -419,6 +432,71 @@ void ofParameterGroup::Value::notifyParameterChanged(ofAbstractParameter & param
 	}),parents.end());
 }
 
+void ofParameterGroup::Value::notifyParametersChanged(const vector<shared_ptr<ofAbstractParameter>> & params){
+	if(changesDepth > 0 || asyncChanges){
+		addChanges(params);
+		return;
+	}
+	for(auto & param: params){
+		ofNotifyEvent(parameterChangedE,*param);
+	}
+	ofParameterGroupChangedEventArgs args{params};
+	ofNotifyEvent(parametersChangedE,args);
+	parents.erase(std::remove_if(parents.begin(),parents.end(),[&params](const weak_ptr<Value> & p){
+		auto parent = p.lock();
+		if(parent) parent->notifyParametersChanged(params);
+		return !parent;
+	}),parents.end());
+}
+
+void ofParameterGroup::Value::addChanges(const vector<shared_ptr<ofAbstractParameter>> & params){
+	std::unique_lock<std::mutex> lck(changesMutex);
+	for(auto & param: params){
+		if(changedObjects.insert(param->getInternalObject()).second){
+			changes.push_back(param);
+		}
+	}
+	if(asyncChanges && changesDepth == 0 && !flushScheduled && !changes.empty()){
+		auto queue = asyncEventQueue.load();
+		if(!queue){
+			lck.unlock();
+			flushChanges();
+			return;
+		}
+		flushScheduled = true;
+		weak_ptr<Value> weakSelf = shared_from_this();
+		queue->post([weakSelf]{
+			auto self = weakSelf.lock();
+			if(self){
+				self->flushChanges();
+			}
+		});
+	}
+}
+
+void ofParameterGroup::Value::flushChanges(){
+	vector<shared_ptr<ofAbstractParameter>> params;
+	{
+		std::unique_lock<std::mutex> lck(changesMutex);
+		std::swap(params, changes);
+		changedObjects.clear();
+		flushScheduled = false;
+	}
+	if(params.empty()){
+		return;
+	}
+	for(auto & param: params){
+		ofNotifyEvent(parameterChangedE,*param);
+	}
+	ofParameterGroupChangedEventArgs args{params};
+	ofNotifyEvent(parametersChangedE,args);
+	parents.erase(std::remove_if(parents.begin(),parents.end(),[&params](const weak_ptr<Value> & p){
+		auto parent = p.lock();
+		if(parent) parent->notifyParametersChanged(params);
+		return !parent;
+	}),parents.end());
+}
+
 const ofParameterGroup ofParameterGroup::getFirstParent() const{
 	auto first = std::find_if(obj->parents.begin(),obj->parents.end(),[](const weak_ptr<Value> & p){return p.lock()!=nullptr;});
 	if(first!=obj->parents.end()){
@@ -432,6 +510,66 @@ ofEvent<ofAbstractParameter> & ofParameterGroup::parameterChangedE(){
 	return obj->parameterChangedE;
 }
 
+ofEvent<const ofParameterGroupChangedEventArgs> & ofParameterGroup::parametersChangedE(){
+	return obj->parametersChangedE;
+}
+
+void ofParameterGroup::beginChanges(){
+	obj->changesDepth++;
+}
+
+void ofParameterGroup::endChanges(){
+	auto depth = obj->changesDepth.load();
+	do{
+		if(depth == 0){
+			ofLogError("ofParameterGroup") << "endChanges(): called without a matching beginChanges() on group " << getName();
+			return;
+		}
+	}while(!obj->changesDepth.compare_exchange_weak(depth, depth - 1));
+	if(depth == 1){
+		if(obj->asyncChanges){
+			// schedules the notification for the next frame
+			obj->addChanges({});
+		}else{
+			obj->flushChanges();
+		}
+	}
+}
+
+bool ofParameterGroup::isChanging() const{
+	return obj->changesDepth > 0;
+}
+
+ofParameterGroup::ChangeSet::ChangeSet(ofParameterGroup & group)
+:group(group){
+	group.beginChanges();
+}
+
+ofParameterGroup::ChangeSet::~ChangeSet(){
+	group.endChanges();
+}
+
+void ofParameterGroup::setAsyncChanges(bool async){
+	obj->asyncChanges = async;
+	if(!async && obj->changesDepth == 0){
+		obj->flushChanges();
+	}
+}
+
+bool ofParameterGroup::isAsyncChanges() const{
+	return obj->asyncChanges;
+}
+
+void ofParameterGroup::setAsyncEventQueue(ofEventQueue * queue){
+	asyncEventQueue = queue;
+}
+
+bool ofParameterGroupChangedEventArgs::contains(const ofAbstractParameter & parameter) const{
+	return std::any_of(parameters.begin(), parameters.end(), [&](const shared_ptr<ofAbstractParameter> & p){
+		return p->isReferenceTo(parameter);
+	});
+}
+
 ofAbstractParameter & ofParameterGroup::back(){
 	return *obj->parameters.back();
 }
@@ -0,0 +1,207 @@
+#include "ofParameterSnapshot.h"
+#include "ofParameterGroup.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+using namespace std;
+
+namespace{
+	const char magic[] = {'O','F','P','S'};
+	const uint8_t version = 1;
+
+	void writeVarint(string & data, uint64_t value){
+		while(value >= 0x80){
+			data += char((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		data += char(value);
+	}
+
+	bool readVarint(const char *& data, const char * end, uint64_t & value){
+		value = 0;
+		for(int shift = 0; shift < 64; shift += 7){
+			if(data == end){
+				return false;
+			}
+			uint8_t byte = *data++;
+			value |= uint64_t(byte & 0x7f) << shift;
+			if(!(byte & 0x80)){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void writeId(string & data, uint32_t id){
+		for(int i = 0; i < 4; i++){
+			data += char((id >> (i * 8)) & 0xff);
+		}
+	}
+
+	bool readId(const char *& data, const char * end, uint32_t & id){
+		if(end - data < 4){
+			return false;
+		}
+		id = 0;
+		for(int i = 0; i < 4; i++){
+			id |= uint32_t(uint8_t(*data++)) << (i * 8);
+		}
+		return true;
+	}
+}
+
+//--------------------------------------------------------------
+ofParameterSnapshot::ofParameterSnapshot(){}
+
+//--------------------------------------------------------------
+ofParameterSnapshot::ofParameterSnapshot(const ofParameterGroup & group){
+	capture(group, "", values);
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::capture(const ofParameterGroup & group, const string & prefix, map<uint32_t, string> & values){
+	for(auto & p: group){
+		if(!p->isSerializable()){
+			continue;
+		}
+		auto path = prefix + p->getEscapedName();
+		if(p->type() == typeid(ofParameterGroup).name()){
+			capture(static_cast<const ofParameterGroup &>(*p), path + "/", values);
+			continue;
+		}
+		string data;
+		try{
+			p->toBinary(data);
+		}catch(std::exception & e){
+			ofLogWarning("ofParameterSnapshot") << "couldn't capture " << path << ": " << e.what();
+			continue;
+		}
+		auto inserted = values.emplace(getId(path), std::move(data));
+		if(!inserted.second){
+			ofLogWarning("ofParameterSnapshot") << "parameter " << path << " has the same id as a previous one, "
+				"it'll be ignored. Parameters need unique names in their group";
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::index(ofParameterGroup & group, const string & prefix, map<uint32_t, ofAbstractParameter*> & parameters){
+	for(auto & p: group){
+		if(!p->isSerializable()){
+			continue;
+		}
+		auto path = prefix + p->getEscapedName();
+		if(p->type() == typeid(ofParameterGroup).name()){
+			index(static_cast<ofParameterGroup &>(*p), path + "/", parameters);
+		}else if(!p->isReadOnly()){
+			parameters.emplace(getId(path), p.get());
+		}
+	}
+}
+
+//--------------------------------------------------------------
+ofParameterSnapshot ofParameterSnapshot::diff(const ofParameterSnapshot & newer) const{
+	ofParameterSnapshot changes;
+	for(auto & value: newer.values){
+		auto current = values.find(value.first);
+		if(current == values.end() || current->second != value.second){
+			changes.values.insert(value);
+		}
+	}
+	return changes;
+}
+
+//--------------------------------------------------------------
+ofParameterSnapshot ofParameterSnapshot::diff(const ofParameterGroup & group) const{
+	return diff(ofParameterSnapshot(group));
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::apply(ofParameterGroup & group) const{
+	map<uint32_t, ofAbstractParameter*> parameters;
+	index(group, "", parameters);
+	ofParameterGroup::ChangeSet changes(group);
+	for(auto & value: values){
+		auto parameter = parameters.find(value.first);
+		if(parameter == parameters.end()){
+			continue;
+		}
+		if(!parameter->second->fromBinary(value.second.data(), value.second.size())){
+			ofLogWarning("ofParameterSnapshot") << "apply(): invalid value for " << parameter->second->getName();
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::merge(const ofParameterSnapshot & other){
+	for(auto & value: other.values){
+		values[value.first] = value.second;
+	}
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::save(ofBuffer & buffer) const{
+	string data(magic, sizeof(magic));
+	data += char(version);
+	writeVarint(data, values.size());
+	for(auto & value: values){
+		writeId(data, value.first);
+		writeVarint(data, value.second.size());
+		data += value.second;
+	}
+	buffer.set(data.data(), data.size());
+}
+
+//--------------------------------------------------------------
+bool ofParameterSnapshot::load(const ofBuffer & buffer){
+	const char * data = buffer.getData();
+	const char * end = data + buffer.size();
+	if(buffer.size() < sizeof(magic) + 1 || !std::equal(magic, magic + sizeof(magic), data)){
+		ofLogError("ofParameterSnapshot") << "load(): data is not a parameter snapshot";
+		return false;
+	}
+	data += sizeof(magic);
+	if(uint8_t(*data++) != version){
+		ofLogError("ofParameterSnapshot") << "load(): unsupported snapshot version " << int(uint8_t(data[-1]));
+		return false;
+	}
+
+	map<uint32_t, string> loaded;
+	uint64_t count;
+	if(!readVarint(data, end, count)){
+		ofLogError("ofParameterSnapshot") << "load(): truncated snapshot";
+		return false;
+	}
+	for(uint64_t i = 0; i < count; i++){
+		uint32_t id;
+		uint64_t size;
+		if(!readId(data, end, id) || !readVarint(data, end, size) || size > uint64_t(end - data)){
+			ofLogError("ofParameterSnapshot") << "load(): truncated snapshot";
+			return false;
+		}
+		loaded[id].assign(data, size);
+		data += size;
+	}
+	values = std::move(loaded);
+	return true;
+}
+
+//--------------------------------------------------------------
+size_t ofParameterSnapshot::size() const{
+	return values.size();
+}
+
+//--------------------------------------------------------------
+bool ofParameterSnapshot::empty() const{
+	return values.empty();
+}
+
+//--------------------------------------------------------------
+void ofParameterSnapshot::clear(){
+	values.clear();
+}
+
+//--------------------------------------------------------------
+uint32_t ofParameterSnapshot::getId(const string & path){
+	return ofHashFnv1a32(path.data(), path.size());
+}
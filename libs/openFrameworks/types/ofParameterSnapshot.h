@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ofParameter.h"
+#include "ofFileUtils.h"
+#include <map>
+
+/// \brief A compact binary copy of the values of an ofParameterGroup.
+///
+/// Every parameter is identified by an id computed from its path inside
+/// the group, like `"sub/radius"`, so a snapshot can be applied to any
+/// group with the same structure, for example one in another process
+/// that receives it through the network. Values of trivially copyable
+/// types like numbers, vectors or colors are stored as their bytes,
+/// strings as their characters and anything else in its string form.
+///
+/// A diff is a snapshot that only contains the values that changed, so
+/// it can be used to implement undo or to send only what changed:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// last = ofParameterSnapshot(group);
+///
+/// // update, send only what changed since the last frame
+/// auto changes = last.diff(group);
+/// if(!changes.empty()){
+/// 	ofBuffer buffer;
+/// 	changes.save(buffer);
+/// 	send(buffer);
+/// 	last.merge(changes);
+/// }
+///
+/// // receiver
+/// ofParameterSnapshot changes;
+/// if(changes.load(buffer)){
+/// 	changes.apply(group);
+/// }
+/// ~~~~
+///
+/// Values are stored in the byte order of the machine, which is little
+/// endian in every platform openFrameworks supports.
+class ofParameterSnapshot{
+public:
+	ofParameterSnapshot();
+
+	/// \brief Captures the values of all the serializable parameters in group.
+	explicit ofParameterSnapshot(const ofParameterGroup & group);
+
+	/// \brief Returns the values in newer that are different or not in this one.
+	ofParameterSnapshot diff(const ofParameterSnapshot & newer) const;
+
+	/// \brief Returns the current values in group that are different from
+	/// this snapshot.
+	ofParameterSnapshot diff(const ofParameterGroup & group) const;
+
+	/// \brief Sets the parameters in group to the values in the snapshot.
+	///
+	/// Parameters that aren't in the snapshot aren't modified and values
+	/// that didn't change don't notify. All the changes are notified to the
+	/// group listeners as a single change set, see
+	/// ofParameterGroup::beginChanges().
+	void apply(ofParameterGroup & group) const;
+
+	/// \brief Adds the values of other to this snapshot, replacing the ones
+	/// for the same parameters, usually to apply a diff to a snapshot.
+	void merge(const ofParameterSnapshot & other);
+
+	/// \brief Writes the snapshot in its binary format.
+	void save(ofBuffer & buffer) const;
+
+	/// \brief Reads a snapshot written with save().
+	/// \returns false if the data is not a valid snapshot.
+	bool load(const ofBuffer & buffer);
+
+	/// \returns the number of values in the snapshot.
+	std::size_t size() const;
+	bool empty() const;
+	void clear();
+
+	/// \returns the id of a parameter from its path in the group with
+	/// the escaped names separated by '/', like `"sub/radius"`.
+	static uint32_t getId(const std::string & path);
+
+private:
+	static void capture(const ofParameterGroup & group, const std::string & prefix, std::map<uint32_t, std::string> & values);
+	static void index(ofParameterGroup & group, const std::string & prefix, std::map<uint32_t, ofAbstractParameter*> & parameters);
+
+	std::map<uint32_t, std::string> values;
+};
@@ -92,6 +92,7 @@ inline void ofDeserialize(const ofJson & json, ofAbstractParameter & parameter){
 	if(json.find(name) != json.end()){
 		if(parameter.type() == typeid(ofParameterGroup).name()){
 			ofParameterGroup & group = static_cast <ofParameterGroup &>(parameter);
+			ofParameterGroup::ChangeSet changes(group);
 			for(auto & p: group){
 				ofDeserialize(json[name], *p);
 			}
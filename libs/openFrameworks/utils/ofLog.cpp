@@ -1,7 +1,7 @@
 #include "ofLog.h"
 #include "ofConstants.h"
 #include <ofUtils.h>
-#include <map>
+#include <algorithm>
 #include <cstdarg>
 #ifdef TARGET_ANDROID
 	#include "ofxAndroidLogChannel.h"
@@ -9,7 +9,7 @@
 
 using namespace std;
 
-static ofLogLevel currentLogLevel =  OF_LOG_NOTICE;
+static atomic<ofLogLevel> currentLogLevel{OF_LOG_NOTICE};
 
 bool ofLog::bAutoSpace = false;
 string & ofLog::getPadding() {
@@ -17,9 +17,163 @@ string & ofLog::getPadding() {
 	return *padding;
 }
 
-static map<string,ofLogLevel> & getModules(){
-	static map<string,ofLogLevel> * modules = new map<string,ofLogLevel>;
-	return *modules;
+namespace{
+	// Open addressing hash table of the module levels, it's never modified
+	// once published so messages can be checked without locking. Setting a
+	// module level copies it.
+	class ModuleLevels{
+	public:
+		struct Entry{
+			string module;
+			uint32_t hash = 0;
+			ofLogLevel level = OF_LOG_NOTICE;
+			bool used = false;
+		};
+
+		static uint32_t hash(const char * module, size_t size){
+			return ofHashFnv1a32(module, size);
+		}
+
+		const Entry * find(const char * module, size_t size) const{
+			if(count == 0){
+				return nullptr;
+			}
+			auto h = hash(module, size);
+			auto mask = entries.size() - 1;
+			for(auto i = h & mask; entries[i].used; i = (i + 1) & mask){
+				auto & entry = entries[i];
+				if(entry.hash == h && entry.module.size() == size && memcmp(entry.module.data(), module, size) == 0){
+					return &entry;
+				}
+			}
+			return nullptr;
+		}
+
+		unique_ptr<ModuleLevels> with(const string & module, ofLogLevel level) const{
+			auto table = make_unique<ModuleLevels>();
+			size_t size = 16;
+			while(size < (count + 1) * 2){
+				size *= 2;
+			}
+			table->entries.resize(size);
+			for(auto & entry: entries){
+				if(entry.used && entry.module != module){
+					table->insert(entry.module, entry.level);
+				}
+			}
+			table->insert(module, level);
+			return table;
+		}
+
+		ofLogLevel minLevel = OF_LOG_SILENT;
+		ofLogLevel maxLevel = OF_LOG_VERBOSE;
+
+	private:
+		void insert(const string & module, ofLogLevel level){
+			auto h = hash(module.data(), module.size());
+			auto mask = entries.size() - 1;
+			auto i = h & mask;
+			while(entries[i].used){
+				i = (i + 1) & mask;
+			}
+			entries[i].module = module;
+			entries[i].hash = h;
+			entries[i].level = level;
+			entries[i].used = true;
+			minLevel = std::min(minLevel, level);
+			maxLevel = std::max(maxLevel, level);
+			count++;
+		}
+
+		vector<Entry> entries;
+		size_t count = 0;
+	};
+
+	// the current table and the ones it replaced. Replaced tables might still
+	// be read by another thread so they are only freed once there are no
+	// readers, the same way ofEvent frees its listener copies
+	class Modules{
+	public:
+		void set(const string & module, ofLogLevel level){
+			lock_guard<mutex> lck(mtx);
+			auto next = current.load()->with(module, level);
+			minLevel = next->minLevel;
+			maxLevel = next->maxLevel;
+			retired.emplace_back(current.exchange(next.release()));
+			hasRetired = true;
+			reclaim();
+		}
+
+		// keeps the table it reads alive while it's in scope
+		class ReadScope{
+		public:
+			ReadScope(Modules & modules)
+			:modules(modules){
+				modules.readers++;
+				table = modules.current.load();
+			}
+
+			~ReadScope(){
+				if(--modules.readers == 0 && modules.hasRetired){
+					// if a level is being set right now that thread
+					// or the next reader will free the old tables
+					unique_lock<mutex> lck(modules.mtx, try_to_lock);
+					if(lck.owns_lock()){
+						modules.reclaim();
+					}
+				}
+			}
+
+			const ModuleLevels * operator->() const{
+				return table;
+			}
+
+		private:
+			Modules & modules;
+			const ModuleLevels * table;
+		};
+
+		// bounds of the levels in the current table so most messages
+		// can be decided without reading it
+		atomic<ofLogLevel> minLevel{OF_LOG_SILENT};
+		atomic<ofLogLevel> maxLevel{OF_LOG_VERBOSE};
+
+	private:
+		// must be called with mtx locked
+		void reclaim(){
+			if(readers == 0){
+				retired.clear();
+				hasRetired = false;
+			}
+		}
+
+		atomic<const ModuleLevels*> current{new ModuleLevels};
+		atomic<int> readers{0};
+		atomic<bool> hasRetired{false};
+		mutex mtx;
+		vector<unique_ptr<const ModuleLevels>> retired;
+	};
+
+	// never destroyed so messages can still be checked during static destruction
+	Modules & getModules(){
+		static Modules * modules = new Modules;
+		return *modules;
+	}
+
+	bool checkModuleLevel(ofLogLevel level, const char * module, size_t size){
+		auto global = currentLogLevel.load(memory_order_relaxed);
+		auto & modules = getModules();
+		// most messages are decided without looking up the module
+		if(level < std::min(global, modules.minLevel.load(memory_order_relaxed))){
+			return false;
+		}
+		if(level >= std::max(global, modules.maxLevel.load(memory_order_relaxed))){
+			return true;
+		}
+		Modules::ReadScope table(modules);
+		auto entry = table->find(module, size);
+		return level >= (entry ? entry->level : global);
+	}
 }
 
 static void noopDeleter(ofBaseLoggerChannel*){}
@@ -43,7 +197,7 @@ void ofSetLogLevel(ofLogLevel level){
 
 //--------------------------------------------------
 void ofSetLogLevel(string module, ofLogLevel level){
-	getModules()[module] = level;
+	getModules().set(module, level);
 }
 
 //--------------------------------------------------
@@ -53,11 +207,9 @@ ofLogLevel ofGetLogLevel(){
 
 //--------------------------------------------------
 ofLogLevel ofGetLogLevel(string module){
-	if (getModules().find(module) == getModules().end()) {
-		return currentLogLevel;
-	} else {
-		return getModules()[module];
-	}
+	Modules::ReadScope table(getModules());
+	auto entry = table->find(module.data(), module.size());
+	return entry ? entry->level : currentLogLevel.load();
 }
 
 //--------------------------------------------------
@@ -80,14 +232,15 @@ void ofLogToDebugView() {
 ofLog::ofLog(){
 	level = OF_LOG_NOTICE;
 	module = "";
-	bPrinted = false;
+	// disabled messages are marked as printed so they aren't built
+	bPrinted = !checkLog(level, module);
 }
 		
 //--------------------------------------------------
 ofLog::ofLog(ofLogLevel _level){
 	level = _level;
 	module = "";
-	bPrinted = false;
+	bPrinted = !checkLog(level, module);
 }
 
 //--------------------------------------------------
@@ -127,12 +280,17 @@ ofLog::~ofLog(){
 }
 
 bool ofLog::checkLog(ofLogLevel level, const string & module){
-	if(getModules().find(module)==getModules().end()){
-		if(level >= currentLogLevel) return true;
-	}else{
-		if(level >= getModules()[module]) return true;
-	}
-	return false;
+	return checkModuleLevel(level, module.data(), module.size());
+}
+
+//-------------------------------------------------------
+bool ofLog::isEnabled(ofLogLevel level, const string & module){
+	return checkModuleLevel(level, module.data(), module.size());
+}
+
+//-------------------------------------------------------
+bool ofLog::isEnabled(ofLogLevel level, const char * module){
+	return checkModuleLevel(level, module, strlen(module));
 }
 
 //-------------------------------------------------------
@@ -146,7 +304,7 @@ void ofLog::_log(ofLogLevel level, const string & module, const string & message
 ofLogVerbose::ofLogVerbose(const string & _module){
 	level = OF_LOG_VERBOSE;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogVerbose::ofLogVerbose(const string & _module, const string & _message){
@@ -168,7 +326,7 @@ ofLogVerbose::ofLogVerbose(const string & module, const char* format, ...){
 ofLogNotice::ofLogNotice(const string & _module){
 	level = OF_LOG_NOTICE;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogNotice::ofLogNotice(const string & _module, const string & _message){
@@ -190,7 +348,7 @@ ofLogNotice::ofLogNotice(const string & module, const char* format, ...){
 ofLogWarning::ofLogWarning(const string & _module){
 	level = OF_LOG_WARNING;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogWarning::ofLogWarning(const string & _module, const string & _message){
@@ -212,7 +370,7 @@ ofLogWarning::ofLogWarning(const string & module, const char* format, ...){
 ofLogError::ofLogError(const string & _module){
 	level = OF_LOG_ERROR;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogError::ofLogError(const string & _module, const string & _message){
@@ -234,7 +392,7 @@ ofLogError::ofLogError(const string & module, const char* format, ...){
 ofLogFatalError::ofLogFatalError(const string &  _module){
 	level = OF_LOG_FATAL_ERROR;
 	module = _module;
-	bPrinted=false;
+	bPrinted = !checkLog(level, module);
 }
 
 ofLogFatalError::ofLogFatalError(const string & _module, const string & _message){
@@ -297,7 +455,11 @@ void ofConsoleLoggerChannel::log(ofLogLevel level, const string & module, const
 	if(module != ""){
 		out << module << ": ";
 	}
-	out << message << endl;
+	if(batching){
+		out << message << '\n';
+	}else{
+		out << message << endl;
+	}
 }
 
 void ofConsoleLoggerChannel::log(ofLogLevel level, const string & module, const char* format, ...){
@@ -319,6 +481,16 @@ void ofConsoleLoggerChannel::log(ofLogLevel level, const string & module, const
 	fprintf(out, "\n");
 }
 
+void ofConsoleLoggerChannel::beginBatch(){
+	batching = true;
+}
+
+void ofConsoleLoggerChannel::endBatch(){
+	batching = false;
+	cout.flush();
+	cerr.flush();
+}
+
 
 #ifdef TARGET_WIN32
 #include <array>
@@ -382,7 +554,11 @@ void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const str
 	if(module != ""){
 		file << module << ": ";
 	}
-	file << message << endl;
+	if(batching){
+		file << message << '\n';
+	}else{
+		file << message << endl;
+	}
 }
 
 void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const char* format, ...){
@@ -397,5 +573,207 @@ void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const cha
 	if(module != ""){
 		file << module << ": ";
 	}
-	file << ofVAArgsToString(format,args) << endl;
+	if(batching){
+		file << ofVAArgsToString(format,args) << '\n';
+	}else{
+		file << ofVAArgsToString(format,args) << endl;
+	}
+}
+
+void ofFileLoggerChannel::beginBatch(){
+	batching = true;
+}
+
+void ofFileLoggerChannel::endBatch(){
+	batching = false;
+	file.flush();
+}
+
+//--------------------------------------------------
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(shared_ptr<ofBaseLoggerChannel> channel, size_t capacity, ofLogOverflowPolicy policy)
+:channel(channel)
+,policy(policy){
+	size_t size = 2;
+	while(size < capacity){
+		size *= 2;
+	}
+	slots.reset(new Slot[size]);
+	for(size_t i = 0; i < size; i++){
+		slots[i].sequence.store(i, memory_order_relaxed);
+	}
+	mask = size - 1;
+	thread = std::thread(&ofAsyncLoggerChannel::threadedFunction, this);
+}
+
+ofAsyncLoggerChannel::~ofAsyncLoggerChannel(){
+	{
+		lock_guard<mutex> lck(mtx);
+		running = false;
+	}
+	wakeUp.notify_one();
+	thread.join();
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const string & message){
+	push({level, module, message, chrono::system_clock::now(), this_thread::get_id()});
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, ...){
+	va_list args;
+	va_start(args, format);
+	log(level, module, format, args);
+	va_end(args);
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, va_list args){
+	push({level, module, ofVAArgsToString(format, args), chrono::system_clock::now(), this_thread::get_id()});
+}
+
+void ofAsyncLoggerChannel::push(Record && record){
+	auto level = record.level;
+	if(!tryPush(record)){
+		if(policy == OF_LOG_OVERFLOW_DROP && level != OF_LOG_FATAL_ERROR){
+			dropped++;
+			return;
+		}
+		if(this_thread::get_id() == thread.get_id()){
+			// the wrapped channel is logging from the writer thread, which
+			// is the only one that can make space, waiting would deadlock
+			write(record);
+			return;
+		}
+		do{
+			// space is made a batch at a time, the timeout covers a batch
+			// written between the failed push and the wait
+			unique_lock<mutex> lck(mtx);
+			wakeUp.notify_one();
+			writtenCondition.wait_for(lck, chrono::milliseconds(10));
+		}while(!tryPush(record));
+	}
+	if(sleeping){
+		lock_guard<mutex> lck(mtx);
+		wakeUp.notify_one();
+	}
+	if(level == OF_LOG_FATAL_ERROR){
+		flush();
+	}
+}
+
+// Bounded multiple producer queue, each slot's sequence tells if it's
+// free to write for the current lap or has a record ready to read
+bool ofAsyncLoggerChannel::tryPush(Record & record){
+	auto pos = enqueuePos.load(memory_order_relaxed);
+	while(true){
+		auto & slot = slots[pos & mask];
+		auto sequence = slot.sequence.load(memory_order_acquire);
+		auto diff = intptr_t(sequence) - intptr_t(pos);
+		if(diff == 0){
+			if(enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)){
+				slot.record = std::move(record);
+				slot.sequence.store(pos + 1, memory_order_release);
+				return true;
+			}
+		}else if(diff < 0){
+			return false;
+		}else{
+			pos = enqueuePos.load(memory_order_relaxed);
+		}
+	}
+}
+
+bool ofAsyncLoggerChannel::tryPop(Record & record){
+	auto & slot = slots[dequeuePos & mask];
+	if(slot.sequence.load(memory_order_acquire) != dequeuePos + 1){
+		return false;
+	}
+	record = std::move(slot.record);
+	slot.sequence.store(dequeuePos + mask + 1, memory_order_release);
+	dequeuePos++;
+	return true;
+}
+
+void ofAsyncLoggerChannel::flush(){
+	if(this_thread::get_id() == thread.get_id()){
+		return;
+	}
+	auto target = enqueuePos.load();
+	unique_lock<mutex> lck(mtx);
+	wakeUp.notify_one();
+	writtenCondition.wait(lck, [&]{ return written >= target; });
+}
+
+void ofAsyncLoggerChannel::setShowTimestamp(bool show){
+	showTimestamp = show;
+}
+
+void ofAsyncLoggerChannel::setShowThreadId(bool show){
+	showThreadId = show;
+}
+
+size_t ofAsyncLoggerChannel::getDroppedCount() const{
+	return dropped;
+}
+
+shared_ptr<ofBaseLoggerChannel> ofAsyncLoggerChannel::getChannel() const{
+	return channel;
+}
+
+void ofAsyncLoggerChannel::write(const Record & record){
+	if(!showTimestamp && !showThreadId){
+		channel->log(record.level, record.module, record.message);
+		return;
+	}
+	stringstream message;
+	if(showTimestamp){
+		auto t = chrono::system_clock::to_time_t(record.time);
+		auto ms = chrono::duration_cast<chrono::milliseconds>(record.time.time_since_epoch()).count() % 1000;
+		char buf[16];
+		strftime(buf, sizeof(buf), "%H:%M:%S", localtime(&t));
+		message << "[" << buf << "." << ofToString(ms, 3, '0') << "] ";
+	}
+	if(showThreadId){
+		message << "[" << record.threadId << "] ";
+	}
+	message << record.message;
+	channel->log(record.level, record.module, message.str());
+}
+
+void ofAsyncLoggerChannel::threadedFunction(){
+	Record record;
+	while(true){
+		if(!tryPop(record)){
+			unique_lock<mutex> lck(mtx);
+			if(!running){
+				break;
+			}
+			// a producer might miss that this thread is going to sleep,
+			// the timeout bounds how long its message waits in that case
+			sleeping = true;
+			wakeUp.wait_for(lck, chrono::milliseconds(10), [&]{
+				return !running || slots[dequeuePos & mask].sequence.load(memory_order_acquire) == dequeuePos + 1;
+			});
+			sleeping = false;
+			continue;
+		}
+
+		size_t count = 0;
+		channel->beginBatch();
+		do{
+			write(record);
+			count++;
+		}while(count <= mask && tryPop(record));
+
+		auto droppedNow = dropped.load();
+		if(droppedNow != droppedReported){
+			channel->log(OF_LOG_WARNING, "ofAsyncLoggerChannel", ofToString(droppedNow - droppedReported) + " messages dropped because the queue was full");
+			droppedReported = droppedNow;
+		}
+		channel->endBatch();
+
+		{
+			lock_guard<mutex> lck(mtx);
+			written += count;
+		}
+		writtenCondition.notify_all();
+	}
 }
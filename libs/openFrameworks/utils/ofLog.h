@@ -3,6 +3,11 @@
 #include "ofConstants.h"
 #include "ofFileUtils.h"
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 /// \file
 /// ofLog provides an interface for writing text output from your app.
@@ -95,6 +100,21 @@
 /// - ofLogToFile()
 /// - ofLogToConsole()
 /// - ofSetLoggerChannel()
+///
+/// ####Skipping disabled messages
+///
+/// The stream objects are created and their operands evaluated even if
+/// the message is filtered out by its level. The OF_LOGV(), OF_LOGN(),
+/// OF_LOGW(), OF_LOGE() and OF_LOGF() macros check the level of the module
+/// first and skip the whole statement if it wouldn't be printed:
+///
+/// ~~~~{.cpp}
+/// // expensiveDump() is only called if verbose messages for "MyClass"
+/// // are enabled
+/// OF_LOGV("MyClass") << "state: " << expensiveDump();
+/// ~~~~
+///
+/// Messages below OF_LOG_MIN_LEVEL are removed at compile time.
 
 
 /// \cond INTERNAL
@@ -123,6 +143,21 @@ enum ofLogLevel: short{
 					/// ofSetLogLevel(OF_LOG_SILENT).
 };
 
+/// \brief Messages logged with the OF_LOGV() family of macros below this
+/// level are removed at compile time.
+///
+/// It defaults to OF_LOG_NOTICE in release builds, where NDEBUG is defined,
+/// so verbose messages don't have any cost, and to OF_LOG_VERBOSE
+/// otherwise. Define it in the project flags to change it, for example
+/// `-DOF_LOG_MIN_LEVEL=OF_LOG_WARNING`.
+#ifndef OF_LOG_MIN_LEVEL
+	#ifdef NDEBUG
+		#define OF_LOG_MIN_LEVEL OF_LOG_NOTICE
+	#else
+		#define OF_LOG_MIN_LEVEL OF_LOG_VERBOSE
+	#endif
+#endif
+
 //--------------------------------------------
 //console colors for our logger - shame this doesn't work with the xcode console
 #ifdef TARGET_WIN32
@@ -456,6 +491,30 @@ class ofLog{
 	
 		/// \brief Get the current logging channel.
 		static std::shared_ptr<ofBaseLoggerChannel> getChannel();
+
+		/// \brief Check if a message would be printed.
+		///
+		/// Uses the level set for the module with ofSetLogLevel() or the
+		/// global one. It doesn't allocate or lock so it can be used to avoid
+		/// building messages that won't be printed.
+		///
+		/// \param level The log level.
+		/// \param module The target module.
+		/// \returns true if messages with that level and module are printed.
+		static bool isEnabled(ofLogLevel level, const std::string & module = "");
+		static bool isEnabled(ofLogLevel level, const char * module);
+
+		/// \brief Check if a message would be printed, always false if level
+		/// is below OF_LOG_MIN_LEVEL.
+		template<ofLogLevel level>
+		static bool isEnabled(const char * module = ""){
+			return level >= OF_LOG_MIN_LEVEL && isEnabled(level, module);
+		}
+
+		template<ofLogLevel level>
+		static bool isEnabled(const std::string & module){
+			return level >= OF_LOG_MIN_LEVEL && isEnabled(level, module);
+		}
 	
 		/// \}
 
@@ -477,7 +536,9 @@ class ofLog{
 		/// \returns A reference to itself.
 		template <class T> 
 		ofLog& operator<<(const T& value){
-			message << value << getPadding();
+			if(!bPrinted){
+				message << value << getPadding();
+			}
 			return *this;
 		}
 	
@@ -489,7 +550,9 @@ class ofLog{
 		/// \param func A function pointer that takes a std::ostream as an argument.
 		/// \returns A reference to itself.
 		ofLog& operator<<(std::ostream& (*func)(std::ostream&)){
-			func(message);
+			if(!bPrinted){
+				func(message);
+			}
 			return *this;
 		}
 	
@@ -632,6 +695,30 @@ class ofLogFatalError : public ofLog{
 		ofLogFatalError(const std::string & module, const char* format, ...) OF_PRINTF_ATTR(3, 4);
 };
 
+/// \brief Log a verbose message only if it would be printed.
+///
+/// Works as ofLogVerbose() but the message, including the operands of <<,
+/// is only evaluated if verbose messages are enabled for the module, and
+/// never if OF_LOG_MIN_LEVEL is higher than OF_LOG_VERBOSE. The module is
+/// evaluated twice.
+///
+/// ~~~~{.cpp}
+/// OF_LOGV("MyClass") << "state: " << expensiveDump();
+/// ~~~~
+#define OF_LOGV(...) if(!ofLog::isEnabled<OF_LOG_VERBOSE>(__VA_ARGS__)){}else ofLogVerbose(__VA_ARGS__)
+
+/// \brief Log a notice message only if it would be printed, see OF_LOGV().
+#define OF_LOGN(...) if(!ofLog::isEnabled<OF_LOG_NOTICE>(__VA_ARGS__)){}else ofLogNotice(__VA_ARGS__)
+
+/// \brief Log a warning message only if it would be printed, see OF_LOGV().
+#define OF_LOGW(...) if(!ofLog::isEnabled<OF_LOG_WARNING>(__VA_ARGS__)){}else ofLogWarning(__VA_ARGS__)
+
+/// \brief Log an error message only if it would be printed, see OF_LOGV().
+#define OF_LOGE(...) if(!ofLog::isEnabled<OF_LOG_ERROR>(__VA_ARGS__)){}else ofLogError(__VA_ARGS__)
+
+/// \brief Log a fatal error message only if it would be printed, see OF_LOGV().
+#define OF_LOGF(...) if(!ofLog::isEnabled<OF_LOG_FATAL_ERROR>(__VA_ARGS__)){}else ofLogFatalError(__VA_ARGS__)
+
 
 /// \cond INTERNAL
 
@@ -665,6 +752,15 @@ public:
 	/// \param format The printf-style format string.
 	/// \param args the list of printf-style arguments.
 	virtual void log(ofLogLevel level, const std::string & module, const char* format, va_list args)=0;
+
+	/// \brief Called before logging several messages in a row.
+	///
+	/// Channels that write to a stream can avoid flushing it after every
+	/// message until endBatch() is called.
+	virtual void beginBatch(){}
+
+	/// \brief Called after logging the messages of a batch.
+	virtual void endBatch(){}
 };
 
 /// \brief A logger channel that logs its messages to the console.
@@ -675,6 +771,11 @@ public:
 	void log(ofLogLevel level, const std::string & module, const std::string & message);
 	void log(ofLogLevel level, const std::string & module, const char* format, ...) OF_PRINTF_ATTR(4, 5);
 	void log(ofLogLevel level, const std::string & module, const char* format, va_list args);
+	void beginBatch();
+	void endBatch();
+
+private:
+	bool batching = false;
 };
 
 #ifdef TARGET_WIN32
@@ -712,12 +813,119 @@ public:
 	void log(ofLogLevel level, const std::string & module, const char* format, ...) OF_PRINTF_ATTR(4, 5);
 	void log(ofLogLevel level, const std::string & module, const char* format, va_list args);
 
+	void beginBatch();
+	void endBatch();
+
 	/// \brief CLose the log file.
 	void close();
 
 private:
 	ofFile file; ///< The location of the log file.
-	
+	bool batching = false;
+};
+
+/// \brief What an ofAsyncLoggerChannel does when its queue is full.
+enum ofLogOverflowPolicy{
+	/// \brief The message is discarded. Logging never blocks, the number
+	/// of discarded messages is reported once the queue has space again.
+	OF_LOG_OVERFLOW_DROP,
+	/// \brief The logging thread waits until there's space in the queue.
+	/// Messages logged by the wrapped channel from the writer thread are
+	/// written right away instead, since only that thread makes space.
+	OF_LOG_OVERFLOW_BLOCK
+};
+
+/// \brief A logger channel that writes the messages to another channel
+/// from a background thread.
+///
+/// Logging only formats the message and pushes it into a lock-free queue
+/// so threads that can't block, like the audio thread, can log without
+/// waiting for a file or the console. A background thread writes the
+/// messages in batches to the wrapped channel in the order they were
+/// logged.
+///
+/// The time and thread of each message are captured when it's logged
+/// and can be added to the written message with setShowTimestamp() and
+/// setShowThreadId().
+///
+/// ~~~~{.cpp}
+/// ofLogToFile("log.txt");
+/// ofSetLoggerChannel(std::make_shared<ofAsyncLoggerChannel>(ofGetLoggerChannel()));
+/// ~~~~
+///
+/// Fatal errors wait until they are written so they aren't lost if the
+/// application ends right after.
+class ofAsyncLoggerChannel: public ofBaseLoggerChannel{
+public:
+	/// \brief Create an ofAsyncLoggerChannel.
+	/// \param channel The channel messages are written to.
+	/// \param capacity Maximum number of messages waiting to be written,
+	/// rounded up to a power of 2.
+	/// \param policy What to do when the queue is full.
+	ofAsyncLoggerChannel(std::shared_ptr<ofBaseLoggerChannel> channel, std::size_t capacity = 4096, ofLogOverflowPolicy policy = OF_LOG_OVERFLOW_DROP);
+
+	/// \brief Writes the pending messages and stops the writer thread.
+	virtual ~ofAsyncLoggerChannel();
+
+	void log(ofLogLevel level, const std::string & module, const std::string & message);
+	void log(ofLogLevel level, const std::string & module, const char* format, ...) OF_PRINTF_ATTR(4, 5);
+	void log(ofLogLevel level, const std::string & module, const char* format, va_list args);
+
+	/// \brief Blocks until the messages logged before the call are written.
+	void flush();
+
+	/// \brief Prepend the time each message was logged, as
+	/// `[hours:minutes:seconds.milliseconds]`. Disabled by default.
+	void setShowTimestamp(bool show);
+
+	/// \brief Prepend the id of the thread that logged each message.
+	/// Disabled by default.
+	void setShowThreadId(bool show);
+
+	/// \returns the number of messages discarded because the queue was full.
+	std::size_t getDroppedCount() const;
+
+	/// \returns the channel messages are written to.
+	std::shared_ptr<ofBaseLoggerChannel> getChannel() const;
+
+private:
+	struct Record{
+		ofLogLevel level;
+		std::string module;
+		std::string message;
+		std::chrono::system_clock::time_point time;
+		std::thread::id threadId;
+	};
+
+	struct Slot{
+		std::atomic<std::size_t> sequence;
+		Record record;
+	};
+
+	void push(Record && record);
+	bool tryPush(Record & record);
+	bool tryPop(Record & record);
+	void write(const Record & record);
+	void threadedFunction();
+
+	std::shared_ptr<ofBaseLoggerChannel> channel;
+	ofLogOverflowPolicy policy;
+	std::unique_ptr<Slot[]> slots;
+	std::size_t mask;
+	std::atomic<std::size_t> enqueuePos{0};
+	std::size_t dequeuePos = 0;
+	std::atomic<std::size_t> written{0};
+	std::atomic<std::size_t> dropped{0};
+	std::size_t droppedReported = 0;
+	std::atomic<bool> showTimestamp{false};
+	std::atomic<bool> showThreadId{false};
+
+	std::atomic<bool> running{true};
+	std::atomic<bool> sleeping{false};
+	std::mutex mtx;
+	std::condition_variable wakeUp;
+	std::condition_variable writtenCondition;
+	std::thread thread;
 };
 
 /// \endcond
@@ -0,0 +1,465 @@
+#include "ofProfiler.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+std::atomic<bool> ofProfiler::enabled{false};
+
+namespace{
+	const size_t bufferSize = 1 << 14;
+
+	uint64_t now(){
+		static const auto epoch = chrono::steady_clock::now();
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+	}
+
+	struct Event{
+		uint32_t path;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	struct PathKey{
+		uint32_t parent;
+		const char * name;
+		bool operator==(const PathKey & other) const{
+			return parent == other.parent && name == other.name;
+		}
+	};
+
+	struct PathKeyHash{
+		size_t operator()(const PathKey & key) const{
+			return hash<const void*>()(key.name) ^ (size_t(key.parent) * 2654435761u);
+		}
+	};
+
+	// Events of one thread. Only that thread writes and only newFrame()
+	// reads so the ring doesn't need any lock.
+	class ThreadBuffer{
+	public:
+		ThreadBuffer(uint32_t id)
+		:id(id)
+		,name("thread " + ofToString(id)){}
+
+		void push(const Event & event){
+			auto w = writePos.load(memory_order_relaxed);
+			if(w - readPos.load(memory_order_acquire) == bufferSize){
+				dropped++;
+				return;
+			}
+			if(!events){
+				events.reset(new Event[bufferSize]);
+			}
+			events[w & (bufferSize - 1)] = event;
+			writePos.store(w + 1, memory_order_release);
+		}
+
+		template<typename F>
+		void drain(F f){
+			auto r = readPos.load(memory_order_relaxed);
+			auto w = writePos.load(memory_order_acquire);
+			for(; r != w; r++){
+				f(events[r & (bufferSize - 1)]);
+			}
+			readPos.store(w, memory_order_release);
+		}
+
+		// only reliable once the thread finished, with the registry mutex locked
+		bool empty() const{
+			return readPos.load(memory_order_relaxed) == writePos.load(memory_order_acquire);
+		}
+
+		const uint32_t id;
+		string name; // guarded by the registry mutex
+		atomic<bool> finished{false};
+		atomic<size_t> dropped{0};
+
+		// only used by the thread
+		uint32_t current = 0;
+		unordered_map<PathKey, uint32_t, PathKeyHash> paths;
+
+	private:
+		unique_ptr<Event[]> events;
+		atomic<size_t> writePos{0};
+		atomic<size_t> readPos{0};
+	};
+
+	struct PathNode{
+		uint32_t parent;
+		string name;
+		size_t depth;
+	};
+
+	struct Record{
+		vector<double> history;
+		size_t next = 0;
+		size_t filled = 0;
+		double frameMs = 0;
+		size_t frameCalls = 0;
+		double lastMs = 0;
+		size_t lastCalls = 0;
+	};
+
+	// Created once and never destroyed so threads that end after main
+	// returns can still use it.
+	struct Profiler{
+		// paths and threads, locked by threads only the first time they
+		// find a new marker
+		mutex registryMutex;
+		vector<PathNode> paths{{0, "", 0}};
+		map<pair<uint32_t, string>, uint32_t> pathIds;
+		vector<shared_ptr<ThreadBuffer>> threads;
+		uint32_t nextThreadId = 1;
+
+		// collected data, locked before the registry
+		mutex statsMutex;
+		map<pair<uint32_t, uint32_t>, Record> records;
+		map<uint32_t, string> threadNames;
+		size_t historySize = 120;
+		size_t droppedFinished = 0;
+		ofFile trace;
+		bool tracing = false;
+		bool firstTraceEvent = true;
+	};
+
+	Profiler & profiler(){
+		static Profiler * profiler = new Profiler;
+		return *profiler;
+	}
+
+	struct ThreadHolder{
+		shared_ptr<ThreadBuffer> buffer;
+		string name;
+		~ThreadHolder(){
+			if(buffer){
+				buffer->finished = true;
+			}
+		}
+	};
+
+	ThreadHolder & threadHolder(){
+		thread_local ThreadHolder holder;
+		return holder;
+	}
+
+	ThreadBuffer & threadBuffer(){
+		auto & holder = threadHolder();
+		if(!holder.buffer){
+			auto & p = profiler();
+			lock_guard<mutex> statsLock(p.statsMutex);
+			lock_guard<mutex> registryLock(p.registryMutex);
+			// newFrame() only runs while the profiler is enabled, threads
+			// that ended with nothing left to collect are removed here too
+			for(auto it = p.threads.begin(); it != p.threads.end();){
+				auto & thread = *it;
+				if(thread->finished && thread->empty()){
+					p.droppedFinished += thread->dropped;
+					it = p.threads.erase(it);
+				}else{
+					++it;
+				}
+			}
+			holder.buffer = make_shared<ThreadBuffer>(p.nextThreadId++);
+			if(!holder.name.empty()){
+				holder.buffer->name = holder.name;
+			}
+			p.threads.push_back(holder.buffer);
+		}
+		return *holder.buffer;
+	}
+
+	uint32_t registerPath(uint32_t parent, const char * name){
+		auto & p = profiler();
+		lock_guard<mutex> lck(p.registryMutex);
+		auto key = make_pair(parent, string(name));
+		auto found = p.pathIds.find(key);
+		if(found != p.pathIds.end()){
+			return found->second;
+		}
+		auto id = uint32_t(p.paths.size());
+		p.paths.push_back({parent, name, p.paths[parent].depth + 1});
+		p.pathIds[key] = id;
+		return id;
+	}
+
+	string escapeJson(const string & str){
+		string escaped;
+		for(auto c: str){
+			switch(c){
+			case '"': escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\t': escaped += "\\t"; break;
+			default:
+				if(uint8_t(c) < 0x20){
+					char buf[8];
+					snprintf(buf, sizeof(buf), "\\u%04x", c);
+					escaped += buf;
+				}else{
+					escaped += c;
+				}
+			}
+		}
+		return escaped;
+	}
+
+	void writeTraceEvent(Profiler & p, const string & json){
+		if(!p.firstTraceEvent){
+			p.trace << ",\n";
+		}
+		p.trace << json;
+		p.firstTraceEvent = false;
+	}
+
+	string getPath(const Profiler & p, uint32_t path){
+		string result = p.paths[path].name;
+		for(auto parent = p.paths[path].parent; parent != 0; parent = p.paths[parent].parent){
+			result = p.paths[parent].name + "/" + result;
+		}
+		return result;
+	}
+}
+
+//--------------------------------------------------------------
+void ofProfileScope::begin(const char * name){
+	auto & buffer = threadBuffer();
+	parent = buffer.current;
+	PathKey key{parent, name};
+	auto found = buffer.paths.find(key);
+	if(found != buffer.paths.end()){
+		buffer.current = found->second;
+	}else{
+		buffer.current = registerPath(parent, name);
+		buffer.paths.emplace(key, buffer.current);
+	}
+	started = true;
+	start = now();
+}
+
+//--------------------------------------------------------------
+void ofProfileScope::end(){
+	auto end = now();
+	auto & buffer = threadBuffer();
+	buffer.push({buffer.current, start, end});
+	buffer.current = parent;
+}
+
+//--------------------------------------------------------------
+void ofProfiler::setEnabled(bool enabled){
+	ofProfiler::enabled = enabled;
+}
+
+//--------------------------------------------------------------
+void ofProfiler::newFrame(){
+	auto & p = profiler();
+	lock_guard<mutex> statsLock(p.statsMutex);
+	lock_guard<mutex> registryLock(p.registryMutex);
+	char json[256];
+	for(auto it = p.threads.begin(); it != p.threads.end();){
+		auto & thread = *it;
+		// checked before draining, a thread that ended can't record
+		// anything else so it can be removed once drained
+		bool finished = thread->finished;
+		p.threadNames[thread->id] = thread->name;
+		thread->drain([&](const Event & event){
+			auto & record = p.records[make_pair(thread->id, event.path)];
+			record.frameMs += (event.end - event.start) / 1000000.0;
+			record.frameCalls++;
+			if(p.tracing){
+				snprintf(json, sizeof(json), "\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					unsigned(thread->id), event.start / 1000.0, (event.end - event.start) / 1000.0);
+				writeTraceEvent(p, "{\"name\":\"" + escapeJson(p.paths[event.path].name) + "\"," + json);
+			}
+		});
+		if(finished){
+			p.droppedFinished += thread->dropped;
+			it = p.threads.erase(it);
+		}else{
+			++it;
+		}
+	}
+
+	for(auto & pair: p.records){
+		auto & record = pair.second;
+		if(record.frameCalls == 0){
+			continue;
+		}
+		if(record.history.size() != p.historySize){
+			record.history.assign(p.historySize, 0);
+			record.next = 0;
+			record.filled = 0;
+		}
+		record.history[record.next] = record.frameMs;
+		record.next = (record.next + 1) % record.history.size();
+		record.filled = std::min(record.filled + 1, record.history.size());
+		record.lastMs = record.frameMs;
+		record.lastCalls = record.frameCalls;
+		record.frameMs = 0;
+		record.frameCalls = 0;
+	}
+}
+
+//--------------------------------------------------------------
+void ofProfiler::setHistorySize(size_t frames){
+	auto & p = profiler();
+	lock_guard<mutex> lck(p.statsMutex);
+	p.historySize = std::max<size_t>(frames, 1);
+}
+
+//--------------------------------------------------------------
+vector<ofProfiler::Stats> ofProfiler::getStats(){
+	auto & p = profiler();
+	lock_guard<mutex> statsLock(p.statsMutex);
+	lock_guard<mutex> registryLock(p.registryMutex);
+
+	// children of every marker in each thread, markers whose parent
+	// hasn't been collected yet are shown at the root
+	map<uint32_t, map<uint32_t, vector<uint32_t>>> children;
+	for(auto & pair: p.records){
+		if(pair.second.filled == 0){
+			continue;
+		}
+		auto thread = pair.first.first;
+		auto path = pair.first.second;
+		auto parent = p.paths[path].parent;
+		auto record = p.records.find(make_pair(thread, parent));
+		if(record == p.records.end() || record->second.filled == 0){
+			parent = 0;
+		}
+		children[thread][parent].push_back(path);
+	}
+
+	vector<Stats> stats;
+	for(auto & thread: children){
+		function<void(uint32_t, size_t)> add = [&](uint32_t parent, size_t depth){
+			auto found = thread.second.find(parent);
+			if(found == thread.second.end()){
+				return;
+			}
+			for(auto path: found->second){
+				auto & record = p.records[make_pair(thread.first, path)];
+				Stats s;
+				s.name = p.paths[path].name;
+				s.path = getPath(p, path);
+				s.thread = p.threadNames[thread.first];
+				s.depth = depth;
+				s.calls = record.lastCalls;
+				s.lastMs = record.lastMs;
+				s.averageMs = 0;
+				s.minMs = std::numeric_limits<double>::max();
+				s.maxMs = 0;
+				for(size_t i = 0; i < record.filled; i++){
+					s.averageMs += record.history[i];
+					s.minMs = std::min(s.minMs, record.history[i]);
+					s.maxMs = std::max(s.maxMs, record.history[i]);
+				}
+				s.averageMs /= record.filled;
+				stats.push_back(s);
+				add(path, depth + 1);
+			}
+		};
+		add(0, 0);
+	}
+	return stats;
+}
+
+//--------------------------------------------------------------
+string ofProfiler::getReport(){
+	auto stats = getStats();
+	size_t nameWidth = 0;
+	for(auto & s: stats){
+		nameWidth = std::max(nameWidth, s.depth * 2 + s.name.size());
+	}
+	ostringstream report;
+	report << fixed << setprecision(2);
+	string thread;
+	for(auto & s: stats){
+		if(&s == &stats.front() || s.thread != thread){
+			thread = s.thread;
+			report << thread << endl;
+			report << left << setw(nameWidth + 2) << "" << right
+				<< setw(9) << "last ms" << setw(9) << "avg" << setw(9) << "min" << setw(9) << "max" << setw(7) << "calls" << endl;
+		}
+		report << string(s.depth * 2 + 2, ' ') << left << setw(nameWidth - s.depth * 2) << s.name << right
+			<< setw(9) << s.lastMs << setw(9) << s.averageMs << setw(9) << s.minMs << setw(9) << s.maxMs << setw(7) << s.calls << endl;
+	}
+	return report.str();
+}
+
+//--------------------------------------------------------------
+void ofProfiler::clear(){
+	auto & p = profiler();
+	lock_guard<mutex> lck(p.statsMutex);
+	p.records.clear();
+}
+
+//--------------------------------------------------------------
+bool ofProfiler::startTrace(const std::filesystem::path & path){
+	stopTrace();
+	auto & p = profiler();
+	lock_guard<mutex> lck(p.statsMutex);
+	if(!p.trace.open(path, ofFile::WriteOnly)){
+		ofLogError("ofProfiler") << "startTrace(): couldn't open " << path;
+		return false;
+	}
+	p.trace << "{\"traceEvents\":[\n";
+	p.tracing = true;
+	p.firstTraceEvent = true;
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofProfiler::stopTrace(){
+	if(!isTracing()){
+		return;
+	}
+	newFrame();
+	auto & p = profiler();
+	lock_guard<mutex> lck(p.statsMutex);
+	for(auto & thread: p.threadNames){
+		writeTraceEvent(p, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + ofToString(thread.first) +
+			",\"args\":{\"name\":\"" + escapeJson(thread.second) + "\"}}");
+	}
+	p.trace << "\n]}\n";
+	p.trace.close();
+	p.tracing = false;
+}
+
+//--------------------------------------------------------------
+bool ofProfiler::isTracing(){
+	auto & p = profiler();
+	lock_guard<mutex> lck(p.statsMutex);
+	return p.tracing;
+}
+
+//--------------------------------------------------------------
+void ofProfiler::setThreadName(const string & name){
+	// threads that never record a marker don't get a buffer
+	auto & holder = threadHolder();
+	holder.name = name;
+	if(holder.buffer){
+		lock_guard<mutex> lck(profiler().registryMutex);
+		holder.buffer->name = name;
+	}
+}
+
+//--------------------------------------------------------------
+size_t ofProfiler::getDroppedCount(){
+	auto & p = profiler();
+	lock_guard<mutex> statsLock(p.statsMutex);
+	lock_guard<mutex> registryLock(p.registryMutex);
+	auto dropped = p.droppedFinished;
+	for(auto & thread: p.threads){
+		dropped += thread->dropped;
+	}
+	return dropped;
+}
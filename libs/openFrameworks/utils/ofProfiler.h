@@ -0,0 +1,160 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+
+/// \brief A hierarchical CPU profiler.
+///
+/// Code is measured by adding scoped markers, which record how long it
+/// takes until the end of the current scope. Markers nested inside other
+/// markers, even in different functions, are reported as their children:
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+/// 	OF_PROFILE_SCOPE("particles");
+/// 	for(auto & p: particles){
+/// 		p.update();
+/// 	}
+/// }
+/// ~~~~
+///
+/// The main loop adds markers around each frame, the update and draw of
+/// every window, the dispatch of the core events and polling the window
+/// events, so enabling the profiler is enough to see how the frame time is
+/// split:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// ofProfiler::setEnabled(true);
+///
+/// // draw
+/// ofDrawBitmapString(ofProfiler::getReport(), 20, 20);
+/// ~~~~
+///
+/// Each thread records into its own buffer without locking. The main loop
+/// collects the buffers at the start of every frame to update the rolling
+/// statistics and, if a trace is being recorded, to write the events to a
+/// file in the Chrome trace event format that can be opened in
+/// chrome://tracing or https://ui.perfetto.dev.
+///
+/// When the profiler is disabled, which is the default, a marker only
+/// checks a flag. Defining OF_PROFILER_DISABLED removes them completely.
+class ofProfiler{
+public:
+	/// \brief Rolling statistics of a marker.
+	struct Stats{
+		/// \brief Name of the marker.
+		std::string name;
+		/// \brief Names of the enclosing markers and this one separated by '/'.
+		std::string path;
+		/// \brief Name of the thread, see setThreadName().
+		std::string thread;
+		/// \brief Number of enclosing markers.
+		std::size_t depth;
+		/// \brief Times the marker ran in the last frame it ran.
+		std::size_t calls;
+		/// \brief Time in milliseconds spent in the marker, added for all its
+		/// calls in a frame, for the last frame it ran and the average,
+		/// minimum and maximum of the frames in the history.
+		double lastMs;
+		double averageMs;
+		double minMs;
+		double maxMs;
+	};
+
+	/// \brief Starts or stops recording markers.
+	static void setEnabled(bool enabled);
+	static bool isEnabled(){
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/// \brief Collects the markers recorded since the last call and starts a
+	/// new frame for the statistics.
+	///
+	/// The main loop calls it on every frame, it only has to be called
+	/// manually by applications that don't use ofMainLoop.
+	static void newFrame();
+
+	/// \brief Sets the number of frames used for the statistics, 120 by
+	/// default.
+	static void setHistorySize(std::size_t frames);
+
+	/// \brief Statistics of every marker, ordered by thread and then as a
+	/// tree, each marker followed by its children.
+	static std::vector<Stats> getStats();
+
+	/// \brief The statistics as an indented text table.
+	static std::string getReport();
+
+	/// \brief Discards the statistics.
+	static void clear();
+
+	/// \brief Starts writing every recorded marker to a Chrome trace event
+	/// JSON file.
+	///
+	/// The events are written as they are collected so long runs don't
+	/// accumulate them in memory.
+	///
+	/// \param path the file to write, relative to the data folder.
+	/// \returns false if the file couldn't be opened.
+	static bool startTrace(const std::filesystem::path & path);
+
+	/// \brief Writes the events pending and closes the trace file.
+	static void stopTrace();
+	static bool isTracing();
+
+	/// \brief Names the calling thread in the statistics and traces.
+	///
+	/// ofThread names its thread automatically with its getThreadName().
+	static void setThreadName(const std::string & name);
+
+	/// \brief Number of markers discarded because a thread recorded more than
+	/// fit in its buffer between two frames.
+	static std::size_t getDroppedCount();
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+/// \brief Measures the time until the end of its scope, usually created
+/// with OF_PROFILE_SCOPE().
+class ofProfileScope{
+public:
+	/// \param name name of the marker, has to stay valid until the
+	/// profiler is destroyed, usually a string literal.
+	ofProfileScope(const char * name){
+		if(ofProfiler::isEnabled()){
+			begin(name);
+		}
+	}
+
+	~ofProfileScope(){
+		if(started){
+			end();
+		}
+	}
+
+	ofProfileScope(const ofProfileScope &) = delete;
+	ofProfileScope & operator=(const ofProfileScope &) = delete;
+
+private:
+	void begin(const char * name);
+	void end();
+
+	bool started = false;
+	uint32_t parent;
+	uint64_t start;
+};
+
+/// \cond INTERNAL
+#define OF_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OF_PROFILE_CONCAT(a, b) OF_PROFILE_CONCAT_IMPL(a, b)
+/// \endcond
+
+/// \brief Adds a profiler marker from this point to the end of the scope.
+/// \param name a string literal naming the marker.
+#ifdef OF_PROFILER_DISABLED
+	#define OF_PROFILE_SCOPE(name)
+#else
+	#define OF_PROFILE_SCOPE(name) ofProfileScope OF_PROFILE_CONCAT(ofProfileScope_, __LINE__)(name)
+#endif
@@ -1,5 +1,6 @@
 #include "ofThread.h"
 #include "ofLog.h"
+#include "ofProfiler.h"
 
 #ifdef TARGET_ANDROID
 #include <jni.h>
@@ -159,6 +160,8 @@ void ofThread::run(){
 	}
 #endif
 
+	ofProfiler::setThreadName(getThreadName());
+
 	// user function
     // should loop endlessly.
 	try{
@@ -679,6 +679,35 @@ double ofToDouble(const std::string& doubleString);
 /// \returns the boolean represented by the string or 0 on failure.
 bool ofToBool(const std::string& boolString);
 
+/// \brief Hash a block of memory with 32 bit FNV-1a.
+///
+/// The result is the same on every platform and run so it can be stored,
+/// it isn't meant for security. Hashes of data split in several blocks are
+/// computed by passing the hash of the previous block.
+///
+/// \param data Pointer to the bytes to hash.
+/// \param size Number of bytes to hash.
+/// \param hash Hash of the previous data or the FNV-1a offset basis.
+/// \returns the hash of the data.
+inline uint32_t ofHashFnv1a32(const void * data, std::size_t size, uint32_t hash = 2166136261u){
+	auto bytes = static_cast<const unsigned char*>(data);
+	for(std::size_t i = 0; i < size; i++){
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/// \brief Hash a block of memory with 64 bit FNV-1a.
+///
+/// \sa ofHashFnv1a32()
+inline uint64_t ofHashFnv1a64(const void * data, std::size_t size, uint64_t hash = 14695981039346656037ull){
+	auto bytes = static_cast<const unsigned char*>(data);
+	for(std::size_t i = 0; i < size; i++){
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
 /// \brief Converts any value to its equivalent hexadecimal representation.
 ///
 /// The hexadecimal representation corresponds to the way a number is stored in
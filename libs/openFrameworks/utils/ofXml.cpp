@@ -448,6 +448,7 @@ void ofDeserialize(const ofXml & xml, ofAbstractParameter & parameter){
 	if(child){
 		if(parameter.type() == typeid(ofParameterGroup).name()){
 			ofParameterGroup & group = static_cast <ofParameterGroup &>(parameter);
+			ofParameterGroup::ChangeSet changes(group);
 			for(auto & p: group){
 				ofDeserialize(child, *p);
 			}
@@ -0,0 +1,199 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+
+	// grid of w x h vertices with its triangles in random order
+	ofMesh shuffledGrid(int w, int h){
+		ofMesh mesh;
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				mesh.addVertex(glm::vec3(x, y, sin(x * 0.1f) * 5));
+			}
+		}
+		vector<array<ofIndexType,3>> triangles;
+		for(int y = 0; y < h - 1; y++){
+			for(int x = 0; x < w - 1; x++){
+				ofIndexType i = x + y * w;
+				triangles.push_back({i, i + 1, i + w});
+				triangles.push_back({i + 1, i + w + 1, i + w});
+			}
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+		for(auto & t: triangles){
+			mesh.addTriangle(t[0], t[1], t[2]);
+		}
+		return mesh;
+	}
+
+	multiset<array<ofIndexType,3>> triangleIndices(const ofMesh & mesh){
+		multiset<array<ofIndexType,3>> triangles;
+		for(size_t i = 0; i + 2 < mesh.getNumIndices(); i += 3){
+			triangles.insert({mesh.getIndex(i), mesh.getIndex(i + 1), mesh.getIndex(i + 2)});
+		}
+		return triangles;
+	}
+
+	multiset<array<float,9>> trianglePositions(const ofMesh & mesh){
+		multiset<array<float,9>> triangles;
+		for(size_t i = 0; i + 2 < mesh.getNumIndices(); i += 3){
+			array<float,9> t;
+			for(size_t k = 0; k < 3; k++){
+				auto v = mesh.getVertex(mesh.getIndex(i + k));
+				t[k * 3] = v.x;
+				t[k * 3 + 1] = v.y;
+				t[k * 3 + 2] = v.z;
+			}
+			triangles.insert(t);
+		}
+		return triangles;
+	}
+
+	void testOptimizeVertexCache(){
+		auto mesh = shuffledGrid(100, 100);
+		auto original = mesh;
+		auto before = mesh.getCacheStats();
+		mesh.optimizeVertexCache();
+		auto after = mesh.getCacheStats();
+		ofxTest(triangleIndices(mesh) == triangleIndices(original), "optimizeVertexCache only reorders triangles");
+		ofxTestEq(mesh.getNumIndices(), original.getNumIndices(), "optimizeVertexCache keeps every index");
+		ofxTest(after.acmr <= before.acmr, "optimizeVertexCache doesn't make the ACMR worse");
+		ofxTest(after.acmr < 1.f, "optimizeVertexCache ACMR of a grid below 1, got " + ofToString(after.acmr));
+
+		// optimizing again can't make it worse either
+		auto optimized = mesh.getCacheStats();
+		mesh.optimizeVertexCache();
+		ofxTest(mesh.getCacheStats().acmr <= optimized.acmr * 1.01f, "optimizeVertexCache is stable");
+
+		// degenerate triangles repeat a vertex and have to be kept as is
+		auto degenerate = shuffledGrid(20, 20);
+		for(ofIndexType i = 0; i < 50; i++){
+			degenerate.addTriangle(i * 7, i * 7, i * 3);
+			degenerate.addTriangle(i * 5, i * 5, i * 5);
+		}
+		auto degenerateOriginal = degenerate;
+		before = degenerate.getCacheStats();
+		degenerate.optimizeVertexCache();
+		ofxTest(triangleIndices(degenerate) == triangleIndices(degenerateOriginal), "optimizeVertexCache keeps degenerate triangles");
+		ofxTest(degenerate.getCacheStats().acmr <= before.acmr, "optimizeVertexCache with degenerate triangles doesn't make the ACMR worse");
+
+		// trailing indices that don't make a triangle are left at the end
+		auto trailing = shuffledGrid(10, 10);
+		trailing.addIndex(3);
+		trailing.optimizeVertexCache();
+		ofxTestEq(trailing.getIndices().back(), ofIndexType(3), "optimizeVertexCache keeps trailing indices");
+	}
+
+	void testOptimizeIndices(){
+		auto mesh = shuffledGrid(100, 100);
+		auto original = mesh;
+		auto before = mesh.getCacheStats();
+		mesh.optimizeIndices();
+		ofxTest(trianglePositions(mesh) == trianglePositions(original), "optimizeIndices draws the same triangles");
+		ofxTestEq(mesh.getNumVertices(), original.getNumVertices(), "optimizeIndices keeps every vertex");
+		ofxTest(mesh.getCacheStats().acmr <= before.acmr, "optimizeIndices doesn't make the ACMR worse");
+
+		// after optimizeVertexFetch vertices are in the order they are first used
+		ofIndexType next = 0;
+		bool ordered = true;
+		for(auto index: mesh.getIndices()){
+			if(index > next){
+				ordered = false;
+			}else if(index == next){
+				next++;
+			}
+		}
+		ofxTest(ordered, "optimizeVertexFetch orders vertices by first use");
+	}
+
+	// every face of the mesh, closest hit first, in double precision
+	ofMeshBVH::Hit bruteForceIntersect(const ofMesh & mesh, const glm::dvec3 & origin, const glm::dvec3 & direction){
+		ofMeshBVH::Hit result;
+		for(size_t f = 0; f < mesh.getNumIndices() / 3; f++){
+			glm::dvec3 v0 = toGlm(mesh.getVertex(mesh.getIndex(f * 3)));
+			glm::dvec3 v1 = toGlm(mesh.getVertex(mesh.getIndex(f * 3 + 1)));
+			glm::dvec3 v2 = toGlm(mesh.getVertex(mesh.getIndex(f * 3 + 2)));
+			auto e1 = v1 - v0;
+			auto e2 = v2 - v0;
+			auto p = glm::cross(direction, e2);
+			double det = glm::dot(e1, p);
+			if(det == 0.0){
+				continue;
+			}
+			auto s = origin - v0;
+			double u = glm::dot(s, p) / det;
+			auto q = glm::cross(s, e1);
+			double v = glm::dot(direction, q) / det;
+			double t = glm::dot(e2, q) / det;
+			if(u >= 0.0 && v >= 0.0 && u + v <= 1.0 && t >= 0.0 && t < result.distance){
+				result.hit = true;
+				result.distance = t;
+				result.faceIndex = f;
+			}
+		}
+		return result;
+	}
+
+	void testBVH(){
+		// at a scale of 0.0001 per vertex the determinant of every ray
+		// triangle test is below the float epsilon
+		for(float scale: {1.f, 0.0001f}){
+			auto mesh = shuffledGrid(40, 40);
+			for(auto & v: mesh.getVertices()){
+				v *= scale;
+			}
+			ofMeshBVH bvh(mesh);
+			ofxTestEq(bvh.getNumFaces(), mesh.getNumIndices() / 3, "bvh has every face");
+
+			std::mt19937 random(2);
+			std::uniform_real_distribution<float> position(-2.f * scale, 41.f * scale);
+			std::uniform_real_distribution<float> tilt(-0.5f, 0.5f);
+			size_t hits = 0, matches = 0, numRays = 500;
+			for(size_t i = 0; i < numRays; i++){
+				glm::vec3 origin(position(random), position(random), 20.f * scale);
+				glm::vec3 direction(tilt(random), tilt(random), -1.f);
+				auto hit = bvh.intersect(origin, direction);
+				auto expected = bruteForceIntersect(mesh, origin, direction);
+				hits += expected.hit;
+				if(hit.hit == expected.hit && (!hit.hit || abs(hit.distance - expected.distance) <= 1e-4f * expected.distance)){
+					matches++;
+				}
+			}
+			ofxTest(hits > numRays / 2, "rays at scale " + ofToString(scale) + " hit the mesh");
+			ofxTestEq(matches, numRays, "bvh hits match brute force at scale " + ofToString(scale));
+
+			// the closest point can't be further than the closest vertex
+			size_t closer = 0;
+			for(size_t i = 0; i < 100; i++){
+				glm::vec3 p(position(random), position(random), position(random) - 20.f * scale);
+				auto closest = bvh.getClosestPoint(p);
+				float closestVertex = numeric_limits<float>::max();
+				for(auto & v: mesh.getVertices()){
+					closestVertex = min(closestVertex, glm::distance(p, toGlm(v)));
+				}
+				closer += closest.hit && closest.distance <= closestVertex * (1.f + 1e-5f);
+			}
+			ofxTestEq(closer, size_t(100), "bvh closest points at scale " + ofToString(scale));
+		}
+	}
+
+	void run(){
+		testOptimizeVertexCache();
+		testOptimizeIndices();
+		testBVH();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
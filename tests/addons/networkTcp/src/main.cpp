@@ -256,6 +256,190 @@ public:
 		ofxTestEq(received, str, "received max size message == sent message");
 	}
 
+	void testReactor(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testReactor";
+
+		int port = ofRandom(15000, 65535);
+
+		ofxTCPSettings settings(port);
+		settings.reactor = true;
+		ofxTCPServer server;
+		ofxTest(server.setup(settings), "reactor server");
+		ofxTest(server.isReactor(), "server is in reactor mode");
+
+		ofxTCPClient a;
+		ofxTest(a.setup("127.0.0.1", port, true), "first client");
+		server.waitConnectedClient(500);
+		ofxTestEq(server.getNumClients(), 1, "reactor accepts the client");
+
+		std::string messageReceived;
+		ofxTest(a.send("hello"), "send from client");
+		for(int i=0;i<100 && messageReceived.empty();i++){
+			ofSleepMillis(10);
+			messageReceived = server.receive(0);
+		}
+		ofxTestEq(messageReceived, std::string("hello"), "receive from reactor");
+
+		ofxTest(server.send(0, "world"), "send from reactor");
+		ofxTestEq(a.receive(), std::string("world"), "client receives from reactor");
+
+		ofxTest(a.sendRawBytes("raw", 3), "send raw bytes to reactor");
+		std::vector<char> raw(4, 0);
+		int received = 0;
+		for(int i=0;i<100 && received<3;i++){
+			ofSleepMillis(10);
+			received += server.receiveRawBytes(0, raw.data() + received, 3 - received);
+		}
+		ofxTestEq(std::string(raw.data()), std::string("raw"), "receive raw bytes from reactor");
+
+		ofxTCPClient b;
+		ofxTest(b.setup("127.0.0.1", port, true), "second client");
+		for(int i=0;i<100 && server.getNumClients()<2;i++){
+			ofSleepMillis(10);
+		}
+		ofxTestEq(server.getNumClients(), 2, "reactor accepts the second client");
+
+		ofxTest(server.sendToAll("all"), "send to all from reactor");
+		ofxTestEq(a.receive(), std::string("all"), "first client receives send to all");
+		ofxTestEq(b.receive(), std::string("all"), "second client receives send to all");
+
+		int connected = 0;
+		int disconnected = 0;
+		std::vector<ofxTCPMessageEventArgs> messages;
+		auto connectedListener = server.clientConnected.newListener([&](int &){
+			connected++;
+		});
+		auto disconnectedListener = server.clientDisconnected.newListener([&](int &){
+			disconnected++;
+		});
+		auto messageListener = server.messageReceived.newListener([&](ofxTCPMessageEventArgs & message){
+			messages.push_back(message);
+		});
+
+		ofxTest(b.send("first"), "send first message");
+		ofxTest(b.send("second"), "send second message");
+		for(int i=0;i<100 && messages.size()<2;i++){
+			ofSleepMillis(10);
+			server.dispatchEvents();
+		}
+		ofxTestEq(connected, 2, "connection events");
+		ofxTestEq(messages.size(), size_t(2), "message events");
+		if(messages.size() == 2){
+			ofxTestEq(messages[0].message, std::string("first"), "first message event");
+			ofxTestEq(messages[1].message, std::string("second"), "second message event");
+			ofxTestEq(messages[1].clientID, 1, "message event client");
+		}
+
+		ofxTest(server.disconnectClient(0), "reactor disconnects client");
+		ofxTest(!server.isClientConnected(0), "disconnected client");
+		bool detected = false;
+		for(int i=0;i<100 && !detected;i++){
+			ofSleepMillis(10);
+			detected = !a.isConnected();
+		}
+		ofxTest(detected, "client detects disconnection from reactor");
+
+		ofxTest(b.close(), "second client disconnects");
+		for(int i=0;i<100 && disconnected<2;i++){
+			ofSleepMillis(10);
+			server.dispatchEvents();
+		}
+		ofxTestEq(disconnected, 2, "disconnection events");
+		ofxTestEq(server.getNumClients(), 0, "reactor removes disconnected clients");
+
+		ofxTest(a.setup("127.0.0.1", port, true), "client reconnects");
+		server.waitConnectedClient(500);
+		ofxTest(server.isClientConnected(0), "reactor reuses ids");
+		ofxTest(server.close(), "reactor closes");
+	}
+
+	// loopback benchmark, numClients send numMessages each to the
+	// server and then the server sends numMessages to all of them.
+	// counts bytes instead of messages so it measures the server and not
+	// how the clients split messages
+	void benchmark(bool reactor, int numClients, int numMessages){
+		int port = ofRandom(15000, 65535);
+		std::string mode = reactor ? "reactor" : "threaded";
+
+		ofxTCPSettings settings(port);
+		settings.reactor = reactor;
+		ofxTCPServer server;
+		ofxTest(server.setup(settings), mode + " benchmark server");
+
+		std::vector<std::unique_ptr<ofxTCPClient>> clients;
+		for(int i=0;i<numClients;i++){
+			clients.emplace_back(new ofxTCPClient);
+			if(!clients.back()->setup("127.0.0.1", port, false)){
+				break;
+			}
+		}
+		ofxTestEq(int(clients.size()), numClients, mode + " benchmark clients connected");
+		for(int i=0;i<500 && server.getNumClients()<numClients;i++){
+			ofSleepMillis(10);
+		}
+
+		// every message is sent with the delimiter and a null byte
+		std::string message(64, 'x');
+		size_t messageSize = message.size() + std::string("[/TCP]").size() + 1;
+		size_t total = numClients * numMessages * messageSize;
+		std::vector<char> buffer(65536);
+
+		size_t received = 0;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i=0;i<numMessages;i++){
+			for(auto & client: clients){
+				client->send(message);
+			}
+		}
+		while(received < total && ofGetElapsedTimeMicros() - start < 10000000){
+			for(int i=0;i<server.getLastID();i++){
+				int ret;
+				while((ret = server.receiveRawBytes(i, buffer.data(), buffer.size())) > 0){
+					received += ret;
+				}
+			}
+		}
+		auto receiveTime = ofGetElapsedTimeMicros() - start;
+		ofxTestEq(received, total, mode + " benchmark bytes received by the server");
+
+		received = 0;
+		start = ofGetElapsedTimeMicros();
+		for(int i=0;i<numMessages;i++){
+			server.sendToAll(message);
+		}
+		while(received < total && ofGetElapsedTimeMicros() - start < 10000000){
+			for(auto & client: clients){
+				int ret;
+				while((ret = client->receiveRawBytes(buffer.data(), buffer.size())) > 0){
+					received += ret;
+				}
+			}
+		}
+		auto sendTime = ofGetElapsedTimeMicros() - start;
+		ofxTestEq(received, total, mode + " benchmark bytes received by the clients");
+
+		int numSent = numClients * numMessages;
+		ofLogNotice() << mode << " server, " << numClients << " clients: "
+			<< numSent * 1000000. / std::max<uint64_t>(receiveTime, 1) << " messages/s received, "
+			<< numSent * 1000000. / std::max<uint64_t>(sendTime, 1) << " messages/s sent to all";
+		server.close();
+	}
+
+	void testReactorBenchmark(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testReactorBenchmark";
+
+		// the threaded server checks every client on each sendToAll
+		// which takes a few ms, so it's compared with a small number
+		// of messages
+		benchmark(false, 10, 20);
+		benchmark(true, 10, 20);
+		benchmark(true, 300, 100);
+	}
+
 	void run(){
 		ofSeedRandom(ofGetSeconds());
 		testNonBlocking();
@@ -266,6 +450,8 @@ public:
 		testWrongConnect();
 		testReceiveTimeout();
 		testSendMaxSize();
+		testReactor();
+		testReactorBenchmark();
 	}
 };
 
@@ -192,11 +192,249 @@ class ofApp: public ofxUnitTestsApp{
         ofxTestEq(receivedPort, serverport, "client received from servers bound port");
     }
 
+	void testBatch(){
+		ofLogNotice() << "----------------------";
+		ofLogNotice() << "testBatch";
+
+		int port = ofRandom(15000, 65535);
+		ofxUDPManager server;
+		ofxTest(server.Create(),"create udp socket");
+		ofxTest(server.SetNonBlocking(true), "set non-blocking");
+		ofxTest(server.Bind(port), "bind udp socket");
+
+		ofxUDPManager client;
+		ofxTest(client.Create(), "create udp socket");
+		ofxTest(client.SetNonBlocking(false), "set udp socket blocking");
+		ofxTest(client.Bind(port+1), "bind udp socket");
+		ofxTest(client.Connect("127.0.0.1", port), "set ip and port to send for udp socket");
+
+		ofxUDPPacketBatch received(128, 64);
+		ofxTestEq(server.ReceiveBatch(received), 0, "batch receive without data in non blocking socket");
+		ofxTest(received.empty(), "empty batch received");
+
+		ofxUDPPacketBatch sent(100, 64);
+		for(int i = 0; i < 100; i++){
+			auto message = "packet " + ofToString(i);
+			sent.add(message.c_str(), message.size());
+		}
+		ofxTest(!sent.add("full", 4), "can't add packets to a full batch");
+		ofxTestEq(sent.size(), size_t(100), "batch size");
+		ofxTestEq(client.SendBatch(sent), 100, "client sends a batch");
+
+		std::vector<std::string> messages;
+		for(int i = 0; i < 100 && messages.size() < 100; i++){
+			auto ret = server.ReceiveBatch(received);
+			ofxTest(ret >= 0, "server receiving batch non block");
+			for(auto & packet: received){
+				messages.emplace_back(packet.data, packet.size);
+			}
+			ofSleepMillis(1);
+		}
+		ofxTestEq(messages.size(), size_t(100), "all the packets received");
+		bool inOrder = messages.size() == 100;
+		for(size_t i = 0; i < messages.size(); i++){
+			inOrder &= messages[i] == "packet " + ofToString(i);
+		}
+		ofxTest(inOrder, "packets received in order and complete");
+		ofxTestEq(received[0].getAddress(), std::string("127.0.0.1"), "packet source address");
+		ofxTestEq(received[0].getPort(), port+1, "packet source port");
+
+		std::string address;
+		int remotePort;
+		ofxTest(server.GetRemoteAddr(address, remotePort), "remote address after a batch");
+		ofxTestEq(remotePort, port+1, "remote port after a batch");
+
+		// packets to different destinations and truncation
+		ofxUDPManager other;
+		ofxTest(other.Create(), "create udp socket");
+		ofxTest(other.SetNonBlocking(false), "set udp socket blocking");
+		ofxTest(other.Bind(port+2), "bind udp socket");
+		std::string large(100, 'x');
+		sent.clear();
+		sent.add("to other", 8, "127.0.0.1", port+2);
+		sent.add("to server", 9);
+		ofxTest(!sent.add(large.c_str(), large.size()), "can't add packets larger than the maximum");
+		sent.add(large.c_str(), 64);
+		ofxTestEq(client.SendBatch(sent), 3, "client sends to several destinations");
+
+		ofxUDPPacketBatch small(4, 32);
+		ofxTestEq(other.ReceiveBatch(small), 1, "blocking batch receive returns the packets queued");
+		ofxTestEq(std::string(small[0].data, small[0].size), std::string("to other"), "packet sent to its own destination");
+		messages.clear();
+		for(int i = 0; i < 100 && messages.size() < 2; i++){
+			server.ReceiveBatch(small);
+			for(auto & packet: small){
+				messages.emplace_back(packet.data, packet.size);
+			}
+			ofSleepMillis(1);
+		}
+		ofxTestEq(messages.size(), size_t(2), "packets sent to the connected address");
+		ofxTest(messages.size() == 2 && messages[0] == "to server", "packet to the connected address");
+		ofxTest(messages.size() == 2 && messages[1] == large.substr(0, 32), "larger packets are truncated");
+	}
+
+	void testReceiver(){
+		ofLogNotice() << "----------------------";
+		ofLogNotice() << "testReceiver";
+
+		int port = ofRandom(15000, 65535);
+		ofxUDPSettings settings;
+		settings.receiveOn(port);
+		ofxUDPReceiver receiver;
+		ofxTest(receiver.setup(settings, 8, 32, 64), "setup receiver");
+
+		ofxUDPManager client;
+		ofxTest(client.Create(), "create udp socket");
+		ofxTest(client.SetNonBlocking(false), "set udp socket blocking");
+		ofxTest(client.Connect("127.0.0.1", port), "set ip and port to send for udp socket");
+
+		// sent in small bursts and read in between, so the pool of batches
+		// and the default socket buffer are enough
+		std::vector<int> received;
+		auto receive = [&](const ofxUDPPacket & packet){
+			received.push_back(ofToInt(std::string(packet.data, packet.size)));
+		};
+		ofxUDPPacketBatch batch(50, 64);
+		for(int i = 0; i < 1000; i += 50){
+			batch.clear();
+			for(int j = i; j < i + 50; j++){
+				auto message = ofToString(j);
+				batch.add(message.c_str(), message.size());
+			}
+			client.SendBatch(batch);
+			ofSleepMillis(1);
+			receiver.receive(receive);
+		}
+		for(int i = 0; i < 1000 && received.size() < 1000; i++){
+			receiver.receive(receive);
+			ofSleepMillis(1);
+		}
+		ofxTestEq(received.size(), size_t(1000), "receiver thread delivers all the packets");
+		bool inOrder = received.size() == 1000;
+		for(size_t i = 0; i < received.size(); i++){
+			inOrder &= received[i] == int(i);
+		}
+		ofxTest(inOrder, "receiver thread delivers the packets in order");
+		ofxTestEq(receiver.getNumPacketsReceived(), uint64_t(1000), "number of packets received");
+		ofxTest(receiver.receive() == nullptr, "no batches left");
+		receiver.close();
+	}
+
+	// packets per second sent and received through loopback, one at a time
+	// and in batches. UDP can drop packets when the receiver falls behind,
+	// so the rates are only reported
+	void testThroughput(){
+		ofLogNotice() << "----------------------";
+		ofLogNotice() << "testThroughput";
+
+		const int numPackets = 100000;
+		const int packetSize = 256;
+		std::vector<char> payload(packetSize, 'x');
+
+		auto rate = [](int packets, uint64_t micros){
+			return packets * 1000000. / std::max<uint64_t>(micros, 1);
+		};
+
+		// one packet at a time
+		{
+			int port = ofRandom(15000, 65535);
+			ofxUDPManager server;
+			server.Create();
+			server.SetNonBlocking(true);
+			server.SetReceiveBufferSize(4 * 1024 * 1024);
+			server.Bind(port);
+
+			ofxUDPManager client;
+			client.Create();
+			client.SetNonBlocking(false);
+			client.Connect("127.0.0.1", port);
+
+			std::atomic<bool> done{false};
+			int received = 0;
+			std::thread thread([&]{
+				std::vector<char> buffer(packetSize);
+				while(!done){
+					if(server.Receive(buffer.data(), packetSize) > 0){
+						received++;
+					}
+				}
+				while(server.Receive(buffer.data(), packetSize) > 0){
+					received++;
+				}
+			});
+			auto start = ofGetElapsedTimeMicros();
+			int sent = 0;
+			for(int i = 0; i < numPackets; i++){
+				sent += client.Send(payload.data(), packetSize) == packetSize;
+			}
+			auto sendTime = ofGetElapsedTimeMicros() - start;
+			ofSleepMillis(50);
+			done = true;
+			thread.join();
+			ofLogNotice() << "Send(): " << int(rate(sent, sendTime)) << " packets/s, " << received << " of " << sent << " received";
+			ofxTestGt(received, 0, "packets received one at a time");
+		}
+
+		// batches
+		{
+			int port = ofRandom(15000, 65535);
+			ofxUDPSettings settings;
+			settings.receiveOn(port);
+			settings.receiveBufferSize = 4 * 1024 * 1024;
+			ofxUDPReceiver receiver;
+			receiver.setup(settings, 64, 64, packetSize);
+
+			ofxUDPManager client;
+			client.Create();
+			client.SetNonBlocking(false);
+			client.Connect("127.0.0.1", port);
+
+			std::atomic<bool> done{false};
+			int received = 0;
+			std::thread thread([&]{
+				auto count = [&](const ofxUDPPacket &){
+					received++;
+				};
+				while(!done){
+					if(receiver.receive(count) == 0){
+						std::this_thread::yield();
+					}
+				}
+				receiver.receive(count);
+			});
+			ofxUDPPacketBatch batch(64, packetSize);
+			auto start = ofGetElapsedTimeMicros();
+			int sent = 0;
+			while(sent < numPackets){
+				batch.clear();
+				while(batch.size() < batch.capacity()){
+					batch.add(payload.data(), packetSize);
+				}
+				auto ret = client.SendBatch(batch);
+				if(ret <= 0){
+					break;
+				}
+				sent += ret;
+			}
+			auto sendTime = ofGetElapsedTimeMicros() - start;
+			ofSleepMillis(150);
+			done = true;
+			thread.join();
+			ofLogNotice() << "SendBatch(): " << int(rate(sent, sendTime)) << " packets/s, " << received << " of " << sent << " received"
+				<< ", " << receiver.getNumStalls() << " receiver stalls";
+			ofxTestGt(received, 0, "packets received in batches");
+			ofxTestEq(uint64_t(received), receiver.getNumPacketsReceived(), "all the packets received are delivered");
+		}
+	}
+
 	void run(){
 		testNonBlocking();
 		testBlocking();
 		testTimeOutRecv();
         testPortsStayBound();
+		testBatch();
+		testReceiver();
+		testThroughput();
 	}
 };
 
@@ -0,0 +1,550 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxCvConnectedComponents.h"
+#include "ofxCvBlobTracker.h"
+#include "ofxCvPipeline.h"
+#include "ofxCvContourFinder.h"
+#include "ofxCvGrayscaleImage.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// flood fill, 8-connected for bright pixels and 4-connected for dark
+	// ones, regions of dark pixels touching the border are labelled -1
+	int referenceLabels(const ofPixels & pixels, unsigned char threshold, bool bright, std::vector<int> & labels){
+		int w = pixels.getWidth(), h = pixels.getHeight();
+		const unsigned char * data = pixels.getData();
+		labels.assign(w * h, -1);
+		std::vector<int> visited(w * h, 0), stack, region;
+		int count = 0;
+		for(int start = 0; start < w * h; start++){
+			if(visited[start] || (data[start] > threshold) != bright) continue;
+			bool border = false;
+			region.clear();
+			stack.push_back(start);
+			visited[start] = 1;
+			while(!stack.empty()){
+				int i = stack.back();
+				stack.pop_back();
+				region.push_back(i);
+				int x = i % w, y = i / w;
+				border |= x == 0 || y == 0 || x == w - 1 || y == h - 1;
+				for(int dy = -1; dy <= 1; dy++){
+					for(int dx = -1; dx <= 1; dx++){
+						if((dx == 0 && dy == 0) || (!bright && dx != 0 && dy != 0)) continue;
+						int nx = x + dx, ny = y + dy;
+						if(nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+						int n = ny * w + nx;
+						if(!visited[n] && (data[n] > threshold) == bright){
+							visited[n] = 1;
+							stack.push_back(n);
+						}
+					}
+				}
+			}
+			if(bright || !border){
+				for(int i: region) labels[i] = count;
+				count++;
+			}
+		}
+		return count;
+	}
+
+	ofPixels randomMask(int w, int h, float density, bool gray = false){
+		ofPixels pixels;
+		pixels.allocate(w, h, OF_PIXELS_GRAY);
+		for(int i = 0; i < w * h; i++){
+			pixels.getData()[i] = gray ? ofRandom(256) : (ofRandom(1) < density ? 255 : 0);
+		}
+		return pixels;
+	}
+
+	// every pixel of a region is in the same reference region and the other
+	// way round, with the same areas
+	bool sameLabels(const ofxCvConnectedComponents & components, const std::vector<int> & reference, int referenceCount, int w, int h, bool holes){
+		std::vector<int> toReference(components.size(), -1), fromReference(referenceCount, -1);
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				int label = components.getLabel(x, y);
+				if(label >= 0 && components.isHole(label) != holes) label = -1;
+				int ref = reference[y * w + x];
+				if((label < 0) != (ref < 0)) return false;
+				if(label < 0) continue;
+				if(toReference[label] == -1) toReference[label] = ref;
+				if(fromReference[ref] == -1) fromReference[ref] = label;
+				if(toReference[label] != ref || fromReference[ref] != label) return false;
+			}
+		}
+		std::vector<int> areas(referenceCount, 0);
+		for(int ref: reference) if(ref >= 0) areas[ref]++;
+		for(int i = 0; i < referenceCount; i++){
+			if(fromReference[i] < 0 || components.getArea(fromReference[i]) != areas[i]) return false;
+		}
+		return true;
+	}
+
+	// a closed chain of 8-connected border pixels of the region
+	bool validContour(const ofxCvConnectedComponents & components, std::size_t i, const std::vector<ofDefaultVec3> & pts){
+		if(pts.empty()) return false;
+		for(std::size_t j = 0; j < pts.size(); j++){
+			int x = pts[j].x, y = pts[j].y;
+			if(components.getLabel(x, y) != int(i)) return false;
+			bool border = false;
+			for(auto d: {std::make_pair(1, 0), std::make_pair(-1, 0), std::make_pair(0, 1), std::make_pair(0, -1)}){
+				border |= components.getLabel(x + d.first, y + d.second) != int(i);
+			}
+			auto & next = pts[(j + 1) % pts.size()];
+			if(!border || fabs(next.x - x) > 1 || fabs(next.y - y) > 1) return false;
+		}
+		return true;
+	}
+
+	// one op at a time over the whole image, as the ofxCvImage methods
+	struct ReferenceOp{
+		enum Type{ ABS_DIFF, SUBTRACT, SUBTRACT_VALUE, THRESHOLD, CONVERT_TO_RANGE, BLUR, ERODE, DILATE } type;
+		float value;
+		float max;
+		bool invert;
+		int size;
+	};
+
+	static unsigned char saturate(float v, unsigned char){ return v <= 0 ? 0 : (v >= 255 ? 255 : (unsigned char)(v + 0.5f)); }
+	static float saturate(float v, float){ return v; }
+
+	template<typename T>
+	void reference(std::vector<T> & image, const std::vector<T> & source, int w, int h, const std::vector<ReferenceOp> & ops, float scaleMax){
+		std::vector<T> temp(image.size());
+		auto at = [&](int x, int y){ return image[std::min(std::max(y, 0), h - 1) * w + std::min(std::max(x, 0), w - 1)]; };
+		for(auto & op: ops){
+			for(int y = 0; y < h; y++){
+				for(int x = 0; x < w; x++){
+					T v = image[y * w + x], s = source[y * w + x];
+					float scale = (op.max - op.value) / scaleMax;
+					switch(op.type){
+						case ReferenceOp::ABS_DIFF: temp[y * w + x] = v > s ? v - s : s - v; break;
+						case ReferenceOp::SUBTRACT: temp[y * w + x] = saturate(float(v) - float(s), T()); break;
+						case ReferenceOp::SUBTRACT_VALUE: temp[y * w + x] = saturate(v * 1.0f - op.value, T()); break;
+						case ReferenceOp::THRESHOLD: temp[y * w + x] = saturate((v > op.value) != op.invert ? scaleMax : 0, T()); break;
+						case ReferenceOp::CONVERT_TO_RANGE: temp[y * w + x] = saturate(v * scale + op.value, T()); break;
+						case ReferenceOp::BLUR:{
+							double sum = 0;
+							int r = op.size / 2;
+							for(int dy = -r; dy <= r; dy++) for(int dx = -r; dx <= r; dx++) sum += at(x + dx, y + dy);
+							temp[y * w + x] = saturate(float(sum) * (1.0f / (op.size * op.size)), T());
+							break;
+						}
+						case ReferenceOp::ERODE:
+						case ReferenceOp::DILATE:{
+							T m = v;
+							for(int dy = -1; dy <= 1; dy++) for(int dx = -1; dx <= 1; dx++){
+								m = op.type == ReferenceOp::ERODE ? std::min(m, at(x + dx, y + dy)) : std::max(m, at(x + dx, y + dy));
+							}
+							temp[y * w + x] = m;
+							break;
+						}
+					}
+				}
+			}
+			std::swap(image, temp);
+		}
+	}
+
+	template<typename Pixels>
+	void addOps(ofxCvPipeline & pipeline, const std::vector<ReferenceOp> & ops, const Pixels & source){
+		for(auto & op: ops){
+			switch(op.type){
+				case ReferenceOp::ABS_DIFF: pipeline.absDiff(source); break;
+				case ReferenceOp::SUBTRACT: pipeline.subtract(source); break;
+				case ReferenceOp::SUBTRACT_VALUE: pipeline.subtract(op.value); break;
+				case ReferenceOp::THRESHOLD: pipeline.threshold(op.value, op.invert); break;
+				case ReferenceOp::CONVERT_TO_RANGE: pipeline.convertToRange(op.value, op.max); break;
+				case ReferenceOp::BLUR: pipeline.blur(op.size); break;
+				case ReferenceOp::ERODE: pipeline.erode(); break;
+				case ReferenceOp::DILATE: pipeline.dilate(); break;
+			}
+		}
+	}
+
+	std::vector<ReferenceOp> randomOps(bool bFloat){
+		std::vector<ReferenceOp> ops(ofRandom(1, 7));
+		float range = bFloat ? 1 : 255;
+		for(auto & op: ops){
+			op.type = ReferenceOp::Type(int(ofRandom(8)) % 8);
+			op.value = int(ofRandom(range * 100)) / 100.f;
+			op.max = int(ofRandom(range * 100)) / 100.f;
+			op.invert = ofRandom(1) < 0.5;
+			op.size = 1 + 2 * int(ofRandom(1, 5));
+		}
+		return ops;
+	}
+
+	void testPipeline(){
+		bool same8 = true, same32 = true, threads = true, copies = true;
+		for(int i = 0; i < 200; i++){
+			int w = ofRandom(1, 60), h = ofRandom(1, 50);
+			auto ops = randomOps(false);
+			ofPixels pixels, source;
+			pixels.allocate(w, h, OF_PIXELS_GRAY);
+			source.allocate(w, h, OF_PIXELS_GRAY);
+			for(int p = 0; p < w * h; p++){
+				pixels.getData()[p] = ofRandom(256);
+				source.getData()[p] = ofRandom(256);
+			}
+			std::vector<unsigned char> expected(pixels.getData(), pixels.getData() + w * h);
+			reference(expected, std::vector<unsigned char>(source.getData(), source.getData() + w * h), w, h, ops, 255);
+			ofxCvPipeline pipeline;
+			addOps(pipeline, ops, source);
+			pipeline.run(pixels);
+			same8 &= std::equal(expected.begin(), expected.end(), pixels.getData());
+
+			ofFloatPixels floatPixels, floatSource;
+			floatPixels.allocate(w, h, OF_PIXELS_GRAY);
+			floatSource.allocate(w, h, OF_PIXELS_GRAY);
+			for(int p = 0; p < w * h; p++){
+				floatPixels.getData()[p] = ofRandom(1);
+				floatSource.getData()[p] = ofRandom(1);
+			}
+			ops = randomOps(true);
+			std::vector<float> floatExpected(floatPixels.getData(), floatPixels.getData() + w * h);
+			reference(floatExpected, std::vector<float>(floatSource.getData(), floatSource.getData() + w * h), w, h, ops, 1);
+			ofxCvPipeline floatPipeline;
+			addOps(floatPipeline, ops, floatSource);
+			floatPipeline.run(floatPixels);
+			for(int p = 0; p < w * h; p++){
+				same32 &= fabs(floatExpected[p] - floatPixels.getData()[p]) < 1e-3;
+			}
+		}
+		ofxTest(same8, "same result as one op at a time");
+		ofxTest(same32, "same result as one op at a time on floats");
+
+		// split in bands
+		for(int i = 0; i < 10; i++){
+			int w = ofRandom(300, 700), h = ofRandom(300, 700);
+			ofPixels pixels, source;
+			pixels.allocate(w, h, OF_PIXELS_GRAY);
+			source.allocate(w, h, OF_PIXELS_GRAY);
+			for(int p = 0; p < w * h; p++){
+				pixels.getData()[p] = ofRandom(256);
+				source.getData()[p] = ofRandom(256);
+			}
+			auto original = pixels;
+			auto ops = randomOps(false);
+			ops.push_back({ReferenceOp::BLUR, 0, 0, false, 7});
+			ofxCvPipeline pipeline;
+			addOps(pipeline, ops, source);
+			pipeline.setNumThreads(1);
+			pipeline.run(pixels);
+			// the threads are kept between runs with any number of bands
+			for(int run = 0; run < 3; run++){
+				auto banded = original;
+				pipeline.setNumThreads(int(ofRandom(2, 9)));
+				pipeline.run(banded);
+				threads &= std::equal(pixels.getData(), pixels.getData() + w * h, banded.getData());
+			}
+			auto copied = pipeline;
+			auto banded = original;
+			copied.run(banded);
+			copies &= std::equal(pixels.getData(), pixels.getData() + w * h, banded.getData());
+		}
+		ofxTest(threads, "same result split in bands");
+		ofxTest(copies, "same result from a copy of the pipeline");
+
+		ofxCvPipeline pipeline;
+		ofPixels pixels, source;
+		pixels.allocate(10, 10, OF_PIXELS_GRAY);
+		source.allocate(10, 11, OF_PIXELS_GRAY);
+		ofxTest(!pipeline.absDiff(source).run(pixels), "source size mismatch");
+		ofFloatPixels floatSource;
+		floatSource.allocate(10, 10, OF_PIXELS_GRAY);
+		pipeline.clear();
+		ofxTest(!pipeline.absDiff(floatSource).run(pixels), "source type mismatch");
+	}
+
+	void testShapes(){
+		ofPixels pixels;
+		pixels.allocate(20, 20, OF_PIXELS_GRAY);
+		auto fill = [&](int x0, int y0, int x1, int y1, unsigned char value){
+			for(int y = y0; y < y1; y++) for(int x = x0; x < x1; x++) pixels.getData()[y * 20 + x] = value;
+		};
+		ofxCvConnectedComponents components;
+		std::vector<ofDefaultVec3> pts;
+
+		fill(0, 0, 20, 20, 0);
+		fill(2, 3, 7, 9, 255);
+		ofxTestEq(components.find(pixels), std::size_t(1), "rectangle found");
+		ofxTestEq(components.getArea(0), 30, "rectangle area");
+		ofxTest(components.getBoundingBox(0) == ofRectangle(2, 3, 5, 6), "rectangle bounding box");
+		ofxTest(components.getCentroid(0).x == 4 && components.getCentroid(0).y == 5.5, "rectangle centroid");
+		components.getContour(0, pts);
+		ofxTestEq(pts.size(), std::size_t(4), "approximated rectangle contour has the corners");
+		components.getContour(0, pts, false);
+		ofxTestEq(pts.size(), std::size_t(18), "rectangle contour has all the border pixels");
+		ofxTest(validContour(components, 0, pts), "rectangle contour");
+
+		fill(0, 0, 20, 20, 0);
+		fill(10, 10, 11, 11, 255);
+		components.find(pixels);
+		components.getContour(0, pts);
+		ofxTest(components.size() == 1 && pts.size() == 1 && pts[0].x == 10 && pts[0].y == 10, "single pixel");
+
+		fill(0, 0, 20, 20, 0);
+		for(int i = 0; i < 5; i++) fill(3 + i, 2 + i, 4 + i, 3 + i, 255);
+		components.find(pixels);
+		components.getContour(0, pts);
+		ofxTest(components.size() == 1 && components.getArea(0) == 5, "diagonal pixels are connected");
+		ofxTestEq(pts.size(), std::size_t(2), "approximated diagonal line contour has the ends");
+
+		fill(0, 0, 20, 20, 0);
+		fill(5, 5, 15, 15, 255);
+		fill(8, 8, 12, 12, 0);
+		fill(0, 17, 20, 20, 255);
+		fill(4, 18, 6, 19, 0);
+		ofxTestEq(components.find(pixels), std::size_t(2), "holes not labelled by default");
+		ofxTestEq(components.find(pixels, 0, true), std::size_t(4), "holes labelled");
+		int hole = components.getLabel(9, 9);
+		ofxTest(hole >= 0 && components.isHole(hole) && components.getArea(hole) == 16, "hole");
+		ofxTest(components.getLabel(4, 18) >= 0 && components.isHole(components.getLabel(4, 18)), "hole at the bottom");
+		ofxTestEq(components.getLabel(1, 1), -1, "background touching the border is not a hole");
+		ofxTestEq(components.getArea(components.getLabel(5, 5)), 84, "area doesn't include the hole");
+		components.getContour(hole, pts);
+		ofxTestEq(pts.size(), std::size_t(4), "approximated hole contour has the corners");
+		components.getContour(hole, pts, false);
+		ofxTest(validContour(components, hole, pts) && pts.size() == 12, "hole contour");
+
+		ofPixels color;
+		color.allocate(4, 4, OF_PIXELS_RGB);
+		ofxTestEq(components.find(color), std::size_t(0), "color pixels rejected");
+	}
+
+	void testRandom(){
+		ofxCvConnectedComponents components;
+		std::vector<int> reference;
+		std::vector<ofDefaultVec3> pts;
+		bool labels = true, holes = true, contours = true;
+		for(int i = 0; i < 50; i++){
+			int w = ofRandom(1, 80), h = ofRandom(1, 60);
+			unsigned char threshold = i % 3 == 0 ? 0 : (i % 3 == 1 ? 100 : 200);
+			auto pixels = randomMask(w, h, ofRandom(0.2, 0.7), threshold != 0);
+			components.find(pixels, threshold, true);
+
+			int count = referenceLabels(pixels, threshold, true, reference);
+			labels &= sameLabels(components, reference, count, w, h, false);
+			count = referenceLabels(pixels, threshold, false, reference);
+			holes &= sameLabels(components, reference, count, w, h, true);
+			for(std::size_t c = 0; c < components.size(); c++){
+				if(components.isHole(c)) continue;
+				components.getContour(c, pts, false);
+				contours &= validContour(components, c, pts);
+			}
+		}
+		ofxTest(labels, "same regions as flood fill");
+		ofxTest(holes, "same holes as flood fill");
+		ofxTest(contours, "contours of random regions");
+	}
+
+	void testBlobs(){
+		ofPixels pixels;
+		pixels.allocate(100, 100, OF_PIXELS_GRAY);
+		memset(pixels.getData(), 0, 100 * 100);
+		auto fill = [&](int x0, int y0, int size){
+			for(int y = y0; y < y0 + size; y++) for(int x = x0; x < x0 + size; x++) pixels.getData()[y * 100 + x] = 255;
+		};
+		fill(10, 10, 5);
+		fill(30, 30, 10);
+		fill(60, 60, 3);
+		fill(80, 10, 8);
+
+		ofxCvConnectedComponents components;
+		components.find(pixels);
+		std::vector<ofxCvBlob> blobs;
+		ofxTestEq(components.getBlobs(blobs, 10, 90, 10), std::size_t(2), "blobs filtered by area");
+		ofxTest(blobs[0].area == 64 && blobs[1].area == 25, "blobs sorted by area");
+		ofxTest(blobs[0].nPts == 4 && blobs[0].length == 28 && blobs[0].boundingRect == ofRectangle(80, 10, 8, 8), "blob contour");
+
+		auto pts = blobs[0].pts.data();
+		components.getBlobs(blobs, 0, 1000, 1);
+		ofxTest(blobs.size() == 1 && blobs[0].area == 100, "number of blobs limited");
+		ofxTestEq(blobs[0].pts.data(), pts, "contours reused");
+	}
+
+	void testTracker(){
+		ofxCvBlobTracker tracker;
+		tracker.setMaxDistance(10);
+		tracker.setPersistence(2);
+		std::vector<ofxCvBlob> blobs(2);
+		blobs[0].centroid = ofDefaultVec3(10, 10, 0);
+		blobs[1].centroid = ofDefaultVec3(50, 10, 0);
+		tracker.track(blobs);
+		ofxTest(blobs[0].id == 0 && blobs[1].id == 1, "new blobs get new ids");
+
+		// moved and swapped
+		std::swap(blobs[0], blobs[1]);
+		blobs[0].centroid.x += 5;
+		blobs[1].centroid.y += 5;
+		tracker.track(blobs);
+		ofxTest(blobs[0].id == 1 && blobs[1].id == 0, "blobs keep their ids");
+
+		// the second one disappears for 2 frames
+		auto lost = blobs[1];
+		blobs.resize(1);
+		tracker.track(blobs);
+		tracker.track(blobs);
+		blobs.push_back(lost);
+		tracker.track(blobs);
+		ofxTestEq(blobs[1].id, 0, "lost blob keeps its id");
+
+		// and for 3 frames
+		blobs.resize(1);
+		for(int i = 0; i < 3; i++) tracker.track(blobs);
+		blobs.push_back(lost);
+		tracker.track(blobs);
+		ofxTestEq(blobs[1].id, 2, "blob lost for too long gets a new id");
+
+		blobs[1].centroid.x += 20;
+		tracker.track(blobs);
+		ofxTest(blobs[0].id == 1 && blobs[1].id == 3, "blob moving too far gets a new id");
+
+		blobs[0].hole = true;
+		tracker.track(blobs);
+		ofxTestEq(blobs[0].id, 4, "holes and blobs tracked apart");
+	}
+
+	// a 1080p mask with moving circles, labelled and converted to blobs with
+	// contours every frame, compared with a flood fill of the same mask and
+	// with both ofxCvContourFinder::findContours() overloads
+	void benchmark(){
+		const int w = 1920, h = 1080, numFrames = 30;
+		ofPixels pixels;
+		pixels.allocate(w, h, OF_PIXELS_GRAY);
+		std::vector<ofDefaultVec3> circles;
+		for(int i = 0; i < 100; i++){
+			circles.push_back(ofDefaultVec3(ofRandom(w), ofRandom(h), ofRandom(5, 60)));
+		}
+
+		ofxCvConnectedComponents components;
+		ofxCvBlobTracker tracker;
+		std::vector<ofxCvBlob> blobs;
+		std::vector<int> reference;
+		ofxCvContourFinder finder;
+		ofxCvGrayscaleImage image;
+		image.allocate(w, h);
+		uint64_t nativeTime = 0, referenceTime = 0, pixelsFinderTime = 0, openCvFinderTime = 0;
+		bool same = true;
+		for(int frame = 0; frame < numFrames; frame++){
+			memset(pixels.getData(), 0, w * h);
+			for(auto & c: circles){
+				c.x += ofRandom(-3, 3);
+				c.y += ofRandom(-3, 3);
+				for(int y = std::max(0, int(c.y - c.z)); y < std::min(h, int(c.y + c.z)); y++){
+					for(int x = std::max(0, int(c.x - c.z)); x < std::min(w, int(c.x + c.z)); x++){
+						if((x - c.x) * (x - c.x) + (y - c.y) * (y - c.y) < c.z * c.z){
+							pixels.getData()[y * w + x] = 255;
+						}
+					}
+				}
+			}
+
+			auto start = ofGetElapsedTimeMicros();
+			components.find(pixels);
+			components.getBlobs(blobs, 0, w * h, 1000);
+			tracker.track(blobs);
+			nativeTime += ofGetElapsedTimeMicros() - start;
+
+			start = ofGetElapsedTimeMicros();
+			int count = referenceLabels(pixels, 0, true, reference);
+			referenceTime += ofGetElapsedTimeMicros() - start;
+			same &= count == int(components.size());
+
+			start = ofGetElapsedTimeMicros();
+			finder.findContours(pixels, 0, w * h, 1000, false);
+			pixelsFinderTime += ofGetElapsedTimeMicros() - start;
+
+			image.setFromPixels(pixels);
+			start = ofGetElapsedTimeMicros();
+			finder.findContours(image, 0, w * h, 1000, false);
+			openCvFinderTime += ofGetElapsedTimeMicros() - start;
+		}
+		ofLogNotice() << "1920x1080, " << blobs.size() << " blobs: "
+			<< nativeTime / 1000. / numFrames << "ms per frame labelled, with contours and tracking, "
+			<< referenceTime / 1000. / numFrames << "ms per frame with a flood fill";
+		ofLogNotice() << "ofxCvContourFinder: "
+			<< pixelsFinderTime / 1000. / numFrames << "ms per frame from ofPixels, "
+			<< openCvFinderTime / 1000. / numFrames << "ms per frame with cvFindContours";
+		ofxTest(same, "same number of blobs as flood fill");
+	}
+
+	// background subtraction, threshold and morphology on a 1080p frame,
+	// in one pass and as separate passes over the whole image, as with
+	// the ofxCvImage methods
+	void benchmarkPipeline(){
+		const int w = 1920, h = 1080, numFrames = 20;
+		ofPixels frame, background;
+		frame.allocate(w, h, OF_PIXELS_GRAY);
+		background.allocate(w, h, OF_PIXELS_GRAY);
+		for(int p = 0; p < w * h; p++){
+			background.getData()[p] = ofRandom(256);
+			frame.getData()[p] = ofRandom(256);
+		}
+		std::vector<ReferenceOp> ops = {
+			{ReferenceOp::ABS_DIFF, 0, 0, false, 0},
+			{ReferenceOp::THRESHOLD, 30, 0, false, 0},
+			{ReferenceOp::ERODE, 0, 0, false, 0},
+			{ReferenceOp::DILATE, 0, 0, false, 0},
+		};
+		std::vector<unsigned char> expected(frame.getData(), frame.getData() + w * h);
+		reference(expected, std::vector<unsigned char>(background.getData(), background.getData() + w * h), w, h, ops, 255);
+
+		std::vector<ofxCvPipeline> separate(ops.size());
+		for(std::size_t i = 0; i < ops.size(); i++){
+			addOps(separate[i], {ops[i]}, background);
+			separate[i].setNumThreads(1);
+		}
+		ofPixels result;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < numFrames; i++){
+			result = frame;
+			for(auto & pipeline: separate){
+				pipeline.run(result);
+			}
+		}
+		auto separateTime = ofGetElapsedTimeMicros() - start;
+		bool same = std::equal(expected.begin(), expected.end(), result.getData());
+
+		ofxCvPipeline pipeline;
+		addOps(pipeline, ops, background);
+		uint64_t times[2];
+		for(int threads = 0; threads < 2; threads++){
+			pipeline.setNumThreads(threads == 0 ? 1 : 0);
+			start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < numFrames; i++){
+				result = frame;
+				pipeline.run(result);
+			}
+			times[threads] = ofGetElapsedTimeMicros() - start;
+			same &= std::equal(expected.begin(), expected.end(), result.getData());
+		}
+		ofLogNotice() << "1920x1080 absDiff, threshold, erode and dilate: "
+			<< times[0] / 1000. / numFrames << "ms per frame in one pass, "
+			<< times[1] / 1000. / numFrames << "ms with all the cores, "
+			<< separateTime / 1000. / numFrames << "ms in separate passes";
+		ofxTest(same, "benchmark result");
+	}
+
+	void run(){
+		testShapes();
+		testRandom();
+		testBlobs();
+		testTracker();
+		testPipeline();
+		benchmark();
+		benchmarkPipeline();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
@@ -0,0 +1,484 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxOsc.h"
+#include "OscOutboundPacketStream.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void addArgs(ofxOscFlatMessage & message){
+		message.setAddress("/test/args");
+		message.addInt32Arg(-42);
+		message.addInt64Arg(1ll << 40);
+		message.addFloatArg(0.5f);
+		message.addDoubleArg(0.25);
+		message.addStringArg("hello");
+		message.addSymbolArg("sym");
+		message.addCharArg('c');
+		message.addMidiMessageArg(0x90407f00);
+		message.addBoolArg(true);
+		message.addBoolArg(false);
+		message.addNoneArg();
+		message.addTriggerArg();
+		message.addTimetagArg(123456789012ull);
+		message.addBlobArg("blob", 4);
+		message.addRgbaColorArg(0xff8000ff);
+	}
+
+	bool checkArgs(const ofxOscFlatMessage & message){
+		return message.isAddress("/test/args") &&
+			message.getTypeString().compare(0, 15, "ihfdsScmTFNItbr") == 0 &&
+			message.getArgAsInt32(0) == -42 &&
+			message.getArgAsInt64(1) == (1ll << 40) &&
+			message.getArgAsFloat(2) == 0.5f &&
+			message.getArgAsDouble(3) == 0.25 &&
+			std::string(message.getArgAsCString(4)) == "hello" &&
+			message.getArgAsStringSize(4) == 5 &&
+			message.getArgAsString(5) == "sym" &&
+			message.getArgAsChar(6) == 'c' &&
+			message.getArgAsMidiMessage(7) == 0x90407f00 &&
+			message.getArgAsBool(8) && !message.getArgAsBool(9) &&
+			message.getArgAsTimetag(12) == 123456789012ull &&
+			message.getArgAsBlobSize(13) == 4 &&
+			std::string(message.getArgAsBlobData(13), 4) == "blob" &&
+			message.getArgAsRgbaColor(14) == 0xff8000ff;
+	}
+
+	void testFlatMessage(){
+		ofxOscFlatMessage message;
+		addArgs(message);
+		ofxTest(checkArgs(message), "flat message arguments");
+		ofxTestEq(message.getArgAsFloat(0), -42.f, "numeric arguments are converted");
+
+		// same bytes as oscpack
+		char expected[1024];
+		osc::OutboundPacketStream p(expected, sizeof(expected));
+		p << osc::BeginMessage("/test/args") << -42 << (osc::int64)(1ll << 40) << 0.5f << 0.25
+		  << "hello" << osc::Symbol("sym") << 'c' << osc::MidiMessage(0x90407f00) << true << false
+		  << osc::NilType() << osc::InfinitumType() << osc::TimeTag(123456789012ull)
+		  << osc::Blob("blob", 4) << osc::RgbaColor(0xff8000ff) << osc::EndMessage;
+
+		std::vector<char> buffer(message.getSerializedSize());
+		ofxTestEq(buffer.size(), size_t(p.Size()), "serialized size");
+		ofxTestEq(message.serialize(buffer.data(), buffer.size() - 1), size_t(0), "serialize fails if the buffer is too small");
+		ofxTestEq(message.serialize(buffer.data(), buffer.size()), buffer.size(), "serialize");
+		ofxTest(memcmp(buffer.data(), p.Data(), p.Size()) == 0, "serialized like oscpack");
+
+		ofxOscFlatMessage parsed;
+		ofxTest(parsed.parse(p.Data(), p.Size()), "parse");
+		ofxTest(checkArgs(parsed), "parsed arguments");
+		ofxTest(parsed.getArgAsCString(4) >= p.Data() && parsed.getArgAsCString(4) < p.Data() + p.Size(), "parsed strings point into the data");
+
+		auto copy = parsed;
+		copy.addStringArg("more");
+		ofxTest(checkArgs(copy), "arguments kept when a parsed message is modified");
+		ofxTestEq(copy.getArgAsString(15), std::string("more"), "argument added to a parsed message");
+		ofxTestEq(parsed.getNumArgs(), size_t(15), "original not modified");
+
+		ofxOscMessage legacy;
+		parsed.toMessage(legacy);
+		ofxTestEq(legacy.getArgAsString(4), std::string("hello"), "converted to ofxOscMessage");
+		ofxOscFlatMessage converted;
+		converted.fromMessage(legacy);
+		ofxTest(checkArgs(converted), "converted from ofxOscMessage");
+
+		ofxTest(!parsed.parse(p.Data(), p.Size() - 4), "truncated message rejected");
+		ofxTest(!parsed.parse("abc", 3), "data not aligned rejected");
+		ofxTest(!parsed.parse("nope", 4), "address without / rejected");
+		ofxTestEq(parsed.getNumArgs(), size_t(0), "failed parse leaves the message empty");
+	}
+
+	void testFlatBundle(){
+		char data[1024];
+		osc::OutboundPacketStream p(data, sizeof(data));
+		p << osc::BeginBundle(1234)
+		  << osc::BeginMessage("/a") << 1 << osc::EndMessage
+		  << osc::BeginBundleImmediate
+		  << osc::BeginMessage("/b") << "two" << osc::EndMessage
+		  << osc::BeginMessage("/c") << 3.f << osc::EndMessage
+		  << osc::EndBundle
+		  << osc::EndBundle;
+
+		ofxOscFlatBundle bundle;
+		ofxTest(bundle.parse(p.Data(), p.Size()), "parse bundle");
+		ofxTestEq(bundle.getMessageCount(), size_t(3), "nested bundles flattened");
+		ofxTestEq(bundle.getTimetag(), uint64_t(1234), "bundle time tag");
+		ofxTest(bundle.getMessageCount() == 3 &&
+			bundle.getMessageAt(0).isAddress("/a") && bundle.getMessageAt(0).getArgAsInt(0) == 1 &&
+			bundle.getMessageAt(1).isAddress("/b") && bundle.getMessageAt(1).getArgAsString(0) == "two" &&
+			bundle.getMessageAt(2).isAddress("/c") && bundle.getMessageAt(2).getArgAsFloat(0) == 3.f, "bundle messages");
+
+		ofxOscFlatBundle copied;
+		copied.parse(p.Data(), p.Size(), true);
+		auto copy = copied;
+		copied.clear();
+		ofxTest(copy.getMessageCount() == 3 && copy.getMessageAt(1).getArgAsString(0) == "two", "copy of a copied bundle");
+
+		std::vector<char> buffer(bundle.getSerializedSize());
+		ofxTestEq(bundle.serialize(buffer.data(), buffer.size()), buffer.size(), "serialize bundle");
+		ofxOscFlatBundle reparsed;
+		ofxTest(reparsed.parse(buffer.data(), buffer.size()), "parse serialized bundle");
+		ofxTest(reparsed.getMessageCount() == 3 && reparsed.getMessageAt(2).getArgAsFloat(0) == 3.f, "serialized bundle messages");
+
+		ofxTest(!bundle.parse(p.Data(), p.Size() - 4), "truncated bundle rejected");
+		ofxTestEq(bundle.getMessageCount(), size_t(0), "failed parse leaves the bundle empty");
+
+		ofxTest(bundle.parse(data + 20, 12), "parse a single message");
+		ofxTestEq(bundle.getMessageCount(), size_t(1), "single message in a bundle");
+	}
+
+	// flat and legacy messages sent between both kinds of receivers
+	void testSendReceive(){
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiverSettings flatSettings;
+		flatSettings.port = port;
+		flatSettings.flat = true;
+		ofxOscReceiver flatReceiver;
+		ofxTest(flatReceiver.setup(flatSettings), "setup flat receiver");
+		ofxOscReceiver legacyReceiver;
+		ofxTest(legacyReceiver.setup(port + 1), "setup receiver");
+
+		ofxOscSender toFlat, toLegacy;
+		ofxTest(toFlat.setup("localhost", port), "setup sender");
+		ofxTest(toLegacy.setup("localhost", port + 1), "setup sender");
+
+		ofxOscFlatMessage flat;
+		addArgs(flat);
+		ofxOscMessage legacy;
+		flat.toMessage(legacy);
+
+		toFlat.sendMessage(legacy);
+		toFlat.sendMessage(flat, false);
+		toLegacy.sendMessage(flat);
+
+		ofxOscFlatBundle bundle;
+		std::vector<bool> received;
+		for(int i = 0; i < 100 && received.size() < 2; i++){
+			while(flatReceiver.getNextBundle(bundle)){
+				received.push_back(bundle.getMessageCount() == 1 && checkArgs(bundle.getMessageAt(0)));
+			}
+			ofSleepMillis(10);
+		}
+		ofxTest(received.size() == 2 && received[0] && received[1], "flat receiver gets legacy and flat messages");
+		ofxTestEq(bundle.getRemoteHost(), std::string("127.0.0.1"), "remote host");
+
+		ofxOscMessage message;
+		bool receivedLegacy = false;
+		for(int i = 0; i < 100 && !receivedLegacy; i++){
+			receivedLegacy = legacyReceiver.getNextMessage(message);
+			ofSleepMillis(10);
+		}
+		ofxOscFlatMessage converted;
+		converted.fromMessage(message);
+		ofxTest(receivedLegacy && checkArgs(converted), "receiver gets flat messages");
+		ofxTestEq(flatReceiver.getNumDroppedPackets(), uint64_t(0), "no packets dropped");
+	}
+
+	// packets queued in flat mode aren't messages, so the usual loop over
+	// hasWaitingMessages() still ends, and restarting the receiver reuses
+	// the queue once the old listener thread has exited
+	void testFlatRestart(){
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiverSettings settings;
+		settings.port = port;
+		settings.flat = true;
+		ofxOscReceiver receiver;
+		ofxTest(receiver.setup(settings), "setup flat receiver");
+		ofxOscSender sender;
+		ofxTest(sender.setup("localhost", port), "setup sender");
+
+		ofxOscMessage message;
+		message.setAddress("/restart");
+		message.addIntArg(1);
+		sender.sendMessage(message, false);
+		for(int i = 0; i < 100 && !receiver.hasWaitingBundles(); i++){
+			ofSleepMillis(10);
+		}
+		ofxTest(receiver.hasWaitingBundles(), "packets wait for getNextBundle()");
+		ofxTest(!receiver.hasWaitingMessages(), "packets aren't waiting messages");
+		int loops = 0;
+		while(receiver.hasWaitingMessages() && loops < 10){
+			receiver.getNextMessage(message);
+			loops++;
+		}
+		ofxTestEq(loops, 0, "hasWaitingMessages() loop ends in flat mode");
+
+		ofxOscFlatBundle bundle;
+		for(int restart = 0; restart < 10; restart++){
+			receiver.stop();
+			settings.flatQueueSize *= 2;
+			receiver.setup(settings);
+		}
+		ofxTest(receiver.isListening(), "receiver restarted");
+		while(receiver.getNextBundle(bundle));
+		sender.sendMessage(message, false);
+		bool received = false;
+		for(int i = 0; i < 100 && !received; i++){
+			received = receiver.getNextBundle(bundle);
+			ofSleepMillis(10);
+		}
+		ofxTest(received && bundle.getMessageCount() == 1, "restarted receiver gets packets");
+		ofxTest(!receiver.hasWaitingBundles(), "no packets left after getNextBundle()");
+	}
+
+	void testRouter(){
+		ofxTest(ofxOscRouter::match("/a/b", "/a/b"), "literal pattern");
+		ofxTest(!ofxOscRouter::match("/a/b", "/a/c"), "literal pattern mismatch");
+		ofxTest(!ofxOscRouter::match("/a", "/a/b"), "pattern with less parts");
+		ofxTest(ofxOscRouter::match("/a/?x", "/a/bx"), "? wildcard");
+		ofxTest(ofxOscRouter::match("/*/b*c", "/a/bxyc") && ofxOscRouter::match("/a/*", "/a/"), "* wildcard");
+		ofxTest(!ofxOscRouter::match("/*", "/a/b"), "* doesn't match /");
+		ofxTest(ofxOscRouter::match("/[abc]/[a-z]", "/b/q") && !ofxOscRouter::match("/[abc]", "/d"), "[] wildcard");
+		ofxTest(ofxOscRouter::match("/[!abc]", "/d") && !ofxOscRouter::match("/[!a-c]", "/b"), "[!] wildcard");
+		ofxTest(ofxOscRouter::match("/{foo,bar}/x", "/bar/x") && !ofxOscRouter::match("/{foo,bar}", "/baz"), "{} wildcard");
+		ofxTest(ofxOscRouter::match("/{a,ab}c", "/abc"), "{} wildcard backtracking");
+
+		ofxOscRouter router;
+		std::vector<std::string> called;
+		auto record = [&](const std::string &name){
+			return [&called, name](const ofxOscMessage &){ called.push_back(name); };
+		};
+		router.add("/synth/lead/volume", record("lead"));
+		router.add("/synth/*/volume", record("any"));
+		router.add("/synth/{lead,bass}/*", record("leadOrBass"));
+		auto id = router.add("/synth/lead/volume", record("second"));
+		router.add("/drums/[0-9]", record("drum"));
+		ofxTestEq(router.add("synth", record("invalid")), std::size_t(0), "pattern without / rejected");
+		ofxTestEq(router.size(), std::size_t(5), "number of routes");
+
+		ofxOscMessage message;
+		message.setAddress("/synth/lead/volume");
+		ofxTest(router.dispatch(message), "dispatch");
+		std::sort(called.begin(), called.end());
+		ofxTest(called == std::vector<std::string>({"any", "lead", "leadOrBass", "second"}), "all matching routes called");
+
+		called.clear();
+		ofxTest(router.remove(id) && !router.remove(id), "remove route");
+		router.dispatch(message);
+		ofxTestEq(called.size(), size_t(3), "removed route not called");
+
+		called.clear();
+		message.setAddress("/synth/pad/volume");
+		router.dispatch(message);
+		message.setAddress("/drums/7");
+		router.dispatch(message);
+		message.setAddress("/drums/x");
+		ofxTest(!router.dispatch(message), "no matching route");
+		message.setAddress("/synth/lead");
+		ofxTest(!router.dispatch(message), "address with less parts");
+		ofxTest(called == std::vector<std::string>({"any", "drum"}), "wildcard routes");
+
+		int flatCalls = 0;
+		router.add("/flat", [&](const ofxOscFlatMessage &m){ flatCalls += m.getArgAsInt(0); });
+		ofxOscFlatMessage flat("/flat");
+		flat.addIntArg(3);
+		message.setAddress("/flat");
+		ofxTest(router.dispatch(flat) && !router.dispatch(message), "handlers called for their message type");
+		ofxTestEq(flatCalls, 3, "flat handler");
+
+		router.clear();
+		ofxTest(router.empty() && !router.dispatch(flat), "clear routes");
+	}
+
+	void testReceiverRoutes(bool flat){
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiverSettings settings;
+		settings.port = port;
+		settings.flat = flat;
+		ofxOscReceiver receiver;
+		receiver.setup(settings);
+		ofxOscSender sender;
+		sender.setup("localhost", port);
+
+		std::atomic<int> threaded{0};
+		int main = 0;
+		if(flat){
+			receiver.addRoute("/threaded/*", [&](const ofxOscFlatMessage &m){ threaded += m.getArgAsInt(0); }, true);
+			receiver.addRoute("/main/*", [&](const ofxOscFlatMessage &m){ main += m.getArgAsInt(0); });
+		}else{
+			receiver.addRoute("/threaded/*", [&](const ofxOscMessage &m){ threaded += m.getArgAsInt(0); }, true);
+			receiver.addRoute("/main/*", [&](const ofxOscMessage &m){ main += m.getArgAsInt(0); });
+		}
+
+		ofxOscMessage message;
+		message.setAddress("/threaded/a");
+		message.addIntArg(1);
+		sender.sendMessage(message, false);
+		message.setAddress("/main/a");
+		sender.sendMessage(message, false);
+		message.setAddress("/other");
+		sender.sendMessage(message, false);
+
+		for(int i = 0; i < 100 && threaded == 0; i++){
+			ofSleepMillis(10);
+		}
+		ofxTestEq(threaded.load(), 1, std::string(flat ? "flat " : "") + "threaded route called from the receive thread");
+		ofxTestEq(main, 0, "main thread route not called before dispatching");
+
+		std::size_t dispatched = 0;
+		for(int i = 0; i < 100 && main == 0; i++){
+			dispatched += receiver.dispatchMessages();
+			ofSleepMillis(10);
+		}
+		dispatched += receiver.dispatchMessages();
+		ofxTestEq(main, 1, "main thread route called when dispatching");
+		ofxTestEq(dispatched, std::size_t(1), "unrouted messages discarded");
+	}
+
+	// messages per second sent and received through loopback, the sender
+	// sends a burst and waits for the receiver before sending the next one
+	// so the socket buffer doesn't overflow
+	void benchmark(bool flat){
+		const int numMessages = 50000;
+		const int burst = 100;
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiverSettings settings;
+		settings.port = port;
+		settings.flat = flat;
+		ofxOscReceiver receiver;
+		receiver.setup(settings);
+		ofxOscSender sender;
+		sender.setup("localhost", port);
+
+		ofxOscMessage message;
+		ofxOscFlatMessage flatMessage;
+		ofxOscFlatBundle bundle;
+		int received = 0;
+		float sum = 0;
+		uint64_t sendTime = 0;
+		auto start = ofGetElapsedTimeMicros();
+		for(int sent = 0; sent < numMessages; sent += burst){
+			auto sendStart = ofGetElapsedTimeMicros();
+			for(int i = sent; i < sent + burst; i++){
+				if(flat){
+					flatMessage.clear();
+					flatMessage.setAddress("/benchmark/value");
+					flatMessage.addIntArg(i);
+					flatMessage.addFloatArg(i * 0.5f);
+					flatMessage.addStringArg("benchmark");
+					sender.sendMessage(flatMessage, false);
+				}else{
+					message.clear();
+					message.setAddress("/benchmark/value");
+					message.addIntArg(i);
+					message.addFloatArg(i * 0.5f);
+					message.addStringArg("benchmark");
+					sender.sendMessage(message, false);
+				}
+			}
+			sendTime += ofGetElapsedTimeMicros() - sendStart;
+
+			auto waitStart = ofGetElapsedTimeMillis();
+			while(received < sent + burst && ofGetElapsedTimeMillis() - waitStart < 100){
+				if(flat){
+					while(receiver.getNextBundle(bundle)){
+						for(size_t m = 0; m < bundle.getMessageCount(); m++){
+							sum += bundle.getMessageAt(m).getArgAsFloat(1);
+							received++;
+						}
+					}
+				}else{
+					while(receiver.getNextMessage(message)){
+						sum += message.getArgAsFloat(1);
+						received++;
+					}
+				}
+				std::this_thread::yield();
+			}
+		}
+		auto totalTime = ofGetElapsedTimeMicros() - start;
+
+		ofLogNotice() << (flat ? "ofxOscFlatMessage: " : "ofxOscMessage: ")
+			<< int(numMessages * 1000000. / std::max<uint64_t>(sendTime, 1)) << " messages/s sent, "
+			<< int(received * 1000000. / std::max<uint64_t>(totalTime, 1)) << " messages/s sent and received, "
+			<< received << " of " << numMessages << " received";
+		ofxTestGt(received, 0, std::string(flat ? "flat" : "legacy") + " messages received");
+	}
+
+	// serializing and parsing in memory, without the network
+	void benchmarkSerialization(){
+		const int numMessages = 1000000;
+		ofxOscFlatMessage message, parsed;
+		std::vector<char> buffer(256);
+		int64_t sum = 0;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < numMessages; i++){
+			message.clear();
+			message.setAddress("/benchmark/value");
+			message.addIntArg(i);
+			message.addFloatArg(i * 0.5f);
+			message.addStringArg("benchmark");
+			auto size = message.serialize(buffer.data(), buffer.size());
+			parsed.parse(buffer.data(), size);
+			sum += parsed.getArgAsInt(0);
+		}
+		auto time = ofGetElapsedTimeMicros() - start;
+		ofLogNotice() << "ofxOscFlatMessage: " << int(numMessages * 1000000. / std::max<uint64_t>(time, 1))
+			<< " messages/s serialized and parsed";
+		ofxTestEq(sum, int64_t(numMessages) * (numMessages - 1) / 2, "all messages parsed");
+	}
+
+	// routing messages to one of many addresses, compared with comparing
+	// the address with each of them
+	void benchmarkRouter(){
+		const int numAddresses = 2000;
+		const int numMessages = 200000;
+		std::vector<std::string> addresses;
+		ofxOscRouter router;
+		int64_t routed = 0;
+		for(int i = 0; i < numAddresses; i++){
+			addresses.push_back("/group" + ofToString(i % 20) + "/parameter" + ofToString(i));
+			router.add(addresses.back(), [&routed, i](const ofxOscMessage &){ routed += i; });
+		}
+		std::vector<ofxOscMessage> messages(100);
+		for(size_t i = 0; i < messages.size(); i++){
+			messages[i].setAddress(addresses[(i * 7919) % numAddresses]);
+		}
+
+		int64_t compared = 0;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < numMessages; i++){
+			auto &message = messages[i % messages.size()];
+			for(int a = 0; a < numAddresses; a++){
+				if(message.getAddress() == addresses[a]){
+					compared += a;
+					break;
+				}
+			}
+		}
+		auto compareTime = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < numMessages; i++){
+			router.dispatch(messages[i % messages.size()]);
+		}
+		auto routeTime = ofGetElapsedTimeMicros() - start;
+
+		ofLogNotice() << numAddresses << " addresses: "
+			<< int(numMessages * 1000000. / std::max<uint64_t>(compareTime, 1)) << " messages/s compared, "
+			<< int(numMessages * 1000000. / std::max<uint64_t>(routeTime, 1)) << " messages/s routed";
+		ofxTestEq(routed, compared, "router calls the same handlers");
+	}
+
+	void run(){
+		testFlatMessage();
+		testFlatBundle();
+		testSendReceive();
+		testFlatRestart();
+		testRouter();
+		testReceiverRoutes(false);
+		testReceiverRoutes(true);
+		benchmark(false);
+		benchmark(true);
+		benchmarkSerialization();
+		benchmarkRouter();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
@@ -177,6 +177,109 @@ class ofApp: public ofxUnitTestsApp{
 
 			});
 		}
+
+		{
+			ofEvent<const int> e;
+			int calls = 0;
+			ofEventListeners listeners;
+			listeners.push(e.newListener([&](const int &){
+				calls++;
+				listeners.push(e.newListener([&](const int &){
+					calls++;
+				}));
+			}));
+			e.notify(0);
+			ofxTestEq(calls, 1, "Listeners added during a notification are called from the next one");
+			ofxTestEq(e.size(), size_t(2), "Listener added during a notification");
+			listeners.unsubscribeAll();
+			ofxTestEq(e.size(), size_t(0), "Listeners removed");
+		}
+
+		{
+			ofEvent<int> e;
+			std::atomic<bool> done{false};
+			std::atomic<int> calls{0};
+			std::thread notifier([&]{
+				int value = 0;
+				while(!done){
+					e.notify(value);
+				}
+			});
+			for(int i = 0; i < 1000; i++){
+				auto listener = e.newListener([&](int &){
+					calls++;
+				});
+			}
+			done = true;
+			notifier.join();
+			ofxTestEq(e.size(), size_t(0), "Adding and removing listeners while notifying from another thread");
+		}
+
+		{
+			ofEventQueue queue;
+			ofEvent<int> e;
+			ofEvent<void> voidE;
+			vector<int> received;
+			int latest = 0;
+			int latestCalls = 0;
+			int voidCalls = 0;
+			std::thread::id listenerThread;
+			auto listener = queue.newListener(e, [&](int & value){
+				received.push_back(value);
+				listenerThread = std::this_thread::get_id();
+			});
+			auto latestListener = queue.newListener(e, [&](const int & value){
+				latest = value;
+				latestCalls++;
+			}, OF_EVENT_QUEUE_LATEST);
+			auto voidListener = queue.newListener(voidE, [&]{
+				voidCalls++;
+			}, OF_EVENT_QUEUE_LATEST);
+
+			std::thread notifier([&]{
+				for(int i = 0; i < 100; i++){
+					e.notify(i);
+					voidE.notify();
+				}
+			});
+			notifier.join();
+			ofxTest(received.empty(), "Queued listeners are not called when the event is notified");
+			queue.process();
+			ofxTestEq(received.size(), size_t(100), "Queued listener receives every notification");
+			ofxTest(received.back() == 99, "Queued notifications are delivered in order");
+			ofxTest(listenerThread == std::this_thread::get_id(), "Queued listener is called in the thread that processes the queue");
+			ofxTestEq(latestCalls, 1, "Latest only listener is called once");
+			ofxTestEq(latest, 99, "Latest only listener receives the last value");
+			ofxTestEq(voidCalls, 1, "Latest only void listener is called once");
+
+			int value = 100;
+			e.notify(value);
+			listener.reset();
+			queue.process();
+			ofxTestEq(received.size(), size_t(100), "Unsubscribed queued listener is not called for pending notifications");
+			ofxTestEq(latest, 100, "Latest only listener receives the next value");
+		}
+
+		// notification cost against the number of listeners
+		for(int numListeners: {0, 1, 10, 100, 1000}){
+			ofEvent<int> e;
+			ofEventListeners listeners;
+			int sum = 0;
+			for(int i = 0; i < numListeners; i++){
+				listeners.push(e.newListener([&](int & value){
+					sum += value;
+				}));
+			}
+			int value = 1;
+			int iterations = 1000000 / (numListeners + 1);
+			auto start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < iterations; i++){
+				e.notify(value);
+			}
+			auto time = ofGetElapsedTimeMicros() - start;
+			ofxTestEq(sum, numListeners * iterations, "All listeners notified with " + ofToString(numListeners) + " listeners");
+			ofLogNotice() << numListeners << " listeners, " << time * 1000.0 / iterations << "ns per notify";
+		}
 	}
 };
 
@@ -0,0 +1,194 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+
+	float area(const vector<ofPolyline> & polylines){
+		float area = 0;
+		for(auto & polyline: polylines){
+			area += polyline.getArea();
+		}
+		return area;
+	}
+
+	ofPolyline rect(float x, float y, float w, float h){
+		return ofPolyline::fromRectangle(ofRectangle(x, y, w, h));
+	}
+
+	ofPolyline star(const glm::vec2 & center, int numPoints, float radius, float variation){
+		ofPolyline star;
+		for(int i = 0; i < numPoints; i++){
+			float angle = TWO_PI * i / numPoints;
+			float r = radius + variation * sin(angle * 37.f);
+			star.addVertex(center.x + r * cos(angle), center.y + r * sin(angle));
+		}
+		star.close();
+		return star;
+	}
+
+	void testBooleans(){
+		auto a = rect(0, 0, 200, 200);
+		auto b = rect(100, 100, 200, 200);
+		ofxTestEq(area(ofPolylinesClip({a}, {b}, OF_POLY_CLIP_UNION)), 70000.f, "union area");
+		ofxTestEq(area(ofPolylinesClip({a}, {b}, OF_POLY_CLIP_INTERSECTION)), 10000.f, "intersection area");
+		ofxTestEq(area(ofPolylinesClip({a}, {b}, OF_POLY_CLIP_DIFFERENCE)), 30000.f, "difference area");
+		ofxTestEq(area(ofPolylinesClip({a}, {b}, OF_POLY_CLIP_XOR)), 60000.f, "xor area");
+		ofxTestEq(ofPolylinesClip({a}, {b}, OF_POLY_CLIP_UNION)[0].size(), size_t(8), "union removes inner vertices");
+
+		ofxTestEq(ofPolylinesClip({rect(0, 0, 10, 10)}, {rect(10, 0, 10, 10)}, OF_POLY_CLIP_UNION).size(), size_t(1), "union of adjacent rectangles is a single contour");
+		ofxTestEq(ofPolylinesClip({rect(0, 0, 10, 10)}, {rect(10, 10, 10, 10)}, OF_POLY_CLIP_UNION).size(), size_t(2), "rectangles touching at a corner stay separated");
+		ofxTest(ofPolylinesClip({a}, {a}, OF_POLY_CLIP_XOR).empty(), "xor with itself is empty");
+
+		auto withHole = ofPolylinesClip({rect(0, 0, 100, 100)}, {rect(20, 20, 30, 30)}, OF_POLY_CLIP_DIFFERENCE);
+		ofxTestEq(withHole.size(), size_t(2), "difference inside creates a hole");
+		ofxTestEq(area(withHole), 9100.f, "area with hole");
+
+		// a self intersecting bow tie, odd and nonzero fill the same area
+		// but positive only fills the half that goes counter clockwise
+		ofPolyline bowTie;
+		bowTie.addVertex(0, 0);
+		bowTie.addVertex(100, 100);
+		bowTie.addVertex(100, 0);
+		bowTie.addVertex(0, 100);
+		bowTie.close();
+		ofxTestEq(area(ofPolylinesSimplify({bowTie}, OF_POLY_WINDING_ODD)), 5000.f, "bow tie odd");
+		ofxTestEq(area(ofPolylinesSimplify({bowTie}, OF_POLY_WINDING_POSITIVE)), 2500.f, "bow tie positive");
+	}
+
+	void testPath(){
+		ofPath path;
+		path.rectangle(0, 0, 200, 200);
+		ofPath hole;
+		hole.rectangle(50, 50, 100, 100);
+		path.difference(hole);
+		ofxTestEq(path.getWindingMode(), OF_POLY_WINDING_ODD, "boolean operations set the winding mode to odd");
+		ofxTestEq(area(path.getOutline()), 30000.f, "path difference");
+
+		path.unionWith(hole);
+		ofxTestEq(area(path.getOutline()), 40000.f, "path union");
+		ofxTestEq(path.getOutline().size(), size_t(1), "path union fills the hole");
+
+		ofPath other;
+		other.rectangle(100, 0, 200, 200);
+		path.intersect(other);
+		ofxTestEq(area(path.getOutline()), 20000.f, "path intersection");
+
+		path.xorWith(other);
+		ofxTestEq(area(path.getOutline()), 20000.f, "path xor");
+
+		ofPath polylinesPath;
+		polylinesPath.setMode(ofPath::POLYLINES);
+		polylinesPath.rectangle(0, 0, 100, 100);
+		polylinesPath.offset(10);
+		ofxTestEq(area(polylinesPath.getOutline()), 14400.f, "path offset in polylines mode");
+	}
+
+	void testOffset(){
+		auto square = rect(0, 0, 100, 100);
+		ofxTestEq(area(ofPolylineOffset(square, 10, OF_POLY_JOIN_MITER)), 14400.f, "miter offset");
+		ofxTestEq(area(ofPolylineOffset(square, 10, OF_POLY_JOIN_BEVEL)), 14200.f, "bevel offset");
+		ofxTestEq(area(ofPolylineOffset(square, -10)), 6400.f, "negative offset");
+		ofxTest(ofPolylineOffset(square, -60).empty(), "shrinking more than the size removes the polygon");
+		ofxTest(abs(area(ofPolylineOffset(square, 10, OF_POLY_JOIN_ROUND)) - (14000.f + PI * 100.f)) < 15.f, "round offset");
+
+		// shrinking a U splits it in two
+		ofPolyline u;
+		u.addVertex(0, 0);
+		u.addVertex(100, 0);
+		u.addVertex(100, 100);
+		u.addVertex(70, 100);
+		u.addVertex(70, 20);
+		u.addVertex(30, 20);
+		u.addVertex(30, 100);
+		u.addVertex(0, 100);
+		u.close();
+		ofxTestEq(ofPolylineOffset(u, -12).size(), size_t(2), "negative offset splits");
+
+		ofPolyline line;
+		line.addVertex(0, 0);
+		line.addVertex(100, 0);
+		ofxTestEq(area(ofPolylineOffset(line, 5, OF_POLY_JOIN_BEVEL)), 1000.f, "open polyline with butt caps");
+		ofxTestEq(area(ofPolylineOffset(line, 5, OF_POLY_JOIN_SQUARE)), 1100.f, "open polyline with square caps");
+	}
+
+	// every scanbeam of a comb crosses all of its teeth
+	void testManyActiveEdges(){
+		int numTeeth = 4000;
+		ofPolyline comb;
+		comb.addVertex(0, -10);
+		comb.addVertex(numTeeth * 2, -10);
+		for(int i = numTeeth - 1; i >= 0; i--){
+			float top = 1000 + i * 0.37f;
+			comb.addVertex(i * 2 + 1.5f, 0);
+			comb.addVertex(i * 2 + 1.5f, top);
+			comb.addVertex(i * 2 + 0.5f, top);
+			comb.addVertex(i * 2 + 0.5f, 0);
+		}
+		comb.close();
+		auto bar = rect(-5, 500, numTeeth * 2 + 10, 10);
+
+		auto start = ofGetElapsedTimeMicros();
+		auto joined = ofPolylinesClip({comb}, {bar}, OF_POLY_CLIP_UNION);
+		auto time = ofGetElapsedTimeMicros() - start;
+		ofxTestEq(joined.size(), size_t(numTeeth), "comb union has an outer contour and a hole between every two teeth");
+		float expected = comb.getArea() + bar.getArea() - numTeeth * 10.f;
+		ofxTest(abs(area(joined) - expected) < expected * 1e-4f, "comb union area");
+		ofLogNotice() << "comb with " << numTeeth << " teeth union: " << time << "us";
+	}
+
+	// compares against the tessellator for the operations it can do with
+	// winding modes, union and the intersection of two simple polygons
+	void testTessellatorRoute(){
+		ofTessellator tessellator;
+		for(int numPoints: {1000, 10000, 100000}){
+			auto a = star({0, 0}, numPoints, 100, 10);
+			auto b = star({40, 0}, numPoints, 100, 10);
+
+			vector<ofPolyline> tessellated;
+			auto start = ofGetElapsedTimeMicros();
+			tessellator.tessellateToPolylines({a, b}, OF_POLY_WINDING_NONZERO, tessellated, true);
+			auto tessellatorUnion = ofGetElapsedTimeMicros() - start;
+			auto tessellatedUnionArea = abs(area(tessellated));
+
+			start = ofGetElapsedTimeMicros();
+			auto clipped = ofPolylinesClip({a}, {b}, OF_POLY_CLIP_UNION);
+			auto clipperUnion = ofGetElapsedTimeMicros() - start;
+			ofxTest(abs(area(clipped) - tessellatedUnionArea) < tessellatedUnionArea * 1e-4f, "union matches tessellator with " + ofToString(numPoints) + " points");
+
+			start = ofGetElapsedTimeMicros();
+			tessellator.tessellateToPolylines({a, b}, OF_POLY_WINDING_ABS_GEQ_TWO, tessellated, true);
+			auto tessellatorIntersection = ofGetElapsedTimeMicros() - start;
+			auto tessellatedIntersectionArea = abs(area(tessellated));
+
+			start = ofGetElapsedTimeMicros();
+			clipped = ofPolylinesClip({a}, {b}, OF_POLY_CLIP_INTERSECTION);
+			auto clipperIntersection = ofGetElapsedTimeMicros() - start;
+			ofxTest(abs(area(clipped) - tessellatedIntersectionArea) < tessellatedIntersectionArea * 1e-4f, "intersection matches tessellator with " + ofToString(numPoints) + " points");
+
+			ofLogNotice() << numPoints << " points, union: tessellator " << tessellatorUnion << "us, clipper " << clipperUnion << "us"
+			              << ", intersection: tessellator " << tessellatorIntersection << "us, clipper " << clipperIntersection << "us";
+		}
+	}
+
+	void run(){
+		testBooleans();
+		testPath();
+		testOffset();
+		testManyActiveEdges();
+		testTessellatorRoute();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
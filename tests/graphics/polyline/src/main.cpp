@@ -0,0 +1,170 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+
+	// a closed wavy circle, convoluted enough for the index to matter
+	ofPolyline flower(size_t numPoints){
+		ofPolyline flower;
+		for(size_t i = 0; i < numPoints; i++){
+			float angle = TWO_PI * i / numPoints;
+			float radius = 200 + 30 * sin(angle * 50);
+			flower.addVertex(radius * cos(angle), radius * sin(angle));
+		}
+		flower.close();
+		return flower;
+	}
+
+	// distance to the closest of every segment, in double precision
+	double bruteForceDistance(const ofPolyline & line, const glm::vec3 & target){
+		size_t numSegments = line.isClosed() ? line.size() : line.size() - 1;
+		double distance = numeric_limits<double>::max();
+		for(size_t i = 0; i < numSegments; i++){
+			glm::dvec3 a = line[i];
+			glm::dvec3 b = line[(i + 1) % line.size()];
+			glm::dvec3 p = target;
+			auto ab = b - a;
+			double t = glm::clamp(glm::dot(p - a, ab) / glm::dot(ab, ab), 0.0, 1.0);
+			auto c = a + ab * t;
+			distance = min(distance, glm::length(p - c));
+		}
+		return distance;
+	}
+
+	size_t bruteForceNumIntersections(const ofPolyline & line, const glm::vec3 & p0, const glm::vec3 & p1){
+		size_t numSegments = line.isClosed() ? line.size() : line.size() - 1;
+		size_t count = 0;
+		for(size_t i = 0; i < numSegments; i++){
+			glm::dvec3 a = line[i];
+			glm::dvec3 b = line[(i + 1) % line.size()];
+			glm::dvec3 d = glm::dvec3(p1) - glm::dvec3(p0);
+			auto e = b - a;
+			double denom = d.x * e.y - d.y * e.x;
+			if(denom == 0){
+				continue;
+			}
+			auto w = a - glm::dvec3(p0);
+			double t = (w.x * e.y - w.y * e.x) / denom;
+			double u = (w.x * d.y - w.y * d.x) / denom;
+			count += t >= 0 && t <= 1 && u >= 0 && u <= 1;
+		}
+		return count;
+	}
+
+	void testSpatialIndex(){
+		for(bool closed: {true, false}){
+			auto linear = flower(20000);
+			linear.setClosed(closed);
+			auto indexed = linear;
+			indexed.setUseSpatialIndex(true);
+			string name = closed ? " closed" : " open";
+
+			std::mt19937 random(1);
+			std::uniform_real_distribution<float> position(-300, 300);
+			size_t closestMatches = 0, closestLinear = 0, insideMatches = 0, intersectionMatches = 0;
+			size_t numQueries = 200;
+			for(size_t i = 0; i < numQueries; i++){
+				glm::vec3 target(position(random), position(random), 0);
+				unsigned int linearIndex, indexedIndex;
+				auto linearPoint = linear.getClosestPoint(target, &linearIndex);
+				auto indexedPoint = indexed.getClosestPoint(target, &indexedIndex);
+				// points at the same distance can be different on ties
+				closestMatches += abs(glm::distance(indexedPoint, target) - bruteForceDistance(linear, target)) < 1e-3;
+				closestLinear += indexedPoint == linearPoint && indexedIndex == linearIndex;
+				insideMatches += indexed.inside(target) == linear.inside(target);
+
+				glm::vec3 end(position(random), position(random), 0);
+				intersectionMatches += indexed.getIntersections(target, end).size() == bruteForceNumIntersections(linear, target, end);
+			}
+			ofxTestEq(closestMatches, numQueries, "indexed closest point matches brute force," + name);
+			ofxTestEq(closestLinear, numQueries, "indexed closest point and index match the linear search," + name);
+			ofxTestEq(insideMatches, numQueries, "indexed inside matches the linear test," + name);
+			ofxTestEq(intersectionMatches, numQueries, "indexed intersections match brute force," + name);
+			ofxTestEq(linear.getIntersections({-300, 1, 0}, {300, 1, 0}).size(), indexed.getIntersections({-300, 1, 0}, {300, 1, 0}).size(), "intersections with and without index," + name);
+		}
+
+		// the index is rebuilt when the line changes
+		auto line = flower(1000);
+		line.setUseSpatialIndex(true);
+		line.getClosestPoint({0, 0, 0});
+		line.addVertex(0, 0);
+		line.flagHasChanged();
+		ofxTestEq(line.getClosestPoint({-1, -1, 0}), glm::vec3(0, 0, 0), "index updated after adding a vertex");
+		ofxTest(line.inside(150, 50) && !line.inside(300, 0), "inside with index");
+	}
+
+	bool equal(const ofPolyline & a, const ofPolyline & b, float tolerance = 0){
+		if(a.size() != b.size() || a.isClosed() != b.isClosed()){
+			return false;
+		}
+		for(size_t i = 0; i < a.size(); i++){
+			if(glm::distance(a[i], b[i]) > tolerance){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void testOutputOverloads(){
+		auto closed = flower(5000);
+		auto open = closed;
+		open.setClosed(false);
+
+		// the same result is reused with lines of different sizes and
+		// closed state to check nothing from a previous call is left
+		ofPolyline result;
+		for(auto & line: {closed, open, closed}){
+			string name = line.isClosed() ? " closed" : " open";
+			for(int size: {1, 5, 40}){
+				for(float shape: {0.f, 0.5f, 1.f}){
+					line.getSmoothed(size, shape, result);
+					ofxTest(equal(result, line.getSmoothed(size, shape)), "getSmoothed " + ofToString(size) + " " + ofToString(shape) + name);
+				}
+			}
+			for(float spacing: {0.5f, 3.f, 100.f}){
+				line.getResampledBySpacing(spacing, result);
+				ofxTest(equal(result, line.getResampledBySpacing(spacing)), "getResampledBySpacing " + ofToString(spacing) + name);
+			}
+			for(int count: {2, 100, 4999, 20000}){
+				line.getResampledByCount(count, result);
+				ofxTest(equal(result, line.getResampledByCount(count)), "getResampledByCount " + ofToString(count) + name);
+			}
+
+			// scale by 2 then translate by 10,20
+			glm::mat4 m(1.f);
+			m[0][0] = 2;
+			m[1][1] = 2;
+			m[3] = glm::vec4(10, 20, 0, 1);
+			auto transformed = line;
+			transformed.transform(m);
+			line.getTransformed(m, result);
+			ofxTest(equal(result, transformed), "getTransformed matches transform" + name);
+			auto moved = line;
+			moved.scale(2, 2);
+			moved.translate({10, 20, 0});
+			ofxTest(equal(transformed, moved, 1e-3f), "transform matches scale and translate" + name);
+			result = line;
+			result.getTransformed(m, result);
+			ofxTest(equal(result, transformed), "getTransformed in place" + name);
+		}
+	}
+
+	void run(){
+		testSpatialIndex();
+		testOutputOverloads();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,270 @@
+#include "ofMain.h"
+#include "ofAppGLFWWindow.h"
+#include "ofxUnitTests.h"
+
+// exposes the atlas pages to check the pixels the quads point to, and
+// the layout api used by ofTextLayout and the renderers
+class atlasFont: public ofTrueTypeFont{
+public:
+	using ofTrueTypeFont::getCachedLayout;
+	using ofTrueTypeFont::layoutGlyphs;
+	using ofTrueTypeFont::beginLayout;
+	using ofTrueTypeFont::addLayoutLine;
+	using ofTrueTypeFont::endLayout;
+	using ofTrueTypeFont::isLayoutCurrent;
+	using ofTrueTypeFont::useLayout;
+
+	const ofPixels & getPagePixels(size_t page) const{
+		return atlasPages[page].pixels;
+	}
+
+	// top left corner of the texels of a glyph in glyph coordinates
+	glm::vec2 getTexelsOrigin(uint32_t c) const{
+		auto & props = getGlyphProperties(c);
+		return glm::vec2(props.xmin - getDistanceFieldPadding(), props.ymin - getDistanceFieldPadding());
+	}
+};
+
+class ofApp: public ofxUnitTestsApp{
+
+	const std::string fontPath = "../../../../../examples/graphics/fontsExample/bin/data/verdana.ttf";
+
+	ofTrueTypeFontSettings fontSettings(int pageSize, size_t maxPages){
+		ofTrueTypeFontSettings settings(ofToDataPath(fontPath), 24);
+		settings.dynamicAtlas = true;
+		settings.atlasPageSize = pageSize;
+		settings.maxAtlasPages = maxPages;
+		return settings;
+	}
+
+	// pixels pointed to by every quad keyed by the quad position
+	template<class Mesh>
+	std::map<std::pair<int,int>,ofPixels> quadPixels(const atlasFont & font, const std::vector<Mesh> & meshes){
+		std::map<std::pair<int,int>,ofPixels> glyphs;
+		for(size_t page = 0; page < meshes.size(); page++){
+			auto & pixels = font.getPagePixels(page);
+			auto & vertices = meshes[page].getVertices();
+			auto & texCoords = meshes[page].getTexCoords();
+			for(size_t i = 0; i + 3 < vertices.size(); i += 4){
+				int x = round(texCoords[i].x * pixels.getWidth());
+				int y = round(texCoords[i].y * pixels.getHeight());
+				int w = round(texCoords[i + 2].x * pixels.getWidth()) - x;
+				int h = round(texCoords[i + 2].y * pixels.getHeight()) - y;
+				ofPixels glyph;
+				pixels.cropTo(glyph, x, y, w, h);
+				glyphs[{int(round(vertices[i].x)), int(round(vertices[i].y))}] = glyph;
+			}
+		}
+		return glyphs;
+	}
+
+	std::map<std::pair<int,int>,ofPixels> glyphPixels(const atlasFont & font, const std::string & str){
+		return quadPixels(font, font.getStringMeshes(str, 0, 0));
+	}
+
+	size_t numQuads(const std::vector<ofMesh> & meshes){
+		size_t quads = 0;
+		for(auto & mesh: meshes){
+			quads += mesh.getNumVertices() / 4;
+		}
+		return quads;
+	}
+
+	bool equal(const std::map<std::pair<int,int>,ofPixels> & glyphs1, const std::map<std::pair<int,int>,ofPixels> & glyphs2){
+		if(glyphs1.size() != glyphs2.size()){
+			return false;
+		}
+		for(auto & glyph: glyphs1){
+			auto other = glyphs2.find(glyph.first);
+			if(other == glyphs2.end() ||
+			   other->second.getWidth() != glyph.second.getWidth() ||
+			   other->second.getHeight() != glyph.second.getHeight() ||
+			   !std::equal(glyph.second.begin(), glyph.second.end(), other->second.begin())){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void testPages(const atlasFont & reference){
+		atlasFont font;
+		ofxTestEq(font.load(fontSettings(128, 2)), true, "load small atlas");
+
+		std::string str = "ABCDEFGHIJKLMNOPQRST";
+		auto & meshes = font.getStringMeshes(str, 0, 0);
+		ofxTestEq(font.getNumAtlasPages(), 2u, "a string bigger than a page opens a second one");
+		ofxTestEq(meshes.size(), 2u, "one mesh per page");
+		ofxTest(meshes[0].getNumVertices() > 0 && meshes[1].getNumVertices() > 0, "the string uses both pages");
+		ofxTestEq(numQuads(meshes), str.size(), "every glyph has a quad");
+		ofxTest(equal(glyphPixels(font, str), glyphPixels(reference, str)), "quads point to their glyph in their page");
+
+		auto firstPageVertices = meshes[0].getNumVertices();
+		auto & mesh = font.getStringMesh(str, 0, 0);
+		ofxTestEq(mesh.getNumVertices(), firstPageVertices, "getStringMesh only returns the first page");
+	}
+
+	void testEviction(const atlasFont & reference){
+		atlasFont font;
+		ofxTestEq(font.load(fontSettings(128, 2)), true, "load small atlas");
+
+		std::vector<std::string> strings{
+			"abcdefghij", "klmnopqrst", "uvwxyzABCD", "EFGHIJKLMN",
+			"OPQRSTUVWX", "YZ01234567", "89!?@#$%&*", "abcdefghij",
+		};
+		bool allMatch = true;
+		bool allQuads = true;
+		for(auto & str: strings){
+			allQuads &= numQuads(font.getStringMeshes(str, 0, 0)) == str.size();
+			allMatch &= equal(glyphPixels(font, str), glyphPixels(reference, str));
+		}
+		auto stats = font.getAtlasStats();
+		ofxTestEq(stats.numPages, 2u, "the atlas doesn't grow over maxAtlasPages");
+		ofxTest(stats.evictions > 0, "glyphs are evicted when the atlas is full");
+		ofxTest(stats.numResidentGlyphs < stats.numGlyphs, "evicted glyphs aren't resident");
+		ofxTest(allQuads, "every glyph has a quad after evictions");
+		ofxTest(allMatch, "quads point to their glyph after evictions");
+	}
+
+	void testLayoutCache(){
+		auto settings = fontSettings(1024, 1);
+		settings.layoutCacheSize = 2;
+		atlasFont font;
+		ofxTestEq(font.load(settings), true, "load font with a small layout cache");
+
+		ofxTest(font.getCachedLayout("a") == nullptr, "strings aren't cached the first time");
+		auto a = font.getCachedLayout("a");
+		ofxTest(a != nullptr, "strings are cached the second time");
+		ofxTest(font.getCachedLayout("a") == a, "cached layouts are reused");
+		font.getCachedLayout("b");
+		font.getCachedLayout("a");
+		font.getCachedLayout("c");
+		ofxTest(font.getCachedLayout("a") == a, "the most recently used layouts stay in the cache");
+		ofxTest(font.getCachedLayout("b") == nullptr, "the least recently used layout is evicted");
+		ofxTest(font.getCachedLayout("a", false) == nullptr, "flipped strings are cached separately");
+	}
+
+	void testLayoutInvalidation(const atlasFont & reference){
+		atlasFont font;
+		ofxTestEq(font.load(fontSettings(128, 1)), true, "load small atlas");
+
+		atlasFont::layoutGlyphs glyphs;
+		std::vector<ofRectangle> glyphBoxes;
+		font.beginLayout(glyphs);
+		font.addLayoutLine("ab", {0, 0}, true, glyphs, glyphBoxes);
+		auto quads = font.endLayout(glyphs);
+		auto expected = glyphPixels(reference, "ab");
+		ofxTest(font.useLayout(glyphs), "a new layout is valid");
+
+		std::vector<std::string> strings{
+			"cdefghij", "klmnopqr", "stuvwxyz", "ABCDEFGH",
+			"IJKLMNOP", "QRSTUVWX", "YZ012345", "6789!?@#",
+		};
+		bool staleReportedValid = false;
+		bool evictedWhileValid = false;
+		for(auto & str: strings){
+			auto evictions = font.getAtlasStats().evictions;
+			font.getStringMeshes(str, 0, 0);
+			if(font.useLayout(glyphs)){
+				staleReportedValid |= !equal(quadPixels(font, quads), expected);
+				evictedWhileValid |= font.getAtlasStats().evictions > evictions;
+			}
+		}
+		ofxTest(!staleReportedValid, "layouts are stale when their glyphs are evicted");
+		ofxTest(evictedWhileValid, "evicting other glyphs doesn't invalidate a layout");
+
+		font.setLineHeight(font.getLineHeight() + 1);
+		ofxTest(!font.isLayoutCurrent(glyphs), "changing the metrics invalidates layouts");
+
+		// the layout isn't drawn while its glyphs are evicted
+		ofTextLayout layout(font, "ab", 0, OF_ALIGN_HORZ_IGNORE);
+		layout.getMeshes();
+		for(auto & str: strings){
+			font.getStringMeshes(str, 0, 0);
+		}
+		ofxTest(font.getAtlasStats().numResidentGlyphs < font.getAtlasStats().numGlyphs, "glyphs were evicted");
+		ofxTest(equal(quadPixels(font, layout.getMeshes()), expected), "layouts are rebuilt when their glyphs are evicted");
+	}
+
+	// signed distance fields have to agree with the outline on which texels
+	// are inside, the contours returned by the font are rounded to pixels
+	// so texels closer than that to the edge are skipped
+	void testDistanceField(ofTrueTypeFontRenderMode mode, const std::string & name){
+		auto settings = fontSettings(256, 1);
+		settings.renderMode = mode;
+		settings.contours = true;
+		settings.simplifyAmt = 0;
+		atlasFont font;
+		ofxTestEq(font.load(settings), true, "load " + name + " font");
+
+		float range = settings.distanceRange;
+		size_t numInside = 0, numOutside = 0, numWrong = 0;
+		for(uint32_t c: {'O', 'A', 'g', 'E'}){
+			std::string str(1, char(c));
+			auto & meshes = font.getStringMeshes(str, 0, 0);
+			auto & pixels = font.getPagePixels(0);
+			auto & texCoords = meshes[0].getTexCoords();
+			if(texCoords.size() != 4){
+				numWrong++;
+				continue;
+			}
+			int x0 = round(texCoords[0].x * pixels.getWidth());
+			int y0 = round(texCoords[0].y * pixels.getHeight());
+			int w = round(texCoords[2].x * pixels.getWidth()) - x0;
+			int h = round(texCoords[2].y * pixels.getHeight()) - y0;
+
+			auto outlines = font.getCharacterAsPoints(c).getOutline();
+			auto origin = font.getTexelsOrigin(c);
+			for(int y = 0; y < h; y++){
+				for(int x = 0; x < w; x++){
+					auto color = pixels.getColor(x0 + x, y0 + y);
+					float value = mode == OF_TTF_RENDER_MSDF ?
+						std::max(std::min(color.r, color.g), std::min(std::max(color.r, color.g), color.b)) :
+						color.a;
+					float distance = (value / 255.f - 0.5f) * 2 * range;
+					if(std::abs(distance) < 1.5f){
+						continue;
+					}
+					glm::vec2 p = origin + glm::vec2(x + 0.5f, y + 0.5f);
+					bool inside = false;
+					for(auto & outline: outlines){
+						inside ^= outline.inside(p.x, p.y);
+					}
+					if(inside != (distance > 0)){
+						numWrong++;
+					}else if(inside){
+						numInside++;
+					}else{
+						numOutside++;
+					}
+				}
+			}
+		}
+		ofxTest(numInside > 0 && numOutside > 0, name + " glyphs have texels inside and outside");
+		ofxTestEq(numWrong, 0u, name + " distances agree with the outlines");
+	}
+
+	void run(){
+		// a single page big enough to never evict
+		atlasFont reference;
+		ofxTestEq(reference.load(fontSettings(1024, 1)), true, "load reference font");
+
+		testPages(reference);
+		testEviction(reference);
+		ofxTestEq(reference.getAtlasStats().evictions, 0u, "the reference font never evicts");
+		testLayoutCache();
+		testLayoutInvalidation(reference);
+		testDistanceField(OF_TTF_RENDER_SDF, "sdf");
+		testDistanceField(OF_TTF_RENDER_MSDF, "msdf");
+	}
+};
+
+//========================================================================
+int main( ){
+	// the atlas pages are textures so this test needs a gl context
+	ofGLFWWindowSettings settings;
+	settings.visible = false;
+	ofCreateWindow(settings);
+	ofRunApp(make_shared<ofApp>());
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,279 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofSoundDecoding.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// wav file header and chunks built by hand to test the parser
+	struct Wav{
+		std::string bytes;
+
+		void add16(uint16_t v){
+			bytes += char(v & 0xff);
+			bytes += char(v >> 8);
+		}
+
+		void add32(uint32_t v){
+			add16(v & 0xffff);
+			add16(v >> 16);
+		}
+
+		void addChunk(const std::string & id, const std::string & data){
+			bytes += id;
+			add32(data.size());
+			bytes += data;
+			if(data.size() & 1){
+				bytes += char(0);
+			}
+		}
+
+		static std::string fmt(uint16_t format, uint16_t channels, uint32_t rate, uint16_t bits, bool extensible = false){
+			Wav chunk;
+			chunk.add16(extensible ? 0xFFFE : format);
+			chunk.add16(channels);
+			chunk.add32(rate);
+			chunk.add32(rate * channels * bits / 8);
+			chunk.add16(channels * bits / 8);
+			chunk.add16(bits);
+			if(extensible){
+				chunk.add16(22);
+				chunk.add16(bits);
+				chunk.add32(0);
+				// the sub format GUID starts with the format
+				chunk.add16(format);
+				chunk.bytes += std::string(14, '\x10');
+			}
+			return chunk.bytes;
+		}
+
+		static std::string samples(const std::vector<short> & samples){
+			Wav chunk;
+			for(auto s: samples){
+				chunk.add16(uint16_t(s));
+			}
+			return chunk.bytes;
+		}
+
+		std::string file() const{
+			Wav riff;
+			riff.bytes = "RIFF";
+			riff.add32(bytes.size() + 4);
+			riff.bytes += "WAVE" + bytes;
+			return riff.bytes;
+		}
+	};
+
+	std::string write(const std::string & name, const std::string & bytes){
+		auto path = ofToDataPath(name, true);
+		std::ofstream file(path, std::ios::binary);
+		file.write(bytes.data(), bytes.size());
+		return path;
+	}
+
+	void testMappedWav(){
+		std::vector<short> stereo{1, -1, 2, -2, 3, -3, 32767, -32768};
+
+		Wav simple;
+		simple.addChunk("fmt ", Wav::fmt(1, 2, 44100, 16));
+		simple.addChunk("data", Wav::samples(stereo));
+		ofMappedWav wav;
+		ofxTest(wav.open(write("simple.wav", simple.file())), "Open a 16 bit wav file");
+		ofxTestEq(wav.channels, 2, "Channels");
+		ofxTestEq(wav.samplerate, 44100, "Sample rate");
+		ofxTestEq(wav.frames, uint64_t(4), "Frames");
+		ofxTest(std::equal(stereo.begin(), stereo.end(), wav.samples), "Samples are mapped in place");
+
+		// an odd sized chunk before the data is padded to an even size
+		Wav padded;
+		padded.addChunk("fmt ", Wav::fmt(1, 1, 22050, 16));
+		padded.addChunk("LIST", "odd");
+		padded.addChunk("data", Wav::samples({5, 6, 7}));
+		ofxTest(wav.open(write("padded.wav", padded.file())), "Skip odd sized chunks");
+		ofxTestEq(wav.frames, uint64_t(3), "Frames after an odd sized chunk");
+		ofxTestEq(wav.samples[2], short(7), "Samples after an odd sized chunk");
+
+		Wav extensible;
+		extensible.addChunk("fmt ", Wav::fmt(1, 2, 48000, 16, true));
+		extensible.addChunk("data", Wav::samples(stereo));
+		ofxTest(wav.open(write("extensible.wav", extensible.file())), "Open WAVE_FORMAT_EXTENSIBLE files");
+		ofxTestEq(wav.samplerate, 48000, "Sample rate of WAVE_FORMAT_EXTENSIBLE files");
+
+		// a data chunk longer than the file, as left by an interrupted recording
+		Wav truncated;
+		truncated.addChunk("fmt ", Wav::fmt(1, 2, 44100, 16));
+		truncated.bytes += "data";
+		truncated.add32(1000);
+		truncated.bytes += Wav::samples({1, 2, 3, 4, 5});
+		ofxTest(wav.open(write("truncated.wav", truncated.file())), "Open files with a truncated data chunk");
+		ofxTestEq(wav.frames, uint64_t(2), "Only the complete frames in the file are used");
+
+		Wav pcm24;
+		pcm24.addChunk("fmt ", Wav::fmt(1, 2, 44100, 24));
+		pcm24.addChunk("data", std::string(12, '\0'));
+		ofxTest(!wav.open(write("pcm24.wav", pcm24.file())), "24 bit files aren't mapped");
+		ofxTest(wav.samples == nullptr && wav.frames == 0, "A failed open leaves the file closed");
+
+		Wav floats;
+		floats.addChunk("fmt ", Wav::fmt(3, 1, 44100, 32, true));
+		floats.addChunk("data", std::string(8, '\0'));
+		ofxTest(!wav.open(write("float.wav", floats.file())), "Float files aren't mapped");
+
+		Wav noFormat;
+		noFormat.addChunk("data", Wav::samples(stereo));
+		ofxTest(!wav.open(write("noformat.wav", noFormat.file())), "Files without a format chunk aren't mapped");
+		ofxTest(!wav.open(write("notwav.wav", std::string("RIFF\0\0\0\0AVI LIST", 16))), "Other RIFF files aren't mapped");
+		ofxTest(!wav.open(write("empty.wav", "")), "Empty files aren't mapped");
+		ofxTest(!wav.open(ofToDataPath("missing.wav", true)), "Missing files aren't mapped");
+
+		for(auto name: {"simple", "padded", "extensible", "truncated", "pcm24", "float", "noformat", "notwav", "empty"}){
+			ofFile::removeFile(std::string(name) + ".wav");
+		}
+	}
+
+	void testStreamRing(){
+		ofSoundStreamRing ring;
+		ring.allocate(4, 8);
+		ofxTestEq(ring.getNumBlocks(), size_t(4), "Number of blocks");
+		ofxTest(ring.front(0) == nullptr, "A new ring is empty");
+
+		auto push = [&](uint32_t generation, uint64_t firstFrame){
+			auto block = ring.beginWrite();
+			if(block){
+				block->generation = generation;
+				block->firstFrame = firstFrame;
+				block->frames = 8;
+				ring.endWrite();
+			}
+			return block != nullptr;
+		};
+
+		bool written = true;
+		for(int i = 0; i < 4; i++){
+			written &= push(0, i * 8);
+		}
+		ofxTest(written, "Write until the ring is full");
+		ofxTest(!push(0, 32), "A full ring can't be written");
+
+		auto block = ring.front(0);
+		ofxTest(block && block->firstFrame == 0, "Blocks are read in order");
+		ring.pop();
+		ofxTest(push(0, 32), "Popping a block frees it for the decoder");
+		ofxTestEq(ring.front(0)->firstFrame, uint64_t(8), "Front doesn't consume the block");
+
+		// seek: the decoder writes blocks for generation 1 after the ones
+		// for generation 0 still in the ring
+		ring.pop();
+		ring.pop();
+		push(1, 100);
+		ofxTest(ring.front(0) && ring.front(0)->firstFrame == 24, "Blocks of the current generation before a seek are read");
+		ring.pop();
+		ring.pop();
+		ofxTest(ring.front(0) == nullptr, "Blocks of a newer generation aren't read");
+		ofxTest(ring.front(1) && ring.front(1)->firstFrame == 100, "Blocks of a newer generation are kept for it");
+
+		push(2, 200);
+		push(3, 300);
+		ofxTest(ring.front(3) && ring.front(3)->firstFrame == 300, "Blocks of older generations are skipped");
+		ring.pop();
+		ofxTest(ring.front(3) == nullptr, "Skipped blocks are consumed");
+		ofxTest(push(3, 308) && push(3, 316) && push(3, 324) && push(3, 332), "Skipped blocks are freed for the decoder");
+
+		// generations compared across the wrap around
+		ofSoundStreamRing wrapped;
+		wrapped.allocate(2, 8);
+		auto first = wrapped.beginWrite();
+		first->generation = 0xffffffff;
+		wrapped.endWrite();
+		auto second = wrapped.beginWrite();
+		second->generation = 0;
+		wrapped.endWrite();
+		ofxTest(wrapped.front(0xffffffff) == first, "Generations before the wrap around are current");
+		wrapped.pop();
+		ofxTest(wrapped.front(0xffffffff) == nullptr, "Generations after the wrap around are newer");
+		ofxTest(wrapped.front(0) == second, "Generations after the wrap around are read");
+
+		// producer and consumer in different threads
+		ofSoundStreamRing threaded;
+		threaded.allocate(4, 1);
+		const uint64_t numBlocks = 100000;
+		std::thread producer([&]{
+			for(uint64_t i = 0; i < numBlocks;){
+				auto block = threaded.beginWrite();
+				if(!block){
+					std::this_thread::yield();
+					continue;
+				}
+				block->firstFrame = i;
+				block->samples[0] = short(i);
+				block->generation = uint32_t(i / 1000);
+				threaded.endWrite();
+				i++;
+			}
+		});
+		bool inOrder = true;
+		uint64_t read = 0;
+		for(uint32_t generation = 0; read < numBlocks;){
+			auto block = threaded.front(generation);
+			if(!block){
+				// the next generation once the current one is read
+				if(read > 0 && read % 1000 == 0 && read / 1000 > generation){
+					generation++;
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			inOrder &= block->firstFrame == read && block->samples[0] == short(read);
+			threaded.pop();
+			read++;
+		}
+		producer.join();
+		ofxTest(inOrder, "Blocks written by another thread are read in order");
+	}
+
+	void testCache(){
+		ofSoundCache<int> cache;
+		size_t loads = 0;
+		auto load = [&]{
+			loads++;
+			return std::make_shared<int>(42);
+		};
+
+		auto a = cache.get("a", load);
+		auto a2 = cache.get("a", load);
+		ofxTest(a && a == a2, "Objects loaded from the same key are shared");
+		ofxTestEq(loads, size_t(1), "Shared objects are only loaded once");
+
+		auto b = cache.get("b", load);
+		ofxTest(b != a, "Different keys load different objects");
+		ofxTestEq(cache.size(), size_t(2), "Number of cached keys");
+
+		a.reset();
+		a2.reset();
+		auto c = cache.get("c", load);
+		ofxTestEq(cache.size(), size_t(2), "Objects no longer in use are removed");
+		cache.get("a", load);
+		ofxTestEq(loads, size_t(4), "Objects no longer in use are loaded again");
+
+		auto failed = cache.get("missing", []{
+			return std::shared_ptr<int>();
+		});
+		ofxTest(failed == nullptr, "Failed loads return nullptr");
+		auto retried = cache.get("missing", load);
+		ofxTest(retried != nullptr, "Failed loads aren't cached");
+	}
+
+	void run(){
+		testMappedWav();
+		testStreamRing();
+		testCache();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
@@ -0,0 +1,119 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// reference O(n^2) discrete fourier transform
+	std::vector<std::complex<double>> dft(const std::vector<std::complex<float>> & x){
+		auto n = x.size();
+		std::vector<std::complex<double>> out(n);
+		for(size_t k = 0; k < n; k++){
+			for(size_t j = 0; j < n; j++){
+				out[k] += std::complex<double>(x[j]) * std::polar(1.0, -TWO_PI * double(j * k % n) / n);
+			}
+		}
+		return out;
+	}
+
+	void testTransforms(){
+		for(size_t n: {1, 2, 3, 8, 12, 15, 49, 97, 360, 441, 512, 1000, 1024}){
+			ofFFT fft;
+			fft.setup(n);
+			std::vector<std::complex<float>> x(n), X(n), y(n);
+			std::vector<float> real(n), realBack(n);
+			for(size_t i = 0; i < n; i++){
+				x[i] = {ofRandom(-1, 1), ofRandom(-1, 1)};
+				real[i] = ofRandom(-1, 1);
+			}
+
+			auto expected = dft(x);
+			fft.forward(x.data(), X.data());
+			double error = 0;
+			for(size_t k = 0; k < n; k++){
+				error = std::max(error, std::abs(std::complex<double>(X[k]) - expected[k]));
+			}
+			ofxTest(error / sqrt(n) < 1e-5, "complex fft of size " + ofToString(n));
+
+			fft.inverse(X.data(), y.data());
+			error = 0;
+			for(size_t k = 0; k < n; k++){
+				error = std::max(error, double(std::abs(y[k] - x[k])));
+			}
+			ofxTest(error < 1e-5, "inverse complex fft of size " + ofToString(n));
+
+			std::vector<std::complex<float>> realAsComplex(real.begin(), real.end());
+			expected = dft(realAsComplex);
+			std::vector<std::complex<float>> bins(fft.getNumBins());
+			fft.forward(real.data(), bins.data());
+			error = 0;
+			for(size_t k = 0; k < bins.size(); k++){
+				error = std::max(error, std::abs(std::complex<double>(bins[k]) - expected[k]));
+			}
+			ofxTest(error / sqrt(n) < 1e-5, "real fft of size " + ofToString(n));
+
+			fft.inverse(bins.data(), realBack.data());
+			error = 0;
+			for(size_t k = 0; k < n; k++){
+				error = std::max(error, double(std::abs(realBack[k] - real[k])));
+			}
+			ofxTest(error < 1e-5, "inverse real fft of size " + ofToString(n));
+		}
+	}
+
+	void testAnalyzer(){
+		ofSpectrumAnalyzer analyzer;
+		analyzer.setup(2048, 512, 44100);
+		analyzer.setupMelBands(40);
+		analyzer.setupLogBands(3);
+		ofxTestEq(analyzer.getNumBins(), size_t(1025), "Number of bins");
+		ofxTestEq(analyzer.getMelBands().size(), size_t(40), "Number of mel bands");
+
+		// a 1KHz stereo sine in blocks of 256 frames
+		ofSoundBuffer buffer;
+		buffer.allocate(256, 2);
+		buffer.setSampleRate(44100);
+		size_t frames = 0;
+		float phase = 0;
+		for(int i = 0; i < 40; i++){
+			for(size_t f = 0; f < 256; f++){
+				buffer.getSample(f, 0) = buffer.getSample(f, 1) = sin(phase);
+				phase += TWO_PI * 1000 / 44100;
+			}
+			frames += analyzer.process(buffer);
+		}
+		ofxTestEq(frames, size_t((40 * 256 - 2048) / 512 + 1), "One frame every hop");
+		ofxTestEq(analyzer.getNumFramesAnalyzed(), uint64_t(frames), "Frames counted");
+
+		auto & magnitudes = analyzer.getMagnitudes();
+		auto peak = std::max_element(magnitudes.begin(), magnitudes.end()) - magnitudes.begin();
+		ofxTest(std::abs(analyzer.getBinFrequency(peak) - 1000) < analyzer.getBinFrequency(1), "Peak at the frequency of the sine");
+		ofxTest(magnitudes[peak] > 0.8 && magnitudes[peak] <= 1, "Magnitude normalized to the sine amplitude");
+
+		auto & mel = analyzer.getMelBands();
+		auto melPeak = std::max_element(mel.begin(), mel.end()) - mel.begin();
+		ofxTest(std::abs(analyzer.getMelFrequencies()[melPeak] - 1000) < 150, "Mel band with the sine");
+
+		auto & log = analyzer.getLogBands();
+		auto logPeak = std::max_element(log.begin(), log.end()) - log.begin();
+		float center = analyzer.getLogFrequencies()[logPeak];
+		ofxTest(1000 > center / pow(2, 1 / 6.) && 1000 < center * pow(2, 1 / 6.), "Third octave band with the sine");
+
+		analyzer.reset();
+		ofxTestEq(analyzer.getNumFramesAnalyzed(), uint64_t(0), "Reset");
+		ofxTestEq(analyzer.getMagnitudes()[peak], 0.f, "Reset clears the results");
+	}
+
+	void run(){
+		testTransforms();
+		testAnalyzer();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
@@ -0,0 +1,249 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// constant source that counts how many times it's processed
+	struct ConstantNode: public ofSoundNode{
+		ConstantNode(float value)
+		:value(value){}
+
+		void onParameter(int id, float v) override{
+			value = v;
+		}
+
+		void process(const std::vector<const ofSoundBuffer *> & inputs, ofSoundBuffer & output) override{
+			std::fill(output.getBuffer().begin(), output.getBuffer().end(), value);
+			processed++;
+		}
+
+		float value;
+		size_t processed = 0;
+	};
+
+	void testMix(){
+		ofSoundGraph graph;
+		graph.setup(2, 256, 44100);
+		ofSoundBuffer out;
+		out.allocate(256, 2);
+
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.f, "Empty graph outputs silence");
+
+		auto a = std::make_shared<ConstantNode>(0.25f);
+		auto b = std::make_shared<ConstantNode>(0.5f);
+		auto unconnected = std::make_shared<ConstantNode>(1.f);
+		ofxTest(graph.connect(a, graph.getOutput()), "Connect a source to the output");
+		ofxTest(graph.connect(b, graph.getOutput()), "Connect a second source to the output");
+		graph.add(unconnected);
+		ofxTestEq(graph.getNumNodes(), size_t(4), "Number of nodes");
+		ofxTestEq(graph.getNumScheduledNodes(), size_t(3), "Only the nodes connected to the output are scheduled");
+
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.75f, "Sources are mixed");
+		ofxTestEq(out[511], 0.75f, "All the block is mixed");
+		ofxTestEq(unconnected->processed, size_t(0), "Unconnected nodes aren't processed");
+
+		b->setParameter(0, 0.25f);
+		ofxTestEq(b->value, 0.5f, "Parameters wait for the audio thread");
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.5f, "Parameters are applied before the next block");
+
+		graph.getOutput()->setInputGain(1, 0);
+		graph.audioOut(out);
+		ofxTest(out[0] > 0.49f && out[509] < 0.26f, "Input gain is ramped over a block");
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.25f, "Input gain after the ramp");
+
+		ofxTest(!graph.connect(graph.getOutput(), a), "Cycles are rejected");
+		auto gain = std::make_shared<ofSoundGainNode>();
+		ofxTest(graph.connect(a, gain), "Connect to an effect");
+		ofxTest(!graph.connect(gain, a), "Indirect cycles are rejected");
+
+		graph.remove(a);
+		ofxTestEq(graph.getNumScheduledNodes(), size_t(2), "Removed nodes aren't scheduled");
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.25f, "Removed nodes aren't mixed");
+
+		out.allocate(100, 2);
+		graph.getOutput()->setInputGain(0, 1);
+		graph.audioOut(out);
+		graph.audioOut(out);
+		ofxTestEq(out.getNumFrames(), size_t(100), "Blocks smaller than the maximum");
+		ofxTestEq(out[199], 0.25f, "Mix of smaller blocks");
+	}
+
+	void testEffects(){
+		ofSoundGraph graph;
+		graph.setup(2, 64, 44100);
+		ofSoundBuffer out;
+		out.allocate(64, 2);
+
+		auto sample = std::make_shared<ofSoundBuffer>();
+		sample->allocate(100, 1);
+		sample->fillWithTone(440);
+		auto voice = std::make_shared<ofSoundBufferSourceNode>(sample);
+		auto gain = std::make_shared<ofSoundGainNode>(0.5f);
+		auto pan = std::make_shared<ofSoundPanNode>(-1);
+		graph.connect(voice, gain);
+		graph.connect(gain, pan);
+		graph.connect(pan, graph.getOutput());
+		ofxTestEq(graph.getNumScheduledNodes(), size_t(4), "Chain of effects scheduled");
+
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.f, "Sources are silent until played");
+		voice->play();
+		graph.audioOut(out);
+		ofxTest(voice->isPlaying(), "Source playing");
+		float error = 0;
+		for(size_t i = 0; i < 64; i++){
+			error = std::max(error, std::abs(out[i * 2] - (*sample)[i] * 0.5f));
+			error = std::max(error, std::abs(out[i * 2 + 1]));
+		}
+		ofxTest(error < 1e-6, "Gain and pan applied");
+
+		graph.audioOut(out);
+		ofxTest(!voice->isPlaying(), "Source stops at the end");
+		ofxTestEq(out[(100 - 64) * 2], 0.f, "Silence after the end");
+
+		voice->setLoop(true);
+		voice->play();
+		graph.audioOut(out);
+		graph.audioOut(out);
+		ofxTest(voice->isPlaying(), "Looping source keeps playing");
+		ofxTest(std::abs(out[(100 - 64) * 2] - (*sample)[0] * 0.5f) < 1e-6, "Source loops");
+	}
+
+	// a removed node can still be processed until the audio thread uses
+	// a schedule without it, changes to it wait until then
+	void testRemove(){
+		ofSoundGraph graph;
+		graph.setup(2, 64, 44100);
+		ofSoundBuffer out;
+		out.allocate(64, 2);
+
+		auto node = std::make_shared<ConstantNode>(0.25f);
+		graph.connect(node, graph.getOutput());
+		graph.audioOut(out);
+		graph.remove(node);
+		node->setParameter(0, 0.5f);
+		ofxTestEq(node->value, 0.25f, "Removed nodes wait for the audio thread to stop processing them");
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.f, "Removed nodes aren't processed in the next block");
+		ofxTestEq(node->value, 0.5f, "Changes sent to removed nodes are applied by the audio thread");
+		node->setParameter(0, 1.f);
+		ofxTestEq(node->value, 1.f, "Removed nodes are detached once the audio thread stops processing them");
+
+		graph.connect(node, graph.getOutput());
+		graph.remove(node);
+		graph.connect(node, graph.getOutput());
+		graph.audioOut(out);
+		ofxTestEq(out[0], 1.f, "Nodes added back before being detached are processed");
+		node->setParameter(0, 0.75f);
+		ofxTestEq(node->value, 1.f, "Nodes added back stay in the graph");
+		graph.audioOut(out);
+		ofxTestEq(out[0], 0.75f, "Changes to nodes added back reach the audio thread");
+	}
+
+	// many independent voices processed serially and in parallel
+	void testParallel(){
+		auto build = [](ofSoundGraph & graph, std::vector<std::shared_ptr<ofSoundGainNode>> & gains){
+			graph.setup(2, 256, 48000);
+			graph.beginChanges();
+			for(int i = 0; i < 32; i++){
+				auto phase = std::make_shared<float>(0.f);
+				float frequency = 100 + i * 37;
+				auto osc = std::make_shared<ofSoundFunctionNode>([phase, frequency](const std::vector<const ofSoundBuffer *> &, ofSoundBuffer & output){
+					for(size_t f = 0; f < output.getNumFrames(); f++){
+						output.getSample(f, 0) = output.getSample(f, 1) = sin(*phase);
+						*phase += TWO_PI * frequency / 48000;
+					}
+				});
+				auto gain = std::make_shared<ofSoundGainNode>(1 / 32.f);
+				auto pan = std::make_shared<ofSoundPanNode>(i / 16.f - 1);
+				graph.connect(osc, gain);
+				graph.connect(gain, pan);
+				graph.connect(pan, graph.getOutput());
+				gains.push_back(gain);
+			}
+			graph.endChanges();
+		};
+
+		ofSoundGraph serial, parallel;
+		std::vector<std::shared_ptr<ofSoundGainNode>> serialGains, parallelGains;
+		build(serial, serialGains);
+		build(parallel, parallelGains);
+		parallel.setNumThreads(4);
+		ofxTestEq(parallel.getNumThreads(), size_t(4), "Number of threads");
+		ofxTestEq(parallel.getNumScheduledNodes(), size_t(97), "All voices scheduled");
+
+		ofSoundBuffer a, b;
+		a.allocate(256, 2);
+		b.allocate(256, 2);
+		bool equal = true;
+		for(int block = 0; block < 200; block++){
+			if(block % 10 == 0){
+				serialGains[block % 32]->setGain(0.1f);
+				parallelGains[block % 32]->setGain(0.1f);
+			}
+			serial.audioOut(a);
+			parallel.audioOut(b);
+			equal &= a.getBuffer() == b.getBuffer();
+		}
+		ofxTest(equal, "Parallel processing produces the same output");
+		ofxTestEq(parallel.getDroppedParameterCount(), size_t(0), "No parameters dropped");
+		parallel.setNumThreads(1);
+		ofxTestEq(parallel.getNumThreads(), size_t(1), "Workers stopped");
+
+		// levels that grow, so workers late from a small level run while
+		// the next, larger one starts
+		auto fanOut = [](ofSoundGraph & graph){
+			graph.setup(2, 64, 48000);
+			graph.setMinParallelNodes(2);
+			graph.beginChanges();
+			for(int i = 0; i < 2; i++){
+				auto value = float(i + 1);
+				auto source = std::make_shared<ofSoundFunctionNode>([value](const std::vector<const ofSoundBuffer *> &, ofSoundBuffer & output){
+					for(auto & sample: output.getBuffer()){
+						sample = value;
+					}
+				});
+				for(int j = 0; j < 16; j++){
+					auto gain = std::make_shared<ofSoundGainNode>(1 / 64.f);
+					graph.connect(source, gain);
+					graph.connect(gain, graph.getOutput());
+				}
+			}
+			graph.endChanges();
+		};
+		ofSoundGraph small, grown;
+		fanOut(small);
+		fanOut(grown);
+		grown.setNumThreads(4);
+		a.allocate(64, 2);
+		b.allocate(64, 2);
+		equal = true;
+		for(int block = 0; block < 20000; block++){
+			small.audioOut(a);
+			grown.audioOut(b);
+			equal &= a.getBuffer() == b.getBuffer();
+		}
+		ofxTest(equal, "Parallel processing of growing levels produces the same output");
+	}
+
+	void run(){
+		testMix();
+		testEffects();
+		testRemove();
+		testParallel();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
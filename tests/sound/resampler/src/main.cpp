@@ -0,0 +1,177 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	std::vector<float> tone(float hz, unsigned int sampleRate, size_t frames, size_t channels){
+		std::vector<float> samples(frames * channels);
+		for(size_t i = 0; i < frames; i++){
+			for(size_t c = 0; c < channels; c++){
+				samples[i * channels + c] = sin(TWO_PI * hz * i / sampleRate) / (c + 1);
+			}
+		}
+		return samples;
+	}
+
+	void testRates(){
+		std::vector<std::pair<unsigned int, unsigned int>> rates = {{44100, 48000}, {48000, 44100}, {44100, 96000}, {96000, 44100}, {48000, 96000}};
+		for(auto & rate: rates){
+			auto name = ofToString(rate.first) + " -> " + ofToString(rate.second);
+			ofSoundResampler resampler;
+			resampler.setup(rate.first, rate.second, 2);
+			auto in = tone(1000, rate.first, rate.first, 2);
+			std::vector<float> out(resampler.getMaxOutputFrames(rate.first) * 2);
+			auto frames = resampler.process(in.data(), rate.first, out.data(), out.size() / 2);
+			std::vector<float> tail(resampler.getLatency() * 8);
+			auto tailFrames = resampler.flush(tail.data(), tail.size() / 2);
+			ofxTestEq(frames + tailFrames, size_t(rate.second), name + ": one second of input outputs one second");
+
+			// skip the start, where the filter still covers the silence before the stream
+			float error = 0;
+			for(size_t i = resampler.getNumTaps() * 2; i < frames; i++){
+				float expected = sin(TWO_PI * 1000 * i / rate.second);
+				error = std::max(error, std::abs(out[i * 2] - expected));
+				error = std::max(error, std::abs(out[i * 2 + 1] - expected / 2));
+			}
+			ofxTest(error < 0.001, name + ": sine resampled, max error " + ofToString(error));
+		}
+	}
+
+	void testAliasing(){
+		// 30KHz is above the nyquist frequency of 44100Hz, it should be removed
+		auto in = tone(30000, 96000, 96000, 1);
+		ofSoundResampler resampler;
+		resampler.setup(96000, 44100, 1);
+		std::vector<float> out(resampler.getMaxOutputFrames(96000));
+		auto frames = resampler.process(in.data(), 96000, out.data(), out.size());
+		float rms = 0;
+		size_t start = resampler.getNumTaps();
+		for(size_t i = start; i < frames; i++){
+			rms += out[i] * out[i];
+		}
+		rms = sqrt(rms / (frames - start));
+		ofxTest(rms < 0.001, "Frequencies above the new nyquist removed, rms " + ofToString(rms));
+	}
+
+	void testStreaming(){
+		for(auto speed: {0.918, 1.5, 0.3, 1.0123}){
+			auto name = "speed " + ofToString(speed);
+			auto in = tone(440, 44100, 20000, 3);
+			for(auto & sample: in){
+				sample += ofRandom(-0.1, 0.1);
+			}
+
+			ofSoundResampler once;
+			once.setup(speed, 3);
+			std::vector<float> expected(once.getMaxOutputFrames(20000) * 3 + once.getLatency() * 12);
+			auto frames = once.process(in.data(), 20000, expected.data(), expected.size() / 3);
+			frames += once.flush(expected.data() + frames * 3, expected.size() / 3 - frames);
+			expected.resize(frames * 3);
+			ofxTestEq(frames, size_t(ceil(20000 / speed)), name + ": output length");
+
+			// pull blocks of random sizes as an audioOut callback would
+			ofSoundResampler blocks;
+			blocks.setup(speed, 3, ofSoundResampler::Normal, 64);
+			std::vector<float> streamed;
+			std::vector<float> block;
+			size_t position = 0;
+			bool exactBlocks = true;
+			while(position < 20000){
+				size_t wanted = ofRandom(1, 300);
+				auto needed = std::min(blocks.getInputFramesNeeded(wanted), 20000 - position);
+				block.resize(blocks.getMaxOutputFrames(needed) * 3);
+				auto got = blocks.process(in.data() + position * 3, needed, block.data(), wanted);
+				position += needed;
+				exactBlocks &= got == wanted || position == 20000;
+				streamed.insert(streamed.end(), block.begin(), block.begin() + got * 3);
+			}
+			block.resize(blocks.getLatency() * 12);
+			auto tailFrames = blocks.flush(block.data(), block.size() / 3);
+			streamed.insert(streamed.end(), block.begin(), block.begin() + tailFrames * 3);
+
+			ofxTest(exactBlocks, name + ": getInputFramesNeeded() gives the exact input for each block");
+			ofxTest(streamed == expected, name + ": block by block output equals processing at once");
+		}
+	}
+
+	void testSoundBuffer(){
+		ofSoundBuffer buffer;
+		buffer.copyFrom(tone(440, 44100, 1000, 2), 2, 44100);
+		buffer.resample(0.5, ofSoundBuffer::Sinc);
+		ofxTestEq(buffer.getNumFrames(), size_t(2000), "Sinc resample in place");
+		float error = 0;
+		for(size_t i = 100; i < 1900; i++){
+			error = std::max(error, std::abs(buffer.getSample(i, 0) - float(sin(TWO_PI * 440 * i / 88200))));
+		}
+		ofxTest(error < 0.001, "Sinc resample in place, max error " + ofToString(error));
+
+		ofSoundBuffer looped;
+		buffer.resampleTo(looped, 100, 5000, 0.7, true, ofSoundBuffer::Sinc);
+		ofxTestEq(looped.getNumFrames(), size_t(5000), "Sinc resampleTo with loop");
+		ofxTestEq(looped.getNumChannels(), size_t(2), "Sinc resampleTo channels");
+
+		// the filter starts on the frames before fromFrame, so the output
+		// is right from its first frame
+		float speed = 0.7;
+		ofSoundBuffer source;
+		source.copyFrom(tone(440, 44100, 20000, 2), 2, 44100);
+		ofSoundBuffer out;
+		source.resampleTo(out, 5000, 4000, speed, false, ofSoundBuffer::Sinc);
+		error = 0;
+		for(size_t i = 0; i < 4000; i++){
+			float expected = sin(TWO_PI * 440 * (5000 + i * double(speed)) / 44100);
+			error = std::max(error, std::abs(out.getSample(i, 0) - expected));
+			error = std::max(error, std::abs(out.getSample(i, 1) - expected / 2));
+		}
+		ofxTest(error < 0.001, "Sinc resampleTo from the middle of a buffer, max error " + ofToString(error));
+
+		// blocks whose start is rounded down continue from the exact end of
+		// the previous one
+		std::vector<float> streamed;
+		double position = 5000;
+		for(size_t i = 0; i < 4000 / 256 + 1; i++){
+			source.resampleTo(out, position, 256, speed, false, ofSoundBuffer::Sinc);
+			streamed.insert(streamed.end(), out.getBuffer().begin(), out.getBuffer().end());
+			position += 256 * double(speed);
+		}
+		error = 0;
+		for(size_t i = 0; i < streamed.size() / 2; i++){
+			float expected = sin(TWO_PI * 440 * (5000 + i * double(speed)) / 44100);
+			error = std::max(error, std::abs(streamed[i * 2] - expected));
+		}
+		ofxTest(error < 0.001, "Sinc resampleTo block by block, max error " + ofToString(error));
+		float jump = 0;
+		for(size_t i = 256; i < streamed.size() / 2; i += 256){
+			float expected = sin(TWO_PI * 440 * (5000 + i * double(speed)) / 44100);
+			jump = std::max(jump, std::abs(streamed[i * 2] - expected));
+		}
+		ofxTest(jump < 0.001, "Sinc resampleTo first frame of each block, max error " + ofToString(jump));
+
+		// 441Hz fits 10 times in 1000 frames so the loop is seamless, the
+		// frames before the start and after the end are wrapped
+		source.copyFrom(tone(441, 44100, 1000, 2), 2, 44100);
+		source.resampleTo(out, 0, 3000, speed, true, ofSoundBuffer::Sinc);
+		error = 0;
+		for(size_t i = 0; i < 3000; i++){
+			float expected = sin(TWO_PI * 441 * (i * double(speed)) / 44100);
+			error = std::max(error, std::abs(out.getSample(i, 0) - expected));
+		}
+		ofxTest(error < 0.001, "Sinc resampleTo with loop wraps the history, max error " + ofToString(error));
+	}
+
+	void run(){
+		testRates();
+		testAliasing();
+		testStreaming();
+		testSoundBuffer();
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
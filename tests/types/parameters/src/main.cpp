@@ -24,6 +24,129 @@ class ofApp: public ofxUnitTestsApp{
 		group.remove(p3);
 		ofxTest(!group.contains("p>3"), "Group shouldn't contain p2 after remove");
 		ofxTestEq(group.get("p>4").getName(), "p>4", "p4 name " + group.get("p>4").getName() + " should be p>4, probably index map is corrupt"); //Issue #6016
+
+		testChangeSets();
+		testSnapshots();
+	}
+
+	void testChangeSets(){
+		ofParameter<float> a{"a", 0, 0, 1};
+		ofParameter<float> b{"b", 0, 0, 1};
+		ofParameter<int> c{"c", 0, 0, 100};
+		ofParameterGroup sub{"sub", c};
+		ofParameterGroup group{"group", a, b, sub};
+		int changed = 0;
+		int changeSets = 0;
+		ofParameterGroupChangedEventArgs lastChanges;
+		ofEventListeners listeners;
+		listeners.push(group.parameterChangedE().newListener([&](ofAbstractParameter &){
+			changed++;
+		}));
+		listeners.push(group.parametersChangedE().newListener([&](const ofParameterGroupChangedEventArgs & changes){
+			changeSets++;
+			lastChanges = changes;
+		}));
+
+		a = 0.5f;
+		ofxTestEq(changed, 1, "Parameter change notified outside of a change set");
+		ofxTestEq(changeSets, 1, "Change set notified for a single change outside of a change set");
+
+		group.beginChanges();
+		for(int i = 0; i < 100; i++){
+			a = i / 100.f;
+			b = i / 100.f;
+			c = i;
+		}
+		ofxTestEq(changed, 1, "Changes not notified inside a change set");
+		group.endChanges();
+		ofxTestEq(changed, 4, "Each changed parameter notified once at the end of the change set");
+		ofxTestEq(changeSets, 2, "Change set notified once at the end of the change set");
+		ofxTestEq(lastChanges.parameters.size(), size_t(3), "Change set contains each changed parameter once");
+		ofxTest(lastChanges.contains(c), "Change set contains parameters of subgroups");
+
+		sub.beginChanges();
+		c = 1;
+		c = 2;
+		sub.endChanges();
+		ofxTestEq(changeSets, 3, "Change set of a subgroup notifies the parent once");
+
+		group.setAsyncChanges(true);
+		a = 0.1f;
+		b = 0.2f;
+		a = 0.3f;
+		ofxTestEq(changed, 5, "Async changes not notified immediately");
+		ofGetMainLoop()->getEventQueue().process();
+		ofxTestEq(changed, 7, "Async changes notified when the main loop queue is processed");
+		ofxTestEq(lastChanges.parameters.size(), size_t(2), "Async change set contains each changed parameter once");
+		group.setAsyncChanges(false);
+
+		int before = changeSets;
+		{
+			ofParameterGroup::ChangeSet changes(group);
+			a = 0.9f;
+			b = 0.9f;
+			ofxTest(group.isChanging(), "ChangeSet opens a change set");
+			ofxTestEq(changeSets, before, "Changes not notified inside a ChangeSet");
+		}
+		ofxTestEq(changeSets, before + 1, "ChangeSet notifies once when it goes out of scope");
+		try{
+			ofParameterGroup::ChangeSet changes(group);
+			a = 0.8f;
+			throw std::runtime_error("interrupted");
+		}catch(std::runtime_error &){
+		}
+		ofxTest(!group.isChanging(), "ChangeSet ends the change set when an exception leaves it");
+		ofxTestEq(changeSets, before + 2, "ChangeSet notifies the changes made before the exception");
+	}
+
+	void testSnapshots(){
+		ofParameter<float> a{"a", 0.25f, 0, 1};
+		ofParameter<string> s{"s", "hello"};
+		ofParameter<int> c{"c", 3, 0, 10};
+		ofParameter<void> v{"v"};
+		ofParameterGroup sub{"sub", c};
+		ofParameterGroup group{"group", a, s, sub, v};
+
+		ofParameterSnapshot snapshot(group);
+		ofxTestEq(snapshot.size(), size_t(3), "Snapshot contains every serializable parameter");
+
+		ofBuffer buffer;
+		snapshot.save(buffer);
+		ofParameterSnapshot loaded;
+		ofxTest(loaded.load(buffer), "Snapshot loads its own data");
+		ofxTest(snapshot.diff(loaded).empty(), "Loaded snapshot is the same as the saved one");
+
+		c = 7;
+		auto changes = snapshot.diff(group);
+		ofxTestEq(changes.size(), size_t(1), "Diff contains only the changed parameters");
+		auto merged = snapshot;
+		merged.merge(changes);
+		ofxTest(merged.diff(group).empty(), "Diff contains the new value of the changed parameter");
+
+		a = 0.75f;
+		s = "world";
+		ofxTestEq(snapshot.diff(group).size(), size_t(3), "Diff contains every changed parameter");
+
+		int changeSets = 0;
+		auto listener = group.parametersChangedE().newListener([&](const ofParameterGroupChangedEventArgs &){
+			changeSets++;
+		});
+		loaded.apply(group);
+		ofxTestEq(a.get(), 0.25f, "Snapshot applied to float");
+		ofxTestEq(s.get(), string("hello"), "Snapshot applied to string");
+		ofxTestEq(c.get(), 3, "Snapshot applied to subgroup");
+		ofxTestEq(changeSets, 1, "Applying a snapshot notifies a single change set");
+		loaded.apply(group);
+		ofxTestEq(changeSets, 1, "Applying a snapshot without changes doesn't notify");
+
+		snapshot.merge(changes);
+		snapshot.apply(group);
+		ofxTestEq(c.get(), 7, "Merged diff applied");
+
+		ofBuffer invalid;
+		invalid.set("OFPS\x01\x05", 6);
+		ofxTest(!loaded.load(invalid), "Truncated snapshot rejected");
+		ofxTestEq(loaded.size(), size_t(3), "Rejected data doesn't modify the snapshot");
 	}
 };
 
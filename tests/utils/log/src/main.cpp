@@ -0,0 +1,152 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class CaptureLoggerChannel: public ofBaseLoggerChannel{
+public:
+	void log(ofLogLevel level, const std::string & module, const std::string & message){
+		std::unique_lock<std::mutex> lck(mtx);
+		modules.push_back(module);
+		messages.push_back(message);
+	}
+	void log(ofLogLevel level, const std::string & module, const char* format, ...){
+		va_list args;
+		va_start(args, format);
+		log(level, module, format, args);
+		va_end(args);
+	}
+	void log(ofLogLevel level, const std::string & module, const char* format, va_list args){
+		log(level, module, ofVAArgsToString(format, args));
+	}
+
+	std::mutex mtx;
+	std::vector<std::string> modules;
+	std::vector<std::string> messages;
+};
+
+class ofApp: public ofxUnitTestsApp{
+	int evaluated = 0;
+
+	std::string expensive(){
+		evaluated++;
+		return "expensive";
+	}
+
+	void testLevels(){
+		auto previousLevel = ofGetLogLevel();
+		ofSetLogLevel(OF_LOG_WARNING);
+		ofSetLogLevel("verboseModule", OF_LOG_VERBOSE);
+		for(int i = 0; i < 100; i++){
+			ofSetLogLevel("module" + ofToString(i), i % 2 ? OF_LOG_ERROR : OF_LOG_NOTICE);
+		}
+		ofSetLogLevel("silentModule", OF_LOG_SILENT);
+
+		ofxTestEq(ofGetLogLevel("verboseModule"), OF_LOG_VERBOSE, "Module level");
+		ofxTestEq(ofGetLogLevel("module51"), OF_LOG_ERROR, "Module level with many modules set");
+		ofxTestEq(ofGetLogLevel("unknownModule"), OF_LOG_WARNING, "Global level for modules without level");
+		ofxTest(ofLog::isEnabled(OF_LOG_NOTICE, "module50"), "Enabled by module level below the global one");
+		ofxTest(!ofLog::isEnabled(OF_LOG_WARNING, "module51"), "Disabled by module level above the global one");
+		ofxTest(!ofLog::isEnabled(OF_LOG_FATAL_ERROR, "silentModule"), "Silent module disabled");
+		ofxTest(ofLog::isEnabled(OF_LOG_WARNING), "Global level without module");
+
+		evaluated = 0;
+		OF_LOGN("unknownModule") << expensive();
+		OF_LOGW("module51") << expensive();
+		OF_LOGV() << expensive();
+		ofxTestEq(evaluated, 0, "Disabled messages not evaluated");
+		if(OF_LOG_MIN_LEVEL <= OF_LOG_VERBOSE){
+			OF_LOGV("verboseModule") << expensive();
+			ofxTestEq(evaluated, 1, "Enabled messages evaluated");
+		}
+
+		ofSetLogLevel("verboseModule", OF_LOG_NOTICE);
+		ofxTest(!ofLog::isEnabled(OF_LOG_VERBOSE, "verboseModule"), "Module level replaced");
+		ofSetLogLevel(previousLevel);
+	}
+
+	void run(){
+		testLevels();
+
+		auto previous = ofGetLoggerChannel();
+
+		{
+			auto capture = std::make_shared<CaptureLoggerChannel>();
+			auto async = std::make_shared<ofAsyncLoggerChannel>(capture, 1024, OF_LOG_OVERFLOW_BLOCK);
+			ofSetLoggerChannel(async);
+			std::vector<std::thread> threads;
+			for(int t = 0; t < 4; t++){
+				threads.emplace_back([t]{
+					for(int i = 0; i < 5000; i++){
+						ofLogNotice("thread" + ofToString(t)) << i;
+					}
+				});
+			}
+			for(auto & thread: threads){
+				thread.join();
+			}
+			async->flush();
+			ofSetLoggerChannel(previous);
+
+			ofxTestEq(capture->messages.size(), size_t(20000), "Every message written with the block policy");
+			ofxTestEq(async->getDroppedCount(), size_t(0), "No messages dropped with the block policy");
+			std::map<std::string, int> last;
+			bool inOrder = true;
+			for(size_t i = 0; i < capture->messages.size(); i++){
+				auto & previousValue = last.emplace(capture->modules[i], -1).first->second;
+				auto value = ofToInt(capture->messages[i]);
+				inOrder &= value == previousValue + 1;
+				previousValue = value;
+			}
+			ofxTest(inOrder, "Messages from each thread written in order");
+		}
+
+		{
+			auto capture = std::make_shared<CaptureLoggerChannel>();
+			ofAsyncLoggerChannel async(capture, 16, OF_LOG_OVERFLOW_DROP);
+			// holding the capture lock stalls the writer thread so the queue fills
+			std::unique_lock<std::mutex> lck(capture->mtx);
+			for(int i = 0; i < 1000; i++){
+				async.log(OF_LOG_NOTICE, "", ofToString(i));
+			}
+			lck.unlock();
+			async.flush();
+			ofxTest(async.getDroppedCount() > 0, "Messages dropped when the queue is full");
+			ofxTestEq(capture->messages.size(), 1000 - async.getDroppedCount() + 1, "Kept messages and the dropped report written");
+		}
+
+		{
+			auto capture = std::make_shared<CaptureLoggerChannel>();
+			{
+				ofAsyncLoggerChannel async(capture);
+				async.log(OF_LOG_NOTICE, "", "%s %d", "formatted", 10);
+				for(int i = 0; i < 99; i++){
+					async.log(OF_LOG_NOTICE, "", "message");
+				}
+			}
+			ofxTestEq(capture->messages.size(), size_t(100), "Pending messages written when the channel is destroyed");
+			ofxTestEq(capture->messages.front(), std::string("formatted 10"), "printf style message formatted");
+		}
+
+		{
+			auto capture = std::make_shared<CaptureLoggerChannel>();
+			ofAsyncLoggerChannel async(capture);
+			async.setShowTimestamp(true);
+			async.log(OF_LOG_NOTICE, "", "stamped");
+			async.flush();
+			ofxTestEq(capture->messages.size(), size_t(1), "Timestamped message written");
+			if(!capture->messages.empty()){
+				auto & message = capture->messages.front();
+				ofxTest(message.size() == std::string("[00:00:00.000] stamped").size() && message.front() == '[', "Timestamp prepended to the message");
+			}
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}
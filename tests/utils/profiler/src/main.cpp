@@ -0,0 +1,87 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void inner(){
+		OF_PROFILE_SCOPE("inner");
+		ofSleepMillis(1);
+	}
+
+	void run(){
+		{
+			OF_PROFILE_SCOPE("disabled");
+		}
+		ofProfiler::newFrame();
+		ofxTest(ofProfiler::getStats().empty(), "Nothing recorded while disabled");
+
+		ofProfiler::setEnabled(true);
+		ofProfiler::setThreadName("main");
+		ofxTest(ofProfiler::startTrace("trace.json"), "Trace file opened");
+
+		std::thread worker([]{
+			ofProfiler::setThreadName("worker");
+			for(int i = 0; i < 5; i++){
+				OF_PROFILE_SCOPE("job");
+			}
+		});
+		worker.join();
+
+		for(int frame = 0; frame < 3; frame++){
+			ofProfiler::newFrame();
+			OF_PROFILE_SCOPE("frame");
+			for(int i = 0; i < 2; i++){
+				inner();
+			}
+		}
+		ofProfiler::newFrame();
+		ofProfiler::stopTrace();
+		ofProfiler::setEnabled(false);
+
+		auto stats = ofProfiler::getStats();
+		auto find = [&](const std::string & path) -> const ofProfiler::Stats *{
+			for(auto & s: stats){
+				if(s.path == path){
+					return &s;
+				}
+			}
+			return nullptr;
+		};
+		auto frame = find("frame");
+		auto innerStats = find("frame/inner");
+		auto job = find("job");
+		ofxTest(frame && innerStats && job, "Stats for every marker");
+		if(frame && innerStats && job){
+			ofxTestEq(innerStats->depth, size_t(1), "Nested marker depth");
+			ofxTestEq(innerStats->calls, size_t(2), "Calls in the last frame");
+			ofxTest(innerStats->lastMs >= 2, "Time of all the calls in the frame");
+			ofxTest(frame->averageMs >= innerStats->averageMs, "Parent includes the time of its children");
+			ofxTest(frame < innerStats, "Children after their parent");
+			ofxTestEq(job->thread, std::string("worker"), "Thread name");
+			ofxTestEq(job->calls, size_t(5), "Markers from other threads collected");
+		}
+
+		auto trace = ofLoadJson("trace.json");
+		ofxTest(trace["traceEvents"].is_array(), "Trace is valid json");
+		size_t inners = 0;
+		for(auto & event: trace["traceEvents"]){
+			if(event["name"] == "inner"){
+				inners++;
+			}
+		}
+		ofxTestEq(inners, size_t(6), "Every marker written to the trace");
+
+		ofProfiler::clear();
+		ofxTest(ofProfiler::getStats().empty(), "Stats cleared");
+		ofxTestEq(ofProfiler::getDroppedCount(), size_t(0), "No markers dropped");
+	}
+};
+
+//========================================================================
+int main( ){
+    ofInit();
+    auto window = std::make_shared<ofAppNoWindow>();
+    auto app = std::make_shared<ofApp>();
+    ofRunApp(window, app);
+    return ofRunMainLoop();
+}